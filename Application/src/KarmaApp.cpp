@@ -10,23 +10,23 @@ public:
 		m_Camera.reset(new Karma::PerspectiveCamera(45.0f, 1280.f / 720.0f, 0.1f, 100.0f));
 
 		m_SquareVA.reset(Karma::VertexArray::Create());
-		std::shared_ptr<Karma::Mesh> trialMesh;
-		trialMesh.reset(new Karma::Mesh("../Resources/Models/viking_room.obj"));
-		m_SquareVA->SetMesh(trialMesh);
+		Karma::AssetManager& assetManager = Karma::AssetManager::Get();
+
+		m_SquareMesh = assetManager.LoadMesh("../Resources/Models/viking_room.obj", Karma::AssetPriority::Immediate);
+		m_SquareVA->SetMesh(m_SquareMesh.GetShared());
 
 		std::shared_ptr<Karma::UniformBufferObject> shaderUniform;
 		shaderUniform.reset(Karma::UniformBufferObject::Create({ Karma::ShaderDataType::Mat4, Karma::ShaderDataType::Mat4 }, 0));
 
-		m_BlueSQShader.reset(Karma::Shader::Create("../Resources/Shaders/shader.vert", "../Resources/Shaders/shader.frag", shaderUniform, "CylinderShader"));
+		m_BlueSQShader = assetManager.LoadShader("../Resources/Shaders/shader.vert", "../Resources/Shaders/shader.frag", shaderUniform, "CylinderShader",
+			Karma::AssetPriority::Immediate);
 
-		m_SquareMat.reset(new Karma::Material());
-		m_SquareMat->AddShader(m_BlueSQShader);
-		m_SquareTex.reset(new Karma::Texture(Karma::TextureType::Image, "../Resources/Textures/viking_room.png", "VikingTex", "texSampler"));
-		m_SquareMat->AddTexture(m_SquareTex);
+		m_SquareTex = assetManager.LoadTexture("../Resources/Textures/viking_room.png", "VikingTex", "texSampler", Karma::AssetPriority::Immediate);
 
+		m_SquareMat = assetManager.LoadMaterial("VikingRoomMaterial", m_BlueSQShader, { m_SquareTex }, Karma::AssetPriority::Immediate);
 		m_SquareMat->AttatchMainCamera(m_Camera);
 
-		m_SquareVA->SetMaterial(m_SquareMat);
+		m_SquareVA->SetMaterial(m_SquareMat.GetShared());
 		
 		m_Scene.reset(new Karma::Scene());
 
@@ -176,11 +176,12 @@ public:
 	}
 
 private:
-	std::shared_ptr<Karma::Shader> m_BlueSQShader;
+	Karma::AssetHandle<Karma::Mesh> m_SquareMesh;
+	Karma::AssetHandle<Karma::Shader> m_BlueSQShader;
 
 	std::shared_ptr<Karma::VertexArray> m_SquareVA;
-	std::shared_ptr<Karma::Material> m_SquareMat;
-	std::shared_ptr<Karma::Texture> m_SquareTex;
+	Karma::AssetHandle<Karma::Material> m_SquareMat;
+	Karma::AssetHandle<Karma::Texture> m_SquareTex;
 
 	std::shared_ptr<Karma::PerspectiveCamera> m_Camera;
 	std::shared_ptr<Karma::Scene> m_Scene;
@@ -0,0 +1,221 @@
+#include "Benchmark.h"
+#include "Karma/JobPool.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+namespace Karma
+{
+	// Animates synthetic characters (a skeleton of 64 joints cross fading between two clips) on one thread and then on the loading
+	// JobPool, and logs the poses a second, the memory of the clips with and without compression, and the time to skin a mesh on the CPU
+	static void RunAnimationBenchmark(uint32_t numberOfCharacters)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+
+		const uint32_t numberOfChains = 8;
+		const uint32_t jointsPerChain = 8;
+		const float sampleRate = 30.0f;
+		const uint32_t numberOfClipFrames = 31;
+
+		// A spine with a chain off each of its joints
+		std::shared_ptr<Skeleton> skeleton = std::make_shared<Skeleton>();
+
+		for (uint32_t chain = 0; chain < numberOfChains; chain++)
+		{
+			for (uint32_t link = 0; link < jointsPerChain; link++)
+			{
+				const uint32_t joint = chain * jointsPerChain + link;
+				const int32_t parent = link > 0 ? int32_t(joint - 1) : chain > 0 ? int32_t(chain - 1) : -1;
+
+				skeleton->AddJoint("Joint" + std::to_string(joint), parent, glm::vec3(0.0f, 0.1f, 0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec3(1.0f));
+			}
+		}
+
+		{
+			std::vector<glm::mat4> bindMatrices(skeleton->GetNumberOfJoints());
+			skeleton->ComputeModelMatrices(skeleton->GetBindPose(), bindMatrices.data());
+
+			for (uint32_t joint = 0; joint < skeleton->GetNumberOfJoints(); joint++)
+			{
+				skeleton->SetSkinJoint(joint, joint, glm::inverse(bindMatrices[joint]));
+			}
+		}
+
+		// Swings of each joint about an axis of its own, every fourth joint left still for the compression to find
+		std::vector<AnimationPose> firstFrames(numberOfClipFrames, skeleton->GetBindPose());
+		std::vector<AnimationPose> secondFrames(numberOfClipFrames, skeleton->GetBindPose());
+
+		for (uint32_t frame = 0; frame < numberOfClipFrames; frame++)
+		{
+			const float phase = 6.2831853f * float(frame) / float(numberOfClipFrames - 1);
+
+			for (uint32_t joint = 0; joint < skeleton->GetNumberOfJoints(); joint++)
+			{
+				if (joint % 4 == 3)
+				{
+					continue;
+				}
+
+				const glm::vec3 axis = glm::normalize(glm::vec3(std::sin(float(joint)), 1.0f, std::cos(float(joint))));
+
+				const float firstAngle = 0.3f * std::sin(phase + 0.1f * float(joint));
+				const float secondAngle = 0.6f * std::sin(2.0f * phase + 0.2f * float(joint));
+
+				firstFrames[frame].GetRotation(joint) = glm::vec4(axis * std::sin(firstAngle * 0.5f), std::cos(firstAngle * 0.5f));
+				secondFrames[frame].GetRotation(joint) = glm::vec4(axis * std::sin(secondAngle * 0.5f), std::cos(secondAngle * 0.5f));
+			}
+
+			firstFrames[frame].GetTranslation(0) = glm::vec4(std::sin(phase), 0.1f, 0.0f, 0.0f);
+			secondFrames[frame].GetTranslation(0) = glm::vec4(0.0f, 0.1f + 0.05f * std::sin(2.0f * phase), 0.0f, 0.0f);
+		}
+
+		AnimationCompressionSettings floatSettings;
+		floatSettings.m_bQuantize = false;
+
+		std::shared_ptr<RiggedAnimation> firstClip = std::make_shared<RiggedAnimation>("Sway", skeleton, firstFrames, sampleRate,
+			RiggedAnimation::GetDefaultCompression());
+		std::shared_ptr<RiggedAnimation> secondClip = std::make_shared<RiggedAnimation>("Bob", skeleton, secondFrames, sampleRate,
+			RiggedAnimation::GetDefaultCompression());
+		std::shared_ptr<RiggedAnimation> firstFloatClip = std::make_shared<RiggedAnimation>("Sway", skeleton, firstFrames, sampleRate, floatSettings);
+		std::shared_ptr<RiggedAnimation> secondFloatClip = std::make_shared<RiggedAnimation>("Bob", skeleton, secondFrames, sampleRate, floatSettings);
+
+		KR_INFO("Animation benchmark: clips of {0} joints and {1} frames, {2} of {3} tracks animated, {4} bytes a clip compressed ({5} in floats, {6} without the constant tracks stripped), largest error {7}",
+			skeleton->GetNumberOfJoints(), numberOfClipFrames, firstClip->GetNumberOfAnimatedTracks(), skeleton->GetNumberOfJoints() * 3,
+			firstClip->GetMemorySize(), firstFloatClip->GetMemorySize(), firstClip->GetUncompressedSize(),
+			std::max(firstClip->GetCompressionError(), secondClip->GetCompressionError()));
+
+		const uint32_t numberOfFrames = 60;
+		const float deltaSeconds = 1.0f / 60.0f;
+
+		// Half the characters cross fade from the first clip to the second over the frames, the other half blend the two evenly
+		auto runCharacters = [&](const std::shared_ptr<RiggedAnimation>& first, const std::shared_ptr<RiggedAnimation>& second, JobPool* pool,
+			std::vector<glm::mat4>& lastSkinMatrices)
+		{
+			std::vector<Anuprana> characters(numberOfCharacters, Anuprana(skeleton));
+			std::vector<Anuprana*> animators;
+			animators.reserve(numberOfCharacters);
+
+			for (uint32_t counter = 0; counter < numberOfCharacters; counter++)
+			{
+				Anuprana& character = characters[counter];
+				character.Play(first);
+				character.GetLayers()[0].m_Time = 0.01f * float(counter);
+
+				if (counter % 2 == 0)
+				{
+					character.Play(second, float(numberOfFrames) * deltaSeconds);
+				}
+				else
+				{
+					AnimationLayer layer;
+					layer.m_Animation = second;
+					layer.m_Weight = 1.0f;
+					character.GetLayers().push_back(layer);
+				}
+
+				animators.push_back(&character);
+			}
+
+			Clock::time_point begin = Clock::now();
+
+			for (uint32_t frame = 0; frame < numberOfFrames; frame++)
+			{
+				Anuprana::UpdateAll(animators.data(), numberOfCharacters, deltaSeconds, pool);
+			}
+
+			const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+			lastSkinMatrices.clear();
+
+			for (const Anuprana& character : characters)
+			{
+				lastSkinMatrices.insert(lastSkinMatrices.end(), character.GetSkinMatrices().begin(), character.GetSkinMatrices().end());
+			}
+
+			return seconds;
+		};
+
+		JobPool& pool = JobPool::GetLoadingPool();
+
+		std::vector<glm::mat4> serialMatrices;
+		std::vector<glm::mat4> parallelMatrices;
+		std::vector<glm::mat4> floatMatrices;
+
+		const double serialSeconds = runCharacters(firstClip, secondClip, nullptr, serialMatrices);
+		const double parallelSeconds = runCharacters(firstClip, secondClip, &pool, parallelMatrices);
+		const double floatSeconds = runCharacters(firstFloatClip, secondFloatClip, &pool, floatMatrices);
+
+		const double numberOfPoses = double(numberOfCharacters) * numberOfFrames;
+
+		// The same characters give the same matrices whatever thread updated them, and the compressed clips nearly the float ones
+		uint32_t numberOfMismatches = 0;
+		float largestDifference = 0.0f;
+
+		for (size_t matrix = 0; matrix < serialMatrices.size(); matrix++)
+		{
+			numberOfMismatches += serialMatrices[matrix] != parallelMatrices[matrix] ? 1 : 0;
+
+			for (uint32_t column = 0; column < 4; column++)
+			{
+				const glm::vec4 difference = glm::abs(parallelMatrices[matrix][column] - floatMatrices[matrix][column]);
+				largestDifference = std::max(largestDifference, std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w)));
+			}
+		}
+
+		KR_INFO("Animation benchmark: {0} characters for {1} frames, {2} poses a second on one thread, {3} on {4} threads ({5} with the clips in floats)",
+			numberOfCharacters, numberOfFrames, uint64_t(numberOfPoses / serialSeconds), uint64_t(numberOfPoses / parallelSeconds),
+			pool.GetNumberOfWorkers() + 1, uint64_t(numberOfPoses / floatSeconds));
+		KR_INFO("Animation benchmark: largest difference of the skin matrices from the compressed clips to the float ones {0}", largestDifference);
+
+		if (numberOfMismatches)
+		{
+			KR_WARN("Animation benchmark: {0} skin matrices differ between the serial and the parallel updates", numberOfMismatches);
+		}
+
+		// A mesh of 10000 vertices skinned on the CPU by the last character's matrices, each vertex weighted to four bones
+		const uint32_t numberOfVertices = 10000;
+		const uint32_t numberOfSkinnings = 100;
+
+		std::vector<glm::vec3> positions(numberOfVertices);
+		std::vector<glm::vec3> normals(numberOfVertices, glm::vec3(0.0f, 1.0f, 0.0f));
+		std::vector<VertexBoneWeights> weights(numberOfVertices);
+		std::vector<glm::vec3> skinnedPositions(numberOfVertices);
+		std::vector<glm::vec3> skinnedNormals(numberOfVertices);
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			positions[vertex] = glm::vec3(std::sin(float(vertex)), 0.01f * float(vertex % 640), std::cos(float(vertex)));
+
+			for (uint32_t influence = 0; influence < 4; influence++)
+			{
+				weights[vertex].m_BoneIDs[influence] = (vertex / 160 + influence) % skeleton->GetNumberOfSkinJoints();
+				weights[vertex].m_Weights[influence] = influence == 0 ? 0.7f : 0.1f;
+			}
+		}
+
+		const glm::mat4* skinMatrices = parallelMatrices.data() + parallelMatrices.size() - skeleton->GetNumberOfSkinJoints();
+
+		Clock::time_point skinBegin = Clock::now();
+
+		for (uint32_t counter = 0; counter < numberOfSkinnings; counter++)
+		{
+			SkeletalMesh::SkinVertices(positions.data(), normals.data(), weights.data(), numberOfVertices, skinMatrices, skinnedPositions.data(),
+				skinnedNormals.data());
+		}
+
+		const double skinSeconds = std::chrono::duration<double>(Clock::now() - skinBegin).count();
+
+		KR_INFO("Animation benchmark: CPU skinning of {0} vertices with 4 bones each in {1} ms, {2} million vertices a second", numberOfVertices,
+			1000.0 * skinSeconds / numberOfSkinnings, double(numberOfVertices) * numberOfSkinnings / skinSeconds / 1000000.0);
+	}
+
+	static BenchmarkOption s_AnimationBenchmarkOption("animation-benchmark",
+		"--animation-benchmark[=characters] animates synthetic characters on one thread and on the loading JobPool and logs the poses a second (4096 by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfCharacters = uint32_t(CommandLine::ParseNumber(value, 4096));
+
+			return new OneShotBenchmark("animation", [numberOfCharacters]() { RunAnimationBenchmark(numberOfCharacters); });
+		});
+}
@@ -0,0 +1,373 @@
+#include "Benchmark.h"
+#include "Karma/FileWatcher.h"
+#include "Platform/Null/NullRendererAPI.h"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace Karma
+{
+	// Loads the models of the Models directory and the images of the Textures one, with a material for each model of the shader of the
+	// Shaders one, headless. Each is requested twice, at different priorities, to check that the requests coalesce. Logs the times and
+	// the memory report, then drops the handles and checks that the assets and their buffers are gone.
+	static void RunAssetBenchmark(const std::string& resourceDirectory)
+	{
+		if (Renderer::GetAPI() != RendererAPI::API::Null)
+		{
+			// What is left after the unload is checked against the Null renderer's counts
+			KR_WARN("Asset benchmark: runs with --renderer=null only");
+			return;
+		}
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		std::vector<std::string> modelPaths;
+		std::vector<std::string> imagePaths;
+		std::error_code errorCode;
+
+		Assimp::Importer assImporter;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(resourceDirectory + "/Models", errorCode))
+		{
+			// Material libraries and the cooked files sit next to the models
+			if (entry.is_regular_file() && assImporter.IsExtensionSupported(entry.path().extension().string()))
+			{
+				modelPaths.push_back(entry.path().string());
+			}
+		}
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(resourceDirectory + "/Textures", errorCode))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return char(tolower(character)); });
+
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" ||
+				extension == ".bmp"))
+			{
+				imagePaths.push_back(entry.path().string());
+			}
+		}
+
+		if (modelPaths.empty() || imagePaths.empty())
+		{
+			KR_WARN("Asset benchmark: no models or no images in {0}", resourceDirectory);
+			return;
+		}
+
+		std::sort(modelPaths.begin(), modelPaths.end());
+		std::sort(imagePaths.begin(), imagePaths.end());
+
+		const NullRHIStatistics before = NullRendererAPI::GetStatistics();
+
+		AssetManager manager;
+
+		std::vector<AssetHandle<Mesh>> meshes;
+		std::vector<AssetHandle<Texture>> textures;
+		std::vector<AssetHandle<Material>> materials;
+		uint32_t numberOfMismatches = 0;
+
+		Clock::time_point begin = Clock::now();
+
+		{
+			std::shared_ptr<UniformBufferObject> shaderUniform;
+			shaderUniform.reset(UniformBufferObject::Create({ ShaderDataType::Mat4, ShaderDataType::Mat4 }, 0));
+
+			AssetHandle<Shader> shader = manager.LoadShader(resourceDirectory + "/Shaders/shader.vert", resourceDirectory + "/Shaders/shader.frag",
+				shaderUniform, "BenchmarkShader");
+
+			// Each twice, the second request joining the first one's load, and the priorities mixed
+			for (uint32_t counter = 0; counter < uint32_t(imagePaths.size()); counter++)
+			{
+				textures.push_back(manager.LoadTexture(imagePaths[counter], "BenchmarkTexture", "texSampler", AssetPriority::Low));
+				textures.push_back(manager.LoadTexture(imagePaths[counter], "BenchmarkTexture", "texSampler", AssetPriority(counter % 3)));
+			}
+
+			for (uint32_t counter = 0; counter < uint32_t(modelPaths.size()); counter++)
+			{
+				meshes.push_back(manager.LoadMesh(modelPaths[counter], AssetPriority(counter % 3)));
+				meshes.push_back(manager.LoadMesh(modelPaths[counter], AssetPriority::High));
+
+				materials.push_back(manager.LoadMaterial("BenchmarkMaterial" + std::to_string(counter), shader,
+					{ textures[(counter * 2) % textures.size()] }));
+			}
+		}
+
+		Clock::time_point requested = Clock::now();
+
+		manager.WaitForLoads();
+
+		Clock::time_point loaded = Clock::now();
+
+		for (size_t counter = 0; counter < meshes.size(); counter += 2)
+		{
+			numberOfMismatches += meshes[counter] != meshes[counter + 1] ? 1 : 0;
+		}
+
+		for (size_t counter = 0; counter < textures.size(); counter += 2)
+		{
+			numberOfMismatches += textures[counter] != textures[counter + 1] ? 1 : 0;
+		}
+
+		// The registry answers by GUID what it loaded by path
+		numberOfMismatches += manager.Find<Mesh>(AssetManager::GetMeshGUID(modelPaths.front())) != meshes.front() ? 1 : 0;
+
+		uint32_t numberOfReadyMaterials = 0;
+
+		for (const AssetHandle<Material>& material : materials)
+		{
+			numberOfReadyMaterials += material.IsReady() && material->GetShader(0) && material->GetTextures().size() == 1 ? 1 : 0;
+		}
+
+		const AssetStatistics statistics = manager.GetStatistics();
+
+		KR_INFO("Asset benchmark: {0} models and {1} images requested twice each in {2} ms, all loaded {3} ms later", modelPaths.size(),
+			imagePaths.size(), std::chrono::duration<double, std::milli>(requested - begin).count(),
+			std::chrono::duration<double, std::milli>(loaded - requested).count());
+		KR_INFO("Asset benchmark: {0} requests, {1} coalesced, {2} loads ({3} ms from request to loaded on average), {4} failed, {5} of {6} materials made",
+			statistics.m_NumberOfRequests, statistics.m_NumberOfCoalescedRequests, statistics.m_NumberOfLoads,
+			statistics.m_NumberOfLoads ? statistics.m_LoadMilliseconds / statistics.m_NumberOfLoads : 0.0, statistics.m_NumberOfFailures,
+			numberOfReadyMaterials, materials.size());
+
+		manager.LogMemoryReport();
+
+		if (numberOfMismatches)
+		{
+			KR_WARN("Asset benchmark: {0} requests of the same file got different assets", numberOfMismatches);
+		}
+
+		materials.clear();
+		meshes.clear();
+		textures.clear();
+
+		manager.Update();
+
+		// The streamed textures unregistered, their GPU side goes with the streamer's Update
+		if (TextureStreamer::IsSupported())
+		{
+			TextureStreamer::Get().WaitForDecodes();
+			TextureStreamer::Get().Update();
+		}
+
+		const AssetMemoryReport report = manager.GetMemoryReport();
+		uint32_t numberOfAssetsLeft = 0;
+
+		for (const AssetTypeReport& typeReport : report.m_Types)
+		{
+			numberOfAssetsLeft += typeReport.m_NumberOfAssets;
+		}
+
+		const NullRHIStatistics& after = NullRendererAPI::GetStatistics();
+
+		KR_INFO("Asset benchmark: {0} unloads once the handles were dropped, {1} assets left", manager.GetStatistics().m_NumberOfUnloads,
+			numberOfAssetsLeft);
+
+		if (numberOfAssetsLeft || after.m_LiveVertexBuffers != before.m_LiveVertexBuffers || after.m_LiveIndexBuffers != before.m_LiveIndexBuffers ||
+			after.m_LiveShaders != before.m_LiveShaders || after.m_ResidentTextureBytes != before.m_ResidentTextureBytes)
+		{
+			KR_WARN("Asset benchmark: left after the unload {0} vertex buffers, {1} index buffers, {2} shaders, {3} bytes of textures",
+				int64_t(after.m_LiveVertexBuffers) - before.m_LiveVertexBuffers, int64_t(after.m_LiveIndexBuffers) - before.m_LiveIndexBuffers,
+				int64_t(after.m_LiveShaders) - before.m_LiveShaders, int64_t(after.m_ResidentTextureBytes) - int64_t(before.m_ResidentTextureBytes));
+		}
+	}
+
+	// Copies a model, an image and the shaders of the resources directory into a temporary one and loads them (with a material and a
+	// vertex array) headless with the hot reload on. Then writes the files again, the fragment shader with a line more, and logs the
+	// time from the writes to the contents swapped, whether the vertex array picked them up, and what was left after the unload.
+	static void RunHotReloadBenchmark(const std::string& resourceDirectory)
+	{
+		if (Renderer::GetAPI() != RendererAPI::API::Null)
+		{
+			// What is left after the unload is checked against the Null renderer's counts
+			KR_WARN("Hot reload benchmark: runs with --renderer=null only");
+			return;
+		}
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		std::string modelPath;
+		std::string imagePath;
+		std::error_code errorCode;
+
+		Assimp::Importer assImporter;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(resourceDirectory + "/Models", errorCode))
+		{
+			if (entry.is_regular_file() && assImporter.IsExtensionSupported(entry.path().extension().string()) &&
+				(modelPath.empty() || entry.path().string() < modelPath))
+			{
+				modelPath = entry.path().string();
+			}
+		}
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(resourceDirectory + "/Textures", errorCode))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return char(tolower(character)); });
+
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" ||
+				extension == ".bmp") && (imagePath.empty() || entry.path().string() < imagePath))
+			{
+				imagePath = entry.path().string();
+			}
+		}
+
+		if (modelPath.empty() || imagePath.empty())
+		{
+			KR_WARN("Hot reload benchmark: no models or no images in {0}", resourceDirectory);
+			return;
+		}
+
+		// The files are written over, so copies of them. The material libraries of the model (same stem) go along.
+		const std::filesystem::path directory = std::filesystem::temp_directory_path(errorCode) / "KarmaHotReloadBenchmark";
+		std::filesystem::remove_all(directory, errorCode);
+		std::filesystem::create_directories(directory, errorCode);
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(resourceDirectory + "/Models", errorCode))
+		{
+			if (entry.is_regular_file() && entry.path().stem() == std::filesystem::path(modelPath).stem())
+			{
+				std::filesystem::copy_file(entry.path(), directory / entry.path().filename(), std::filesystem::copy_options::overwrite_existing, errorCode);
+			}
+		}
+
+		std::filesystem::copy_file(imagePath, directory / std::filesystem::path(imagePath).filename(), std::filesystem::copy_options::overwrite_existing, errorCode);
+		std::filesystem::copy_file(resourceDirectory + "/Shaders/shader.vert", directory / "shader.vert", std::filesystem::copy_options::overwrite_existing, errorCode);
+		std::filesystem::copy_file(resourceDirectory + "/Shaders/shader.frag", directory / "shader.frag", std::filesystem::copy_options::overwrite_existing, errorCode);
+
+		if (errorCode)
+		{
+			KR_WARN("Hot reload benchmark: couldn't copy the files into {0} ({1})", directory.string(), errorCode.message());
+			std::filesystem::remove_all(directory, errorCode);
+			return;
+		}
+
+		const std::string modelCopy = (directory / std::filesystem::path(modelPath).filename()).generic_string();
+		const std::string imageCopy = (directory / std::filesystem::path(imagePath).filename()).generic_string();
+		const std::string vertexCopy = (directory / "shader.vert").generic_string();
+		const std::string fragmentCopy = (directory / "shader.frag").generic_string();
+
+		const NullRHIStatistics before = NullRendererAPI::GetStatistics();
+
+		AssetManager manager;
+		manager.SetHotReloadEnabled(true);
+
+		{
+			std::shared_ptr<UniformBufferObject> shaderUniform;
+			shaderUniform.reset(UniformBufferObject::Create({ ShaderDataType::Mat4, ShaderDataType::Mat4 }, 0));
+
+			AssetHandle<Shader> shader = manager.LoadShader(vertexCopy, fragmentCopy, shaderUniform, "HotReloadShader");
+			AssetHandle<Texture> texture = manager.LoadTexture(imageCopy, "HotReloadTexture");
+			AssetHandle<Mesh> mesh = manager.LoadMesh(modelCopy);
+			AssetHandle<Material> material = manager.LoadMaterial("HotReloadMaterial", shader, { texture });
+
+			manager.WaitForLoads();
+
+			if (!mesh.IsReady() || !material.IsReady())
+			{
+				KR_WARN("Hot reload benchmark: the copies of {0} and {1} didn't load", modelPath, imagePath);
+			}
+			else
+			{
+				const Mesh* loadedMesh = mesh.Get();
+				const Shader* loadedShader = shader.Get();
+
+				std::shared_ptr<VertexArray> vertexArray;
+				vertexArray.reset(VertexArray::Create());
+				vertexArray->SetMesh(mesh.GetShared());
+				vertexArray->SetMaterial(material.GetShared());
+
+				const uint32_t numberOfWatchedFiles = manager.GetNumberOfWatchedFiles();
+				const AssetStatistics loadStatistics = manager.GetStatistics();
+
+				// Written back as they are, but for a comment more in the fragment shader
+				for (const std::string& filePath : { modelCopy, imageCopy })
+				{
+					std::ifstream input(filePath, std::ios::binary);
+					const std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+					input.close();
+
+					std::ofstream(filePath, std::ios::binary | std::ios::trunc) << contents;
+				}
+
+				{
+					std::ofstream fragmentFile(fragmentCopy, std::ios::app);
+					fragmentFile << "\n// Hot reload benchmark\n";
+				}
+
+				const Clock::time_point written = Clock::now();
+				AssetStatistics statistics = loadStatistics;
+
+				// The frames, till the three are swapped in
+				while (statistics.m_NumberOfReloads + statistics.m_NumberOfFailedReloads < loadStatistics.m_NumberOfReloads + 3 &&
+					Clock::now() - written < std::chrono::seconds(5))
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					manager.Update();
+					manager.ApplyReloads();
+					statistics = manager.GetStatistics();
+				}
+
+				const Clock::time_point swapped = Clock::now();
+
+				const bool bRefreshed = vertexArray->RefreshReloadedAssets();
+				const bool bRefreshedAgain = vertexArray->RefreshReloadedAssets();
+
+				KR_INFO("Hot reload benchmark: {0} files watched ({1}), {2} reloads and {3} failed {4} ms after the writes, {5} ms a reload on average",
+					numberOfWatchedFiles, FileWatcher::UsesNotifications() ? "inotify" : "polling",
+					statistics.m_NumberOfReloads - loadStatistics.m_NumberOfReloads, statistics.m_NumberOfFailedReloads - loadStatistics.m_NumberOfFailedReloads,
+					std::chrono::duration<double, std::milli>(swapped - written).count(),
+					statistics.m_NumberOfReloads ? statistics.m_ReloadMilliseconds / statistics.m_NumberOfReloads : 0.0);
+
+				// The same objects, with new contents, and the vertex array set up once for them
+				if (mesh.Get() != loadedMesh || shader.Get() != loadedShader || mesh->GetGeneration() == 0 || shader->GetGeneration() == 0 ||
+					!bRefreshed || bRefreshedAgain)
+				{
+					KR_WARN("Hot reload benchmark: the reloaded assets weren't swapped into the loaded ones (mesh generation {0}, shader generation {1}, vertex array refreshed {2} then {3})",
+						mesh->GetGeneration(), shader->GetGeneration(), bRefreshed, bRefreshedAgain);
+				}
+			}
+		}
+
+		manager.SetHotReloadEnabled(false);
+		manager.Update();
+
+		if (TextureStreamer::IsSupported())
+		{
+			TextureStreamer::Get().WaitForDecodes();
+			TextureStreamer::Get().Update();
+		}
+
+		const NullRHIStatistics& after = NullRendererAPI::GetStatistics();
+
+		if (after.m_LiveVertexBuffers != before.m_LiveVertexBuffers || after.m_LiveIndexBuffers != before.m_LiveIndexBuffers ||
+			after.m_LiveShaders != before.m_LiveShaders || after.m_ResidentTextureBytes != before.m_ResidentTextureBytes)
+		{
+			KR_WARN("Hot reload benchmark: left after the unload {0} vertex buffers, {1} index buffers, {2} shaders, {3} bytes of textures",
+				int64_t(after.m_LiveVertexBuffers) - before.m_LiveVertexBuffers, int64_t(after.m_LiveIndexBuffers) - before.m_LiveIndexBuffers,
+				int64_t(after.m_LiveShaders) - before.m_LiveShaders, int64_t(after.m_ResidentTextureBytes) - int64_t(before.m_ResidentTextureBytes));
+		}
+
+		std::filesystem::remove_all(directory, errorCode);
+	}
+
+	static BenchmarkOption s_AssetBenchmarkOption("asset-benchmark",
+		"--asset-benchmark[=directory] loads the models and images of the resources directory through an AssetManager headless (with --renderer=null), each twice, and logs the loads, the coalesced requests, the memory report and what is left after the unload (../Resources by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const std::string directory = value.empty() ? "../Resources" : value;
+
+			return new OneShotBenchmark("asset", [directory]() { RunAssetBenchmark(directory); });
+		});
+
+	static BenchmarkOption s_HotReloadBenchmarkOption("hot-reload-benchmark",
+		"--hot-reload-benchmark[=directory] edits copies of a model, an image and the shaders headless (with --renderer=null) and logs how soon the reloads were swapped in (../Resources by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const std::string directory = value.empty() ? "../Resources" : value;
+
+			return new OneShotBenchmark("hot reload", [directory]() { RunHotReloadBenchmark(directory); });
+		});
+}
@@ -0,0 +1,130 @@
+#include "SceneBenchmark.h"
+#include "Platform/Null/NullRendererAPI.h"
+
+#include <set>
+
+namespace Karma
+{
+	// Draws the same scene of proxies twice through the Null renderer, which counts the draw calls: first with shader.vert, a draw per
+	// proxy as before the batching, then with instanced.vert, a draw per (material, vertex array) run. Logs the draw calls and instances
+	// per frame of each. Fails unless the opaque pass makes a draw per proxy without batching, a draw per distinct (mesh, material) pair of
+	// the proxies with it, and the same instances both times.
+	class BatchingBenchmark : public SceneBenchmark
+	{
+	public:
+		BatchingBenchmark(const SceneBenchmarkSettings& settings) : SceneBenchmark("batching", settings), m_NumberOfDrawCalls(0),
+			m_NumberOfInstances(0), m_UnbatchedDrawCalls(0), m_UnbatchedInstances(0), m_bLODsEnabled(true)
+		{
+		}
+
+		virtual bool OnUpdate(float deltaTime) override
+		{
+			if (Renderer::GetAPI() != RendererAPI::API::Null)
+			{
+				KR_WARN("Batching benchmark: runs with --renderer=null only");
+				return true;
+			}
+
+			return SceneBenchmark::OnUpdate(deltaTime);
+		}
+
+	protected:
+		virtual void OnBegin() override
+		{
+			// A level of detail is a vertex array of its own, so the levels picked would split a pair into a batch per level
+			m_bLODsEnabled = Renderer::GetLODSettings().m_bEnabled;
+			Renderer::GetLODSettings().m_bEnabled = false;
+
+			// The counters are the render thread's. The uploads of making the scene are done with by now.
+			RenderThread::WaitForRenderThread();
+
+			const NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+
+			m_NumberOfDrawCalls = statistics.m_NumberOfPassDrawCalls[uint32_t(RenderPassType::Opaque)];
+			m_NumberOfInstances = statistics.m_NumberOfInstances;
+		}
+
+		virtual bool OnEnd() override
+		{
+			RenderThread::WaitForRenderThread();
+
+			Renderer::GetLODSettings().m_bEnabled = m_bLODsEnabled;
+
+			const NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+			const RenderScene& renderScene = m_Scene->GetRenderScene();
+			const RenderSceneStatistics& sceneStatistics = renderScene.GetStatistics();
+
+			// The depth pre-pass, if on, draws the opaque proxies once more
+			const uint64_t drawCalls = (statistics.m_NumberOfPassDrawCalls[uint32_t(RenderPassType::Opaque)] - m_NumberOfDrawCalls) /
+				m_Settings.m_NumberOfFrames;
+			const uint64_t instances = (statistics.m_NumberOfInstances - m_NumberOfInstances) / m_Settings.m_NumberOfFrames;
+
+			std::set<std::pair<const Mesh*, const Material*>> pairs;
+
+			for (const RenderProxy& proxy : renderScene.GetProxies())
+			{
+				pairs.insert(std::make_pair(proxy.m_Mesh, proxy.m_Material));
+			}
+
+			KR_INFO("Batching benchmark ({0}): {1} proxies, {2} (mesh, material) pairs, {3} opaque draw calls and {4} instances per frame, "
+				"{5} batches ({6} instanced)", m_Settings.m_bInstanced ? "instanced" : "a draw per proxy", sceneStatistics.m_NumberOfProxies,
+				pairs.size(), drawCalls, instances, sceneStatistics.m_NumberOfBatches, sceneStatistics.m_NumberOfInstancedBatches);
+
+			if (!m_Settings.m_bInstanced)
+			{
+				m_UnbatchedDrawCalls = drawCalls;
+				m_UnbatchedInstances = instances;
+
+				// Once more, batched
+				m_Settings.m_bInstanced = true;
+
+				return false;
+			}
+
+			if (m_UnbatchedDrawCalls != sceneStatistics.m_NumberOfProxies)
+			{
+				KR_ERROR("Batching benchmark: the frames without batching made {0} opaque draw calls, against {1} proxies", m_UnbatchedDrawCalls,
+					sceneStatistics.m_NumberOfProxies);
+				SetFailed();
+			}
+
+			if (drawCalls != pairs.size())
+			{
+				KR_ERROR("Batching benchmark: the batched frames made {0} opaque draw calls, against {1} (mesh, material) pairs", drawCalls, pairs.size());
+				SetFailed();
+			}
+
+			if (instances != m_UnbatchedInstances)
+			{
+				KR_ERROR("Batching benchmark: the batched frames drew {0} instances, against {1} without batching", instances, m_UnbatchedInstances);
+				SetFailed();
+			}
+
+			return true;
+		}
+
+	private:
+		// Counters at the first frame of the present pass
+		uint64_t m_NumberOfDrawCalls;
+		uint64_t m_NumberOfInstances;
+
+		// Per frame, of the pass without instancing
+		uint64_t m_UnbatchedDrawCalls;
+		uint64_t m_UnbatchedInstances;
+
+		// Put back after each pass
+		bool m_bLODsEnabled;
+	};
+
+	static BenchmarkOption s_BatchingBenchmarkOption("batching-benchmark",
+		"--batching-benchmark[=proxies] checks that the batching draws a scene with a draw call per (mesh, material) pair, exiting non-zero if not (1000 proxies by default, Null only)",
+		[](const std::string& value) -> Benchmark*
+		{
+			SceneBenchmarkSettings settings;
+			settings.m_NumberOfProxies = uint32_t(CommandLine::ParseNumber(value, 1000));
+			settings.m_NumberOfMaterials = 4;
+			settings.m_NumberOfFrames = 10;
+
+			return new BatchingBenchmark(settings);
+		});
+}
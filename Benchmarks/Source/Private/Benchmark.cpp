@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+#include "Karma/EntryPoint.h"
+
+namespace Karma
+{
+	BenchmarkOption::BenchmarkOption(const std::string& name, const std::string& description, BenchmarkFactory factory)
+	{
+		CommandLine::RegisterOption(name, description, [factory](const std::string& value)
+			{
+				GetQueue().push_back(factory(value));
+			});
+	}
+
+	std::vector<Benchmark*>& BenchmarkOption::GetQueue()
+	{
+		// The options register at static initialization, whatever the order of the translation units
+		static std::vector<Benchmark*> queue;
+
+		return queue;
+	}
+
+	BenchmarkLayer::BenchmarkLayer() : Layer("Benchmarks"), m_Current(0), m_NumberOfFailures(0)
+	{
+		if (BenchmarkOption::GetQueue().empty())
+		{
+			KR_WARN("No benchmark asked for, --help lists the options");
+		}
+	}
+
+	BenchmarkLayer::~BenchmarkLayer()
+	{
+		for (Benchmark* benchmark : BenchmarkOption::GetQueue())
+		{
+			delete benchmark;
+		}
+
+		BenchmarkOption::GetQueue().clear();
+	}
+
+	void BenchmarkLayer::OnAttach()
+	{
+	}
+
+	void BenchmarkLayer::OnDetach()
+	{
+	}
+
+	void BenchmarkLayer::OnUpdate(float deltaTime)
+	{
+		std::vector<Benchmark*>& queue = BenchmarkOption::GetQueue();
+
+		if (m_Current >= queue.size())
+		{
+			if (m_NumberOfFailures > 0)
+			{
+				KR_ERROR("{0} of the {1} benchmarks failed", m_NumberOfFailures, queue.size());
+				Application::Get().SetExitCode(1);
+			}
+
+			Application::Get().CloseApplication();
+			return;
+		}
+
+		Benchmark* benchmark = queue[m_Current];
+
+		if (m_Begin == std::chrono::high_resolution_clock::time_point())
+		{
+			KR_INFO("Running the {0} benchmark", benchmark->GetName());
+			m_Begin = std::chrono::high_resolution_clock::now();
+		}
+
+		if (benchmark->OnUpdate(deltaTime))
+		{
+			KR_INFO("The {0} benchmark took {1} s", benchmark->GetName(),
+				std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_Begin).count());
+
+			if (benchmark->HasFailed())
+			{
+				KR_ERROR("The {0} benchmark failed", benchmark->GetName());
+				m_NumberOfFailures++;
+			}
+
+			m_Begin = std::chrono::high_resolution_clock::time_point();
+			m_Current++;
+		}
+	}
+
+	void BenchmarkLayer::KarmaGuiRender(float deltaTime)
+	{
+	}
+
+	void BenchmarkLayer::OnEvent(Event& event)
+	{
+	}
+}
+
+class KarmaBenchmarks : public Karma::Application
+{
+public:
+	KarmaBenchmarks()
+	{
+		PushLayer(new Karma::BenchmarkLayer());
+	}
+};
+
+Karma::Application* Karma::CreateApplication()
+{
+	return new KarmaBenchmarks();
+}
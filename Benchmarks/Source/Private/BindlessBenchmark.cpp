@@ -0,0 +1,90 @@
+#include "SceneBenchmark.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+#include "Platform/Vulkan/VulkanContext.h"
+#include "Platform/Vulkan/VulkanRendererAPI.h"
+#include "Platform/Vulkan/VulkanParallelRecorder.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+
+namespace Karma
+{
+	// Draws a scene of instanced proxies going round many materials (as many textures as the Textures directory has) through the Vulkan
+	// renderer, and logs the descriptor set binds and the recording time per frame, along with the bindless table's counters. The table is
+	// picked at start up, so the comparison is this run against one with --bindless=off.
+	class BindlessBenchmark : public SceneBenchmark
+	{
+	public:
+		BindlessBenchmark(const SceneBenchmarkSettings& settings) : SceneBenchmark("bindless", settings), m_NumberOfDescriptorBinds(0),
+			m_RecordingTimeMicroseconds(0), m_NumberOfDraws(0)
+		{
+		}
+
+		virtual bool OnUpdate(float deltaTime) override
+		{
+			if (Renderer::GetAPI() != RendererAPI::API::Vulkan)
+			{
+				KR_WARN("Bindless benchmark: runs with --renderer=vulkan only");
+				return true;
+			}
+
+			return SceneBenchmark::OnUpdate(deltaTime);
+		}
+
+	protected:
+		virtual void OnFrame(uint32_t frame) override
+		{
+			// The recorder is the render thread's
+			RenderThread::Enqueue([this]()
+				{
+					const ParallelRecordingStatistics& statistics =
+						static_cast<VulkanRendererAPI*>(RenderCommand::GetRendererAPI())->GetParallelRecorder()->GetStatistics();
+
+					m_NumberOfDescriptorBinds += statistics.m_NumberOfDescriptorBinds;
+					m_RecordingTimeMicroseconds += statistics.m_RecordingTimeMicroseconds;
+					m_NumberOfDraws += statistics.m_NumberOfDraws;
+				});
+		}
+
+		virtual bool OnEnd() override
+		{
+			RenderThread::WaitForRenderThread();
+
+			const uint64_t numberOfFrames = m_Settings.m_NumberOfFrames;
+			VulkanBindlessTable* bindlessTable = VulkanHolder::GetVulkanContext()->GetBindlessTable();
+
+			KR_INFO("Bindless benchmark ({0}): {1} proxies, {2} materials, {3} draws, {4} descriptor binds and {5} us recording per frame",
+				bindlessTable ? "bindless" : "per material sets", m_Settings.m_NumberOfProxies, m_Settings.m_NumberOfMaterials, m_NumberOfDraws / numberOfFrames,
+				m_NumberOfDescriptorBinds / numberOfFrames, m_RecordingTimeMicroseconds / numberOfFrames);
+
+			if (bindlessTable)
+			{
+				const BindlessStatistics& statistics = bindlessTable->GetStatistics();
+
+				KR_INFO("Bindless benchmark: {0} textures and {1} materials in the table, {2} texture writes", statistics.m_NumberOfTextures,
+					statistics.m_NumberOfMaterials, statistics.m_TextureWrites);
+			}
+			else
+			{
+				KR_INFO("Bindless benchmark: no bindless table (--bindless=off, or no descriptor indexing on the device)");
+			}
+
+			return true;
+		}
+
+	private:
+		// Written by the render thread, read after WaitForRenderThread
+		uint64_t m_NumberOfDescriptorBinds;
+		uint64_t m_RecordingTimeMicroseconds;
+		uint64_t m_NumberOfDraws;
+	};
+
+	static BenchmarkOption s_BindlessBenchmarkOption("bindless-benchmark",
+		"--bindless-benchmark[=materials] counts the descriptor binds of a scene of many materials, to compare with a --bindless=off run (64 by default, Vulkan only)",
+		[](const std::string& value) -> Benchmark*
+		{
+			SceneBenchmarkSettings settings;
+			settings.m_NumberOfMaterials = uint32_t(CommandLine::ParseNumber(value, 64));
+			settings.m_bInstanced = true;
+
+			return new BindlessBenchmark(settings);
+		});
+}
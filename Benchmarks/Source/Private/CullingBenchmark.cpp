@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "Karma/Renderer/FrustumCuller.h"
+
+#include <random>
+
+namespace Karma
+{
+	// Culls numberOfObjects random bounds (spheres and boxes scattered all around the camera, so that most are culled) against the frustum
+	// of a perspective camera, with the calling thread alone and then with 1, 3 and 7 workers besides it. Logs the visible and culled
+	// counts and the average time of a Cull for each.
+	static void RunCullingBenchmark(uint32_t numberOfObjects)
+	{
+		const uint32_t numberOfRepeats = 20;
+		const uint32_t numberOfWorkers[] = { 0, 1, 3, 7 };
+
+		PerspectiveCamera camera(45.0f, 1280.0f / 720.0f, 0.1f, 100.0f);
+		const Frustum frustum = camera.GetFrustum();
+
+		// Same bounds from run to run
+		std::mt19937 generator(2718);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> size(0.1f, 2.0f);
+
+		RenderBoundsStream boundsStream;
+
+		for (uint32_t counter = 0; counter < numberOfObjects; counter++)
+		{
+			RenderBounds bounds;
+			bounds.m_Center = glm::vec3(position(generator), position(generator), position(generator));
+			bounds.m_Extents = glm::vec3(size(generator), size(generator), size(generator));
+			bounds.m_Radius = glm::length(bounds.m_Extents);
+
+			boundsStream.PushBack(bounds);
+		}
+
+		FrustumCuller culler;
+
+		for (uint32_t workers : numberOfWorkers)
+		{
+			culler.SetNumberOfWorkers(workers);
+
+			uint64_t cullTimeMicroseconds = 0;
+
+			for (uint32_t counter = 0; counter < numberOfRepeats; counter++)
+			{
+				culler.Cull(frustum, boundsStream);
+				cullTimeMicroseconds += culler.GetStatistics().m_CullTimeMicroseconds;
+			}
+
+			const FrustumCullingStatistics& statistics = culler.GetStatistics();
+
+			KR_INFO("Culling benchmark: {0} threads, {1} tested, {2} visible, {3} culled in {4} chunks, {5} us per cull on average (batches of {6})",
+				workers + 1, statistics.m_NumberOfTested, statistics.m_NumberOfVisible, statistics.m_NumberOfCulled, statistics.m_NumberOfChunks,
+				cullTimeMicroseconds / numberOfRepeats, FrustumCuller::s_BatchWidth);
+		}
+	}
+
+	static BenchmarkOption s_CullingBenchmarkOption("culling-benchmark",
+		"--culling-benchmark[=n] times the frustum culling of n random bounds on 1 to 8 threads (100000 by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfObjects = uint32_t(CommandLine::ParseNumber(value, 100000));
+
+			return new OneShotBenchmark("culling", [numberOfObjects]() { RunCullingBenchmark(numberOfObjects); });
+		});
+}
@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+#include "Karma/JobPool.h"
+#include "Karma/Renderer/VertexConversionProgram.h"
+
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+
+namespace Karma
+{
+	// Times the Assimp import (ModelImporter, converting on the calling thread only and on the loading pool) against cooking and
+	// against mapping the cooked file, for every model of the directory
+	static void RunMeshLoadBenchmark(const std::string& directory)
+	{
+		std::vector<std::string> modelPaths;
+		std::error_code errorCode;
+
+		Assimp::Importer assImporter;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, errorCode))
+		{
+			// Material libraries and the cooked files sit next to the models
+			if (entry.is_regular_file() && assImporter.IsExtensionSupported(entry.path().extension().string()))
+			{
+				modelPaths.push_back(entry.path().string());
+			}
+		}
+
+		if (errorCode || modelPaths.empty())
+		{
+			KR_WARN("Mesh load benchmark: no models in {0}", directory);
+			return;
+		}
+
+		std::sort(modelPaths.begin(), modelPaths.end());
+
+		const bool bFlipUVs = RendererAPI::GetAPI() == RendererAPI::API::Vulkan;
+
+		for (const std::string& modelPath : modelPaths)
+		{
+			typedef std::chrono::high_resolution_clock Clock;
+
+			// What Mesh does without cooked files, converting on one thread and then on the loading pool
+			ImportedModel model;
+			ModelImportStatistics serialStatistics, parallelStatistics;
+
+			ModelImporter::Import(modelPath, bFlipUVs, model, nullptr, &serialStatistics);
+
+			model = ImportedModel();
+			Clock::time_point serialImported = Clock::now();
+			ModelImporter::Import(modelPath, bFlipUVs, model, &JobPool::GetLoadingPool(), &parallelStatistics);
+			Clock::time_point imported = Clock::now();
+
+			std::string cookedPath = CookedMesh::GetCookedPath(modelPath);
+			bool bCooked = CookedMesh::Cook(modelPath, cookedPath, bFlipUVs);
+			Clock::time_point cooked = Clock::now();
+
+			if (!bCooked)
+			{
+				continue;
+			}
+
+			// Mapping alone touches nothing, the validation reads every page as the upload would
+			CookedMesh cookedMesh;
+			bool bValid = cookedMesh.Load(cookedPath, bFlipUVs) && cookedMesh.Validate();
+			Clock::time_point loaded = Clock::now();
+
+			double importMilliseconds = std::chrono::duration<double, std::milli>(imported - serialImported).count();
+			double cookMilliseconds = std::chrono::duration<double, std::milli>(cooked - imported).count();
+			double loadMilliseconds = std::chrono::duration<double, std::milli>(loaded - cooked).count();
+
+			KR_INFO("Mesh load benchmark {0}: {1} submeshes, Assimp read {2} ms, conversion {3} ms on 1 thread and {4} ms on {5} threads",
+				modelPath, parallelStatistics.m_NumberOfSubmeshes, parallelStatistics.m_ReadMilliseconds, serialStatistics.m_ConvertMilliseconds,
+				parallelStatistics.m_ConvertMilliseconds, parallelStatistics.m_NumberOfThreads);
+
+			KR_INFO("Mesh load benchmark {0}: Assimp import {1} ms, cook {2} ms, cooked load {3} ms ({4}x){5}", modelPath,
+				importMilliseconds, cookMilliseconds, loadMilliseconds, loadMilliseconds > 0.0 ? importMilliseconds / loadMilliseconds : 0.0,
+				bValid ? "" : ", content hash mismatch");
+		}
+	}
+
+	// Interleaves a made up mesh (positions, UVs, colors, normals and tangents) with Mesh::LayoutElementToAttributeValue and with a
+	// VertexConversionProgram, and checks that both agree
+	static void RunInterleaveBenchmark(uint32_t numberOfVertices)
+	{
+		Mesh::InitializeAttributeDictionary();
+
+		// The arrays go with the aiMesh
+		aiMesh* meshToProcess = new aiMesh();
+		meshToProcess->mNumVertices = numberOfVertices;
+		meshToProcess->mVertices = new aiVector3D[numberOfVertices];
+		meshToProcess->mNormals = new aiVector3D[numberOfVertices];
+		meshToProcess->mTangents = new aiVector3D[numberOfVertices];
+		meshToProcess->mBitangents = new aiVector3D[numberOfVertices];
+		meshToProcess->mTextureCoords[0] = new aiVector3D[numberOfVertices];
+		meshToProcess->mNumUVComponents[0] = 2;
+		meshToProcess->mColors[0] = new aiColor4D[numberOfVertices];
+
+		for (uint32_t counter = 0; counter < numberOfVertices; counter++)
+		{
+			float value = float(counter);
+
+			meshToProcess->mVertices[counter] = aiVector3D(value, value + 0.25f, value + 0.5f);
+			meshToProcess->mNormals[counter] = aiVector3D(0.0f, 1.0f, value);
+			meshToProcess->mTangents[counter] = aiVector3D(1.0f, value, 0.0f);
+			meshToProcess->mBitangents[counter] = aiVector3D(0.0f, 0.0f, 1.0f);
+			meshToProcess->mTextureCoords[0][counter] = aiVector3D(value * 0.5f, value * 0.125f, 0.0f);
+			meshToProcess->mColors[0][counter] = aiColor4D(value, 0.5f, 0.25f, 1.0f);
+		}
+
+		BufferLayout layout;
+		Mesh::GaugeVertexDataLayout(meshToProcess, layout);
+
+		const uint32_t strideInFloats = layout.GetStride() / sizeof(float);
+
+		std::vector<float> lookedUp(size_t(numberOfVertices) * strideInFloats);
+		std::vector<float> converted(size_t(numberOfVertices) * strideInFloats);
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		// The per float path DealVertexIndexBufferData had
+		Clock::time_point begin = Clock::now();
+
+		uint32_t counter = 0;
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			for (const auto& layoutElem : layout.GetElements())
+			{
+				for (uint32_t component = 0; component < layoutElem.GetComponentCount(); component++)
+				{
+					lookedUp[counter++] = Mesh::LayoutElementToAttributeValue(vertex, component, meshToProcess, layoutElem);
+				}
+			}
+		}
+
+		Clock::time_point lookedUpEnd = Clock::now();
+
+		VertexConversionProgram program(layout);
+		program.Convert(meshToProcess, converted.data());
+
+		Clock::time_point convertedEnd = Clock::now();
+
+		double lookupMilliseconds = std::chrono::duration<double, std::milli>(lookedUpEnd - begin).count();
+		double programMilliseconds = std::chrono::duration<double, std::milli>(convertedEnd - lookedUpEnd).count();
+
+		bool bSame = lookedUp == converted;
+
+		KR_INFO("Vertex interleave benchmark ({0} vertices, {1} floats each): per float lookups {2} ms, conversion program {3} ms ({4}x){5}",
+			numberOfVertices, strideInFloats, lookupMilliseconds, programMilliseconds,
+			programMilliseconds > 0.0 ? lookupMilliseconds / programMilliseconds : 0.0, bSame ? "" : ", results differ");
+
+		delete meshToProcess;
+	}
+
+	static BenchmarkOption s_MeshBenchmarkOption("mesh-benchmark",
+		"--mesh-benchmark[=directory] times the Assimp import against the cooked load for the models of the directory (../Resources/Models by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const std::string directory = value.empty() ? "../Resources/Models" : value;
+
+			return new OneShotBenchmark("mesh load", [directory]() { RunMeshLoadBenchmark(directory); });
+		});
+
+	static BenchmarkOption s_InterleaveBenchmarkOption("interleave-benchmark",
+		"--interleave-benchmark[=vertices] times the per float interleaving against the VertexConversionProgram (a million vertices by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfVertices = uint32_t(CommandLine::ParseNumber(value, 1000000));
+
+			return new OneShotBenchmark("vertex interleave", [numberOfVertices]() { RunInterleaveBenchmark(numberOfVertices); });
+		});
+}
@@ -0,0 +1,87 @@
+#include "SceneBenchmark.h"
+#include "Platform/Null/NullRendererAPI.h"
+
+namespace Karma
+{
+	// Draws a scene of proxies (10k by default) with whichever renderer is picked, --renderer=null or Vulkan on lavapipe being the headless
+	// ones. A tenth of the proxies moves every frame, going through RenderScene as transform deltas. Logs the average time of applying the
+	// deltas and of walking the proxies, and with the Null renderer the draw calls it counted.
+	class ProxyBenchmark : public SceneBenchmark
+	{
+	public:
+		ProxyBenchmark(const SceneBenchmarkSettings& settings) : SceneBenchmark("proxy", settings), m_ApplyTimeMicroseconds(0),
+			m_SubmitTimeMicroseconds(0), m_NumberOfUpdates(0), m_NumberOfDrawCalls(0)
+		{
+		}
+
+	protected:
+		virtual void OnBegin() override
+		{
+			const RenderSceneStatistics& statistics = m_Scene->GetRenderScene().GetStatistics();
+
+			KR_INFO("Proxy benchmark: {0} proxies added in {1} us", statistics.m_NumberOfAdds, statistics.m_ApplyTimeMicroseconds);
+
+			m_ApplyTimeMicroseconds = 0;
+			m_SubmitTimeMicroseconds = 0;
+			m_NumberOfUpdates = 0;
+
+			// The counters are the render thread's
+			RenderThread::WaitForRenderThread();
+			m_NumberOfDrawCalls = NullRendererAPI::GetStatistics().m_NumberOfDrawCalls;
+		}
+
+		virtual void OnFrame(uint32_t frame) override
+		{
+			RenderScene& renderScene = m_Scene->GetRenderScene();
+			const RenderSceneStatistics& statistics = renderScene.GetStatistics();
+
+			m_ApplyTimeMicroseconds += statistics.m_ApplyTimeMicroseconds;
+			m_SubmitTimeMicroseconds += statistics.m_SubmitTimeMicroseconds;
+			m_NumberOfUpdates += statistics.m_NumberOfUpdates;
+
+			// Every tenth proxy, a different tenth each frame, bobs up or down for the next frame
+			const float offset = (frame & 1) ? -0.1f : 0.1f;
+
+			for (size_t counter = frame % 10; counter < m_Proxies.size(); counter += 10)
+			{
+				m_WorldMatrices[counter][3][2] += offset;
+				renderScene.UpdateTransform(m_Proxies[counter], m_WorldMatrices[counter]);
+			}
+		}
+
+		virtual bool OnEnd() override
+		{
+			const uint32_t numberOfFrames = m_Settings.m_NumberOfFrames;
+			const RenderSceneStatistics& statistics = m_Scene->GetRenderScene().GetStatistics();
+
+			KR_INFO("Proxy benchmark: {0} proxies over {1} frames, {2} us submit and {3} us applying {4} updates per frame on average, {5} batches",
+				statistics.m_NumberOfProxies, numberOfFrames, m_SubmitTimeMicroseconds / numberOfFrames, m_ApplyTimeMicroseconds / numberOfFrames,
+				m_NumberOfUpdates / numberOfFrames, statistics.m_NumberOfBatches);
+
+			if (Renderer::GetAPI() == RendererAPI::API::Null)
+			{
+				RenderThread::WaitForRenderThread();
+
+				KR_INFO("Proxy benchmark: {0} draw calls per frame", (NullRendererAPI::GetStatistics().m_NumberOfDrawCalls - m_NumberOfDrawCalls) / numberOfFrames);
+			}
+
+			return true;
+		}
+
+	private:
+		uint64_t m_ApplyTimeMicroseconds;
+		uint64_t m_SubmitTimeMicroseconds;
+		uint64_t m_NumberOfUpdates;
+		uint64_t m_NumberOfDrawCalls;
+	};
+
+	static BenchmarkOption s_ProxyBenchmarkOption("proxy-benchmark",
+		"--proxy-benchmark[=proxies] draws a scene of proxies, a tenth of them moving, and times the deltas and the submission (10000 by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			SceneBenchmarkSettings settings;
+			settings.m_NumberOfProxies = uint32_t(CommandLine::ParseNumber(value, 10000));
+
+			return new ProxyBenchmark(settings);
+		});
+}
@@ -0,0 +1,129 @@
+#include "SceneBenchmark.h"
+#include "Platform/Vulkan/VulkanRendererAPI.h"
+#include "Platform/Vulkan/VulkanParallelRecorder.h"
+
+namespace Karma
+{
+	// Draws a scene of non instanced proxies (a draw each) for a few frames with each of 0, 1, 3, 7 and 15 recorder workers, that is 1 to 16
+	// recording threads, and logs the average recording time of the draw list for each.
+	class RecordingBenchmark : public SceneBenchmark
+	{
+	public:
+		RecordingBenchmark(const SceneBenchmarkSettings& settings) : SceneBenchmark("recording", settings), m_OriginalNumberOfWorkers(0)
+		{
+			m_Settings.m_NumberOfFrames = s_NumberOfSteps * s_FramesPerStep;
+		}
+
+		virtual bool OnUpdate(float deltaTime) override
+		{
+			if (Renderer::GetAPI() != RendererAPI::API::Vulkan)
+			{
+				KR_WARN("Recording benchmark: runs with --renderer=vulkan only");
+				return true;
+			}
+
+			return SceneBenchmark::OnUpdate(deltaTime);
+		}
+
+	protected:
+		virtual void OnBegin() override
+		{
+			for (uint32_t step = 0; step < s_NumberOfSteps; step++)
+			{
+				m_Results[step] = StepResult();
+			}
+
+			// The recorder is the render thread's, so the workers are changed and the counters read there
+			RenderThread::Enqueue([this]()
+				{
+					VulkanParallelRecorder* recorder = GetRecorder();
+
+					m_OriginalNumberOfWorkers = recorder->GetNumberOfWorkers();
+					recorder->SetNumberOfWorkers(s_NumberOfWorkers[0]);
+				});
+		}
+
+		virtual void OnFrame(uint32_t frame) override
+		{
+			const uint32_t step = frame / s_FramesPerStep;
+			const uint32_t stepFrame = frame % s_FramesPerStep;
+
+			RenderThread::Enqueue([this, step, stepFrame]()
+				{
+					VulkanParallelRecorder* recorder = GetRecorder();
+
+					// The first frames after the workers changed warm the command pools up
+					if (stepFrame >= s_WarmUpFrames)
+					{
+						const ParallelRecordingStatistics& statistics = recorder->GetStatistics();
+						StepResult& result = m_Results[step];
+
+						result.m_RecordingTimeMicroseconds += statistics.m_RecordingTimeMicroseconds;
+						result.m_NumberOfDraws = statistics.m_NumberOfDraws;
+						result.m_NumberOfChunks = statistics.m_NumberOfChunks;
+						result.m_NumberOfFrames++;
+					}
+
+					if (stepFrame == s_FramesPerStep - 1 && step + 1 < s_NumberOfSteps)
+					{
+						recorder->SetNumberOfWorkers(s_NumberOfWorkers[step + 1]);
+					}
+				});
+		}
+
+		virtual bool OnEnd() override
+		{
+			RenderThread::WaitForRenderThread();
+
+			for (uint32_t step = 0; step < s_NumberOfSteps; step++)
+			{
+				const StepResult& result = m_Results[step];
+
+				KR_INFO("Recording benchmark: {0} threads, {1} draws in {2} chunks, {3} us per frame on average", s_NumberOfWorkers[step] + 1,
+					result.m_NumberOfDraws, result.m_NumberOfChunks, result.m_NumberOfFrames ? result.m_RecordingTimeMicroseconds / result.m_NumberOfFrames : 0);
+			}
+
+			const uint32_t originalNumberOfWorkers = m_OriginalNumberOfWorkers;
+
+			RenderThread::Enqueue([originalNumberOfWorkers]()
+				{
+					GetRecorder()->SetNumberOfWorkers(originalNumberOfWorkers);
+				});
+
+			return true;
+		}
+
+	private:
+		static VulkanParallelRecorder* GetRecorder()
+		{
+			return static_cast<VulkanRendererAPI*>(RenderCommand::GetRendererAPI())->GetParallelRecorder();
+		}
+
+		struct StepResult
+		{
+			uint64_t m_RecordingTimeMicroseconds = 0;
+			uint32_t m_NumberOfDraws = 0;
+			uint32_t m_NumberOfChunks = 0;
+			uint32_t m_NumberOfFrames = 0;
+		};
+
+		static constexpr uint32_t s_NumberOfSteps = 5;
+		static constexpr uint32_t s_NumberOfWorkers[s_NumberOfSteps] = { 0, 1, 3, 7, 15 };
+		static constexpr uint32_t s_WarmUpFrames = 3;
+		static constexpr uint32_t s_FramesPerStep = 23;
+
+		// Written by the render thread, read after WaitForRenderThread
+		StepResult m_Results[s_NumberOfSteps];
+		uint32_t m_OriginalNumberOfWorkers;
+	};
+
+	static BenchmarkOption s_RecordingBenchmarkOption("recording-benchmark",
+		"--recording-benchmark[=proxies] times the parallel recording of a draw per proxy on 1 to 16 threads (10000 proxies by default, Vulkan only)",
+		[](const std::string& value) -> Benchmark*
+		{
+			SceneBenchmarkSettings settings;
+			settings.m_NumberOfProxies = uint32_t(CommandLine::ParseNumber(value, 10000));
+
+			return new RecordingBenchmark(settings);
+		});
+}
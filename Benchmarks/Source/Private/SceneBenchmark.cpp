@@ -0,0 +1,172 @@
+#include "SceneBenchmark.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+
+namespace Karma
+{
+	SceneBenchmark::SceneBenchmark(const std::string& name, const SceneBenchmarkSettings& settings) : Benchmark(name), m_Settings(settings),
+		m_Frame(0), m_bMade(false)
+	{
+	}
+
+	bool SceneBenchmark::MakeScene()
+	{
+		const std::string& directory = m_Settings.m_ResourceDirectory;
+
+		std::vector<std::string> imagePaths;
+		std::error_code errorCode;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory + "/Textures", errorCode))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return char(tolower(character)); });
+
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg"))
+			{
+				imagePaths.push_back(entry.path().string());
+			}
+		}
+
+		if (imagePaths.empty())
+		{
+			KR_WARN("{0} benchmark: no images in {1}/Textures", GetName(), directory);
+			return false;
+		}
+
+		std::sort(imagePaths.begin(), imagePaths.end());
+
+		AssetManager& assetManager = AssetManager::Get();
+
+		// The vertex arrays made below create pipelines and descriptor sets, which the render thread may be drawing the previous frame with
+		RenderThread::WaitForRenderThread();
+
+		m_Mesh = assetManager.LoadMesh(directory + "/" + m_Settings.m_ModelPath, AssetPriority::Immediate);
+
+		if (!m_Mesh.IsReady())
+		{
+			KR_WARN("{0} benchmark: couldn't load {1}", GetName(), m_Settings.m_ModelPath);
+			return false;
+		}
+
+		const std::string shaderName = m_Settings.m_bInstanced ? "SceneBenchmarkInstancedShader" : "SceneBenchmarkShader";
+
+		std::shared_ptr<UniformBufferObject> shaderUniform;
+		shaderUniform.reset(UniformBufferObject::Create({ ShaderDataType::Mat4, ShaderDataType::Mat4 }, 0));
+
+		m_Shader = assetManager.LoadShader(directory + (m_Settings.m_bInstanced ? "/Shaders/instanced.vert" : "/Shaders/shader.vert"),
+			directory + "/Shaders/shader.frag", shaderUniform, shaderName, AssetPriority::Immediate);
+
+		// Far enough for the grid to fit in the 45 degrees of the camera, with room to spare
+		const float spacing = 2.0f * std::max(m_Mesh->GetBounds().m_Radius, 0.5f);
+		const uint32_t side = std::max(1u, uint32_t(std::ceil(std::sqrt(float(m_Settings.m_NumberOfProxies)))));
+		const float distance = 1.5f * float(side) * spacing;
+
+		m_Camera.reset(new PerspectiveCamera(45.0f, 1280.0f / 720.0f, 0.1f, 2.0f * distance + 10.0f * spacing));
+
+		m_Scene.reset(new Scene());
+		m_Scene->AddCamera(m_Camera);
+		m_Scene->SetClearColor({ 0.0f, 0.0f, 0.0f, 1.0f });
+
+		m_Textures.clear();
+		m_Materials.clear();
+
+		std::vector<std::shared_ptr<VertexArray>> vertexArrays;
+
+		for (uint32_t counter = 0; counter < std::max(1u, m_Settings.m_NumberOfMaterials); counter++)
+		{
+			if (counter < imagePaths.size())
+			{
+				m_Textures.push_back(assetManager.LoadTexture(imagePaths[counter], "SceneBenchmarkTexture", "texSampler", AssetPriority::Immediate));
+			}
+
+			AssetHandle<Material> material = assetManager.LoadMaterial(shaderName + "Material" + std::to_string(counter), m_Shader,
+				{ m_Textures[counter % m_Textures.size()] }, AssetPriority::Immediate);
+			material->AttatchMainCamera(m_Camera);
+
+			std::shared_ptr<VertexArray> vertexArray(VertexArray::Create());
+			vertexArray->SetMesh(m_Mesh.GetShared());
+			vertexArray->SetMaterial(material.GetShared());
+
+			m_Scene->AddVertexArray(vertexArray);
+
+			m_Materials.push_back(material);
+			vertexArrays.push_back(vertexArray);
+		}
+
+		// The camera looks down -x from (2.5, 0, 1), with z up. The grid stands across y and z.
+		RenderScene& renderScene = m_Scene->GetRenderScene();
+		const glm::vec3 gridCenter = m_Camera->GetPosition() - glm::vec3(distance, 0.0f, 0.0f);
+
+		m_Proxies.clear();
+		m_WorldMatrices.clear();
+
+		for (uint32_t counter = 0; counter < m_Settings.m_NumberOfProxies; counter++)
+		{
+			const float y = (float(counter % side) - 0.5f * float(side - 1)) * spacing;
+			const float z = (float(counter / side) - 0.5f * float(side - 1)) * spacing;
+
+			const glm::mat4 worldMatrix = glm::translate(glm::mat4(1.0f), gridCenter + glm::vec3(0.0f, y, z));
+			const uint32_t materialIndex = counter % uint32_t(vertexArrays.size());
+
+			m_Proxies.push_back(renderScene.AddProxy(vertexArrays[materialIndex], m_Mesh.GetShared(), m_Materials[materialIndex].GetShared(), worldMatrix));
+			m_WorldMatrices.push_back(worldMatrix);
+		}
+
+		renderScene.ApplyDeltas();
+
+		return true;
+	}
+
+	bool SceneBenchmark::OnUpdate(float deltaTime)
+	{
+		if (!m_bMade)
+		{
+			m_bMade = true;
+
+			if (!MakeScene())
+			{
+				return true;
+			}
+
+			OnBegin();
+		}
+
+		if (m_Scene == nullptr)
+		{
+			return true;
+		}
+
+		RenderCommand::SetClearColor(m_Scene->GetClearColor());
+		RenderCommand::Clear();
+
+		Renderer::BeginScene(m_Scene);
+		Renderer::Submit(m_Scene);
+		Renderer::EndScene();
+
+		OnFrame(m_Frame);
+
+		if (++m_Frame < m_Settings.m_NumberOfFrames)
+		{
+			return false;
+		}
+
+		const bool bDone = OnEnd();
+
+		// The proxies hold on to the vertex arrays, the handles to the assets
+		m_Scene.reset();
+		m_Proxies.clear();
+		m_WorldMatrices.clear();
+		m_Materials.clear();
+		m_Textures.clear();
+		m_Shader.Reset();
+		m_Mesh.Reset();
+
+		m_Frame = 0;
+		m_bMade = false;
+
+		return bDone;
+	}
+}
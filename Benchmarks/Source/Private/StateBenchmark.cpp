@@ -0,0 +1,369 @@
+#include "SceneBenchmark.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
+#include <set>
+
+namespace Karma
+{
+	// The GL calls the OpenGLStateCache filters, one kind each
+	enum class GLCallKind : uint32_t
+	{
+		Program = 0,
+		VertexArray,
+		Texture,
+		BufferRange,
+		Uniform,
+		Count
+	};
+
+	static const char* s_GLCallKindNames[uint32_t(GLCallKind::Count)] = { "programs", "vertex arrays", "textures", "buffer ranges", "uniforms" };
+
+	struct GLCallCounts
+	{
+		// Reached OpenGL through the glad function pointer
+		uint64_t m_Intercepted = 0;
+
+		// Of those, the ones setting what OpenGL held already
+		uint64_t m_Redundant = 0;
+
+		// Redundant ones which were the first on their binding point in the frame. The cache starts a frame not knowing the state (KarmaGui
+		// invalidates it after drawing), so these are not its to filter.
+		uint64_t m_FirstRedundant = 0;
+
+		// Asked of the cache and issued by it, by its own counters
+		uint64_t m_Requested = 0;
+		uint64_t m_Issued = 0;
+	};
+
+	// Swaps the glad function pointers of the filtered calls for counting ones while a frame of the scene is drawn. Before passing a call on,
+	// each asks OpenGL for the state the call sets, so that redundant calls are told from OpenGL itself and not from the cache's book keeping.
+	class GLCallInterceptor
+	{
+	public:
+		static void Install()
+		{
+			s_UseProgram = glad_glUseProgram;
+			s_BindVertexArray = glad_glBindVertexArray;
+			s_BindTexture = glad_glBindTexture;
+			s_BindBufferRange = glad_glBindBufferRange;
+			s_Uniform1i = glad_glUniform1i;
+
+			glad_glUseProgram = &UseProgram;
+			glad_glBindVertexArray = &BindVertexArray;
+			glad_glBindTexture = &BindTexture;
+			glad_glBindBufferRange = &BindBufferRange;
+			glad_glUniform1i = &Uniform1i;
+
+			for (std::set<uint64_t>& bindingPoints : s_BindingPoints)
+			{
+				bindingPoints.clear();
+			}
+
+			s_StatisticsAtInstall = OpenGLStateCache::GetStatistics();
+		}
+
+		static void Uninstall()
+		{
+			glad_glUseProgram = s_UseProgram;
+			glad_glBindVertexArray = s_BindVertexArray;
+			glad_glBindTexture = s_BindTexture;
+			glad_glBindBufferRange = s_BindBufferRange;
+			glad_glUniform1i = s_Uniform1i;
+
+			const OpenGLStateStatistics& statistics = OpenGLStateCache::GetStatistics();
+			const OpenGLStateStatistics& before = s_StatisticsAtInstall;
+
+			AddCacheCounts(GLCallKind::Program, statistics.m_ProgramBindsRequested - before.m_ProgramBindsRequested,
+				statistics.m_ProgramBindsIssued - before.m_ProgramBindsIssued);
+			AddCacheCounts(GLCallKind::VertexArray, statistics.m_VertexArrayBindsRequested - before.m_VertexArrayBindsRequested,
+				statistics.m_VertexArrayBindsIssued - before.m_VertexArrayBindsIssued);
+			AddCacheCounts(GLCallKind::Texture, statistics.m_TextureBindsRequested - before.m_TextureBindsRequested,
+				statistics.m_TextureBindsIssued - before.m_TextureBindsIssued);
+			AddCacheCounts(GLCallKind::BufferRange, statistics.m_BufferRangeBindsRequested - before.m_BufferRangeBindsRequested,
+				statistics.m_BufferRangeBindsIssued - before.m_BufferRangeBindsIssued);
+			AddCacheCounts(GLCallKind::Uniform, statistics.m_UniformSetsRequested - before.m_UniformSetsRequested,
+				statistics.m_UniformSetsIssued - before.m_UniformSetsIssued);
+		}
+
+		static void ResetCounts()
+		{
+			for (GLCallCounts& counts : s_Counts)
+			{
+				counts = GLCallCounts();
+			}
+		}
+
+		static const GLCallCounts& GetCounts(GLCallKind kind) { return s_Counts[uint32_t(kind)]; }
+
+	private:
+		static void APIENTRY UseProgram(GLuint program)
+		{
+			GLint current = 0;
+			glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+
+			Count(GLCallKind::Program, 0, GLuint(current) == program);
+			s_UseProgram(program);
+		}
+
+		static void APIENTRY BindVertexArray(GLuint vertexArray)
+		{
+			GLint current = 0;
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &current);
+
+			Count(GLCallKind::VertexArray, 0, GLuint(current) == vertexArray);
+			s_BindVertexArray(vertexArray);
+		}
+
+		static void APIENTRY BindTexture(GLenum target, GLuint texture)
+		{
+			GLint unit = 0;
+			glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+
+			GLenum bindingQuery = GL_NONE;
+			switch (target)
+			{
+				case GL_TEXTURE_2D:
+					bindingQuery = GL_TEXTURE_BINDING_2D;
+					break;
+				case GL_TEXTURE_2D_ARRAY:
+					bindingQuery = GL_TEXTURE_BINDING_2D_ARRAY;
+					break;
+				case GL_TEXTURE_3D:
+					bindingQuery = GL_TEXTURE_BINDING_3D;
+					break;
+				case GL_TEXTURE_CUBE_MAP:
+					bindingQuery = GL_TEXTURE_BINDING_CUBE_MAP;
+					break;
+				default:
+					break;
+			}
+
+			// Targets not looked up count as changing the state
+			GLint current = -1;
+			if (bindingQuery != GL_NONE)
+			{
+				glGetIntegerv(bindingQuery, &current);
+			}
+
+			Count(GLCallKind::Texture, (uint64_t(uint32_t(unit)) << 32) | target, current >= 0 && GLuint(current) == texture);
+			s_BindTexture(target, texture);
+		}
+
+		static void APIENTRY BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+		{
+			GLenum bufferQuery = GL_NONE;
+			GLenum startQuery = GL_NONE;
+			GLenum sizeQuery = GL_NONE;
+
+			if (target == GL_UNIFORM_BUFFER)
+			{
+				bufferQuery = GL_UNIFORM_BUFFER_BINDING;
+				startQuery = GL_UNIFORM_BUFFER_START;
+				sizeQuery = GL_UNIFORM_BUFFER_SIZE;
+			}
+			else if (target == GL_SHADER_STORAGE_BUFFER)
+			{
+				bufferQuery = GL_SHADER_STORAGE_BUFFER_BINDING;
+				startQuery = GL_SHADER_STORAGE_BUFFER_START;
+				sizeQuery = GL_SHADER_STORAGE_BUFFER_SIZE;
+			}
+
+			bool bRedundant = false;
+			if (bufferQuery != GL_NONE)
+			{
+				GLint currentBuffer = 0;
+				GLint64 currentStart = 0;
+				GLint64 currentSize = 0;
+
+				glGetIntegeri_v(bufferQuery, index, &currentBuffer);
+				glGetInteger64i_v(startQuery, index, &currentStart);
+				glGetInteger64i_v(sizeQuery, index, &currentSize);
+
+				bRedundant = GLuint(currentBuffer) == buffer && currentStart == GLint64(offset) && currentSize == GLint64(size);
+			}
+
+			Count(GLCallKind::BufferRange, (uint64_t(target) << 32) | index, bRedundant);
+			s_BindBufferRange(target, index, buffer, offset, size);
+		}
+
+		static void APIENTRY Uniform1i(GLint location, GLint value)
+		{
+			GLint program = 0;
+			glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+			GLint current = 0;
+			glGetUniformiv(GLuint(program), location, &current);
+
+			Count(GLCallKind::Uniform, (uint64_t(uint32_t(program)) << 32) | uint32_t(location), current == value);
+			s_Uniform1i(location, value);
+		}
+
+		static void Count(GLCallKind kind, uint64_t bindingPoint, bool bRedundant)
+		{
+			GLCallCounts& counts = s_Counts[uint32_t(kind)];
+			counts.m_Intercepted++;
+
+			const bool bFirst = s_BindingPoints[uint32_t(kind)].insert(bindingPoint).second;
+
+			if (bRedundant)
+			{
+				if (bFirst)
+				{
+					counts.m_FirstRedundant++;
+				}
+				else
+				{
+					counts.m_Redundant++;
+				}
+			}
+		}
+
+		static void AddCacheCounts(GLCallKind kind, uint64_t requested, uint64_t issued)
+		{
+			s_Counts[uint32_t(kind)].m_Requested += requested;
+			s_Counts[uint32_t(kind)].m_Issued += issued;
+		}
+
+	private:
+		static PFNGLUSEPROGRAMPROC s_UseProgram;
+		static PFNGLBINDVERTEXARRAYPROC s_BindVertexArray;
+		static PFNGLBINDTEXTUREPROC s_BindTexture;
+		static PFNGLBINDBUFFERRANGEPROC s_BindBufferRange;
+		static PFNGLUNIFORM1IPROC s_Uniform1i;
+
+		static GLCallCounts s_Counts[uint32_t(GLCallKind::Count)];
+
+		// Set in the frame so far, per kind
+		static std::set<uint64_t> s_BindingPoints[uint32_t(GLCallKind::Count)];
+
+		static OpenGLStateStatistics s_StatisticsAtInstall;
+	};
+
+	PFNGLUSEPROGRAMPROC GLCallInterceptor::s_UseProgram = nullptr;
+	PFNGLBINDVERTEXARRAYPROC GLCallInterceptor::s_BindVertexArray = nullptr;
+	PFNGLBINDTEXTUREPROC GLCallInterceptor::s_BindTexture = nullptr;
+	PFNGLBINDBUFFERRANGEPROC GLCallInterceptor::s_BindBufferRange = nullptr;
+	PFNGLUNIFORM1IPROC GLCallInterceptor::s_Uniform1i = nullptr;
+
+	GLCallCounts GLCallInterceptor::s_Counts[uint32_t(GLCallKind::Count)];
+	std::set<uint64_t> GLCallInterceptor::s_BindingPoints[uint32_t(GLCallKind::Count)];
+	OpenGLStateStatistics GLCallInterceptor::s_StatisticsAtInstall;
+
+	// Draws a scene of non instanced proxies going round several materials through the OpenGL renderer, with the GL calls the
+	// OpenGLStateCache filters intercepted at the glad function pointers while the frames of the scene are drawn. Logs, per frame, the calls
+	// asked of the cache against the ones reaching OpenGL. Fails if a call reaching OpenGL sets what OpenGL holds already (bar the first on
+	// its binding point in the frame), if the cache's counters don't match the intercepted calls, or if nothing was filtered out.
+	class StateBenchmark : public SceneBenchmark
+	{
+	public:
+		StateBenchmark(const SceneBenchmarkSettings& settings) : SceneBenchmark("state", settings), m_bCounting(false)
+		{
+		}
+
+		virtual bool OnUpdate(float deltaTime) override
+		{
+			if (Renderer::GetAPI() != RendererAPI::API::OpenGL)
+			{
+				KR_WARN("State benchmark: runs with --renderer=opengl only");
+				return true;
+			}
+
+			// Only the frames of the scene, KarmaGui draws in between with GL calls of its own
+			if (m_bCounting)
+			{
+				RenderThread::Enqueue([]()
+					{
+						GLCallInterceptor::Install();
+					});
+			}
+
+			return SceneBenchmark::OnUpdate(deltaTime);
+		}
+
+	protected:
+		virtual void OnBegin() override
+		{
+			m_bCounting = true;
+
+			// The pointers are swapped where the GL calls are made
+			RenderThread::Enqueue([]()
+				{
+					GLCallInterceptor::ResetCounts();
+					GLCallInterceptor::Install();
+				});
+		}
+
+		virtual void OnFrame(uint32_t frame) override
+		{
+			RenderThread::Enqueue([]()
+				{
+					GLCallInterceptor::Uninstall();
+				});
+		}
+
+		virtual bool OnEnd() override
+		{
+			m_bCounting = false;
+
+			RenderThread::WaitForRenderThread();
+
+			const uint64_t numberOfFrames = m_Settings.m_NumberOfFrames;
+
+			KR_INFO("State benchmark: {0} proxies, {1} materials, per frame requested / issued / reaching OpenGL (redundant):", m_Settings.m_NumberOfProxies,
+				m_Settings.m_NumberOfMaterials);
+
+			uint64_t requested = 0;
+			uint64_t intercepted = 0;
+
+			for (uint32_t kind = 0; kind < uint32_t(GLCallKind::Count); kind++)
+			{
+				const GLCallCounts& counts = GLCallInterceptor::GetCounts(GLCallKind(kind));
+				const char* name = s_GLCallKindNames[kind];
+
+				KR_INFO("    {0} {1} / {2} / {3} ({4}, {5} first in the frame)", name, counts.m_Requested / numberOfFrames, counts.m_Issued / numberOfFrames,
+					counts.m_Intercepted / numberOfFrames, counts.m_Redundant / numberOfFrames, counts.m_FirstRedundant / numberOfFrames);
+
+				// Expected to reach OpenGL are the calls changing its state, and nothing else
+				if (counts.m_Redundant > 0)
+				{
+					KR_ERROR("State benchmark: {0} of the {1} GL calls of the {2} set what OpenGL held already", counts.m_Redundant, counts.m_Intercepted, name);
+					SetFailed();
+				}
+
+				if (counts.m_Issued != counts.m_Intercepted)
+				{
+					KR_ERROR("State benchmark: the cache counted {0} GL calls of the {1} issued, against {2} reaching OpenGL", counts.m_Issued, name,
+						counts.m_Intercepted);
+					SetFailed();
+				}
+
+				requested += counts.m_Requested;
+				intercepted += counts.m_Intercepted;
+			}
+
+			if (intercepted >= requested)
+			{
+				KR_ERROR("State benchmark: the cache filtered out none of the {0} GL calls", requested);
+				SetFailed();
+			}
+
+			return true;
+		}
+
+	private:
+		// Between the first frame and the last, the pointers are swapped for each frame of the scene
+		bool m_bCounting;
+	};
+
+	static BenchmarkOption s_StateBenchmarkOption("state-benchmark",
+		"--state-benchmark[=proxies] counts the GL binds reaching OpenGL, exiting non-zero if any is redundant (1000 proxies by default, OpenGL only)",
+		[](const std::string& value) -> Benchmark*
+		{
+			SceneBenchmarkSettings settings;
+			settings.m_NumberOfProxies = uint32_t(CommandLine::ParseNumber(value, 1000));
+			settings.m_NumberOfMaterials = 8;
+			settings.m_NumberOfFrames = 20;
+
+			return new StateBenchmark(settings);
+		});
+}
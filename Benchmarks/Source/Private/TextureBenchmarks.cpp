@@ -0,0 +1,275 @@
+#include "Benchmark.h"
+#include "Platform/Null/NullRendererAPI.h"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <cmath>
+
+namespace Karma
+{
+	// Streams synthetic textures through moving screen sizes and a budget smaller than all of them, checks that the budget holds, and
+	// logs the statistics and timings
+	static void RunTextureStreamBenchmark(uint32_t numberOfTextures)
+	{
+		if (Renderer::GetAPI() != RendererAPI::API::Null)
+		{
+			// The budget is checked against the Null renderer's count of the texture bytes
+			KR_WARN("Texture stream benchmark: runs with --renderer=null only");
+			return;
+		}
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		TextureStreamer streamer;
+		std::vector<TextureStreamHandle> handles;
+		uint64_t fullBytes = 0;
+		uint64_t tailBytes = 0;
+
+		// Square and not, powers of two and not
+		const uint32_t extents[] = { 256, 512, 1024, 2048, 1000, 600 };
+		const uint32_t numberOfExtents = sizeof(extents) / sizeof(extents[0]);
+
+		for (uint32_t counter = 0; counter < numberOfTextures; counter++)
+		{
+			const uint32_t width = extents[counter % numberOfExtents];
+			const uint32_t height = extents[(counter / numberOfExtents + counter) % numberOfExtents];
+
+			handles.push_back(streamer.Register(std::make_shared<SyntheticTextureSource>(width, height, counter)));
+
+			fullBytes += streamer.GetFullBytes(handles.back());
+			tailBytes += streamer.GetTailBytes(handles.back());
+		}
+
+		// A quarter of what the textures take whole
+		streamer.GetSettings().m_BudgetBytes = std::max(fullBytes / 4, tailBytes);
+
+		const uint64_t nullResidentBytes = NullRendererAPI::GetStatistics().m_ResidentTextureBytes;
+		const uint32_t numberOfFrames = 240;
+
+		uint64_t uploadedBytes = 0;
+		uint32_t numberOfUploads = 0;
+		uint32_t numberOfEvictions = 0;
+		uint32_t numberOfPlaceholderBinds = 0;
+		uint32_t numberOfOverBudget = 0;
+		double updateMilliseconds = 0.0;
+		double worstUpdateMilliseconds = 0.0;
+
+		Clock::time_point begin = Clock::now();
+
+		for (uint32_t frame = 0; frame < numberOfFrames; frame++)
+		{
+			// Frames of 120 Hz, for the decodes to keep up as they would
+			std::this_thread::sleep_until(begin + std::chrono::microseconds(8333) * frame);
+
+			Clock::time_point updateBegin = Clock::now();
+			streamer.Update();
+			Clock::time_point updateEnd = Clock::now();
+
+			const double milliseconds = std::chrono::duration<double, std::milli>(updateEnd - updateBegin).count();
+			updateMilliseconds += milliseconds;
+			worstUpdateMilliseconds = std::max(worstUpdateMilliseconds, milliseconds);
+
+			TextureStreamingStatistics statistics = streamer.GetStatistics();
+
+			if (statistics.m_ResidentBytes > streamer.GetSettings().m_BudgetBytes)
+			{
+				numberOfOverBudget++;
+			}
+
+			uploadedBytes += statistics.m_UploadedBytes;
+			numberOfUploads += statistics.m_NumberOfUploads;
+			numberOfEvictions += statistics.m_NumberOfEvictions;
+
+			// Textures wander between filling the screen and a few pixels, and a few drop out of view half way
+			for (uint32_t counter = 0; counter < numberOfTextures; counter++)
+			{
+				if (frame >= numberOfFrames / 2 && counter % 8 == 0)
+				{
+					continue;
+				}
+
+				const float fraction = 0.5f + 0.5f * std::sin(frame * 0.05f + counter * 0.7f);
+
+				streamer.ReportUsage(handles[counter], 0.01f + fraction * fraction);
+				streamer.Bind(handles[counter], 0);
+			}
+
+			numberOfPlaceholderBinds += streamer.GetStatistics().m_NumberOfPlaceholderBinds;
+		}
+
+		Clock::time_point end = Clock::now();
+
+		// Whatever was asked for last, everything decoded and uploaded
+		uint32_t numberOfSettlingFrames = 0;
+
+		while (numberOfSettlingFrames < 1000)
+		{
+			streamer.WaitForDecodes();
+			streamer.Update();
+			numberOfSettlingFrames++;
+
+			TextureStreamingStatistics statistics = streamer.GetStatistics();
+
+			if (statistics.m_NumberOfUploads == 0 && statistics.m_NumberOfPendingDecodes == 0)
+			{
+				break;
+			}
+		}
+
+		TextureStreamingStatistics statistics = streamer.GetStatistics();
+
+		KR_INFO("Texture stream benchmark: {0} textures, {1} MB whole, {2} MB budget, {3} MB resident at most, {4} MB wanted at the end",
+			numberOfTextures, fullBytes >> 20, streamer.GetSettings().m_BudgetBytes >> 20, statistics.m_PeakResidentBytes >> 20,
+			statistics.m_WantedBytes >> 20);
+		KR_INFO("Texture stream benchmark: {0} frames in {1} ms, Update {2} ms on average and {3} ms at worst", numberOfFrames,
+			std::chrono::duration<double, std::milli>(end - begin).count(), updateMilliseconds / numberOfFrames, worstUpdateMilliseconds);
+		KR_INFO("Texture stream benchmark: {0} decodes, {1} uploads ({2} MB), {3} evictions, {4} placeholder binds, settled {5} frames later",
+			statistics.m_NumberOfDecodes, numberOfUploads, uploadedBytes >> 20, numberOfEvictions, numberOfPlaceholderBinds, numberOfSettlingFrames);
+
+		if (numberOfOverBudget)
+		{
+			KR_WARN("Texture stream benchmark: over budget in {0} frames", numberOfOverBudget);
+		}
+
+		streamer.ReleaseResources();
+
+		if (NullRendererAPI::GetStatistics().m_ResidentTextureBytes != nullResidentBytes)
+		{
+			KR_WARN("Texture stream benchmark: {0} bytes of textures left after the release",
+				NullRendererAPI::GetStatistics().m_ResidentTextureBytes - nullResidentBytes);
+		}
+
+		for (TextureStreamHandle handle : handles)
+		{
+			streamer.Unregister(handle);
+		}
+	}
+
+	// Times decoding each image of the directory with its mips made on the CPU (what FileTextureSource does) against cooking it and
+	// against mapping the cooked file, and logs the times with the bytes the mips take on the GPU uncompressed and cooked and the PSNR
+	// of the full size mip
+	static void RunTextureLoadBenchmark(const std::string& directory)
+	{
+		std::vector<std::string> imagePaths;
+		std::error_code errorCode;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, errorCode))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return char(tolower(character)); });
+
+			// The cooked files sit next to the images
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" ||
+				extension == ".bmp"))
+			{
+				imagePaths.push_back(entry.path().string());
+			}
+		}
+
+		if (errorCode || imagePaths.empty())
+		{
+			KR_WARN("Texture load benchmark: no images in {0}", directory);
+			return;
+		}
+
+		std::sort(imagePaths.begin(), imagePaths.end());
+
+		const TextureCompression compression = CookedTexture::GetDefaultCompression();
+
+		uint64_t totalUncompressedBytes = 0;
+		uint64_t totalCookedBytes = 0;
+		double totalDecodeMilliseconds = 0.0;
+		double totalLoadMilliseconds = 0.0;
+
+		for (const std::string& imagePath : imagePaths)
+		{
+			typedef std::chrono::high_resolution_clock Clock;
+
+			// What FileTextureSource does per texture without cooked files
+			Clock::time_point begin = Clock::now();
+			std::vector<TextureMip> mips;
+			bool bDecoded = FileTextureSource(imagePath).Decode(0, mips);
+			Clock::time_point decoded = Clock::now();
+
+			if (!bDecoded)
+			{
+				continue;
+			}
+
+			std::string cookedPath = CookedTexture::GetCookedPath(imagePath);
+			bool bCooked = CookedTexture::Cook(imagePath, cookedPath, compression);
+			Clock::time_point cooked = Clock::now();
+
+			if (!bCooked)
+			{
+				continue;
+			}
+
+			// Mapping alone touches nothing, the validation reads every page as the upload would
+			CookedTexture cookedTexture;
+			bool bValid = cookedTexture.Load(cookedPath, compression, CookedTexture::HashSource(imagePath)) && cookedTexture.Validate();
+			Clock::time_point loaded = Clock::now();
+
+			if (!bValid)
+			{
+				KR_WARN("Texture load benchmark {0}: the cooked file doesn't load back", imagePath);
+				continue;
+			}
+
+			uint64_t uncompressedBytes = 0;
+
+			for (const TextureMip& mip : mips)
+			{
+				uncompressedBytes += mip.m_Pixels.size();
+			}
+
+			TextureMip cookedMip;
+			cookedMip.m_Width = cookedTexture.GetMip(0).m_Width;
+			cookedMip.m_Height = cookedTexture.GetMip(0).m_Height;
+			cookedMip.m_Format = cookedTexture.GetFormat();
+			cookedMip.m_Pixels.assign(cookedTexture.GetMipData(0), cookedTexture.GetMipData(0) + cookedTexture.GetMip(0).m_Size);
+
+			TextureMip decodedMip;
+			TextureCompressor::Decompress(cookedMip, decodedMip);
+
+			double decodeMilliseconds = std::chrono::duration<double, std::milli>(decoded - begin).count();
+			double cookMilliseconds = std::chrono::duration<double, std::milli>(cooked - decoded).count();
+			double loadMilliseconds = std::chrono::duration<double, std::milli>(loaded - cooked).count();
+
+			KR_INFO("Texture load benchmark {0}: {1}x{2} {3}, decode and mips {4} ms, cook {5} ms, cooked load {6} ms ({7}x), "
+				"GPU memory {8} KB uncompressed and {9} KB cooked, PSNR {10} dB", imagePath, cookedTexture.GetWidth(), cookedTexture.GetHeight(),
+				TextureCompressor::GetFormatName(cookedTexture.GetFormat()), decodeMilliseconds, cookMilliseconds, loadMilliseconds,
+				loadMilliseconds > 0.0 ? decodeMilliseconds / loadMilliseconds : 0.0, uncompressedBytes >> 10, cookedTexture.GetDataSize() >> 10,
+				TextureCompressor::ComputePSNR(mips[0], decodedMip));
+
+			totalUncompressedBytes += uncompressedBytes;
+			totalCookedBytes += cookedTexture.GetDataSize();
+			totalDecodeMilliseconds += decodeMilliseconds;
+			totalLoadMilliseconds += loadMilliseconds;
+		}
+
+		KR_INFO("Texture load benchmark ({0}): decode and mips {1} ms against cooked load {2} ms, GPU memory {3} MB against {4} MB",
+			TextureCompressor::GetCompressionName(compression), totalDecodeMilliseconds, totalLoadMilliseconds,
+			double(totalUncompressedBytes) / (1 << 20), double(totalCookedBytes) / (1 << 20));
+	}
+
+	static BenchmarkOption s_TextureStreamBenchmarkOption("texture-stream-benchmark",
+		"--texture-stream-benchmark[=textures] streams synthetic textures headless (with --renderer=null) and logs the statistics (256 textures by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfTextures = uint32_t(CommandLine::ParseNumber(value, 256));
+
+			return new OneShotBenchmark("texture stream", [numberOfTextures]() { RunTextureStreamBenchmark(numberOfTextures); });
+		});
+
+	static BenchmarkOption s_TextureBenchmarkOption("texture-benchmark",
+		"--texture-benchmark[=directory] times the decoding against the cooked load for the images of the directory and logs their GPU memory and PSNR (../Resources/Textures by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const std::string directory = value.empty() ? "../Resources/Textures" : value;
+
+			return new OneShotBenchmark("texture load", [directory]() { RunTextureLoadBenchmark(directory); });
+		});
+}
@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+#include "Karma/Renderer/UniformBufferRing.h"
+
+#include <chrono>
+
+namespace Karma
+{
+	// Writes numberOfDraws blocks of per draw uniforms (a world matrix and a colour), first into a buffer created, mapped and destroyed for
+	// each draw, as the uniforms went before the ring, then bumped into one ring. Logs the time of each, with whichever renderer is picked.
+	static void RunUniformBenchmark(uint32_t numberOfDraws)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+
+		struct DrawUniforms
+		{
+			glm::mat4 m_World;
+			glm::vec4 m_Color;
+		};
+
+		DrawUniforms uniforms;
+		uniforms.m_World = glm::mat4(1.0f);
+		uniforms.m_Color = glm::vec4(1.0f);
+
+		const uint32_t blockSize = uint32_t(sizeof(DrawUniforms));
+
+		// Room in the ring for every draw, with the alignment padding
+		UniformBufferRing* probe = UniformBufferRing::Create(RingBufferType::Uniform, blockSize, 1);
+		const uint32_t alignedSize = (blockSize + probe->GetAlignment() - 1) / probe->GetAlignment() * probe->GetAlignment();
+		delete probe;
+
+		Clock::time_point begin = Clock::now();
+
+		for (uint32_t counter = 0; counter < numberOfDraws; counter++)
+		{
+			UniformBufferRing* buffer = UniformBufferRing::Create(RingBufferType::Uniform, blockSize, 1);
+
+			// Different for each draw, so that no block is shared
+			uniforms.m_World[3][0] = float(counter);
+			buffer->PushData(&uniforms, blockSize);
+
+			delete buffer;
+		}
+
+		const double perDrawMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+		begin = Clock::now();
+
+		UniformBufferRing* ring = UniformBufferRing::Create(RingBufferType::Uniform, alignedSize * numberOfDraws, 1);
+
+		for (uint32_t counter = 0; counter < numberOfDraws; counter++)
+		{
+			uniforms.m_World[3][0] = float(counter);
+			ring->PushData(&uniforms, blockSize);
+		}
+
+		const double ringMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+		const UniformRingStatistics statistics = ring->GetStatistics();
+
+		delete ring;
+
+		KR_INFO("Uniform benchmark: {0} draws, a buffer per draw {1} ms, ring {2} ms ({3} allocations, {4} bytes, {5} failed)", numberOfDraws,
+			perDrawMilliseconds, ringMilliseconds, statistics.m_NumberOfAllocations, statistics.m_UsedBytes, statistics.m_NumberOfFailedAllocations);
+	}
+
+	static BenchmarkOption s_UniformBenchmarkOption("uniform-benchmark",
+		"--uniform-benchmark[=draws] times a uniform buffer per draw against the uniform ring (10000 draws by default)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfDraws = uint32_t(CommandLine::ParseNumber(value, 10000));
+
+			return new OneShotBenchmark("uniform", [numberOfDraws]() { RunUniformBenchmark(numberOfDraws); });
+		});
+}
@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+#include "Platform/Vulkan/VulkanContext.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+
+#include <chrono>
+
+namespace Karma
+{
+	// Uploads numberOfUploads small buffers (a mesh's worth of vertices each) into one device local buffer, first the way they went
+	// before the VulkanUploadManager (a submission and a fence wait per copy), then batched (submitted when the ring runs out of space,
+	// waited for once at the end). Logs the times and the submission and fence wait counts of each.
+	static void RunUploadBenchmark(uint32_t numberOfUploads)
+	{
+		if (Renderer::GetAPI() != RendererAPI::API::Vulkan)
+		{
+			KR_WARN("Upload benchmark: runs with --renderer=vulkan only");
+			return;
+		}
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		const VkDeviceSize uploadSize = 16 * 1024;
+
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+		VulkanUploadManager* uploadManager = context->GetUploadManager();
+		VkDevice device = context->GetLogicalDevice();
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = uploadSize * numberOfUploads;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+		uploadManager->FillSharingMode(bufferInfo);
+
+		VkBuffer buffer;
+		VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer);
+		KR_ASSERT(result == VK_SUCCESS, "Failed to create the upload benchmark buffer");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = context->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		VkDeviceMemory memory;
+		result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+		KR_ASSERT(result == VK_SUCCESS, "Failed to allocate the upload benchmark buffer");
+
+		vkBindBufferMemory(device, buffer, memory, 0);
+
+		std::vector<uint8_t> data(size_t(uploadSize), 0x5a);
+
+		// Whatever the scene queued is out of the way first
+		uploadManager->WaitForUploads();
+
+		for (uint32_t pass = 0; pass < 2; pass++)
+		{
+			const bool bBatched = pass == 1;
+
+			uploadManager->ResetStatistics();
+			Clock::time_point begin = Clock::now();
+
+			for (uint32_t counter = 0; counter < numberOfUploads; counter++)
+			{
+				uploadManager->UploadBuffer(buffer, data.data(), uploadSize, uploadSize * counter);
+
+				if (!bBatched)
+				{
+					uploadManager->WaitForUploads();
+				}
+			}
+
+			uploadManager->WaitForUploads();
+
+			const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+			const UploadStatistics& statistics = uploadManager->GetStatistics();
+
+			KR_INFO("Upload benchmark ({0}): {1} uploads of {2} bytes in {3} ms, {4} submissions, {5} fence waits", bBatched ? "batched" : "wait per upload",
+				statistics.m_NumberOfUploads, uploadSize, milliseconds, statistics.m_NumberOfSubmissions, statistics.m_NumberOfFenceWaits);
+		}
+
+		vkDestroyBuffer(device, buffer, nullptr);
+		vkFreeMemory(device, memory, nullptr);
+	}
+
+	static BenchmarkOption s_UploadBenchmarkOption("upload-benchmark",
+		"--upload-benchmark[=n] times n buffer uploads waited for one by one against batched (1000 by default, Vulkan only)",
+		[](const std::string& value) -> Benchmark*
+		{
+			const uint32_t numberOfUploads = uint32_t(CommandLine::ParseNumber(value, 1000));
+
+			return new OneShotBenchmark("upload", [numberOfUploads]() { RunUploadBenchmark(numberOfUploads); });
+		});
+}
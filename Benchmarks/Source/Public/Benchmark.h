@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Karma.h"
+
+#include <chrono>
+
+namespace Karma
+{
+	// A measurement run by the BenchmarkLayer, one OnUpdate a frame till it is done
+	class Benchmark
+	{
+	public:
+		Benchmark(const std::string& name) : m_Name(name), m_bFailed(false) {}
+		virtual ~Benchmark() {}
+
+		// Returns true once the benchmark is done (and has logged its results)
+		virtual bool OnUpdate(float deltaTime) = 0;
+
+		const std::string& GetName() const { return m_Name; }
+
+		// Set by the benchmarks which check their results when a check fails, the application then exits non-zero
+		void SetFailed() { m_bFailed = true; }
+		bool HasFailed() const { return m_bFailed; }
+
+	private:
+		std::string m_Name;
+		bool m_bFailed;
+	};
+
+	// For the benchmarks which do all of their work at once, without frames being drawn
+	class OneShotBenchmark : public Benchmark
+	{
+	public:
+		OneShotBenchmark(const std::string& name, std::function<void()> run) : Benchmark(name), m_Run(run) {}
+
+		virtual bool OnUpdate(float deltaTime) override
+		{
+			m_Run();
+			return true;
+		}
+
+	private:
+		std::function<void()> m_Run;
+	};
+
+	// Makes the benchmark from the value of its option (--name=value, empty for --name)
+	typedef std::function<Benchmark*(const std::string& value)> BenchmarkFactory;
+
+	// Registers --name as a command line option which queues the benchmark, the benchmarks running in the order of the command line
+	class BenchmarkOption
+	{
+	public:
+		BenchmarkOption(const std::string& name, const std::string& description, BenchmarkFactory factory);
+
+		static std::vector<Benchmark*>& GetQueue();
+	};
+
+	// Runs the queued benchmarks one after the other, and closes the application after the last one, with exit code 1 if any failed
+	class BenchmarkLayer : public Layer
+	{
+	public:
+		BenchmarkLayer();
+		~BenchmarkLayer();
+
+		virtual void OnAttach() override;
+		virtual void OnDetach() override;
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void KarmaGuiRender(float deltaTime) override;
+		virtual void OnEvent(Event& event) override;
+
+	private:
+		size_t m_Current;
+		uint32_t m_NumberOfFailures;
+		std::chrono::high_resolution_clock::time_point m_Begin;
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace Karma
+{
+	// What the SceneBenchmark draws
+	struct SceneBenchmarkSettings
+	{
+		uint32_t m_NumberOfProxies = 10000;
+
+		// Each with a vertex array of its own and the images of the Textures directory taking turns, the proxies going round them
+		uint32_t m_NumberOfMaterials = 1;
+
+		// instanced.vert, which Renderer::Submit collapses into one draw per (material, vertex array) run, instead of shader.vert
+		bool m_bInstanced = false;
+
+		uint32_t m_NumberOfFrames = 100;
+
+		std::string m_ResourceDirectory = "../Resources";
+		std::string m_ModelPath = "Models/BonedCylinder.obj";
+	};
+
+	// Makes a scene of proxies of one model laid out on a grid, all of it in front of the camera, and draws it with Renderer::Submit for the
+	// frames of the settings. The sub class reads the counters of the frames and logs them.
+	class SceneBenchmark : public Benchmark
+	{
+	public:
+		SceneBenchmark(const std::string& name, const SceneBenchmarkSettings& settings);
+
+		virtual bool OnUpdate(float deltaTime) override;
+
+	protected:
+		// After the scene is made and its deltas applied, before the first frame
+		virtual void OnBegin() {}
+
+		// After each frame is drawn (Renderer::EndScene), frame counting from 0
+		virtual void OnFrame(uint32_t frame) {}
+
+		// After the last frame. Returns false to draw the frames again, with the scene made anew for m_Settings (changed by then).
+		virtual bool OnEnd() = 0;
+
+		// Makes the scene (again), with the present settings
+		bool MakeScene();
+
+		SceneBenchmarkSettings m_Settings;
+
+		std::shared_ptr<Scene> m_Scene;
+		std::shared_ptr<PerspectiveCamera> m_Camera;
+
+		// Of the proxies, in the grid's order
+		std::vector<RenderProxyHandle> m_Proxies;
+		std::vector<glm::mat4> m_WorldMatrices;
+
+	private:
+		uint32_t m_Frame;
+		bool m_bMade;
+
+		AssetHandle<Mesh> m_Mesh;
+		AssetHandle<Shader> m_Shader;
+		std::vector<AssetHandle<Texture>> m_Textures;
+		std::vector<AssetHandle<Material>> m_Materials;
+	};
+}
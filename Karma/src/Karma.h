@@ -24,11 +24,26 @@
 #include "Karma/Renderer/RenderCommand.h"
 #include "Karma/Renderer/Buffer.h"
 #include "Karma/Renderer/Mesh.h"
+#include "Karma/Renderer/CookedMesh.h"
+#include "Karma/Renderer/ModelImporter.h"
+#include "Karma/Renderer/MeshOptimizer.h"
+#include "Karma/Renderer/MeshSimplifier.h"
 #include "Karma/Renderer/SkeletalMesh.h"
+#include "Karma/Animation/Animation.h"
+#include "Karma/Animation/RiggedAnimation.h"
+#include "Karma/Animation/Animator.h"
 #include "Karma/Renderer/Material.h"
 #include "Karma/Renderer/Texture.h"
+#include "Karma/Renderer/StreamedTexture.h"
+#include "Karma/Renderer/TextureStreamer.h"
+#include "Karma/Renderer/TextureCompressor.h"
+#include "Karma/Renderer/CookedTexture.h"
+#include "Karma/Renderer/AssetManager.h"
 #include "Karma/Renderer/Scene.h"
+#include "Karma/Renderer/GPUProfiler.h"
+#include "Karma/Renderer/RenderTarget.h"
 #include "Karma/KarmaUtilities.h"
+#include "Karma/CommandLine.h"
 
 #include "Karma/Input.h"
 
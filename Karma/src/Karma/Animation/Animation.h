@@ -1,15 +1,50 @@
+/**
+ * @file Animation.h
+ * @brief This file contains the Animation class, the base of the clips the engine plays.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
 #pragma once
 
 #include "krpch.h"
 
 namespace Karma
 {
+	/**
+	 * @brief A named clip of some duration. Types of Animation 1. Sprites, 2. Rigged (with bones hierarchy and stuff), the latter
+	 * being RiggedAnimation, played by Anuprana.
+	 *
+	 * @since Karma 1.0.0
+	 */
 	class KARMA_API Animation
 	{
-		// Types of Animation 1. Sprites, 2. Rigged (with bones hierarchy and stuff)
+	public:
+		/**
+		 * @brief A constructor
+		 *
+		 * @param name							Name of the clip, as in the model file
+		 * @param duration						Length of the clip in seconds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Animation(const std::string& name, float duration) : m_Name(name), m_Duration(duration)
+		{
+		}
 
-		// Ways to talk to the Renderer and main game loop hookup to actually display animating stuff
+		virtual ~Animation() = default;
 
-	};
+		const std::string& GetName() const { return m_Name; }
+
+		/**
+		 * @brief Length of the clip in seconds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float GetDuration() const { return m_Duration; }
 
-}
\ No newline at end of file
+	protected:
+		std::string m_Name;
+		float m_Duration;
+	};
+}
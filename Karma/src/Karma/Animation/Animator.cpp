@@ -0,0 +1,132 @@
+#include "Animator.h"
+#include "Karma/JobPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Karma
+{
+	// Characters a job of UpdateAll, enough to outweigh handing the job out
+	static const uint32_t s_AnimatorsPerJob = 16;
+
+	Anuprana::Anuprana(std::shared_ptr<Skeleton> skeleton) : m_Skeleton(skeleton), m_BlendSeconds(0.0f), m_BlendElapsed(0.0f)
+	{
+		KR_CORE_ASSERT(m_Skeleton, "Anuprana needs a skeleton");
+
+		m_Pose = m_Skeleton->GetBindPose();
+		m_LayerPose = m_Pose;
+
+		m_ModelMatrices.resize(m_Skeleton->GetNumberOfJoints());
+		m_SkinMatrices.resize(m_Skeleton->GetNumberOfSkinJoints());
+
+		m_Skeleton->ComputeModelMatrices(m_Pose, m_ModelMatrices.data());
+		m_Skeleton->ComputeSkinMatrices(m_ModelMatrices.data(), m_SkinMatrices.data());
+	}
+
+	void Anuprana::Play(std::shared_ptr<RiggedAnimation> animation, float blendSeconds, bool bLooping)
+	{
+		KR_CORE_ASSERT(animation && animation->GetSkeleton() == m_Skeleton, "The clip is of another skeleton");
+
+		AnimationLayer layer;
+		layer.m_Animation = animation;
+		layer.m_bLooping = bLooping;
+
+		if (blendSeconds <= 0.0f || m_Layers.empty())
+		{
+			m_Layers = { layer };
+			m_BlendSeconds = 0.0f;
+
+			return;
+		}
+
+		// From the latest clip, the one faded to if a fade is under way
+		AnimationLayer from = m_Layers.back();
+		from.m_Weight = 1.0f;
+
+		layer.m_Weight = 0.0f;
+
+		m_Layers = { from, layer };
+		m_BlendSeconds = blendSeconds;
+		m_BlendElapsed = 0.0f;
+	}
+
+	void Anuprana::Update(float deltaSeconds)
+	{
+		if (m_BlendSeconds > 0.0f && m_Layers.size() == 2)
+		{
+			m_BlendElapsed += deltaSeconds;
+
+			const float weight = std::min(m_BlendElapsed / m_BlendSeconds, 1.0f);
+
+			m_Layers[0].m_Weight = 1.0f - weight;
+			m_Layers[1].m_Weight = weight;
+
+			if (weight >= 1.0f)
+			{
+				m_Layers.erase(m_Layers.begin());
+				m_BlendSeconds = 0.0f;
+			}
+		}
+
+		// Weighted blend of the layers in one pass: each is blended into the ones before by its share of the weights so far
+		float accumulatedWeight = 0.0f;
+
+		for (AnimationLayer& layer : m_Layers)
+		{
+			layer.m_Time += deltaSeconds * layer.m_Speed;
+
+			if (layer.m_Weight <= 0.0f || !layer.m_Animation)
+			{
+				continue;
+			}
+
+			if (accumulatedWeight == 0.0f)
+			{
+				layer.m_Animation->Sample(layer.m_Time, layer.m_bLooping, m_Pose);
+				accumulatedWeight = layer.m_Weight;
+
+				continue;
+			}
+
+			layer.m_Animation->Sample(layer.m_Time, layer.m_bLooping, m_LayerPose);
+			accumulatedWeight += layer.m_Weight;
+
+			Skeleton::BlendPoses(m_Pose, m_LayerPose, layer.m_Weight / accumulatedWeight, m_Pose);
+		}
+
+		if (accumulatedWeight == 0.0f)
+		{
+			m_Pose = m_Skeleton->GetBindPose();
+		}
+
+		m_Skeleton->ComputeModelMatrices(m_Pose, m_ModelMatrices.data());
+		m_Skeleton->ComputeSkinMatrices(m_ModelMatrices.data(), m_SkinMatrices.data());
+	}
+
+	void Anuprana::UpdateAll(Anuprana* const* animators, uint32_t numberOfAnimators, float deltaSeconds, JobPool* pool)
+	{
+		const uint32_t numberOfJobs = (numberOfAnimators + s_AnimatorsPerJob - 1) / s_AnimatorsPerJob;
+
+		std::function<void(uint32_t)> updateJob = [animators, numberOfAnimators, deltaSeconds](uint32_t job)
+		{
+			const uint32_t end = std::min((job + 1) * s_AnimatorsPerJob, numberOfAnimators);
+
+			for (uint32_t counter = job * s_AnimatorsPerJob; counter < end; counter++)
+			{
+				animators[counter]->Update(deltaSeconds);
+			}
+		};
+
+		if (pool)
+		{
+			pool->ParallelFor(numberOfJobs, updateJob);
+		}
+		else
+		{
+			for (uint32_t job = 0; job < numberOfJobs; job++)
+			{
+				updateJob(job);
+			}
+		}
+	}
+}
@@ -1,13 +1,150 @@
+/**
+ * @file Animator.h
+ * @brief This file contains the Anuprana class, which plays the RiggedAnimation clips of a character and makes its skin matrices.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
 #pragma once
 
 #include "krpch.h"
 
+#include "RiggedAnimation.h"
+
 namespace Karma
 {
-	// Anu-praan-aa - She who breathes (animated) life.
+	class JobPool;
+
+	/**
+	 * @brief A clip being played by an Anuprana, with its own time and weight
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AnimationLayer
+	{
+		std::shared_ptr<RiggedAnimation> m_Animation;
+
+		/**
+		 * @brief Time in the clip, in seconds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Time = 0.0f;
+
+		/**
+		 * @brief Playback rate, 1 for the clip's own
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Speed = 1.0f;
+
+		/**
+		 * @brief Share of the layer in the pose, relative to the other layers' (a walk and a run blended by speed, say)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Weight = 1.0f;
+
+		bool m_bLooping = true;
+	};
+
+	/**
+	 * @brief Anu-praan-aa - She who breathes (animated) life.
+	 *
+	 * Mechanism for updating the animation time and determining the current pose of a character: samples the clips of its layers,
+	 * blends them by weight, and sets the transforms in the bone-joint model (model space matrices, then the skin matrices for the
+	 * vertices, SkeletalMesh::Skin or u_FinalBonesMatrices through Material::SetBoneMatrices).
+	 *
+	 * An Anuprana touches only its own data in Update, so that the characters of a frame are updated side by side (UpdateAll).
+	 *
+	 * @since Karma 1.0.0
+	 */
 	class KARMA_API Anuprana
 	{
-		// Mechanism for updating the animation time and determining the current pose (sequence, series of vertices transforms)
-		// and set the transforms in the bone-joint model.
+	public:
+		/**
+		 * @brief A constructor, the character in the bind pose
+		 *
+		 * @param skeleton						Skeleton of the character, the clips played must be of it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Anuprana(std::shared_ptr<Skeleton> skeleton);
+
+		/**
+		 * @brief Plays the clip from its start, cross fading from what is playing over blendSeconds
+		 *
+		 * @param animation						The clip
+		 * @param blendSeconds					Cross fade time, 0 to cut to the clip
+		 * @param bLooping						Whether the clip wraps around
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Play(std::shared_ptr<RiggedAnimation> animation, float blendSeconds = 0.0f, bool bLooping = true);
+
+		/**
+		 * @brief The layers played, for blends set by hand. Play owns them while it cross fades.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<AnimationLayer>& GetLayers() { return m_Layers; }
+
+		/**
+		 * @brief Moves the layers on by the time and makes the pose, the model space matrices and the skin matrices
+		 *
+		 * @param deltaSeconds					Time since the previous Update
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Update(float deltaSeconds);
+
+		const std::shared_ptr<Skeleton>& GetSkeleton() const { return m_Skeleton; }
+
+		/**
+		 * @brief Local transforms of the joints, of the latest Update
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const AnimationPose& GetPose() const { return m_Pose; }
+
+		/**
+		 * @brief Model space matrices of the joints, of the latest Update
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<glm::mat4>& GetModelMatrices() const { return m_ModelMatrices; }
+
+		/**
+		 * @brief Skin matrices by palette index (BoneInfo::m_Id), of the latest Update
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<glm::mat4>& GetSkinMatrices() const { return m_SkinMatrices; }
+
+		/**
+		 * @brief Updates the characters, in batches on the pool's workers and the calling thread
+		 *
+		 * @param animators						The characters, each once
+		 * @param numberOfAnimators				Number of them
+		 * @param deltaSeconds					Time since the previous Update
+		 * @param pool							Pool to run the batches on, nullptr for the calling thread alone
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void UpdateAll(Anuprana* const* animators, uint32_t numberOfAnimators, float deltaSeconds, JobPool* pool);
+
+	private:
+		std::shared_ptr<Skeleton> m_Skeleton;
+		std::vector<AnimationLayer> m_Layers;
+
+		// The cross fade of Play, from the first layer to the second
+		float m_BlendSeconds;
+		float m_BlendElapsed;
+
+		AnimationPose m_Pose;
+		AnimationPose m_LayerPose;
+
+		std::vector<glm::mat4> m_ModelMatrices;
+		std::vector<glm::mat4> m_SkinMatrices;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,638 @@
+#include "RiggedAnimation.h"
+#include "Karma/Renderer/SkeletalMesh.h"
+#include "Karma/CommandLine.h"
+
+#include <assimp/scene.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define KR_ANIMATION_SSE 1
+#endif
+
+namespace Karma
+{
+	AnimationCompressionSettings RiggedAnimation::s_DefaultCompression;
+
+	// The constant tracks are kept once either way
+	static CommandLineOption s_AnimationCompressionOption("animation-compression", "--animation-compression=off keeps the animated tracks of the clips in floats rather than quantized",
+		[](const std::string& value) { RiggedAnimation::GetDefaultCompression().m_bQuantize = value != "off"; });
+
+	namespace
+	{
+		glm::mat4 ToMatrix(const aiMatrix4x4& matrix)
+		{
+			// Assimp's matrices are row major
+			glm::mat4 result;
+
+			for (uint32_t row = 0; row < 4; row++)
+			{
+				for (uint32_t column = 0; column < 4; column++)
+				{
+					result[column][row] = matrix[row][column];
+				}
+			}
+
+			return result;
+		}
+
+		/**
+		 * @brief The matrix of the joint's translation, rotation and scale (applied in the reverse order)
+		 */
+		void ComposeMatrix(const glm::vec4* transform, glm::mat4& result)
+		{
+			const glm::vec4& translation = transform[0];
+			const glm::vec4& rotation = transform[1];
+			const glm::vec4& scale = transform[2];
+
+			const float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+			const float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+			const float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+
+			result[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * scale.x;
+			result[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * scale.y;
+			result[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * scale.z;
+			result[3] = glm::vec4(translation.x, translation.y, translation.z, 1.0f);
+		}
+
+		/**
+		 * @brief result = left * right. result may be either of them.
+		 */
+		void MultiplyMatrices(const glm::mat4& left, const glm::mat4& right, glm::mat4& result)
+		{
+#if defined(KR_ANIMATION_SSE)
+			const float* leftData = &left[0][0];
+			const float* rightData = &right[0][0];
+			float* resultData = &result[0][0];
+
+			const __m128 column0 = _mm_loadu_ps(leftData);
+			const __m128 column1 = _mm_loadu_ps(leftData + 4);
+			const __m128 column2 = _mm_loadu_ps(leftData + 8);
+			const __m128 column3 = _mm_loadu_ps(leftData + 12);
+
+			// A column of right is read before the same column of result is written
+			for (uint32_t column = 0; column < 4; column++)
+			{
+				const float* rightColumn = rightData + column * 4;
+
+				__m128 product = _mm_mul_ps(column0, _mm_set1_ps(rightColumn[0]));
+				product = _mm_add_ps(product, _mm_mul_ps(column1, _mm_set1_ps(rightColumn[1])));
+				product = _mm_add_ps(product, _mm_mul_ps(column2, _mm_set1_ps(rightColumn[2])));
+				product = _mm_add_ps(product, _mm_mul_ps(column3, _mm_set1_ps(rightColumn[3])));
+
+				_mm_storeu_ps(resultData + column * 4, product);
+			}
+#else
+			result = left * right;
+#endif
+		}
+
+#if defined(KR_ANIMATION_SSE)
+		// The dot product in every lane
+		inline __m128 Dot4(__m128 left, __m128 right)
+		{
+			__m128 product = _mm_mul_ps(left, right);
+			product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			return _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 0, 3, 2)));
+		}
+
+		inline __m128 Normalize4(__m128 value)
+		{
+			return _mm_div_ps(value, _mm_sqrt_ps(Dot4(value, value)));
+		}
+
+		inline __m128 Lerp4(__m128 from, __m128 to, __m128 weight)
+		{
+			return _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), weight));
+		}
+
+		// The four 16 bit components at source, as floats
+		inline __m128 LoadQuantized(const uint16_t* source)
+		{
+			const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+
+			return _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+		}
+#endif
+
+		glm::vec4 NormalizeQuaternion(const glm::vec4& quaternion)
+		{
+			const float length = glm::length(quaternion);
+
+			return length > 0.0f ? quaternion / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+
+		/**
+		 * @brief Index of the key at or before the tick, from the cursor on. The ticks asked for only grow, so the cursor only moves on.
+		 */
+		template<typename KeyType>
+		uint32_t FindKey(const KeyType* keys, uint32_t numberOfKeys, double tick, uint32_t& cursor)
+		{
+			while (cursor + 1 < numberOfKeys && keys[cursor + 1].mTime <= tick)
+			{
+				cursor++;
+			}
+
+			return cursor;
+		}
+
+		template<typename KeyType>
+		float GetKeyFactor(const KeyType* keys, uint32_t numberOfKeys, uint32_t key, double tick)
+		{
+			if (key + 1 >= numberOfKeys)
+			{
+				return 0.0f;
+			}
+
+			const double span = keys[key + 1].mTime - keys[key].mTime;
+
+			return span > 0.0 ? float(std::clamp((tick - keys[key].mTime) / span, 0.0, 1.0)) : 0.0f;
+		}
+
+		glm::vec4 InterpolateVectorKeys(const aiVectorKey* keys, uint32_t numberOfKeys, double tick, uint32_t& cursor)
+		{
+			const uint32_t key = FindKey(keys, numberOfKeys, tick, cursor);
+			const float factor = GetKeyFactor(keys, numberOfKeys, key, tick);
+
+			aiVector3D value = keys[key].mValue;
+
+			if (factor > 0.0f)
+			{
+				value = value + (keys[key + 1].mValue - value) * factor;
+			}
+
+			return glm::vec4(value.x, value.y, value.z, 0.0f);
+		}
+
+		glm::vec4 InterpolateQuaternionKeys(const aiQuatKey* keys, uint32_t numberOfKeys, double tick, uint32_t& cursor)
+		{
+			const uint32_t key = FindKey(keys, numberOfKeys, tick, cursor);
+			const float factor = GetKeyFactor(keys, numberOfKeys, key, tick);
+
+			aiQuaternion value = keys[key].mValue;
+
+			if (factor > 0.0f)
+			{
+				aiQuaternion::Interpolate(value, keys[key].mValue, keys[key + 1].mValue, factor);
+			}
+
+			return NormalizeQuaternion(glm::vec4(value.x, value.y, value.z, value.w));
+		}
+	}
+
+	Skeleton::Skeleton() : m_GlobalInverseTransform(1.0f)
+	{
+	}
+
+	std::shared_ptr<Skeleton> Skeleton::FromScene(const aiScene* scene, const std::unordered_map<std::string, BoneInfo>& bones)
+	{
+		std::shared_ptr<Skeleton> skeleton = std::make_shared<Skeleton>();
+
+		if (!scene || !scene->mRootNode)
+		{
+			return skeleton;
+		}
+
+		// Depth first, so that the parents come first
+		std::vector<std::pair<const aiNode*, int32_t>> nodes = { { scene->mRootNode, -1 } };
+
+		while (!nodes.empty())
+		{
+			const aiNode* node = nodes.back().first;
+			const int32_t parent = nodes.back().second;
+			nodes.pop_back();
+
+			aiVector3D scale;
+			aiQuaternion rotation;
+			aiVector3D translation;
+			node->mTransformation.Decompose(scale, rotation, translation);
+
+			const uint32_t joint = skeleton->AddJoint(node->mName.C_Str(), parent, glm::vec3(translation.x, translation.y, translation.z),
+				glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w), glm::vec3(scale.x, scale.y, scale.z));
+
+			for (uint32_t counter = node->mNumChildren; counter > 0; counter--)
+			{
+				nodes.push_back({ node->mChildren[counter - 1], int32_t(joint) });
+			}
+		}
+
+		for (const std::pair<const std::string, BoneInfo>& bone : bones)
+		{
+			const int32_t joint = skeleton->FindJoint(bone.first);
+
+			if (joint < 0)
+			{
+				KR_CORE_WARN("Skeleton: no node for the bone {0}, its vertices stay in the bind pose", bone.first);
+				continue;
+			}
+
+			skeleton->SetSkinJoint(uint32_t(bone.second.m_Id), uint32_t(joint), bone.second.m_ModelToBoneTransform);
+		}
+
+		skeleton->SetGlobalInverseTransform(glm::inverse(ToMatrix(scene->mRootNode->mTransformation)));
+
+		return skeleton;
+	}
+
+	uint32_t Skeleton::AddJoint(const std::string& name, int32_t parent, const glm::vec3& translation, const glm::vec4& rotation, const glm::vec3& scale)
+	{
+		const uint32_t joint = GetNumberOfJoints();
+
+		KR_CORE_ASSERT(parent < int32_t(joint), "Joints come after their parents");
+
+		m_JointNames.push_back(name);
+		m_Parents.push_back(parent);
+
+		// The first of the name is the one found, node names needn't be unique
+		m_JointIndices.emplace(name, joint);
+
+		m_BindPose.Resize(joint + 1);
+		m_BindPose.GetTranslation(joint) = glm::vec4(translation, 0.0f);
+		m_BindPose.GetRotation(joint) = NormalizeQuaternion(rotation);
+		m_BindPose.GetScale(joint) = glm::vec4(scale, 0.0f);
+
+		return joint;
+	}
+
+	void Skeleton::SetSkinJoint(uint32_t paletteIndex, uint32_t joint, const glm::mat4& inverseBindMatrix)
+	{
+		if (paletteIndex >= m_SkinJoints.size())
+		{
+			m_SkinJoints.resize(paletteIndex + 1, 0);
+			m_InverseBindMatrices.resize(paletteIndex + 1, glm::mat4(1.0f));
+		}
+
+		m_SkinJoints[paletteIndex] = joint;
+		m_InverseBindMatrices[paletteIndex] = inverseBindMatrix;
+	}
+
+	int32_t Skeleton::FindJoint(const std::string& name) const
+	{
+		std::unordered_map<std::string, uint32_t>::const_iterator joint = m_JointIndices.find(name);
+
+		return joint != m_JointIndices.end() ? int32_t(joint->second) : -1;
+	}
+
+	void Skeleton::ComputeModelMatrices(const AnimationPose& pose, glm::mat4* modelMatrices) const
+	{
+		KR_CORE_ASSERT(pose.GetNumberOfJoints() == GetNumberOfJoints(), "The pose is of another skeleton");
+
+		const glm::vec4* transforms = pose.m_Transforms.data();
+		const uint32_t numberOfJoints = GetNumberOfJoints();
+
+		glm::mat4 localMatrix;
+
+		for (uint32_t joint = 0; joint < numberOfJoints; joint++)
+		{
+			const int32_t parent = m_Parents[joint];
+
+			if (parent < 0)
+			{
+				ComposeMatrix(transforms + joint * 3, modelMatrices[joint]);
+				continue;
+			}
+
+			// The parent's is done already
+			ComposeMatrix(transforms + joint * 3, localMatrix);
+			MultiplyMatrices(modelMatrices[parent], localMatrix, modelMatrices[joint]);
+		}
+	}
+
+	void Skeleton::ComputeSkinMatrices(const glm::mat4* modelMatrices, glm::mat4* skinMatrices) const
+	{
+		for (uint32_t paletteIndex = 0; paletteIndex < GetNumberOfSkinJoints(); paletteIndex++)
+		{
+			MultiplyMatrices(modelMatrices[m_SkinJoints[paletteIndex]], m_InverseBindMatrices[paletteIndex], skinMatrices[paletteIndex]);
+			MultiplyMatrices(m_GlobalInverseTransform, skinMatrices[paletteIndex], skinMatrices[paletteIndex]);
+		}
+	}
+
+	void Skeleton::BlendPoses(const AnimationPose& from, const AnimationPose& to, float weight, AnimationPose& result)
+	{
+		KR_CORE_ASSERT(from.m_Transforms.size() == to.m_Transforms.size(), "The poses are of different skeletons");
+
+		const uint32_t numberOfJoints = from.GetNumberOfJoints();
+		result.Resize(numberOfJoints);
+
+		const float* fromData = &from.m_Transforms[0].x;
+		const float* toData = &to.m_Transforms[0].x;
+		float* resultData = &result.m_Transforms[0].x;
+
+#if defined(KR_ANIMATION_SSE)
+		const __m128 weights = _mm_set1_ps(weight);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (uint32_t joint = 0; joint < numberOfJoints; joint++)
+		{
+			const uint32_t offset = joint * 12;
+
+			_mm_storeu_ps(resultData + offset, Lerp4(_mm_loadu_ps(fromData + offset), _mm_loadu_ps(toData + offset), weights));
+			_mm_storeu_ps(resultData + offset + 8, Lerp4(_mm_loadu_ps(fromData + offset + 8), _mm_loadu_ps(toData + offset + 8), weights));
+
+			// The shorter arc, negating the target rotation when the two are more than half a turn apart
+			const __m128 fromRotation = _mm_loadu_ps(fromData + offset + 4);
+			__m128 toRotation = _mm_loadu_ps(toData + offset + 4);
+			toRotation = _mm_xor_ps(toRotation, _mm_and_ps(signMask, _mm_cmplt_ps(Dot4(fromRotation, toRotation), _mm_setzero_ps())));
+
+			_mm_storeu_ps(resultData + offset + 4, Normalize4(Lerp4(fromRotation, toRotation, weights)));
+		}
+#else
+		for (uint32_t joint = 0; joint < numberOfJoints; joint++)
+		{
+			const uint32_t index = joint * 3;
+
+			result.m_Transforms[index] = glm::mix(from.m_Transforms[index], to.m_Transforms[index], weight);
+			result.m_Transforms[index + 2] = glm::mix(from.m_Transforms[index + 2], to.m_Transforms[index + 2], weight);
+
+			const glm::vec4 fromRotation = from.m_Transforms[index + 1];
+			glm::vec4 toRotation = to.m_Transforms[index + 1];
+
+			if (glm::dot(fromRotation, toRotation) < 0.0f)
+			{
+				toRotation = -toRotation;
+			}
+
+			result.m_Transforms[index + 1] = NormalizeQuaternion(glm::mix(fromRotation, toRotation, weight));
+		}
+
+		(void)fromData;
+		(void)toData;
+		(void)resultData;
+#endif
+	}
+
+	RiggedAnimation::RiggedAnimation(const std::string& name, std::shared_ptr<Skeleton> skeleton, const std::vector<AnimationPose>& frames, float sampleRate,
+		const AnimationCompressionSettings& settings) : Animation(name, 0.0f), m_Skeleton(skeleton), m_SampleRate(sampleRate),
+		m_NumberOfFrames(uint32_t(frames.size())), m_bQuantized(settings.m_bQuantize), m_CompressionError(0.0f)
+	{
+		KR_CORE_ASSERT(m_Skeleton && !frames.empty() && sampleRate > 0.0f, "A clip needs a skeleton, frames and a sample rate");
+
+		m_Duration = float(m_NumberOfFrames - 1) / m_SampleRate;
+		m_BasePose = m_Skeleton->GetBindPose();
+
+		const uint32_t numberOfTransforms = uint32_t(m_BasePose.m_Transforms.size());
+
+		// A track's values, the rotations kept on the same side of the sphere frame to frame for the frames to be lerped
+		std::vector<glm::vec4> values(m_NumberOfFrames);
+
+		std::vector<glm::vec4> minimums;
+		std::vector<glm::vec4> maximums;
+
+		for (uint32_t transform = 0; transform < numberOfTransforms; transform++)
+		{
+			const uint32_t channel = transform % 3;
+			const float tolerance = channel == 0 ? settings.m_TranslationTolerance : channel == 1 ? settings.m_RotationTolerance : settings.m_ScaleTolerance;
+
+			glm::vec4 minimum(std::numeric_limits<float>::max());
+			glm::vec4 maximum(-std::numeric_limits<float>::max());
+
+			for (uint32_t frame = 0; frame < m_NumberOfFrames; frame++)
+			{
+				KR_CORE_ASSERT(frames[frame].m_Transforms.size() == numberOfTransforms, "The frames are poses of the skeleton");
+
+				glm::vec4 value = frames[frame].m_Transforms[transform];
+
+				if (channel == 1 && frame > 0 && glm::dot(value, values[frame - 1]) < 0.0f)
+				{
+					value = -value;
+				}
+
+				values[frame] = value;
+				minimum = glm::min(minimum, value);
+				maximum = glm::max(maximum, value);
+			}
+
+			const glm::vec4 extent = maximum - minimum;
+
+			if (std::max(std::max(extent.x, extent.y), std::max(extent.z, extent.w)) <= tolerance)
+			{
+				// Kept once, the first frame's value
+				m_BasePose.m_Transforms[transform] = channel == 1 ? NormalizeQuaternion(values[0]) : values[0];
+
+				const glm::vec4 error = glm::max(maximum - values[0], values[0] - minimum);
+				m_CompressionError = std::max(m_CompressionError, std::max(std::max(error.x, error.y), std::max(error.z, error.w)));
+				continue;
+			}
+
+			if (channel == 1)
+			{
+				m_RotationTracks.push_back(uint32_t(m_TrackTargets.size()));
+			}
+
+			m_TrackTargets.push_back(transform);
+			minimums.push_back(minimum);
+			maximums.push_back(maximum);
+
+			// Gathered track by track, laid out frame by frame below
+			m_Frames.insert(m_Frames.end(), values.begin(), values.end());
+		}
+
+		const uint32_t numberOfTracks = GetNumberOfAnimatedTracks();
+
+		std::vector<glm::vec4> trackMajorFrames;
+		trackMajorFrames.swap(m_Frames);
+
+		if (!m_bQuantized)
+		{
+			m_Frames.resize(size_t(m_NumberOfFrames) * numberOfTracks);
+
+			for (uint32_t track = 0; track < numberOfTracks; track++)
+			{
+				for (uint32_t frame = 0; frame < m_NumberOfFrames; frame++)
+				{
+					m_Frames[size_t(frame) * numberOfTracks + track] = trackMajorFrames[size_t(track) * m_NumberOfFrames + frame];
+				}
+			}
+
+			return;
+		}
+
+		m_QuantizedFrames.resize(size_t(m_NumberOfFrames) * numberOfTracks * 4);
+		m_TrackMinimums = minimums;
+		m_TrackSteps.resize(numberOfTracks);
+
+		for (uint32_t track = 0; track < numberOfTracks; track++)
+		{
+			const glm::vec4 step = (maximums[track] - minimums[track]) / 65535.0f;
+			m_TrackSteps[track] = step;
+
+			for (uint32_t frame = 0; frame < m_NumberOfFrames; frame++)
+			{
+				const glm::vec4& value = trackMajorFrames[size_t(track) * m_NumberOfFrames + frame];
+				uint16_t* quantized = &m_QuantizedFrames[(size_t(frame) * numberOfTracks + track) * 4];
+
+				for (uint32_t component = 0; component < 4; component++)
+				{
+					quantized[component] = step[component] > 0.0f ?
+						uint16_t(std::clamp(std::lround((value[component] - minimums[track][component]) / step[component]), 0l, 65535l)) : 0;
+
+					const float restored = minimums[track][component] + float(quantized[component]) * step[component];
+					m_CompressionError = std::max(m_CompressionError, std::abs(restored - value[component]));
+				}
+			}
+		}
+	}
+
+	std::shared_ptr<RiggedAnimation> RiggedAnimation::FromAssimp(const aiAnimation* animation, std::shared_ptr<Skeleton> skeleton,
+		const AnimationCompressionSettings& settings)
+	{
+		const double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+		const double duration = animation->mDuration / ticksPerSecond;
+		const uint32_t numberOfFrames = uint32_t(std::ceil(duration * settings.m_SampleRate)) + 1;
+
+		std::vector<AnimationPose> frames(numberOfFrames, skeleton->GetBindPose());
+		uint32_t numberOfSkippedChannels = 0;
+
+		for (uint32_t channelIndex = 0; channelIndex < animation->mNumChannels; channelIndex++)
+		{
+			const aiNodeAnim* channel = animation->mChannels[channelIndex];
+			const int32_t joint = skeleton->FindJoint(channel->mNodeName.C_Str());
+
+			if (joint < 0)
+			{
+				numberOfSkippedChannels++;
+				continue;
+			}
+
+			uint32_t positionCursor = 0;
+			uint32_t rotationCursor = 0;
+			uint32_t scalingCursor = 0;
+
+			for (uint32_t frame = 0; frame < numberOfFrames; frame++)
+			{
+				const double tick = std::min(double(frame) / settings.m_SampleRate, duration) * ticksPerSecond;
+				AnimationPose& pose = frames[frame];
+
+				if (channel->mNumPositionKeys)
+				{
+					pose.GetTranslation(joint) = InterpolateVectorKeys(channel->mPositionKeys, channel->mNumPositionKeys, tick, positionCursor);
+				}
+
+				if (channel->mNumRotationKeys)
+				{
+					pose.GetRotation(joint) = InterpolateQuaternionKeys(channel->mRotationKeys, channel->mNumRotationKeys, tick, rotationCursor);
+				}
+
+				if (channel->mNumScalingKeys)
+				{
+					pose.GetScale(joint) = InterpolateVectorKeys(channel->mScalingKeys, channel->mNumScalingKeys, tick, scalingCursor);
+				}
+			}
+		}
+
+		if (numberOfSkippedChannels)
+		{
+			KR_CORE_WARN("RiggedAnimation {0}: {1} channels of nodes not in the skeleton left out", animation->mName.C_Str(), numberOfSkippedChannels);
+		}
+
+		return std::make_shared<RiggedAnimation>(animation->mName.length ? animation->mName.C_Str() : "Animation", skeleton, frames,
+			settings.m_SampleRate, settings);
+	}
+
+	void RiggedAnimation::Sample(float time, bool bLooping, AnimationPose& pose) const
+	{
+		// Same size, so a copy without allocation
+		pose.m_Transforms = m_BasePose.m_Transforms;
+
+		const uint32_t numberOfTracks = GetNumberOfAnimatedTracks();
+
+		if (numberOfTracks == 0)
+		{
+			return;
+		}
+
+		if (bLooping && m_Duration > 0.0f)
+		{
+			time = std::fmod(time, m_Duration);
+			time = time < 0.0f ? time + m_Duration : time;
+		}
+
+		const float position = std::clamp(time, 0.0f, m_Duration) * m_SampleRate;
+		const uint32_t firstFrame = std::min(uint32_t(position), m_NumberOfFrames - 1);
+		const uint32_t secondFrame = std::min(firstFrame + 1, m_NumberOfFrames - 1);
+		const float weight = position - float(firstFrame);
+
+		float* poseData = &pose.m_Transforms[0].x;
+		const uint32_t* targets = m_TrackTargets.data();
+
+#if defined(KR_ANIMATION_SSE)
+		const __m128 weights = _mm_set1_ps(weight);
+
+		if (m_bQuantized)
+		{
+			const uint16_t* firstValues = &m_QuantizedFrames[size_t(firstFrame) * numberOfTracks * 4];
+			const uint16_t* secondValues = &m_QuantizedFrames[size_t(secondFrame) * numberOfTracks * 4];
+			const float* minimums = &m_TrackMinimums[0].x;
+			const float* steps = &m_TrackSteps[0].x;
+
+			for (uint32_t track = 0; track < numberOfTracks; track++)
+			{
+				// Interpolated in the quantized steps, then restored once
+				const __m128 steps4 = Lerp4(LoadQuantized(firstValues + track * 4), LoadQuantized(secondValues + track * 4), weights);
+				const __m128 value = _mm_add_ps(_mm_loadu_ps(minimums + track * 4), _mm_mul_ps(steps4, _mm_loadu_ps(steps + track * 4)));
+
+				_mm_storeu_ps(poseData + targets[track] * 4, value);
+			}
+		}
+		else
+		{
+			const float* firstValues = &m_Frames[size_t(firstFrame) * numberOfTracks].x;
+			const float* secondValues = &m_Frames[size_t(secondFrame) * numberOfTracks].x;
+
+			for (uint32_t track = 0; track < numberOfTracks; track++)
+			{
+				_mm_storeu_ps(poseData + targets[track] * 4, Lerp4(_mm_loadu_ps(firstValues + track * 4), _mm_loadu_ps(secondValues + track * 4), weights));
+			}
+		}
+
+		for (uint32_t track : m_RotationTracks)
+		{
+			float* rotation = poseData + targets[track] * 4;
+			_mm_storeu_ps(rotation, Normalize4(_mm_loadu_ps(rotation)));
+		}
+#else
+		for (uint32_t track = 0; track < numberOfTracks; track++)
+		{
+			glm::vec4 first;
+			glm::vec4 second;
+
+			if (m_bQuantized)
+			{
+				const uint16_t* firstValues = &m_QuantizedFrames[(size_t(firstFrame) * numberOfTracks + track) * 4];
+				const uint16_t* secondValues = &m_QuantizedFrames[(size_t(secondFrame) * numberOfTracks + track) * 4];
+
+				first = m_TrackMinimums[track] + glm::vec4(firstValues[0], firstValues[1], firstValues[2], firstValues[3]) * m_TrackSteps[track];
+				second = m_TrackMinimums[track] + glm::vec4(secondValues[0], secondValues[1], secondValues[2], secondValues[3]) * m_TrackSteps[track];
+			}
+			else
+			{
+				first = m_Frames[size_t(firstFrame) * numberOfTracks + track];
+				second = m_Frames[size_t(secondFrame) * numberOfTracks + track];
+			}
+
+			pose.m_Transforms[targets[track]] = glm::mix(first, second, weight);
+		}
+
+		for (uint32_t track : m_RotationTracks)
+		{
+			pose.m_Transforms[targets[track]] = NormalizeQuaternion(pose.m_Transforms[targets[track]]);
+		}
+
+		(void)poseData;
+#endif
+	}
+
+	uint64_t RiggedAnimation::GetMemorySize() const
+	{
+		return m_Frames.size() * sizeof(glm::vec4) + m_QuantizedFrames.size() * sizeof(uint16_t) + m_BasePose.m_Transforms.size() * sizeof(glm::vec4) +
+			(m_TrackMinimums.size() + m_TrackSteps.size()) * sizeof(glm::vec4) + (m_TrackTargets.size() + m_RotationTracks.size()) * sizeof(uint32_t);
+	}
+
+	uint64_t RiggedAnimation::GetUncompressedSize() const
+	{
+		return uint64_t(m_NumberOfFrames) * m_BasePose.m_Transforms.size() * sizeof(glm::vec4);
+	}
+}
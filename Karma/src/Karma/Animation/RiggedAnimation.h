@@ -1,11 +1,312 @@
+/**
+ * @file RiggedAnimation.h
+ * @brief This file contains the Skeleton (the joint hierarchy of a SkeletalMesh), the AnimationPose and the RiggedAnimation, a clip of
+ * joint transforms kept compact for sampling many characters a frame.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
 #pragma once
 
 #include "krpch.h"
 
+#include "Animation.h"
+#include "glm/glm.hpp"
+
+struct aiScene;
+struct aiAnimation;
+
 namespace Karma
 {
-	// Here we focus on bone based animation
-	// We need relevant data structure supporting
-	// 1. Hierarchy 2. Relative transforms 3. Identification Scheme 4. Children capacity
-	// Tie up with model
-}
\ No newline at end of file
+	struct BoneInfo;
+
+	/**
+	 * @brief Local (relative to the parent joint) transforms of the joints of a Skeleton, three vec4 a joint: the translation (w unused),
+	 * the rotation quaternion as (x, y, z, w) and the scale (w unused). Each is one SIMD register, so that sampling and blending go a
+	 * register at a time.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AnimationPose
+	{
+		std::vector<glm::vec4> m_Transforms;
+
+		void Resize(uint32_t numberOfJoints) { m_Transforms.resize(size_t(numberOfJoints) * 3); }
+		uint32_t GetNumberOfJoints() const { return uint32_t(m_Transforms.size() / 3); }
+
+		glm::vec4& GetTranslation(uint32_t joint) { return m_Transforms[size_t(joint) * 3]; }
+		glm::vec4& GetRotation(uint32_t joint) { return m_Transforms[size_t(joint) * 3 + 1]; }
+		glm::vec4& GetScale(uint32_t joint) { return m_Transforms[size_t(joint) * 3 + 2]; }
+	};
+
+	/**
+	 * @brief The joint hierarchy of a rigged model: names, parents, the bind pose and, for the joints which are bones (skin the
+	 * vertices), their inverse bind matrices in the order of the skin palette (BoneInfo::m_Id).
+	 *
+	 * Joints come after their parents, so that the model space transforms are made in one pass from the first joint to the last
+	 * (ComputeModelMatrices).
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API Skeleton
+	{
+	public:
+		Skeleton();
+
+		/**
+		 * @brief Makes the skeleton of the node hierarchy of the scene, every node a joint (the nodes between the bones carry
+		 * transforms too). The nodes named in bones are the skin joints.
+		 *
+		 * @param scene							Imported scene
+		 * @param bones							Bones of the skinned mesh by name (SkeletalMesh::GetBoneInfoMap)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::shared_ptr<Skeleton> FromScene(const aiScene* scene, const std::unordered_map<std::string, BoneInfo>& bones);
+
+		/**
+		 * @brief Appends a joint
+		 *
+		 * @param name							Name, unique in the skeleton
+		 * @param parent						Index of the parent joint, added before, or -1 for a root
+		 * @param translation					Bind pose translation, relative to the parent
+		 * @param rotation						Bind pose rotation quaternion (x, y, z, w)
+		 * @param scale							Bind pose scale
+		 *
+		 * @return Index of the joint
+		 * @since Karma 1.0.0
+		 */
+		uint32_t AddJoint(const std::string& name, int32_t parent, const glm::vec3& translation, const glm::vec4& rotation, const glm::vec3& scale);
+
+		/**
+		 * @brief Makes the joint the skin joint (bone) paletteIndex, which the vertices weighted to paletteIndex follow
+		 *
+		 * @param paletteIndex					Index in the skin matrices (u_FinalBonesMatrices)
+		 * @param joint							Index of the joint
+		 * @param inverseBindMatrix				From model space to the space of the joint in the bind pose (aiBone::mOffsetMatrix)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetSkinJoint(uint32_t paletteIndex, uint32_t joint, const glm::mat4& inverseBindMatrix);
+
+		/**
+		 * @brief Index of the joint of the name, -1 if there is none
+		 *
+		 * @since Karma 1.0.0
+		 */
+		int32_t FindJoint(const std::string& name) const;
+
+		uint32_t GetNumberOfJoints() const { return uint32_t(m_Parents.size()); }
+		uint32_t GetNumberOfSkinJoints() const { return uint32_t(m_SkinJoints.size()); }
+
+		const std::string& GetJointName(uint32_t joint) const { return m_JointNames[joint]; }
+		int32_t GetParent(uint32_t joint) const { return m_Parents[joint]; }
+
+		const AnimationPose& GetBindPose() const { return m_BindPose; }
+
+		/**
+		 * @brief Applied last to the skin matrices, the inverse of the root node's transform, so that the skinned vertices stay in
+		 * the space of the mesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetGlobalInverseTransform(const glm::mat4& transform) { m_GlobalInverseTransform = transform; }
+
+		/**
+		 * @brief Model space transforms of the joints, a parent's before its children in one linear pass
+		 *
+		 * @param pose							Local transforms of the joints
+		 * @param modelMatrices					GetNumberOfJoints matrices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ComputeModelMatrices(const AnimationPose& pose, glm::mat4* modelMatrices) const;
+
+		/**
+		 * @brief The skin matrices (u_FinalBonesMatrices), taking the vertices from the bind pose to the posed one
+		 *
+		 * @param modelMatrices					From ComputeModelMatrices
+		 * @param skinMatrices					GetNumberOfSkinJoints matrices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ComputeSkinMatrices(const glm::mat4* modelMatrices, glm::mat4* skinMatrices) const;
+
+		/**
+		 * @brief Interpolates the poses, the rotations along the shorter arc (normalized lerp)
+		 *
+		 * @param from							Pose at weight 0
+		 * @param to							Pose at weight 1
+		 * @param weight						Of to, 0 to 1
+		 * @param result						May be from or to
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void BlendPoses(const AnimationPose& from, const AnimationPose& to, float weight, AnimationPose& result);
+
+	private:
+		std::vector<std::string> m_JointNames;
+		std::vector<int32_t> m_Parents;
+		std::unordered_map<std::string, uint32_t> m_JointIndices;
+
+		AnimationPose m_BindPose;
+
+		// Joint and inverse bind matrix of each palette index
+		std::vector<uint32_t> m_SkinJoints;
+		std::vector<glm::mat4> m_InverseBindMatrices;
+
+		glm::mat4 m_GlobalInverseTransform;
+	};
+
+	/**
+	 * @brief How the clips are compressed as they are made
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AnimationCompressionSettings
+	{
+		/**
+		 * @brief Quantizes the animated tracks to 16 bits a component over the range of each track. The tracks constant within the
+		 * tolerances are kept once either way.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bQuantize = true;
+
+		/**
+		 * @brief Largest change of a translation (in the units of the model) over the clip for its track to be kept once
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_TranslationTolerance = 0.0001f;
+
+		/**
+		 * @brief Largest change of a rotation quaternion component for its track to be kept once
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_RotationTolerance = 0.00005f;
+
+		float m_ScaleTolerance = 0.0001f;
+
+		/**
+		 * @brief Frames a second the Assimp keys are resampled at
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_SampleRate = 30.0f;
+	};
+
+	/**
+	 * @brief A clip of joint transforms for a Skeleton. The keys are resampled at a fixed rate, and a frame holds the animated tracks
+	 * (a joint's translation, rotation or scale) side by side, so that sampling reads two frames front to back whatever the joint.
+	 * Tracks which don't change over the clip are kept once, in the base pose, and the others may be quantized to 16 bits a component.
+	 *
+	 * @see Anuprana
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API RiggedAnimation : public Animation
+	{
+	public:
+		/**
+		 * @brief Makes the clip of poses sampled at a fixed rate, compressed as the settings say
+		 *
+		 * @param name							Name of the clip
+		 * @param skeleton						Skeleton the poses are of
+		 * @param frames						The poses, the first at time 0 and one every 1 / sampleRate seconds
+		 * @param sampleRate					Frames a second
+		 * @param settings						Compression
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RiggedAnimation(const std::string& name, std::shared_ptr<Skeleton> skeleton, const std::vector<AnimationPose>& frames, float sampleRate,
+			const AnimationCompressionSettings& settings);
+
+		/**
+		 * @brief Resamples the keys of an Assimp animation. Channels of nodes which aren't joints of the skeleton are left out, and the
+		 * joints without channel keep their bind pose.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::shared_ptr<RiggedAnimation> FromAssimp(const aiAnimation* animation, std::shared_ptr<Skeleton> skeleton,
+			const AnimationCompressionSettings& settings);
+
+		/**
+		 * @brief The pose of the clip at the time, interpolating between the frames around it
+		 *
+		 * @param time							In seconds
+		 * @param bLooping						Wraps time around the duration, else clamps it
+		 * @param pose							Gets the pose, sized for the skeleton
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Sample(float time, bool bLooping, AnimationPose& pose) const;
+
+		const std::shared_ptr<Skeleton>& GetSkeleton() const { return m_Skeleton; }
+
+		uint32_t GetNumberOfFrames() const { return m_NumberOfFrames; }
+
+		/**
+		 * @brief Number of tracks changing over the clip, of the three of every joint
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfAnimatedTracks() const { return uint32_t(m_TrackTargets.size()); }
+
+		/**
+		 * @brief Bytes of the frames and of the base pose
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetMemorySize() const;
+
+		/**
+		 * @brief Bytes the frames would take with every track kept in full floats
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetUncompressedSize() const;
+
+		/**
+		 * @brief Largest difference of a component between the poses given and the ones kept, by the constant tracks' tolerance and
+		 * the quantization
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float GetCompressionError() const { return m_CompressionError; }
+
+		/**
+		 * @brief The settings the clips imported with the models are compressed with (SkeletalMesh)
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static AnimationCompressionSettings& GetDefaultCompression() { return s_DefaultCompression; }
+
+	private:
+		std::shared_ptr<Skeleton> m_Skeleton;
+
+		float m_SampleRate;
+		uint32_t m_NumberOfFrames;
+
+		// The bind pose with the constant tracks in, copied ahead of the animated ones
+		AnimationPose m_BasePose;
+
+		// Index in AnimationPose::m_Transforms each animated track goes to, and which of them are rotations
+		std::vector<uint32_t> m_TrackTargets;
+		std::vector<uint32_t> m_RotationTracks;
+
+		// Frame major, GetNumberOfAnimatedTracks values a frame, either in floats or quantized
+		bool m_bQuantized;
+		std::vector<glm::vec4> m_Frames;
+		std::vector<uint16_t> m_QuantizedFrames;
+
+		// A track's value is m_TrackMinimums + quantized * m_TrackSteps
+		std::vector<glm::vec4> m_TrackMinimums;
+		std::vector<glm::vec4> m_TrackSteps;
+
+		float m_CompressionError;
+
+		static AnimationCompressionSettings s_DefaultCompression;
+	};
+}
@@ -2,6 +2,8 @@
 #include "Karma/Log.h"
 #include "Karma/Input.h"
 #include "Karma/Renderer/Renderer.h"
+#include "Karma/Renderer/RenderThread.h"
+#include "Karma/Renderer/GPUProfiler.h"
 #include "chrono"
 #include "Engine/Engine.h"
 #include "Core/UObjectGlobals.h"// to be bundled appropriately in core.h
@@ -91,6 +93,8 @@ namespace Karma
 
 		begin = std::chrono::high_resolution_clock::now();
 
+		RenderThread::Init();
+
 		while (m_Running)
 		{
 			end = std::chrono::high_resolution_clock::now();
@@ -104,11 +108,15 @@ namespace Karma
 			// Tick KEngine
 			GEngine->Tick(deltaTime, false);
 
+			// Records this frame's render commands, while the render thread (if pipelining) plays the previous frame's
 			for (auto layer : *m_LayerStack)
 			{
 				layer->OnUpdate(deltaTime);
 			}
 
+			// KarmaGui and the window (presentation, events) use the GPU from this thread, so the render thread should be done by now
+			RenderThread::WaitForRenderThread();
+
 			// KarmaGui rendering sequence cue trickling through stack
 			m_KarmaGuiLayer->Begin();
 
@@ -120,7 +128,13 @@ namespace Karma
 			m_KarmaGuiLayer->End();
 
 			m_Window->OnUpdate();
+
+			RenderThread::KickFrame();
 		}
+
+		RenderThread::Shutdown();
+
+		GPUProfiler::LogStatistics();
 	}
 
 	bool Application::OnWindowClose(WindowCloseEvent& event)
@@ -80,9 +80,11 @@ namespace Karma
 		 * The purpose of the loop is multifold
 		 * 	- Tracking the clock time gap between consecutive loop iterations (thus compute the deltatime)
 		 * 	- Make GEngine (instance of KEngine class) tick
-		 * 	- Update all the layers of stack
+		 * 	- Update all the layers of stack (recording the frame's render commands)
+		 * 	- Wait for the render thread to finish the previous frame (RenderThread::WaitForRenderThread)
 		 * 	- Update all the layers' UI rendering (KarmaGui's sequence)
 		 * 	- Window update
+		 * 	- Hand the recorded frame over to the render thread (RenderThread::KickFrame)
 		 *
 		 * @since Karma 1.0.0
 		 */
@@ -191,6 +193,21 @@ namespace Karma
 		 */
 		void CloseApplication();
 
+		/**
+		 * @brief Sets the value main() returns once the Application is done, for instance non-zero for a run which failed its checks
+		 *
+		 * @param exitCode					The value returned, 0 for success
+		 * @since Karma 1.0.0
+		 */
+		void SetExitCode(int exitCode) { m_ExitCode = exitCode; }
+
+		/**
+		 * @brief Getter for the value main() returns, 0 unless set with SetExitCode
+		 *
+		 * @since Karma 1.0.0
+		 */
+		int GetExitCode() const { return m_ExitCode; }
+
 	private:
 		/**
 		 * @brief Privately defined Window close routine
@@ -231,6 +248,7 @@ namespace Karma
 
 		KarmaGuiLayer* m_KarmaGuiLayer;
 		bool m_Running = true;
+		int m_ExitCode = 0;
 
 		static Application* s_Instance;
 
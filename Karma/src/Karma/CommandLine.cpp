@@ -0,0 +1,103 @@
+#include "CommandLine.h"
+
+#include <algorithm>
+
+namespace Karma
+{
+	std::vector<CommandLineOptionInfo>& CommandLine::GetOptions()
+	{
+		// Options register at static initialization, whatever the order of the translation units
+		static std::vector<CommandLineOptionInfo> options;
+
+		return options;
+	}
+
+	void CommandLine::RegisterOption(const std::string& name, const std::string& description, CommandLineHandler handler,
+		const std::string& environmentVariable)
+	{
+		std::vector<CommandLineOptionInfo>& options = GetOptions();
+
+		std::vector<CommandLineOptionInfo>::iterator option = std::find_if(options.begin(), options.end(),
+			[&name](const CommandLineOptionInfo& info) { return info.m_Name == name; });
+
+		if (option == options.end())
+		{
+			options.push_back(CommandLineOptionInfo());
+			option = options.end() - 1;
+		}
+
+		option->m_Name = name;
+		option->m_Description = description;
+		option->m_EnvironmentVariable = environmentVariable;
+		option->m_Handler = handler;
+	}
+
+	void CommandLine::Process(int argc, char** argv)
+	{
+		const std::vector<CommandLineOptionInfo>& options = GetOptions();
+
+		for (const CommandLineOptionInfo& option : options)
+		{
+			if (option.m_EnvironmentVariable.empty())
+			{
+				continue;
+			}
+
+			if (const char* environmentValue = std::getenv(option.m_EnvironmentVariable.c_str()))
+			{
+				option.m_Handler(environmentValue);
+			}
+		}
+
+		for (int counter = 1; counter < argc; counter++)
+		{
+			std::string argument = argv[counter];
+
+			if (argument == "--help")
+			{
+				LogOptions();
+				continue;
+			}
+
+			if (argument.rfind("--", 0) != 0)
+			{
+				KR_CORE_WARN("Unknown argument {0}", argument);
+				continue;
+			}
+
+			const size_t equals = argument.find('=');
+			const std::string name = argument.substr(2, equals == std::string::npos ? std::string::npos : equals - 2);
+			const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+			std::vector<CommandLineOptionInfo>::const_iterator option = std::find_if(options.begin(), options.end(),
+				[&name](const CommandLineOptionInfo& info) { return info.m_Name == name; });
+
+			if (option == options.end())
+			{
+				KR_CORE_WARN("Unknown option {0}, --help lists the ones there are", argument);
+				continue;
+			}
+
+			option->m_Handler(value);
+		}
+	}
+
+	void CommandLine::LogOptions()
+	{
+		std::vector<CommandLineOptionInfo> options = GetOptions();
+
+		std::sort(options.begin(), options.end(),
+			[](const CommandLineOptionInfo& first, const CommandLineOptionInfo& second) { return first.m_Name < second.m_Name; });
+
+		for (const CommandLineOptionInfo& option : options)
+		{
+			KR_CORE_INFO("{0}{1}", option.m_Description,
+				option.m_EnvironmentVariable.empty() ? "" : " (or " + option.m_EnvironmentVariable + ")");
+		}
+	}
+
+	uint64_t CommandLine::ParseNumber(const std::string& value, uint64_t defaultValue)
+	{
+		return value.empty() ? defaultValue : std::strtoull(value.c_str(), nullptr, 10);
+	}
+}
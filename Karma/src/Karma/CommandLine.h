@@ -0,0 +1,110 @@
+/**
+ * @file CommandLine.h
+ * @brief This file contains the CommandLine class, the registry of the command line options the subsystems of the engine (and the tools
+ * built on it) register for themselves.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Called with what follows the = of --name=value, empty for a bare --name
+	 *
+	 * @since Karma 1.0.0
+	 */
+	typedef std::function<void(const std::string& value)> CommandLineHandler;
+
+	/**
+	 * @brief An option of the command line, as registered
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CommandLineOptionInfo
+	{
+		/** Without the leading --, for instance "renderer" */
+		std::string m_Name;
+
+		/** The line of the --help listing, for instance "--renderer=vulkan|opengl|null picks the rendering api" */
+		std::string m_Description;
+
+		/** Read before the command line (which wins over it), empty for none */
+		std::string m_EnvironmentVariable;
+
+		CommandLineHandler m_Handler;
+	};
+
+	/**
+	 * @brief Dispatches the arguments of main() to the handlers of the options registered. Each subsystem registers the options it
+	 * understands next to the code they configure (usually with a static CommandLineOption in its translation unit), so that neither
+	 * the engine nor the applications need a list of all of them.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API CommandLine
+	{
+	public:
+		/**
+		 * @brief Registers an option. A later registration of the same name replaces the earlier one.
+		 *
+		 * @param name							Without the leading --
+		 * @param description					The line of the --help listing, the syntax of the option and what it does
+		 * @param handler						Called for each --name or --name=value, in the order of the command line
+		 * @param environmentVariable			Variable handed to the handler (if set) before the command line is, empty for none
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void RegisterOption(const std::string& name, const std::string& description, CommandLineHandler handler,
+			const std::string& environmentVariable = "");
+
+		/**
+		 * @brief Hands the environment variables of the options and then the arguments to the handlers. Unknown arguments are warned
+		 * about, --help logs the options registered.
+		 *
+		 * @param argc						argument count
+		 * @param argv						argument vector
+		 *
+		 * @see EntryPoint.h
+		 * @since Karma 1.0.0
+		 */
+		static void Process(int argc, char** argv);
+
+		/**
+		 * @brief Logs the options registered with their descriptions
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void LogOptions();
+
+		/**
+		 * @brief The value as a number, defaultValue if it is empty
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t ParseNumber(const std::string& value, uint64_t defaultValue);
+
+	private:
+		static std::vector<CommandLineOptionInfo>& GetOptions();
+	};
+
+	/**
+	 * @brief Registers an option when constructed, for registering at static initialization like so
+	 *
+	 * static CommandLineOption s_FramesOption("frames", "--frames=N ends the run after N frames", [](const std::string& value) { ... });
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API CommandLineOption
+	{
+	public:
+		CommandLineOption(const std::string& name, const std::string& description, CommandLineHandler handler,
+			const std::string& environmentVariable = "")
+		{
+			CommandLine::RegisterOption(name, description, handler, environmentVariable);
+		}
+	};
+}
@@ -36,6 +36,7 @@ int main(int argc, char** argv)
 {
 	// TODO: add engine initialization code for various systems
 	Karma::Log::Init();
+	Karma::CommandLine::Process(argc, argv);
 	Karma::RenderCommand::Init();
 	KR_INFO("Hello Cowboy. Your lucky number is {0}", 7);
 
@@ -46,12 +47,14 @@ int main(int argc, char** argv)
 	app->PrepareApplicationForRun();
 	app->Run();
 
+	const int exitCode = app->GetExitCode();
+
 	delete app;
 
 	Karma::RenderCommand::DeInit();
 	Karma::Input::DeInit();
 
-	return 0;
+	return exitCode;
 }
 
 // If we are on Linux
@@ -72,6 +75,7 @@ int main(int argc, char** argv)
 {
 	// TODO: add engine initialization code for various systems
 	Karma::Log::Init();
+	Karma::CommandLine::Process(argc, argv);
 	Karma::RenderCommand::Init();
 	KR_INFO("Hello Cowboy. Your lucky number is {0}", 7);
 	
@@ -82,12 +86,14 @@ int main(int argc, char** argv)
 	app->PrepareApplicationForRun();
 	app->Run();
 
+	const int exitCode = app->GetExitCode();
+
 	delete app;
 	
 	Karma::RenderCommand::DeInit();
 	Karma::Input::DeInit();
 
-	return 0;
+	return exitCode;
 }
 
 // If we are on Mac
@@ -109,6 +115,7 @@ int main(int argc, char** argv)
 {
 	// TODO: add engine initialization code for various systems
 	Karma::Log::Init();
+	Karma::CommandLine::Process(argc, argv);
 	Karma::RenderCommand::Init();
 	KR_INFO("Hello Cowboy. Your lucky number is {0}", 7);
 	
@@ -118,12 +125,14 @@ int main(int argc, char** argv)
 
 	app->PrepareApplicationForRun();
 	app->Run();
+
+	const int exitCode = app->GetExitCode();
 	delete app;
 	
 	Karma::RenderCommand::DeInit();
 	Karma::Input::DeInit();
 	
-	return 0;
+	return exitCode;
 }
 
 #endif
@@ -0,0 +1,301 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+
+#ifdef KR_LINUX_PLATFORM
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace Karma
+{
+	FileWatcher::FileWatcher(std::function<void(const std::vector<std::string>&)> onChanges, uint32_t debounceMilliseconds) :
+		m_OnChanges(onChanges), m_Debounce(debounceMilliseconds), m_NotifyDescriptor(-1), m_bQuit(false)
+	{
+#ifdef KR_LINUX_PLATFORM
+		m_NotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if (m_NotifyDescriptor < 0)
+		{
+			KR_CORE_WARN("FileWatcher: inotify unavailable ({0}), polling the write times instead", errno);
+		}
+#endif
+
+		m_WatchThread = std::thread(&FileWatcher::WatchLoop, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		m_bQuit = true;
+		m_WatchThread.join();
+
+#ifdef KR_LINUX_PLATFORM
+		if (m_NotifyDescriptor >= 0)
+		{
+			// The watches go with the instance
+			close(m_NotifyDescriptor);
+		}
+#endif
+	}
+
+	bool FileWatcher::UsesNotifications()
+	{
+#ifdef KR_LINUX_PLATFORM
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	std::string FileWatcher::NormalizePath(const std::string& path)
+	{
+		// As AssetManager::NormalizePath, so that the paths told are the ones the assets were loaded by
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	std::string FileWatcher::GetDirectory(const std::string& filePath)
+	{
+		std::string directory = std::filesystem::path(filePath).parent_path().generic_string();
+
+		return directory.empty() ? "." : directory;
+	}
+
+	void FileWatcher::Watch(const std::string& filePath)
+	{
+		const std::string path = NormalizePath(filePath);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Files[path]++ > 0)
+		{
+			return;
+		}
+
+		std::error_code errorCode;
+		m_WriteTimes[path] = std::filesystem::last_write_time(path, errorCode);
+
+		const std::string directory = GetDirectory(path);
+
+		if (m_Directories[directory]++ > 0)
+		{
+			return;
+		}
+
+#ifdef KR_LINUX_PLATFORM
+		if (m_NotifyDescriptor >= 0)
+		{
+			// The directory rather than the file, editors often save by writing another file and renaming it over this one
+			const int watch = inotify_add_watch(m_NotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_MOVED_TO);
+
+			if (watch < 0)
+			{
+				KR_CORE_WARN("FileWatcher: couldn't watch the directory {0} ({1})", directory, errno);
+				return;
+			}
+
+			m_WatchDirectories[watch] = directory;
+			m_DirectoryWatches[directory] = watch;
+		}
+#endif
+	}
+
+	void FileWatcher::Unwatch(const std::string& filePath)
+	{
+		const std::string path = NormalizePath(filePath);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::unordered_map<std::string, uint32_t>::iterator file = m_Files.find(path);
+
+		if (file == m_Files.end() || --file->second > 0)
+		{
+			return;
+		}
+
+		m_Files.erase(file);
+		m_WriteTimes.erase(path);
+		m_PendingChanges.erase(path);
+
+		const std::string directory = GetDirectory(path);
+		std::unordered_map<std::string, uint32_t>::iterator watchedDirectory = m_Directories.find(directory);
+
+		if (watchedDirectory == m_Directories.end() || --watchedDirectory->second > 0)
+		{
+			return;
+		}
+
+		m_Directories.erase(watchedDirectory);
+
+#ifdef KR_LINUX_PLATFORM
+		std::unordered_map<std::string, int>::iterator watch = m_DirectoryWatches.find(directory);
+
+		if (watch != m_DirectoryWatches.end())
+		{
+			inotify_rm_watch(m_NotifyDescriptor, watch->second);
+			m_WatchDirectories.erase(watch->second);
+			m_DirectoryWatches.erase(watch);
+		}
+#endif
+	}
+
+	uint32_t FileWatcher::GetNumberOfFiles()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return uint32_t(m_Files.size());
+	}
+
+	FileWatcherStatistics FileWatcher::GetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return m_Statistics;
+	}
+
+	void FileWatcher::NoteEvent(const std::string& filePath, Clock::time_point eventTime)
+	{
+		if (m_Files.find(filePath) == m_Files.end())
+		{
+			return;
+		}
+
+		m_PendingChanges[filePath] = eventTime;
+		m_Statistics.m_NumberOfEvents++;
+	}
+
+	void FileWatcher::GatherEvents(uint32_t timeoutMilliseconds)
+	{
+#ifdef KR_LINUX_PLATFORM
+		if (m_NotifyDescriptor >= 0)
+		{
+			pollfd descriptor{};
+			descriptor.fd = m_NotifyDescriptor;
+			descriptor.events = POLLIN;
+
+			if (poll(&descriptor, 1, int(timeoutMilliseconds)) <= 0)
+			{
+				return;
+			}
+
+			const Clock::time_point now = Clock::now();
+
+			alignas(inotify_event) char buffer[4096];
+
+			while (true)
+			{
+				const ssize_t length = read(m_NotifyDescriptor, buffer, sizeof(buffer));
+
+				if (length <= 0)
+				{
+					break;
+				}
+
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += sizeof(inotify_event) + event->len;
+
+					std::unordered_map<int, std::string>::const_iterator directory = m_WatchDirectories.find(event->wd);
+
+					// Events of the directory itself have no name
+					if (directory == m_WatchDirectories.end() || event->len == 0)
+					{
+						continue;
+					}
+
+					NoteEvent(NormalizePath(directory->second + "/" + event->name), now);
+				}
+			}
+
+			return;
+		}
+#endif
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMilliseconds));
+
+		std::vector<std::string> paths;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			paths.reserve(m_Files.size());
+
+			for (const std::pair<const std::string, uint32_t>& file : m_Files)
+			{
+				paths.push_back(file.first);
+			}
+		}
+
+		// Stat without the lock, the files may be many
+		std::vector<std::pair<std::string, std::filesystem::file_time_type>> writeTimes;
+		writeTimes.reserve(paths.size());
+
+		for (const std::string& path : paths)
+		{
+			std::error_code errorCode;
+			writeTimes.emplace_back(path, std::filesystem::last_write_time(path, errorCode));
+		}
+
+		const Clock::time_point now = Clock::now();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (const std::pair<std::string, std::filesystem::file_time_type>& writeTime : writeTimes)
+		{
+			std::unordered_map<std::string, std::filesystem::file_time_type>::iterator known = m_WriteTimes.find(writeTime.first);
+
+			// Unwatched meanwhile, or unchanged
+			if (known == m_WriteTimes.end() || known->second == writeTime.second)
+			{
+				continue;
+			}
+
+			known->second = writeTime.second;
+			NoteEvent(writeTime.first, now);
+		}
+	}
+
+	void FileWatcher::WatchLoop()
+	{
+		// Polling wants a coarser tick than waiting on notifications
+		const uint32_t tickMilliseconds = m_NotifyDescriptor >= 0 ? 25 : 250;
+
+		while (!m_bQuit)
+		{
+			GatherEvents(tickMilliseconds);
+
+			std::vector<std::string> changes;
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				const Clock::time_point now = Clock::now();
+
+				for (std::unordered_map<std::string, Clock::time_point>::iterator change = m_PendingChanges.begin(); change != m_PendingChanges.end();)
+				{
+					// Still being written, most likely
+					if (now - change->second < m_Debounce)
+					{
+						++change;
+						continue;
+					}
+
+					changes.push_back(change->first);
+					change = m_PendingChanges.erase(change);
+				}
+
+				m_Statistics.m_NumberOfChanges += changes.size();
+			}
+
+			// Without the lock, the callback may well Watch and Unwatch
+			if (changes.size() && m_OnChanges)
+			{
+				std::sort(changes.begin(), changes.end());
+				m_OnChanges(changes);
+			}
+		}
+	}
+}
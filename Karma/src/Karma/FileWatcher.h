@@ -0,0 +1,149 @@
+/**
+ * @file FileWatcher.h
+ * @brief This file contains the FileWatcher class, which tells of the files changed on disk (the assets being edited) a while after their last write.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace Karma
+{
+	/**
+	 * @brief Counters of a FileWatcher since it was made
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API FileWatcherStatistics
+	{
+		/**
+		 * @brief Writes, creations and renames seen on the watched files, several a save
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfEvents = 0;
+
+		/**
+		 * @brief Changes told, a file once for the events of a save
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfChanges = 0;
+	};
+
+	/**
+	 * @brief Watches files for changes on a thread of its own and tells of them through a callback, from that thread. A file is told of
+	 * once no event has come for it in the debounce time, so that the several writes of a save (or the write and rename editors save
+	 * with) are one change, and the file is complete when it is read.
+	 *
+	 * On Linux the directories of the files are watched with inotify, so that files replaced by a rename are still seen. Elsewhere the
+	 * write times of the files are polled.
+	 *
+	 * @see AssetManager::SetHotReloadEnabled
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API FileWatcher
+	{
+	public:
+		/**
+		 * @brief Starts the watching thread
+		 *
+		 * @param onChanges						Called with the changed files (as given to Watch, normalized), from the watching thread
+		 * @param debounceMilliseconds			Quiet time after the last event of a file before it is told of
+		 *
+		 * @since Karma 1.0.0
+		 */
+		FileWatcher(std::function<void(const std::vector<std::string>&)> onChanges, uint32_t debounceMilliseconds = 100);
+
+		/**
+		 * @brief Joins the watching thread. No callback runs after.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/**
+		 * @brief Watches the file. A file watched n times is watched till the nth Unwatch.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Watch(const std::string& filePath);
+
+		void Unwatch(const std::string& filePath);
+
+		/**
+		 * @brief Number of files watched
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfFiles();
+
+		FileWatcherStatistics GetStatistics();
+
+		/**
+		 * @brief Whether the changes come from the OS's notifications (inotify), else from polling the write times
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool UsesNotifications();
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		void WatchLoop();
+
+		/**
+		 * @brief Notes an event on the file, if watched, pushing its telling back by the debounce time. The lock is held.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void NoteEvent(const std::string& filePath, Clock::time_point eventTime);
+
+		/**
+		 * @brief Reads the pending inotify events, or compares the write times when polling. The lock is not held.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void GatherEvents(uint32_t timeoutMilliseconds);
+
+		static std::string NormalizePath(const std::string& path);
+		static std::string GetDirectory(const std::string& filePath);
+
+	private:
+		std::function<void(const std::vector<std::string>&)> m_OnChanges;
+		std::chrono::milliseconds m_Debounce;
+
+		// Watched files and the number of Watch calls for each
+		std::unordered_map<std::string, uint32_t> m_Files;
+
+		// Files with events, and when the latest came
+		std::unordered_map<std::string, Clock::time_point> m_PendingChanges;
+
+		// Watched directories and the number of watched files in each
+		std::unordered_map<std::string, uint32_t> m_Directories;
+
+		// Write times, when polling
+		std::unordered_map<std::string, std::filesystem::file_time_type> m_WriteTimes;
+
+		// inotify instance and the directory of each of its watches
+		int m_NotifyDescriptor;
+		std::unordered_map<int, std::string> m_WatchDirectories;
+		std::unordered_map<std::string, int> m_DirectoryWatches;
+
+		FileWatcherStatistics m_Statistics;
+
+		std::mutex m_Mutex;
+		std::thread m_WatchThread;
+		std::atomic<bool> m_bQuit;
+	};
+}
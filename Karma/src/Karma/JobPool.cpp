@@ -0,0 +1,111 @@
+#include "JobPool.h"
+
+#include <algorithm>
+
+namespace Karma
+{
+	JobPool::JobPool(uint32_t numberOfWorkers) : m_Generation(0), m_PendingWorkers(0), m_bQuit(false), m_Job(nullptr), m_NumberOfJobs(0),
+		m_NextJob(0)
+	{
+		for (uint32_t counter = 0; counter < numberOfWorkers; counter++)
+		{
+			m_Workers.emplace_back(&JobPool::WorkerLoop, this, m_Generation);
+		}
+	}
+
+	JobPool::~JobPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bQuit = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+		m_Workers.clear();
+	}
+
+	JobPool& JobPool::GetLoadingPool()
+	{
+		static JobPool loadingPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+
+		return loadingPool;
+	}
+
+	void JobPool::WorkerLoop(uint64_t seenGeneration)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeCondition.wait(lock, [&] { return m_bQuit || m_Generation != seenGeneration; });
+
+				if (m_bQuit)
+				{
+					return;
+				}
+
+				seenGeneration = m_Generation;
+			}
+
+			RunJobs();
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (--m_PendingWorkers == 0)
+				{
+					m_DoneCondition.notify_one();
+				}
+			}
+		}
+	}
+
+	void JobPool::RunJobs()
+	{
+		uint32_t jobIndex;
+
+		while ((jobIndex = m_NextJob.fetch_add(1)) < m_NumberOfJobs)
+		{
+			(*m_Job)(jobIndex);
+		}
+	}
+
+	void JobPool::ParallelFor(uint32_t numberOfJobs, const std::function<void(uint32_t)>& job)
+	{
+		std::unique_lock<std::mutex> submitLock(m_SubmitMutex, std::try_to_lock);
+
+		// Busy (or nested), or not worth waking anyone
+		if (!submitLock.owns_lock() || m_Workers.empty() || numberOfJobs < 2)
+		{
+			for (uint32_t jobIndex = 0; jobIndex < numberOfJobs; jobIndex++)
+			{
+				job(jobIndex);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Job = &job;
+			m_NumberOfJobs = numberOfJobs;
+			m_NextJob = 0;
+			m_PendingWorkers = uint32_t(m_Workers.size());
+			m_Generation++;
+		}
+		m_WakeCondition.notify_all();
+
+		// The calling thread takes jobs as well
+		RunJobs();
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_DoneCondition.wait(lock, [&] { return m_PendingWorkers == 0; });
+
+			m_Job = nullptr;
+			m_NumberOfJobs = 0;
+		}
+	}
+}
@@ -0,0 +1,102 @@
+/**
+ * @file JobPool.h
+ * @brief This file contains the JobPool class, a fixed set of worker threads for splitting loading work (model import and all that) across cores.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace Karma
+{
+	/**
+	 * @brief Worker threads which run the jobs of a ParallelFor. Jobs are handed out one index at a time, so uneven jobs (submeshes of
+	 * very different sizes, say) still keep all of the threads busy.
+	 *
+	 * One ParallelFor runs at a time. A ParallelFor called while another is running (from another thread, or from within a job) runs its
+	 * jobs on the calling thread, so that nothing deadlocks.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API JobPool
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param numberOfWorkers				Number of worker threads (besides the calling thread). 0 runs every job on the calling thread.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		JobPool(uint32_t numberOfWorkers);
+
+		/**
+		 * @brief Joins the workers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~JobPool();
+
+		JobPool(const JobPool&) = delete;
+		JobPool& operator=(const JobPool&) = delete;
+
+		/**
+		 * @brief Runs job(0), ..., job(numberOfJobs - 1) on the workers and the calling thread, and returns once all are done
+		 *
+		 * @param numberOfJobs					Number of jobs
+		 * @param job							Called with the index of the job, from any of the threads
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ParallelFor(uint32_t numberOfJobs, const std::function<void(uint32_t)>& job);
+
+		/**
+		 * @brief Number of worker threads (besides the calling thread)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfWorkers() const { return uint32_t(m_Workers.size()); }
+
+		/**
+		 * @brief The pool shared by the loaders, with a worker for every core but the calling one. Spawned on first use.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static JobPool& GetLoadingPool();
+
+	private:
+		void WorkerLoop(uint64_t seenGeneration);
+
+		/**
+		 * @brief Takes indices of the present job till there are none left
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RunJobs();
+
+	private:
+		std::vector<std::thread> m_Workers;
+
+		// Held by the ParallelFor running
+		std::mutex m_SubmitMutex;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeCondition;
+		std::condition_variable m_DoneCondition;
+		uint64_t m_Generation;
+		uint32_t m_PendingWorkers;
+		bool m_bQuit;
+
+		// The present job
+		const std::function<void(uint32_t)>* m_Job;
+		uint32_t m_NumberOfJobs;
+		std::atomic<uint32_t> m_NextJob;
+	};
+}
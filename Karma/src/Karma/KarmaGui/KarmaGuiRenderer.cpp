@@ -2,6 +2,9 @@
 #include "Renderer/RendererAPI.h"
 #include "Vulkan/VulkanHolder.h"
 #include "Renderer/RenderCommand.h"
+#include "Vulkan/VulkanGPUProfiler.h"
+#include "OpenGL/OpenGLContext.h"
+#include "OpenGL/OpenGLGPUProfiler.h"
 
 // Emedded font
 #include "Karma/KarmaGui/Roboto-Regular.h"
@@ -10,6 +13,7 @@ namespace Karma
 {
 	VkDescriptorPool KarmaGuiRenderer::m_KarmaGuiDescriptorPool;
 	KarmaGui_ImplVulkanH_Window KarmaGuiRenderer::m_VulkanWindowData;
+	VulkanGPUProfiler* KarmaGuiRenderer::m_GPUProfiler = nullptr;
 	bool KarmaGuiRenderer::m_SwapChainRebuild;
 	GLFWwindow* KarmaGuiRenderer::m_GLFWwindow = nullptr;
 
@@ -52,6 +56,8 @@ namespace Karma
 			// Since VulkanContext has already instantiated fresh swapchain and commandbuffers, we send that false
 			KarmaGuiVulkanHandler::ShareVulkanContextResourcesOfMainWindow(&m_VulkanWindowData, true);
 
+			m_GPUProfiler = new VulkanGPUProfiler(m_VulkanWindowData.MAX_FRAMES_IN_FLIGHT);
+
 			// Load default font
 			KGFontConfig fontConfig;
 			fontConfig.FontDataOwnedByAtlas = false;
@@ -112,6 +118,15 @@ namespace Karma
 			// Load images
 			// No images to load yet
 		}
+		else if (RendererAPI::GetAPI() == RendererAPI::API::Null)
+		{
+			// No platform or renderer backend, only the font atlas (needed by KarmaGui::NewFrame) is built
+			KGFontConfig fontConfig;
+			fontConfig.FontDataOwnedByAtlas = false;
+			KGFont* robotoFont = io.Fonts->AddFontFromMemoryTTF((void*)g_RobotoRegular, sizeof(g_RobotoRegular), 20.0f, &fontConfig);
+			io.FontDefault = robotoFont;
+			io.Fonts->Build();
+		}
 	}
 
 	void KarmaGuiRenderer::AddImageTexture(char const* fileName, const std::string& label)
@@ -157,6 +172,9 @@ namespace Karma
 				KarmaGuiOpenGLHandler::KarmaGui_ImplOpenGL3_CreateTexture(fileName, label);
 			}
 			break;
+			case RendererAPI::API::Null:
+					KR_CORE_INFO("Null renderer: skipping KarmaGui image {0}", label);
+				break;
 			case RendererAPI::API::None:
 					KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 				break;
@@ -177,6 +195,13 @@ namespace Karma
 				KarmaGuiOpenGLHandler::KarmaGui_ImplOpenGL3_NewFrame();
 				KarmaGui_ImplGlfw_NewFrame();
 			break;
+		case RendererAPI::API::Null:
+			{
+				// Normally the platform backend's job
+				KarmaGuiIO& io = KarmaGui::GetIO();
+				io.DeltaTime = 1.0f / 60.0f;
+			}
+			break;
 		case RendererAPI::API::None:
 				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 			break;
@@ -204,7 +229,9 @@ namespace Karma
 			glm::vec4 clearColor = RenderCommand::GetClearColor();
 			glClearColor(clearColor.x * clearColor.w, clearColor.y * clearColor.w, clearColor.z * clearColor.w, clearColor.w);
 			glClear(GL_COLOR_BUFFER_BIT);
+			OpenGLContext::GetGPUProfiler()->BeginScope("KarmaGui", true);
 			KarmaGuiOpenGLHandler::KarmaGui_ImplOpenGL3_RenderDrawData(KarmaGui::GetDrawData());
+			OpenGLContext::GetGPUProfiler()->EndScope();
 			if (io.ConfigFlags & KGGuiConfigFlags_ViewportsEnable)
 			{
 				GLFWwindow* backup_current_context = glfwGetCurrentContext();
@@ -214,6 +241,9 @@ namespace Karma
 			}
 		}
 		break;
+		case RendererAPI::API::Null:
+			// The draw data is discarded
+			break;
 		case RendererAPI::API::None:
 			KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 			break;
@@ -302,6 +332,12 @@ namespace Karma
 				m_SwapChainRebuild = false;
 			}
 		}
+		else if (m_VulkanWindowData.Swapchain != VulkanHolder::GetVulkanContext()->GetSwapChain())
+		{
+			// Recreated elsewhere (out of date on the renderer's side, vsync toggle, resize benchmark). The old handles are retired by
+			// the context and stay valid for a few frames.
+			KarmaGuiVulkanHandler::ShareVulkanContextResourcesOfMainWindow(&m_VulkanWindowData, false);
+		}
 
 		KarmaGuiVulkanHandler::KarmaGui_ImplVulkan_NewFrame();
 		KarmaGui_ImplGlfw_NewFrame();
@@ -360,6 +396,9 @@ namespace Karma
 			KarmaGui_ImplGlfw_Shutdown();
 			KarmaGui::DestroyContext();
 			break;
+		case RendererAPI::API::Null:
+			KarmaGui::DestroyContext();
+			break;
 		case RendererAPI::API::None:
 			KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 			break;
@@ -384,6 +423,12 @@ namespace Karma
 
 		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to wait for the completion of command buffers");
 
+		if (m_GPUProfiler)
+		{
+			delete m_GPUProfiler;
+			m_GPUProfiler = nullptr;
+		}
+
 		CleanUpVulkanAndWindowData();
 
 		KarmaGuiVulkanHandler::KarmaGui_ImplVulkan_Shutdown();
@@ -477,6 +522,11 @@ namespace Karma
 		result = vkBeginCommandBuffer(frameOnFlightData->CommandBuffer, &info);
 		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to begin command buffer");
 
+		// The fence has been waited upon, so the previous results of this frame are in. The overlay records no secondaries, so it may
+		// count its invocations as well.
+		m_GPUProfiler->BeginFrame(frameOnFlightData->CommandBuffer, windowData->SemaphoreIndex);
+		m_GPUProfiler->BeginScope(frameOnFlightData->CommandBuffer, "KarmaGui", true);
+
 		// Render Pass
 		// Ponder over here for UI and 3D model depth stuff
 		VkRenderPassBeginInfo renderPassInfo = {};
@@ -502,6 +552,8 @@ namespace Karma
 
 		vkCmdEndRenderPass(frameOnFlightData->CommandBuffer);
 
+		m_GPUProfiler->EndScope(frameOnFlightData->CommandBuffer);
+
 		result = vkEndCommandBuffer(frameOnFlightData->CommandBuffer);
 		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to end command buffer");
 		// Recording ends:
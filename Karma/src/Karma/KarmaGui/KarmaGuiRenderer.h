@@ -18,6 +18,8 @@
 
 namespace Karma
 {
+	class VulkanGPUProfiler;
+
 	/**
 	 * @brief A multiply inherited class for supporting both OpenGL and Vulkan API's.
 	 *
@@ -88,6 +90,9 @@ namespace Karma
 		static VkDescriptorPool m_KarmaGuiDescriptorPool;
 		static KarmaGui_ImplVulkanH_Window m_VulkanWindowData;
 
+		// Times the overlay's render pass, with the frames in flight of m_VulkanWindowData
+		static VulkanGPUProfiler* m_GPUProfiler;
+
 		static bool m_SwapChainRebuild;
 	};
 }
@@ -33,4 +33,9 @@ namespace Karma
 	{
 		return stbi_load(fileName, width, height, channels, req_comp);
 	}
+
+	bool KarmaUtilities::GetImageInfo(char const* fileName, int* width, int* height, int* channels)
+	{
+		return stbi_info(fileName, width, height, channels) != 0;
+	}
 }
\ No newline at end of file
@@ -78,6 +78,19 @@ namespace Karma
 		 * @since Karma 1.0.0
 		 */
 		static unsigned char* GetImagePixelData(char const* fileName, int* width, int* height, int* channels, int req_comp);
+
+		/**
+		 * @brief Reads the size and number of components of the supplied image file, without decoding the pixels
+		 *
+		 * @param fileName						The relative path to the file location
+		 * @param width							outputs image width in pixels
+		 * @param height						outputs image height in pixels
+		 * @param channels						outputs number of image components in image file
+		 *
+		 * @return false if the file can't be read or isn't an image
+		 * @since Karma 1.0.0
+		 */
+		static bool GetImageInfo(char const* fileName, int* width, int* height, int* channels);
 	};
 
 	/**
@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+
+#ifdef KR_WINDOWS_PLATFORM
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Karma
+{
+	MappedFile::MappedFile() : m_Data(nullptr), m_Size(0), m_MappingHandle(nullptr)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef KR_WINDOWS_PLATFORM
+	bool MappedFile::Open(const std::string& filePath)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// The view keeps the mapping, and the mapping the file, alive
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		CloseHandle(file);
+
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+		if (view == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		m_Data = static_cast<uint8_t*>(view);
+		m_Size = size_t(fileSize.QuadPart);
+		m_MappingHandle = mapping;
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+		{
+			UnmapViewOfFile(m_Data);
+			CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+		}
+
+		m_Data = nullptr;
+		m_Size = 0;
+		m_MappingHandle = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& filePath)
+	{
+		Close();
+
+		int file = open(filePath.c_str(), O_RDONLY);
+
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStatus;
+		if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		// The mapping outlives the descriptor
+		void* data = mmap(nullptr, size_t(fileStatus.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		close(file);
+
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		m_Data = static_cast<uint8_t*>(data);
+		m_Size = size_t(fileStatus.st_size);
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+		{
+			munmap(m_Data, m_Size);
+		}
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+#endif
+}
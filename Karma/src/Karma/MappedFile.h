@@ -0,0 +1,87 @@
+/**
+ * @file MappedFile.h
+ * @brief This file contains the MappedFile class, a read only view of a file mapped into memory.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief A file mapped into the address space (mmap, or MapViewOfFile on Windows), so that cooked data can be handed around without
+	 * being read or parsed. Pages are brought in by the OS as they are touched.
+	 *
+	 * The mapping is copy on write: writes through GetData go to private pages, never to the file.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API MappedFile
+	{
+	public:
+		/**
+		 * @brief Nothing mapped yet
+		 *
+		 * @since Karma 1.0.0
+		 */
+		MappedFile();
+
+		/**
+		 * @brief Unmaps, if mapped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @brief Maps the whole of the file, unmapping the previous one if any
+		 *
+		 * @param filePath						Path of the file
+		 *
+		 * @return false if the file can't be opened or is empty
+		 * @since Karma 1.0.0
+		 */
+		bool Open(const std::string& filePath);
+
+		/**
+		 * @brief Unmaps the file
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Close();
+
+		/**
+		 * @brief Whether a file is mapped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsOpen() const { return m_Data != nullptr; }
+
+		/**
+		 * @brief First byte of the file, page aligned
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint8_t* GetData() const { return m_Data; }
+
+		/**
+		 * @brief Size of the file in bytes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		uint8_t* m_Data;
+		size_t m_Size;
+
+		// The mapping object on Windows, unused elsewhere
+		void* m_MappingHandle;
+	};
+}
@@ -0,0 +1,1078 @@
+#include "AssetManager.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "Material.h"
+#include "Buffer.h"
+#include "Renderer.h"
+#include "CookedMesh.h"
+#include "TextureStreamer.h"
+#include "VertexArray.h"
+#include "RenderThread.h"
+#include "Karma/JobPool.h"
+#include "Karma/FileWatcher.h"
+#include "Karma/CommandLine.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace Karma
+{
+	// What GetAsset gives till the asset is Ready
+	static const std::shared_ptr<void> s_NoAsset;
+
+	static CommandLineOption s_HotReloadOption("hot-reload", "--hot-reload watches the files of the loaded assets and reloads the edited ones at the next frame",
+		[](const std::string& value) { AssetManager::Get().SetHotReloadEnabled(true); });
+
+	AssetHandleBase::AssetHandleBase() : m_Record(nullptr)
+	{
+	}
+
+	AssetHandleBase::AssetHandleBase(AssetRecord* record) : m_Record(record)
+	{
+	}
+
+	AssetHandleBase::AssetHandleBase(const AssetHandleBase& other) : m_Record(other.m_Record)
+	{
+		if (m_Record)
+		{
+			m_Record->m_References++;
+		}
+	}
+
+	AssetHandleBase::AssetHandleBase(AssetHandleBase&& other) noexcept : m_Record(other.m_Record)
+	{
+		other.m_Record = nullptr;
+	}
+
+	AssetHandleBase& AssetHandleBase::operator=(const AssetHandleBase& other)
+	{
+		if (m_Record != other.m_Record)
+		{
+			if (other.m_Record)
+			{
+				other.m_Record->m_References++;
+			}
+
+			Reset();
+			m_Record = other.m_Record;
+		}
+
+		return *this;
+	}
+
+	AssetHandleBase& AssetHandleBase::operator=(AssetHandleBase&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			m_Record = other.m_Record;
+			other.m_Record = nullptr;
+		}
+
+		return *this;
+	}
+
+	AssetHandleBase::~AssetHandleBase()
+	{
+		Reset();
+	}
+
+	void AssetHandleBase::Reset()
+	{
+		// The record is unloaded by the next AssetManager::Update, if nothing takes it again meanwhile
+		if (m_Record)
+		{
+			m_Record->m_References--;
+			m_Record = nullptr;
+		}
+	}
+
+	AssetState AssetHandleBase::GetState() const
+	{
+		return m_Record ? m_Record->m_State.load() : AssetState::Failed;
+	}
+
+	AssetGUID AssetHandleBase::GetGUID() const
+	{
+		return m_Record ? m_Record->m_GUID : 0;
+	}
+
+	AssetType AssetHandleBase::GetType() const
+	{
+		return m_Record ? m_Record->m_Type : AssetType::Count;
+	}
+
+	const std::string& AssetHandleBase::GetPath() const
+	{
+		static const std::string noPath;
+
+		return m_Record ? m_Record->m_Path : noPath;
+	}
+
+	bool AssetHandleBase::Wait() const
+	{
+		return m_Record ? m_Record->m_Manager->Wait(m_Record) : false;
+	}
+
+	const std::shared_ptr<void>& AssetHandleBase::GetAsset() const
+	{
+		return IsReady() ? m_Record->m_Asset : s_NoAsset;
+	}
+
+	AssetManager::AssetManager() : m_Watcher(nullptr), m_ReloadGeneration(0), m_NextSequence(0), m_NumberOfRunningPrepares(0), m_bQuit(false)
+	{
+		m_Pool = &JobPool::GetLoadingPool();
+		m_PrepareThread = std::thread(&AssetManager::PrepareLoop, this);
+	}
+
+	AssetManager::~AssetManager()
+	{
+		// No change told from here on
+		SetHotReloadEnabled(false);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bQuit = true;
+		}
+		m_PrepareCondition.notify_all();
+
+		m_PrepareThread.join();
+
+		// The assets still loaded are ReleaseResources' business, the context may be gone by now
+		for (std::pair<const AssetGUID, AssetRecord*>& record : m_Records)
+		{
+			if (record.second->m_References == 0 && !record.second->m_Asset)
+			{
+				delete record.second;
+			}
+		}
+		m_Records.clear();
+	}
+
+	AssetManager& AssetManager::Get()
+	{
+		static AssetManager assetManager;
+
+		return assetManager;
+	}
+
+	AssetHandle<Mesh> AssetManager::LoadMesh(const std::string& filePath, AssetPriority priority)
+	{
+		const std::string path = NormalizePath(filePath);
+
+		return AssetHandle<Mesh>(Request(AssetType::Mesh, path, path, { path }, priority,
+			[path]()
+			{
+				return Mesh::Prepare(path);
+			},
+			[path]() -> std::shared_ptr<void>
+			{
+				std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>(path);
+
+				// The constructor logged why
+				return mesh->GetVertexBuffer() && mesh->GetIndexBuffer() ? mesh : nullptr;
+			}));
+	}
+
+	AssetHandle<Texture> AssetManager::LoadTexture(const std::string& filePath, const std::string& textureName, const std::string& textureShaderName,
+		AssetPriority priority)
+	{
+		const std::string path = NormalizePath(filePath);
+
+		return AssetHandle<Texture>(Request(AssetType::Texture, path + "|" + textureShaderName, path, { path }, priority,
+			[path]()
+			{
+				return Texture::Prepare(path);
+			},
+			[path, textureName, textureShaderName]() -> std::shared_ptr<void>
+			{
+				return std::make_shared<Texture>(TextureType::Image, path.c_str(), textureName, textureShaderName);
+			}));
+	}
+
+	AssetHandle<Shader> AssetManager::LoadShader(const std::string& vertexSrcFile, const std::string& fragmentSrcFile,
+		std::shared_ptr<UniformBufferObject> ubo, const std::string& shaderName, AssetPriority priority)
+	{
+		const std::string vertexPath = NormalizePath(vertexSrcFile);
+		const std::string fragmentPath = NormalizePath(fragmentSrcFile);
+
+		return AssetHandle<Shader>(Request(AssetType::Shader, vertexPath + "|" + fragmentPath + "|" + shaderName, vertexPath, { vertexPath, fragmentPath },
+			priority,
+			[vertexPath, fragmentPath]()
+			{
+				// Vulkan compiles here, so that Create only looks the SPIR-V up
+				return Shader::Prepare(vertexPath, fragmentPath);
+			},
+			[vertexPath, fragmentPath, ubo, shaderName]() -> std::shared_ptr<void>
+			{
+				return std::shared_ptr<Shader>(Shader::Create(vertexPath, fragmentPath, ubo, shaderName));
+			}));
+	}
+
+	AssetHandle<Material> AssetManager::LoadMaterial(const std::string& materialName, const AssetHandle<Shader>& shader,
+		const std::vector<AssetHandle<Texture>>& textures, AssetPriority priority)
+	{
+		std::vector<AssetHandleBase> dependencies(textures.begin(), textures.end());
+		dependencies.push_back(shader);
+
+		// Made once the dependencies are Ready
+		return AssetHandle<Material>(Request(AssetType::Material, materialName, materialName, {}, priority, nullptr,
+			[shader, textures]() -> std::shared_ptr<void>
+			{
+				std::shared_ptr<Material> material = std::make_shared<Material>();
+
+				material->AddShader(shader.GetShared());
+
+				for (const AssetHandle<Texture>& texture : textures)
+				{
+					material->AddTexture(texture.GetShared());
+				}
+
+				return material;
+			}, dependencies));
+	}
+
+	AssetGUID AssetManager::GetMeshGUID(const std::string& filePath)
+	{
+		return MakeGUID(AssetType::Mesh, NormalizePath(filePath));
+	}
+
+	AssetGUID AssetManager::GetTextureGUID(const std::string& filePath, const std::string& textureShaderName)
+	{
+		return MakeGUID(AssetType::Texture, NormalizePath(filePath) + "|" + textureShaderName);
+	}
+
+	AssetGUID AssetManager::GetShaderGUID(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, const std::string& shaderName)
+	{
+		return MakeGUID(AssetType::Shader, NormalizePath(vertexSrcFile) + "|" + NormalizePath(fragmentSrcFile) + "|" + shaderName);
+	}
+
+	AssetGUID AssetManager::GetMaterialGUID(const std::string& materialName)
+	{
+		return MakeGUID(AssetType::Material, materialName);
+	}
+
+	AssetGUID AssetManager::MakeGUID(AssetType type, const std::string& key)
+	{
+		const uint32_t typeValue = uint32_t(type);
+
+		return CookedMesh::HashBytes(key.data(), key.size(), CookedMesh::HashBytes(&typeValue, sizeof(typeValue)));
+	}
+
+	std::string AssetManager::NormalizePath(const std::string& path)
+	{
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	AssetRecord* AssetManager::Request(AssetType type, const std::string& key, const std::string& path, const std::vector<std::string>& files,
+		AssetPriority priority, std::function<bool()> prepare, std::function<std::shared_ptr<void>()> create, const std::vector<AssetHandleBase>& dependencies)
+	{
+		const AssetGUID guid = MakeGUID(type, key);
+		AssetRecord* record = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			m_Statistics.m_NumberOfRequests++;
+
+			std::unordered_map<AssetGUID, AssetRecord*>::iterator found = m_Records.find(guid);
+
+			if (found != m_Records.end())
+			{
+				record = found->second;
+
+				if (record->m_Key != key)
+				{
+					KR_CORE_WARN("The assets {0} and {1} have the same GUID, the first one is given for both", record->m_Key, key);
+				}
+
+				if (record->m_State == AssetState::Failed)
+				{
+					// The file may be there by now
+					record->m_Priority = priority;
+					record->m_State = AssetState::Queued;
+					record->m_RequestTime = std::chrono::high_resolution_clock::now();
+					Enqueue(record);
+				}
+				else
+				{
+					m_Statistics.m_NumberOfCoalescedRequests++;
+
+					// A more urgent request moves the load up the queue
+					if (record->m_State == AssetState::Queued && priority > record->m_Priority)
+					{
+						record->m_Priority = priority;
+						Enqueue(record);
+					}
+				}
+			}
+			else
+			{
+				record = new AssetRecord();
+				record->m_Manager = this;
+				record->m_GUID = guid;
+				record->m_Type = type;
+				record->m_Key = key;
+				record->m_Path = path;
+				record->m_Files = files;
+				record->m_Priority = priority;
+				record->m_Prepare = prepare;
+				record->m_Create = create;
+				record->m_Dependencies = dependencies;
+				record->m_RequestTime = std::chrono::high_resolution_clock::now();
+
+				m_Records[guid] = record;
+
+				if (m_Watcher)
+				{
+					for (const std::string& file : files)
+					{
+						m_Watcher->Watch(file);
+					}
+				}
+
+				Enqueue(record);
+			}
+
+			record->m_References++;
+		}
+
+		if (priority == AssetPriority::Immediate)
+		{
+			Wait(record);
+		}
+
+		return record;
+	}
+
+	AssetRecord* AssetManager::FindRecord(AssetType type, AssetGUID guid)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::unordered_map<AssetGUID, AssetRecord*>::iterator found = m_Records.find(guid);
+
+		if (found == m_Records.end() || found->second->m_Type != type)
+		{
+			return nullptr;
+		}
+
+		found->second->m_References++;
+
+		return found->second;
+	}
+
+	void AssetManager::Enqueue(AssetRecord* record)
+	{
+		record->m_Sequence = m_NextSequence++;
+
+		QueuedLoad load;
+		load.m_Priority = record->m_Priority;
+		load.m_Sequence = record->m_Sequence;
+		load.m_GUID = record->m_GUID;
+		load.m_bReload = false;
+
+		m_Queue.push(load);
+		m_PrepareCondition.notify_one();
+	}
+
+	void AssetManager::EnqueueReload(AssetRecord* record)
+	{
+		record->m_ReloadSequence = m_NextSequence++;
+
+		QueuedLoad load;
+		load.m_Priority = AssetPriority::High;
+		load.m_Sequence = record->m_ReloadSequence;
+		load.m_GUID = record->m_GUID;
+		load.m_bReload = true;
+
+		m_Queue.push(load);
+		m_PrepareCondition.notify_one();
+	}
+
+	void AssetManager::PrepareLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		while (true)
+		{
+			m_PrepareCondition.wait(lock, [this] { return m_bQuit || m_Queue.size(); });
+
+			if (m_bQuit)
+			{
+				return;
+			}
+
+			std::vector<AssetRecord*> batch;
+			std::vector<uint8_t> reloads;
+
+			while (m_Queue.size() && batch.size() < std::max(m_Settings.m_PrepareBatchSize, 1u))
+			{
+				QueuedLoad load = m_Queue.top();
+				m_Queue.pop();
+
+				std::unordered_map<AssetGUID, AssetRecord*>::iterator found = m_Records.find(load.m_GUID);
+
+				if (found == m_Records.end())
+				{
+					continue;
+				}
+
+				if (load.m_bReload)
+				{
+					// Dropped by ReleaseResources. The asset stays Ready meanwhile, the handles using what is loaded.
+					if (!found->second->m_bReloadPending || found->second->m_ReloadSequence != load.m_Sequence)
+					{
+						continue;
+					}
+				}
+				else
+				{
+					// Queued again since or taken by a Wait
+					if (found->second->m_Sequence != load.m_Sequence || found->second->m_State != AssetState::Queued)
+					{
+						continue;
+					}
+
+					found->second->m_State = AssetState::Preparing;
+				}
+
+				batch.push_back(found->second);
+				reloads.push_back(load.m_bReload ? 1 : 0);
+			}
+
+			if (batch.empty())
+			{
+				// Only stale entries, the queue may be empty now
+				m_PreparedCondition.notify_all();
+				continue;
+			}
+
+			m_NumberOfRunningPrepares += uint32_t(batch.size());
+
+			lock.unlock();
+
+			std::vector<uint8_t> succeeded(batch.size(), 0);
+
+			m_Pool->ParallelFor(uint32_t(batch.size()), [&batch, &succeeded](uint32_t job)
+			{
+				succeeded[job] = !batch[job]->m_Prepare || batch[job]->m_Prepare() ? 1 : 0;
+			});
+
+			lock.lock();
+
+			for (uint32_t counter = 0; counter < uint32_t(batch.size()); counter++)
+			{
+				AssetRecord* record = batch[counter];
+
+				if (reloads[counter])
+				{
+					if (succeeded[counter])
+					{
+						m_PreparedReloads.push_back(record);
+					}
+					else
+					{
+						KR_CORE_WARN("Couldn't reload the {0} {1}, keeping the loaded one", GetTypeName(record->m_Type), record->m_Path);
+						record->m_bReloadPending = false;
+						m_Statistics.m_NumberOfFailedReloads++;
+					}
+
+					continue;
+				}
+
+				if (succeeded[counter])
+				{
+					record->m_State = AssetState::Prepared;
+					m_Prepared.push_back(record);
+				}
+				else
+				{
+					KR_CORE_WARN("Couldn't load the {0} {1}", GetTypeName(record->m_Type), record->m_Path);
+					record->m_State = AssetState::Failed;
+					m_Statistics.m_NumberOfFailures++;
+				}
+			}
+
+			m_NumberOfRunningPrepares -= uint32_t(batch.size());
+			m_PreparedCondition.notify_all();
+		}
+	}
+
+	bool AssetManager::Wait(AssetRecord* record)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		bool bPreparedHere = false;
+
+		if (record->m_State == AssetState::Queued)
+		{
+			// Not worth waiting for the loading thread to get to it
+			record->m_State = AssetState::Preparing;
+			m_NumberOfRunningPrepares++;
+
+			lock.unlock();
+			const bool bPrepared = !record->m_Prepare || record->m_Prepare();
+			lock.lock();
+
+			m_NumberOfRunningPrepares--;
+
+			if (bPrepared)
+			{
+				record->m_State = AssetState::Prepared;
+				bPreparedHere = true;
+			}
+			else
+			{
+				KR_CORE_WARN("Couldn't load the {0} {1}", GetTypeName(record->m_Type), record->m_Path);
+				record->m_State = AssetState::Failed;
+				m_Statistics.m_NumberOfFailures++;
+			}
+
+			m_PreparedCondition.notify_all();
+		}
+		else if (record->m_State == AssetState::Preparing)
+		{
+			m_PreparedCondition.wait(lock, [record] { return record->m_State != AssetState::Preparing; });
+		}
+
+		// Off the list, Update is making it on the render thread. It is made, or put back if its dependencies aren't ready yet.
+		if (!bPreparedHere)
+		{
+			m_PreparedCondition.wait(lock, [this, record]
+			{
+				return record->m_State != AssetState::Prepared || std::find(m_Prepared.begin(), m_Prepared.end(), record) != m_Prepared.end();
+			});
+		}
+
+		if (record->m_State != AssetState::Prepared)
+		{
+			return record->m_State == AssetState::Ready;
+		}
+
+		m_Prepared.erase(std::remove(m_Prepared.begin(), m_Prepared.end(), record), m_Prepared.end());
+
+		lock.unlock();
+
+		for (const AssetHandleBase& dependency : record->m_Dependencies)
+		{
+			dependency.Wait();
+		}
+
+		// Made here, on the game thread, so the render thread (which makes the others in Update) is waited for
+		if (!RenderThread::IsRenderThread())
+		{
+			RenderThread::WaitForRenderThread();
+		}
+
+		Create(record);
+
+		return record->m_State == AssetState::Ready;
+	}
+
+	bool AssetManager::Create(AssetRecord* record)
+	{
+		for (const AssetHandleBase& dependency : record->m_Dependencies)
+		{
+			if (dependency.IsFailed())
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				KR_CORE_WARN("Couldn't load the {0} {1}, the {2} {3} failed", GetTypeName(record->m_Type), record->m_Path,
+					GetTypeName(dependency.GetType()), dependency.GetPath());
+				record->m_State = AssetState::Failed;
+				m_Statistics.m_NumberOfFailures++;
+				m_PreparedCondition.notify_all();
+
+				return true;
+			}
+
+			if (!dependency.IsReady())
+			{
+				return false;
+			}
+		}
+
+		std::shared_ptr<void> asset = record->m_Create();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// For a Wait on another thread
+		m_PreparedCondition.notify_all();
+
+		if (asset)
+		{
+			record->m_Asset = asset;
+			record->m_State = AssetState::Ready;
+
+			m_Statistics.m_NumberOfLoads++;
+			m_Statistics.m_LoadMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() -
+				record->m_RequestTime).count();
+		}
+		else
+		{
+			KR_CORE_WARN("Couldn't load the {0} {1}", GetTypeName(record->m_Type), record->m_Path);
+			record->m_State = AssetState::Failed;
+			m_Statistics.m_NumberOfFailures++;
+		}
+
+		return true;
+	}
+
+	void AssetManager::Update()
+	{
+		std::vector<AssetRecord*> creates;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			// The most urgent first, in the order they were prepared within a priority
+			std::stable_sort(m_Prepared.begin(), m_Prepared.end(), [](const AssetRecord* first, const AssetRecord* second)
+			{
+				return first->m_Priority > second->m_Priority;
+			});
+
+			const size_t numberOfCreates = std::min(m_Prepared.size(), size_t(std::max(m_Settings.m_MaxCreatesPerFrame, 1u)));
+
+			creates.assign(m_Prepared.begin(), m_Prepared.begin() + numberOfCreates);
+			m_Prepared.erase(m_Prepared.begin(), m_Prepared.begin() + numberOfCreates);
+		}
+
+		for (AssetRecord* record : creates)
+		{
+			// Dependencies still loading, or nothing wants it anymore (CollectUnreferenced takes it off the list)
+			if (record->m_References == 0 || !Create(record))
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Prepared.push_back(record);
+
+				// A Wait for it on the game thread makes it itself
+				m_PreparedCondition.notify_all();
+			}
+		}
+
+		CollectUnreferenced();
+	}
+
+	bool AssetManager::HasPreparedReloads()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return !m_PreparedReloads.empty();
+	}
+
+	void AssetManager::ApplyReloads()
+	{
+		std::vector<AssetRecord*> reloads;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			reloads.swap(m_PreparedReloads);
+		}
+
+		// The old contents, let go of without the lock
+		std::vector<std::shared_ptr<void>> retired;
+
+		for (AssetRecord* record : reloads)
+		{
+			// Not worth making if it is about to be unloaded
+			const bool bWanted = record->m_Asset && (record->m_References > 0 || record->m_Asset.use_count() > 1);
+			std::shared_ptr<void> reloaded = bWanted ? record->m_Create() : nullptr;
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			record->m_bReloadPending = false;
+
+			if (!bWanted)
+			{
+				continue;
+			}
+
+			if (!reloaded)
+			{
+				KR_CORE_WARN("Couldn't reload the {0} {1}, keeping the loaded one", GetTypeName(record->m_Type), record->m_Path);
+				m_Statistics.m_NumberOfFailedReloads++;
+				continue;
+			}
+
+			SwapContents(record->m_Type, record->m_Asset.get(), reloaded.get());
+			retired.push_back(std::move(reloaded));
+
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() -
+				record->m_ReloadRequestTime).count();
+
+			m_Statistics.m_NumberOfReloads++;
+			m_Statistics.m_ReloadMilliseconds += milliseconds;
+			m_ReloadGeneration++;
+
+			KR_CORE_INFO("Reloaded the {0} {1} in {2} ms", GetTypeName(record->m_Type), record->m_Path, milliseconds);
+		}
+	}
+
+	void AssetManager::SwapContents(AssetType type, void* asset, void* reloaded)
+	{
+		switch (type)
+		{
+		case AssetType::Mesh:
+			static_cast<Mesh*>(asset)->SwapContents(*static_cast<Mesh*>(reloaded));
+			break;
+		case AssetType::Texture:
+			static_cast<Texture*>(asset)->SwapContents(*static_cast<Texture*>(reloaded));
+			break;
+		case AssetType::Shader:
+			static_cast<Shader*>(asset)->SwapContents(*static_cast<Shader*>(reloaded));
+			break;
+		case AssetType::Material:
+		case AssetType::Count:
+			KR_CORE_ASSERT(false, "Materials aren't reloaded");
+			break;
+		}
+	}
+
+	void AssetManager::ReloadFiles(const std::vector<std::string>& filePaths)
+	{
+		std::unordered_set<std::string> changedFiles;
+
+		for (const std::string& filePath : filePaths)
+		{
+			changedFiles.insert(NormalizePath(filePath));
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (std::pair<const AssetGUID, AssetRecord*>& entry : m_Records)
+		{
+			AssetRecord* record = entry.second;
+
+			if (std::none_of(record->m_Files.begin(), record->m_Files.end(), [&changedFiles](const std::string& file)
+				{
+					return changedFiles.count(file) > 0;
+				}))
+			{
+				continue;
+			}
+
+			if (record->m_State == AssetState::Failed)
+			{
+				// Fixed, perhaps
+				record->m_State = AssetState::Queued;
+				record->m_RequestTime = std::chrono::high_resolution_clock::now();
+				Enqueue(record);
+			}
+			else if (record->m_State == AssetState::Ready && !record->m_bReloadPending)
+			{
+				record->m_bReloadPending = true;
+				record->m_ReloadRequestTime = std::chrono::high_resolution_clock::now();
+				EnqueueReload(record);
+			}
+		}
+	}
+
+	void AssetManager::SetHotReloadEnabled(bool bEnabled)
+	{
+		if (bEnabled)
+		{
+			// Made without the lock, its thread calls ReloadFiles
+			FileWatcher* watcher = new FileWatcher([this](const std::vector<std::string>& changedFiles)
+			{
+				ReloadFiles(changedFiles);
+			});
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (m_Watcher)
+			{
+				delete watcher;
+				return;
+			}
+
+			for (const std::pair<const AssetGUID, AssetRecord*>& record : m_Records)
+			{
+				for (const std::string& file : record.second->m_Files)
+				{
+					watcher->Watch(file);
+				}
+			}
+
+			m_Watcher = watcher;
+
+			KR_CORE_INFO("Hot reload on, watching {0} files{1}", m_Watcher->GetNumberOfFiles(), FileWatcher::UsesNotifications() ? "" : " (polling)");
+			return;
+		}
+
+		FileWatcher* watcher = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::swap(watcher, m_Watcher);
+		}
+
+		// Joined without the lock, a change being told may be waiting for it
+		delete watcher;
+	}
+
+	bool AssetManager::IsHotReloadEnabled()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return m_Watcher != nullptr;
+	}
+
+	uint32_t AssetManager::GetNumberOfWatchedFiles()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return m_Watcher ? m_Watcher->GetNumberOfFiles() : 0;
+	}
+
+	void AssetManager::UnwatchFiles(const AssetRecord* record)
+	{
+		if (m_Watcher)
+		{
+			for (const std::string& file : record->m_Files)
+			{
+				m_Watcher->Unwatch(file);
+			}
+		}
+	}
+
+	void AssetManager::CollectUnreferenced()
+	{
+		// Deleting a material lets go of its shader and textures, which may go in the next round
+		while (true)
+		{
+			std::vector<AssetRecord*> unloads;
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+
+				for (std::unordered_map<AssetGUID, AssetRecord*>::iterator record = m_Records.begin(); record != m_Records.end();)
+				{
+					AssetRecord* candidate = record->second;
+
+					// Held by a handle, a loading thread (loading or reloading it), or whoever took the shared_ptr
+					if (candidate->m_References > 0 || candidate->m_State == AssetState::Preparing || candidate->m_bReloadPending ||
+						(candidate->m_Asset && candidate->m_Asset.use_count() > 1))
+					{
+						++record;
+						continue;
+					}
+
+					if (candidate->m_State == AssetState::Prepared)
+					{
+						m_Prepared.erase(std::remove(m_Prepared.begin(), m_Prepared.end(), candidate), m_Prepared.end());
+					}
+					else if (candidate->m_State == AssetState::Ready)
+					{
+						m_Statistics.m_NumberOfUnloads++;
+					}
+
+					UnwatchFiles(candidate);
+
+					unloads.push_back(candidate);
+					record = m_Records.erase(record);
+				}
+			}
+
+			if (unloads.empty())
+			{
+				break;
+			}
+
+			// The GPU objects go here, on the render thread, and the dependencies are released without the lock
+			for (AssetRecord* record : unloads)
+			{
+				delete record;
+			}
+		}
+	}
+
+	void AssetManager::WaitForLoads()
+	{
+		// The assets are made here, with the render thread idle
+		if (!RenderThread::IsRenderThread())
+		{
+			RenderThread::WaitForRenderThread();
+		}
+
+		while (true)
+		{
+			std::vector<AssetRecord*> prepared;
+
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+
+				m_PreparedCondition.wait(lock, [this] { return m_Queue.empty() && m_NumberOfRunningPrepares == 0; });
+
+				prepared.swap(m_Prepared);
+			}
+
+			if (prepared.empty())
+			{
+				return;
+			}
+
+			// Over and over, a material made once its textures are (which may come after it in the list)
+			bool bCreated = false;
+			std::vector<AssetRecord*> deferred;
+
+			for (AssetRecord* record : prepared)
+			{
+				if (Create(record))
+				{
+					bCreated = true;
+				}
+				else
+				{
+					deferred.push_back(record);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Prepared.insert(m_Prepared.end(), deferred.begin(), deferred.end());
+			m_PreparedCondition.notify_all();
+
+			if (!bCreated)
+			{
+				return;
+			}
+		}
+	}
+
+	void AssetManager::ReleaseResources()
+	{
+		std::vector<std::shared_ptr<void>> assets;
+		std::vector<AssetRecord*> releases;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			m_Queue = std::priority_queue<QueuedLoad>();
+			m_PreparedCondition.wait(lock, [this] { return m_NumberOfRunningPrepares == 0; });
+
+			m_Prepared.clear();
+			m_PreparedReloads.clear();
+
+			for (std::unordered_map<AssetGUID, AssetRecord*>::iterator record = m_Records.begin(); record != m_Records.end();)
+			{
+				AssetRecord* released = record->second;
+
+				// A request for it loads it again
+				released->m_State = AssetState::Failed;
+				released->m_bReloadPending = false;
+				assets.push_back(std::move(released->m_Asset));
+
+				if (released->m_References == 0)
+				{
+					UnwatchFiles(released);
+					releases.push_back(released);
+					record = m_Records.erase(record);
+				}
+				else
+				{
+					++record;
+				}
+			}
+		}
+
+		// Without the lock, the records of the materials letting go of their dependencies
+		assets.clear();
+
+		for (AssetRecord* record : releases)
+		{
+			delete record;
+		}
+
+		CollectUnreferenced();
+	}
+
+	AssetStatistics AssetManager::GetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		AssetStatistics statistics = m_Statistics;
+		statistics.m_NumberOfPendingLoads = 0;
+
+		for (const std::pair<const AssetGUID, AssetRecord*>& record : m_Records)
+		{
+			const AssetState state = record.second->m_State;
+
+			if (state != AssetState::Ready && state != AssetState::Failed)
+			{
+				statistics.m_NumberOfPendingLoads++;
+			}
+		}
+
+		return statistics;
+	}
+
+	AssetMemoryReport AssetManager::GetMemoryReport()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		AssetMemoryReport report;
+
+		for (const std::pair<const AssetGUID, AssetRecord*>& record : m_Records)
+		{
+			const AssetRecord* asset = record.second;
+			AssetTypeReport& typeReport = report.m_Types[size_t(asset->m_Type)];
+
+			typeReport.m_NumberOfAssets++;
+			typeReport.m_NumberOfReferences += asset->m_References;
+
+			if (asset->m_State != AssetState::Ready)
+			{
+				continue;
+			}
+
+			typeReport.m_NumberOfReadyAssets++;
+
+			switch (asset->m_Type)
+			{
+			case AssetType::Mesh:
+				typeReport.m_MemoryBytes += static_cast<const Mesh*>(asset->m_Asset.get())->GetMemorySize();
+				break;
+			case AssetType::Texture:
+				typeReport.m_MemoryBytes += static_cast<const Texture*>(asset->m_Asset.get())->GetMemorySize();
+				break;
+			case AssetType::Shader:
+			case AssetType::Material:
+			case AssetType::Count:
+				break;
+			}
+		}
+
+		return report;
+	}
+
+	void AssetManager::LogMemoryReport()
+	{
+		const AssetMemoryReport report = GetMemoryReport();
+
+		for (uint32_t type = 0; type < uint32_t(AssetType::Count); type++)
+		{
+			const AssetTypeReport& typeReport = report.m_Types[type];
+
+			KR_CORE_INFO("Assets of type {0}: {1} ({2} loaded), {3} references, {4} KB", GetTypeName(AssetType(type)), typeReport.m_NumberOfAssets,
+				typeReport.m_NumberOfReadyAssets, typeReport.m_NumberOfReferences, typeReport.m_MemoryBytes >> 10);
+		}
+	}
+
+	const char* AssetManager::GetTypeName(AssetType type)
+	{
+		switch (type)
+		{
+		case AssetType::Mesh:
+			return "mesh";
+		case AssetType::Texture:
+			return "texture";
+		case AssetType::Shader:
+			return "shader";
+		case AssetType::Material:
+			return "material";
+		case AssetType::Count:
+			break;
+		}
+
+		return "unknown";
+	}
+}
@@ -0,0 +1,675 @@
+/**
+ * @file AssetManager.h
+ * @brief This file contains the AssetManager class, the registry the meshes, textures, shaders and materials are loaded through, once each.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <queue>
+#include <chrono>
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declarations
+	 */
+	class Mesh;
+	class Texture;
+	class Shader;
+	class Material;
+	class UniformBufferObject;
+	class JobPool;
+	class FileWatcher;
+	class AssetManager;
+	struct AssetRecord;
+
+	/**
+	 * @brief Identity of an asset, the hash of its type and key (AssetManager::GetMeshGUID and company), so the same for the same file
+	 * from one run to the next
+	 *
+	 * @since Karma 1.0.0
+	 */
+	typedef uint64_t AssetGUID;
+
+	/**
+	 * @brief The types of assets the AssetManager loads
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class AssetType : uint32_t
+	{
+		Mesh = 0,
+		Texture,
+		Shader,
+		Material,
+		Count
+	};
+
+	/**
+	 * @brief Where the load of an asset is
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class AssetState : uint32_t
+	{
+		/** Waiting for a loading thread */
+		Queued = 0,
+		/** The CPU side (cooking, decoding) being done on a loading thread */
+		Preparing,
+		/** Waiting for AssetManager::Update to make the GPU objects */
+		Prepared,
+		/** Loaded */
+		Ready,
+		/** The file is missing or couldn't be loaded, or a dependency failed */
+		Failed
+	};
+
+	/**
+	 * @brief Order of the loads, the higher first and the requests of a priority in the order they came
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class AssetPriority : uint32_t
+	{
+		Low = 0,
+		Normal,
+		High,
+		/** Loaded on the calling thread (which must be the render thread) before the request returns */
+		Immediate
+	};
+
+	/**
+	 * @brief The AssetType of an asset class
+	 *
+	 * @since Karma 1.0.0
+	 */
+	template<typename T>
+	struct AssetTypeOf;
+
+	template<>
+	struct AssetTypeOf<Mesh> { static constexpr AssetType s_Type = AssetType::Mesh; };
+
+	template<>
+	struct AssetTypeOf<Texture> { static constexpr AssetType s_Type = AssetType::Texture; };
+
+	template<>
+	struct AssetTypeOf<Shader> { static constexpr AssetType s_Type = AssetType::Shader; };
+
+	template<>
+	struct AssetTypeOf<Material> { static constexpr AssetType s_Type = AssetType::Material; };
+
+	/**
+	 * @brief A counted reference to an asset of the AssetManager, of any type. The asset stays loaded as long as a handle to it exists
+	 * (or its shared_ptr, AssetHandle::GetShared, is held elsewhere), and is unloaded by AssetManager::Update after that.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API AssetHandleBase
+	{
+	public:
+		/**
+		 * @brief A handle to nothing
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetHandleBase();
+
+		AssetHandleBase(const AssetHandleBase& other);
+		AssetHandleBase(AssetHandleBase&& other) noexcept;
+		AssetHandleBase& operator=(const AssetHandleBase& other);
+		AssetHandleBase& operator=(AssetHandleBase&& other) noexcept;
+
+		~AssetHandleBase();
+
+		/**
+		 * @brief Drops the reference, the handle is to nothing after
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Reset();
+
+		bool IsSet() const { return m_Record != nullptr; }
+		bool IsReady() const { return GetState() == AssetState::Ready; }
+		bool IsFailed() const { return GetState() == AssetState::Failed; }
+
+		/**
+		 * @brief Where the load is, Failed for a handle to nothing
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetState GetState() const;
+
+		AssetGUID GetGUID() const;
+		AssetType GetType() const;
+
+		/**
+		 * @brief The (first) file of the asset, normalized (AssetManager::NormalizePath), or the name of a material
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::string& GetPath() const;
+
+		/**
+		 * @brief Finishes the load on the calling thread, which must be the render thread, the CPU side too if no loading thread has
+		 * begun it
+		 *
+		 * @return true if the asset is loaded
+		 * @since Karma 1.0.0
+		 */
+		bool Wait() const;
+
+		bool operator==(const AssetHandleBase& other) const { return m_Record == other.m_Record; }
+		bool operator!=(const AssetHandleBase& other) const { return m_Record != other.m_Record; }
+
+	protected:
+		/**
+		 * @brief Adopts the reference to the record the AssetManager took (under its lock, so that Update can't unload it meanwhile)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		explicit AssetHandleBase(AssetRecord* record);
+
+		/**
+		 * @brief The asset, or nullptr till it is Ready
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::shared_ptr<void>& GetAsset() const;
+
+	protected:
+		AssetRecord* m_Record;
+
+		friend class AssetManager;
+	};
+
+	/**
+	 * @brief A counted reference to an asset of type T (Mesh, Texture, Shader or Material)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	template<typename T>
+	class AssetHandle : public AssetHandleBase
+	{
+	public:
+		AssetHandle() {}
+
+		/**
+		 * @brief The asset, nullptr till it is Ready
+		 *
+		 * @since Karma 1.0.0
+		 */
+		T* Get() const { return static_cast<T*>(GetAsset().get()); }
+
+		/**
+		 * @brief The asset for the APIs taking a shared_ptr (VertexArray::SetMesh, Material::AddTexture and all that). Holding it keeps
+		 * the asset loaded past the last handle.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<T> GetShared() const { return std::static_pointer_cast<T>(GetAsset()); }
+
+		T* operator->() const { return Get(); }
+
+	private:
+		explicit AssetHandle(AssetRecord* record) : AssetHandleBase(record) {}
+
+		friend class AssetManager;
+	};
+
+	/**
+	 * @brief An asset in the registry
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AssetRecord
+	{
+		AssetManager* m_Manager = nullptr;
+		AssetGUID m_GUID = 0;
+		AssetType m_Type = AssetType::Mesh;
+
+		// What the GUID is the hash of, to tell a collision
+		std::string m_Key;
+		std::string m_Path;
+
+		// What the asset is made from, watched for the hot reload (none for a material)
+		std::vector<std::string> m_Files;
+
+		std::atomic<uint32_t> m_References{ 0 };
+		std::atomic<AssetState> m_State{ AssetState::Queued };
+		AssetPriority m_Priority = AssetPriority::Low;
+
+		// Of the latest queuing, older entries of the queue are stale
+		uint64_t m_Sequence = 0;
+
+		// Set before m_State goes Ready, and reset only once no handle is left
+		std::shared_ptr<void> m_Asset;
+
+		// The CPU side, on a loading thread, and the GPU side, on the render thread
+		std::function<bool()> m_Prepare;
+		std::function<std::shared_ptr<void>()> m_Create;
+
+		// Assets which must be Ready before this one is made (the shader and textures of a material)
+		std::vector<AssetHandleBase> m_Dependencies;
+
+		std::chrono::high_resolution_clock::time_point m_RequestTime;
+
+		// A reload queued, being prepared or waiting for Update to swap it in. The record is kept till then.
+		bool m_bReloadPending = false;
+		uint64_t m_ReloadSequence = 0;
+		std::chrono::high_resolution_clock::time_point m_ReloadRequestTime;
+	};
+
+	/**
+	 * @brief Settings of the AssetManager
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AssetLoadSettings
+	{
+		/**
+		 * @brief Assets the loading thread prepares at a time, in parallel on JobPool::GetLoadingPool
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_PrepareBatchSize = 4;
+
+		/**
+		 * @brief Assets AssetManager::Update makes at most in a frame, so that a burst of loads doesn't stall one. The Immediate ones
+		 * don't count.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_MaxCreatesPerFrame = 8;
+	};
+
+	/**
+	 * @brief Counters of the AssetManager since it was made
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AssetStatistics
+	{
+		uint64_t m_NumberOfRequests = 0;
+
+		/**
+		 * @brief The requests answered with an asset already in the registry, loaded or being loaded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfCoalescedRequests = 0;
+
+		uint64_t m_NumberOfLoads = 0;
+		uint64_t m_NumberOfFailures = 0;
+		uint64_t m_NumberOfUnloads = 0;
+
+		/**
+		 * @brief Assets not yet Ready nor Failed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfPendingLoads = 0;
+
+		/**
+		 * @brief Sum, over the loads, of the time from the request to Ready
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_LoadMilliseconds = 0.0;
+
+		/**
+		 * @brief Loaded assets whose contents were swapped for the ones of their changed files
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfReloads = 0;
+
+		/**
+		 * @brief Reloads which didn't load (a shader that doesn't compile, say), the loaded asset kept
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfFailedReloads = 0;
+
+		/**
+		 * @brief Sum, over the reloads, of the time from the change being told to the contents swapped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_ReloadMilliseconds = 0.0;
+	};
+
+	/**
+	 * @brief The assets of a type in the registry
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AssetTypeReport
+	{
+		uint32_t m_NumberOfAssets = 0;
+		uint32_t m_NumberOfReadyAssets = 0;
+
+		/**
+		 * @brief Handles to the assets, the ones the materials hold to their shader and textures included
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfReferences = 0;
+
+		/**
+		 * @brief What the Ready ones take on the GPU (Mesh::GetMemorySize, Texture::GetMemorySize). Shaders and materials count 0.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_MemoryBytes = 0;
+	};
+
+	/**
+	 * @brief The assets in the registry, by type
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API AssetMemoryReport
+	{
+		std::array<AssetTypeReport, size_t(AssetType::Count)> m_Types;
+
+		const AssetTypeReport& Get(AssetType type) const { return m_Types[size_t(type)]; }
+	};
+
+	/**
+	 * @brief Registry of the assets, keyed by GUID (the hash of the normalized path and what else makes an asset differ), so that a file
+	 * requested twice is loaded once and both get handles to the same asset. A request for an asset being loaded joins that load.
+	 *
+	 * The loads are in two halves. The CPU side (Mesh::Prepare, Texture::Prepare, cooking the files if need be) runs on a loading thread,
+	 * the most urgent requests first (AssetPriority), a batch at a time on JobPool::GetLoadingPool. The GPU side (the constructors, mapping
+	 * the cooked files and making the buffers, textures and shaders) runs on the render thread in Update, a few a frame. An asset
+	 * with no handle left is unloaded by the Update after, on the render thread too.
+	 *
+	 * With the hot reload on (SetHotReloadEnabled), the files of the loaded assets are watched. A changed file is prepared again on the
+	 * loading thread (cooked again, or compiled, the caches sparing what hasn't changed), and Update swaps the new contents into the loaded
+	 * asset, so that the handles, materials and vertex arrays holding it keep the same object. The vertex arrays pick the contents up at
+	 * the frame boundary (VertexArray::RefreshReloadedAssets).
+	 *
+	 * @see Renderer::BeginScene
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API AssetManager
+	{
+	public:
+		AssetManager();
+		~AssetManager();
+
+		AssetManager(const AssetManager&) = delete;
+		AssetManager& operator=(const AssetManager&) = delete;
+
+		/**
+		 * @brief The manager of the engine's assets
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static AssetManager& Get();
+
+		/**
+		 * @brief Requests the model file (Mesh::Mesh)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetHandle<Mesh> LoadMesh(const std::string& filePath, AssetPriority priority = AssetPriority::Normal);
+
+		/**
+		 * @brief Requests the image file (Texture::Texture, of TextureType::Image). The same file sampled by another name in the shaders
+		 * is another asset.
+		 *
+		 * @param textureName					Name of the texture, from the first request
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetHandle<Texture> LoadTexture(const std::string& filePath, const std::string& textureName, const std::string& textureShaderName = "texSampler",
+			AssetPriority priority = AssetPriority::Normal);
+
+		/**
+		 * @brief Requests the shader of the files (Shader::Create). The uniform buffer is the first request's.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetHandle<Shader> LoadShader(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, std::shared_ptr<UniformBufferObject> ubo,
+			const std::string& shaderName, AssetPriority priority = AssetPriority::Normal);
+
+		/**
+		 * @brief Requests a material of the shader and textures, made once they are loaded and keeping them loaded. Materials carry the
+		 * camera and transform of what they are drawn on, so each distinct use wants a name of its own.
+		 *
+		 * @param materialName					Key of the material
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetHandle<Material> LoadMaterial(const std::string& materialName, const AssetHandle<Shader>& shader, const std::vector<AssetHandle<Texture>>& textures,
+			AssetPriority priority = AssetPriority::Normal);
+
+		/**
+		 * @brief A handle to the asset of the GUID if it is in the registry, loaded or not
+		 *
+		 * @return A handle to nothing if it isn't, or is of another type
+		 * @since Karma 1.0.0
+		 */
+		template<typename T>
+		AssetHandle<T> Find(AssetGUID guid)
+		{
+			return AssetHandle<T>(FindRecord(AssetTypeOf<T>::s_Type, guid));
+		}
+
+		static AssetGUID GetMeshGUID(const std::string& filePath);
+		static AssetGUID GetTextureGUID(const std::string& filePath, const std::string& textureShaderName = "texSampler");
+		static AssetGUID GetShaderGUID(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, const std::string& shaderName);
+		static AssetGUID GetMaterialGUID(const std::string& materialName);
+
+		/**
+		 * @brief The path lexically normalized with forward slashes, so that ../Resources/Models/../Models/a.obj and
+		 * ../Resources/Models/a.obj are the same asset
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::string NormalizePath(const std::string& path);
+
+		/**
+		 * @brief Once a frame on the render thread: makes the prepared assets, the most urgent first and up to
+		 * AssetLoadSettings::m_MaxCreatesPerFrame of them, and unloads the assets nothing refers to anymore. The reloads are swapped in
+		 * apart, by ApplyReloads.
+		 *
+		 * @see Renderer::BeginScene
+		 * @since Karma 1.0.0
+		 */
+		void Update();
+
+		/**
+		 * @brief Makes the prepared reloads and swaps their contents into the loaded assets. The loaded assets may be drawn with, so
+		 * this is called on the game thread with the render thread done (RenderThread::WaitForRenderThread), and the scenes are
+		 * refreshed (Scene::RefreshReloadedAssets) before the next draws.
+		 *
+		 * @see Renderer::BeginScene
+		 * @since Karma 1.0.0
+		 */
+		void ApplyReloads();
+
+		/**
+		 * @brief Whether any reload waits for ApplyReloads
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool HasPreparedReloads();
+
+		/**
+		 * @brief Blocks till every request is Ready or Failed, making the assets on the calling thread. Called from another thread than the
+		 * render thread, the render thread is waited for first.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void WaitForLoads();
+
+		/**
+		 * @brief Drops the registry's references to every asset, the GPU objects going now unless held elsewhere. The handles left
+		 * point to Failed assets.
+		 *
+		 * @see Renderer::DeleteData
+		 * @since Karma 1.0.0
+		 */
+		void ReleaseResources();
+
+		/**
+		 * @brief Watches the files of the meshes, textures and shaders (FileWatcher), loaded and to be, and reloads the assets of the
+		 * files changed. The files a shader includes aren't watched, only the ones it was requested with.
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		void SetHotReloadEnabled(bool bEnabled);
+
+		bool IsHotReloadEnabled();
+
+		/**
+		 * @brief Queues the reload of the loaded assets made from the files, at AssetPriority::High, as the FileWatcher does for the
+		 * changed ones. The Failed ones are loaded again. Materials aren't made again, their shader and textures are reloaded in place.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ReloadFiles(const std::vector<std::string>& filePaths);
+
+		/**
+		 * @brief Number of reloads swapped in so far, for the scenes to tell that their vertex arrays may need refreshing
+		 *
+		 * @see Scene::RefreshReloadedAssets
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetReloadGeneration() const { return m_ReloadGeneration; }
+
+		/**
+		 * @brief Number of files watched for the hot reload
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfWatchedFiles();
+
+		AssetLoadSettings& GetSettings() { return m_Settings; }
+		AssetStatistics GetStatistics();
+
+		/**
+		 * @brief Counts and memory of the assets by type
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetMemoryReport GetMemoryReport();
+
+		/**
+		 * @brief Logs GetMemoryReport, a line per type
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void LogMemoryReport();
+
+		static const char* GetTypeName(AssetType type);
+
+	private:
+		struct QueuedLoad
+		{
+			AssetPriority m_Priority;
+			uint64_t m_Sequence;
+			AssetGUID m_GUID;
+
+			// Of a loaded asset, its contents to be swapped rather than made
+			bool m_bReload;
+
+			// The higher priority first, then the older request
+			bool operator<(const QueuedLoad& other) const
+			{
+				return m_Priority != other.m_Priority ? m_Priority < other.m_Priority : m_Sequence > other.m_Sequence;
+			}
+		};
+
+		/**
+		 * @brief Finds the record of the key or adds it, queuing its load, and takes a reference to it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		AssetRecord* Request(AssetType type, const std::string& key, const std::string& path, const std::vector<std::string>& files, AssetPriority priority,
+			std::function<bool()> prepare, std::function<std::shared_ptr<void>()> create,
+			const std::vector<AssetHandleBase>& dependencies = std::vector<AssetHandleBase>());
+
+		AssetRecord* FindRecord(AssetType type, AssetGUID guid);
+
+		/**
+		 * @brief Finishes the load of the record on the calling thread (AssetHandleBase::Wait)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool Wait(AssetRecord* record);
+
+		/**
+		 * @brief Makes the prepared asset, the lock not held
+		 *
+		 * @return false if a dependency is still loading, the record staying Prepared
+		 * @since Karma 1.0.0
+		 */
+		bool Create(AssetRecord* record);
+
+		/**
+		 * @brief Deletes the records with no handle whose asset isn't held elsewhere either
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CollectUnreferenced();
+
+		void Enqueue(AssetRecord* record);
+		void EnqueueReload(AssetRecord* record);
+		void PrepareLoop();
+
+		/**
+		 * @brief Mesh::SwapContents, Texture::SwapContents or Shader::SwapContents of the asset with the reloaded one
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SwapContents(AssetType type, void* asset, void* reloaded);
+
+		/**
+		 * @brief Stops watching the files of the record, being deleted. The lock is held.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void UnwatchFiles(const AssetRecord* record);
+
+		static AssetGUID MakeGUID(AssetType type, const std::string& key);
+
+		friend class AssetHandleBase;
+
+	private:
+		AssetLoadSettings m_Settings;
+		AssetStatistics m_Statistics;
+
+		std::unordered_map<AssetGUID, AssetRecord*> m_Records;
+
+		// Waiting for Update, in the order they were prepared
+		std::vector<AssetRecord*> m_Prepared;
+		std::vector<AssetRecord*> m_PreparedReloads;
+
+		// Set while the hot reload is on
+		FileWatcher* m_Watcher;
+		std::atomic<uint64_t> m_ReloadGeneration;
+
+		std::mutex m_Mutex;
+
+		std::thread m_PrepareThread;
+		std::condition_variable m_PrepareCondition;
+		std::condition_variable m_PreparedCondition;
+		std::priority_queue<QueuedLoad> m_Queue;
+		uint64_t m_NextSequence;
+		uint32_t m_NumberOfRunningPrepares;
+		bool m_bQuit;
+		JobPool* m_Pool;
+	};
+}
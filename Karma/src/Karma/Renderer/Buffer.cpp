@@ -3,6 +3,7 @@
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLBuffer.h"
 #include "Platform/Vulkan/VulkanBuffer.h"
+#include "Platform/Null/NullBuffer.h"
 
 namespace Karma
 {
@@ -17,6 +18,8 @@ namespace Karma
 				return new OpenGLVertexBuffer(vertices, size);
 			case RendererAPI::API::Vulkan:
 				return new VulkanVertexBuffer(vertices, size);
+			case RendererAPI::API::Null:
+				return new NullVertexBuffer(vertices, size);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
@@ -34,6 +37,27 @@ namespace Karma
 				return new OpenGLIndexBuffer(indices, size);
 			case RendererAPI::API::Vulkan:
 				return new VulkanIndexBuffer(indices, size);
+			case RendererAPI::API::Null:
+				return new NullIndexBuffer(indices, size);
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
+		return nullptr;
+	}
+
+	IndexBuffer* IndexBuffer::Create(uint16_t* indices, uint32_t count)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return new OpenGLIndexBuffer(indices, count);
+			case RendererAPI::API::Vulkan:
+				return new VulkanIndexBuffer(indices, count);
+			case RendererAPI::API::Null:
+				return new NullIndexBuffer(indices, count);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
@@ -52,6 +76,8 @@ namespace Karma
 				return nullptr;
 			case RendererAPI::API::Vulkan:
 				return(static_cast<ImageBuffer*>(new VulkanImageBuffer(filename)));
+			case RendererAPI::API::Null:
+				return new NullImageBuffer(filename);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
@@ -69,6 +95,8 @@ namespace Karma
 				return new OpenGLUniformBuffer(dataTypes, bindingPointIndex);
 			case RendererAPI::API::Vulkan:
 				return new VulkanUniformBuffer(dataTypes, bindingPointIndex);
+			case RendererAPI::API::Null:
+				return new NullUniformBuffer(dataTypes, bindingPointIndex);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
@@ -76,7 +104,7 @@ namespace Karma
 	}
 
 	UniformBufferObject::UniformBufferObject(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex) :
-		m_UniformDataType(dataTypes), m_BindingPoint(bindingPointIndex)
+		m_UniformDataType(dataTypes), m_BindingPoint(bindingPointIndex), m_RingOffset(0)
 	{
 		CalculateOffsetsAndBufferSize();
 	}
@@ -149,6 +177,13 @@ namespace Karma
 				return sizeof(glm::ivec4);
 			case Karma::ShaderDataType::Bool:
 				return sizeof(bool);
+			case Karma::ShaderDataType::Half2:
+			case Karma::ShaderDataType::Half4:
+			case Karma::ShaderDataType::Short2Norm:
+			case Karma::ShaderDataType::Byte4Norm:
+			case Karma::ShaderDataType::UByte4Norm:
+				KR_CORE_ASSERT(false, "Packed ShaderDataTypes are for vertex data, not uniforms");
+				return 0;
 		}
 		KR_CORE_ASSERT(false, "Unknown ShaderDataType");
 		return 0;
@@ -32,7 +32,17 @@ namespace Karma
 		Int2,
 		Int3,
 		Int4,
-		Bool
+		Bool,
+		/** Two 16 bit floats, read as vec2 (quantized UVs) */
+		Half2,
+		/** Four 16 bit floats, read as vec4 */
+		Half4,
+		/** Two 16 bit signed normalized integers, read as vec2 in [-1, 1] (octahedral normals and tangents) */
+		Short2Norm,
+		/** Four 8 bit signed normalized integers, read as vec4 (or vec3) in [-1, 1] (quantized normals and tangents) */
+		Byte4Norm,
+		/** Four 8 bit unsigned normalized integers, read as vec4 in [0, 1] (quantized colors) */
+		UByte4Norm
 	};
 
 	/**
@@ -70,6 +80,16 @@ namespace Karma
 				return 4 * 4;
 			case ShaderDataType::Bool:
 				return 4;
+			case ShaderDataType::Half2:
+				return 2 * 2;
+			case ShaderDataType::Half4:
+				return 2 * 4;
+			case ShaderDataType::Short2Norm:
+				return 2 * 2;
+			case ShaderDataType::Byte4Norm:
+				return 4;
+			case ShaderDataType::UByte4Norm:
+				return 4;
 			case ShaderDataType::None:
 				KR_CORE_WARN("ShaderDataType is none. Size shall be considered 0.");
 				return 0;
@@ -167,6 +187,16 @@ namespace Karma
 					return 4;
 				case Karma::ShaderDataType::Bool:
 					return 1;
+				case Karma::ShaderDataType::Half2:
+					return 2;
+				case Karma::ShaderDataType::Half4:
+					return 4;
+				case Karma::ShaderDataType::Short2Norm:
+					return 2;
+				case Karma::ShaderDataType::Byte4Norm:
+					return 4;
+				case Karma::ShaderDataType::UByte4Norm:
+					return 4;
 			}
 
 			KR_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -311,6 +341,17 @@ namespace Karma
 	/**
 	 * @brief An abstract class for index buffer
 	 */
+	/**
+	 * @brief Width of the indices of an IndexBuffer
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class IndexType
+	{
+		UInt16 = 0,
+		UInt32
+	};
+
 	class KARMA_API IndexBuffer
 	{
 	public:
@@ -321,7 +362,25 @@ namespace Karma
 
 		virtual uint32_t GetCount() const = 0;
 
+		/**
+		 * @brief Width of the indices, for the draws (glDrawElements, vkCmdBindIndexBuffer) to read them with
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual IndexType GetIndexType() const = 0;
+
 		static IndexBuffer* Create(uint32_t* vertices, uint32_t size);
+
+		/**
+		 * @brief Creates a buffer of 16 bit indices, half the memory and bandwidth of 32 bit ones, for meshes of at most 65536 vertices
+		 *
+		 * @param indices						The indices
+		 * @param count							Number of indices
+		 *
+		 * @see MeshOptimizer
+		 * @since Karma 1.0.0
+		 */
+		static IndexBuffer* Create(uint16_t* indices, uint32_t count);
 	};
 
 	/**
@@ -415,16 +474,38 @@ namespace Karma
 		}
 
 		/**
-		 * @brief An overridable function to upload the uniform buffer
+		 * @brief Sets the m_UniformList with a list made at run time, for uniform buffer objects with arrays (the bone matrices of
+		 * skinned.vert, say)
 		 *
-		 * @note The function is pure virtual with default value provided.
-		 * @todo Need to rewrite implementation of this virtual function because Material::ProcessForSubmission() makes agnostic call and VulkanContext::UploadUBO
-		 * also makes call to upload uniform which is seperate from Material::ProcessForSubmission.
+		 * @see Material::SetBoneMatrices
+		 * @since Karma 1.0.0
+		 */
+		void SetUniformList(const std::vector<UBODataPointer>& uniforms)
+		{
+			m_UniformList = uniforms;
+		}
+
+		/**
+		 * @brief An overridable function to upload the uniform buffer. The uniforms are written into the renderer's UniformBufferRing
+		 * and the offset of the written block is cached (see GetRingOffset()) for the draw to use.
+		 *
+		 * @note The function is pure virtual with default value provided. The frameIndex is kept for compatibility, the ring keeps track of the frames itself.
+		 * @see Material::ProcessForSubmission
 		 *
 		 * @since Karma 1.0.0
 		 */
 		virtual void UploadUniformBuffer(size_t frameIndex = 0) = 0;
 
+		/**
+		 * @brief Offset (in bytes) of the block, written by the latest UploadUniformBuffer call, in the UniformBufferRing
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetRingOffset() const
+		{
+			return m_RingOffset;
+		}
+
 		uint32_t GetBufferSize() const
 		{
 			return m_BufferSize;
@@ -509,6 +590,13 @@ namespace Karma
 		 */
 		std::vector<uint32_t> m_UniformSizes;
 
+		/**
+		 * @brief Offset of the latest uploaded block in the UniformBufferRing
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_RingOffset;
+
 	private:
 		/**
 		 * @brief Computing size of pre defined \ref ShaderDataType
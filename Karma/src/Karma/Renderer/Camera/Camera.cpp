@@ -13,6 +13,11 @@ namespace Karma
 	{
 	}
 
+	Frustum Camera::GetFrustum() const
+	{
+		return Frustum::FromViewProjection(m_ProjectionMatrix * m_ViewMatrix);
+	}
+
 	void Camera::SetPosition(const glm::vec3& position)
 	{
 		m_Position = position;
@@ -12,6 +12,7 @@
 #include "krpch.h"
 
 #include "glm/glm.hpp"
+#include "Frustum.h"
 
 namespace Karma
 {
@@ -171,6 +172,13 @@ namespace Karma
 		 */
 		const glm::mat4& GetViewMatirx() const { return m_ViewMatrix; }
 
+		/**
+		 * @brief The planes of the present view volume, extracted from the projection and view matrices. Used by the FrustumCuller.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Frustum GetFrustum() const;
+
 	private:
 		void RecalculateViewMatrix();
 
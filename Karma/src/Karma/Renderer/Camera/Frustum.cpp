@@ -0,0 +1,65 @@
+#include "Frustum.h"
+
+namespace Karma
+{
+	Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection)
+	{
+		// glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+		glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+		Frustum frustum;
+
+		frustum.m_Planes[Left] = row3 + row0;
+		frustum.m_Planes[Right] = row3 - row0;
+		frustum.m_Planes[Bottom] = row3 + row1;
+		frustum.m_Planes[Top] = row3 - row1;
+		frustum.m_Planes[Near] = row3 + row2;
+		frustum.m_Planes[Far] = row3 - row2;
+
+		for (uint32_t counter = 0; counter < NumberOfPlanes; counter++)
+		{
+			float normalLength = glm::length(glm::vec3(frustum.m_Planes[counter]));
+
+			if (normalLength > 0.0f)
+			{
+				frustum.m_Planes[counter] /= normalLength;
+			}
+		}
+
+		return frustum;
+	}
+
+	bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (uint32_t counter = 0; counter < NumberOfPlanes; counter++)
+		{
+			if (glm::dot(glm::vec3(m_Planes[counter]), center) + m_Planes[counter].w < -radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Frustum::IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const
+	{
+		for (uint32_t counter = 0; counter < NumberOfPlanes; counter++)
+		{
+			glm::vec3 normal = glm::vec3(m_Planes[counter]);
+
+			// Projection of the box on the normal
+			float projectedRadius = glm::dot(glm::abs(normal), extents);
+
+			if (glm::dot(normal, center) + m_Planes[counter].w < -projectedRadius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
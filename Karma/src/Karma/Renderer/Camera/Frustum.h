@@ -0,0 +1,73 @@
+/**
+ * @file Frustum.h
+ * @brief This file contains Frustum structure, the six planes bounding the volume seen by a Camera.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "glm/glm.hpp"
+
+namespace Karma
+{
+	/**
+	 * @brief The six planes (left, right, bottom, top, near, far) of a view volume. Each plane is (n, d) with n pointing inwards, so that
+	 * dot(n, p) + d >= 0 for the points p inside.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API Frustum
+	{
+		/**
+		 * @brief Indices of the planes in m_Planes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		enum PlaneIndex : uint32_t
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			NumberOfPlanes
+		};
+
+		/**
+		 * @brief The planes as (normal.x, normal.y, normal.z, distance), normalized
+		 *
+		 * @since Karma 1.0.0
+		 */
+		glm::vec4 m_Planes[NumberOfPlanes];
+
+		/**
+		 * @brief Extracts the planes from the rows of a (projection * view) matrix (Gribb and Hartmann). Works for perspective as well as
+		 * orthographic projections, and for the flipped Y of Vulkan (top and bottom just swap).
+		 *
+		 * @param viewProjection					Projection * View
+		 *
+		 * @note The near plane assumes the OpenGL clip depth (-w, w), which glm produces by default. For a (0, w) depth range it is
+		 * conservative (a little behind the true near plane).
+		 * @since Karma 1.0.0
+		 */
+		static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+		/**
+		 * @brief Whether the sphere is (at least partially) inside
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+		/**
+		 * @brief Whether the axis aligned box is (at least partially) inside. Conservative: boxes near the corners of the frustum may pass.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const;
+	};
+}
@@ -18,6 +18,7 @@ namespace Karma
 				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 				break;
 			case RendererAPI::API::OpenGL:
+			case RendererAPI::API::Null:
 				m_ProjectionMatrix = glm::ortho(left, right, bottom, top, -1.0f, 1.0f);
 				break;
 			case RendererAPI::API::Vulkan:
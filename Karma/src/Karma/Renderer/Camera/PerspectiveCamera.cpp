@@ -17,6 +17,7 @@ namespace Karma
 				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
 				break;
 			case RendererAPI::API::OpenGL:
+			case RendererAPI::API::Null:
 				m_ProjectionMatrix = glm::perspective(glm::radians(fovRad), aspectRatio, nearPlane, farPlane);
 				break;
 			case RendererAPI::API::Vulkan:
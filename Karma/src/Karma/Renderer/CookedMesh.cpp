@@ -0,0 +1,458 @@
+#include "CookedMesh.h"
+#include "Mesh.h"
+#include "RendererAPI.h"
+#include "ModelImporter.h"
+#include "MeshOptimizer.h"
+#include "Karma/JobPool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Karma
+{
+	namespace
+	{
+		// Sections start at multiples of this, so that the vertices can be read as floats (and by SIMD) straight from the mapping
+		constexpr uint64_t s_SectionAlignment = 16;
+
+		uint64_t AlignSection(uint64_t offset)
+		{
+			return (offset + s_SectionAlignment - 1) & ~(s_SectionAlignment - 1);
+		}
+
+		// Whether every index refers to one of the vertices
+		template<typename IndexT>
+		bool AreIndicesInRange(const uint8_t* indexData, uint64_t numberOfIndices, uint32_t numberOfVertices)
+		{
+			const IndexT* indices = reinterpret_cast<const IndexT*>(indexData);
+			IndexT maximum = 0;
+
+			for (uint64_t counter = 0; counter < numberOfIndices; counter++)
+			{
+				maximum = std::max(maximum, indices[counter]);
+			}
+
+			return numberOfIndices == 0 || uint64_t(maximum) < numberOfVertices;
+		}
+	}
+
+	CookedMesh::CookedMesh() : m_Header(nullptr), m_Elements(nullptr), m_Submeshes(nullptr), m_LODs(nullptr)
+	{
+	}
+
+	bool CookedMesh::Cook(const std::string& sourcePath, const std::string& cookedPath, bool bFlipUVs)
+	{
+		ImportedModel model;
+
+		if (!ModelImporter::Import(sourcePath, bFlipUVs, model, &JobPool::GetLoadingPool()))
+		{
+			return false;
+		}
+
+		MeshOptimizationStatistics optimizationStatistics;
+		MeshOptimizer::Optimize(model, MeshOptimizer::GetDefaultSettings(), &JobPool::GetLoadingPool(), &optimizationStatistics);
+		MeshOptimizer::LogStatistics(sourcePath, optimizationStatistics);
+
+		const BufferLayout& layout = model.m_Layout;
+		const std::vector<uint8_t>& vertices = model.m_VertexData;
+
+		const bool bShortIndices = !model.m_ShortIndices.empty();
+		const size_t indexSize = bShortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		// The model's indices and then those of the levels of detail, one section
+		std::vector<uint8_t> indices(size_t(model.GetNumberOfIndices()) * indexSize);
+		memcpy(indices.data(), bShortIndices ? static_cast<const void*>(model.m_ShortIndices.data()) : model.m_Indices.data(), indices.size());
+
+		std::vector<CookedMeshLOD> lods;
+		uint32_t numberOfLODIndices = 0;
+
+		for (const ImportedLOD& modelLOD : model.m_LODs)
+		{
+			CookedMeshLOD lod;
+			lod.m_FirstIndex = model.GetNumberOfIndices() + numberOfLODIndices;
+			lod.m_NumberOfIndices = modelLOD.GetNumberOfIndices();
+			lod.m_Error = modelLOD.m_Error;
+
+			const size_t offset = indices.size();
+			indices.resize(offset + size_t(lod.m_NumberOfIndices) * indexSize);
+			memcpy(indices.data() + offset, bShortIndices ? static_cast<const void*>(modelLOD.m_ShortIndices.data()) : modelLOD.m_Indices.data(),
+				size_t(lod.m_NumberOfIndices) * indexSize);
+
+			numberOfLODIndices += lod.m_NumberOfIndices;
+			lods.push_back(lod);
+		}
+
+		std::vector<CookedSubmesh> submeshes;
+
+		for (const Submesh& modelSubmesh : model.m_Submeshes)
+		{
+			CookedSubmesh submesh;
+			submesh.m_FirstVertex = modelSubmesh.m_FirstVertex;
+			submesh.m_NumberOfVertices = modelSubmesh.m_NumberOfVertices;
+			submesh.m_FirstIndex = modelSubmesh.m_FirstIndex;
+			submesh.m_NumberOfIndices = modelSubmesh.m_NumberOfIndices;
+			submesh.m_Center[0] = modelSubmesh.m_Bounds.m_Center.x;
+			submesh.m_Center[1] = modelSubmesh.m_Bounds.m_Center.y;
+			submesh.m_Center[2] = modelSubmesh.m_Bounds.m_Center.z;
+			submesh.m_Radius = modelSubmesh.m_Bounds.m_Radius;
+			submesh.m_Extents[0] = modelSubmesh.m_Bounds.m_Extents.x;
+			submesh.m_Extents[1] = modelSubmesh.m_Bounds.m_Extents.y;
+			submesh.m_Extents[2] = modelSubmesh.m_Bounds.m_Extents.z;
+			submesh.m_MaterialIndex = modelSubmesh.m_MaterialIndex;
+
+			submeshes.push_back(submesh);
+		}
+
+		std::vector<CookedMeshElement> elements;
+		for (const BufferElement& layoutElem : layout.GetElements())
+		{
+			CookedMeshElement element;
+			element.m_Type = uint32_t(layoutElem.Type);
+			element.m_bNormalized = layoutElem.Normalized ? 1 : 0;
+
+			KR_CORE_ASSERT(layoutElem.Name.size() < sizeof(element.m_Name), "Attribute name too long for the cooked format");
+			strncpy(element.m_Name, layoutElem.Name.c_str(), sizeof(element.m_Name) - 1);
+
+			elements.push_back(element);
+		}
+
+		CookedMeshHeader header;
+		header.m_Magic = s_Magic;
+		header.m_Version = s_Version;
+		header.m_Flags = ComputeFlags(bFlipUVs) | (bShortIndices ? s_FlagShortIndices : 0);
+		header.m_NumberOfElements = uint32_t(elements.size());
+		header.m_VertexStride = layout.GetStride();
+		header.m_NumberOfVertices = model.m_NumberOfVertices;
+		header.m_NumberOfIndices = model.GetNumberOfIndices();
+		header.m_NumberOfSubmeshes = uint32_t(submeshes.size());
+		header.m_NumberOfLODs = uint32_t(lods.size());
+		header.m_NumberOfLODIndices = numberOfLODIndices;
+
+		header.m_ContentHash = HashBytes(vertices.data(), vertices.size());
+		header.m_ContentHash = HashBytes(indices.data(), indices.size(), header.m_ContentHash);
+
+		header.m_ElementsOffset = AlignSection(sizeof(CookedMeshHeader));
+		header.m_SubmeshesOffset = AlignSection(header.m_ElementsOffset + elements.size() * sizeof(CookedMeshElement));
+		header.m_VertexDataOffset = AlignSection(header.m_SubmeshesOffset + submeshes.size() * sizeof(CookedSubmesh));
+		header.m_IndexDataOffset = AlignSection(header.m_VertexDataOffset + vertices.size());
+		header.m_LODsOffset = AlignSection(header.m_IndexDataOffset + indices.size());
+
+		// Written aside and renamed, so that a reader never maps a half written file
+		std::string temporaryPath = cookedPath + ".tmp";
+
+		{
+			std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+
+			if (!out)
+			{
+				KR_CORE_WARN("CookedMesh: couldn't write {0}", temporaryPath);
+				return false;
+			}
+
+			auto writeSection = [&out](uint64_t offset, const void* data, size_t size)
+			{
+				static const char padding[s_SectionAlignment] = {};
+
+				uint64_t position = uint64_t(out.tellp());
+				out.write(padding, std::streamsize(offset - position));
+				out.write(static_cast<const char*>(data), std::streamsize(size));
+			};
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			writeSection(header.m_ElementsOffset, elements.data(), elements.size() * sizeof(CookedMeshElement));
+			writeSection(header.m_SubmeshesOffset, submeshes.data(), submeshes.size() * sizeof(CookedSubmesh));
+			writeSection(header.m_VertexDataOffset, vertices.data(), vertices.size());
+			writeSection(header.m_IndexDataOffset, indices.data(), indices.size());
+			writeSection(header.m_LODsOffset, lods.data(), lods.size() * sizeof(CookedMeshLOD));
+
+			if (!out)
+			{
+				KR_CORE_WARN("CookedMesh: couldn't write {0}", temporaryPath);
+				return false;
+			}
+		}
+
+		std::error_code errorCode;
+		std::filesystem::rename(temporaryPath, cookedPath, errorCode);
+
+		if (errorCode)
+		{
+			KR_CORE_WARN("CookedMesh: couldn't move {0} to {1} ({2})", temporaryPath, cookedPath, errorCode.message());
+			std::filesystem::remove(temporaryPath, errorCode);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CookedMesh::Load(const std::string& cookedPath, bool bFlipUVs)
+	{
+		m_Header = nullptr;
+		m_Elements = nullptr;
+		m_Submeshes = nullptr;
+		m_LODs = nullptr;
+
+		if (!m_File.Open(cookedPath))
+		{
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+		const uint64_t fileSize = m_File.GetSize();
+
+		auto refuse = [this]()
+		{
+			m_File.Close();
+			return false;
+		};
+
+		if (fileSize < sizeof(CookedMeshHeader))
+		{
+			return refuse();
+		}
+
+		const CookedMeshHeader* header = reinterpret_cast<const CookedMeshHeader*>(data);
+
+		if (header->m_Magic != s_Magic || header->m_Version != s_Version)
+		{
+			return refuse();
+		}
+
+		// Cooked with the flipping and the optimization settings of now
+		if ((header->m_Flags & ~s_FlagShortIndices) != ComputeFlags(bFlipUVs))
+		{
+			return refuse();
+		}
+
+		const uint64_t indexSize = (header->m_Flags & s_FlagShortIndices) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		// Sections within the file, the sizes in 64 bits so that nothing overflows
+		if (header->m_NumberOfSubmeshes == 0 || header->m_VertexStride == 0 ||
+			header->m_ElementsOffset + uint64_t(header->m_NumberOfElements) * sizeof(CookedMeshElement) > fileSize ||
+			header->m_SubmeshesOffset + uint64_t(header->m_NumberOfSubmeshes) * sizeof(CookedSubmesh) > fileSize ||
+			header->m_VertexDataOffset + uint64_t(header->m_NumberOfVertices) * header->m_VertexStride > fileSize ||
+			header->m_IndexDataOffset + (uint64_t(header->m_NumberOfIndices) + header->m_NumberOfLODIndices) * indexSize > fileSize ||
+			header->m_LODsOffset + uint64_t(header->m_NumberOfLODs) * sizeof(CookedMeshLOD) > fileSize)
+		{
+			KR_CORE_WARN("CookedMesh: {0} is truncated", cookedPath);
+			return refuse();
+		}
+
+		const CookedSubmesh* submeshes = reinterpret_cast<const CookedSubmesh*>(data + header->m_SubmeshesOffset);
+
+		for (uint32_t counter = 0; counter < header->m_NumberOfSubmeshes; counter++)
+		{
+			if (uint64_t(submeshes[counter].m_FirstVertex) + submeshes[counter].m_NumberOfVertices > header->m_NumberOfVertices ||
+				uint64_t(submeshes[counter].m_FirstIndex) + submeshes[counter].m_NumberOfIndices > header->m_NumberOfIndices)
+			{
+				KR_CORE_WARN("CookedMesh: {0} has a submesh out of its data", cookedPath);
+				return refuse();
+			}
+		}
+
+		const CookedMeshLOD* lods = reinterpret_cast<const CookedMeshLOD*>(data + header->m_LODsOffset);
+
+		for (uint32_t counter = 0; counter < header->m_NumberOfLODs; counter++)
+		{
+			if (lods[counter].m_FirstIndex < header->m_NumberOfIndices ||
+				uint64_t(lods[counter].m_FirstIndex) + lods[counter].m_NumberOfIndices > uint64_t(header->m_NumberOfIndices) + header->m_NumberOfLODIndices)
+			{
+				KR_CORE_WARN("CookedMesh: {0} has a level of detail out of its indices", cookedPath);
+				return refuse();
+			}
+		}
+
+		// A corrupted index reads past the vertex buffer on the GPU. One pass over the indices, much cheaper than the content hash (Validate).
+		const uint8_t* indexData = data + header->m_IndexDataOffset;
+		const uint64_t numberOfIndices = uint64_t(header->m_NumberOfIndices) + header->m_NumberOfLODIndices;
+
+		const bool bIndicesInRange = indexSize == sizeof(uint16_t) ? AreIndicesInRange<uint16_t>(indexData, numberOfIndices, header->m_NumberOfVertices) :
+			AreIndicesInRange<uint32_t>(indexData, numberOfIndices, header->m_NumberOfVertices);
+
+		if (!bIndicesInRange)
+		{
+			KR_CORE_WARN("CookedMesh: {0} has indices out of its vertices", cookedPath);
+			return refuse();
+		}
+
+		m_Header = header;
+		m_Elements = reinterpret_cast<const CookedMeshElement*>(data + header->m_ElementsOffset);
+		m_Submeshes = submeshes;
+		m_LODs = lods;
+
+		if (GetLayout().GetStride() != header->m_VertexStride)
+		{
+			m_Header = nullptr;
+			return refuse();
+		}
+
+		return true;
+	}
+
+	bool CookedMesh::IsUpToDate(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		std::error_code errorCode;
+
+		std::filesystem::file_time_type cookedTime = std::filesystem::last_write_time(cookedPath, errorCode);
+		if (errorCode)
+		{
+			return false;
+		}
+
+		std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, errorCode);
+		if (errorCode)
+		{
+			// No source to compare with (shipped without it), the cooked file is all there is
+			return true;
+		}
+
+		return cookedTime >= sourceTime;
+	}
+
+	bool CookedMesh::Validate() const
+	{
+		if (!m_Header)
+		{
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+
+		uint64_t hash = HashBytes(data + m_Header->m_VertexDataOffset, size_t(m_Header->m_NumberOfVertices) * m_Header->m_VertexStride);
+		hash = HashBytes(data + m_Header->m_IndexDataOffset, (size_t(m_Header->m_NumberOfIndices) + m_Header->m_NumberOfLODIndices) * GetIndexSize(),
+			hash);
+
+		return hash == m_Header->m_ContentHash;
+	}
+
+	BufferLayout CookedMesh::GetLayout() const
+	{
+		BufferLayout layout;
+
+		for (uint32_t counter = 0; m_Header && counter < m_Header->m_NumberOfElements; counter++)
+		{
+			const CookedMeshElement& element = m_Elements[counter];
+
+			std::string name(element.m_Name, strnlen(element.m_Name, sizeof(element.m_Name)));
+			layout.PushElement({ ShaderDataType(element.m_Type), name, element.m_bNormalized != 0 });
+		}
+
+		return layout;
+	}
+
+	const CookedSubmesh& CookedMesh::GetSubmesh(uint32_t submeshIndex) const
+	{
+		KR_CORE_ASSERT(m_Header && submeshIndex < m_Header->m_NumberOfSubmeshes, "Submesh index out of the cooked mesh");
+
+		return m_Submeshes[submeshIndex];
+	}
+
+	float* CookedMesh::GetVertexData(uint32_t submeshIndex) const
+	{
+		const CookedSubmesh& submesh = GetSubmesh(submeshIndex);
+
+		return reinterpret_cast<float*>(m_File.GetData() + m_Header->m_VertexDataOffset + uint64_t(submesh.m_FirstVertex) * m_Header->m_VertexStride);
+	}
+
+	uint32_t CookedMesh::GetVertexDataSize(uint32_t submeshIndex) const
+	{
+		return GetSubmesh(submeshIndex).m_NumberOfVertices * m_Header->m_VertexStride;
+	}
+
+	uint8_t* CookedMesh::GetIndexData(uint32_t submeshIndex) const
+	{
+		const CookedSubmesh& submesh = GetSubmesh(submeshIndex);
+
+		return m_File.GetData() + m_Header->m_IndexDataOffset + uint64_t(submesh.m_FirstIndex) * GetIndexSize();
+	}
+
+	RenderBounds CookedMesh::GetBounds(uint32_t submeshIndex) const
+	{
+		const CookedSubmesh& submesh = GetSubmesh(submeshIndex);
+
+		RenderBounds bounds;
+		bounds.m_Center = glm::vec3(submesh.m_Center[0], submesh.m_Center[1], submesh.m_Center[2]);
+		bounds.m_Radius = submesh.m_Radius;
+		bounds.m_Extents = glm::vec3(submesh.m_Extents[0], submesh.m_Extents[1], submesh.m_Extents[2]);
+
+		return bounds;
+	}
+
+	float* CookedMesh::GetVertexData() const
+	{
+		KR_CORE_ASSERT(m_Header, "No cooked mesh loaded");
+
+		return reinterpret_cast<float*>(m_File.GetData() + m_Header->m_VertexDataOffset);
+	}
+
+	uint8_t* CookedMesh::GetIndexData() const
+	{
+		KR_CORE_ASSERT(m_Header, "No cooked mesh loaded");
+
+		return m_File.GetData() + m_Header->m_IndexDataOffset;
+	}
+
+	IndexType CookedMesh::GetIndexType() const
+	{
+		return (m_Header && (m_Header->m_Flags & s_FlagShortIndices)) ? IndexType::UInt16 : IndexType::UInt32;
+	}
+
+	IndexBuffer* CookedMesh::CreateIndexBuffer() const
+	{
+		if (GetIndexType() == IndexType::UInt16)
+		{
+			return IndexBuffer::Create(reinterpret_cast<uint16_t*>(GetIndexData()), GetNumberOfIndices());
+		}
+
+		return IndexBuffer::Create(reinterpret_cast<uint32_t*>(GetIndexData()), GetNumberOfIndices());
+	}
+
+	RenderBounds CookedMesh::GetBounds() const
+	{
+		std::vector<RenderBounds> submeshBounds;
+
+		for (uint32_t counter = 0; counter < GetNumberOfSubmeshes(); counter++)
+		{
+			submeshBounds.push_back(GetBounds(counter));
+		}
+
+		return RenderBounds::Enclose(submeshBounds.data(), uint32_t(submeshBounds.size()));
+	}
+
+	const CookedMeshLOD& CookedMesh::GetLOD(uint32_t lodIndex) const
+	{
+		KR_CORE_ASSERT(m_Header && lodIndex < m_Header->m_NumberOfLODs, "Level of detail out of the cooked mesh");
+
+		return m_LODs[lodIndex];
+	}
+
+	IndexBuffer* CookedMesh::CreateLODIndexBuffer(uint32_t lodIndex) const
+	{
+		const CookedMeshLOD& lod = GetLOD(lodIndex);
+		uint8_t* lodIndices = GetIndexData() + uint64_t(lod.m_FirstIndex) * GetIndexSize();
+
+		if (GetIndexType() == IndexType::UInt16)
+		{
+			return IndexBuffer::Create(reinterpret_cast<uint16_t*>(lodIndices), lod.m_NumberOfIndices);
+		}
+
+		return IndexBuffer::Create(reinterpret_cast<uint32_t*>(lodIndices), lod.m_NumberOfIndices);
+	}
+
+	uint64_t CookedMesh::HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+		for (size_t counter = 0; counter < size; counter++)
+		{
+			hash ^= bytes[counter];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	uint32_t CookedMesh::ComputeFlags(bool bFlipUVs)
+	{
+		return (bFlipUVs ? s_FlagFlippedUVs : 0) | (MeshOptimizer::GetDefaultSettings().GetKey() << s_OptimizationKeyShift);
+	}
+}
@@ -0,0 +1,383 @@
+/**
+ * @file CookedMesh.h
+ * @brief This file contains the CookedMesh class, the binary (cooked) form of a model file which is mapped into memory instead of parsed.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Buffer.h"
+#include "RenderScene.h"
+#include "Karma/MappedFile.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Header at the start of a cooked mesh file. All offsets are from the start of the file, and the sections are 16 byte aligned.
+	 *
+	 * The layout of a file is
+	 * 1. CookedMeshHeader
+	 * 2. m_NumberOfElements CookedMeshElement, the BufferLayout of the vertices
+	 * 3. m_NumberOfSubmeshes CookedSubmesh
+	 * 4. Interleaved vertices, m_VertexStride bytes each, as MeshOptimizer left them (floats, or packed when quantized)
+	 * 5. Indices, 16 bit if m_Flags has CookedMesh::s_FlagShortIndices and 32 bit otherwise, into the whole of the vertices (not relative
+	 *    to their submesh), so that all of the submeshes draw at once. The m_NumberOfLODIndices of the levels of detail follow the
+	 *    m_NumberOfIndices of the model, of the same width.
+	 * 6. m_NumberOfLODs CookedMeshLOD
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedMeshHeader
+	{
+		uint32_t m_Magic = 0;
+		uint32_t m_Version = 0;
+		uint32_t m_Flags = 0;
+		uint32_t m_NumberOfElements = 0;
+		uint32_t m_VertexStride = 0;
+		uint32_t m_NumberOfVertices = 0;
+		uint32_t m_NumberOfIndices = 0;
+		uint32_t m_NumberOfSubmeshes = 0;
+		uint32_t m_NumberOfLODs = 0;
+		uint32_t m_NumberOfLODIndices = 0;
+
+		/**
+		 * @brief FNV-1a hash of the vertex and index sections (the levels of detail included), for telling identical content apart from the file name
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ContentHash = 0;
+
+		uint64_t m_ElementsOffset = 0;
+		uint64_t m_SubmeshesOffset = 0;
+		uint64_t m_VertexDataOffset = 0;
+		uint64_t m_IndexDataOffset = 0;
+		uint64_t m_LODsOffset = 0;
+	};
+
+	/**
+	 * @brief A BufferElement as stored in a cooked mesh file
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedMeshElement
+	{
+		uint32_t m_Type = 0;
+		uint32_t m_bNormalized = 0;
+		char m_Name[24] = {};
+	};
+
+	/**
+	 * @brief A range of the vertices and indices of a cooked mesh, as the Submesh ModelImporter made it
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedSubmesh
+	{
+		uint32_t m_FirstVertex = 0;
+		uint32_t m_NumberOfVertices = 0;
+		uint32_t m_FirstIndex = 0;
+		uint32_t m_NumberOfIndices = 0;
+
+		/**
+		 * @brief Object space bounds, as RenderBounds (m_Center, m_Radius, m_Extents)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Center[3] = {};
+		float m_Radius = 0.0f;
+		float m_Extents[3] = {};
+
+		uint32_t m_MaterialIndex = 0;
+	};
+
+	/**
+	 * @brief A level of detail of a cooked mesh, a range of the index section past the model's indices (MeshSimplifier made it)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedMeshLOD
+	{
+		/**
+		 * @brief First index, counted from the start of the index section
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_FirstIndex = 0;
+		uint32_t m_NumberOfIndices = 0;
+
+		/**
+		 * @brief As ImportedLOD::m_Error
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Error = 0.0f;
+
+		uint32_t m_Padding = 0;
+	};
+
+	/**
+	 * @brief A model file cooked into GPU ready vertex and index data. The cooked file is mapped (MappedFile) and the spans of a submesh go
+	 * straight to VertexBuffer::Create and IndexBuffer::Create, with no text parsing and no per vertex conversion at load time.
+	 *
+	 * Mesh cooks its model next to the source (GetCookedPath) the first time, and whenever the source is newer than the cooked file,
+	 * the cooked file is of another version, its UVs are flipped differently (Vulkan flips them) or it was optimized with other
+	 * MeshOptimizationSettings.
+	 *
+	 * @see Mesh::Mesh(const std::string&)
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API CookedMesh
+	{
+	public:
+		/**
+		 * @brief Nothing loaded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		CookedMesh();
+
+		/**
+		 * @brief Imports the whole of the model (ModelImporter, on JobPool::GetLoadingPool), optimizes it with the settings of
+		 * MeshOptimizer::GetDefaultSettings and writes the cooked file
+		 *
+		 * @param sourcePath					The model file (obj and all that Assimp reads)
+		 * @param cookedPath					Where the cooked file goes
+		 * @param bFlipUVs						Whether to flip the texture coordinates (aiProcess_FlipUVs), as Vulkan wants them
+		 *
+		 * @return false if the model can't be imported or the file can't be written
+		 * @since Karma 1.0.0
+		 */
+		static bool Cook(const std::string& sourcePath, const std::string& cookedPath, bool bFlipUVs);
+
+		/**
+		 * @brief Maps the cooked file and checks its header, the ranges of its submeshes and levels of detail, and that every index refers to
+		 * one of its vertices
+		 *
+		 * @param cookedPath					The cooked file
+		 * @param bFlipUVs						The flipping expected, a file cooked otherwise (or with other optimization settings) is refused
+		 *
+		 * @return false if the file is missing, of another version, flipping or optimization, truncated or with indices out of range (the
+		 * caller cooks it again)
+		 * @since Karma 1.0.0
+		 */
+		bool Load(const std::string& cookedPath, bool bFlipUVs);
+
+		/**
+		 * @brief Whether the cooked file exists and is newer than the source
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsUpToDate(const std::string& sourcePath, const std::string& cookedPath);
+
+		/**
+		 * @brief The path the cooked file of the source goes to, next to it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::string GetCookedPath(const std::string& sourcePath) { return sourcePath + ".krmesh"; }
+
+		/**
+		 * @brief Recomputes the content hash, touching every page of the vertex and index sections
+		 *
+		 * @return true if it matches the header's
+		 * @since Karma 1.0.0
+		 */
+		bool Validate() const;
+
+		/**
+		 * @brief The layout of the vertices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		BufferLayout GetLayout() const;
+
+		/**
+		 * @brief Number of submeshes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfSubmeshes() const { return m_Header ? m_Header->m_NumberOfSubmeshes : 0; }
+
+		/**
+		 * @brief Range and bounds of a submesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const CookedSubmesh& GetSubmesh(uint32_t submeshIndex) const;
+
+		/**
+		 * @brief First vertex of the submesh, within the mapping (valid as long as this object is)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float* GetVertexData(uint32_t submeshIndex) const;
+
+		/**
+		 * @brief Bytes of the vertices of the submesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetVertexDataSize(uint32_t submeshIndex) const;
+
+		/**
+		 * @brief First index of the submesh, within the mapping, of GetIndexType
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint8_t* GetIndexData(uint32_t submeshIndex) const;
+
+		/**
+		 * @brief The bounds of the submesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds GetBounds(uint32_t submeshIndex) const;
+
+		/**
+		 * @brief All of the vertices, within the mapping
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float* GetVertexData() const;
+
+		/**
+		 * @brief Bytes of all of the vertices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetVertexDataSize() const { return m_Header ? m_Header->m_NumberOfVertices * m_Header->m_VertexStride : 0; }
+
+		/**
+		 * @brief All of the indices, within the mapping, of GetIndexType
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint8_t* GetIndexData() const;
+
+		/**
+		 * @brief Width of the indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		IndexType GetIndexType() const;
+
+		/**
+		 * @brief Bytes per index
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetIndexSize() const { return GetIndexType() == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+		/**
+		 * @brief Creates the index buffer of all of the indices, of their width
+		 *
+		 * @since Karma 1.0.0
+		 */
+		IndexBuffer* CreateIndexBuffer() const;
+
+		/**
+		 * @brief Number of indices of all of the submeshes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfIndices() const { return m_Header ? m_Header->m_NumberOfIndices : 0; }
+
+		/**
+		 * @brief The bounds of the whole of the model
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds GetBounds() const;
+
+		/**
+		 * @brief Number of levels of detail past the model
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfLODs() const { return m_Header ? m_Header->m_NumberOfLODs : 0; }
+
+		/**
+		 * @brief Range and error of a level of detail
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const CookedMeshLOD& GetLOD(uint32_t lodIndex) const;
+
+		/**
+		 * @brief Creates the index buffer of a level of detail, of the width of GetIndexType
+		 *
+		 * @since Karma 1.0.0
+		 */
+		IndexBuffer* CreateLODIndexBuffer(uint32_t lodIndex) const;
+
+		/**
+		 * @brief The content hash of the header
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetContentHash() const { return m_Header ? m_Header->m_ContentHash : 0; }
+
+		/**
+		 * @brief 64 bit FNV-1a hash of bytes, continuing from hash
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = s_HashOffsetBasis);
+
+		/**
+		 * @brief The m_Flags a file cooked now would have, the flipping and the bits of the optimization settings
+		 * (MeshOptimizationSettings::GetKey), save for s_FlagShortIndices which depends on the model
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t ComputeFlags(bool bFlipUVs);
+
+	public:
+		/**
+		 * @brief "KRMS"
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_Magic = 0x534D524B;
+
+		/**
+		 * @brief Bumped whenever the layout of the file changes, older files get recooked
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_Version = 4;
+
+		/**
+		 * @brief CookedMeshHeader::m_Flags bit, the UVs were flipped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_FlagFlippedUVs = 1;
+
+		/**
+		 * @brief CookedMeshHeader::m_Flags bit, the indices are 16 bit
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_FlagShortIndices = 2;
+
+		/**
+		 * @brief CookedMeshHeader::m_Flags bits from this one up hold MeshOptimizationSettings::GetKey
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_OptimizationKeyShift = 8;
+
+		static constexpr uint64_t s_HashOffsetBasis = 14695981039346656037ull;
+
+	private:
+		MappedFile m_File;
+		const CookedMeshHeader* m_Header;
+		const CookedMeshElement* m_Elements;
+		const CookedSubmesh* m_Submeshes;
+		const CookedMeshLOD* m_LODs;
+	};
+}
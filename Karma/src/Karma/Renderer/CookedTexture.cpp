@@ -0,0 +1,418 @@
+#include "CookedTexture.h"
+#include "CookedMesh.h"
+#include "RenderCommand.h"
+#include "StreamedTexture.h"
+#include "Karma/JobPool.h"
+#include "Karma/KarmaUtilities.h"
+#include "Karma/CommandLine.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Karma
+{
+	namespace
+	{
+		// Sections (and mips) start at multiples of this, as the block sizes and Vulkan's buffer copies want
+		constexpr uint64_t s_SectionAlignment = 16;
+
+		uint64_t AlignSection(uint64_t offset)
+		{
+			return (offset + s_SectionAlignment - 1) & ~(s_SectionAlignment - 1);
+		}
+
+		/**
+		 * @brief The image as RGBA8 with its mip chain, as FileTextureSource decodes it
+		 */
+		bool DecodeImage(const std::string& sourcePath, std::vector<TextureMip>& mips)
+		{
+			int width = 0;
+			int height = 0;
+			int channels = 0;
+
+			unsigned char* pixels = KarmaUtilities::GetImagePixelData(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+			if (pixels == nullptr)
+			{
+				return false;
+			}
+
+			mips.resize(1);
+			mips[0].m_Width = uint32_t(width);
+			mips[0].m_Height = uint32_t(height);
+			mips[0].m_Format = TextureFormat::RGBA8;
+			mips[0].m_Pixels.assign(pixels, pixels + size_t(width) * height * 4);
+
+			stbi_image_free(pixels);
+
+			TextureSource::GenerateMipChain(mips);
+
+			return true;
+		}
+	}
+
+	TextureCompression CookedTexture::s_DefaultCompression = TextureCompression::BC;
+
+	static CommandLineOption s_TextureCompressionOption("texture-compression", "--texture-compression=none|bc|bc7|bc5|etc2 picks the block compression the textures are cooked with",
+		[](const std::string& value)
+		{
+			TextureCompression compression;
+
+			if (TextureCompressor::ParseCompression(value, compression))
+			{
+				CookedTexture::SetDefaultCompression(compression);
+			}
+			else
+			{
+				KR_CORE_WARN("Unknown texture compression {0} asked for, keeping the default one", value);
+			}
+		});
+
+	CookedTexture::CookedTexture() : m_Header(nullptr), m_Mips(nullptr)
+	{
+	}
+
+	bool CookedTexture::Cook(const std::string& sourcePath, const std::string& cookedPath, TextureCompression compression)
+	{
+		std::vector<TextureMip> mips;
+
+		if (!DecodeImage(sourcePath, mips))
+		{
+			return false;
+		}
+
+		const TextureFormat format = TextureCompressor::ChooseFormat(compression, TextureCompressor::HasAlpha(mips[0]));
+
+		std::vector<TextureMip> compressedMips(mips.size());
+
+		for (size_t counter = 0; counter < mips.size(); counter++)
+		{
+			TextureCompressor::Compress(format, mips[counter], compressedMips[counter], &JobPool::GetLoadingPool());
+		}
+
+		CookedTextureHeader header;
+		header.m_Magic = s_Magic;
+		header.m_Version = s_Version;
+		header.m_Format = uint32_t(format);
+		header.m_Compression = uint32_t(compression);
+		header.m_Width = mips[0].m_Width;
+		header.m_Height = mips[0].m_Height;
+		header.m_NumberOfMips = uint32_t(mips.size());
+		header.m_SourceHash = HashSource(sourcePath);
+		header.m_MipsOffset = AlignSection(sizeof(CookedTextureHeader));
+		header.m_DataOffset = AlignSection(header.m_MipsOffset + mips.size() * sizeof(CookedTextureMip));
+
+		std::vector<CookedTextureMip> cookedMips(mips.size());
+		uint64_t offset = header.m_DataOffset;
+
+		for (size_t counter = 0; counter < mips.size(); counter++)
+		{
+			cookedMips[counter].m_Offset = offset;
+			cookedMips[counter].m_Size = compressedMips[counter].m_Pixels.size();
+			cookedMips[counter].m_Width = compressedMips[counter].m_Width;
+			cookedMips[counter].m_Height = compressedMips[counter].m_Height;
+
+			offset = AlignSection(offset + cookedMips[counter].m_Size);
+		}
+
+		// The padding between the mips is hashed too, Validate hashes the section whole
+		std::vector<uint8_t> data(size_t(offset - header.m_DataOffset), 0);
+
+		for (size_t counter = 0; counter < mips.size(); counter++)
+		{
+			memcpy(data.data() + (cookedMips[counter].m_Offset - header.m_DataOffset), compressedMips[counter].m_Pixels.data(),
+				size_t(cookedMips[counter].m_Size));
+		}
+
+		header.m_ContentHash = CookedMesh::HashBytes(data.data(), data.size());
+
+		// Written aside and renamed, so that a reader never maps a half written file
+		std::string temporaryPath = cookedPath + ".tmp";
+
+		{
+			std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+
+			if (!out)
+			{
+				KR_CORE_WARN("CookedTexture: couldn't write {0}", temporaryPath);
+				return false;
+			}
+
+			auto writeSection = [&out](uint64_t offset, const void* data, size_t size)
+			{
+				static const char padding[s_SectionAlignment] = {};
+
+				uint64_t position = uint64_t(out.tellp());
+				out.write(padding, std::streamsize(offset - position));
+				out.write(static_cast<const char*>(data), std::streamsize(size));
+			};
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			writeSection(header.m_MipsOffset, cookedMips.data(), cookedMips.size() * sizeof(CookedTextureMip));
+			writeSection(header.m_DataOffset, data.data(), data.size());
+
+			if (!out)
+			{
+				KR_CORE_WARN("CookedTexture: couldn't write {0}", temporaryPath);
+				return false;
+			}
+		}
+
+		std::error_code errorCode;
+		std::filesystem::rename(temporaryPath, cookedPath, errorCode);
+
+		if (errorCode)
+		{
+			KR_CORE_WARN("CookedTexture: couldn't move {0} to {1} ({2})", temporaryPath, cookedPath, errorCode.message());
+			std::filesystem::remove(temporaryPath, errorCode);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CookedTexture::Load(const std::string& cookedPath, TextureCompression compression, uint64_t sourceHash)
+	{
+		m_Header = nullptr;
+		m_Mips = nullptr;
+
+		if (!m_File.Open(cookedPath))
+		{
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+		const uint64_t fileSize = m_File.GetSize();
+
+		auto refuse = [this]()
+		{
+			m_File.Close();
+			return false;
+		};
+
+		if (fileSize < sizeof(CookedTextureHeader))
+		{
+			return refuse();
+		}
+
+		const CookedTextureHeader* header = reinterpret_cast<const CookedTextureHeader*>(data);
+
+		if (header->m_Magic != s_Magic || header->m_Version != s_Version || header->m_Compression != uint32_t(compression) ||
+			header->m_Format > uint32_t(TextureFormat::ETC2RGBA))
+		{
+			return refuse();
+		}
+
+		// Cooked from another image than the one there now
+		if (sourceHash != 0 && header->m_SourceHash != sourceHash)
+		{
+			return refuse();
+		}
+
+		if (header->m_Width == 0 || header->m_Height == 0 ||
+			header->m_NumberOfMips != StreamedTexture::ComputeNumberOfMips(header->m_Width, header->m_Height) ||
+			header->m_MipsOffset + uint64_t(header->m_NumberOfMips) * sizeof(CookedTextureMip) > fileSize || header->m_DataOffset > fileSize)
+		{
+			KR_CORE_WARN("CookedTexture: {0} is truncated", cookedPath);
+			return refuse();
+		}
+
+		const CookedTextureMip* mips = reinterpret_cast<const CookedTextureMip*>(data + header->m_MipsOffset);
+		const TextureFormat format = TextureFormat(header->m_Format);
+
+		for (uint32_t mip = 0; mip < header->m_NumberOfMips; mip++)
+		{
+			// The sizes are what the format makes of the extents, so the upload never reads past a mip
+			if (mips[mip].m_Width != StreamedTexture::GetMipExtent(header->m_Width, mip) ||
+				mips[mip].m_Height != StreamedTexture::GetMipExtent(header->m_Height, mip) ||
+				mips[mip].m_Size != StreamedTexture::GetMipSize(format, header->m_Width, header->m_Height, mip) ||
+				mips[mip].m_Offset < header->m_DataOffset || mips[mip].m_Offset + mips[mip].m_Size > fileSize)
+			{
+				KR_CORE_WARN("CookedTexture: {0} has a mip out of its data", cookedPath);
+				return refuse();
+			}
+		}
+
+		m_Header = header;
+		m_Mips = mips;
+
+		return true;
+	}
+
+	bool CookedTexture::LoadOrCook(const std::string& sourcePath, TextureCompression compression)
+	{
+		const std::string cookedPath = GetCookedPath(sourcePath);
+		const uint64_t sourceHash = HashSource(sourcePath);
+
+		if (Load(cookedPath, compression, sourceHash))
+		{
+			return true;
+		}
+
+		if (sourceHash == 0)
+		{
+			return false;
+		}
+
+		KR_CORE_INFO("Cooking {0} ({1})", sourcePath, TextureCompressor::GetCompressionName(compression));
+
+		return Cook(sourcePath, cookedPath, compression) && Load(cookedPath, compression, sourceHash);
+	}
+
+	uint64_t CookedTexture::HashSource(const std::string& sourcePath)
+	{
+		MappedFile file;
+
+		if (!file.Open(sourcePath))
+		{
+			return 0;
+		}
+
+		const uint64_t hash = CookedMesh::HashBytes(file.GetData(), file.GetSize());
+
+		// 0 means no source
+		return hash != 0 ? hash : 1;
+	}
+
+	bool CookedTexture::Validate() const
+	{
+		if (!m_Header)
+		{
+			return false;
+		}
+
+		const CookedTextureMip& lastMip = m_Mips[m_Header->m_NumberOfMips - 1];
+		const uint64_t dataSize = AlignSection(lastMip.m_Offset + lastMip.m_Size) - m_Header->m_DataOffset;
+
+		if (m_Header->m_DataOffset + dataSize > m_File.GetSize())
+		{
+			return false;
+		}
+
+		return CookedMesh::HashBytes(m_File.GetData() + m_Header->m_DataOffset, size_t(dataSize)) == m_Header->m_ContentHash;
+	}
+
+	const CookedTextureMip& CookedTexture::GetMip(uint32_t mip) const
+	{
+		KR_CORE_ASSERT(m_Header && mip < m_Header->m_NumberOfMips, "CookedTexture: mip out of range");
+
+		return m_Mips[mip];
+	}
+
+	const uint8_t* CookedTexture::GetMipData(uint32_t mip) const
+	{
+		return m_File.GetData() + GetMip(mip).m_Offset;
+	}
+
+	uint64_t CookedTexture::GetDataSize() const
+	{
+		uint64_t size = 0;
+
+		for (uint32_t mip = 0; m_Header && mip < m_Header->m_NumberOfMips; mip++)
+		{
+			size += m_Mips[mip].m_Size;
+		}
+
+		return size;
+	}
+
+	TextureCompression CookedTexture::GetCompression()
+	{
+		RendererAPI* rendererAPI = RenderCommand::GetRendererAPI();
+
+		if (rendererAPI == nullptr || s_DefaultCompression == TextureCompression::None)
+		{
+			return s_DefaultCompression;
+		}
+
+		if (rendererAPI->SupportsTextureFormat(TextureCompressor::ChooseFormat(s_DefaultCompression, false)) &&
+			rendererAPI->SupportsTextureFormat(TextureCompressor::ChooseFormat(s_DefaultCompression, true)))
+		{
+			return s_DefaultCompression;
+		}
+
+		static bool bWarned = false;
+
+		if (!bWarned)
+		{
+			bWarned = true;
+			KR_CORE_WARN("The renderer can't sample {0} compressed textures, they are cooked uncompressed",
+				TextureCompressor::GetCompressionName(s_DefaultCompression));
+		}
+
+		return TextureCompression::None;
+	}
+
+	CookedTextureSource::CookedTextureSource(const std::string& fileName, TextureCompression compression) : m_FileName(fileName),
+		m_Compression(compression), m_Format(TextureFormat::RGBA8), m_bChecked(false)
+	{
+	}
+
+	bool CookedTextureSource::GetInfo(uint32_t& width, uint32_t& height)
+	{
+		// The header is all that is read, whether the file is stale is the first Decode's business
+		CookedTexture cookedTexture;
+
+		if (cookedTexture.Load(CookedTexture::GetCookedPath(m_FileName), m_Compression, 0))
+		{
+			width = cookedTexture.GetWidth();
+			height = cookedTexture.GetHeight();
+			m_Format = cookedTexture.GetFormat();
+
+			return true;
+		}
+
+		int imageWidth = 0;
+		int imageHeight = 0;
+		int channels = 0;
+
+		if (!KarmaUtilities::GetImageInfo(m_FileName.c_str(), &imageWidth, &imageHeight, &channels) || imageWidth <= 0 || imageHeight <= 0)
+		{
+			return false;
+		}
+
+		width = uint32_t(imageWidth);
+		height = uint32_t(imageHeight);
+
+		// Images with an alpha channel may still be opaque, the streamer goes by the decoded format once cooked
+		m_Format = TextureCompressor::ChooseFormat(m_Compression, channels == 2 || channels == 4);
+
+		return true;
+	}
+
+	bool CookedTextureSource::Decode(uint32_t firstMip, std::vector<TextureMip>& mips)
+	{
+		CookedTexture cookedTexture;
+
+		if (!m_bChecked)
+		{
+			if (!cookedTexture.LoadOrCook(m_FileName, m_Compression))
+			{
+				return false;
+			}
+
+			m_bChecked = true;
+		}
+		else if (!cookedTexture.Load(CookedTexture::GetCookedPath(m_FileName), m_Compression, 0))
+		{
+			return false;
+		}
+
+		const uint32_t numberOfMips = cookedTexture.GetNumberOfMips();
+		const uint32_t first = std::min(firstMip, numberOfMips - 1);
+
+		mips.resize(numberOfMips - first);
+
+		for (uint32_t mip = first; mip < numberOfMips; mip++)
+		{
+			TextureMip& destination = mips[mip - first];
+			const CookedTextureMip& source = cookedTexture.GetMip(mip);
+
+			destination.m_Width = source.m_Width;
+			destination.m_Height = source.m_Height;
+			destination.m_Format = cookedTexture.GetFormat();
+			destination.m_Pixels.assign(cookedTexture.GetMipData(mip), cookedTexture.GetMipData(mip) + source.m_Size);
+		}
+
+		return true;
+	}
+}
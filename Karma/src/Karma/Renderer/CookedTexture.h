@@ -0,0 +1,242 @@
+/**
+ * @file CookedTexture.h
+ * @brief This file contains the CookedTexture class, the binary (cooked) form of an image file, its mip chain block compressed and mapped into memory instead of decoded.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "TextureCompressor.h"
+#include "TextureStreamer.h"
+#include "Karma/MappedFile.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Header at the start of a cooked texture file. All offsets are from the start of the file, and the sections are 16 byte aligned.
+	 *
+	 * The layout of a file is
+	 * 1. CookedTextureHeader
+	 * 2. m_NumberOfMips CookedTextureMip, from the full size down to 1x1
+	 * 3. The mips, each in m_Format (TextureCompressor) and starting at a multiple of 16
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedTextureHeader
+	{
+		uint32_t m_Magic = 0;
+		uint32_t m_Version = 0;
+		uint32_t m_Format = 0;
+		uint32_t m_Compression = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_NumberOfMips = 0;
+		uint32_t m_Padding = 0;
+
+		/**
+		 * @brief CookedMesh::HashBytes of the image file cooked, the key of the cache: a file whose source hashes otherwise is recooked
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_SourceHash = 0;
+
+		/**
+		 * @brief CookedMesh::HashBytes of the mips section
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ContentHash = 0;
+
+		uint64_t m_MipsOffset = 0;
+		uint64_t m_DataOffset = 0;
+	};
+
+	/**
+	 * @brief A mip of a cooked texture
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API CookedTextureMip
+	{
+		uint64_t m_Offset = 0;
+		uint64_t m_Size = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+	};
+
+	/**
+	 * @brief An image file cooked into its full mip chain, block compressed (TextureCompressor) in the format of the TextureCompression
+	 * asked for. The cooked file is mapped (MappedFile) and the mips go to the GPU as they are, with no image decoding, mip filtering or
+	 * compression at load time.
+	 *
+	 * The cooked file goes next to the source (GetCookedPath), and is recooked whenever the source's bytes hash otherwise than the ones it
+	 * was cooked from (so that a touched but unchanged source doesn't recook), it is of another version or of another compression.
+	 *
+	 * @see CookedTextureSource, Texture::Texture
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API CookedTexture
+	{
+	public:
+		/**
+		 * @brief Nothing loaded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		CookedTexture();
+
+		/**
+		 * @brief Decodes the image (as RGBA8), makes its mips (TextureSource::GenerateMipChain), compresses them on JobPool::GetLoadingPool
+		 * and writes the cooked file
+		 *
+		 * @param sourcePath					The image file
+		 * @param cookedPath					Where the cooked file goes
+		 * @param compression					The format of the mips is TextureCompressor::ChooseFormat's for it and the image's alpha
+		 *
+		 * @return false if the image can't be decoded or the file can't be written
+		 * @since Karma 1.0.0
+		 */
+		static bool Cook(const std::string& sourcePath, const std::string& cookedPath, TextureCompression compression);
+
+		/**
+		 * @brief Maps the cooked file and checks its header
+		 *
+		 * @param cookedPath					The cooked file
+		 * @param compression					The compression expected, a file cooked otherwise is refused
+		 * @param sourceHash					HashSource of the source, a file cooked from another is refused. 0 (no source) takes any.
+		 *
+		 * @return false if the file is missing, of another version, compression or source, or truncated
+		 * @since Karma 1.0.0
+		 */
+		bool Load(const std::string& cookedPath, TextureCompression compression, uint64_t sourceHash);
+
+		/**
+		 * @brief Loads the cooked file of the source, cooking it first if it is missing or stale
+		 *
+		 * @return false if there is neither a usable cooked file nor a source to cook
+		 * @since Karma 1.0.0
+		 */
+		bool LoadOrCook(const std::string& sourcePath, TextureCompression compression);
+
+		/**
+		 * @brief Hash of the bytes of the source file (mapped)
+		 *
+		 * @return 0 if the file can't be read
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t HashSource(const std::string& sourcePath);
+
+		/**
+		 * @brief The path the cooked file of the source goes to, next to it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::string GetCookedPath(const std::string& sourcePath) { return sourcePath + ".krtex"; }
+
+		/**
+		 * @brief Recomputes the content hash, touching every page of the mips
+		 *
+		 * @return true if it matches the header's
+		 * @since Karma 1.0.0
+		 */
+		bool Validate() const;
+
+		TextureFormat GetFormat() const { return m_Header ? TextureFormat(m_Header->m_Format) : TextureFormat::RGBA8; }
+		uint32_t GetWidth() const { return m_Header ? m_Header->m_Width : 0; }
+		uint32_t GetHeight() const { return m_Header ? m_Header->m_Height : 0; }
+		uint32_t GetNumberOfMips() const { return m_Header ? m_Header->m_NumberOfMips : 0; }
+
+		/**
+		 * @brief Size and extent of a mip
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const CookedTextureMip& GetMip(uint32_t mip) const;
+
+		/**
+		 * @brief The texels (or blocks) of a mip, within the mapping (valid as long as this object is)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const uint8_t* GetMipData(uint32_t mip) const;
+
+		/**
+		 * @brief Bytes of all of the mips, as they take on the GPU
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetDataSize() const;
+
+		/**
+		 * @brief The compression the textures are cooked with
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetDefaultCompression(TextureCompression compression) { s_DefaultCompression = compression; }
+		static TextureCompression GetDefaultCompression() { return s_DefaultCompression; }
+
+		/**
+		 * @brief The default compression if the renderer's API samples its formats (RendererAPI::SupportsTextureFormat), None otherwise
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static TextureCompression GetCompression();
+
+	public:
+		/**
+		 * @brief "KRTX"
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_Magic = 0x5854524B;
+
+		/**
+		 * @brief Bumped whenever the layout of the file (or the output of the encoders) changes, older files get recooked
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_Version = 1;
+
+	private:
+		MappedFile m_File;
+		const CookedTextureHeader* m_Header;
+		const CookedTextureMip* m_Mips;
+
+		static TextureCompression s_DefaultCompression;
+	};
+
+	/**
+	 * @brief Streams the mips of a cooked texture, cooking it (on the decoding thread) the first time it is decoded if the cooked file is
+	 * missing or stale. The mips are handed over in the cooked format, so that the StreamedTexture uploads the blocks as they are.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API CookedTextureSource : public TextureSource
+	{
+	public:
+		CookedTextureSource(const std::string& fileName, TextureCompression compression);
+
+		/**
+		 * @brief From the cooked file's header if there is one, else from the image's (the format then guessed from its channels)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool GetInfo(uint32_t& width, uint32_t& height) override;
+
+		virtual bool Decode(uint32_t firstMip, std::vector<TextureMip>& mips) override;
+		virtual TextureFormat GetFormat() const override { return m_Format; }
+		virtual const std::string& GetName() const override { return m_FileName; }
+
+	private:
+		std::string m_FileName;
+		TextureCompression m_Compression;
+		TextureFormat m_Format;
+
+		// The first Decode checked the cooked file against the source (or cooked it), the later ones skip hashing the source
+		bool m_bChecked;
+	};
+}
@@ -0,0 +1,332 @@
+#include "FrustumCuller.h"
+#include "RenderScene.h"
+
+#include <chrono>
+#include <algorithm>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define KR_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define KR_CULL_SSE 1
+#endif
+
+namespace Karma
+{
+#if defined(KR_CULL_AVX)
+	const uint32_t FrustumCuller::s_BatchWidth = 8;
+#else
+	const uint32_t FrustumCuller::s_BatchWidth = 4;
+#endif
+
+	FrustumCuller::FrustumCuller(uint32_t numberOfWorkers) : m_Generation(0), m_PendingWorkers(0), m_bQuit(false), m_Frustum{},
+		m_BoundsStream(nullptr), m_NumberOfChunks(0)
+	{
+		SpawnWorkers(numberOfWorkers);
+	}
+
+	FrustumCuller::~FrustumCuller()
+	{
+		JoinWorkers();
+	}
+
+	void FrustumCuller::SetNumberOfWorkers(uint32_t numberOfWorkers)
+	{
+		JoinWorkers();
+		SpawnWorkers(numberOfWorkers);
+	}
+
+	void FrustumCuller::SpawnWorkers(uint32_t numberOfWorkers)
+	{
+		m_ChunkVisible.resize(numberOfWorkers + 1);
+		m_ChunkVisibleCount.resize(numberOfWorkers + 1);
+
+		m_bQuit = false;
+
+		for (uint32_t counter = 0; counter < numberOfWorkers; counter++)
+		{
+			m_Workers.emplace_back(&FrustumCuller::WorkerLoop, this, counter + 1, m_Generation);
+		}
+	}
+
+	void FrustumCuller::JoinWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bQuit = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+		m_Workers.clear();
+	}
+
+	void FrustumCuller::WorkerLoop(uint32_t chunkIndex, uint64_t seenGeneration)
+	{
+		while (true)
+		{
+			uint32_t numberOfChunks;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeCondition.wait(lock, [&] { return m_bQuit || m_Generation != seenGeneration; });
+
+				if (m_bQuit)
+				{
+					return;
+				}
+
+				seenGeneration = m_Generation;
+				numberOfChunks = m_NumberOfChunks;
+			}
+
+			if (chunkIndex < numberOfChunks)
+			{
+				CullChunk(chunkIndex);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (--m_PendingWorkers == 0)
+				{
+					m_DoneCondition.notify_one();
+				}
+			}
+		}
+	}
+
+	const std::vector<uint32_t>& FrustumCuller::Cull(const Frustum& frustum, const RenderBoundsStream& boundsStream)
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		uint32_t numberOfBounds = uint32_t(boundsStream.Size());
+		uint32_t numberOfContexts = uint32_t(m_Workers.size()) + 1;
+
+		uint32_t numberOfChunks = (numberOfBounds + s_MinimumBoundsPerChunk - 1) / s_MinimumBoundsPerChunk;
+		numberOfChunks = std::max(1u, std::min(numberOfChunks, numberOfContexts));
+
+		m_Frustum = frustum;
+		m_BoundsStream = &boundsStream;
+
+		if (numberOfChunks > 1)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_NumberOfChunks = numberOfChunks;
+				m_PendingWorkers = uint32_t(m_Workers.size());
+				m_Generation++;
+			}
+			m_WakeCondition.notify_all();
+		}
+		else
+		{
+			m_NumberOfChunks = 1;
+		}
+
+		// The calling thread culls the first chunk
+		CullChunk(0);
+
+		if (numberOfChunks > 1)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_DoneCondition.wait(lock, [&] { return m_PendingWorkers == 0; });
+		}
+
+		// Join in chunk order
+		m_VisibleIndices.clear();
+		for (uint32_t chunk = 0; chunk < numberOfChunks; chunk++)
+		{
+			m_VisibleIndices.insert(m_VisibleIndices.end(), m_ChunkVisible[chunk].begin(), m_ChunkVisible[chunk].begin() + m_ChunkVisibleCount[chunk]);
+		}
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		m_Statistics.m_NumberOfTested = numberOfBounds;
+		m_Statistics.m_NumberOfVisible = uint32_t(m_VisibleIndices.size());
+		m_Statistics.m_NumberOfCulled = numberOfBounds - m_Statistics.m_NumberOfVisible;
+		m_Statistics.m_NumberOfChunks = numberOfChunks;
+		m_Statistics.m_CullTimeMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+		return m_VisibleIndices;
+	}
+
+	void FrustumCuller::CullChunk(uint32_t chunkIndex)
+	{
+		uint32_t numberOfBounds = uint32_t(m_BoundsStream->Size());
+
+		// Contiguous, nearly equal, chunks starting at batch boundaries
+		uint32_t first = uint32_t(uint64_t(numberOfBounds) * chunkIndex / m_NumberOfChunks);
+		first -= first % s_BatchWidth;
+
+		uint32_t last = numberOfBounds;
+		if (chunkIndex + 1 < m_NumberOfChunks)
+		{
+			last = uint32_t(uint64_t(numberOfBounds) * (chunkIndex + 1) / m_NumberOfChunks);
+			last -= last % s_BatchWidth;
+		}
+
+		std::vector<uint32_t>& visible = m_ChunkVisible[chunkIndex];
+		if (visible.size() < last - first)
+		{
+			visible.resize(last - first);
+		}
+
+		m_ChunkVisibleCount[chunkIndex] = last > first ? CullRange(m_Frustum, *m_BoundsStream, first, last, visible.data()) : 0;
+	}
+
+	uint32_t FrustumCuller::CullRange(const Frustum& frustum, const RenderBoundsStream& boundsStream, uint32_t first, uint32_t last,
+		uint32_t* visibleIndices)
+	{
+		const float* centerX = boundsStream.m_CenterX.data();
+		const float* centerY = boundsStream.m_CenterY.data();
+		const float* centerZ = boundsStream.m_CenterZ.data();
+		const float* radius = boundsStream.m_Radius.data();
+		const float* extentX = boundsStream.m_ExtentX.data();
+		const float* extentY = boundsStream.m_ExtentY.data();
+		const float* extentZ = boundsStream.m_ExtentZ.data();
+
+		// Absolute normals, for projecting the boxes on the planes
+		glm::vec3 absoluteNormals[Frustum::NumberOfPlanes];
+		for (uint32_t plane = 0; plane < Frustum::NumberOfPlanes; plane++)
+		{
+			absoluteNormals[plane] = glm::abs(glm::vec3(frustum.m_Planes[plane]));
+		}
+
+		uint32_t numberOfVisible = 0;
+		uint32_t index = first;
+
+#if defined(KR_CULL_AVX)
+		for (; index + 8 <= last; index += 8)
+		{
+			__m256 cx = _mm256_loadu_ps(centerX + index);
+			__m256 cy = _mm256_loadu_ps(centerY + index);
+			__m256 cz = _mm256_loadu_ps(centerZ + index);
+			__m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + index));
+			__m256 ex = _mm256_loadu_ps(extentX + index);
+			__m256 ey = _mm256_loadu_ps(extentY + index);
+			__m256 ez = _mm256_loadu_ps(extentZ + index);
+
+			__m256 outside = _mm256_setzero_ps();
+
+			for (uint32_t plane = 0; plane < Frustum::NumberOfPlanes; plane++)
+			{
+				const glm::vec4& p = frustum.m_Planes[plane];
+				const glm::vec3& a = absoluteNormals[plane];
+
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.x), cx), _mm256_mul_ps(_mm256_set1_ps(p.y), cy)),
+					_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.z), cz), _mm256_set1_ps(p.w)));
+
+				__m256 projectedRadius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a.x), ex), _mm256_mul_ps(_mm256_set1_ps(a.y), ey)),
+					_mm256_mul_ps(_mm256_set1_ps(a.z), ez));
+
+				// Sphere or box entirely behind the plane. Ordered compares, so NaNs (0 * infinity of unbounded boxes) never cull.
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negativeRadius, _CMP_LT_OQ));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, projectedRadius), _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+
+			int outsideMask = _mm256_movemask_ps(outside);
+			for (uint32_t lane = 0; lane < 8; lane++)
+			{
+				if (!(outsideMask & (1 << lane)))
+				{
+					visibleIndices[numberOfVisible++] = index + lane;
+				}
+			}
+		}
+#elif defined(KR_CULL_SSE)
+		for (; index + 4 <= last; index += 4)
+		{
+			__m128 cx = _mm_loadu_ps(centerX + index);
+			__m128 cy = _mm_loadu_ps(centerY + index);
+			__m128 cz = _mm_loadu_ps(centerZ + index);
+			__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + index));
+			__m128 ex = _mm_loadu_ps(extentX + index);
+			__m128 ey = _mm_loadu_ps(extentY + index);
+			__m128 ez = _mm_loadu_ps(extentZ + index);
+
+			__m128 outside = _mm_setzero_ps();
+
+			for (uint32_t plane = 0; plane < Frustum::NumberOfPlanes; plane++)
+			{
+				const glm::vec4& p = frustum.m_Planes[plane];
+				const glm::vec3& a = absoluteNormals[plane];
+
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), cx), _mm_mul_ps(_mm_set1_ps(p.y), cy)),
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), cz), _mm_set1_ps(p.w)));
+
+				__m128 projectedRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.x), ex), _mm_mul_ps(_mm_set1_ps(a.y), ey)),
+					_mm_mul_ps(_mm_set1_ps(a.z), ez));
+
+				// Sphere or box entirely behind the plane. Ordered compares, so NaNs (0 * infinity of unbounded boxes) never cull.
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, projectedRadius), _mm_setzero_ps()));
+			}
+
+			int outsideMask = _mm_movemask_ps(outside);
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if (!(outsideMask & (1 << lane)))
+				{
+					visibleIndices[numberOfVisible++] = index + lane;
+				}
+			}
+		}
+#else
+		// Batches of 4 with fixed trip counts, for the compiler to vectorize (NEON and the like)
+		for (; index + 4 <= last; index += 4)
+		{
+			bool outside[4] = { false, false, false, false };
+
+			for (uint32_t plane = 0; plane < Frustum::NumberOfPlanes; plane++)
+			{
+				const glm::vec4& p = frustum.m_Planes[plane];
+				const glm::vec3& a = absoluteNormals[plane];
+
+				for (uint32_t lane = 0; lane < 4; lane++)
+				{
+					uint32_t i = index + lane;
+					float distance = p.x * centerX[i] + p.y * centerY[i] + p.z * centerZ[i] + p.w;
+					float projectedRadius = a.x * extentX[i] + a.y * extentY[i] + a.z * extentZ[i];
+
+					outside[lane] = outside[lane] || distance < -radius[i] || distance + projectedRadius < 0.0f;
+				}
+			}
+
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if (!outside[lane])
+				{
+					visibleIndices[numberOfVisible++] = index + lane;
+				}
+			}
+		}
+#endif
+
+		// The remainder
+		for (; index < last; index++)
+		{
+			bool outside = false;
+
+			for (uint32_t plane = 0; plane < Frustum::NumberOfPlanes && !outside; plane++)
+			{
+				const glm::vec4& p = frustum.m_Planes[plane];
+				const glm::vec3& a = absoluteNormals[plane];
+
+				float distance = p.x * centerX[index] + p.y * centerY[index] + p.z * centerZ[index] + p.w;
+				float projectedRadius = a.x * extentX[index] + a.y * extentY[index] + a.z * extentZ[index];
+
+				outside = distance < -radius[index] || distance + projectedRadius < 0.0f;
+			}
+
+			if (!outside)
+			{
+				visibleIndices[numberOfVisible++] = index;
+			}
+		}
+
+		return numberOfVisible;
+	}
+}
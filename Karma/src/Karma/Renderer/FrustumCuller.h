@@ -0,0 +1,187 @@
+/**
+ * @file FrustumCuller.h
+ * @brief This file contains FrustumCuller class, the visibility stage which tests the bounds of render proxies against a camera's frustum.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/Camera/Frustum.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	struct RenderBoundsStream;
+
+	/**
+	 * @brief Counters of the latest FrustumCuller::Cull call. Culling a scene of, say, 100k proxies (with the Null backend) and reading
+	 * m_CullTimeMicroseconds for several SetNumberOfWorkers gives the cost and the scaling of the stage.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API FrustumCullingStatistics
+	{
+		/**
+		 * @brief Number of proxies tested
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfTested = 0;
+
+		/**
+		 * @brief Number of proxies found (at least partially) inside the frustum
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfVisible = 0;
+
+		/**
+		 * @brief Number of proxies found outside the frustum
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfCulled = 0;
+
+		/**
+		 * @brief Number of ranges the proxies were split in (hence the threads involved)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfChunks = 0;
+
+		/**
+		 * @brief Wall clock time of the Cull call
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_CullTimeMicroseconds = 0;
+	};
+
+	/**
+	 * @brief Tests the world bounds of render proxies (RenderBoundsStream) against a Frustum and lists the visible ones.
+	 *
+	 * A proxy is culled when its sphere or its box lies entirely behind one of the six planes. The bounds are tested s_BatchWidth at a time
+	 * with SIMD (8 with AVX, 4 with SSE2, and a plain loop of 4 elsewhere), the remainder one by one. Large streams are split into contiguous
+	 * ranges culled by worker threads, whose results are joined in range order, so the visible list keeps the order of the proxies.
+	 *
+	 * @see Renderer::Submit
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API FrustumCuller
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param numberOfWorkers				Number of worker threads (besides the calling thread). 0 culls on the calling thread only.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		FrustumCuller(uint32_t numberOfWorkers = 0);
+
+		/**
+		 * @brief Joins the workers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~FrustumCuller();
+
+		/**
+		 * @brief Culls the bounds against the frustum
+		 *
+		 * @param frustum						The view volume
+		 * @param boundsStream					World bounds of the proxies
+		 *
+		 * @return Indices (into boundsStream, and the proxies) of the visible bounds, in increasing order. Valid till the next Cull.
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<uint32_t>& Cull(const Frustum& frustum, const RenderBoundsStream& boundsStream);
+
+		/**
+		 * @brief Culls bounds [first, last) of the stream on the calling thread
+		 *
+		 * @param visibleIndices				Output, at least (last - first) long
+		 *
+		 * @return Number of indices written to visibleIndices
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t CullRange(const Frustum& frustum, const RenderBoundsStream& boundsStream, uint32_t first, uint32_t last,
+			uint32_t* visibleIndices);
+
+		/**
+		 * @brief Joins the present workers and spawns numberOfWorkers fresh ones
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetNumberOfWorkers(uint32_t numberOfWorkers);
+
+		/**
+		 * @brief Number of worker threads (besides the calling thread)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfWorkers() const { return uint32_t(m_Workers.size()); }
+
+		/**
+		 * @brief Counters of the latest Cull call
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const FrustumCullingStatistics& GetStatistics() const { return m_Statistics; }
+
+		/**
+		 * @brief Number of bounds tested together
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static const uint32_t s_BatchWidth;
+
+	private:
+		void SpawnWorkers(uint32_t numberOfWorkers);
+		void JoinWorkers();
+
+		void WorkerLoop(uint32_t chunkIndex, uint64_t seenGeneration);
+
+		/**
+		 * @brief Culls range number chunkIndex of the present job into m_ChunkVisible[chunkIndex]
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CullChunk(uint32_t chunkIndex);
+
+	private:
+		std::vector<std::thread> m_Workers;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeCondition;
+		std::condition_variable m_DoneCondition;
+		uint64_t m_Generation;
+		uint32_t m_PendingWorkers;
+		bool m_bQuit;
+
+		// The present job
+		Frustum m_Frustum;
+		const RenderBoundsStream* m_BoundsStream;
+		uint32_t m_NumberOfChunks;
+
+		// Per chunk results, joined in chunk order
+		std::vector<std::vector<uint32_t>> m_ChunkVisible;
+		std::vector<uint32_t> m_ChunkVisibleCount;
+
+		std::vector<uint32_t> m_VisibleIndices;
+
+		FrustumCullingStatistics m_Statistics;
+
+		// Below this many proxies per chunk, threading costs more than it saves
+		static constexpr uint32_t s_MinimumBoundsPerChunk = 8192;
+	};
+}
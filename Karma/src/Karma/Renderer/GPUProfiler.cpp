@@ -0,0 +1,138 @@
+#include "GPUProfiler.h"
+#include "Karma/CommandLine.h"
+
+#include <algorithm>
+
+namespace Karma
+{
+	bool GPUProfiler::s_bEnabled = false;
+	bool GPUProfiler::s_bPipelineStatisticsEnabled = false;
+	uint32_t GPUProfiler::s_AveragingWindow = 60;
+
+	std::mutex GPUProfiler::s_Mutex;
+	std::map<std::string, GPUScopeStatistics> GPUProfiler::s_Scopes;
+	std::map<std::string, uint64_t> GPUProfiler::s_PipelineStatisticsSamples;
+
+	static CommandLineOption s_GPUProfileOption("gpu-profile", "--gpu-profile[=stats] times the scene, its passes and KarmaGui on the GPU, stats counts their pipeline statistics too",
+		[](const std::string& value)
+		{
+			GPUProfiler::SetEnabled(true);
+			GPUProfiler::SetPipelineStatisticsEnabled(value == "stats");
+		});
+
+	void GPUProfiler::SetAveragingWindow(uint32_t numberOfSamples)
+	{
+		s_AveragingWindow = std::max(1u, numberOfSamples);
+	}
+
+	double GPUProfiler::Accumulate(double average, double sample, uint64_t numberOfSamples)
+	{
+		// numberOfSamples counts the new sample. Till the window fills up this is the plain mean.
+		double weight = double(std::min<uint64_t>(numberOfSamples, s_AveragingWindow));
+
+		return average + (sample - average) / weight;
+	}
+
+	void GPUProfiler::ReportTime(const std::string& scopeName, double milliseconds)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		GPUScopeStatistics& scope = s_Scopes[scopeName];
+
+		scope.m_Name = scopeName;
+		scope.m_NumberOfSamples++;
+		scope.m_LastMilliseconds = milliseconds;
+		scope.m_AverageMilliseconds = Accumulate(scope.m_AverageMilliseconds, milliseconds, scope.m_NumberOfSamples);
+	}
+
+	void GPUProfiler::ReportPipelineStatistics(const std::string& scopeName, const GPUPipelineStatistics& statistics)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		GPUScopeStatistics& scope = s_Scopes[scopeName];
+		uint64_t numberOfSamples = ++s_PipelineStatisticsSamples[scopeName];
+
+		GPUPipelineStatistics& average = scope.m_AveragePipelineStatistics;
+
+		average.m_VertexInvocations = uint64_t(Accumulate(double(average.m_VertexInvocations), double(statistics.m_VertexInvocations), numberOfSamples));
+		average.m_ClippingInvocations = uint64_t(Accumulate(double(average.m_ClippingInvocations), double(statistics.m_ClippingInvocations), numberOfSamples));
+		average.m_ClippingPrimitives = uint64_t(Accumulate(double(average.m_ClippingPrimitives), double(statistics.m_ClippingPrimitives), numberOfSamples));
+		average.m_FragmentInvocations = uint64_t(Accumulate(double(average.m_FragmentInvocations), double(statistics.m_FragmentInvocations), numberOfSamples));
+
+		scope.m_Name = scopeName;
+		scope.m_LastPipelineStatistics = statistics;
+		scope.m_bHasPipelineStatistics = true;
+	}
+
+	bool GPUProfiler::GetScopeStatistics(const std::string& scopeName, GPUScopeStatistics& statistics)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto found = s_Scopes.find(scopeName);
+		if (found == s_Scopes.end())
+		{
+			return false;
+		}
+
+		statistics = found->second;
+		return true;
+	}
+
+	std::vector<GPUScopeStatistics> GPUProfiler::GetAllScopeStatistics()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		std::vector<GPUScopeStatistics> scopes;
+		scopes.reserve(s_Scopes.size());
+
+		for (const auto& scope : s_Scopes)
+		{
+			scopes.push_back(scope.second);
+		}
+
+		return scopes;
+	}
+
+	void GPUProfiler::LogStatistics()
+	{
+		if (!s_bEnabled)
+		{
+			return;
+		}
+
+		std::vector<GPUScopeStatistics> scopes = GetAllScopeStatistics();
+
+		if (scopes.empty())
+		{
+			KR_CORE_INFO("GPU profile: no scope has been resolved (are timestamp queries supported?)");
+			return;
+		}
+
+		KR_CORE_INFO("+-------------------------------------------------");
+		KR_CORE_INFO("| GPU profile, averages over the last {0} samples:", s_AveragingWindow);
+		for (const GPUScopeStatistics& scope : scopes)
+		{
+			if (scope.m_bHasPipelineStatistics)
+			{
+				const GPUPipelineStatistics& statistics = scope.m_AveragePipelineStatistics;
+
+				KR_CORE_INFO("| {0}: {1:.3f} ms ({2} samples), vertices {3}, clipping in {4} out {5}, fragments {6}", scope.m_Name,
+					scope.m_AverageMilliseconds, scope.m_NumberOfSamples, statistics.m_VertexInvocations, statistics.m_ClippingInvocations,
+					statistics.m_ClippingPrimitives, statistics.m_FragmentInvocations);
+			}
+			else
+			{
+				KR_CORE_INFO("| {0}: {1:.3f} ms ({2} samples)", scope.m_Name, scope.m_AverageMilliseconds, scope.m_NumberOfSamples);
+			}
+		}
+		KR_CORE_INFO("+-------------------------------------------------");
+	}
+
+	void GPUProfiler::Reset()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		s_Scopes.clear();
+		s_PipelineStatisticsSamples.clear();
+	}
+}
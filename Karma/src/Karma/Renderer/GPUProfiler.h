@@ -0,0 +1,245 @@
+/**
+ * @file GPUProfiler.h
+ * @brief This file contains GPUProfiler class, the backend agnostic store of the GPU timings and pipeline statistics of named scopes.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <map>
+#include <mutex>
+
+namespace Karma
+{
+	/**
+	 * @brief Pipeline statistics of a scope, as counted by the GPU
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API GPUPipelineStatistics
+	{
+		/**
+		 * @brief Vertex shader invocations
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_VertexInvocations = 0;
+
+		/**
+		 * @brief Primitives which reached the clipping stage
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ClippingInvocations = 0;
+
+		/**
+		 * @brief Primitives which came out of the clipping stage
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ClippingPrimitives = 0;
+
+		/**
+		 * @brief Fragment shader invocations
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_FragmentInvocations = 0;
+	};
+
+	/**
+	 * @brief What is known of a named scope: the latest measurement and the running average over the last frames
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API GPUScopeStatistics
+	{
+		/**
+		 * @brief Name of the scope, for instance "Scene", "Opaque" or "KarmaGui"
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::string m_Name;
+
+		/**
+		 * @brief GPU time of the latest resolved frame, in milliseconds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_LastMilliseconds = 0.0;
+
+		/**
+		 * @brief GPU time averaged over GPUProfiler::GetAveragingWindow frames, in milliseconds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_AverageMilliseconds = 0.0;
+
+		/**
+		 * @brief Number of timings received
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfSamples = 0;
+
+		/**
+		 * @brief Whether the m_*PipelineStatistics hold a measurement
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bHasPipelineStatistics = false;
+
+		/**
+		 * @brief Pipeline statistics of the latest resolved frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		GPUPipelineStatistics m_LastPipelineStatistics;
+
+		/**
+		 * @brief Pipeline statistics averaged like the timings
+		 *
+		 * @since Karma 1.0.0
+		 */
+		GPUPipelineStatistics m_AveragePipelineStatistics;
+	};
+
+	/**
+	 * @brief Gathers what the backend profilers (VulkanGPUProfiler, OpenGLGPUProfiler and the per pass queries of VulkanParallelRecorder) measure,
+	 * keyed by scope name. The backends record timestamp queries around their scopes into a ring of per frame query sets and hand the results
+	 * over once a set comes round again and its results are available, so the CPU never waits on the GPU for them. The numbers thus lag the
+	 * frame by the frames in flight.
+	 *
+	 * The averages are running means over the last GetAveragingWindow samples (a plain mean till that many have come).
+	 *
+	 * Off by default, --gpu-profile turns the timings on and --gpu-profile=stats the pipeline statistics as well (see CommandLine).
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API GPUProfiler
+	{
+	public:
+		/**
+		 * @brief Turns the timestamp queries of the backends on or off. Takes effect from the next frame.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SetEnabled(bool bEnabled) { s_bEnabled = bEnabled; }
+
+		/**
+		 * @brief Whether the backends should record the timestamp queries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsEnabled() { return s_bEnabled; }
+
+		/**
+		 * @brief Turns the pipeline statistics queries (vertex, clipping and fragment invocations) of the scopes on or off. Only honoured
+		 * while profiling is enabled, and where the device supports them (Vulkan pipelineStatisticsQuery, OpenGL 4.6).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SetPipelineStatisticsEnabled(bool bEnabled) { s_bPipelineStatisticsEnabled = bEnabled; }
+
+		/**
+		 * @brief Whether the backends should record the pipeline statistics queries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsPipelineStatisticsEnabled() { return s_bEnabled && s_bPipelineStatisticsEnabled; }
+
+		/**
+		 * @brief Number of samples the averages run over
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SetAveragingWindow(uint32_t numberOfSamples);
+
+		/**
+		 * @brief Getter for the number of samples the averages run over
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetAveragingWindow() { return s_AveragingWindow; }
+
+		/**
+		 * @brief Hands over a resolved timing of the scope. Called by the backends, from whichever thread resolves their queries.
+		 *
+		 * @param scopeName					Name of the scope
+		 * @param milliseconds				GPU time between the scope's begin and end timestamps
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReportTime(const std::string& scopeName, double milliseconds);
+
+		/**
+		 * @brief Hands over resolved pipeline statistics of the scope. Called by the backends.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReportPipelineStatistics(const std::string& scopeName, const GPUPipelineStatistics& statistics);
+
+		/**
+		 * @brief What is known of the scope
+		 *
+		 * @param scopeName					Name of the scope
+		 * @param statistics				Filled if the scope has been reported
+		 *
+		 * @return false if nothing has been reported for the scope yet
+		 * @since Karma 1.0.0
+		 */
+		static bool GetScopeStatistics(const std::string& scopeName, GPUScopeStatistics& statistics);
+
+		/**
+		 * @brief All the scopes reported so far, by name
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static std::vector<GPUScopeStatistics> GetAllScopeStatistics();
+
+		/**
+		 * @brief Logs the averages of every scope, if profiling is enabled
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void LogStatistics();
+
+		/**
+		 * @brief Forgets all the scopes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Reset();
+
+	public:
+		/**
+		 * @brief Most scopes a backend profiler records per frame, the query pools are sized for that many
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_MaxScopesPerFrame = 32;
+
+	private:
+		/**
+		 * @brief Running mean over the window, the newest sample replacing the share of an average one
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static double Accumulate(double average, double sample, uint64_t numberOfSamples);
+
+	private:
+		static bool s_bEnabled;
+		static bool s_bPipelineStatisticsEnabled;
+		static uint32_t s_AveragingWindow;
+
+		// Reported by the render thread (or whoever resolves the queries), read by the game thread
+		static std::mutex s_Mutex;
+		static std::map<std::string, GPUScopeStatistics> s_Scopes;
+
+		// The samples the pipeline statistics of each scope are averaged over, counted apart from the timings
+		static std::map<std::string, uint64_t> s_PipelineStatisticsSamples;
+	};
+}
@@ -2,7 +2,7 @@
 
 namespace Karma
 {
-	Material::Material() : m_MainCamera(nullptr)
+	Material::Material() : m_MainCamera(nullptr), m_WorldMatrix(1.0f)
 	{
 	}
 
@@ -13,10 +13,35 @@ namespace Karma
 			UBODataPointer uProjection(&m_MainCamera->GetProjectionMatrix());
 			UBODataPointer uView(&m_MainCamera->GetViewMatirx());
 
+			UBODataPointer uWorld(&m_WorldMatrix);
+
 			// Hack for now
 			for (const auto& elem : m_Shaders)
 			{
-				elem->GetUniformBufferObject()->UpdateUniforms(uProjection, uView);
+				std::shared_ptr<UniformBufferObject> ubo = elem->GetUniformBufferObject();
+
+				if (m_bSkinned && ubo->GetUniformDataType().size() > 3)
+				{
+					// Skinned, the bone matrices follow the world matrix
+					static const glm::mat4 s_IdentityMatrix(1.0f);
+
+					m_SkinnedUniforms = { uProjection, uView, uWorld };
+
+					for (uint32_t bone = 0; bone < uint32_t(ubo->GetUniformDataType().size()) - 3; bone++)
+					{
+						m_SkinnedUniforms.push_back(UBODataPointer(bone < m_NumberOfBoneMatrices ? &m_BoneMatrices[bone] : &s_IdentityMatrix));
+					}
+
+					ubo->SetUniformList(m_SkinnedUniforms);
+				}
+				else if (ubo->GetUniformDataType().size() >= 3)
+				{
+					ubo->UpdateUniforms(uProjection, uView, uWorld);
+				}
+				else
+				{
+					ubo->UpdateUniforms(uProjection, uView);
+				}
 			}
 		}
 		else
@@ -34,12 +59,21 @@ namespace Karma
 	{
 		// Hack for now. We shall systematically deal with this as complexity of Material increases
 
+		// A material may come without textures, then there is no sampler to point at unit 0 (an unknown name is skipped)
+		const std::string textureShaderName = m_Textures.empty() ? std::string() : m_Textures.front()->GetTextureShaderName();
+
 		for (const auto& elem : m_Shaders)
 		{
 			// Again hacky way.
-			elem->Bind(m_Textures.front()->GetTextureShaderName());
+			elem->Bind(textureShaderName);
 			elem->GetUniformBufferObject()->UploadUniformBuffer();
 		}
+
+		// The shaders sample unit 0 (OpenGLShader::Bind)
+		if (!m_Textures.empty())
+		{
+			m_Textures.front()->Bind(0);
+		}
 	}
 
 	std::shared_ptr<Shader> Material::GetShader(const std::string& shaderName) const
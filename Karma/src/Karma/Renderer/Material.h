@@ -57,6 +57,49 @@ namespace Karma
 		 */
 		void AttatchMainCamera(std::shared_ptr<Camera> mCamera);
 
+		/**
+		 * @brief Sets the object to world matrix of the next draw. Shaders whose uniform buffer object has a third uniform (a Mat4 after
+		 * projection and view) receive it, the others are unaffected.
+		 *
+		 * @see Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		void SetWorldMatrix(const glm::mat4& worldMatrix) { m_WorldMatrix = worldMatrix; }
+
+		/**
+		 * @brief Getter for the object to world matrix
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const glm::mat4& GetWorldMatrix() const { return m_WorldMatrix; }
+
+		/**
+		 * @brief Sets the bone matrices of the next draw. If the material is skinned (SetSkinned), the Mat4s of its shaders' uniform buffer
+		 * objects past the world matrix (skinned.vert, see SkeletalMesh::GetSkinnedUniformTypes) receive them, identity for the ones past
+		 * numberOfBones.
+		 *
+		 * @param boneMatrices					Anuprana::GetSkinMatrices, kept alive by the caller till the uniforms are uploaded
+		 * @param numberOfBones					Number of them
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetBoneMatrices(const glm::mat4* boneMatrices, uint32_t numberOfBones) { m_BoneMatrices = boneMatrices; m_NumberOfBoneMatrices = numberOfBones; }
+
+		/**
+		 * @brief Marks the material as skinned, its shaders reading the bone matrices (SetBoneMatrices) after projection, view and world.
+		 * The uniforms past the world matrix of the shaders of other materials are left alone.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetSkinned(bool bSkinned) { m_bSkinned = bSkinned; }
+
+		/**
+		 * @brief Whether the material's shaders take the bone matrices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsSkinned() const { return m_bSkinned; }
+
 		/**
 		 * @brief Add to the list of shaders used by this material
 		 *
@@ -107,6 +150,37 @@ namespace Karma
 		 */
 		std::shared_ptr<Texture> GetTexture(int index);
 
+		/**
+		 * @brief Getter for the texture list
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::list<std::shared_ptr<Texture>>& GetTextures() const { return m_Textures; }
+
+		/**
+		 * @brief Identity of the material in RenderSortKey
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetSortID() const { return m_SortID; }
+
+		/**
+		 * @brief Marks the material as transparent. Its draws then go to the transparent pass, drawn back to front after the opaque ones,
+		 * blended and without depth writes.
+		 *
+		 * @note Backends with baked pipeline state (Vulkan) read the flag when the pipeline is made, so set it before VertexArray::SetMaterial
+		 * @see RenderPassType, Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		void SetTransparent(bool bTransparent) { m_bTransparent = bTransparent; }
+
+		/**
+		 * @brief Whether the material is drawn in the transparent pass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsTransparent() const { return m_bTransparent; }
+
 		// May add Physics-relevant features in future.
 
 	private:
@@ -115,5 +189,18 @@ namespace Karma
 		std::list<std::shared_ptr<Texture>> m_Textures;
 
 		std::shared_ptr<Camera> m_MainCamera;
+
+		glm::mat4 m_WorldMatrix;
+
+		const glm::mat4* m_BoneMatrices = nullptr;
+		uint32_t m_NumberOfBoneMatrices = 0;
+
+		// The uniforms of a skinned draw, made again each OnUpdate
+		std::vector<UBODataPointer> m_SkinnedUniforms;
+
+		uint32_t m_SortID = RenderSortKey::NextSortID();
+
+		bool m_bTransparent = false;
+		bool m_bSkinned = false;
 	};
 }
@@ -1,5 +1,12 @@
 #include "Mesh.h"
 #include "RenderCommand.h"
+#include "CookedMesh.h"
+#include "ModelImporter.h"
+#include "MeshOptimizer.h"
+#include "VertexConversionProgram.h"
+#include "Karma/JobPool.h"
+#include "Karma/CommandLine.h"
+#include <chrono>
 
 namespace Karma
 {
@@ -7,6 +14,11 @@ namespace Karma
 	// Make sure to add elements to dictionary for vertex attribute extension
 	std::shared_ptr<std::unordered_map<std::string, MeshAttribute>> Mesh::m_NameToAttributeDictionary = std::make_shared<std::unordered_map<std::string, MeshAttribute>>();
 
+	bool Mesh::s_bCookedMeshesAllowed = true;
+
+	static CommandLineOption s_CookedMeshesOption("cooked-meshes", "--cooked-meshes=off imports the models with Assimp instead of loading their cooked files",
+		[](const std::string& value) { Mesh::SetCookedMeshesAllowed(value != "off"); });
+
 	Mesh::Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer, const std::string& meshName,
 		MeshType mType)
 	{
@@ -34,29 +46,182 @@ namespace Karma
 
 		m_MeshName = meshName;
 		m_MeshType = mType;
+
+		// No vertex data at hand
+		m_Bounds = RenderBounds::Unbounded();
+	}
+
+	Mesh::Mesh(const std::string& meshName, MeshType mType)
+	{
+		InitializeAttributeDictionary();
+
+		m_MeshName = meshName;
+		m_MeshType = mType;
+		m_Bounds = RenderBounds::Unbounded();
 	}
 
 	Mesh::Mesh(const std::string& filePath)
 	{
 		InitializeAttributeDictionary();
 
-		Assimp::Importer assImporter;
+		m_Bounds = RenderBounds::Unbounded();
+		m_MeshName = filePath;
+		m_MeshType = MeshType::Mesh;
+
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		const bool bFlipUVs = RendererAPI::GetAPI() == RendererAPI::API::Vulkan;
+
+		if (s_bCookedMeshesAllowed && LoadCooked(filePath, bFlipUVs))
+		{
+			KR_CORE_INFO("Mesh {0} loaded from the cooked file in {1} ms", filePath,
+				std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count());
+			return;
+		}
+
+		ImportedModel model;
+
+		if (!ModelImporter::Import(filePath, bFlipUVs, model, &JobPool::GetLoadingPool()))
+		{
+			return;
+		}
+
+		MeshOptimizationStatistics optimizationStatistics;
+		MeshOptimizer::Optimize(model, MeshOptimizer::GetDefaultSettings(), &JobPool::GetLoadingPool(), &optimizationStatistics);
+		MeshOptimizer::LogStatistics(filePath, optimizationStatistics);
+
+		m_VertexBuffer.reset(VertexBuffer::Create(reinterpret_cast<float*>(model.m_VertexData.data()), uint32_t(model.m_VertexData.size())));
+		m_VertexBuffer->SetLayout(model.m_Layout);
+		m_VertexDataSize = model.m_VertexData.size();
+
+		m_IndexBuffer.reset(model.CreateIndexBuffer());
+
+		m_Submeshes = std::move(model.m_Submeshes);
+		m_Bounds = model.m_Bounds;
+
+		for (ImportedLOD& lod : model.m_LODs)
+		{
+			AddLOD(lod.CreateIndexBuffer(), lod.m_Error);
+		}
+
+		KR_CORE_INFO("Mesh {0} ({1} submeshes) imported with Assimp in {2} ms", filePath, m_Submeshes.size(),
+			std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count());
+	}
+
+	bool Mesh::LoadCooked(const std::string& filePath, bool bFlipUVs)
+	{
+		const std::string cookedPath = CookedMesh::GetCookedPath(filePath);
+
+		CookedMesh cookedMesh;
+
+		// Stale, of another version, flipped otherwise or corrupted: cook afresh
+		if (!CookedMesh::IsUpToDate(filePath, cookedPath) || !cookedMesh.Load(cookedPath, bFlipUVs))
+		{
+			if (!CookedMesh::Cook(filePath, cookedPath, bFlipUVs) || !cookedMesh.Load(cookedPath, bFlipUVs))
+			{
+				KR_CORE_WARN("Mesh {0} couldn't be cooked, importing it with Assimp", filePath);
+				return false;
+			}
+		}
+
+		// The whole of the model, straight from the mapping. The buffers copy (or stage) the data before the mapping goes.
+		m_VertexBuffer.reset(VertexBuffer::Create(cookedMesh.GetVertexData(), cookedMesh.GetVertexDataSize()));
+		m_VertexBuffer->SetLayout(cookedMesh.GetLayout());
+		m_VertexDataSize = cookedMesh.GetVertexDataSize();
+
+		m_IndexBuffer.reset(cookedMesh.CreateIndexBuffer());
+
+		m_Submeshes.clear();
+		for (uint32_t counter = 0; counter < cookedMesh.GetNumberOfSubmeshes(); counter++)
+		{
+			const CookedSubmesh& cookedSubmesh = cookedMesh.GetSubmesh(counter);
+
+			Submesh submesh;
+			submesh.m_FirstVertex = cookedSubmesh.m_FirstVertex;
+			submesh.m_NumberOfVertices = cookedSubmesh.m_NumberOfVertices;
+			submesh.m_FirstIndex = cookedSubmesh.m_FirstIndex;
+			submesh.m_NumberOfIndices = cookedSubmesh.m_NumberOfIndices;
+			submesh.m_MaterialIndex = cookedSubmesh.m_MaterialIndex;
+			submesh.m_Bounds = cookedMesh.GetBounds(counter);
+
+			m_Submeshes.push_back(submesh);
+		}
+
+		m_Bounds = cookedMesh.GetBounds();
+
+		m_LODs.clear();
+		for (uint32_t counter = 0; counter < cookedMesh.GetNumberOfLODs(); counter++)
+		{
+			AddLOD(cookedMesh.CreateLODIndexBuffer(counter), cookedMesh.GetLOD(counter).m_Error);
+		}
+
+		return true;
+	}
 
-		uint32_t importFlags = aiProcess_Triangulate;
+	bool Mesh::Prepare(const std::string& filePath)
+	{
+		if (!std::filesystem::exists(filePath))
+		{
+			return false;
+		}
 
-		if(RenderCommand::GetRendererAPI()->GetAPI() == RendererAPI::API::Vulkan)
+		if (!s_bCookedMeshesAllowed)
 		{
-			importFlags = importFlags | aiProcess_FlipUVs;
+			return true;
 		}
 
-		const aiScene* scene = assImporter.ReadFile(filePath, importFlags);
+		const std::string cookedPath = CookedMesh::GetCookedPath(filePath);
 
-		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		// Failing here, the constructor falls back to Assimp
+		if (!CookedMesh::IsUpToDate(filePath, cookedPath))
 		{
-			KR_CORE_ERROR("ERROR ASSIMP:: {0}", assImporter.GetErrorString());
+			CookedMesh::Cook(filePath, cookedPath, RendererAPI::GetAPI() == RendererAPI::API::Vulkan);
 		}
 
-		ProcessNode(scene->mRootNode, scene);
+		return true;
+	}
+
+	uint64_t Mesh::GetMemorySize() const
+	{
+		uint64_t bytes = m_VertexDataSize;
+
+		if (m_IndexBuffer)
+		{
+			bytes += uint64_t(m_IndexBuffer->GetCount()) * (m_IndexBuffer->GetIndexType() == IndexType::UInt16 ? 2 : 4);
+		}
+
+		// The levels of detail share the vertex buffer
+		for (const MeshLOD& lod : m_LODs)
+		{
+			bytes += lod.m_Mesh->GetMemorySize();
+		}
+
+		return bytes;
+	}
+
+	void Mesh::SwapContents(Mesh& other)
+	{
+		std::swap(m_VertexBuffer, other.m_VertexBuffer);
+		std::swap(m_IndexBuffer, other.m_IndexBuffer);
+		std::swap(m_Bounds, other.m_Bounds);
+		std::swap(m_Submeshes, other.m_Submeshes);
+		std::swap(m_LODs, other.m_LODs);
+		std::swap(m_VertexDataSize, other.m_VertexDataSize);
+
+		m_Generation++;
+	}
+
+	void Mesh::AddLOD(IndexBuffer* indexBuffer, float error)
+	{
+		std::shared_ptr<IndexBuffer> lodIndexBuffer(indexBuffer);
+
+		MeshLOD lod;
+		lod.m_Mesh.reset(new Mesh(m_VertexBuffer, lodIndexBuffer, m_MeshName + "_LOD" + std::to_string(m_LODs.size() + 1), m_MeshType));
+		lod.m_Mesh->SetBounds(m_Bounds);
+		lod.m_Error = error;
+		lod.m_NumberOfTriangles = lodIndexBuffer->GetCount() / 3;
+
+		m_LODs.push_back(lod);
 	}
 
 	void Mesh::ProcessNode(aiNode* nodeToProcess, const aiScene* theScene)
@@ -98,10 +263,14 @@ namespace Karma
 
 		iBuffer.reset(IndexBuffer::Create(indexData, indexDataLength));
 
+		// Position is the first element of the layout (see GaugeVertexDataLayout)
+		RenderBounds bounds = RenderBounds::FromPositions(vertexData, meshToProcess->mNumVertices, layout.GetStride() / sizeof(float));
+
 		delete[] vertexData;
 		delete[] indexData;
 
 		productMesh.reset(new Mesh(vBuffer, iBuffer, mName));
+		productMesh->SetBounds(bounds);
 
 		return productMesh;
 	}
@@ -117,9 +286,12 @@ namespace Karma
 
 		m_VertexBuffer.reset(VertexBuffer::Create(vertexData, vertexDataSize));
 		m_VertexBuffer->SetLayout(layout);
+		m_VertexDataSize = vertexDataSize;
 
 		m_IndexBuffer.reset(IndexBuffer::Create(indexData, indexDataLength));
 
+		m_Bounds = RenderBounds::FromPositions(vertexData, meshToProcess->mNumVertices, layout.GetStride() / sizeof(float));
+
 		delete[] vertexData;
 		delete[] indexData;
 	}
@@ -150,25 +322,11 @@ namespace Karma
 
 		indexData = new uint32_t[indexDataLength];
 
-		uint32_t counter = 0;
-
-		// We are assuming that primitive types are only triangles
-		// See aiMesh structure for relevant information
-		for (unsigned int i = 0; i < meshToProcess->mNumVertices; i++)
-		{
-			// Now, based on the gauged layout, we interleave all of the
-			// attributes
-			for (const auto& layoutElem : buffLayout.GetElements())
-			{
-				for (uint32_t j = 0; j < layoutElem.GetComponentCount(); j++)
-				{
-					vertexData[counter++] = LayoutElementToAttributeValue(i, j, meshToProcess, layoutElem);
-				}
-			}
-
-		}
+		// The layout is resolved once, and the attributes copied stream by stream
+		VertexConversionProgram conversionProgram(buffLayout);
+		conversionProgram.Convert(meshToProcess, vertexData);
 
-		counter = 0;
+		uint32_t counter = 0;
 
 		for (unsigned int i = 0; i < meshToProcess->mNumFaces; i++)
 		{
@@ -311,10 +469,25 @@ namespace Karma
 	{
 		if (m_NameToAttributeDictionary->empty())
 		{
+			m_NameToAttributeDictionary->insert({ "v_Position", MeshAttribute::Vertices });
 			m_NameToAttributeDictionary->insert({ "v_UV", MeshAttribute::TextureCoords });
 			m_NameToAttributeDictionary->insert({ "v_Color", MeshAttribute::Colors });
 			m_NameToAttributeDictionary->insert({ "v_Normal", MeshAttribute::Normals });
 			m_NameToAttributeDictionary->insert({ "v_Tangent", MeshAttribute::Tangents });
 		}
 	}
+
+	bool Mesh::GetAttributeOfElement(const std::string& elementName, MeshAttribute& attribute)
+	{
+		auto attributeIterator = m_NameToAttributeDictionary->find(elementName);
+
+		if (attributeIterator == m_NameToAttributeDictionary->end())
+		{
+			return false;
+		}
+
+		attribute = attributeIterator->second;
+
+		return true;
+	}
 }
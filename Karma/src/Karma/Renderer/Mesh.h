@@ -13,6 +13,7 @@
 #include "krpch.h"
 
 #include "Buffer.h"
+#include "RenderScene.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -48,6 +49,65 @@ namespace Karma
 		AnimMeshes
 	};
 	
+	/**
+	 * @brief A range of the vertex and index buffers of a Mesh, one per mesh (and node referring to it) of the model file
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API Submesh
+	{
+		/**
+		 * @brief Name of the mesh in the model file
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::string m_Name;
+
+		uint32_t m_FirstVertex = 0;
+		uint32_t m_NumberOfVertices = 0;
+
+		/**
+		 * @brief First index in the index buffer. The indices point into the whole of the vertex buffer, not from m_FirstVertex.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_FirstIndex = 0;
+		uint32_t m_NumberOfIndices = 0;
+
+		/**
+		 * @brief Material index of the mesh in the model file
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_MaterialIndex = 0;
+
+		/**
+		 * @brief Bounds, in the space of the model (the node transforms applied)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds m_Bounds;
+	};
+
+	/**
+	 * @brief A level of detail of a Mesh, a Mesh of its own sharing the vertex buffer with simplified indices (MeshSimplifier)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API MeshLOD
+	{
+		std::shared_ptr<Mesh> m_Mesh;
+
+		/**
+		 * @brief Largest distance, in the space of the model, of the simplified surface from the full one
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Error = 0.0f;
+
+		uint32_t m_NumberOfTriangles = 0;
+	};
+
 	/**
 	 * @brief An organized collection of vertex and index buffers along with rest of the model specific information which includes colors, texture coordinates
 	 * and perhaps animation attributes.
@@ -57,6 +117,15 @@ namespace Karma
 	public:
 		Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer, const std::string& meshName = "NoName",
 			MeshType mType = MeshType::Mesh);
+
+		/**
+		 * @brief Loads the whole of the model (every submesh, see ModelImporter) from its cooked file (CookedMesh), cooking it first if
+		 * there is none or it is stale. Imports it with Assimp if cooking fails or cooked meshes aren't allowed (SetCookedMeshesAllowed).
+		 *
+		 * @param filePath						The model file
+		 *
+		 * @since Karma 1.0.0
+		 */
 		Mesh(const std::string& filePath);
 
 		virtual void ProcessMesh(aiMesh* meshToProcess);
@@ -86,6 +155,11 @@ namespace Karma
 		static void DealVertexIndexBufferData(float*& vertexData, uint32_t& vertexDataSize, uint32_t*& indexData, uint32_t& indexDataLength,
 			aiMesh* meshToProcess, BufferLayout& buffLayout);
 
+		/**
+		 * @brief Processes (ProcessMesh) the first mesh found in the nodes, the rest of the model is left out. ModelImporter imports all of it.
+		 *
+		 * @since Karma 1.0.0
+		 */
 		void ProcessNode(aiNode* nodeToProcess, const aiScene* theScene);
 
 		/**
@@ -104,10 +178,123 @@ namespace Karma
 		void SetVertexBuffer(std::shared_ptr<VertexBuffer> vBuffer) { m_VertexBuffer = vBuffer; }
 		void SetIndexBuffer(std::shared_ptr<IndexBuffer> iBuffer) { m_IndexBuffer = iBuffer; }
 
+		/**
+		 * @brief Getter for the object space bounds. Computed from the vertex positions for meshes processed from Assimp, unbounded
+		 * (never culled) for meshes made from bare buffers unless set with SetBounds.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const RenderBounds& GetBounds() const { return m_Bounds; }
+
+		/**
+		 * @brief Setter for the object space bounds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetBounds(const RenderBounds& bounds) { m_Bounds = bounds; }
+
+		/**
+		 * @brief Ranges of the buffers, one per mesh of the model file. Empty for meshes made from bare buffers or ProcessMesh.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
+
+		/**
+		 * @brief The levels of detail past this mesh, from the finest to the coarsest. Empty unless the mesh was loaded from a model file
+		 * with MeshOptimizationSettings::m_NumberOfLODs set.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<MeshLOD>& GetLODs() const { return m_LODs; }
+
+		/**
+		 * @brief Number of triangles of the index buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfTriangles() const { return m_IndexBuffer ? m_IndexBuffer->GetCount() / 3 : 0; }
+
+		/**
+		 * @brief Allows (default) or forbids the cooked meshes, for comparison with the Assimp import
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetCookedMeshesAllowed(bool bAllowed) { s_bCookedMeshesAllowed = bAllowed; }
+
+		/**
+		 * @brief The CPU side of loading the model file, which may run on any thread ahead of the constructor: cooks it (CookedMesh) if
+		 * the cooked file is missing or stale, so that the constructor only maps it. Nothing to do if cooked meshes aren't allowed.
+		 *
+		 * @param filePath						The model file
+		 *
+		 * @return false if there is no model file
+		 * @see AssetManager
+		 * @since Karma 1.0.0
+		 */
+		static bool Prepare(const std::string& filePath);
+
+		/**
+		 * @brief Bytes of the vertex data and of the indices of the mesh and its levels of detail, as they are on the GPU. The vertex data
+		 * of a mesh made from bare buffers is not known and not counted.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetMemorySize() const;
+
+		/**
+		 * @brief Swaps the buffers, bounds, submeshes and levels of detail with the ones of other, a mesh made from the reloaded file, and
+		 * counts a generation. The old buffers go with other, or with the last vertex array still holding them.
+		 *
+		 * @see AssetManager::SetHotReloadEnabled
+		 * @since Karma 1.0.0
+		 */
+		void SwapContents(Mesh& other);
+
+		/**
+		 * @brief Number of SwapContents so far, for the vertex arrays to tell that their buffers are stale (VertexArray::RefreshReloadedAssets)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetGeneration() const { return m_Generation; }
+
 		// Useful dictionary related functions
 		static float LayoutElementToAttributeValue(unsigned int vertexNumber, uint32_t counter, aiMesh* meshToProcess, const BufferElement& layoutElem);
 		static void InitializeAttributeDictionary();
 
+		/**
+		 * @brief Looks up the attribute a layout element (by its name, v_Position and all that) is interleaved from
+		 *
+		 * @return false if the name is not in the dictionary
+		 * @since Karma 1.0.0
+		 */
+		static bool GetAttributeOfElement(const std::string& elementName, MeshAttribute& attribute);
+
+	protected:
+		/**
+		 * @brief A constructor for the subclasses making their buffers themselves (SkeletalMesh), the mesh unbounded and without
+		 * buffers till then
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Mesh(const std::string& meshName, MeshType mType);
+
+		/**
+		 * @brief Fills the buffers and bounds from the cooked file of filePath
+		 *
+		 * @return false if there is no usable cooked file and none could be cooked
+		 * @since Karma 1.0.0
+		 */
+		bool LoadCooked(const std::string& filePath, bool bFlipUVs);
+
+		/**
+		 * @brief Appends a level of detail drawing the index buffer over this mesh's vertex buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void AddLOD(IndexBuffer* indexBuffer, float error);
+
 	protected:
 		std::shared_ptr<VertexBuffer> m_VertexBuffer;
 		std::shared_ptr<IndexBuffer> m_IndexBuffer;
@@ -115,6 +302,19 @@ namespace Karma
 		std::string m_MeshName;
 		MeshType m_MeshType;
 
+		RenderBounds m_Bounds;
+
+		std::vector<Submesh> m_Submeshes;
+
+		std::vector<MeshLOD> m_LODs;
+
+		// Bytes of the vertex buffer, if made by the mesh
+		uint64_t m_VertexDataSize = 0;
+
+		uint32_t m_Generation = 0;
+
 		static std::shared_ptr<std::unordered_map<std::string, MeshAttribute>> m_NameToAttributeDictionary;
+
+		static bool s_bCookedMeshesAllowed;
 	};
 }
@@ -0,0 +1,967 @@
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Karma/JobPool.h"
+#include "Karma/CommandLine.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Karma
+{
+	MeshOptimizationSettings MeshOptimizer::s_DefaultSettings;
+
+	static CommandLineOption s_MeshOptimizeOption("mesh-optimize", "--mesh-optimize=off|on|quantize|quantize-octahedral picks the optimization the loaded (and cooked) models go through",
+		[](const std::string& value)
+		{
+			MeshOptimizationSettings settings;
+
+			// The levels of detail are --mesh-lods' business
+			settings.m_NumberOfLODs = MeshOptimizer::GetDefaultSettings().m_NumberOfLODs;
+
+			if (value == "off")
+			{
+				settings.m_bWeldVertices = false;
+				settings.m_bOptimizeVertexCache = false;
+				settings.m_bOptimizeOverdraw = false;
+				settings.m_bOptimizeVertexFetch = false;
+				settings.m_bAllowShortIndices = false;
+				settings.m_NumberOfLODs = 0;
+			}
+			else if (value == "quantize" || value == "quantize-octahedral")
+			{
+				// The octahedral normals need the shaders to decode them (MeshOptimizer::EncodeOctahedral)
+				settings.m_bQuantize = true;
+				settings.m_NormalEncoding = value == "quantize" ? NormalEncoding::SNorm8 : NormalEncoding::Octahedral;
+			}
+			else if (value != "on")
+			{
+				KR_CORE_WARN("Unknown mesh optimization {0} asked for, keeping the default one", value);
+				return;
+			}
+
+			MeshOptimizer::SetDefaultSettings(settings);
+		});
+
+	static CommandLineOption s_MeshLODsOption("mesh-lods", "--mesh-lods=N sets the number of levels of detail generated for the models (0 for none)",
+		[](const std::string& value)
+		{
+			MeshOptimizationSettings settings = MeshOptimizer::GetDefaultSettings();
+			settings.m_NumberOfLODs = std::min(uint32_t(CommandLine::ParseNumber(value, 0)), 15u);
+
+			MeshOptimizer::SetDefaultSettings(settings);
+		});
+
+	namespace
+	{
+		// Forsyth's constants, the cache modelled for the ordering is larger than the one of the statistics (it only needs to be about right)
+		constexpr uint32_t s_ForsythCacheSize = 32;
+		constexpr float s_CacheDecayPower = 1.5f;
+		constexpr float s_LastTriangleScore = 0.75f;
+		constexpr float s_ValenceBoostScale = 2.0f;
+		constexpr float s_ValenceBoostPower = 0.5f;
+
+		// A submesh, optimized apart from the shared data
+		struct OptimizedSubmesh
+		{
+			std::vector<uint8_t> m_VertexData;
+			std::vector<uint32_t> m_Indices;
+			uint32_t m_NumberOfVertices = 0;
+			RenderBounds m_Bounds;
+		};
+
+		float ComputeVertexScore(int32_t cachePosition, uint32_t remainingValence)
+		{
+			if (remainingValence == 0)
+			{
+				// No triangle left to use it
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+
+			if (cachePosition >= 0)
+			{
+				if (cachePosition < 3)
+				{
+					// Used by the last triangle, a fixed score so that strips don't simply go on forever
+					score = s_LastTriangleScore;
+				}
+				else
+				{
+					const float scaler = 1.0f / float(s_ForsythCacheSize - 3);
+					score = std::pow(1.0f - float(cachePosition - 3) * scaler, s_CacheDecayPower);
+				}
+			}
+
+			// Vertices with few triangles left are finished off first, so that they don't stay around
+			score += s_ValenceBoostScale * std::pow(float(remainingValence), -s_ValenceBoostPower);
+
+			return score;
+		}
+
+		uint32_t HashVertex(const uint8_t* vertex, uint32_t vertexStride)
+		{
+			uint32_t hash = 2166136261u;
+
+			for (uint32_t counter = 0; counter < vertexStride; counter += sizeof(uint32_t))
+			{
+				uint32_t word;
+				memcpy(&word, vertex + counter, sizeof(word));
+
+				hash = (hash ^ word) * 16777619u;
+			}
+
+			return hash;
+		}
+
+		int8_t ToSNorm8(float value)
+		{
+			return int8_t(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+		}
+
+		uint8_t ToUNorm8(float value)
+		{
+			return uint8_t(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+
+		int16_t ToSNorm16(float value)
+		{
+			return int16_t(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+		}
+
+		// The packed type of a float element, or the element as it is
+		BufferElement QuantizeElement(const BufferElement& layoutElem, const MeshOptimizationSettings& settings)
+		{
+			if (layoutElem.Name == "v_UV" && layoutElem.Type == ShaderDataType::Float2)
+			{
+				return BufferElement(ShaderDataType::Half2, layoutElem.Name);
+			}
+			if (layoutElem.Name == "v_Color" && layoutElem.Type == ShaderDataType::Float4)
+			{
+				return BufferElement(ShaderDataType::UByte4Norm, layoutElem.Name, true);
+			}
+			if ((layoutElem.Name == "v_Normal" || layoutElem.Name == "v_Tangent") && layoutElem.Type == ShaderDataType::Float3)
+			{
+				switch (settings.m_NormalEncoding)
+				{
+					case NormalEncoding::SNorm8:
+						return BufferElement(ShaderDataType::Byte4Norm, layoutElem.Name, true);
+					case NormalEncoding::Octahedral:
+						return BufferElement(ShaderDataType::Short2Norm, layoutElem.Name, true);
+					default:
+						break;
+				}
+			}
+
+			return BufferElement(layoutElem.Type, layoutElem.Name, layoutElem.Normalized);
+		}
+
+		void QuantizeAttribute(const float* source, const BufferElement& packedElement, uint8_t* destination)
+		{
+			switch (packedElement.Type)
+			{
+				case ShaderDataType::Half2:
+				{
+					uint16_t halves[2] = { MeshOptimizer::FloatToHalf(source[0]), MeshOptimizer::FloatToHalf(source[1]) };
+					memcpy(destination, halves, sizeof(halves));
+					break;
+				}
+				case ShaderDataType::UByte4Norm:
+				{
+					for (uint32_t component = 0; component < 4; component++)
+					{
+						destination[component] = ToUNorm8(source[component]);
+					}
+					break;
+				}
+				case ShaderDataType::Byte4Norm:
+				{
+					// The fourth byte is padding, read as 0
+					int8_t packed[4] = { ToSNorm8(source[0]), ToSNorm8(source[1]), ToSNorm8(source[2]), 0 };
+					memcpy(destination, packed, sizeof(packed));
+					break;
+				}
+				case ShaderDataType::Short2Norm:
+				{
+					float encoded[2];
+					MeshOptimizer::EncodeOctahedral(source, encoded);
+
+					int16_t packed[2] = { ToSNorm16(encoded[0]), ToSNorm16(encoded[1]) };
+					memcpy(destination, packed, sizeof(packed));
+					break;
+				}
+				default:
+					memcpy(destination, source, packedElement.Size);
+					break;
+			}
+		}
+
+		void Quantize(ImportedModel& model, const MeshOptimizationSettings& settings)
+		{
+			BufferLayout packedLayout;
+
+			for (const BufferElement& layoutElem : model.m_Layout.GetElements())
+			{
+				packedLayout.PushElement(QuantizeElement(layoutElem, settings));
+			}
+
+			const uint32_t stride = model.m_Layout.GetStride();
+			const uint32_t packedStride = packedLayout.GetStride();
+
+			if (packedStride == stride)
+			{
+				// Nothing to pack (say, positions only)
+				return;
+			}
+
+			std::vector<uint8_t> packedData(size_t(model.m_NumberOfVertices) * packedStride);
+
+			const std::vector<BufferElement>& elements = model.m_Layout.GetElements();
+			const std::vector<BufferElement>& packedElements = packedLayout.GetElements();
+
+			for (uint32_t vertex = 0; vertex < model.m_NumberOfVertices; vertex++)
+			{
+				const uint8_t* source = model.m_VertexData.data() + size_t(vertex) * stride;
+				uint8_t* destination = packedData.data() + size_t(vertex) * packedStride;
+
+				for (size_t counter = 0; counter < elements.size(); counter++)
+				{
+					QuantizeAttribute(reinterpret_cast<const float*>(source + elements[counter].Offset), packedElements[counter],
+						destination + packedElements[counter].Offset);
+				}
+			}
+
+			model.m_Layout = packedLayout;
+			model.m_VertexData.swap(packedData);
+		}
+
+		void OptimizeSubmesh(const ImportedModel& model, const Submesh& submesh, const MeshOptimizationSettings& settings,
+			OptimizedSubmesh& optimized)
+		{
+			const uint32_t stride = model.m_Layout.GetStride();
+
+			optimized.m_VertexData.assign(model.m_VertexData.begin() + size_t(submesh.m_FirstVertex) * stride,
+				model.m_VertexData.begin() + size_t(submesh.m_FirstVertex + submesh.m_NumberOfVertices) * stride);
+			optimized.m_NumberOfVertices = submesh.m_NumberOfVertices;
+
+			// Relative to the submesh while it is optimized
+			optimized.m_Indices.resize(submesh.m_NumberOfIndices);
+			for (uint32_t counter = 0; counter < submesh.m_NumberOfIndices; counter++)
+			{
+				optimized.m_Indices[counter] = model.m_Indices[submesh.m_FirstIndex + counter] - submesh.m_FirstVertex;
+			}
+
+			if (settings.m_bWeldVertices)
+			{
+				std::vector<uint32_t> remap;
+				uint32_t numberOfUniqueVertices = MeshOptimizer::WeldVertices(optimized.m_VertexData.data(), optimized.m_NumberOfVertices,
+					stride, remap);
+
+				if (numberOfUniqueVertices < optimized.m_NumberOfVertices)
+				{
+					std::vector<uint8_t> uniqueData(size_t(numberOfUniqueVertices) * stride);
+					for (uint32_t vertex = 0; vertex < optimized.m_NumberOfVertices; vertex++)
+					{
+						memcpy(uniqueData.data() + size_t(remap[vertex]) * stride, optimized.m_VertexData.data() + size_t(vertex) * stride, stride);
+					}
+
+					for (uint32_t& index : optimized.m_Indices)
+					{
+						index = remap[index];
+					}
+
+					optimized.m_VertexData.swap(uniqueData);
+					optimized.m_NumberOfVertices = numberOfUniqueVertices;
+				}
+			}
+
+			// Points and lines (a model Assimp couldn't triangulate) keep their order
+			const bool bTriangles = submesh.m_NumberOfIndices % 3 == 0;
+
+			if (bTriangles && settings.m_bOptimizeVertexCache)
+			{
+				MeshOptimizer::OptimizeVertexCache(optimized.m_Indices.data(), uint32_t(optimized.m_Indices.size()), optimized.m_NumberOfVertices);
+			}
+
+			if (bTriangles && settings.m_bOptimizeOverdraw)
+			{
+				MeshOptimizer::OptimizeOverdraw(optimized.m_Indices.data(), uint32_t(optimized.m_Indices.size()),
+					reinterpret_cast<const float*>(optimized.m_VertexData.data()), stride / sizeof(float));
+			}
+
+			if (settings.m_bOptimizeVertexFetch)
+			{
+				optimized.m_NumberOfVertices = MeshOptimizer::OptimizeVertexFetch(optimized.m_VertexData.data(), optimized.m_NumberOfVertices,
+					stride, optimized.m_Indices.data(), uint32_t(optimized.m_Indices.size()));
+				optimized.m_VertexData.resize(size_t(optimized.m_NumberOfVertices) * stride);
+			}
+
+			optimized.m_Bounds = optimized.m_NumberOfVertices > 0 ? RenderBounds::FromPositions(reinterpret_cast<const float*>(
+				optimized.m_VertexData.data()), optimized.m_NumberOfVertices, stride / sizeof(float)) : submesh.m_Bounds;
+		}
+	}
+
+	uint32_t MeshOptimizationSettings::GetKey() const
+	{
+		uint32_t key = 0;
+
+		key |= m_bWeldVertices ? 1u : 0u;
+		key |= m_bOptimizeVertexCache ? 2u : 0u;
+		key |= m_bOptimizeOverdraw ? 4u : 0u;
+		key |= m_bOptimizeVertexFetch ? 8u : 0u;
+		key |= m_bQuantize ? 16u : 0u;
+		key |= m_bQuantize ? uint32_t(m_NormalEncoding) << 5 : 0u;
+		key |= m_bAllowShortIndices ? 128u : 0u;
+		key |= std::min(m_NumberOfLODs, 15u) << 8;
+
+		// The reduction and error in steps of 1/64 and 1/1024
+		key |= m_NumberOfLODs > 0 ? std::min(uint32_t(m_LODReduction * 64.0f + 0.5f), 63u) << 12 : 0u;
+		key |= m_NumberOfLODs > 0 ? std::min(uint32_t(m_LODMaximumError * 1024.0f + 0.5f), 63u) << 18 : 0u;
+
+		return key;
+	}
+
+	void MeshOptimizer::Optimize(ImportedModel& model, const MeshOptimizationSettings& settings, JobPool* pool,
+		MeshOptimizationStatistics* statistics)
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		KR_CORE_ASSERT(model.m_ShortIndices.empty(), "The model is optimized already");
+
+		const uint32_t stride = model.m_Layout.GetStride();
+
+		MeshOptimizationStatistics optimizationStatistics;
+
+		if (statistics)
+		{
+			const uint32_t numberOfTriangles = uint32_t(model.m_Indices.size() / 3);
+
+			optimizationStatistics.m_NumberOfVerticesBefore = model.m_NumberOfVertices;
+			optimizationStatistics.m_VertexBytesBefore = model.m_VertexData.size();
+			optimizationStatistics.m_IndexBytesBefore = model.m_Indices.size() * sizeof(uint32_t);
+			optimizationStatistics.m_ACMRBefore = ComputeACMR(model.m_Indices.data(), uint32_t(model.m_Indices.size()));
+			optimizationStatistics.m_FetchedBytesBefore = uint64_t(optimizationStatistics.m_ACMRBefore * numberOfTriangles + 0.5f) * stride +
+				optimizationStatistics.m_IndexBytesBefore;
+		}
+
+		const bool bReorder = settings.m_bWeldVertices || settings.m_bOptimizeVertexCache || settings.m_bOptimizeOverdraw ||
+			settings.m_bOptimizeVertexFetch;
+
+		if (bReorder)
+		{
+			std::vector<OptimizedSubmesh> optimizedSubmeshes(model.m_Submeshes.size());
+
+			auto optimizeJob = [&](uint32_t submeshIndex)
+			{
+				OptimizeSubmesh(model, model.m_Submeshes[submeshIndex], settings, optimizedSubmeshes[submeshIndex]);
+			};
+
+			if (pool)
+			{
+				pool->ParallelFor(uint32_t(model.m_Submeshes.size()), optimizeJob);
+			}
+			else
+			{
+				for (uint32_t counter = 0; counter < uint32_t(model.m_Submeshes.size()); counter++)
+				{
+					optimizeJob(counter);
+				}
+			}
+
+			// The submeshes shrank, so their ranges are laid out again
+			uint32_t numberOfVertices = 0;
+			for (const OptimizedSubmesh& optimized : optimizedSubmeshes)
+			{
+				numberOfVertices += optimized.m_NumberOfVertices;
+			}
+
+			std::vector<uint8_t> vertexData(size_t(numberOfVertices) * stride);
+			uint32_t firstVertex = 0;
+
+			for (size_t counter = 0; counter < optimizedSubmeshes.size(); counter++)
+			{
+				const OptimizedSubmesh& optimized = optimizedSubmeshes[counter];
+				Submesh& submesh = model.m_Submeshes[counter];
+
+				std::copy(optimized.m_VertexData.begin(), optimized.m_VertexData.end(), vertexData.begin() + size_t(firstVertex) * stride);
+
+				for (uint32_t index = 0; index < uint32_t(optimized.m_Indices.size()); index++)
+				{
+					model.m_Indices[submesh.m_FirstIndex + index] = firstVertex + optimized.m_Indices[index];
+				}
+
+				submesh.m_FirstVertex = firstVertex;
+				submesh.m_NumberOfVertices = optimized.m_NumberOfVertices;
+				submesh.m_Bounds = optimized.m_Bounds;
+
+				firstVertex += optimized.m_NumberOfVertices;
+			}
+
+			model.m_VertexData.swap(vertexData);
+			model.m_NumberOfVertices = numberOfVertices;
+		}
+
+		// Before quantizing, while the positions are still where the simplifier reads them. The levels index the final vertex order.
+		MeshSimplifier::GenerateLODs(model, settings, pool);
+
+		if (settings.m_bQuantize)
+		{
+			Quantize(model, settings);
+		}
+
+		if (settings.m_bAllowShortIndices && model.m_NumberOfVertices <= 65536)
+		{
+			model.m_ShortIndices.assign(model.m_Indices.begin(), model.m_Indices.end());
+
+			std::vector<uint32_t>().swap(model.m_Indices);
+
+			for (ImportedLOD& lod : model.m_LODs)
+			{
+				lod.m_ShortIndices.assign(lod.m_Indices.begin(), lod.m_Indices.end());
+
+				std::vector<uint32_t>().swap(lod.m_Indices);
+			}
+		}
+
+		if (statistics)
+		{
+			std::vector<uint32_t> shortIndices;
+			const std::vector<uint32_t>* indices = &model.m_Indices;
+
+			if (!model.m_ShortIndices.empty())
+			{
+				shortIndices.assign(model.m_ShortIndices.begin(), model.m_ShortIndices.end());
+				indices = &shortIndices;
+			}
+
+			const uint32_t numberOfTriangles = uint32_t(indices->size() / 3);
+
+			optimizationStatistics.m_NumberOfVerticesAfter = model.m_NumberOfVertices;
+			optimizationStatistics.m_VertexBytesAfter = model.m_VertexData.size();
+			optimizationStatistics.m_IndexBytesAfter = model.m_ShortIndices.empty() ? model.m_Indices.size() * sizeof(uint32_t) :
+				model.m_ShortIndices.size() * sizeof(uint16_t);
+			optimizationStatistics.m_ACMRAfter = ComputeACMR(indices->data(), uint32_t(indices->size()));
+			optimizationStatistics.m_FetchedBytesAfter = uint64_t(optimizationStatistics.m_ACMRAfter * numberOfTriangles + 0.5f) *
+				model.m_Layout.GetStride() + optimizationStatistics.m_IndexBytesAfter;
+
+			optimizationStatistics.m_NumberOfLODs = uint32_t(model.m_LODs.size());
+			for (const ImportedLOD& lod : model.m_LODs)
+			{
+				optimizationStatistics.m_LODIndexBytes += lod.m_ShortIndices.empty() ? lod.m_Indices.size() * sizeof(uint32_t) :
+					lod.m_ShortIndices.size() * sizeof(uint16_t);
+			}
+
+			optimizationStatistics.m_Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+			*statistics = optimizationStatistics;
+		}
+	}
+
+	uint32_t MeshOptimizer::WeldVertices(const uint8_t* vertexData, uint32_t numberOfVertices, uint32_t vertexStride, std::vector<uint32_t>& remap)
+	{
+		KR_CORE_ASSERT(vertexStride % sizeof(uint32_t) == 0, "Vertices are welded a word at a time");
+
+		remap.resize(numberOfVertices);
+
+		// Open addressing, at most half full, holding the first vertex of each kind
+		uint32_t tableSize = 1;
+		while (tableSize < numberOfVertices * 2)
+		{
+			tableSize <<= 1;
+		}
+
+		const uint32_t emptySlot = ~0u;
+		std::vector<uint32_t> table(tableSize, emptySlot);
+
+		uint32_t numberOfUniqueVertices = 0;
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			const uint8_t* vertexBytes = vertexData + size_t(vertex) * vertexStride;
+			uint32_t slot = HashVertex(vertexBytes, vertexStride) & (tableSize - 1);
+
+			for (;;)
+			{
+				uint32_t candidate = table[slot];
+
+				if (candidate == emptySlot)
+				{
+					table[slot] = vertex;
+					remap[vertex] = numberOfUniqueVertices++;
+					break;
+				}
+
+				if (memcmp(vertexData + size_t(candidate) * vertexStride, vertexBytes, vertexStride) == 0)
+				{
+					remap[vertex] = remap[candidate];
+					break;
+				}
+
+				slot = (slot + 1) & (tableSize - 1);
+			}
+		}
+
+		return numberOfUniqueVertices;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices)
+	{
+		const uint32_t numberOfTriangles = numberOfIndices / 3;
+
+		if (numberOfTriangles < 2)
+		{
+			return;
+		}
+
+		// The triangles of each vertex
+		std::vector<uint32_t> valence(numberOfVertices, 0);
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			valence[indices[counter]]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(numberOfVertices + 1, 0);
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + valence[vertex];
+		}
+
+		std::vector<uint32_t> adjacency(numberOfIndices);
+		std::vector<uint32_t> filled(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32_t triangle = 0; triangle < numberOfTriangles; triangle++)
+		{
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle * 3 + corner];
+				adjacency[filled[vertex]++] = triangle;
+			}
+		}
+
+		// valence becomes the triangles left to emit
+		std::vector<float> vertexScore(numberOfVertices);
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			vertexScore[vertex] = ComputeVertexScore(-1, valence[vertex]);
+		}
+
+		std::vector<float> triangleScore(numberOfTriangles);
+		std::vector<bool> bEmitted(numberOfTriangles, false);
+		for (uint32_t triangle = 0; triangle < numberOfTriangles; triangle++)
+		{
+			triangleScore[triangle] = vertexScore[indices[triangle * 3]] + vertexScore[indices[triangle * 3 + 1]] +
+				vertexScore[indices[triangle * 3 + 2]];
+		}
+
+		std::vector<uint32_t> ordered(numberOfIndices);
+
+		// The modelled LRU cache, with room for the three vertices pushed in before the overflow is dropped
+		uint32_t cache[s_ForsythCacheSize + 3];
+		uint32_t cacheCount = 0;
+
+		uint32_t bestTriangle = 0;
+		uint32_t nextFallbackTriangle = 0;
+
+		for (uint32_t emitted = 0; emitted < numberOfTriangles; emitted++)
+		{
+			if (bestTriangle == ~0u)
+			{
+				// Nothing in the cache leads anywhere, the next triangle in the original order starts afresh
+				while (bEmitted[nextFallbackTriangle])
+				{
+					nextFallbackTriangle++;
+				}
+				bestTriangle = nextFallbackTriangle;
+			}
+
+			const uint32_t* triangleIndices = indices + bestTriangle * 3;
+
+			ordered[emitted * 3] = triangleIndices[0];
+			ordered[emitted * 3 + 1] = triangleIndices[1];
+			ordered[emitted * 3 + 2] = triangleIndices[2];
+			bEmitted[bestTriangle] = true;
+
+			// The triangle leaves the adjacency of its vertices
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = triangleIndices[corner];
+
+				uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+				uint32_t* end = begin + valence[vertex];
+				uint32_t* found = std::find(begin, end, bestTriangle);
+
+				if (found != end)
+				{
+					*found = *(end - 1);
+					valence[vertex]--;
+				}
+			}
+
+			// Its vertices go to the front of the cache
+			uint32_t newCache[s_ForsythCacheSize + 3];
+			uint32_t newCacheCount = 0;
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				// Once, should the triangle be degenerate
+				if (std::find(newCache, newCache + newCacheCount, triangleIndices[corner]) == newCache + newCacheCount)
+				{
+					newCache[newCacheCount++] = triangleIndices[corner];
+				}
+			}
+
+			for (uint32_t counter = 0; counter < cacheCount; counter++)
+			{
+				uint32_t vertex = cache[counter];
+
+				if (vertex != triangleIndices[0] && vertex != triangleIndices[1] && vertex != triangleIndices[2])
+				{
+					newCache[newCacheCount++] = vertex;
+				}
+			}
+
+			// Scores of everything in the cache (and of what fell out of it) change
+			for (uint32_t counter = 0; counter < newCacheCount; counter++)
+			{
+				uint32_t vertex = newCache[counter];
+				int32_t position = counter < s_ForsythCacheSize ? int32_t(counter) : -1;
+
+				float newScore = ComputeVertexScore(position, valence[vertex]);
+				float scoreChange = newScore - vertexScore[vertex];
+				vertexScore[vertex] = newScore;
+
+				for (uint32_t adjacent = 0; adjacent < valence[vertex]; adjacent++)
+				{
+					triangleScore[adjacency[adjacencyOffsets[vertex] + adjacent]] += scoreChange;
+				}
+			}
+
+			cacheCount = std::min(newCacheCount, s_ForsythCacheSize);
+			std::copy(newCache, newCache + cacheCount, cache);
+
+			// The best triangle is among those of the cached vertices
+			bestTriangle = ~0u;
+			float bestScore = -1.0f;
+
+			for (uint32_t counter = 0; counter < cacheCount; counter++)
+			{
+				uint32_t vertex = cache[counter];
+
+				for (uint32_t adjacent = 0; adjacent < valence[vertex]; adjacent++)
+				{
+					uint32_t triangle = adjacency[adjacencyOffsets[vertex] + adjacent];
+
+					if (triangleScore[triangle] > bestScore)
+					{
+						bestScore = triangleScore[triangle];
+						bestTriangle = triangle;
+					}
+				}
+			}
+		}
+
+		std::copy(ordered.begin(), ordered.end(), indices);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, uint32_t numberOfIndices, const float* positions, uint32_t strideInFloats)
+	{
+		const uint32_t numberOfTriangles = numberOfIndices / 3;
+
+		if (numberOfTriangles < 2)
+		{
+			return;
+		}
+
+		uint32_t maximumIndex = 0;
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			maximumIndex = std::max(maximumIndex, indices[counter]);
+		}
+
+		// A cluster starts where every vertex of a triangle misses the cache, so that moving clusters about keeps the cache order within them
+		std::vector<uint32_t> clusterStarts;
+		std::vector<uint32_t> timeStamps(maximumIndex + 1, 0);
+		uint32_t time = s_SimulatedCacheSize + 1;
+
+		for (uint32_t triangle = 0; triangle < numberOfTriangles; triangle++)
+		{
+			uint32_t misses = 0;
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle * 3 + corner];
+
+				if (time - timeStamps[vertex] > s_SimulatedCacheSize)
+				{
+					timeStamps[vertex] = time++;
+					misses++;
+				}
+			}
+
+			if (triangle == 0 || misses == 3)
+			{
+				clusterStarts.push_back(triangle);
+			}
+		}
+
+		if (clusterStarts.size() < 2)
+		{
+			return;
+		}
+
+		auto getPosition = [positions, strideInFloats](uint32_t vertex)
+		{
+			return positions + size_t(vertex) * strideInFloats;
+		};
+
+		// Center of the mesh, by area
+		float meshCenter[3] = {};
+		float meshArea = 0.0f;
+
+		std::vector<float> clusterCenters(clusterStarts.size() * 3, 0.0f);
+		std::vector<float> clusterNormals(clusterStarts.size() * 3, 0.0f);
+		std::vector<float> clusterAreas(clusterStarts.size(), 0.0f);
+
+		for (size_t cluster = 0; cluster < clusterStarts.size(); cluster++)
+		{
+			uint32_t clusterEnd = cluster + 1 < clusterStarts.size() ? clusterStarts[cluster + 1] : numberOfTriangles;
+
+			for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterEnd; triangle++)
+			{
+				const float* p0 = getPosition(indices[triangle * 3]);
+				const float* p1 = getPosition(indices[triangle * 3 + 1]);
+				const float* p2 = getPosition(indices[triangle * 3 + 2]);
+
+				float edge1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				float edge2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+				// Twice the area, along the normal
+				float normal[3] = { edge1[1] * edge2[2] - edge1[2] * edge2[1], edge1[2] * edge2[0] - edge1[0] * edge2[2],
+					edge1[0] * edge2[1] - edge1[1] * edge2[0] };
+
+				float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+				for (uint32_t axis = 0; axis < 3; axis++)
+				{
+					float centroid = (p0[axis] + p1[axis] + p2[axis]) / 3.0f;
+
+					clusterCenters[cluster * 3 + axis] += centroid * area;
+					clusterNormals[cluster * 3 + axis] += normal[axis];
+					meshCenter[axis] += centroid * area;
+				}
+
+				clusterAreas[cluster] += area;
+				meshArea += area;
+			}
+		}
+
+		if (meshArea <= 0.0f)
+		{
+			return;
+		}
+
+		for (uint32_t axis = 0; axis < 3; axis++)
+		{
+			meshCenter[axis] /= meshArea;
+		}
+
+		// How much each cluster faces away from the center, the outer shell (which occludes the rest) gets drawn first
+		std::vector<float> clusterKeys(clusterStarts.size(), 0.0f);
+
+		for (size_t cluster = 0; cluster < clusterStarts.size(); cluster++)
+		{
+			if (clusterAreas[cluster] <= 0.0f)
+			{
+				continue;
+			}
+
+			const float* normal = &clusterNormals[cluster * 3];
+			float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			if (normalLength <= 0.0f)
+			{
+				continue;
+			}
+
+			float key = 0.0f;
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				float center = clusterCenters[cluster * 3 + axis] / clusterAreas[cluster];
+				key += (center - meshCenter[axis]) * normal[axis] / normalLength;
+			}
+
+			clusterKeys[cluster] = key;
+		}
+
+		std::vector<uint32_t> clusterOrder(clusterStarts.size());
+		for (uint32_t cluster = 0; cluster < uint32_t(clusterStarts.size()); cluster++)
+		{
+			clusterOrder[cluster] = cluster;
+		}
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterKeys](uint32_t first, uint32_t second)
+		{
+			return clusterKeys[first] > clusterKeys[second];
+		});
+
+		std::vector<uint32_t> ordered;
+		ordered.reserve(numberOfIndices);
+
+		for (uint32_t cluster : clusterOrder)
+		{
+			uint32_t clusterEnd = cluster + 1 < clusterStarts.size() ? clusterStarts[cluster + 1] : numberOfTriangles;
+
+			ordered.insert(ordered.end(), indices + clusterStarts[cluster] * 3, indices + clusterEnd * 3);
+		}
+
+		std::copy(ordered.begin(), ordered.end(), indices);
+	}
+
+	uint32_t MeshOptimizer::OptimizeVertexFetch(uint8_t* vertexData, uint32_t numberOfVertices, uint32_t vertexStride, uint32_t* indices,
+		uint32_t numberOfIndices)
+	{
+		const uint32_t unused = ~0u;
+		std::vector<uint32_t> remap(numberOfVertices, unused);
+
+		uint32_t numberOfUsedVertices = 0;
+
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			uint32_t& newIndex = remap[indices[counter]];
+
+			if (newIndex == unused)
+			{
+				newIndex = numberOfUsedVertices++;
+			}
+
+			indices[counter] = newIndex;
+		}
+
+		std::vector<uint8_t> reordered(size_t(numberOfUsedVertices) * vertexStride);
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			if (remap[vertex] != unused)
+			{
+				memcpy(reordered.data() + size_t(remap[vertex]) * vertexStride, vertexData + size_t(vertex) * vertexStride, vertexStride);
+			}
+		}
+
+		memcpy(vertexData, reordered.data(), reordered.size());
+
+		return numberOfUsedVertices;
+	}
+
+	float MeshOptimizer::ComputeACMR(const uint32_t* indices, uint32_t numberOfIndices, uint32_t cacheSize)
+	{
+		const uint32_t numberOfTriangles = numberOfIndices / 3;
+
+		if (numberOfTriangles == 0)
+		{
+			return 0.0f;
+		}
+
+		uint32_t maximumIndex = 0;
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			maximumIndex = std::max(maximumIndex, indices[counter]);
+		}
+
+		// A vertex is in the FIFO while fewer than cacheSize others went in after it
+		std::vector<uint32_t> timeStamps(size_t(maximumIndex) + 1, 0);
+		uint32_t time = cacheSize + 1;
+		uint32_t misses = 0;
+
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			uint32_t vertex = indices[counter];
+
+			if (time - timeStamps[vertex] > cacheSize)
+			{
+				timeStamps[vertex] = time++;
+				misses++;
+			}
+		}
+
+		return float(misses) / float(numberOfTriangles);
+	}
+
+	uint16_t MeshOptimizer::FloatToHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		const uint16_t sign = uint16_t((bits >> 16) & 0x8000);
+		const uint32_t magnitude = bits & 0x7fffffff;
+
+		if (magnitude >= 0x7f800000)
+		{
+			// Infinity stays, NaN stays a (quiet) NaN
+			return sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00);
+		}
+
+		if (magnitude >= 0x477ff000)
+		{
+			// Rounds to above 65504
+			return sign | 0x7c00;
+		}
+
+		if (magnitude < 0x38800000)
+		{
+			// Below the smallest normal half, in units of 2^-24
+			float absolute;
+			memcpy(&absolute, &magnitude, sizeof(absolute));
+
+			return sign | uint16_t(std::nearbyint(absolute * 16777216.0f));
+		}
+
+		// Rebias the exponent and round the mantissa to nearest, ties to even
+		uint32_t half = (magnitude - 0x38000000) >> 13;
+		uint32_t remainder = magnitude & 0x1fff;
+
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			half++;
+		}
+
+		return sign | uint16_t(half);
+	}
+
+	void MeshOptimizer::EncodeOctahedral(const float* direction, float* encoded)
+	{
+		float length = std::abs(direction[0]) + std::abs(direction[1]) + std::abs(direction[2]);
+
+		if (length <= 0.0f)
+		{
+			encoded[0] = 0.0f;
+			encoded[1] = 0.0f;
+			return;
+		}
+
+		float u = direction[0] / length;
+		float v = direction[1] / length;
+
+		if (direction[2] < 0.0f)
+		{
+			// The lower half folds over the diagonals
+			float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+			float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+
+			u = foldedU;
+			v = foldedV;
+		}
+
+		encoded[0] = u;
+		encoded[1] = v;
+	}
+
+	void MeshOptimizer::LogStatistics(const std::string& modelName, const MeshOptimizationStatistics& statistics)
+	{
+		KR_CORE_INFO("Mesh optimization {0}: {1} -> {2} vertices, vertex bytes {3} -> {4}, index bytes {5} -> {6}, ACMR {7} -> {8}, "
+			"bytes fetched per draw {9} -> {10}, {11} levels of detail in {12} index bytes, {13} ms", modelName, statistics.m_NumberOfVerticesBefore, statistics.m_NumberOfVerticesAfter,
+			statistics.m_VertexBytesBefore, statistics.m_VertexBytesAfter, statistics.m_IndexBytesBefore, statistics.m_IndexBytesAfter,
+			statistics.m_ACMRBefore, statistics.m_ACMRAfter, statistics.m_FetchedBytesBefore, statistics.m_FetchedBytesAfter,
+			statistics.m_NumberOfLODs, statistics.m_LODIndexBytes, statistics.m_Milliseconds);
+	}
+}
@@ -0,0 +1,287 @@
+/**
+ * @file MeshOptimizer.h
+ * @brief This file contains the MeshOptimizer class, which welds, reorders and quantizes imported models for the GPU's caches and bandwidth.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "ModelImporter.h"
+
+namespace Karma
+{
+	/**
+	 * @brief How MeshOptimizer quantizes the normals and tangents
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class NormalEncoding
+	{
+		/** Kept as Float3 */
+		Float = 0,
+		/** Byte4Norm, read by the shaders as they read Float3 (vec3 or vec4 inputs) */
+		SNorm8,
+		/** Short2Norm octahedral encoding, the shaders must decode the vec2 (see MeshOptimizer::EncodeOctahedral) */
+		Octahedral
+	};
+
+	/**
+	 * @brief Stages of MeshOptimizer::Optimize to run
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API MeshOptimizationSettings
+	{
+		/**
+		 * @brief Merges the vertices whose attributes are identical (Assimp gives, for instance, three vertices per triangle of an obj)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bWeldVertices = true;
+
+		/**
+		 * @brief Reorders the triangles for the post transform vertex cache (Forsyth's linear speed algorithm)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bOptimizeVertexCache = true;
+
+		/**
+		 * @brief Reorders clusters of the cache ordered triangles so that the outward facing ones are drawn first
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bOptimizeOverdraw = true;
+
+		/**
+		 * @brief Renumbers the vertices in the order the indices first use them, so that the vertex fetch streams through memory
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bOptimizeVertexFetch = true;
+
+		/**
+		 * @brief Packs the vertices: Half2 UVs, UByte4Norm colors and the normals and tangents as m_NormalEncoding. Positions stay Float3.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bQuantize = false;
+
+		/**
+		 * @brief Encoding of the normals and tangents, when quantizing
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NormalEncoding m_NormalEncoding = NormalEncoding::SNorm8;
+
+		/**
+		 * @brief Uses 16 bit indices for models of at most 65536 vertices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bAllowShortIndices = true;
+
+		/**
+		 * @brief Levels of detail to generate (MeshSimplifier::GenerateLODs) past the model itself, at most 15, 0 for none
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfLODs = 3;
+
+		/**
+		 * @brief Fraction of the triangles of the previous level each level aims for
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_LODReduction = 0.5f;
+
+		/**
+		 * @brief Largest deviation of the coarsest level from the model, relative to the model's radius
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_LODMaximumError = 0.02f;
+
+		/**
+		 * @brief The settings packed in bits, for the cooked files to tell whether they were made with the same settings
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetKey() const;
+	};
+
+	/**
+	 * @brief What an Optimize call saved
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API MeshOptimizationStatistics
+	{
+		uint32_t m_NumberOfVerticesBefore = 0;
+		uint32_t m_NumberOfVerticesAfter = 0;
+
+		uint64_t m_VertexBytesBefore = 0;
+		uint64_t m_VertexBytesAfter = 0;
+		uint64_t m_IndexBytesBefore = 0;
+		uint64_t m_IndexBytesAfter = 0;
+
+		/**
+		 * @brief Average cache miss ratio, the vertices transformed per triangle with a FIFO cache of MeshOptimizer::s_SimulatedCacheSize
+		 * (0.5 is the ideal for large regular meshes, 3 the worst)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_ACMRBefore = 0.0f;
+		float m_ACMRAfter = 0.0f;
+
+		/**
+		 * @brief Bytes of vertices fetched by a draw of the model (the cache misses times the vertex stride), plus its indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_FetchedBytesBefore = 0;
+		uint64_t m_FetchedBytesAfter = 0;
+
+		/**
+		 * @brief Levels of detail generated, and the bytes of their indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfLODs = 0;
+		uint64_t m_LODIndexBytes = 0;
+
+		double m_Milliseconds = 0.0;
+	};
+
+	/**
+	 * @brief The optimization stage of loading, run on the ImportedModel of the ModelImporter before the buffers are made (Mesh) or the model
+	 * is cooked (CookedMesh::Cook, where it costs nothing at load time).
+	 *
+	 * Each submesh is welded, ordered for the vertex cache and overdraw and renumbered for the vertex fetch independently of the others (on a
+	 * JobPool) and keeps its own range. Then the levels of detail are generated (MeshSimplifier), and the whole of the model is quantized and
+	 * its indices made 16 bit, if the settings ask for it.
+	 *
+	 * @see MeshOptimizationSettings, CommandLine
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API MeshOptimizer
+	{
+	public:
+		/**
+		 * @brief Runs the stages the settings ask for. The layout of the model must be of floats (as ModelImporter makes it).
+		 *
+		 * @param model							The model, optimized in place
+		 * @param settings						The stages to run
+		 * @param pool							Pool to optimize the submeshes on, nullptr optimizes them on the calling thread
+		 * @param statistics					Output, if not nullptr
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Optimize(ImportedModel& model, const MeshOptimizationSettings& settings, JobPool* pool,
+			MeshOptimizationStatistics* statistics = nullptr);
+
+		/**
+		 * @brief Finds the unique vertices
+		 *
+		 * @param vertexData					The vertices
+		 * @param numberOfVertices				Number of vertices
+		 * @param vertexStride					Bytes per vertex, a multiple of 4
+		 * @param remap							Output, the unique vertex each vertex is merged into
+		 *
+		 * @return Number of unique vertices. remap[vertex] < that, and the unique vertices keep their order.
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t WeldVertices(const uint8_t* vertexData, uint32_t numberOfVertices, uint32_t vertexStride, std::vector<uint32_t>& remap);
+
+		/**
+		 * @brief Reorders the triangles (Tom Forsyth's linear speed vertex cache optimization)
+		 *
+		 * @param indices						Triangle list, reordered in place
+		 * @param numberOfIndices				Number of indices, a multiple of 3
+		 * @param numberOfVertices				Indices are below this
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void OptimizeVertexCache(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices);
+
+		/**
+		 * @brief Splits the (cache ordered) triangles into clusters where the simulated cache starts afresh, and sorts the clusters by how much
+		 * they face away from the center of the mesh, so that the outer surfaces, which hide the rest, are drawn first
+		 *
+		 * @param indices						Triangle list, reordered in place
+		 * @param numberOfIndices				Number of indices, a multiple of 3
+		 * @param positions						First position (x, y, z floats)
+		 * @param strideInFloats				Distance, in floats, between consecutive positions
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void OptimizeOverdraw(uint32_t* indices, uint32_t numberOfIndices, const float* positions, uint32_t strideInFloats);
+
+		/**
+		 * @brief Renumbers the vertices in the order of first use and drops the unused ones
+		 *
+		 * @return Number of vertices left
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t OptimizeVertexFetch(uint8_t* vertexData, uint32_t numberOfVertices, uint32_t vertexStride, uint32_t* indices,
+			uint32_t numberOfIndices);
+
+		/**
+		 * @brief Vertices transformed per triangle with a FIFO post transform cache of cacheSize entries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static float ComputeACMR(const uint32_t* indices, uint32_t numberOfIndices, uint32_t cacheSize = s_SimulatedCacheSize);
+
+		/**
+		 * @brief IEEE half precision of value, rounded to nearest
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint16_t FloatToHalf(float value);
+
+		/**
+		 * @brief Octahedral encoding of a unit vector, two values in [-1, 1]. The shader decodes (u, v) with
+		 * n = vec3(u, v, 1 - |u| - |v|); if (n.z < 0) n.xy = (1 - abs(n.yx)) * sign(n.xy); n = normalize(n).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void EncodeOctahedral(const float* direction, float* encoded);
+
+		/**
+		 * @brief Logs the statistics of the model
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void LogStatistics(const std::string& modelName, const MeshOptimizationStatistics& statistics);
+
+		/**
+		 * @brief The settings Mesh and CookedMesh optimize with
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static const MeshOptimizationSettings& GetDefaultSettings() { return s_DefaultSettings; }
+
+		/**
+		 * @brief Setter for the settings Mesh and CookedMesh optimize with
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetDefaultSettings(const MeshOptimizationSettings& settings) { s_DefaultSettings = settings; }
+
+	public:
+		/**
+		 * @brief Entries of the FIFO cache the statistics are simulated with, about the cache of current GPUs
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_SimulatedCacheSize = 16;
+
+	private:
+		static MeshOptimizationSettings s_DefaultSettings;
+	};
+}
@@ -0,0 +1,660 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "Karma/JobPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Karma
+{
+	namespace
+	{
+		// How a vertex may collapse
+		enum class VertexKind : uint8_t
+		{
+			Manifold,
+			Border,
+			Locked
+		};
+
+		// A collapse of m_From into m_To
+		struct Collapse
+		{
+			uint32_t m_From;
+			uint32_t m_To;
+			float m_Error;
+		};
+
+		// Level of detail simplification gives up once a level keeps more than this of the previous one
+		constexpr float s_MinimumLODProgress = 0.9f;
+
+		// Cosine of the largest turn of a triangle's normal a collapse may cause
+		constexpr double s_MaximumFlipCosine = 0.25;
+
+		// Border planes outweigh the surface ones, so that the outline moves last
+		constexpr double s_BorderWeight = 10.0;
+
+		// The symmetric 4x4 matrix of the sum of squared distances to planes, and the sum of their weights
+		struct Quadric
+		{
+			double m_A2 = 0.0, m_B2 = 0.0, m_C2 = 0.0, m_AB = 0.0, m_AC = 0.0, m_BC = 0.0;
+			double m_AD = 0.0, m_BD = 0.0, m_CD = 0.0, m_D2 = 0.0;
+			double m_Weight = 0.0;
+
+			void AddPlane(double a, double b, double c, double d, double weight)
+			{
+				m_A2 += a * a * weight;
+				m_B2 += b * b * weight;
+				m_C2 += c * c * weight;
+				m_AB += a * b * weight;
+				m_AC += a * c * weight;
+				m_BC += b * c * weight;
+				m_AD += a * d * weight;
+				m_BD += b * d * weight;
+				m_CD += c * d * weight;
+				m_D2 += d * d * weight;
+				m_Weight += weight;
+			}
+
+			void Add(const Quadric& other)
+			{
+				m_A2 += other.m_A2;
+				m_B2 += other.m_B2;
+				m_C2 += other.m_C2;
+				m_AB += other.m_AB;
+				m_AC += other.m_AC;
+				m_BC += other.m_BC;
+				m_AD += other.m_AD;
+				m_BD += other.m_BD;
+				m_CD += other.m_CD;
+				m_D2 += other.m_D2;
+				m_Weight += other.m_Weight;
+			}
+
+			// Weighted sum of squared distances from the point to the planes
+			double Evaluate(const float* point) const
+			{
+				const double x = point[0], y = point[1], z = point[2];
+
+				double result = m_A2 * x * x + m_B2 * y * y + m_C2 * z * z + 2.0 * (m_AB * x * y + m_AC * x * z + m_BC * y * z) +
+					2.0 * (m_AD * x + m_BD * y + m_CD * z) + m_D2;
+
+				return std::max(result, 0.0);
+			}
+		};
+
+		// Squared distance the collapse moves the surface, the quadrics of both ends evaluated at the end kept
+		double CollapseError(const Quadric& from, const Quadric& to, const float* position)
+		{
+			double weight = from.m_Weight + to.m_Weight;
+
+			return weight > 0.0 ? (from.Evaluate(position) + to.Evaluate(position)) / weight : 0.0;
+		}
+
+		void Cross(const float* first, const float* second, double* result)
+		{
+			result[0] = double(first[1]) * second[2] - double(first[2]) * second[1];
+			result[1] = double(first[2]) * second[0] - double(first[0]) * second[2];
+			result[2] = double(first[0]) * second[1] - double(first[1]) * second[0];
+		}
+
+		uint64_t EdgeKey(uint32_t first, uint32_t second)
+		{
+			return (uint64_t(first) << 32) | second;
+		}
+
+		// The first vertex at each position, so that the topology ignores the attribute seams
+		void FindPositionIds(const float* positions, uint32_t strideInFloats, uint32_t numberOfVertices, std::vector<uint32_t>& positionIds)
+		{
+			positionIds.resize(numberOfVertices);
+
+			uint32_t tableSize = 1;
+			while (tableSize < numberOfVertices * 2)
+			{
+				tableSize <<= 1;
+			}
+
+			std::vector<uint32_t> table(tableSize, ~0u);
+
+			for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+			{
+				const float* position = positions + size_t(vertex) * strideInFloats;
+
+				uint32_t hash = 2166136261u;
+				for (uint32_t component = 0; component < 3; component++)
+				{
+					uint32_t word;
+					memcpy(&word, position + component, sizeof(word));
+					hash = (hash ^ word) * 16777619u;
+				}
+
+				uint32_t slot = hash & (tableSize - 1);
+
+				for (;;)
+				{
+					uint32_t candidate = table[slot];
+
+					if (candidate == ~0u)
+					{
+						table[slot] = vertex;
+						positionIds[vertex] = vertex;
+						break;
+					}
+
+					if (memcmp(positions + size_t(candidate) * strideInFloats, position, 3 * sizeof(float)) == 0)
+					{
+						positionIds[vertex] = candidate;
+						break;
+					}
+
+					slot = (slot + 1) & (tableSize - 1);
+				}
+			}
+		}
+
+		// Directed edges (between positions) of the triangles, and how many triangles have each
+		void CollectEdges(const uint32_t* indices, uint32_t numberOfIndices, const std::vector<uint32_t>& positionIds,
+			std::unordered_map<uint64_t, uint32_t>& edges)
+		{
+			edges.clear();
+			edges.reserve(numberOfIndices);
+
+			for (uint32_t triangle = 0; triangle < numberOfIndices; triangle += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t first = positionIds[indices[triangle + corner]];
+					uint32_t second = positionIds[indices[triangle + (corner + 1) % 3]];
+
+					edges[EdgeKey(first, second)]++;
+				}
+			}
+		}
+
+		bool IsBorderEdge(const std::unordered_map<uint64_t, uint32_t>& edges, uint32_t firstPosition, uint32_t secondPosition)
+		{
+			bool bForward = edges.find(EdgeKey(firstPosition, secondPosition)) != edges.end();
+			bool bBackward = edges.find(EdgeKey(secondPosition, firstPosition)) != edges.end();
+
+			return bForward != bBackward;
+		}
+	}
+
+	uint32_t MeshSimplifier::Simplify(const float* positions, uint32_t strideInFloats, uint32_t numberOfVertices, const uint32_t* indices,
+		uint32_t numberOfIndices, uint32_t targetNumberOfIndices, float targetError, uint32_t* destination, float* resultError)
+	{
+		if (destination != indices)
+		{
+			std::copy(indices, indices + numberOfIndices, destination);
+		}
+
+		if (resultError)
+		{
+			*resultError = 0.0f;
+		}
+
+		if (numberOfIndices <= targetNumberOfIndices || numberOfIndices % 3 != 0)
+		{
+			return numberOfIndices;
+		}
+
+		auto getPosition = [positions, strideInFloats](uint32_t vertex)
+		{
+			return positions + size_t(vertex) * strideInFloats;
+		};
+
+		std::vector<uint32_t> positionIds;
+		FindPositionIds(positions, strideInFloats, numberOfVertices, positionIds);
+
+		std::unordered_map<uint64_t, uint32_t> edges;
+		CollectEdges(destination, numberOfIndices, positionIds, edges);
+
+		// Seams: more than one used vertex at a position
+		std::vector<uint8_t> bUsed(numberOfVertices, 0);
+		std::vector<uint32_t> verticesAtPosition(numberOfVertices, 0);
+
+		for (uint32_t counter = 0; counter < numberOfIndices; counter++)
+		{
+			uint32_t vertex = destination[counter];
+
+			if (!bUsed[vertex])
+			{
+				bUsed[vertex] = 1;
+				verticesAtPosition[positionIds[vertex]]++;
+			}
+		}
+
+		// Classified per position first, then handed to the vertices there
+		std::vector<VertexKind> positionKinds(numberOfVertices, VertexKind::Manifold);
+
+		for (const std::pair<const uint64_t, uint32_t>& edge : edges)
+		{
+			uint32_t firstPosition = uint32_t(edge.first >> 32);
+			uint32_t secondPosition = uint32_t(edge.first);
+
+			if (edge.second > 1)
+			{
+				// Non manifold
+				positionKinds[firstPosition] = VertexKind::Locked;
+				positionKinds[secondPosition] = VertexKind::Locked;
+			}
+			else if (IsBorderEdge(edges, firstPosition, secondPosition))
+			{
+				for (uint32_t position : { firstPosition, secondPosition })
+				{
+					if (positionKinds[position] == VertexKind::Manifold)
+					{
+						positionKinds[position] = VertexKind::Border;
+					}
+				}
+			}
+		}
+
+		std::vector<VertexKind> vertexKinds(numberOfVertices);
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			uint32_t position = positionIds[vertex];
+
+			vertexKinds[vertex] = verticesAtPosition[position] > 1 ? VertexKind::Locked : positionKinds[position];
+		}
+
+		// The quadrics, of the planes of the triangles by area and of the planes standing on the borders
+		std::vector<Quadric> quadrics(numberOfVertices);
+
+		for (uint32_t triangle = 0; triangle < numberOfIndices; triangle += 3)
+		{
+			const float* corners[3] = { getPosition(destination[triangle]), getPosition(destination[triangle + 1]),
+				getPosition(destination[triangle + 2]) };
+
+			float edge1[3] = { corners[1][0] - corners[0][0], corners[1][1] - corners[0][1], corners[1][2] - corners[0][2] };
+			float edge2[3] = { corners[2][0] - corners[0][0], corners[2][1] - corners[0][1], corners[2][2] - corners[0][2] };
+
+			double normal[3];
+			Cross(edge1, edge2, normal);
+
+			double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			if (length <= 0.0)
+			{
+				continue;
+			}
+
+			for (double& component : normal)
+			{
+				component /= length;
+			}
+
+			const double area = length * 0.5;
+			const double distance = -(normal[0] * corners[0][0] + normal[1] * corners[0][1] + normal[2] * corners[0][2]);
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				quadrics[destination[triangle + corner]].AddPlane(normal[0], normal[1], normal[2], distance, area);
+			}
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t first = destination[triangle + corner];
+				uint32_t second = destination[triangle + (corner + 1) % 3];
+
+				if (!IsBorderEdge(edges, positionIds[first], positionIds[second]))
+				{
+					continue;
+				}
+
+				const float* start = getPosition(first);
+				const float* end = getPosition(second);
+
+				float edgeDirection[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+				float triangleNormal[3] = { float(normal[0]), float(normal[1]), float(normal[2]) };
+
+				double borderNormal[3];
+				Cross(edgeDirection, triangleNormal, borderNormal);
+
+				double borderLength = std::sqrt(borderNormal[0] * borderNormal[0] + borderNormal[1] * borderNormal[1] +
+					borderNormal[2] * borderNormal[2]);
+
+				if (borderLength <= 0.0)
+				{
+					continue;
+				}
+
+				for (double& component : borderNormal)
+				{
+					component /= borderLength;
+				}
+
+				const double borderDistance = -(borderNormal[0] * start[0] + borderNormal[1] * start[1] + borderNormal[2] * start[2]);
+				const double weight = borderLength * borderLength * s_BorderWeight;
+
+				quadrics[first].AddPlane(borderNormal[0], borderNormal[1], borderNormal[2], borderDistance, weight);
+				quadrics[second].AddPlane(borderNormal[0], borderNormal[1], borderNormal[2], borderDistance, weight);
+			}
+		}
+
+		const double errorLimit = double(targetError) * double(targetError);
+		double largestError = 0.0;
+
+		uint32_t indexCount = numberOfIndices;
+
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(numberOfVertices);
+		std::vector<uint8_t> bTouched(numberOfVertices);
+		std::vector<uint32_t> adjacencyOffsets(numberOfVertices + 1);
+		std::vector<uint32_t> adjacency;
+
+		// Passes of independent collapses (no two sharing a triangle), the cheapest first
+		for (;;)
+		{
+			if (indexCount <= targetNumberOfIndices)
+			{
+				break;
+			}
+
+			CollectEdges(destination, indexCount, positionIds, edges);
+
+			auto canCollapse = [&](uint32_t from, uint32_t to)
+			{
+				switch (vertexKinds[from])
+				{
+					case VertexKind::Manifold:
+						return true;
+					case VertexKind::Border:
+						return vertexKinds[to] != VertexKind::Manifold && IsBorderEdge(edges, positionIds[from], positionIds[to]);
+					default:
+						return false;
+				}
+			};
+
+			collapses.clear();
+
+			for (uint32_t triangle = 0; triangle < indexCount; triangle += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t first = destination[triangle + corner];
+					uint32_t second = destination[triangle + (corner + 1) % 3];
+
+					// Each inner edge is seen from both of its triangles, the cheaper direction of it once
+					if (first > second && !IsBorderEdge(edges, positionIds[first], positionIds[second]))
+					{
+						continue;
+					}
+
+					bool bFirstToSecond = canCollapse(first, second);
+					bool bSecondToFirst = canCollapse(second, first);
+
+					double firstToSecond = bFirstToSecond ? CollapseError(quadrics[first], quadrics[second], getPosition(second)) : 0.0;
+					double secondToFirst = bSecondToFirst ? CollapseError(quadrics[second], quadrics[first], getPosition(first)) : 0.0;
+
+					if (bFirstToSecond && (!bSecondToFirst || firstToSecond <= secondToFirst))
+					{
+						collapses.push_back({ first, second, float(firstToSecond) });
+					}
+					else if (bSecondToFirst)
+					{
+						collapses.push_back({ second, first, float(secondToFirst) });
+					}
+				}
+			}
+
+			if (collapses.empty())
+			{
+				break;
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& first, const Collapse& second)
+			{
+				return first.m_Error < second.m_Error;
+			});
+
+			// The triangles of each vertex, for the flip test
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32_t counter = 0; counter < indexCount; counter++)
+			{
+				adjacencyOffsets[destination[counter] + 1]++;
+			}
+			for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+			{
+				adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+			}
+
+			adjacency.resize(indexCount);
+			std::vector<uint32_t> filled(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t counter = 0; counter < indexCount; counter++)
+			{
+				adjacency[filled[destination[counter]]++] = counter / 3;
+			}
+
+			// Moving from onto to mustn't turn any of from's other triangles over, or nearly
+			auto flips = [&](uint32_t from, uint32_t to)
+			{
+				const float* target = getPosition(to);
+
+				for (uint32_t counter = adjacencyOffsets[from]; counter < adjacencyOffsets[from + 1]; counter++)
+				{
+					const uint32_t* triangle = destination + adjacency[counter] * 3;
+
+					if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+					{
+						// Collapses away
+						continue;
+					}
+
+					const float* before[3] = { getPosition(triangle[0]), getPosition(triangle[1]), getPosition(triangle[2]) };
+					const float* after[3] = { before[0], before[1], before[2] };
+
+					for (uint32_t corner = 0; corner < 3; corner++)
+					{
+						if (triangle[corner] == from)
+						{
+							after[corner] = target;
+						}
+					}
+
+					float beforeEdge1[3] = { before[1][0] - before[0][0], before[1][1] - before[0][1], before[1][2] - before[0][2] };
+					float beforeEdge2[3] = { before[2][0] - before[0][0], before[2][1] - before[0][1], before[2][2] - before[0][2] };
+					float afterEdge1[3] = { after[1][0] - after[0][0], after[1][1] - after[0][1], after[1][2] - after[0][2] };
+					float afterEdge2[3] = { after[2][0] - after[0][0], after[2][1] - after[0][1], after[2][2] - after[0][2] };
+
+					double beforeNormal[3], afterNormal[3];
+					Cross(beforeEdge1, beforeEdge2, beforeNormal);
+					Cross(afterEdge1, afterEdge2, afterNormal);
+
+					double dot = beforeNormal[0] * afterNormal[0] + beforeNormal[1] * afterNormal[1] + beforeNormal[2] * afterNormal[2];
+					double beforeLength = beforeNormal[0] * beforeNormal[0] + beforeNormal[1] * beforeNormal[1] + beforeNormal[2] * beforeNormal[2];
+					double afterLength = afterNormal[0] * afterNormal[0] + afterNormal[1] * afterNormal[1] + afterNormal[2] * afterNormal[2];
+
+					// Turning by more than s_MaximumFlipCosine's angle counts as a flip, folds hide in smaller turns seldom
+					if (dot <= 0.0 || dot * dot < s_MaximumFlipCosine * s_MaximumFlipCosine * beforeLength * afterLength)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			};
+
+			for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+			{
+				remap[vertex] = vertex;
+			}
+			std::fill(bTouched.begin(), bTouched.end(), 0);
+
+			// A collapse removes two triangles (one on a border)
+			const uint32_t trianglesToRemove = (indexCount - targetNumberOfIndices) / 3;
+			uint32_t trianglesRemoved = 0;
+			uint32_t numberOfCollapses = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.m_Error > errorLimit || trianglesRemoved >= trianglesToRemove)
+				{
+					break;
+				}
+
+				if (bTouched[collapse.m_From] || bTouched[collapse.m_To] || flips(collapse.m_From, collapse.m_To))
+				{
+					continue;
+				}
+
+				remap[collapse.m_From] = collapse.m_To;
+				quadrics[collapse.m_To].Add(quadrics[collapse.m_From]);
+
+				// The neighbours of from keep still for the rest of the pass, as the flip test took their positions
+				for (uint32_t counter = adjacencyOffsets[collapse.m_From]; counter < adjacencyOffsets[collapse.m_From + 1]; counter++)
+				{
+					const uint32_t* triangle = destination + adjacency[counter] * 3;
+
+					bTouched[triangle[0]] = 1;
+					bTouched[triangle[1]] = 1;
+					bTouched[triangle[2]] = 1;
+				}
+
+				largestError = std::max(largestError, double(collapse.m_Error));
+				trianglesRemoved += vertexKinds[collapse.m_From] == VertexKind::Border ? 1 : 2;
+				numberOfCollapses++;
+			}
+
+			if (numberOfCollapses == 0)
+			{
+				break;
+			}
+
+			// The triangles again, less those collapsed to nothing
+			uint32_t writtenIndices = 0;
+
+			for (uint32_t triangle = 0; triangle < indexCount; triangle += 3)
+			{
+				uint32_t first = remap[destination[triangle]];
+				uint32_t second = remap[destination[triangle + 1]];
+				uint32_t third = remap[destination[triangle + 2]];
+
+				if (first == second || second == third || first == third)
+				{
+					continue;
+				}
+
+				destination[writtenIndices++] = first;
+				destination[writtenIndices++] = second;
+				destination[writtenIndices++] = third;
+			}
+
+			indexCount = writtenIndices;
+		}
+
+		if (resultError)
+		{
+			*resultError = float(std::sqrt(largestError));
+		}
+
+		return indexCount;
+	}
+
+	void MeshSimplifier::GenerateLODs(ImportedModel& model, const MeshOptimizationSettings& settings, JobPool* pool)
+	{
+		model.m_LODs.clear();
+
+		const BufferLayout& layout = model.m_Layout;
+
+		if (settings.m_NumberOfLODs == 0 || layout.GetElements().empty() || layout.GetElements()[0].Type != ShaderDataType::Float3 ||
+			layout.GetElements()[0].Offset != 0)
+		{
+			return;
+		}
+
+		const uint32_t strideInFloats = layout.GetStride() / sizeof(float);
+		const float* positions = reinterpret_cast<const float*>(model.m_VertexData.data());
+		const uint32_t numberOfSubmeshes = uint32_t(model.m_Submeshes.size());
+
+		// The indices of the previous level, per submesh and relative to it
+		std::vector<std::vector<uint32_t>> previousIndices(numberOfSubmeshes);
+
+		for (uint32_t submeshIndex = 0; submeshIndex < numberOfSubmeshes; submeshIndex++)
+		{
+			const Submesh& submesh = model.m_Submeshes[submeshIndex];
+
+			previousIndices[submeshIndex].resize(submesh.m_NumberOfIndices);
+			for (uint32_t counter = 0; counter < submesh.m_NumberOfIndices; counter++)
+			{
+				previousIndices[submeshIndex][counter] = model.m_Indices[submesh.m_FirstIndex + counter] - submesh.m_FirstVertex;
+			}
+		}
+
+		std::vector<float> submeshErrors(numberOfSubmeshes);
+		uint32_t previousNumberOfIndices = uint32_t(model.m_Indices.size());
+		float previousError = 0.0f;
+
+		for (uint32_t level = 1; level <= settings.m_NumberOfLODs; level++)
+		{
+			// Halving per level from the coarsest
+			const float targetError = settings.m_LODMaximumError * model.m_Bounds.m_Radius *
+				std::ldexp(1.0f, int32_t(level) - int32_t(settings.m_NumberOfLODs));
+
+			auto simplifyJob = [&](uint32_t submeshIndex)
+			{
+				const Submesh& submesh = model.m_Submeshes[submeshIndex];
+				std::vector<uint32_t>& indices = previousIndices[submeshIndex];
+
+				submeshErrors[submeshIndex] = 0.0f;
+
+				// Points and lines stay as they are
+				if (indices.size() % 3 != 0)
+				{
+					return;
+				}
+
+				uint32_t targetNumberOfIndices = uint32_t(float(indices.size() / 3) * settings.m_LODReduction) * 3;
+
+				uint32_t numberOfIndices = Simplify(positions + size_t(submesh.m_FirstVertex) * strideInFloats, strideInFloats,
+					submesh.m_NumberOfVertices, indices.data(), uint32_t(indices.size()), targetNumberOfIndices, targetError, indices.data(),
+					&submeshErrors[submeshIndex]);
+
+				indices.resize(numberOfIndices);
+
+				MeshOptimizer::OptimizeVertexCache(indices.data(), numberOfIndices, submesh.m_NumberOfVertices);
+			};
+
+			if (pool)
+			{
+				pool->ParallelFor(numberOfSubmeshes, simplifyJob);
+			}
+			else
+			{
+				for (uint32_t submeshIndex = 0; submeshIndex < numberOfSubmeshes; submeshIndex++)
+				{
+					simplifyJob(submeshIndex);
+				}
+			}
+
+			ImportedLOD lod;
+
+			for (uint32_t submeshIndex = 0; submeshIndex < numberOfSubmeshes; submeshIndex++)
+			{
+				const uint32_t firstVertex = model.m_Submeshes[submeshIndex].m_FirstVertex;
+
+				for (uint32_t index : previousIndices[submeshIndex])
+				{
+					lod.m_Indices.push_back(firstVertex + index);
+				}
+
+				lod.m_Error = std::max(lod.m_Error, submeshErrors[submeshIndex]);
+			}
+
+			// Measured against the previous level, so the errors of the levels add up to bound the distance from the model
+			lod.m_Error += previousError;
+
+			// Not worth an index buffer, nor are the levels past it
+			if (lod.m_Indices.empty() || float(lod.m_Indices.size()) > float(previousNumberOfIndices) * s_MinimumLODProgress)
+			{
+				break;
+			}
+
+			previousNumberOfIndices = uint32_t(lod.m_Indices.size());
+			previousError = lod.m_Error;
+			model.m_LODs.push_back(std::move(lod));
+		}
+	}
+}
@@ -0,0 +1,68 @@
+/**
+ * @file MeshSimplifier.h
+ * @brief This file contains the MeshSimplifier class, which makes the levels of detail of a model by quadric error edge collapses.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "ModelImporter.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	struct MeshOptimizationSettings;
+
+	/**
+	 * @brief Simplification of triangle lists by edge collapses ordered by quadric error (Garland and Heckbert), where each vertex collapses
+	 * into a neighbour instead of a new position, so that the simplified indices keep pointing into the original vertices and a level
+	 * of detail costs an index buffer only.
+	 *
+	 * Vertices are classified first: the inner ones collapse along any edge, those of the open borders only along the border (and border
+	 * planes in their quadrics keep the outline in place), and those of the attribute seams (several vertices at one position, split by
+	 * UV or normal) and of non manifold edges never collapse, so that the seams don't tear.
+	 *
+	 * @see MeshOptimizer::Optimize, Mesh::GetLODs
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API MeshSimplifier
+	{
+	public:
+		/**
+		 * @brief Simplifies a triangle list
+		 *
+		 * @param positions						First position (x, y, z floats)
+		 * @param strideInFloats				Distance, in floats, between consecutive positions
+		 * @param numberOfVertices				Indices are below this
+		 * @param indices						The triangle list
+		 * @param numberOfIndices				Number of indices, a multiple of 3
+		 * @param targetNumberOfIndices			Stops once the list is this short
+		 * @param targetError					Stops before a collapse would move the surface further than this (in the units of the positions)
+		 * @param destination					Output, numberOfIndices at most (may be indices)
+		 * @param resultError					Output, if not nullptr, the largest error of the collapses done
+		 *
+		 * @return Number of indices written to destination
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t Simplify(const float* positions, uint32_t strideInFloats, uint32_t numberOfVertices, const uint32_t* indices,
+			uint32_t numberOfIndices, uint32_t targetNumberOfIndices, float targetError, uint32_t* destination, float* resultError = nullptr);
+
+		/**
+		 * @brief Fills ImportedModel::m_LODs: each level simplifies every submesh of the previous one to settings.m_LODReduction of its
+		 * triangles, with an error bound doubling per level up to settings.m_LODMaximumError of the model's radius for the coarsest.
+		 * Stops early once a level barely reduces the previous one. The layout must start with the Float3 positions (as imported).
+		 *
+		 * @param model							The model, welded (MeshOptimizationSettings::m_bWeldVertices), or every triangle is on a border
+		 * @param settings						m_NumberOfLODs, m_LODReduction and m_LODMaximumError are used
+		 * @param pool							Pool to simplify the submeshes on, nullptr simplifies them on the calling thread
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void GenerateLODs(ImportedModel& model, const MeshOptimizationSettings& settings, JobPool* pool);
+	};
+}
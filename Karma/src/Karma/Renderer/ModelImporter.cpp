@@ -0,0 +1,334 @@
+#include "ModelImporter.h"
+#include "VertexConversionProgram.h"
+#include "Karma/JobPool.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace Karma
+{
+	namespace
+	{
+		// Below this (in magnitude) a node transform's determinant is taken for 0, the inverse being of no use
+		constexpr float s_SingularDeterminant = 1e-12f;
+
+		// A mesh as a node refers to it, with the accumulated transform of the node
+		struct MeshInstance
+		{
+			const aiMesh* m_Mesh;
+			aiMatrix4x4 m_Transform;
+		};
+
+		// The directions of the shared layout, and where they sit in a vertex (in floats)
+		struct LayoutOffsets
+		{
+			uint32_t m_Stride = 0;
+			int32_t m_Normal = -1;
+			int32_t m_Tangent = -1;
+		};
+
+		void CollectInstances(const aiNode* nodeToProcess, const aiScene* theScene, const aiMatrix4x4& parentTransform,
+			std::vector<MeshInstance>& instances)
+		{
+			aiMatrix4x4 transform = parentTransform * nodeToProcess->mTransformation;
+
+			for (unsigned int i = 0; i < nodeToProcess->mNumMeshes; i++)
+			{
+				instances.push_back({ theScene->mMeshes[nodeToProcess->mMeshes[i]], transform });
+			}
+
+			for (unsigned int i = 0; i < nodeToProcess->mNumChildren; i++)
+			{
+				CollectInstances(nodeToProcess->mChildren[i], theScene, transform, instances);
+			}
+		}
+
+		uint32_t CountIndices(const aiMesh* meshToProcess)
+		{
+			// Triangulated, the usual case, needs no walk over the faces
+			if (meshToProcess->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+			{
+				return meshToProcess->mNumFaces * 3;
+			}
+
+			uint32_t numberOfIndices = 0;
+			for (unsigned int i = 0; i < meshToProcess->mNumFaces; i++)
+			{
+				numberOfIndices += meshToProcess->mFaces[i].mNumIndices;
+			}
+
+			return numberOfIndices;
+		}
+
+		LayoutOffsets GetLayoutOffsets(const BufferLayout& layout)
+		{
+			LayoutOffsets offsets;
+
+			for (const BufferElement& layoutElem : layout.GetElements())
+			{
+				int32_t offset = int32_t(layoutElem.Offset / sizeof(float));
+
+				if (layoutElem.Name == "v_Normal")
+				{
+					offsets.m_Normal = offset;
+				}
+				else if (layoutElem.Name == "v_Tangent")
+				{
+					offsets.m_Tangent = offset;
+				}
+			}
+
+			offsets.m_Stride = layout.GetStride() / sizeof(float);
+
+			return offsets;
+		}
+
+		// Transforms and normalizes the directions (normals or tangents) in place
+		void TransformDirections(float* vertexData, uint32_t numberOfVertices, uint32_t strideInFloats, const aiMatrix3x3& directionTransform)
+		{
+			for (uint32_t i = 0; i < numberOfVertices; i++)
+			{
+				float* direction = vertexData + size_t(i) * strideInFloats;
+
+				aiVector3D transformed = directionTransform * aiVector3D(direction[0], direction[1], direction[2]);
+				transformed.NormalizeSafe();
+
+				direction[0] = transformed.x;
+				direction[1] = transformed.y;
+				direction[2] = transformed.z;
+			}
+		}
+
+		// Interleaves the instance into its range of the shared data
+		void ConvertInstance(const MeshInstance& instance, const VertexConversionProgram& conversionProgram, const LayoutOffsets& offsets,
+			float* vertexData, uint32_t* indexData, Submesh& submesh)
+		{
+			const aiMesh* meshToProcess = instance.m_Mesh;
+
+			conversionProgram.Convert(meshToProcess, vertexData);
+
+			// Then the node transform, in place
+			if (!instance.m_Transform.IsIdentity())
+			{
+				for (unsigned int i = 0; i < meshToProcess->mNumVertices; i++)
+				{
+					float* position = vertexData + size_t(i) * offsets.m_Stride;
+
+					aiVector3D transformed = instance.m_Transform * aiVector3D(position[0], position[1], position[2]);
+
+					position[0] = transformed.x;
+					position[1] = transformed.y;
+					position[2] = transformed.z;
+				}
+
+				// Tangents lie along the surface, so they go by the matrix itself. Normals go by the inverse transpose, so that non uniform
+				// scales keep them perpendicular to the surface.
+				const aiMatrix3x3 tangentTransform = aiMatrix3x3(instance.m_Transform);
+				aiMatrix3x3 normalTransform = tangentTransform;
+
+				// A singular matrix (a scale of 0 along some axis) has no inverse, Inverse() fills it with NaNs. The normals go by the
+				// matrix itself then, the surface being flat anyway.
+				if (std::abs(tangentTransform.Determinant()) > s_SingularDeterminant)
+				{
+					normalTransform.Inverse().Transpose();
+				}
+
+				if (offsets.m_Normal >= 0)
+				{
+					TransformDirections(vertexData + offsets.m_Normal, meshToProcess->mNumVertices, offsets.m_Stride, normalTransform);
+				}
+				if (offsets.m_Tangent >= 0)
+				{
+					TransformDirections(vertexData + offsets.m_Tangent, meshToProcess->mNumVertices, offsets.m_Stride, tangentTransform);
+				}
+			}
+
+			uint32_t counter = 0;
+
+			for (unsigned int i = 0; i < meshToProcess->mNumFaces; i++)
+			{
+				for (unsigned int j = 0; j < meshToProcess->mFaces[i].mNumIndices; j++)
+				{
+					indexData[counter++] = submesh.m_FirstVertex + meshToProcess->mFaces[i].mIndices[j];
+				}
+			}
+
+			submesh.m_Bounds = RenderBounds::FromPositions(vertexData, meshToProcess->mNumVertices, offsets.m_Stride);
+		}
+	}
+
+	bool ModelImporter::Import(const std::string& filePath, bool bFlipUVs, ImportedModel& model, JobPool* pool, ModelImportStatistics* statistics)
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		Assimp::Importer assImporter;
+
+		uint32_t importFlags = aiProcess_Triangulate;
+
+		if (bFlipUVs)
+		{
+			importFlags = importFlags | aiProcess_FlipUVs;
+		}
+
+		const aiScene* scene = assImporter.ReadFile(filePath, importFlags);
+
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			KR_CORE_ERROR("ERROR ASSIMP:: {0}", assImporter.GetErrorString());
+			return false;
+		}
+
+		std::chrono::high_resolution_clock::time_point read = std::chrono::high_resolution_clock::now();
+
+		if (!ConvertScene(scene, model, pool))
+		{
+			KR_CORE_WARN("ModelImporter: {0} has no mesh", filePath);
+			return false;
+		}
+
+		std::chrono::high_resolution_clock::time_point converted = std::chrono::high_resolution_clock::now();
+
+		if (statistics)
+		{
+			statistics->m_NumberOfSubmeshes = uint32_t(model.m_Submeshes.size());
+			statistics->m_NumberOfVertices = model.m_NumberOfVertices;
+			statistics->m_NumberOfIndices = model.GetNumberOfIndices();
+			statistics->m_NumberOfThreads = pool ? pool->GetNumberOfWorkers() + 1 : 1;
+			statistics->m_ReadMilliseconds = std::chrono::duration<double, std::milli>(read - begin).count();
+			statistics->m_ConvertMilliseconds = std::chrono::duration<double, std::milli>(converted - read).count();
+		}
+
+		return true;
+	}
+
+	bool ModelImporter::ConvertScene(const aiScene* scene, ImportedModel& model, JobPool* pool)
+	{
+		std::vector<MeshInstance> instances;
+		CollectInstances(scene->mRootNode, scene, aiMatrix4x4(), instances);
+
+		if (instances.empty())
+		{
+			return false;
+		}
+
+		model.m_Layout = GaugeSceneLayout(scene);
+		LayoutOffsets offsets = GetLayoutOffsets(model.m_Layout);
+
+		VertexConversionProgram conversionProgram(model.m_Layout);
+
+		// The ranges first, so that every submesh knows where to write
+		model.m_Submeshes.resize(instances.size());
+
+		uint32_t numberOfVertices = 0;
+		uint32_t numberOfIndices = 0;
+
+		for (size_t counter = 0; counter < instances.size(); counter++)
+		{
+			Submesh& submesh = model.m_Submeshes[counter];
+
+			submesh.m_Name = instances[counter].m_Mesh->mName.C_Str();
+			submesh.m_FirstVertex = numberOfVertices;
+			submesh.m_NumberOfVertices = instances[counter].m_Mesh->mNumVertices;
+			submesh.m_FirstIndex = numberOfIndices;
+			submesh.m_NumberOfIndices = CountIndices(instances[counter].m_Mesh);
+			submesh.m_MaterialIndex = instances[counter].m_Mesh->mMaterialIndex;
+
+			numberOfVertices += submesh.m_NumberOfVertices;
+			numberOfIndices += submesh.m_NumberOfIndices;
+		}
+
+		model.m_NumberOfVertices = numberOfVertices;
+		model.m_VertexData.resize(size_t(numberOfVertices) * model.m_Layout.GetStride());
+		model.m_Indices.resize(numberOfIndices);
+		model.m_ShortIndices.clear();
+		model.m_LODs.clear();
+
+		auto convertJob = [&](uint32_t submeshIndex)
+		{
+			Submesh& submesh = model.m_Submeshes[submeshIndex];
+
+			float* vertexData = reinterpret_cast<float*>(model.m_VertexData.data());
+
+			ConvertInstance(instances[submeshIndex], conversionProgram, offsets, vertexData + size_t(submesh.m_FirstVertex) * offsets.m_Stride,
+				model.m_Indices.data() + submesh.m_FirstIndex, submesh);
+		};
+
+		if (pool)
+		{
+			pool->ParallelFor(uint32_t(instances.size()), convertJob);
+		}
+		else
+		{
+			for (uint32_t counter = 0; counter < uint32_t(instances.size()); counter++)
+			{
+				convertJob(counter);
+			}
+		}
+
+		std::vector<RenderBounds> submeshBounds;
+		for (const Submesh& submesh : model.m_Submeshes)
+		{
+			submeshBounds.push_back(submesh.m_Bounds);
+		}
+
+		model.m_Bounds = RenderBounds::Enclose(submeshBounds.data(), uint32_t(submeshBounds.size()));
+
+		return true;
+	}
+
+	IndexBuffer* ImportedModel::CreateIndexBuffer()
+	{
+		if (!m_ShortIndices.empty())
+		{
+			return IndexBuffer::Create(m_ShortIndices.data(), uint32_t(m_ShortIndices.size()));
+		}
+
+		return IndexBuffer::Create(m_Indices.data(), uint32_t(m_Indices.size()));
+	}
+
+	IndexBuffer* ImportedLOD::CreateIndexBuffer()
+	{
+		if (!m_ShortIndices.empty())
+		{
+			return IndexBuffer::Create(m_ShortIndices.data(), uint32_t(m_ShortIndices.size()));
+		}
+
+		return IndexBuffer::Create(m_Indices.data(), uint32_t(m_Indices.size()));
+	}
+
+	BufferLayout ModelImporter::GaugeSceneLayout(const aiScene* scene)
+	{
+		bool bUV = false, bColor = false, bNormal = false, bTangent = false;
+
+		for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+		{
+			bUV = bUV || scene->mMeshes[i]->mTextureCoords[0] != nullptr;
+			bColor = bColor || scene->mMeshes[i]->mColors[0] != nullptr;
+			bNormal = bNormal || scene->mMeshes[i]->mNormals != nullptr;
+			bTangent = bTangent || scene->mMeshes[i]->mTangents != nullptr;
+		}
+
+		BufferLayout buffLayout;
+
+		buffLayout.PushElement({ ShaderDataType::Float3, "v_Position" });
+
+		if (bUV)
+		{
+			buffLayout.PushElement({ ShaderDataType::Float2, "v_UV" });
+		}
+		if (bColor)
+		{
+			buffLayout.PushElement({ ShaderDataType::Float4, "v_Color" });
+		}
+		if (bNormal)
+		{
+			buffLayout.PushElement({ ShaderDataType::Float3, "v_Normal" });
+		}
+		if (bTangent)
+		{
+			buffLayout.PushElement({ ShaderDataType::Float3, "v_Tangent" });
+		}
+
+		return buffLayout;
+	}
+}
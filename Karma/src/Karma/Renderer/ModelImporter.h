@@ -0,0 +1,219 @@
+/**
+ * @file ModelImporter.h
+ * @brief This file contains the ModelImporter class, which imports every mesh of a model file into shared vertex and index data.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Mesh.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class JobPool;
+
+	/**
+	 * @brief A level of detail of an ImportedModel, coarser indices into the same vertices (see MeshSimplifier::GenerateLODs)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API ImportedLOD
+	{
+		/**
+		 * @brief Indices of all of the submeshes, simplified, into ImportedModel::m_VertexData
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint32_t> m_Indices;
+
+		/**
+		 * @brief The indices as 16 bit, used instead of m_Indices when not empty (as ImportedModel::m_ShortIndices)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint16_t> m_ShortIndices;
+
+		/**
+		 * @brief Largest distance, in the space of the model, between the simplified surface and the original one (as the quadrics measure it)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Error = 0.0f;
+
+		/**
+		 * @brief Number of indices, of whichever width
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfIndices() const { return uint32_t(m_ShortIndices.empty() ? m_Indices.size() : m_ShortIndices.size()); }
+
+		/**
+		 * @brief Creates the index buffer of the width in use
+		 *
+		 * @since Karma 1.0.0
+		 */
+		IndexBuffer* CreateIndexBuffer();
+	};
+
+	/**
+	 * @brief A model imported by ModelImporter, ready for VertexBuffer::Create and IndexBuffer::Create
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API ImportedModel
+	{
+		/**
+		 * @brief Layout shared by all of the submeshes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		BufferLayout m_Layout;
+
+		/**
+		 * @brief Interleaved vertices of all of the submeshes, one after the other. Floats as imported, packed once quantized (MeshOptimizer).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint8_t> m_VertexData;
+
+		/**
+		 * @brief Number of vertices in m_VertexData
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfVertices = 0;
+
+		/**
+		 * @brief Indices of all of the submeshes, into m_VertexData (not relative to the submesh)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint32_t> m_Indices;
+
+		/**
+		 * @brief The indices as 16 bit, used instead of m_Indices when not empty (see MeshOptimizationSettings::m_bAllowShortIndices)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint16_t> m_ShortIndices;
+
+		/**
+		 * @brief Number of indices, of whichever width
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfIndices() const { return uint32_t(m_ShortIndices.empty() ? m_Indices.size() : m_ShortIndices.size()); }
+
+		/**
+		 * @brief Creates the index buffer of the width in use
+		 *
+		 * @since Karma 1.0.0
+		 */
+		IndexBuffer* CreateIndexBuffer();
+
+		/**
+		 * @brief The ranges, in node order
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<Submesh> m_Submeshes;
+
+		/**
+		 * @brief Bounds of the whole of the model
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds m_Bounds;
+
+		/**
+		 * @brief Levels of detail, from the finest to the coarsest, empty unless MeshOptimizer made them
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<ImportedLOD> m_LODs;
+	};
+
+	/**
+	 * @brief Counters of the latest ModelImporter::Import
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API ModelImportStatistics
+	{
+		uint32_t m_NumberOfSubmeshes = 0;
+		uint32_t m_NumberOfVertices = 0;
+		uint32_t m_NumberOfIndices = 0;
+
+		/**
+		 * @brief Threads which converted the submeshes (the calling one included)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfThreads = 0;
+
+		/**
+		 * @brief Time Assimp took to read the file
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_ReadMilliseconds = 0.0;
+
+		/**
+		 * @brief Time taken to walk the nodes and convert the submeshes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_ConvertMilliseconds = 0.0;
+	};
+
+	/**
+	 * @brief Imports all of the meshes of a model, unlike Mesh::ProcessNode which stops at the first one.
+	 *
+	 * The whole of the node hierarchy is walked. Every mesh a node refers to becomes a submesh, with its positions, normals and tangents
+	 * transformed by the node's (accumulated) transform. All of the submeshes share one layout: the attributes present in any of the meshes,
+	 * with defaults where a mesh lacks one. The ranges of the submeshes are laid out first, then the submeshes are converted in parallel on a
+	 * JobPool, each into its own range of the shared data.
+	 *
+	 * @see Mesh::Mesh(const std::string&), CookedMesh::Cook
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API ModelImporter
+	{
+	public:
+		/**
+		 * @brief Reads the model file with Assimp and converts it
+		 *
+		 * @param filePath						The model file
+		 * @param bFlipUVs						Whether to flip the texture coordinates (aiProcess_FlipUVs), as Vulkan wants them
+		 * @param model							Output
+		 * @param pool							Pool to convert the submeshes on, nullptr converts them on the calling thread
+		 * @param statistics					Output, if not nullptr
+		 *
+		 * @return false if the file can't be read or has no mesh
+		 * @since Karma 1.0.0
+		 */
+		static bool Import(const std::string& filePath, bool bFlipUVs, ImportedModel& model, JobPool* pool,
+			ModelImportStatistics* statistics = nullptr);
+
+		/**
+		 * @brief Converts a scene already read
+		 *
+		 * @return false if the scene has no mesh
+		 * @since Karma 1.0.0
+		 */
+		static bool ConvertScene(const aiScene* scene, ImportedModel& model, JobPool* pool);
+
+		/**
+		 * @brief The layout holding every attribute present in any of the meshes, in the order of Mesh::GaugeVertexDataLayout
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static BufferLayout GaugeSceneLayout(const aiScene* scene);
+	};
+}
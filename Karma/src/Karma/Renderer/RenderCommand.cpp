@@ -1,6 +1,9 @@
 #include "RenderCommand.h"
+#include "Material.h"
+#include "UniformBufferRing.h"
 #include "Platform/OpenGL/OpenGLRendererAPI.h"
 #include "Platform/Vulkan/VulkanRendererAPI.h"
+#include "Platform/Null/NullRendererAPI.h"
 
 namespace Karma
 {
@@ -19,6 +22,9 @@ namespace Karma
 			case RendererAPI::API::Vulkan:
 				s_RendererAPI = new VulkanRendererAPI();
 				break;
+			case RendererAPI::API::Null:
+				s_RendererAPI = new NullRendererAPI();
+				break;
 			default:
 				KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
 				break;
@@ -34,4 +40,65 @@ namespace Karma
 
 		KR_CORE_INFO("Deinitialized RenderCommand");
 	}
+
+	void RenderCommand::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray)
+	{
+		const uint32_t uniformRingOffset = GetUniformRingOffset(vertexArray);
+
+		// The uniforms didn't fit in the frame's region of the ring
+		if (uniformRingOffset == UniformBufferRing::s_InvalidOffset)
+		{
+			return;
+		}
+
+		if (!RenderThread::IsDeferring())
+		{
+			s_RendererAPI->DrawIndexed(vertexArray);
+			return;
+		}
+
+		RenderThread::Enqueue([vertexArray, uniformRingOffset]()
+		{
+			s_RendererAPI->DrawIndexedRecorded(vertexArray, uniformRingOffset);
+		});
+	}
+
+	void RenderCommand::DrawIndexedInstanced(const std::shared_ptr<VertexArray>& vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount)
+	{
+		const uint32_t uniformRingOffset = GetUniformRingOffset(vertexArray);
+
+		if (uniformRingOffset == UniformBufferRing::s_InvalidOffset)
+		{
+			return;
+		}
+
+		if (!RenderThread::IsDeferring())
+		{
+			s_RendererAPI->DrawIndexedInstanced(vertexArray, worldMatrices, instanceCount);
+			return;
+		}
+
+		// The caller's matrices are reused for the next batch, the frame's queue keeps a copy till the draw has run
+		const uint32_t matricesSize = instanceCount * uint32_t(sizeof(glm::mat4));
+		glm::mat4* recordedMatrices = static_cast<glm::mat4*>(RenderThread::AllocateFrameData(matricesSize));
+		memcpy(recordedMatrices, worldMatrices, matricesSize);
+
+		RenderThread::Enqueue([vertexArray, recordedMatrices, instanceCount, uniformRingOffset]()
+		{
+			s_RendererAPI->DrawIndexedInstancedRecorded(vertexArray, recordedMatrices, instanceCount, uniformRingOffset);
+		});
+	}
+
+	uint32_t RenderCommand::GetUniformRingOffset(const std::shared_ptr<VertexArray>& vertexArray)
+	{
+		std::shared_ptr<Material> material = vertexArray->GetMaterial();
+		std::shared_ptr<Shader> shader = material ? material->GetShader(0) : nullptr;
+
+		if (!shader || !shader->GetUniformBufferObject())
+		{
+			return 0;
+		}
+
+		return shader->GetUniformBufferObject()->GetRingOffset();
+	}
 }
\ No newline at end of file
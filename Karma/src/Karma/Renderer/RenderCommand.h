@@ -12,11 +12,15 @@
 #include "krpch.h"
 
 #include "RendererAPI.h"
+#include "RenderThread.h"
+#include "RenderTarget.h"
 
 namespace Karma
 {
 	/**
 	 * @brief A class with static routines relevant for rendering a scene using RendererAPI
+	 *
+	 * The routines go through RenderThread::Enqueue, so they run right away, or on the render thread when it is pipelining.
 	 */
 	class KARMA_API RenderCommand
 	{
@@ -44,7 +48,10 @@ namespace Karma
 		 */
 		inline static void SetClearColor(const glm::vec4& color)
 		{
-			s_RendererAPI->SetClearColor(color);
+			RenderThread::Enqueue([color]()
+			{
+				s_RendererAPI->SetClearColor(color);
+			});
 		}
 
 		/**
@@ -57,7 +64,10 @@ namespace Karma
 		 */
 		inline static void Clear()
 		{
-			s_RendererAPI->Clear();
+			RenderThread::Enqueue([]()
+			{
+				s_RendererAPI->Clear();
+			});
 		}
 
 		/**
@@ -80,7 +90,10 @@ namespace Karma
 		 */
 		inline static void BeginScene()
 		{
-			s_RendererAPI->BeginScene();
+			RenderThread::Enqueue([]()
+			{
+				s_RendererAPI->BeginScene();
+			});
 		}
 
 		/**
@@ -91,11 +104,65 @@ namespace Karma
 		 *
 		 * @param vertexArray				The mesh + material to be rendered
 		 *
+		 * @note When recorded for the render thread, the offset of the uploaded uniforms is taken now (see RendererAPI::DrawIndexedRecorded)
 		 * @since Karma 1.0.0
 		 */
-		inline static void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray)
+		static void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray);
+
+		/**
+		 * @brief Issue an instanced draw (glDrawElementsInstanced, or vkCmdDrawIndexed with instanceCount) of the vertex array
+		 *
+		 * @param vertexArray				The mesh + material to be rendered
+		 * @param worldMatrices				Per instance world matrices
+		 * @param instanceCount				Number of instances
+		 *
+		 * @note When recorded for the render thread, the matrices are copied into the frame's queue
+		 * @see RendererAPI::DrawIndexedInstanced
+		 * @since Karma 1.0.0
+		 */
+		static void DrawIndexedInstanced(const std::shared_ptr<VertexArray>& vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount);
+
+		/**
+		 * @brief Starts a pass of the view, see RendererAPI::BeginPass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		inline static void BeginPass(RenderPassType pass)
 		{
-			s_RendererAPI->DrawIndexed(vertexArray);
+			RenderThread::Enqueue([pass]()
+			{
+				s_RendererAPI->BeginPass(pass);
+			});
+		}
+
+		/**
+		 * @brief Ends the pass, see RendererAPI::EndPass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		inline static void EndPass()
+		{
+			RenderThread::Enqueue([]()
+			{
+				s_RendererAPI->EndPass();
+			});
+		}
+
+		/**
+		 * @brief Renders the following scenes into the offscreen target, nullptr for back to the window. Set it before Clear and BeginScene
+		 * and reset it after EndScene.
+		 *
+		 * @param renderTarget				The target, held by the queued command till the render thread has set it
+		 *
+		 * @see RendererAPI::SetRenderTarget
+		 * @since Karma 1.0.0
+		 */
+		inline static void SetRenderTarget(const std::shared_ptr<RenderTarget>& renderTarget)
+		{
+			RenderThread::Enqueue([renderTarget]()
+			{
+				s_RendererAPI->SetRenderTarget(renderTarget.get());
+			});
 		}
 
 		/**
@@ -105,7 +172,10 @@ namespace Karma
 		 */
 		static void EndScene()
 		{
-			s_RendererAPI->EndScene();
+			RenderThread::Enqueue([]()
+			{
+				s_RendererAPI->EndScene();
+			});
 		}
 		
 		/**
@@ -125,6 +195,14 @@ namespace Karma
 		 */
 		inline static RendererAPI* GetRendererAPI() { return s_RendererAPI; }
 
+	private:
+		/**
+		 * @brief UniformBufferObject::GetRingOffset of the vertex array's (first) shader, 0 if there are no uniforms
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetUniformRingOffset(const std::shared_ptr<VertexArray>& vertexArray);
+
 	private:
 		static RendererAPI* s_RendererAPI;
 	};
@@ -0,0 +1,103 @@
+#include "RenderCommandQueue.h"
+
+namespace Karma
+{
+	RenderCommandQueue::RenderCommandQueue(uint32_t blockSize) : m_CurrentBlock(0), m_BlockSize(AlignUp(blockSize)), m_NumberOfCommands(0),
+		m_RecordedSize(0)
+	{
+	}
+
+	RenderCommandQueue::~RenderCommandQueue()
+	{
+		Drain(false);
+
+		for (const Block& block : m_Blocks)
+		{
+			::operator delete(block.m_Memory, std::align_val_t(s_Alignment));
+		}
+		m_Blocks.clear();
+	}
+
+	uint8_t* RenderCommandQueue::Allocate(uint32_t size, CommandFunction execute, CommandFunction destroy)
+	{
+		const uint32_t headerSize = AlignUp(sizeof(CommandHeader));
+		const uint32_t totalSize = headerSize + AlignUp(size);
+
+		// Move on to the next block (reused, or a fresh one) if the present one can't hold the command
+		while (m_CurrentBlock < m_Blocks.size() && m_Blocks[m_CurrentBlock].m_Used + totalSize > m_Blocks[m_CurrentBlock].m_Capacity)
+		{
+			m_CurrentBlock++;
+		}
+
+		if (m_CurrentBlock == m_Blocks.size())
+		{
+			Block block;
+			block.m_Capacity = totalSize > m_BlockSize ? totalSize : m_BlockSize;
+			block.m_Memory = static_cast<uint8_t*>(::operator new(block.m_Capacity, std::align_val_t(s_Alignment)));
+			block.m_Used = 0;
+
+			m_Blocks.push_back(block);
+		}
+
+		Block& block = m_Blocks[m_CurrentBlock];
+
+		CommandHeader* header = new (block.m_Memory + block.m_Used) CommandHeader();
+		header->m_Execute = execute;
+		header->m_Destroy = destroy;
+		header->m_Size = totalSize;
+
+		uint8_t* memory = block.m_Memory + block.m_Used + headerSize;
+
+		block.m_Used += totalSize;
+		m_RecordedSize += totalSize;
+
+		return memory;
+	}
+
+	void* RenderCommandQueue::AllocateData(uint32_t size)
+	{
+		return Allocate(size, nullptr, nullptr);
+	}
+
+	void RenderCommandQueue::Execute()
+	{
+		Drain(true);
+	}
+
+	void RenderCommandQueue::Drain(bool bExecute)
+	{
+		const uint32_t headerSize = AlignUp(sizeof(CommandHeader));
+
+		for (uint32_t blockIndex = 0; blockIndex < m_Blocks.size() && blockIndex <= m_CurrentBlock; blockIndex++)
+		{
+			Block& block = m_Blocks[blockIndex];
+
+			uint32_t offset = 0;
+			while (offset < block.m_Used)
+			{
+				CommandHeader* header = reinterpret_cast<CommandHeader*>(block.m_Memory + offset);
+				void* command = block.m_Memory + offset + headerSize;
+
+				if (header->m_Execute)
+				{
+					if (bExecute)
+					{
+						header->m_Execute(command);
+					}
+					else
+					{
+						header->m_Destroy(command);
+					}
+				}
+
+				offset += header->m_Size;
+			}
+
+			block.m_Used = 0;
+		}
+
+		m_CurrentBlock = 0;
+		m_NumberOfCommands = 0;
+		m_RecordedSize = 0;
+	}
+}
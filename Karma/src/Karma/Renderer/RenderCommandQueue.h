@@ -0,0 +1,169 @@
+/**
+ * @file RenderCommandQueue.h
+ * @brief This file contains RenderCommandQueue class, the linear buffer in which render commands of a frame are recorded for later execution.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Karma
+{
+	/**
+	 * @brief A single producer, single consumer buffer of render commands (callables, usually lambdas capturing their arguments by value).
+	 *
+	 * Commands are placement constructed, one after the other, in fixed size blocks which are kept around across frames, so recording a
+	 * frame does no heap allocation once the blocks have grown to the size of the frame. The queue is not synchronized: RenderThread owns two of
+	 * them and hands one over to the render thread only after the game thread is done recording it.
+	 *
+	 * @see RenderThread
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API RenderCommandQueue
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param blockSize						Size (in bytes) of the blocks in which the commands are placed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderCommandQueue(uint32_t blockSize = 64 * 1024);
+
+		/**
+		 * @brief Destroys the commands not yet executed (without executing them) and frees the blocks
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~RenderCommandQueue();
+
+		RenderCommandQueue(const RenderCommandQueue&) = delete;
+		RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+		/**
+		 * @brief Records a command, executed (and then destroyed) by Execute
+		 *
+		 * @param command						A callable taking no argument
+		 *
+		 * @since Karma 1.0.0
+		 */
+		template<typename CommandT>
+		void Enqueue(CommandT&& command)
+		{
+			using CommandType = std::decay_t<CommandT>;
+
+			static_assert(alignof(CommandType) <= s_Alignment, "Render command is over aligned");
+
+			uint8_t* memory = Allocate(sizeof(CommandType), &ExecuteAndDestroy<CommandType>, &Destroy<CommandType>);
+			new (memory) CommandType(std::forward<CommandT>(command));
+
+			m_NumberOfCommands++;
+		}
+
+		/**
+		 * @brief Memory, for the data (arrays say) a command refers to, which stays valid till the commands recorded so far are executed
+		 *
+		 * @param size							Bytes needed, aligned to s_Alignment
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void* AllocateData(uint32_t size);
+
+		/**
+		 * @brief Executes the commands in the order they were recorded, destroys them and empties the queue (keeping the blocks)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Execute();
+
+		/**
+		 * @brief Number of commands recorded since the last Execute
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfCommands() const { return m_NumberOfCommands; }
+
+		/**
+		 * @brief Bytes (commands, data and headers) recorded since the last Execute
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetRecordedSize() const { return m_RecordedSize; }
+
+		/**
+		 * @brief Alignment of the commands and of AllocateData
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_Alignment = 16;
+
+	private:
+		typedef void (*CommandFunction)(void* command);
+
+		/**
+		 * @brief Precedes every command (and data) in the block. A null m_Execute marks data, which is skipped.
+		 */
+		struct CommandHeader
+		{
+			CommandFunction m_Execute;
+			CommandFunction m_Destroy;
+			uint32_t m_Size;
+		};
+
+		struct Block
+		{
+			uint8_t* m_Memory;
+			uint32_t m_Capacity;
+			uint32_t m_Used;
+		};
+
+		template<typename CommandType>
+		static void ExecuteAndDestroy(void* memory)
+		{
+			CommandType* command = static_cast<CommandType*>(memory);
+			(*command)();
+			command->~CommandType();
+		}
+
+		template<typename CommandType>
+		static void Destroy(void* memory)
+		{
+			static_cast<CommandType*>(memory)->~CommandType();
+		}
+
+		/**
+		 * @brief Reserves a header and size bytes after it, in the current block or in a fresh one
+		 *
+		 * @return The memory after the header
+		 * @since Karma 1.0.0
+		 */
+		uint8_t* Allocate(uint32_t size, CommandFunction execute, CommandFunction destroy);
+
+		/**
+		 * @brief Runs (execute = true) or just destroys the recorded commands, and rewinds the blocks
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Drain(bool bExecute);
+
+		static uint32_t AlignUp(uint32_t size)
+		{
+			return (size + s_Alignment - 1) & ~(s_Alignment - 1);
+		}
+
+	private:
+		std::vector<Block> m_Blocks;
+		uint32_t m_CurrentBlock;
+
+		uint32_t m_BlockSize;
+
+		uint32_t m_NumberOfCommands;
+		uint32_t m_RecordedSize;
+	};
+}
@@ -0,0 +1,109 @@
+/**
+ * @file RenderPass.h
+ * @brief This file contains RenderPassType, the passes Renderer::Submit splits a view's draws into, and their counters.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief The passes of a view, in the order they are drawn
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class RenderPassType : uint8_t
+	{
+		/**
+		 * @brief Optional. The opaque draws, front to back, writing depth only (no color, and with backends which can, only the positions
+		 * are fetched). The opaque pass that follows then shades each pixel about once.
+		 */
+		DepthPrePass = 0,
+
+		/**
+		 * @brief Opaque draws, front to back by quantized depth and by state (RenderSortKey) within a depth bucket
+		 */
+		Opaque,
+
+		/**
+		 * @brief Transparent draws (Material::IsTransparent), back to front, blended and without depth writes
+		 */
+		Transparent
+	};
+
+	/**
+	 * @brief Number of RenderPassType values
+	 *
+	 * @since Karma 1.0.0
+	 */
+	constexpr uint32_t s_NumberOfRenderPasses = 3;
+
+	/**
+	 * @brief Name of the pass, for logs
+	 *
+	 * @since Karma 1.0.0
+	 */
+	inline const char* GetRenderPassName(RenderPassType pass)
+	{
+		switch (pass)
+		{
+			case RenderPassType::DepthPrePass:
+				return "DepthPrePass";
+			case RenderPassType::Opaque:
+				return "Opaque";
+			case RenderPassType::Transparent:
+				return "Transparent";
+		}
+
+		return "Unknown";
+	}
+
+	/**
+	 * @brief Counters of a pass in the latest Renderer::Submit
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderPassStatistics
+	{
+		/**
+		 * @brief Number of draw calls issued (an instanced draw counts one)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfDraws = 0;
+
+		/**
+		 * @brief Number of proxies drawn
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfProxies = 0;
+
+		/**
+		 * @brief Time Renderer::Submit took to issue the draws of the pass (CPU side, the GPU time is not measured here)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_SubmitTimeMicroseconds = 0;
+
+		/**
+		 * @brief Fragment shader invocations of the pass, from the pipeline statistics queries of the backend. Lags the submission by the
+		 * frames in flight.
+		 *
+		 * @see RendererAPI::GetFragmentInvocations
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_FragmentInvocations = 0;
+
+		/**
+		 * @brief Whether m_FragmentInvocations holds a measurement (the backend supports the queries and results have arrived)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bHasFragmentInvocations = false;
+	};
+}
@@ -0,0 +1,584 @@
+#include "RenderScene.h"
+#include "VertexArray.h"
+#include "Mesh.h"
+#include "RenderThread.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+namespace Karma
+{
+	RenderBounds RenderBounds::Transform(const glm::mat4& worldMatrix) const
+	{
+		RenderBounds worldBounds;
+
+		worldBounds.m_Center = glm::vec3(worldMatrix * glm::vec4(m_Center, 1.0f));
+
+		// Extents of the rotated (and scaled) box are |M| * extents
+		glm::mat3 linearPart = glm::mat3(worldMatrix);
+		for (int column = 0; column < 3; column++)
+		{
+			worldBounds.m_Extents += glm::abs(linearPart[column]) * m_Extents[column];
+		}
+
+		float maxScale = std::max({ glm::length(linearPart[0]), glm::length(linearPart[1]), glm::length(linearPart[2]) });
+		worldBounds.m_Radius = m_Radius * maxScale;
+
+		return worldBounds;
+	}
+
+	RenderBounds RenderBounds::Unbounded()
+	{
+		RenderBounds bounds;
+
+		bounds.m_Radius = std::numeric_limits<float>::infinity();
+		bounds.m_Extents = glm::vec3(std::numeric_limits<float>::infinity());
+
+		return bounds;
+	}
+
+	RenderBounds RenderBounds::FromPositions(const float* positions, uint32_t numberOfPositions, uint32_t strideInFloats)
+	{
+		RenderBounds bounds;
+
+		if (numberOfPositions == 0)
+		{
+			return bounds;
+		}
+
+		glm::vec3 minimum(std::numeric_limits<float>::max());
+		glm::vec3 maximum(-std::numeric_limits<float>::max());
+
+		for (uint32_t counter = 0; counter < numberOfPositions; counter++)
+		{
+			const float* position = positions + size_t(counter) * strideInFloats;
+			glm::vec3 point(position[0], position[1], position[2]);
+
+			minimum = glm::min(minimum, point);
+			maximum = glm::max(maximum, point);
+		}
+
+		bounds.m_Center = (minimum + maximum) * 0.5f;
+		bounds.m_Extents = (maximum - minimum) * 0.5f;
+
+		// The sphere around the box center, tighter than the one around the box for most meshes
+		float radiusSquared = 0.0f;
+		for (uint32_t counter = 0; counter < numberOfPositions; counter++)
+		{
+			const float* position = positions + size_t(counter) * strideInFloats;
+			glm::vec3 offset = glm::vec3(position[0], position[1], position[2]) - bounds.m_Center;
+
+			radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+		}
+		bounds.m_Radius = std::sqrt(radiusSquared);
+
+		return bounds;
+	}
+
+	RenderBounds RenderBounds::Enclose(const RenderBounds* bounds, uint32_t numberOfBounds)
+	{
+		RenderBounds enclosing;
+
+		if (numberOfBounds == 0)
+		{
+			return enclosing;
+		}
+
+		glm::vec3 minimum(std::numeric_limits<float>::max());
+		glm::vec3 maximum(-std::numeric_limits<float>::max());
+
+		for (uint32_t counter = 0; counter < numberOfBounds; counter++)
+		{
+			minimum = glm::min(minimum, bounds[counter].m_Center - bounds[counter].m_Extents);
+			maximum = glm::max(maximum, bounds[counter].m_Center + bounds[counter].m_Extents);
+		}
+
+		enclosing.m_Center = (minimum + maximum) * 0.5f;
+		enclosing.m_Extents = (maximum - minimum) * 0.5f;
+
+		// Every sphere, seen from the new center
+		for (uint32_t counter = 0; counter < numberOfBounds; counter++)
+		{
+			enclosing.m_Radius = std::max(enclosing.m_Radius, glm::length(bounds[counter].m_Center - enclosing.m_Center) + bounds[counter].m_Radius);
+		}
+
+		return enclosing;
+	}
+
+	void RenderBoundsStream::PushBack(const RenderBounds& bounds)
+	{
+		m_CenterX.push_back(bounds.m_Center.x);
+		m_CenterY.push_back(bounds.m_Center.y);
+		m_CenterZ.push_back(bounds.m_Center.z);
+		m_Radius.push_back(bounds.m_Radius);
+		m_ExtentX.push_back(bounds.m_Extents.x);
+		m_ExtentY.push_back(bounds.m_Extents.y);
+		m_ExtentZ.push_back(bounds.m_Extents.z);
+	}
+
+	void RenderBoundsStream::Set(size_t index, const RenderBounds& bounds)
+	{
+		m_CenterX[index] = bounds.m_Center.x;
+		m_CenterY[index] = bounds.m_Center.y;
+		m_CenterZ[index] = bounds.m_Center.z;
+		m_Radius[index] = bounds.m_Radius;
+		m_ExtentX[index] = bounds.m_Extents.x;
+		m_ExtentY[index] = bounds.m_Extents.y;
+		m_ExtentZ[index] = bounds.m_Extents.z;
+	}
+
+	void RenderBoundsStream::RemoveSwap(size_t index)
+	{
+		for (std::vector<float>* component : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+		{
+			(*component)[index] = component->back();
+			component->pop_back();
+		}
+	}
+
+	RenderScene::RenderScene()
+	{
+	}
+
+	RenderProxyHandle RenderScene::AddProxy(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material,
+		const glm::mat4& worldMatrix, const RenderBounds& localBounds)
+	{
+		KR_CORE_ASSERT(vertexArray != nullptr, "RenderScene: proxy without vertex array");
+
+		if (material == nullptr)
+		{
+			material = vertexArray->GetMaterial();
+		}
+
+		std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+		uint32_t slotIndex;
+		if (m_FreeSlots.size())
+		{
+			slotIndex = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = uint32_t(m_Slots.size());
+			m_Slots.push_back(Slot());
+		}
+
+		Slot& slot = m_Slots[slotIndex];
+		slot.m_bAlive = true;
+		slot.m_DenseIndex = UINT32_MAX;
+
+		RenderProxyDelta delta;
+		delta.m_Type = RenderProxyDelta::Type::Add;
+		delta.m_Slot = slotIndex;
+		delta.m_WorldMatrix = worldMatrix;
+		delta.m_AddIndex = uint32_t(m_PendingAdds.size());
+
+		m_PendingAdds.push_back({ vertexArray, mesh, material, localBounds });
+		m_Deltas.push_back(delta);
+
+		RenderProxyHandle handle;
+		handle.m_Index = slotIndex;
+		handle.m_Generation = slot.m_Generation;
+
+		return handle;
+	}
+
+	RenderProxyHandle RenderScene::AddProxy(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material,
+		const glm::mat4& worldMatrix)
+	{
+		KR_CORE_ASSERT(mesh != nullptr, "RenderScene: bounds asked from a null mesh");
+
+		return AddProxy(vertexArray, mesh, material, worldMatrix, mesh->GetBounds());
+	}
+
+	void RenderScene::UpdateTransform(RenderProxyHandle handle, const glm::mat4& worldMatrix)
+	{
+		std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+		if (!IsValidLocked(handle))
+		{
+			KR_CORE_WARN("RenderScene: transform update for a stale proxy handle ({0})", handle.m_Index);
+			return;
+		}
+
+		Slot& slot = m_Slots[handle.m_Index];
+
+		// Only the latest matrix matters
+		if (slot.m_PendingUpdate != UINT32_MAX)
+		{
+			m_Deltas[slot.m_PendingUpdate].m_WorldMatrix = worldMatrix;
+			return;
+		}
+
+		RenderProxyDelta delta;
+		delta.m_Type = RenderProxyDelta::Type::Update;
+		delta.m_Slot = handle.m_Index;
+		delta.m_WorldMatrix = worldMatrix;
+		delta.m_AddIndex = UINT32_MAX;
+
+		slot.m_PendingUpdate = uint32_t(m_Deltas.size());
+		m_Deltas.push_back(delta);
+	}
+
+	void RenderScene::RemoveProxy(RenderProxyHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+		if (!IsValidLocked(handle))
+		{
+			KR_CORE_WARN("RenderScene: removal of a stale proxy handle ({0})", handle.m_Index);
+			return;
+		}
+
+		Slot& slot = m_Slots[handle.m_Index];
+		slot.m_bAlive = false;
+
+		// Outstanding handles become invalid right away
+		slot.m_Generation++;
+
+		RenderProxyDelta delta;
+		delta.m_Type = RenderProxyDelta::Type::Remove;
+		delta.m_Slot = handle.m_Index;
+		delta.m_AddIndex = UINT32_MAX;
+
+		m_Deltas.push_back(delta);
+	}
+
+	bool RenderScene::IsValid(RenderProxyHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+		return IsValidLocked(handle);
+	}
+
+	bool RenderScene::IsValidLocked(RenderProxyHandle handle) const
+	{
+		return handle.m_Index < m_Slots.size() && m_Slots[handle.m_Index].m_bAlive && m_Slots[handle.m_Index].m_Generation == handle.m_Generation;
+	}
+
+	void RenderScene::ApplyDeltas()
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		// Deltas are compact, so holding the lock throughout is cheaper than double buffering the slots
+		std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+		m_Statistics.m_NumberOfAdds = 0;
+		m_Statistics.m_NumberOfUpdates = 0;
+		m_Statistics.m_NumberOfRemoves = 0;
+
+		for (const RenderProxyDelta& delta : m_Deltas)
+		{
+			Slot& slot = m_Slots[delta.m_Slot];
+
+			switch (delta.m_Type)
+			{
+				case RenderProxyDelta::Type::Add:
+				{
+					ProxyResources& resources = m_PendingAdds[delta.m_AddIndex];
+
+					RenderProxy proxy;
+					proxy.m_WorldMatrix = delta.m_WorldMatrix;
+					proxy.m_LocalBounds = resources.m_LocalBounds;
+					proxy.m_WorldBounds = resources.m_LocalBounds.Transform(delta.m_WorldMatrix);
+					proxy.m_VertexArray = resources.m_VertexArray.get();
+					proxy.m_Mesh = resources.m_Mesh.get();
+					proxy.m_Material = resources.m_Material.get();
+
+					std::shared_ptr<Shader> shader = proxy.m_Material ? proxy.m_Material->GetShader(0) : nullptr;
+					proxy.m_SortKey = RenderSortKey::Make(shader ? shader->GetSortID() : 0, proxy.m_Material ? proxy.m_Material->GetSortID() : 0,
+						proxy.m_VertexArray ? proxy.m_VertexArray->GetSortID() : 0);
+
+					resources.m_BaseSortKey = proxy.m_SortKey;
+					resources.m_LODChain = AcquireLODChain(resources.m_Mesh, resources.m_Material);
+					proxy.m_LODChain = resources.m_LODChain.get();
+
+					slot.m_DenseIndex = uint32_t(m_Proxies.size());
+
+					m_Proxies.push_back(proxy);
+					m_Resources.push_back(std::move(resources));
+					m_DenseToSlot.push_back(delta.m_Slot);
+					m_BoundsStream.PushBack(proxy.m_WorldBounds);
+
+					m_Statistics.m_NumberOfAdds++;
+				}
+				break;
+				case RenderProxyDelta::Type::Update:
+				{
+					slot.m_PendingUpdate = UINT32_MAX;
+
+					if (slot.m_DenseIndex != UINT32_MAX)
+					{
+						RenderProxy& proxy = m_Proxies[slot.m_DenseIndex];
+						proxy.m_WorldMatrix = delta.m_WorldMatrix;
+						proxy.m_WorldBounds = proxy.m_LocalBounds.Transform(delta.m_WorldMatrix);
+						m_BoundsStream.Set(slot.m_DenseIndex, proxy.m_WorldBounds);
+
+						m_Statistics.m_NumberOfUpdates++;
+					}
+				}
+				break;
+				case RenderProxyDelta::Type::Remove:
+				{
+					uint32_t denseIndex = slot.m_DenseIndex;
+					uint32_t lastIndex = uint32_t(m_Proxies.size()) - 1;
+
+					KR_CORE_ASSERT(denseIndex != UINT32_MAX, "RenderScene: removing a proxy which was never added");
+
+					// Draws recorded for the render thread may still refer to its vertex arrays, which are let go of there
+					RenderThread::ReleaseAfterFrame(std::make_shared<ProxyResources>(std::move(m_Resources[denseIndex])));
+
+					// Swap the last proxy into the hole
+					if (denseIndex != lastIndex)
+					{
+						m_Proxies[denseIndex] = m_Proxies[lastIndex];
+						m_Resources[denseIndex] = std::move(m_Resources[lastIndex]);
+						m_DenseToSlot[denseIndex] = m_DenseToSlot[lastIndex];
+
+						m_Slots[m_DenseToSlot[denseIndex]].m_DenseIndex = denseIndex;
+					}
+
+					m_Proxies.pop_back();
+					m_Resources.pop_back();
+					m_DenseToSlot.pop_back();
+					m_BoundsStream.RemoveSwap(denseIndex);
+
+					slot.m_DenseIndex = UINT32_MAX;
+					slot.m_PendingUpdate = UINT32_MAX;
+					m_FreeSlots.push_back(delta.m_Slot);
+
+					m_Statistics.m_NumberOfRemoves++;
+				}
+				break;
+			}
+		}
+
+		m_Deltas.clear();
+		m_PendingAdds.clear();
+
+		m_Statistics.m_NumberOfProxies = uint32_t(m_Proxies.size());
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+		m_Statistics.m_ApplyTimeMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+	}
+
+	void RenderScene::RefreshReloadedAssets()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_DeltaMutex);
+
+			for (ProxyResources& resources : m_PendingAdds)
+			{
+				resources.m_VertexArray->RefreshReloadedAssets();
+			}
+		}
+
+		for (uint32_t index = 0; index < uint32_t(m_Resources.size()); index++)
+		{
+			ProxyResources& resources = m_Resources[index];
+
+			const bool bRefreshed = resources.m_VertexArray->RefreshReloadedAssets();
+			RenderProxy& proxy = m_Proxies[index];
+
+			if (bRefreshed)
+			{
+				// The shader may be a new program
+				std::shared_ptr<Shader> shader = proxy.m_Material ? proxy.m_Material->GetShader(0) : nullptr;
+				resources.m_BaseSortKey = RenderSortKey::Make(shader ? shader->GetSortID() : 0, proxy.m_Material ? proxy.m_Material->GetSortID() : 0,
+					resources.m_VertexArray->GetSortID());
+
+				if (proxy.m_LODIndex == 0)
+				{
+					proxy.m_SortKey = resources.m_BaseSortKey;
+				}
+			}
+
+			if (resources.m_LODChain && resources.m_LODChain->m_MeshGeneration == resources.m_Mesh->GetGeneration())
+			{
+				// Same levels, the shader or textures may be new. A chain shared by proxies is refreshed by the first. One still to be made
+				// is made from the reloaded assets.
+				RenderLODChain& chain = *resources.m_LODChain;
+
+				if (!chain.m_bReady.load(std::memory_order_acquire))
+				{
+					continue;
+				}
+
+				for (size_t level = 0; level < chain.m_VertexArrays.size(); level++)
+				{
+					if (chain.m_VertexArrays[level]->RefreshReloadedAssets())
+					{
+						std::shared_ptr<Shader> shader = proxy.m_Material ? proxy.m_Material->GetShader(0) : nullptr;
+						chain.m_SortKeys[level] = RenderSortKey::Make(shader ? shader->GetSortID() : 0, proxy.m_Material ? proxy.m_Material->GetSortID() : 0,
+							chain.m_VertexArrays[level]->GetSortID());
+					}
+				}
+
+				if (proxy.m_LODIndex > 0)
+				{
+					proxy.m_SortKey = chain.m_SortKeys[proxy.m_LODIndex - 1];
+				}
+			}
+			else if (bRefreshed || resources.m_LODChain)
+			{
+				// The mesh was reloaded and comes with levels of its own (or none). The first proxy makes the chain again, the others
+				// of the mesh and material take that one.
+				std::weak_ptr<RenderLODChain>& cachedChain = m_LODChains[{ resources.m_Mesh.get(), resources.m_Material.get() }];
+
+				if (std::shared_ptr<RenderLODChain> chain = cachedChain.lock())
+				{
+					if (chain->m_MeshGeneration != resources.m_Mesh->GetGeneration())
+					{
+						cachedChain.reset();
+					}
+				}
+
+				std::shared_ptr<RenderLODChain> previousChain = std::move(resources.m_LODChain);
+
+				resources.m_LODChain = AcquireLODChain(resources.m_Mesh, resources.m_Material);
+
+				// The new chain may have fewer levels (or none), so the proxy goes back to the mesh itself till SelectLODs picks again
+				proxy.m_LODChain = resources.m_LODChain.get();
+				proxy.m_LODIndex = 0;
+				proxy.m_VertexArray = resources.m_VertexArray.get();
+				proxy.m_SortKey = resources.m_BaseSortKey;
+
+				// Draws recorded for the render thread may still refer to the levels of the previous chain
+				if (previousChain)
+				{
+					RenderThread::ReleaseAfterFrame(std::move(previousChain));
+				}
+			}
+		}
+	}
+
+	std::shared_ptr<RenderLODChain> RenderScene::AcquireLODChain(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material)
+	{
+		if (!mesh || mesh->GetLODs().empty() || !material)
+		{
+			return nullptr;
+		}
+
+		std::weak_ptr<RenderLODChain>& cachedChain = m_LODChains[{ mesh.get(), material.get() }];
+
+		if (std::shared_ptr<RenderLODChain> chain = cachedChain.lock())
+		{
+			return chain;
+		}
+
+		std::shared_ptr<RenderLODChain> chain = std::make_shared<RenderLODChain>();
+		chain->m_BaseNumberOfTriangles = mesh->GetNumberOfTriangles();
+		chain->m_MeshGeneration = mesh->GetGeneration();
+
+		// The levels as they are now, a reload may swap others into the mesh before the command runs
+		std::vector<std::shared_ptr<Mesh>> lodMeshes;
+
+		for (const MeshLOD& lod : mesh->GetLODs())
+		{
+			lodMeshes.push_back(lod.m_Mesh);
+			chain->m_Errors.push_back(lod.m_Error);
+			chain->m_NumberOfTriangles.push_back(lod.m_NumberOfTriangles);
+		}
+
+		// The pipelines and descriptor sets are the render thread's, which may be playing the previous frame right now
+		RenderThread::Enqueue([chain, lodMeshes = std::move(lodMeshes), material]()
+			{
+				std::shared_ptr<Shader> shader = material->GetShader(0);
+
+				for (const std::shared_ptr<Mesh>& lodMesh : lodMeshes)
+				{
+					// The level's index buffer over the mesh's vertex buffer, with the pipeline of the material
+					std::shared_ptr<VertexArray> vertexArray;
+					vertexArray.reset(VertexArray::Create());
+					vertexArray->SetMesh(lodMesh);
+					vertexArray->SetMaterial(material);
+
+					chain->m_VertexArrays.push_back(vertexArray);
+					chain->m_SortKeys.push_back(RenderSortKey::Make(shader ? shader->GetSortID() : 0, material->GetSortID(), vertexArray->GetSortID()));
+				}
+
+				chain->m_bReady.store(true, std::memory_order_release);
+			});
+
+		cachedChain = chain;
+
+		return chain;
+	}
+
+	void RenderScene::SelectLODs(const glm::mat4& viewMatrix, float projectionScale, const std::vector<uint32_t>* visibleIndices,
+		const RenderLODSettings& settings)
+	{
+		m_Statistics.m_NumberOfTriangles = 0;
+		m_Statistics.m_NumberOfTrianglesSaved = 0;
+		m_Statistics.m_NumberOfLODSwitches = 0;
+
+		const uint32_t numberOfProxies = visibleIndices ? uint32_t(visibleIndices->size()) : uint32_t(m_Proxies.size());
+		const float minimumDepth = 1.0e-3f;
+
+		// An error of e at view depth d covers e * projectionScale / (2 * d) of the viewport's height
+		const float threshold = settings.m_ErrorThreshold * 2.0f / std::max(projectionScale, 1.0e-6f);
+		const float coarserThreshold = threshold * (1.0f - settings.m_Hysteresis);
+
+		for (uint32_t counter = 0; counter < numberOfProxies; counter++)
+		{
+			const uint32_t index = visibleIndices ? (*visibleIndices)[counter] : counter;
+			RenderProxy& proxy = m_Proxies[index];
+			const RenderLODChain* chain = proxy.m_LODChain;
+
+			// Drawn at level 0 till the render thread has made the levels
+			if (!chain || !chain->m_bReady.load(std::memory_order_acquire))
+			{
+				m_Statistics.m_NumberOfTriangles += proxy.m_Mesh ? proxy.m_Mesh->GetNumberOfTriangles() : 0;
+				continue;
+			}
+
+			uint32_t lodIndex = proxy.m_LODIndex;
+
+			if (!settings.m_bEnabled)
+			{
+				lodIndex = 0;
+			}
+			else
+			{
+				// The nearest point of the bounds, and the scale of the object, bound the error on screen
+				const float depth = std::max(-(viewMatrix * glm::vec4(proxy.m_WorldBounds.m_Center, 1.0f)).z - proxy.m_WorldBounds.m_Radius,
+					minimumDepth);
+				const float worldScale = proxy.m_LocalBounds.m_Radius > 0.0f ? proxy.m_WorldBounds.m_Radius / proxy.m_LocalBounds.m_Radius : 1.0f;
+
+				// Error over depth, against the threshold in the same units
+				auto relativeError = [chain, worldScale, depth](uint32_t level)
+				{
+					return level ? chain->m_Errors[level - 1] * worldScale / depth : 0.0f;
+				};
+
+				while (lodIndex > 0 && relativeError(lodIndex) > threshold)
+				{
+					lodIndex--;
+				}
+
+				while (lodIndex < chain->GetNumberOfLODs() && relativeError(lodIndex + 1) <= coarserThreshold)
+				{
+					lodIndex++;
+				}
+			}
+
+			if (lodIndex != proxy.m_LODIndex)
+			{
+				const ProxyResources& resources = m_Resources[index];
+
+				proxy.m_LODIndex = lodIndex;
+				proxy.m_VertexArray = lodIndex ? chain->m_VertexArrays[lodIndex - 1].get() : resources.m_VertexArray.get();
+				proxy.m_SortKey = lodIndex ? chain->m_SortKeys[lodIndex - 1] : resources.m_BaseSortKey;
+
+				m_Statistics.m_NumberOfLODSwitches++;
+			}
+
+			const uint32_t numberOfTriangles = lodIndex ? chain->m_NumberOfTriangles[lodIndex - 1] : chain->m_BaseNumberOfTriangles;
+
+			m_Statistics.m_NumberOfTriangles += numberOfTriangles;
+			m_Statistics.m_NumberOfTrianglesSaved += chain->m_BaseNumberOfTriangles - numberOfTriangles;
+		}
+	}
+}
@@ -0,0 +1,656 @@
+/**
+ * @file RenderScene.h
+ * @brief This file contains RenderScene class, the renderer's flat list of render proxies (independently transformed objects).
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "glm/glm.hpp"
+#include "RenderPass.h"
+
+#include <mutex>
+#include <map>
+#include <atomic>
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class VertexArray;
+
+	/**
+	 * @brief Forward declaration
+	 */
+	class Mesh;
+
+	/**
+	 * @brief Forward declaration
+	 */
+	class Material;
+
+	/**
+	 * @brief Bounds of a proxy, both as sphere (m_Center, m_Radius) and as axis aligned box (m_Center, m_Extents)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderBounds
+	{
+		/**
+		 * @brief Center of the sphere and the box
+		 *
+		 * @since Karma 1.0.0
+		 */
+		glm::vec3 m_Center = glm::vec3(0.0f);
+
+		/**
+		 * @brief Radius of the bounding sphere
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Radius = 0.0f;
+
+		/**
+		 * @brief Half size of the box along each axis
+		 *
+		 * @since Karma 1.0.0
+		 */
+		glm::vec3 m_Extents = glm::vec3(0.0f);
+
+		/**
+		 * @brief Bounds, of the local bounds, after transformation by worldMatrix (conservative for rotations and non uniform scales)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds Transform(const glm::mat4& worldMatrix) const;
+
+		/**
+		 * @brief Bounds of infinite size, for objects whose extent is unknown (they are never culled)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderBounds Unbounded();
+
+		/**
+		 * @brief Computes the box and the sphere around the (x, y, z) positions
+		 *
+		 * @param positions						First position
+		 * @param numberOfPositions				Number of positions
+		 * @param strideInFloats				Distance, in floats, between consecutive positions (3 for tightly packed)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderBounds FromPositions(const float* positions, uint32_t numberOfPositions, uint32_t strideInFloats);
+
+		/**
+		 * @brief Bounds enclosing all of the bounds (say, the submeshes of a model). The box is exact, the sphere conservative.
+		 *
+		 * @param bounds						First bounds
+		 * @param numberOfBounds				Number of bounds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderBounds Enclose(const RenderBounds* bounds, uint32_t numberOfBounds);
+	};
+
+	/**
+	 * @brief World bounds of the proxies as a structure of arrays (same order as RenderScene::GetProxies), so that the FrustumCuller can load
+	 * the bounds of several proxies into one SIMD register
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderBoundsStream
+	{
+		/**
+		 * @brief Components of the centers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+
+		/**
+		 * @brief Radii of the spheres
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<float> m_Radius;
+
+		/**
+		 * @brief Components of the box extents
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+
+		/**
+		 * @brief Number of bounds in the stream
+		 *
+		 * @since Karma 1.0.0
+		 */
+		size_t Size() const { return m_Radius.size(); }
+
+		/**
+		 * @brief Appends bounds at the end
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void PushBack(const RenderBounds& bounds);
+
+		/**
+		 * @brief Overwrites the bounds at index
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Set(size_t index, const RenderBounds& bounds);
+
+		/**
+		 * @brief Moves the last bounds into index and shrinks by one (mirrors the swap removal of the proxies)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RemoveSwap(size_t index);
+	};
+
+	/**
+	 * @brief Handle to a proxy in a RenderScene. The generation makes handles of removed proxies invalid, even if the slot is reused.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderProxyHandle
+	{
+		/**
+		 * @brief Slot of the proxy
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Index = UINT32_MAX;
+
+		/**
+		 * @brief Generation of the slot when the handle was given out
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Generation = 0;
+
+		/**
+		 * @brief Whether the handle was ever given out (says nothing about the proxy being alive, see RenderScene::IsValid)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsSet() const { return m_Index != UINT32_MAX; }
+	};
+
+	/**
+	 * @brief The vertex arrays of the levels of detail of a mesh drawn with a material, shared by the proxies of the pair. Indexed by
+	 * level - 1 (level 0 is the proxy's own vertex array).
+	 *
+	 * The vertex arrays (pipelines, descriptor sets) are made by a render command, see m_bReady.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderLODChain
+	{
+		/**
+		 * @brief Filled, with m_SortKeys, on the render thread. Read only once m_bReady is.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<std::shared_ptr<VertexArray>> m_VertexArrays;
+		std::vector<uint64_t> m_SortKeys;
+
+		/**
+		 * @brief Set by the render thread once m_VertexArrays and m_SortKeys are made. Till then the proxies of the chain are drawn at level 0.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::atomic<bool> m_bReady = false;
+
+		/**
+		 * @brief MeshLOD::m_Error of each level, in the space of the mesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<float> m_Errors;
+
+		std::vector<uint32_t> m_NumberOfTriangles;
+		uint32_t m_BaseNumberOfTriangles = 0;
+
+		/**
+		 * @brief Mesh::GetGeneration of the mesh when the levels were taken from it, a reloaded mesh has levels of its own
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_MeshGeneration = 0;
+
+		uint32_t GetNumberOfLODs() const { return uint32_t(m_Errors.size()); }
+	};
+
+	/**
+	 * @brief How the levels of detail are picked
+	 *
+	 * @see RenderScene::SelectLODs
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderLODSettings
+	{
+		/**
+		 * @brief false draws every proxy at level 0
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool m_bEnabled = true;
+
+		/**
+		 * @brief Largest error on screen allowed, as a fraction of the viewport's height (0.001 is about a pixel at 1080p)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_ErrorThreshold = 0.001f;
+
+		/**
+		 * @brief A proxy goes coarser only once the coarser level's error is below (1 - m_Hysteresis) of the threshold, so that proxies
+		 * near the threshold don't switch back and forth every frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_Hysteresis = 0.2f;
+	};
+
+	/**
+	 * @brief What the renderer needs to draw an object. Proxies are stored contiguously and iterated linearly, so only the hot data lives
+	 * here (the owning references are kept aside by the RenderScene).
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderProxy
+	{
+		/**
+		 * @brief Object to world transform
+		 *
+		 * @since Karma 1.0.0
+		 */
+		glm::mat4 m_WorldMatrix = glm::mat4(1.0f);
+
+		/**
+		 * @brief Bounds in world space (m_LocalBounds transformed by m_WorldMatrix)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds m_WorldBounds;
+
+		/**
+		 * @brief Bounds in object space
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderBounds m_LocalBounds;
+
+		/**
+		 * @brief The vertex array (mesh buffers and pipeline) to be drawn
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VertexArray* m_VertexArray = nullptr;
+
+		/**
+		 * @brief The mesh
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Mesh* m_Mesh = nullptr;
+
+		/**
+		 * @brief The material (shaders, textures and uniforms)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		Material* m_Material = nullptr;
+
+		/**
+		 * @brief RenderSortKey of the proxy's program, material and vertex array, made when the proxy is added
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_SortKey = 0;
+
+		/**
+		 * @brief The levels of detail of the mesh with the material, nullptr if the mesh has none (Mesh::GetLODs)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const RenderLODChain* m_LODChain = nullptr;
+
+		/**
+		 * @brief Level drawn, 0 for the mesh itself. m_VertexArray and m_SortKey are those of the level.
+		 *
+		 * @see RenderScene::SelectLODs
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LODIndex = 0;
+	};
+
+	/**
+	 * @brief Counters of the RenderScene
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderSceneStatistics
+	{
+		/**
+		 * @brief Number of live proxies
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfProxies = 0;
+
+		/**
+		 * @brief Number of proxies added by the latest ApplyDeltas
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfAdds = 0;
+
+		/**
+		 * @brief Number of transform updates applied by the latest ApplyDeltas
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfUpdates = 0;
+
+		/**
+		 * @brief Number of proxies removed by the latest ApplyDeltas
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfRemoves = 0;
+
+		/**
+		 * @brief Number of (material, vertex array) runs drawn by the latest Renderer::Submit
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfBatches = 0;
+
+		/**
+		 * @brief Number of those runs drawn as one instanced draw
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfInstancedBatches = 0;
+
+		/**
+		 * @brief Triangles of the proxies whose levels of detail the latest SelectLODs picked (the visible ones)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfTriangles = 0;
+
+		/**
+		 * @brief Triangles those proxies would have had at level 0
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfTrianglesSaved = 0;
+
+		/**
+		 * @brief Proxies whose level changed in the latest SelectLODs
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfLODSwitches = 0;
+
+		/**
+		 * @brief Time taken by the latest ApplyDeltas
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ApplyTimeMicroseconds = 0;
+
+		/**
+		 * @brief Time taken by the latest Renderer::Submit to walk the proxies
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_SubmitTimeMicroseconds = 0;
+
+		/**
+		 * @brief Counters of each pass (indexed by RenderPassType) of the latest Renderer::Submit. The depth pre-pass ones stay 0 when it is off.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::array<RenderPassStatistics, s_NumberOfRenderPasses> m_Passes;
+	};
+
+	/**
+	 * @brief The renderer's representation of a Scene's objects: a flat, densely packed array of RenderProxy.
+	 *
+	 * The game side (scene components, possibly on another thread) adds, updates and removes proxies through handles. These calls only queue
+	 * small deltas (an add, a new world matrix or a remove), and the renderer applies them in one go with ApplyDeltas before walking the
+	 * proxies. Removal swaps the last proxy into the hole, so the array never has gaps.
+	 *
+	 * @see Renderer::Submit
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API RenderScene
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderScene();
+
+		/**
+		 * @brief Queues the addition of a proxy
+		 *
+		 * @param vertexArray					The vertex array to be drawn (with mesh and material set)
+		 * @param mesh							The mesh of the vertex array
+		 * @param material						The material of the vertex array (nullptr for vertexArray->GetMaterial())
+		 * @param worldMatrix					Object to world transform
+		 * @param localBounds					Bounds in object space
+		 *
+		 * @return Handle for the later updates and removal
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		RenderProxyHandle AddProxy(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material,
+			const glm::mat4& worldMatrix, const RenderBounds& localBounds);
+
+		/**
+		 * @brief Queues the addition of a proxy bounded by the mesh's bounds (Mesh::GetBounds)
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		RenderProxyHandle AddProxy(std::shared_ptr<VertexArray> vertexArray, std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material,
+			const glm::mat4& worldMatrix);
+
+		/**
+		 * @brief Queues a new world matrix for the proxy. Several updates of a proxy before ApplyDeltas cost one.
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		void UpdateTransform(RenderProxyHandle handle, const glm::mat4& worldMatrix);
+
+		/**
+		 * @brief Queues the removal of the proxy. The handle is invalid right away.
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		void RemoveProxy(RenderProxyHandle handle);
+
+		/**
+		 * @brief Whether the handle refers to a live (or queued for addition) proxy
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		bool IsValid(RenderProxyHandle handle) const;
+
+		/**
+		 * @brief Applies the queued deltas in order. To be called by the renderer before walking the proxies.
+		 *
+		 * @see Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		void ApplyDeltas();
+
+		/**
+		 * @brief Sets up again the vertex arrays of the proxies (the queued ones too) whose mesh, shader or textures were reloaded
+		 * (VertexArray::RefreshReloadedAssets), and makes the chains of levels of detail of the reloaded meshes again. The proxies of a new
+		 * chain go back to level 0 till the next SelectLODs, the previous chain being let go of once the render thread is done with the
+		 * frame. The bounds stay the ones the proxies were added with.
+		 *
+		 * @see Scene::RefreshReloadedAssets
+		 * @since Karma 1.0.0
+		 */
+		void RefreshReloadedAssets();
+
+		/**
+		 * @brief The proxies, densely packed. Valid till the next ApplyDeltas.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<RenderProxy>& GetProxies() const { return m_Proxies; }
+
+		/**
+		 * @brief The owning reference to the vertex array of proxy at index (same order as GetProxies)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::shared_ptr<VertexArray>& GetVertexArray(size_t index) const
+		{
+			const uint32_t lodIndex = m_Proxies[index].m_LODIndex;
+
+			return lodIndex ? m_Resources[index].m_LODChain->m_VertexArrays[lodIndex - 1] : m_Resources[index].m_VertexArray;
+		}
+
+		/**
+		 * @brief Picks the level of detail of each listed proxy, the coarsest whose error, projected at the proxy's distance, stays under
+		 * the threshold of the settings. Counts the triangles drawn and saved.
+		 *
+		 * @param viewMatrix					World to view transform of the camera
+		 * @param projectionScale				The projection's [1][1], 1 / tan(vertical field of view / 2)
+		 * @param visibleIndices				The proxies to pick for (all if nullptr)
+		 * @param settings						The threshold and hysteresis
+		 *
+		 * @see Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		void SelectLODs(const glm::mat4& viewMatrix, float projectionScale, const std::vector<uint32_t>* visibleIndices,
+			const RenderLODSettings& settings);
+
+		/**
+		 * @brief Number of live proxies
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfProxies() const { return uint32_t(m_Proxies.size()); }
+
+		/**
+		 * @brief World bounds of the proxies, as structure of arrays (same order as GetProxies)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const RenderBoundsStream& GetBoundsStream() const { return m_BoundsStream; }
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderSceneStatistics& GetStatistics() { return m_Statistics; }
+
+	private:
+		/**
+		 * @brief A queued change, applied by ApplyDeltas
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct RenderProxyDelta
+		{
+			enum class Type : uint8_t
+			{
+				Add,
+				Update,
+				Remove
+			};
+
+			Type m_Type;
+			uint32_t m_Slot;
+			glm::mat4 m_WorldMatrix;
+
+			// Index in m_PendingAdds for Add deltas
+			uint32_t m_AddIndex;
+		};
+
+		/**
+		 * @brief Owning references of a proxy (cold data, touched only by add and remove)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct ProxyResources
+		{
+			std::shared_ptr<VertexArray> m_VertexArray;
+			std::shared_ptr<Mesh> m_Mesh;
+			std::shared_ptr<Material> m_Material;
+			RenderBounds m_LocalBounds;
+
+			std::shared_ptr<RenderLODChain> m_LODChain;
+			uint64_t m_BaseSortKey = 0;
+		};
+
+		/**
+		 * @brief Maps handles to dense indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Slot
+		{
+			uint32_t m_DenseIndex = UINT32_MAX;
+			uint32_t m_Generation = 0;
+
+			// Index of the latest queued Update delta, for collapsing updates
+			uint32_t m_PendingUpdate = UINT32_MAX;
+			bool m_bAlive = false;
+		};
+
+		bool IsValidLocked(RenderProxyHandle handle) const;
+
+		/**
+		 * @brief The chain of the mesh with the material, made if no live proxy has it already. The vertex arrays of a new chain are made
+		 * by a render command, the chain is ready (RenderLODChain::m_bReady) once that has run.
+		 *
+		 * @return nullptr if the mesh has no levels of detail
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<RenderLODChain> AcquireLODChain(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material);
+
+	private:
+		// Dense, parallel arrays
+		std::vector<RenderProxy> m_Proxies;
+		std::vector<ProxyResources> m_Resources;
+		std::vector<uint32_t> m_DenseToSlot;
+		RenderBoundsStream m_BoundsStream;
+
+		// Chains by (mesh, material), held by the resources of the proxies drawing them
+		std::map<std::pair<const Mesh*, const Material*>, std::weak_ptr<RenderLODChain>> m_LODChains;
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+
+		// Queued by the game side
+		mutable std::mutex m_DeltaMutex;
+		std::vector<RenderProxyDelta> m_Deltas;
+		std::vector<ProxyResources> m_PendingAdds;
+
+		RenderSceneStatistics m_Statistics;
+	};
+}
@@ -0,0 +1,14 @@
+#include "RenderSortKey.h"
+
+#include <atomic>
+
+namespace Karma
+{
+	uint32_t RenderSortKey::NextSortID()
+	{
+		// 0 is left for "no object"
+		static std::atomic<uint32_t> s_NextSortID(1);
+
+		return s_NextSortID.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,57 @@
+/**
+ * @file RenderSortKey.h
+ * @brief This file contains RenderSortKey, the 64 bit key by which the draws of a frame are ordered.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Packs the identities of a draw's program (shader), material and vertex array into 64 bits, most expensive state change first.
+	 * Sorting the draws by the key puts the draws sharing a program together, and within them the ones sharing a material and then a vertex
+	 * array, so the backends (the OpenGLStateCache for instance) see the fewest state changes.
+	 *
+	 * The identities are the sort IDs handed out (NextSortID) to Shader, Material and VertexArray at construction. They are truncated to the
+	 * widths below, so a collision (after a million shaders, say) only costs some ordering, never correctness.
+	 *
+	 * @see Renderer::Submit
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderSortKey
+	{
+		/**
+		 * @brief Bits of the key used by the program (the most significant ones), the material and the vertex array
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_ProgramBits = 20;
+		static constexpr uint32_t s_MaterialBits = 22;
+		static constexpr uint32_t s_VertexArrayBits = 22;
+
+		/**
+		 * @brief The key
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t Make(uint32_t programSortID, uint32_t materialSortID, uint32_t vertexArraySortID)
+		{
+			const uint64_t program = programSortID & ((1u << s_ProgramBits) - 1);
+			const uint64_t material = materialSortID & ((1u << s_MaterialBits) - 1);
+			const uint64_t vertexArray = vertexArraySortID & ((1u << s_VertexArrayBits) - 1);
+
+			return (program << (s_MaterialBits + s_VertexArrayBits)) | (material << s_VertexArrayBits) | vertexArray;
+		}
+
+		/**
+		 * @brief A fresh identity, for the objects taking part in the key
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t NextSortID();
+	};
+}
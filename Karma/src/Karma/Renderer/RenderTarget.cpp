@@ -0,0 +1,83 @@
+#include "RenderTarget.h"
+#include "Karma/Core.h"
+#include "Renderer.h"
+#include "Platform/OpenGL/OpenGLRenderTarget.h"
+#include "Platform/Vulkan/VulkanRenderTarget.h"
+#include "Platform/Null/NullRenderTarget.h"
+
+namespace Karma
+{
+	RenderTarget* RenderTarget::Create(const RenderTargetSpecification& specification)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return new OpenGLRenderTarget(specification);
+			case RendererAPI::API::Vulkan:
+				return new VulkanRenderTarget(specification);
+			case RendererAPI::API::Null:
+				return new NullRenderTarget(specification);
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
+		return nullptr;
+	}
+
+	RenderTarget::RenderTarget(const RenderTargetSpecification& specification) : m_Specification(specification), m_RequestedReadbacks(0)
+	{
+		KR_CORE_ASSERT(specification.m_Width > 0 && specification.m_Height > 0, "RenderTarget needs a non zero size");
+	}
+
+	uint32_t RenderTarget::GetBytesPerPixel(RenderTargetFormat format)
+	{
+		switch (format)
+		{
+			case RenderTargetFormat::RGBA8:
+			case RenderTargetFormat::BGRA8:
+				return 4;
+			case RenderTargetFormat::RGBA16F:
+				return 8;
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RenderTargetFormat");
+		return 0;
+	}
+
+	bool RenderTarget::EndFrame()
+	{
+		m_Statistics.m_NumberOfFrames++;
+
+		uint32_t requested = m_RequestedReadbacks.load();
+
+		while (requested > 0)
+		{
+			if (m_RequestedReadbacks.compare_exchange_weak(requested, requested - 1))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void RenderTarget::FillReadbackHeader(RenderTargetReadback& readback) const
+	{
+		// EndFrame has counted the frame being copied
+		readback.m_FrameNumber = m_Statistics.m_NumberOfFrames - 1;
+		readback.m_Width = m_Specification.m_Width;
+		readback.m_Height = m_Specification.m_Height;
+		readback.m_Format = m_Specification.m_ColorFormat;
+	}
+
+	void RenderTarget::CompleteReadback(RenderTargetReadback& readback, std::chrono::steady_clock::time_point issueTime)
+	{
+		readback.m_LatencyMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - issueTime).count();
+
+		m_Statistics.m_NumberOfCompletedReadbacks++;
+		m_Statistics.m_AverageLatencyMilliseconds += (readback.m_LatencyMilliseconds - m_Statistics.m_AverageLatencyMilliseconds) /
+			double(m_Statistics.m_NumberOfCompletedReadbacks);
+	}
+}
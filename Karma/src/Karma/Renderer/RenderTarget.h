@@ -0,0 +1,341 @@
+/**
+ * @file RenderTarget.h
+ * @brief This file contains the RenderTarget class, an offscreen color (and depth) target whose pixels can be read back without stalling.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace Karma
+{
+	/**
+	 * @brief Pixel format of the color attachment of a RenderTarget, also the layout of the read back pixels
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class RenderTargetFormat : uint8_t
+	{
+		/**
+		 * @brief 8 bit unsigned normalized red, green, blue and alpha
+		 */
+		RGBA8 = 0,
+		/**
+		 * @brief 8 bit unsigned normalized blue, green, red and alpha (the usual swapchain format)
+		 */
+		BGRA8,
+		/**
+		 * @brief 16 bit float red, green, blue and alpha
+		 */
+		RGBA16F
+	};
+
+	/**
+	 * @brief Format of the depth attachment of a RenderTarget
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class RenderTargetDepthFormat : uint8_t
+	{
+		/**
+		 * @brief No depth attachment
+		 */
+		None = 0,
+		/**
+		 * @brief 24 bit normalized depth with 8 bit stencil
+		 */
+		Depth24Stencil8,
+		/**
+		 * @brief 32 bit float depth
+		 */
+		Depth32F
+	};
+
+	/**
+	 * @brief What a RenderTarget is created with
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderTargetSpecification
+	{
+		/**
+		 * @brief Width in pixels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Width = 1280;
+
+		/**
+		 * @brief Height in pixels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Height = 720;
+
+		/**
+		 * @brief Format of the color attachment
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderTargetFormat m_ColorFormat = RenderTargetFormat::RGBA8;
+
+		/**
+		 * @brief Format of the depth attachment
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderTargetDepthFormat m_DepthFormat = RenderTargetDepthFormat::Depth24Stencil8;
+	};
+
+	/**
+	 * @brief The color attachment of a frame, as copied to host memory
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderTargetReadback
+	{
+		/**
+		 * @brief Number (counted from 0 by the target) of the frame the pixels belong to
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_FrameNumber = 0;
+
+		/**
+		 * @brief Width in pixels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Width = 0;
+
+		/**
+		 * @brief Height in pixels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Height = 0;
+
+		/**
+		 * @brief Layout of the pixels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderTargetFormat m_Format = RenderTargetFormat::RGBA8;
+
+		/**
+		 * @brief Tightly packed rows, m_Width * RenderTarget::GetBytesPerPixel(m_Format) bytes each. The first row is the top one on Vulkan
+		 * and the bottom one on OpenGL (see RenderTarget::IsBottomUp).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint8_t> m_Pixels;
+
+		/**
+		 * @brief Time between the end of the frame (when the copy was recorded) and PollReadback finding it done
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_LatencyMilliseconds = 0.0;
+	};
+
+	/**
+	 * @brief Counters of a RenderTarget, for benchmarks
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderTargetStatistics
+	{
+		/**
+		 * @brief Number of scenes rendered into the target
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfFrames = 0;
+
+		/**
+		 * @brief Number of copies recorded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfReadbacks = 0;
+
+		/**
+		 * @brief Number of copies handed out by PollReadback
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfCompletedReadbacks = 0;
+
+		/**
+		 * @brief Number of requests which found every slot in flight and were dropped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfDroppedReadbacks = 0;
+
+		/**
+		 * @brief Mean of RenderTargetReadback::m_LatencyMilliseconds over the completed copies
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_AverageLatencyMilliseconds = 0.0;
+	};
+
+	/**
+	 * @brief An offscreen target the scene can be rendered into instead of the window, for automated benchmarks and golden image tests
+	 * (on software implementations like llvmpipe or lavapipe as well).
+	 *
+	 * Usually the sequence goes like
+	 *
+	 *	@code{.cpp}
+	 *		std::shared_ptr<Karma::RenderTarget> target(Karma::RenderTarget::Create(specification));
+	 *
+	 *		target->RequestReadback();
+	 *		Karma::RenderCommand::SetRenderTarget(target);
+	 *		Karma::RenderCommand::SetClearColor({ 0.0f, 0.0f, 0.0f, 1 });
+	 *		Karma::RenderCommand::Clear();
+	 *		Karma::Renderer::BeginScene(m_Scene);
+	 *		Karma::Renderer::Submit(m_Scene);
+	 *		Karma::Renderer::EndScene();
+	 *		Karma::RenderCommand::SetRenderTarget(nullptr);
+	 *
+	 *		// Frames later
+	 *		Karma::RenderTargetReadback readback;
+	 *		while (target->PollReadback(readback))
+	 *		{
+	 *			// compare against the golden image
+	 *		}
+	 *	@endcode
+	 *
+	 * A requested copy is recorded at the end of the next scene rendered into the target, into one of s_ReadbackSlots host visible buffers
+	 * (staging buffers on Vulkan, pixel buffer objects on OpenGL), and PollReadback hands it out once the GPU is done, never waiting for it.
+	 * The GPU time of the scene goes to GPUProfiler as usual.
+	 *
+	 * @see RenderCommand::SetRenderTarget
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API RenderTarget
+	{
+	public:
+		/**
+		 * @brief A function for appropriate initialization of the target based on programmer selected renderer
+		 *
+		 * @param specification					Size and formats
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderTarget* Create(const RenderTargetSpecification& specification);
+
+		/**
+		 * @brief Destructor. Sub class frees up the attachments and the readback buffers.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~RenderTarget() = default;
+
+		/**
+		 * @brief Asks for the color attachment of the next scene rendered into the target to be copied. May be called from any thread.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RequestReadback() { m_RequestedReadbacks.fetch_add(1); }
+
+		/**
+		 * @brief Hands out the oldest copy the GPU is done with, without waiting
+		 *
+		 * @param readback						Gets the pixels
+		 *
+		 * @return false if no copy is done yet
+		 * @since Karma 1.0.0
+		 */
+		virtual bool PollReadback(RenderTargetReadback& readback) = 0;
+
+		/**
+		 * @brief Whether the first row of the read back pixels is the bottom one (OpenGL's convention)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool IsBottomUp() const { return false; }
+
+		/**
+		 * @brief The specification the target has been created with. The backend may have adjusted it (see VulkanRenderTarget).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const RenderTargetSpecification& GetSpecification() const { return m_Specification; }
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const RenderTargetStatistics& GetStatistics() const { return m_Statistics; }
+
+		/**
+		 * @brief Bytes per pixel of the format
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetBytesPerPixel(RenderTargetFormat format);
+
+		/**
+		 * @brief Bytes of a read back frame of the target
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetReadbackSize() const { return m_Specification.m_Width * m_Specification.m_Height * GetBytesPerPixel(m_Specification.m_ColorFormat); }
+
+	public:
+		/**
+		 * @brief Number of copies which may be in flight at once. Requests beyond are dropped (and counted).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_ReadbackSlots = 3;
+
+	protected:
+		/**
+		 * @brief Agnostic constructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderTarget(const RenderTargetSpecification& specification);
+
+		/**
+		 * @brief Counts the frame rendered into the target and takes a pending request, if any. Called by the backend at the end of the scene.
+		 *
+		 * @return true if a copy should be recorded
+		 * @since Karma 1.0.0
+		 */
+		bool EndFrame();
+
+		/**
+		 * @brief Fills in the latency of a completed copy and counts it
+		 *
+		 * @param readback						The copy, m_Pixels already filled in
+		 * @param issueTime						When the copy was recorded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CompleteReadback(RenderTargetReadback& readback, std::chrono::steady_clock::time_point issueTime);
+
+		/**
+		 * @brief Fills in the header (frame number, size and format) of a copy of the present frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void FillReadbackHeader(RenderTargetReadback& readback) const;
+
+	protected:
+		RenderTargetSpecification m_Specification;
+		RenderTargetStatistics m_Statistics;
+
+	private:
+		std::atomic<uint32_t> m_RequestedReadbacks;
+	};
+}
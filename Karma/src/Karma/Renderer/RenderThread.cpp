@@ -0,0 +1,288 @@
+#include "RenderThread.h"
+#include "RendererAPI.h"
+#include "Karma/CommandLine.h"
+
+namespace Karma
+{
+	static CommandLineOption s_RenderThreadOption("render-thread", "--render-thread=sync|pipelined picks the RenderThreadMode",
+		[](const std::string& value)
+		{
+			if (value == "pipelined")
+			{
+				RenderThread::SetMode(RenderThreadMode::Pipelined);
+			}
+			else if (value == "sync")
+			{
+				RenderThread::SetMode(RenderThreadMode::Synchronous);
+			}
+			else
+			{
+				KR_CORE_WARN("Unknown render thread mode {0} asked for, keeping the default one", value);
+			}
+		});
+
+	RenderThreadMode RenderThread::s_Mode = RenderThreadMode::Synchronous;
+	bool RenderThread::s_bDeferring = false;
+
+	RenderCommandQueue RenderThread::s_Queues[2];
+	uint32_t RenderThread::s_WriteIndex = 0;
+	std::atomic<uint32_t> RenderThread::s_ReadIndex(1);
+
+	std::thread RenderThread::s_Thread;
+	std::atomic<bool> RenderThread::s_bQuit(false);
+
+	std::atomic<uint64_t> RenderThread::s_KickedFrame(0);
+	std::atomic<uint64_t> RenderThread::s_CompletedFrame(0);
+
+	RenderFence RenderThread::s_LastFence = 0;
+	RenderFence RenderThread::s_LastKickedFence = 0;
+	std::atomic<RenderFence> RenderThread::s_SignaledFence(0);
+
+	std::atomic<uint64_t> RenderThread::s_LastRenderMicroseconds(0);
+	std::chrono::high_resolution_clock::time_point RenderThread::s_LastKickTime;
+	uint64_t RenderThread::s_FrameWaitMicroseconds = 0;
+
+	RenderThreadStatistics RenderThread::s_Statistics;
+
+	void RenderThread::Init()
+	{
+		if (s_Thread.joinable())
+		{
+			KR_CORE_WARN("Render thread is already running");
+			return;
+		}
+
+		s_LastKickTime = std::chrono::high_resolution_clock::now();
+		s_FrameWaitMicroseconds = 0;
+		s_Statistics = RenderThreadStatistics();
+
+		if (s_Mode == RenderThreadMode::Pipelined && RendererAPI::GetAPI() == RendererAPI::API::OpenGL)
+		{
+			KR_CORE_WARN("OpenGL context is bound to the main thread, render commands will run synchronously");
+			s_Mode = RenderThreadMode::Synchronous;
+		}
+
+		if (s_Mode == RenderThreadMode::Synchronous)
+		{
+			s_bDeferring = false;
+			KR_CORE_INFO("Render commands run synchronously on the game thread");
+			return;
+		}
+
+		s_bQuit.store(false);
+		s_bDeferring = true;
+
+		s_Thread = std::thread(&RenderThread::RenderThreadLoop);
+
+		KR_CORE_INFO("Render thread started, rendering one frame behind the game thread");
+	}
+
+	void RenderThread::Shutdown()
+	{
+		if (s_bDeferring)
+		{
+			// The render thread goes idle first, so that it sees the quit only after playing the leftovers
+			WaitForRenderThread();
+
+			s_bQuit.store(true, std::memory_order_release);
+			KickFrame();
+
+			WaitForRenderThread();
+			s_Thread.join();
+
+			s_bDeferring = false;
+		}
+
+		if (s_Statistics.m_NumberOfFrames > 0)
+		{
+			const uint64_t frames = s_Statistics.m_NumberOfFrames;
+
+			KR_CORE_INFO("Render thread ({0}): {1} frames, average frame {2} us, game thread {3} us, render thread {4} us, waiting {5} us",
+				s_Mode == RenderThreadMode::Pipelined ? "pipelined" : "synchronous", frames, s_Statistics.m_TotalFrameMicroseconds / frames,
+				s_Statistics.m_TotalGameThreadMicroseconds / frames, s_Statistics.m_TotalRenderThreadMicroseconds / frames,
+				s_Statistics.m_TotalWaitMicroseconds / frames);
+		}
+	}
+
+	void* RenderThread::AllocateFrameData(uint32_t size)
+	{
+		if (!s_bDeferring)
+		{
+			return nullptr;
+		}
+
+		return s_Queues[s_WriteIndex].AllocateData(size);
+	}
+
+	void RenderThread::KickFrame()
+	{
+		KR_CORE_ASSERT(!IsRenderThread(), "Frames are kicked by the game thread");
+
+		if (s_bDeferring)
+		{
+			// Only one frame in flight, the other queue must be free before it is recorded into
+			WaitForRenderThread();
+
+			const RenderCommandQueue& recordedQueue = s_Queues[s_WriteIndex];
+
+			s_Statistics.m_NumberOfCommands = recordedQueue.GetNumberOfCommands();
+			s_Statistics.m_RecordedBytes = recordedQueue.GetRecordedSize();
+			s_Statistics.m_RenderThreadMicroseconds = s_LastRenderMicroseconds.load(std::memory_order_relaxed);
+
+			s_LastKickedFence = s_LastFence;
+
+			s_ReadIndex.store(s_WriteIndex, std::memory_order_relaxed);
+			s_WriteIndex ^= 1;
+
+			s_KickedFrame.fetch_add(1, std::memory_order_release);
+			s_KickedFrame.notify_one();
+		}
+		else
+		{
+			// Everything has run already
+			s_LastKickedFence = s_LastFence;
+
+			s_KickedFrame.fetch_add(1, std::memory_order_relaxed);
+			s_CompletedFrame.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+
+		s_Statistics.m_FrameMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(now - s_LastKickTime).count();
+		s_Statistics.m_WaitMicroseconds = s_FrameWaitMicroseconds;
+		s_Statistics.m_GameThreadMicroseconds = s_Statistics.m_FrameMicroseconds > s_FrameWaitMicroseconds ?
+			s_Statistics.m_FrameMicroseconds - s_FrameWaitMicroseconds : 0;
+
+		s_Statistics.m_NumberOfFrames++;
+		s_Statistics.m_TotalFrameMicroseconds += s_Statistics.m_FrameMicroseconds;
+		s_Statistics.m_TotalGameThreadMicroseconds += s_Statistics.m_GameThreadMicroseconds;
+		s_Statistics.m_TotalRenderThreadMicroseconds += s_Statistics.m_RenderThreadMicroseconds;
+		s_Statistics.m_TotalWaitMicroseconds += s_Statistics.m_WaitMicroseconds;
+
+		s_LastKickTime = now;
+		s_FrameWaitMicroseconds = 0;
+	}
+
+	void RenderThread::WaitForRenderThread()
+	{
+		if (!s_bDeferring)
+		{
+			return;
+		}
+
+		// Only the game thread kicks
+		const uint64_t kickedFrame = s_KickedFrame.load(std::memory_order_relaxed);
+		uint64_t completedFrame = s_CompletedFrame.load(std::memory_order_acquire);
+
+		if (completedFrame == kickedFrame)
+		{
+			return;
+		}
+
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		while (completedFrame != kickedFrame)
+		{
+			s_CompletedFrame.wait(completedFrame, std::memory_order_acquire);
+			completedFrame = s_CompletedFrame.load(std::memory_order_acquire);
+		}
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+		s_FrameWaitMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+	}
+
+	RenderFence RenderThread::InsertFence()
+	{
+		const RenderFence fence = ++s_LastFence;
+
+		Enqueue([fence]()
+		{
+			s_SignaledFence.store(fence, std::memory_order_release);
+			s_SignaledFence.notify_all();
+		});
+
+		return fence;
+	}
+
+	bool RenderThread::IsFenceComplete(RenderFence fence)
+	{
+		return s_SignaledFence.load(std::memory_order_acquire) >= fence;
+	}
+
+	void RenderThread::WaitForFence(RenderFence fence)
+	{
+		if (IsFenceComplete(fence))
+		{
+			return;
+		}
+
+		if (fence > s_LastKickedFence)
+		{
+			KR_CORE_WARN("Waiting for a fence of the frame being recorded, kicking the frame early");
+			KickFrame();
+		}
+
+		RenderFence signaledFence = s_SignaledFence.load(std::memory_order_acquire);
+		while (signaledFence < fence)
+		{
+			s_SignaledFence.wait(signaledFence, std::memory_order_acquire);
+			signaledFence = s_SignaledFence.load(std::memory_order_acquire);
+		}
+	}
+
+	void RenderThread::ReleaseAfterFrame(std::shared_ptr<void> resource)
+	{
+		// The reference goes with the command, which is destroyed on the render thread once it has run
+		Enqueue([resource = std::move(resource)]() mutable
+		{
+			resource.reset();
+		});
+	}
+
+	bool RenderThread::IsRenderThread()
+	{
+		return s_Thread.joinable() && s_Thread.get_id() == std::this_thread::get_id();
+	}
+
+	bool RenderThread::IsRenderingContext()
+	{
+		// Only the game thread kicks, so an idle render thread stays idle till the caller kicks again
+		return !s_bDeferring || IsRenderThread() ||
+			s_CompletedFrame.load(std::memory_order_acquire) == s_KickedFrame.load(std::memory_order_relaxed);
+	}
+
+	void RenderThread::RenderThreadLoop()
+	{
+		uint64_t executedFrame = s_CompletedFrame.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			uint64_t kickedFrame = s_KickedFrame.load(std::memory_order_acquire);
+			while (kickedFrame == executedFrame)
+			{
+				s_KickedFrame.wait(kickedFrame, std::memory_order_acquire);
+				kickedFrame = s_KickedFrame.load(std::memory_order_acquire);
+			}
+
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+			s_Queues[s_ReadIndex.load(std::memory_order_relaxed)].Execute();
+
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			s_LastRenderMicroseconds.store(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count(), std::memory_order_relaxed);
+
+			executedFrame = kickedFrame;
+
+			// Read before signaling, the game thread sets it only while this thread is idle
+			const bool bQuit = s_bQuit.load(std::memory_order_acquire);
+
+			s_CompletedFrame.store(executedFrame, std::memory_order_release);
+			s_CompletedFrame.notify_all();
+
+			if (bQuit)
+			{
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,298 @@
+/**
+ * @file RenderThread.h
+ * @brief This file contains RenderThread class, which plays the render commands of a frame on a dedicated thread while the game thread records the next frame.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "RenderCommandQueue.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+namespace Karma
+{
+	/**
+	 * @brief The ways the render commands may be executed
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class RenderThreadMode : uint8_t
+	{
+		/**
+		 * @brief Every command runs right away on the calling thread, as if there were no queue. Meant for debugging (the call stack of a
+		 * draw leads back to its caller) and for the backends whose context is bound to the main thread (OpenGL).
+		 */
+		Synchronous = 0,
+
+		/**
+		 * @brief The commands of frame N are recorded in one queue and played by the render thread while the game thread records frame N + 1
+		 * into the other queue
+		 */
+		Pipelined
+	};
+
+	/**
+	 * @brief Fence value, see RenderThread::InsertFence
+	 *
+	 * @since Karma 1.0.0
+	 */
+	typedef uint64_t RenderFence;
+
+	/**
+	 * @brief Timings of the frames driven by RenderThread. The latest frame as well as the totals (for averages) are kept.
+	 *
+	 * Running the same application headless (--renderer=null --frames=N) with --render-thread=sync and then with --render-thread=pipelined
+	 * shows the overlap: with pipelining the frame takes about max(game, render) instead of game + render.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API RenderThreadStatistics
+	{
+		/**
+		 * @brief Number of frames handed over (KickFrame calls)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfFrames = 0;
+
+		/**
+		 * @brief Commands recorded in the latest frame (0 in RenderThreadMode::Synchronous)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfCommands = 0;
+
+		/**
+		 * @brief Bytes recorded in the latest frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_RecordedBytes = 0;
+
+		/**
+		 * @brief Wall clock time of the latest frame, from one KickFrame to the next
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_FrameMicroseconds = 0;
+
+		/**
+		 * @brief Time the game thread spent on the latest frame, without the waits for the render thread. In RenderThreadMode::Synchronous
+		 * this includes the execution of the commands.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_GameThreadMicroseconds = 0;
+
+		/**
+		 * @brief Time the render thread spent executing the latest completed frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_RenderThreadMicroseconds = 0;
+
+		/**
+		 * @brief Time the game thread waited for the render thread in the latest frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_WaitMicroseconds = 0;
+
+		/**
+		 * @brief Totals of the above over all the frames
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_TotalFrameMicroseconds = 0;
+		uint64_t m_TotalGameThreadMicroseconds = 0;
+		uint64_t m_TotalRenderThreadMicroseconds = 0;
+		uint64_t m_TotalWaitMicroseconds = 0;
+	};
+
+	/**
+	 * @brief Owner of the render thread and of the two RenderCommandQueue (double buffering) it plays.
+	 *
+	 * RenderCommand (and hence Renderer) records every call through Enqueue. At the end of a frame the game thread calls KickFrame, which
+	 * swaps the queues and wakes the render thread up with the recorded one. Only one frame is in flight: the game thread records frame N + 1
+	 * while the render thread executes frame N, and WaitForRenderThread (called before the next kick, and before anything else touches the GPU
+	 * from the main thread) blocks till it's done. The handshake is a pair of atomic frame counters, recording itself takes no lock.
+	 *
+	 * Whatever a command refers to must be captured by value: shared pointers keep the resources alive till the command has run, and the
+	 * commands of a frame are destroyed, on the render thread, right after they execute. ReleaseAfterFrame and the fences cover the rest.
+	 *
+	 * @see Application::Run
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API RenderThread
+	{
+	public:
+		/**
+		 * @brief Starts the render thread in RenderThreadMode::Pipelined, as set by SetMode. Called by Application::Run once the renderer is up.
+		 *
+		 * @note Pipelining needs a backend which can be driven from another thread. OpenGL (context current on the main thread) falls back to
+		 * RenderThreadMode::Synchronous.
+		 * @since Karma 1.0.0
+		 */
+		static void Init();
+
+		/**
+		 * @brief Plays what is left in the queues, joins the render thread and logs the average timings
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Shutdown();
+
+		/**
+		 * @brief Records a command for the render thread, or runs it right away in RenderThreadMode::Synchronous
+		 *
+		 * @param command						A callable taking no argument, capturing its arguments by value
+		 *
+		 * @since Karma 1.0.0
+		 */
+		template<typename CommandT>
+		static void Enqueue(CommandT&& command)
+		{
+			if (!s_bDeferring)
+			{
+				command();
+				return;
+			}
+
+			s_Queues[s_WriteIndex].Enqueue(std::forward<CommandT>(command));
+		}
+
+		/**
+		 * @brief Memory in the recording queue, valid till the commands recorded so far have run. For arrays a command points to (the world
+		 * matrices of an instanced draw say), which would otherwise have to be copied into a capture.
+		 *
+		 * @return nullptr in RenderThreadMode::Synchronous, where the caller's memory can be used directly
+		 * @since Karma 1.0.0
+		 */
+		static void* AllocateFrameData(uint32_t size);
+
+		/**
+		 * @brief Hands the recorded queue over to the render thread and starts recording into the other one. Waits for the previous frame
+		 * first, so at most one frame is in flight.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void KickFrame();
+
+		/**
+		 * @brief Blocks the game thread till the render thread has executed every handed over frame. After this the main thread may use
+		 * the GPU (KarmaGui, presentation) on its own.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void WaitForRenderThread();
+
+		/**
+		 * @brief Records a fence, signaled once the render thread has executed the commands recorded before it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderFence InsertFence();
+
+		/**
+		 * @brief Whether the commands recorded before the fence have been executed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsFenceComplete(RenderFence fence);
+
+		/**
+		 * @brief Blocks till the fence is signaled. The fence should have been handed over (KickFrame) already, else the frame is kicked here.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void WaitForFence(RenderFence fence);
+
+		/**
+		 * @brief Keeps the resource alive till the render thread has executed the commands recorded so far, and drops the reference there.
+		 * For resources the game thread is done with, but which the recorded commands may still use through raw pointers.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReleaseAfterFrame(std::shared_ptr<void> resource);
+
+		/**
+		 * @brief Sets the mode used by the next Init
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetMode(RenderThreadMode mode) { s_Mode = mode; }
+
+		/**
+		 * @brief The mode in effect
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderThreadMode GetMode() { return s_Mode; }
+
+		/**
+		 * @brief Whether the commands are recorded (true) or run right away (false)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsDeferring() { return s_bDeferring; }
+
+		/**
+		 * @brief Whether the caller is the render thread
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsRenderThread();
+
+		/**
+		 * @brief Whether the caller may make and change the GPU objects the render thread uses (pipelines, descriptor sets, uploads): it is the
+		 * render thread, or nothing is being played (RenderThreadMode::Synchronous, or the game thread after WaitForRenderThread till the next
+		 * KickFrame). For the ownership asserts of the backends' caches.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsRenderingContext();
+
+		/**
+		 * @brief Getter for the timings
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static const RenderThreadStatistics& GetStatistics() { return s_Statistics; }
+
+	private:
+		static void RenderThreadLoop();
+
+	private:
+		static RenderThreadMode s_Mode;
+		static bool s_bDeferring;
+
+		static RenderCommandQueue s_Queues[2];
+		static uint32_t s_WriteIndex;
+		static std::atomic<uint32_t> s_ReadIndex;
+
+		static std::thread s_Thread;
+		static std::atomic<bool> s_bQuit;
+
+		// Frames handed over by the game thread and executed by the render thread
+		static std::atomic<uint64_t> s_KickedFrame;
+		static std::atomic<uint64_t> s_CompletedFrame;
+
+		// Fences recorded by the game thread, handed over, and signaled by the render thread
+		static RenderFence s_LastFence;
+		static RenderFence s_LastKickedFence;
+		static std::atomic<RenderFence> s_SignaledFence;
+
+		static std::atomic<uint64_t> s_LastRenderMicroseconds;
+		static std::chrono::high_resolution_clock::time_point s_LastKickTime;
+		static uint64_t s_FrameWaitMicroseconds;
+
+		static RenderThreadStatistics s_Statistics;
+	};
+}
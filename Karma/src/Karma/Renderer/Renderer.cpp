@@ -1,12 +1,64 @@
 #include "Renderer.h"
+#include "FrustumCuller.h"
+#include "Material.h"
+#include "TextureStreamer.h"
+#include "AssetManager.h"
+#include "Karma/CommandLine.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Karma
 {
 	Renderer::SceneData* Renderer::m_SceneData = new Renderer::SceneData();
+	FrustumCuller* Renderer::m_FrustumCuller = new FrustumCuller();
+	bool Renderer::m_bDepthPrePass = false;
+	uint32_t Renderer::m_OpaqueDepthBuckets = 16;
+	RenderLODSettings Renderer::m_LODSettings;
+	std::vector<Renderer::SortedDraw> Renderer::m_OpaqueDraws;
+	std::vector<Renderer::SortedDraw> Renderer::m_TransparentDraws;
+	std::vector<float> Renderer::m_ViewDepths;
+	std::vector<glm::mat4> Renderer::m_InstanceTransforms;
+
+	static CommandLineOption s_DepthPrePassOption("depth-prepass", "--depth-prepass lays the depth of the opaque draws before shading them",
+		[](const std::string& value) { Renderer::SetDepthPrePass(true); });
+
+	static CommandLineOption s_LODOption("lod", "--lod=off draws every proxy at full detail",
+		[](const std::string& value) { Renderer::GetLODSettings().m_bEnabled = value != "off"; });
 
 	void Renderer::BeginScene(std::shared_ptr<Scene> scene)
 	{
 		RenderCommand::BeginScene();
+
+		AssetManager& assetManager = AssetManager::Get();
+
+		// Swapping reloaded contents into the loaded assets, and setting up again what is drawn with them, changes GPU objects the render
+		// thread may be drawing the previous frame with. Reloads are rare (hot reload), so the render thread is waited for.
+		if (assetManager.HasPreparedReloads() || (scene && scene->GetReloadGeneration() != assetManager.GetReloadGeneration()))
+		{
+			RenderThread::WaitForRenderThread();
+
+			assetManager.ApplyReloads();
+
+			if (scene)
+			{
+				scene->RefreshReloadedAssets(assetManager.GetReloadGeneration());
+			}
+		}
+
+		// On the render thread, ahead of this frame's draws: the assets loaded in the background made, the ones let go of unloaded, and
+		// the mips for the usage of the previous frame streamed
+		RenderThread::Enqueue([]()
+			{
+				AssetManager::Get().Update();
+
+				if (TextureStreamer::IsSupported())
+				{
+					TextureStreamer::Get().Update();
+				}
+			});
 	}
 
 	void Renderer::EndScene()
@@ -16,15 +68,282 @@ namespace Karma
 
 	void Renderer::Submit(std::shared_ptr<Scene> scene)
 	{
-		RenderCommand::DrawIndexed(scene->GetRenderableVertexArray());
+		RenderScene& renderScene = scene->GetRenderScene();
+		renderScene.ApplyDeltas();
+
+		if (renderScene.GetNumberOfProxies() == 0)
+		{
+			RenderCommand::DrawIndexed(scene->GetRenderableVertexArray());
+			return;
+		}
+
+		// Only what the camera sees is submitted
+		const std::vector<uint32_t>* visibleIndices = nullptr;
+		std::shared_ptr<Camera> camera = scene->GetAllCameras().size() ? scene->GetSceneCamera() : nullptr;
+
+		if (m_FrustumCuller && camera)
+		{
+			visibleIndices = &m_FrustumCuller->Cull(camera->GetFrustum(), renderScene.GetBoundsStream());
+		}
+
+		// Before the sort, which keys on the vertex array of the level picked
+		if (camera)
+		{
+			renderScene.SelectLODs(camera->GetViewMatirx(), camera->GetProjectionMatrix()[1][1], visibleIndices, m_LODSettings);
+
+			if (TextureStreamer::IsSupported())
+			{
+				ReportTextureUsage(*camera, renderScene, visibleIndices);
+			}
+		}
+
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		SortDraws(camera.get(), renderScene, visibleIndices);
+
+		RenderSceneStatistics& statistics = renderScene.GetStatistics();
+		statistics.m_NumberOfBatches = 0;
+		statistics.m_NumberOfInstancedBatches = 0;
+
+		for (RenderPassStatistics& passStatistics : statistics.m_Passes)
+		{
+			passStatistics.m_NumberOfDraws = 0;
+			passStatistics.m_NumberOfProxies = 0;
+			passStatistics.m_SubmitTimeMicroseconds = 0;
+		}
+
+		RendererAPI* rendererAPI = RenderCommand::GetRendererAPI();
+
+		if (m_bDepthPrePass && rendererAPI->SupportsDepthPrePass())
+		{
+			SubmitPass(RenderPassType::DepthPrePass, renderScene, m_OpaqueDraws);
+		}
+
+		SubmitPass(RenderPassType::Opaque, renderScene, m_OpaqueDraws);
+		SubmitPass(RenderPassType::Transparent, renderScene, m_TransparentDraws);
+
+		// The queries of the backend trail the submission by the frames in flight
+		for (uint32_t counter = 0; counter < s_NumberOfRenderPasses; counter++)
+		{
+			RenderPassStatistics& passStatistics = statistics.m_Passes[counter];
+			passStatistics.m_bHasFragmentInvocations = rendererAPI->GetFragmentInvocations(RenderPassType(counter), passStatistics.m_FragmentInvocations);
+		}
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+		statistics.m_SubmitTimeMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+	}
+
+	void Renderer::SortDraws(const Camera* camera, const RenderScene& renderScene, const std::vector<uint32_t>* visibleIndices)
+	{
+		const std::vector<RenderProxy>& proxies = renderScene.GetProxies();
+
+		m_OpaqueDraws.clear();
+		m_TransparentDraws.clear();
+		m_ViewDepths.clear();
+
+		const uint32_t numberOfDraws = visibleIndices ? uint32_t(visibleIndices->size()) : uint32_t(proxies.size());
+
+		// Distance along the view direction of each listed proxy's nearest bounding sphere point (opaque) or center (transparent), and the
+		// range they span, for the quantization below
+		const glm::mat4 viewMatrix = camera ? camera->GetViewMatirx() : glm::mat4(1.0f);
+		const float minimumDepth = 1.0e-3f;
+
+		float nearestDepth = std::numeric_limits<float>::max();
+		float farthestDepth = minimumDepth;
+
+		m_ViewDepths.resize(numberOfDraws);
+
+		for (uint32_t counter = 0; counter < numberOfDraws; counter++)
+		{
+			const RenderProxy& proxy = proxies[visibleIndices ? (*visibleIndices)[counter] : counter];
+
+			float depth = 0.0f;
+
+			if (camera)
+			{
+				depth = -(viewMatrix * glm::vec4(proxy.m_WorldBounds.m_Center, 1.0f)).z;
+
+				if (!proxy.m_Material->IsTransparent())
+				{
+					depth -= proxy.m_WorldBounds.m_Radius;
+				}
+			}
+
+			depth = std::max(depth, minimumDepth);
+
+			m_ViewDepths[counter] = depth;
+			nearestDepth = std::min(nearestDepth, depth);
+			farthestDepth = std::max(farthestDepth, depth);
+		}
+
+		// Log distributed: perspective spends its precision near the camera, and so should the buckets
+		const float logNearest = std::log(nearestDepth);
+		const float logRange = std::log(farthestDepth) - logNearest;
+
+		auto quantize = [logNearest, logRange](float depth, uint32_t steps)
+		{
+			if (logRange <= 0.0f)
+			{
+				return 0u;
+			}
+
+			const float position = (std::log(depth) - logNearest) / logRange;
+			return std::min(uint32_t(position * float(steps)), steps - 1);
+		};
+
+		const uint32_t transparentSteps = 1u << 16;
+
+		for (uint32_t counter = 0; counter < numberOfDraws; counter++)
+		{
+			const uint32_t index = visibleIndices ? (*visibleIndices)[counter] : counter;
+			const RenderProxy& proxy = proxies[index];
+
+			if (proxy.m_Material->IsTransparent())
+			{
+				// Back to front: the farthest gets the smallest key. The state key only orders proxies at the same quantized depth.
+				m_TransparentDraws.push_back({ transparentSteps - 1 - quantize(m_ViewDepths[counter], transparentSteps), proxy.m_SortKey, index });
+			}
+			else
+			{
+				// Front to back by bucket, then by state (program, material, vertex array) so that identical pairs stay adjacent in a bucket
+				m_OpaqueDraws.push_back({ quantize(m_ViewDepths[counter], m_OpaqueDepthBuckets), proxy.m_SortKey, index });
+			}
+		}
+
+		std::sort(m_OpaqueDraws.begin(), m_OpaqueDraws.end());
+		std::sort(m_TransparentDraws.begin(), m_TransparentDraws.end());
+	}
+
+	void Renderer::SubmitPass(RenderPassType pass, RenderScene& renderScene, const std::vector<SortedDraw>& draws)
+	{
+		if (draws.empty())
+		{
+			return;
+		}
+
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		const std::vector<RenderProxy>& proxies = renderScene.GetProxies();
+
+		RenderSceneStatistics& statistics = renderScene.GetStatistics();
+		RenderPassStatistics& passStatistics = statistics.m_Passes[uint32_t(pass)];
+
+		RenderCommand::BeginPass(pass);
+
+		// The materials are processed here, on the game thread: they only write their uniforms into the ring's region of the frame being
+		// recorded, and the draws take the offsets along. The GPU objects they are drawn with are made on the render thread.
+		size_t batchStart = 0;
+		while (batchStart < draws.size())
+		{
+			const RenderProxy& leader = proxies[draws[batchStart].m_ProxyIndex];
+
+			size_t batchEnd = batchStart + 1;
+			while (batchEnd < draws.size() && proxies[draws[batchEnd].m_ProxyIndex].m_Material == leader.m_Material &&
+				proxies[draws[batchEnd].m_ProxyIndex].m_VertexArray == leader.m_VertexArray)
+			{
+				batchEnd++;
+			}
+
+			std::shared_ptr<Shader> shader = leader.m_Material->GetShader(0);
+
+			if (shader && shader->SupportsInstancing())
+			{
+				// One draw for the batch. The common uniforms are pushed once and the world matrices travel per instance.
+				m_InstanceTransforms.clear();
+				for (size_t counter = batchStart; counter < batchEnd; counter++)
+				{
+					m_InstanceTransforms.push_back(proxies[draws[counter].m_ProxyIndex].m_WorldMatrix);
+				}
+
+				leader.m_Material->SetWorldMatrix(glm::mat4(1.0f));
+				leader.m_VertexArray->UpdateProcessAndSetReadyForSubmission();
+				leader.m_VertexArray->Bind();
+
+				RenderCommand::DrawIndexedInstanced(renderScene.GetVertexArray(draws[batchStart].m_ProxyIndex), m_InstanceTransforms.data(),
+					uint32_t(m_InstanceTransforms.size()));
+
+				statistics.m_NumberOfInstancedBatches++;
+				passStatistics.m_NumberOfDraws++;
+			}
+			else
+			{
+				for (size_t counter = batchStart; counter < batchEnd; counter++)
+				{
+					const RenderProxy& proxy = proxies[draws[counter].m_ProxyIndex];
+
+					proxy.m_Material->SetWorldMatrix(proxy.m_WorldMatrix);
+					proxy.m_VertexArray->UpdateProcessAndSetReadyForSubmission();
+					proxy.m_VertexArray->Bind();
+
+					RenderCommand::DrawIndexed(renderScene.GetVertexArray(draws[counter].m_ProxyIndex));
+				}
+
+				passStatistics.m_NumberOfDraws += uint32_t(batchEnd - batchStart);
+			}
+
+			statistics.m_NumberOfBatches++;
+			batchStart = batchEnd;
+		}
+
+		RenderCommand::EndPass();
+
+		passStatistics.m_NumberOfProxies = uint32_t(draws.size());
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+		passStatistics.m_SubmitTimeMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+	}
+
+	void Renderer::ReportTextureUsage(const Camera& camera, const RenderScene& renderScene, const std::vector<uint32_t>* visibleIndices)
+	{
+		const std::vector<RenderProxy>& proxies = renderScene.GetProxies();
+		const uint32_t numberOfProxies = visibleIndices ? uint32_t(visibleIndices->size()) : uint32_t(proxies.size());
+
+		const glm::mat4 viewMatrix = camera.GetViewMatirx();
+		const float projectionScale = camera.GetProjectionMatrix()[1][1];
+		const float minimumDepth = 1.0e-3f;
+
+		for (uint32_t counter = 0; counter < numberOfProxies; counter++)
+		{
+			const RenderProxy& proxy = proxies[visibleIndices ? (*visibleIndices)[counter] : counter];
+
+			if (proxy.m_Material == nullptr)
+			{
+				continue;
+			}
+
+			// The bounding sphere's diameter over the viewport's height, from its nearest point
+			const float depth = std::max(-(viewMatrix * glm::vec4(proxy.m_WorldBounds.m_Center, 1.0f)).z - proxy.m_WorldBounds.m_Radius,
+				minimumDepth);
+			const float screenFraction = proxy.m_WorldBounds.m_Radius * projectionScale / depth;
+
+			for (const std::shared_ptr<Texture>& texture : proxy.m_Material->GetTextures())
+			{
+				texture->ReportScreenSize(screenFraction);
+			}
+		}
 	}
 
 	void Renderer::DeleteData()
 	{
+		// The assets' buffers, shaders and textures go before the context does, the streamed textures to the streamer first
+		AssetManager::Get().ReleaseResources();
+
+		// GPU textures go before the context does
+		if (TextureStreamer::IsSupported())
+		{
+			TextureStreamer::Get().ReleaseResources();
+		}
+
 		if (m_SceneData)
 		{
 			delete m_SceneData;
 			m_SceneData = 0;
 		}
+
+		if (m_FrustumCuller)
+		{
+			delete m_FrustumCuller;
+			m_FrustumCuller = nullptr;
+		}
 	}
 }
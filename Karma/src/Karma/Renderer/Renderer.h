@@ -18,6 +18,11 @@
 
 namespace Karma
 {
+	/**
+	 * @brief Forward declaration
+	 */
+	class FrustumCuller;
+
 	/**
 	 * @brief An overlay, if I may consider, for RenderCommand, used for rendering a scene using a renderer (vulkan / opengl)
 	 */
@@ -54,6 +59,21 @@ namespace Karma
 		/**
 		 * @brief Submitting a scene for rendering
 		 *
+		 * If the scene has render proxies (Scene::GetRenderScene), the queued deltas are applied and the proxies are culled against the scene
+		 * camera's frustum (see FrustumCuller). The visible ones get their level of detail (GetLODSettings, RenderScene::SelectLODs), report
+		 * their screen size for their textures' mips (TextureStreamer) and are split by Material::IsTransparent and drawn in passes
+		 * (RenderPassType):
+		 * - DepthPrePass (if SetDepthPrePass and the backend supports it): the opaque list, laying depth only
+		 * - Opaque: sorted front to back by view depth, quantized in GetOpaqueDepthBuckets log distributed buckets, and by RenderSortKey
+		 *   (program, material, vertex array) within a bucket, so that near occluders are drawn first while the state changes stay few
+		 * - Transparent: sorted back to front, for correct blending
+		 *
+		 * Within a pass, runs of identical pairs whose shader reads a per instance world matrix (Shader::SupportsInstancing) are drawn with one
+		 * RenderCommand::DrawIndexedInstanced; the rest get a draw each, with the proxy's world matrix set on its material. Without proxies the
+		 * single renderable VertexArray is drawn (the caller having done UpdateProcessAndSetReadyForSubmission).
+		 *
+		 * The counters of each pass go to RenderSceneStatistics::m_Passes.
+		 *
 		 * @since Karma 1.0.0
 		 */
 		static void Submit(std::shared_ptr<Scene> scene);
@@ -72,6 +92,101 @@ namespace Karma
 		 */
 		static void DeleteData();
 
+		/**
+		 * @brief Getter for the visibility stage used by Submit, for setting the number of workers and reading the visible and culled counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static FrustumCuller* GetFrustumCuller() { return m_FrustumCuller; }
+
+		/**
+		 * @brief Whether Submit draws the opaque proxies in a depth only pass before shading them. Pays off when the fragment shading is
+		 * heavy and the overdraw high, costs a second geometry pass otherwise.
+		 *
+		 * @see RenderPassType::DepthPrePass
+		 * @since Karma 1.0.0
+		 */
+		static void SetDepthPrePass(bool bEnable) { m_bDepthPrePass = bEnable; }
+
+		/**
+		 * @brief Getter for the depth pre-pass setting
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsDepthPrePass() { return m_bDepthPrePass; }
+
+		/**
+		 * @brief Sets the number of depth buckets the opaque draws are sorted into (front to back) before the sort by state. More buckets
+		 * give a stricter front to back order but break more instanced batches apart, 1 sorts by state only.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SetOpaqueDepthBuckets(uint32_t numberOfBuckets) { m_OpaqueDepthBuckets = numberOfBuckets > 0 ? numberOfBuckets : 1; }
+
+		/**
+		 * @brief Getter for the number of depth buckets of the opaque draws
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetOpaqueDepthBuckets() { return m_OpaqueDepthBuckets; }
+
+		/**
+		 * @brief The level of detail settings Submit picks the proxies' levels with (RenderScene::SelectLODs), for the proxies of meshes
+		 * with levels (Mesh::GetLODs)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static RenderLODSettings& GetLODSettings() { return m_LODSettings; }
+
+	private:
+		/**
+		 * @brief A draw of the sorted lists of Submit: ordered by depth key, then RenderSortKey, then proxy index (for a deterministic order)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct SortedDraw
+		{
+			uint32_t m_DepthKey;
+			uint64_t m_SortKey;
+			uint32_t m_ProxyIndex;
+
+			bool operator<(const SortedDraw& other) const
+			{
+				if (m_DepthKey != other.m_DepthKey)
+				{
+					return m_DepthKey < other.m_DepthKey;
+				}
+				if (m_SortKey != other.m_SortKey)
+				{
+					return m_SortKey < other.m_SortKey;
+				}
+				return m_ProxyIndex < other.m_ProxyIndex;
+			}
+		};
+
+		/**
+		 * @brief Draws the proxies, in the given order, as a pass: batches runs of identical pairs into instanced draws and counts
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SubmitPass(RenderPassType pass, RenderScene& renderScene, const std::vector<SortedDraw>& draws);
+
+		/**
+		 * @brief Fills the draw lists of Submit with the given (visible, all if nullptr) proxies and sorts them by the depths seen from
+		 * the camera (by state only if there is no camera)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SortDraws(const Camera* camera, const RenderScene& renderScene, const std::vector<uint32_t>* visibleIndices);
+
+		/**
+		 * @brief Reports the screen size of the given (visible, all if nullptr) proxies to the TextureStreamer, for the textures of their
+		 * materials. A texture is taken to span its object once.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReportTextureUsage(const Camera& camera, const RenderScene& renderScene, const std::vector<uint32_t>* visibleIndices);
+
 	private:
 		// Needs to be in Scene class
 		struct SceneData
@@ -80,5 +195,17 @@ namespace Karma
 		};
 
 		static SceneData* m_SceneData;
+
+		static FrustumCuller* m_FrustumCuller;
+
+		static bool m_bDepthPrePass;
+		static uint32_t m_OpaqueDepthBuckets;
+		static RenderLODSettings m_LODSettings;
+
+		// Scratch of Submit: the sorted draw lists, the view depths of the listed proxies and the world matrices of an instanced batch
+		static std::vector<SortedDraw> m_OpaqueDraws;
+		static std::vector<SortedDraw> m_TransparentDraws;
+		static std::vector<float> m_ViewDepths;
+		static std::vector<glm::mat4> m_InstanceTransforms;
 	};
 }
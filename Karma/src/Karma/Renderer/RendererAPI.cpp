@@ -1,7 +1,52 @@
 #include "RendererAPI.h"
+#include "Material.h"
+#include "Karma/CommandLine.h"
 
 namespace Karma
 {
 	RendererAPI::API RendererAPI::s_API = RendererAPI::API::Vulkan;
 	glm::vec4 RendererAPI::m_ClearColor = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	static CommandLineOption s_RendererOption("renderer", "--renderer=vulkan|opengl|null picks the rendering api",
+		[](const std::string& value)
+		{
+			if (value == "vulkan")
+			{
+				RendererAPI::SetAPI(RendererAPI::API::Vulkan);
+			}
+			else if (value == "opengl")
+			{
+				RendererAPI::SetAPI(RendererAPI::API::OpenGL);
+			}
+			else if (value == "null")
+			{
+				RendererAPI::SetAPI(RendererAPI::API::Null);
+			}
+			else
+			{
+				KR_CORE_WARN("Unknown renderer {0} asked for, keeping the default one", value);
+				return;
+			}
+
+			KR_CORE_INFO("Renderer {0} selected", value);
+		}, "KARMA_RENDERER");
+
+	void RendererAPI::DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount)
+	{
+		std::shared_ptr<Material> material = vertexArray->GetMaterial();
+
+		for (uint32_t counter = 0; counter < instanceCount; counter++)
+		{
+			material->SetWorldMatrix(worldMatrices[counter]);
+			vertexArray->UpdateProcessAndSetReadyForSubmission();
+			vertexArray->Bind();
+
+			DrawIndexed(vertexArray);
+		}
+	}
+
+	void RendererAPI::SetAPI(API api)
+	{
+		s_API = api;
+	}
 }
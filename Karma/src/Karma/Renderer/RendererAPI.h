@@ -13,9 +13,16 @@
 
 #include "glm/glm.hpp"
 #include "VertexArray.h"
+#include "RenderPass.h"
+#include "TextureCompressor.h"
 
 namespace Karma
 {
+	/**
+	 * @brief Forward declaration
+	 */
+	class RenderTarget;
+
 	/**
 	 * @brief An abstract class for a renderer
 	 */
@@ -39,7 +46,13 @@ namespace Karma
 			/**
 			 * @brief Vulkan (https://www.vulkan.org)
 			 */
-			Vulkan = 2
+			Vulkan = 2,
+			/**
+			 * @brief Headless renderer which validates and counts, but does no GPU work
+			 *
+			 * @see NullRendererAPI
+			 */
+			Null = 3
 		};
 
 	public:
@@ -80,6 +93,108 @@ namespace Karma
 		 */
 		virtual void DrawIndexed(std::shared_ptr<VertexArray> vertexArray) = 0;
 
+		/**
+		 * @brief Routine for drawing instanceCount copies of the vertex array, each with its own world matrix
+		 *
+		 * The uniforms common to the instances (projection, view) should have been uploaded (UpdateProcessAndSetReadyForSubmission) and the
+		 * vertex array bound. Backends draw all the instances in one call when the shader reads the per instance world matrix
+		 * (Shader::SupportsInstancing). This default implementation issues one DrawIndexed per instance, with the matrix set on the material.
+		 *
+		 * @param vertexArray					The mesh + material to be rendered
+		 * @param worldMatrices					instanceCount world matrices
+		 * @param instanceCount					Number of instances
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount);
+
+		/**
+		 * @brief DrawIndexed with the uniforms written at uniformRingOffset (UniformBufferObject::GetRingOffset when the draw was recorded).
+		 * The draws recorded for the render thread run after later UploadUniformBuffer calls have moved the offset on.
+		 *
+		 * The default ignores the offset, for backends which bind the uniforms at upload.
+		 *
+		 * @see RenderThread
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexedRecorded(std::shared_ptr<VertexArray> vertexArray, uint32_t uniformRingOffset)
+		{
+			DrawIndexed(vertexArray);
+		}
+
+		/**
+		 * @brief DrawIndexedInstanced with the uniforms written at uniformRingOffset, see DrawIndexedRecorded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexedInstancedRecorded(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount,
+			uint32_t uniformRingOffset)
+		{
+			DrawIndexedInstanced(vertexArray, worldMatrices, instanceCount);
+		}
+
+		/**
+		 * @brief Starts a pass of the view. The draws till EndPass belong to it, and the backend sets the state the pass needs (depth only
+		 * writes for RenderPassType::DepthPrePass, depth test against the laid depth for Opaque, blending without depth writes for
+		 * Transparent). The default does nothing.
+		 *
+		 * @see Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginPass(RenderPassType pass) {}
+
+		/**
+		 * @brief Ends the pass begun by BeginPass, restoring the default state
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndPass() {}
+
+		/**
+		 * @brief Whether the backend can draw RenderPassType::DepthPrePass. If not, Renderer::Submit skips the pre-pass even when asked for it.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsDepthPrePass() const { return false; }
+
+		/**
+		 * @brief Whether textures of the format can be made and sampled. Cooked textures fall back to RGBA8 (TextureCompression::None)
+		 * when their format isn't.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsTextureFormat(TextureFormat format) const { return format == TextureFormat::RGBA8; }
+
+		/**
+		 * @brief The fragment shader invocations of the pass, as counted by pipeline statistics queries, of the latest frame whose results
+		 * are available
+		 *
+		 * @param pass						The pass
+		 * @param invocations				Gets the count
+		 *
+		 * @return false if the backend (or device) has no such queries, or no result has arrived yet
+		 * @since Karma 1.0.0
+		 */
+		virtual bool GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const { return false; }
+
+		/**
+		 * @brief Directs the scenes begun after this call into the offscreen target, or back into the window with nullptr. Backends copy
+		 * the requested readbacks of the target at EndScene.
+		 *
+		 * @param renderTarget				Target of the backend (RenderTarget::Create), kept alive by the caller while set
+		 *
+		 * @see RenderCommand::SetRenderTarget
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetRenderTarget(RenderTarget* renderTarget) { m_RenderTarget = renderTarget; }
+
+		/**
+		 * @brief The target set by SetRenderTarget, nullptr when rendering into the window
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderTarget* GetRenderTarget() const { return m_RenderTarget; }
+
 		/**
 		 * @brief Instructions for end of the scene
 		 *
@@ -101,11 +216,21 @@ namespace Karma
 		 */
 		inline static API GetAPI() { return s_API; }
 
+		/**
+		 * @brief Setter for rendering api to be used. Should be called before RenderCommand::Init.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SetAPI(API api);
+
 	private:
 		static API s_API;
 		
 	protected:
 		// Need to see the utility
 		static glm::vec4 m_ClearColor;
+
+		// Where the scenes go, nullptr for the window
+		RenderTarget* m_RenderTarget = nullptr;
 	};
 }
@@ -32,4 +32,21 @@ namespace Karma
 	{
 		m_Cameras.push_back(camera);
 	}
+
+	void Scene::RefreshReloadedAssets(uint64_t reloadGeneration)
+	{
+		if (reloadGeneration == m_ReloadGeneration)
+		{
+			return;
+		}
+
+		m_ReloadGeneration = reloadGeneration;
+
+		for (const std::shared_ptr<VertexArray>& vertexArray : m_VertexArrays)
+		{
+			vertexArray->RefreshReloadedAssets();
+		}
+
+		m_RenderScene.RefreshReloadedAssets();
+	}
 }
@@ -13,6 +13,7 @@
 
 #include "Camera.h"
 #include "VertexArray.h"
+#include "RenderScene.h"
 
 namespace Karma
 {
@@ -132,10 +133,40 @@ namespace Karma
 		 */
 		inline bool GetWindowToRenderWithinResizeStatus() const { return m_WindowResize; }
 
+		/**
+		 * @brief Getter for the render proxies (independently transformed objects) of the scene. When there are proxies, Renderer::Submit
+		 * draws them instead of the single renderable VertexArray.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		inline RenderScene& GetRenderScene() { return m_RenderScene; }
+
+		/**
+		 * @brief Sets up again the vertex arrays (and the proxies of the RenderScene) whose assets were reloaded, when the AssetManager
+		 * has reloaded any since the last call. Called by Renderer::BeginScene.
+		 *
+		 * @param reloadGeneration				AssetManager::GetReloadGeneration
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RefreshReloadedAssets(uint64_t reloadGeneration);
+
+		/**
+		 * @brief AssetManager::GetReloadGeneration the vertex arrays were last refreshed at
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetReloadGeneration() const { return m_ReloadGeneration; }
+
 	private:
 		std::vector<std::shared_ptr<VertexArray>> m_VertexArrays;
 		std::vector<std::shared_ptr<Camera>> m_Cameras;
 
+		RenderScene m_RenderScene;
+
+		// AssetManager::GetReloadGeneration the vertex arrays were refreshed at
+		uint64_t m_ReloadGeneration = 0;
+
 		glm::vec4 m_ClearColor;
 		
 		// Caution: raw pointer, courtsey authors of Dear ImGui
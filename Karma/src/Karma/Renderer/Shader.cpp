@@ -3,6 +3,7 @@
 #include "Karma/Core.h"
 #include "Platform/OpenGL/OpenGLShader.h"
 #include "Platform/Vulkan/VulkanShader.h"
+#include "Platform/Null/NullShader.h"
 
 // PCH stuff
 #include <vector>
@@ -21,6 +22,8 @@ namespace Karma
 			case RendererAPI::API::Vulkan:
 				KR_CORE_ASSERT(false, "Creating Vulkan shader this way is not supported");
 				return nullptr;// Use the overloaded version
+			case RendererAPI::API::Null:
+				return new NullShader(vertexSrc, fragmentSrc);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -39,9 +42,41 @@ namespace Karma
 				return new OpenGLShader(vertexSrcFile, fragmentSrcFile, ubo, shaderName);
 			case RendererAPI::API::Vulkan:
 				return new VulkanShader(vertexSrcFile, fragmentSrcFile, ubo);
+			case RendererAPI::API::Null:
+				return new NullShader(vertexSrcFile, fragmentSrcFile, ubo, shaderName);
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI");
 		return nullptr;
 	}
+
+	bool Shader::Prepare(const std::string& vertexSrcFile, const std::string& fragmentSrcFile)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+				KR_CORE_ASSERT(false, "RendererAPI::None is currently not supported");
+				return false;
+			case RendererAPI::API::Vulkan:
+				return VulkanShader::Prepare(vertexSrcFile, fragmentSrcFile);
+			case RendererAPI::API::OpenGL:
+			case RendererAPI::API::Null:
+				// Compiled by the context's thread at Create
+				return std::filesystem::exists(vertexSrcFile) && std::filesystem::exists(fragmentSrcFile);
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RendererAPI");
+		return false;
+	}
+
+	void Shader::SwapContents(Shader& other)
+	{
+		std::swap(m_bSupportsInstancing, other.m_bSupportsInstancing);
+		m_Generation++;
+	}
+
+	bool Shader::DeclaresInstanceTransform(const std::string& vertexSource)
+	{
+		return vertexSource.find(s_InstanceTransformName) != std::string::npos;
+	}
 }
@@ -12,6 +12,7 @@
 #include "krpch.h"
 
 #include "Karma/Renderer/Buffer.h"
+#include "Karma/Renderer/RenderSortKey.h"
 #include "glm/glm.hpp"
 
 namespace Karma
@@ -28,7 +29,7 @@ namespace Karma
 		 * @param ubo						Uniform buffer object to a assigned
 		 * @since Karma 1.0.0
 		 */
-		Shader(std::shared_ptr<UniformBufferObject> ubo) : m_UniformBufferObject(ubo)
+		Shader(std::shared_ptr<UniformBufferObject> ubo) : m_UniformBufferObject(ubo), m_SortID(RenderSortKey::NextSortID())
 		{}
 
 		/**
@@ -100,10 +101,76 @@ namespace Karma
 		 */
 		const std::string& GetShaderName() const { return m_ShaderName; }
 
+		/**
+		 * @brief Whether the vertex shader reads a per instance world matrix (mat4 named s_InstanceTransformName at location
+		 * s_InstanceTransformLocation, through location + 3). Such shaders are drawn with RenderCommand::DrawIndexedInstanced.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool SupportsInstancing() const { return m_bSupportsInstancing; }
+
+		/**
+		 * @brief Whether the (vertex) source declares the per instance world matrix. Backends without reflection use this.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool DeclaresInstanceTransform(const std::string& vertexSource);
+
+		/**
+		 * @brief The CPU side of making the shader of the files, which may run on any thread ahead of Create: compiles the stages (Vulkan,
+		 * into VulkanShader's SPIR-V cache), or checks that the files are there for the backends compiling at Create
+		 *
+		 * @return false if a file is missing or doesn't compile
+		 * @see AssetManager
+		 * @since Karma 1.0.0
+		 */
+		static bool Prepare(const std::string& vertexSrcFile, const std::string& fragmentSrcFile);
+
+		/**
+		 * @brief Swaps the compiled program with the one of other, a shader of the same backend made from the reloaded files, and counts
+		 * a generation. The name, uniform buffer and sort identity stay, so the materials holding this shader draw with the new program.
+		 *
+		 * @see AssetManager::SetHotReloadEnabled
+		 * @since Karma 1.0.0
+		 */
+		virtual void SwapContents(Shader& other);
+
+		/**
+		 * @brief Number of SwapContents so far, for the vertex arrays to tell that their pipelines are stale (VertexArray::RefreshReloadedAssets)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetGeneration() const { return m_Generation; }
+
+		/**
+		 * @brief Identity of the shader (the program) in RenderSortKey
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetSortID() const { return m_SortID; }
+
+		/**
+		 * @brief Name of the per instance world matrix vertex input
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr const char* s_InstanceTransformName = "inInstanceWorld";
+
+		/**
+		 * @brief First location of the per instance world matrix (a mat4 takes four consecutive locations), past the mesh attributes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_InstanceTransformLocation = 8;
+
 	private:
 		std::shared_ptr<UniformBufferObject> m_UniformBufferObject;
+		uint32_t m_SortID;
+		uint32_t m_Generation = 0;
 	
 	protected:
 		std::string m_ShaderName;
+
+		bool m_bSupportsInstancing = false;
 	};
 }
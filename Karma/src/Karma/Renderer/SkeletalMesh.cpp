@@ -1,14 +1,304 @@
 #include "SkeletalMesh.h"
+#include "RendererAPI.h"
+#include "Karma/Animation/RiggedAnimation.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define KR_SKINNING_SSE 1
+#endif
 
 namespace Karma
 {
 	SkeletalMesh::SkeletalMesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer, const std::string& meshName) :
-		Mesh(vertexBuffer, indexBuffer, meshName)
+		Mesh(vertexBuffer, indexBuffer, meshName, MeshType::SkeletalMesh)
+	{
+	}
+
+	SkeletalMesh::SkeletalMesh(const std::string& filePath) : Mesh(filePath, MeshType::SkeletalMesh)
 	{
+		Assimp::Importer assImporter;
+
+		// At most four bones a vertex, as the vertex buffer has room for
+		uint32_t importFlags = aiProcess_Triangulate | aiProcess_LimitBoneWeights;
+
+		if (RendererAPI::GetAPI() == RendererAPI::API::Vulkan)
+		{
+			importFlags = importFlags | aiProcess_FlipUVs;
+		}
+
+		const aiScene* scene = assImporter.ReadFile(filePath, importFlags);
+
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			KR_CORE_ERROR("ERROR ASSIMP:: {0}", assImporter.GetErrorString());
+			return;
+		}
+
+		ProcessNode(scene->mRootNode, scene);
+
+		if (!m_VertexBuffer)
+		{
+			KR_CORE_WARN("SkeletalMesh {0} has no mesh", filePath);
+			return;
+		}
+
+		m_Skeleton = Skeleton::FromScene(scene, m_BoneInfoMap);
+
+		for (uint32_t counter = 0; counter < scene->mNumAnimations; counter++)
+		{
+			m_Animations.push_back(RiggedAnimation::FromAssimp(scene->mAnimations[counter], m_Skeleton, RiggedAnimation::GetDefaultCompression()));
+		}
+
+		uint64_t animationBytes = 0;
+
+		for (const std::shared_ptr<RiggedAnimation>& animation : m_Animations)
+		{
+			animationBytes += animation->GetMemorySize();
+		}
+
+		KR_CORE_INFO("SkeletalMesh {0}: {1} vertices, {2} bones, {3} joints, {4} animations in {5} bytes", filePath, m_BindPositions.size(),
+			m_BoneInfoMap.size(), m_Skeleton->GetNumberOfJoints(), m_Animations.size(), animationBytes);
 	}
 
 	void SkeletalMesh::ProcessMesh(aiMesh* meshToProcess)
 	{
+		const uint32_t numberOfVertices = meshToProcess->mNumVertices;
+
+		m_BindPositions.resize(numberOfVertices);
+		m_BindNormals.assign(numberOfVertices, glm::vec3(0.0f));
+		m_BoneWeights.assign(numberOfVertices, VertexBoneWeights());
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			const aiVector3D& position = meshToProcess->mVertices[vertex];
+			m_BindPositions[vertex] = glm::vec3(position.x, position.y, position.z);
+
+			if (meshToProcess->mNormals)
+			{
+				const aiVector3D& normal = meshToProcess->mNormals[vertex];
+				m_BindNormals[vertex] = glm::vec3(normal.x, normal.y, normal.z);
+			}
+		}
+
+		// The bones of the mesh, numbered in the order they are met, and the heaviest four of each vertex
+		for (uint32_t boneIndex = 0; boneIndex < meshToProcess->mNumBones; boneIndex++)
+		{
+			const aiBone* bone = meshToProcess->mBones[boneIndex];
+			const std::string boneName = bone->mName.C_Str();
+
+			std::unordered_map<std::string, BoneInfo>::iterator boneInfo = m_BoneInfoMap.find(boneName);
+
+			if (boneInfo == m_BoneInfoMap.end())
+			{
+				BoneInfo newBoneInfo;
+				newBoneInfo.m_Id = int(m_BoneInfoMap.size());
+
+				// Assimp's matrices are row major
+				for (uint32_t row = 0; row < 4; row++)
+				{
+					for (uint32_t column = 0; column < 4; column++)
+					{
+						newBoneInfo.m_ModelToBoneTransform[column][row] = bone->mOffsetMatrix[row][column];
+					}
+				}
+
+				boneInfo = m_BoneInfoMap.emplace(boneName, newBoneInfo).first;
+			}
+
+			for (uint32_t weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++)
+			{
+				const aiVertexWeight& weight = bone->mWeights[weightIndex];
+
+				if (weight.mVertexId >= numberOfVertices)
+				{
+					continue;
+				}
+
+				VertexBoneWeights& vertexWeights = m_BoneWeights[weight.mVertexId];
+				float* lightest = std::min_element(vertexWeights.m_Weights, vertexWeights.m_Weights + 4);
+
+				if (weight.mWeight > *lightest)
+				{
+					vertexWeights.m_BoneIDs[lightest - vertexWeights.m_Weights] = uint32_t(boneInfo->second.m_Id);
+					*lightest = weight.mWeight;
+				}
+			}
+		}
+
+		if (m_BoneInfoMap.size() > s_MaxBones)
+		{
+			KR_CORE_WARN("SkeletalMesh {0}: {1} bones, the GPU skinning takes the first {2}", m_MeshName, m_BoneInfoMap.size(), s_MaxBones);
+		}
+
+		// v_Position, v_UV, v_Color, v_BoneIDs, v_BoneWeights, the locations skinned.vert reads
+		BufferLayout layout;
+		layout.PushElement({ ShaderDataType::Float3, "v_Position" });
+		layout.PushElement({ ShaderDataType::Float2, "v_UV" });
+		layout.PushElement({ ShaderDataType::Float4, "v_Color" });
+		layout.PushElement({ ShaderDataType::Float4, "v_BoneIDs" });
+		layout.PushElement({ ShaderDataType::Float4, "v_BoneWeights" });
+
+		const uint32_t floatsPerVertex = layout.GetStride() / sizeof(float);
+
+		std::vector<float> vertexData(size_t(numberOfVertices) * floatsPerVertex);
+
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			float* destination = vertexData.data() + size_t(vertex) * floatsPerVertex;
+			VertexBoneWeights& vertexWeights = m_BoneWeights[vertex];
+
+			float weightSum = 0.0f;
+			float gpuWeightSum = 0.0f;
+
+			for (uint32_t influence = 0; influence < 4; influence++)
+			{
+				weightSum += vertexWeights.m_Weights[influence];
+				gpuWeightSum += vertexWeights.m_BoneIDs[influence] < s_MaxBones ? vertexWeights.m_Weights[influence] : 0.0f;
+			}
+
+			destination[0] = m_BindPositions[vertex].x;
+			destination[1] = m_BindPositions[vertex].y;
+			destination[2] = m_BindPositions[vertex].z;
+
+			destination[3] = meshToProcess->mTextureCoords[0] ? meshToProcess->mTextureCoords[0][vertex].x : 0.0f;
+			destination[4] = meshToProcess->mTextureCoords[0] ? meshToProcess->mTextureCoords[0][vertex].y : 0.0f;
+
+			const aiColor4D color = meshToProcess->mColors[0] ? meshToProcess->mColors[0][vertex] : aiColor4D(1.0f, 1.0f, 1.0f, 1.0f);
+			destination[5] = color.r;
+			destination[6] = color.g;
+			destination[7] = color.b;
+			destination[8] = color.a;
+
+			for (uint32_t influence = 0; influence < 4; influence++)
+			{
+				const bool bOnGPU = vertexWeights.m_BoneIDs[influence] < s_MaxBones && gpuWeightSum > 0.0f;
+
+				// The IDs as floats, the vertex data being floats throughout
+				destination[9 + influence] = bOnGPU ? float(vertexWeights.m_BoneIDs[influence]) : 0.0f;
+				destination[13 + influence] = bOnGPU ? vertexWeights.m_Weights[influence] / gpuWeightSum : 0.0f;
+
+				vertexWeights.m_Weights[influence] = weightSum > 0.0f ? vertexWeights.m_Weights[influence] / weightSum : 0.0f;
+			}
+		}
+
+		std::vector<uint32_t> indexData;
+		indexData.reserve(size_t(meshToProcess->mNumFaces) * 3);
+
+		for (uint32_t face = 0; face < meshToProcess->mNumFaces; face++)
+		{
+			for (uint32_t index = 0; index < meshToProcess->mFaces[face].mNumIndices; index++)
+			{
+				indexData.push_back(meshToProcess->mFaces[face].mIndices[index]);
+			}
+		}
+
+		m_VertexBuffer.reset(VertexBuffer::Create(vertexData.data(), uint32_t(vertexData.size() * sizeof(float))));
+		m_VertexBuffer->SetLayout(layout);
+		m_VertexDataSize = vertexData.size() * sizeof(float);
+
+		m_IndexBuffer.reset(IndexBuffer::Create(indexData.data(), uint32_t(indexData.size())));
+
+		// The bind pose's, an animated pose may reach past them
+		m_Bounds = RenderBounds::FromPositions(vertexData.data(), numberOfVertices, floatsPerVertex);
+	}
+
+	void SkeletalMesh::Skin(const glm::mat4* skinMatrices, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) const
+	{
+		positions.resize(m_BindPositions.size());
+		normals.resize(m_BindNormals.size());
+
+		SkinVertices(m_BindPositions.data(), m_BindNormals.data(), m_BoneWeights.data(), uint32_t(m_BindPositions.size()), skinMatrices,
+			positions.data(), normals.data());
+	}
+
+	void SkeletalMesh::SkinVertices(const glm::vec3* positions, const glm::vec3* normals, const VertexBoneWeights* weights, uint32_t numberOfVertices,
+		const glm::mat4* skinMatrices, glm::vec3* skinnedPositions, glm::vec3* skinnedNormals)
+	{
+		for (uint32_t vertex = 0; vertex < numberOfVertices; vertex++)
+		{
+			const VertexBoneWeights& vertexWeights = weights[vertex];
+
+			if (vertexWeights.m_Weights[0] + vertexWeights.m_Weights[1] + vertexWeights.m_Weights[2] + vertexWeights.m_Weights[3] <= 0.0f)
+			{
+				// Following no bone
+				skinnedPositions[vertex] = positions[vertex];
+				skinnedNormals[vertex] = normals[vertex];
+				continue;
+			}
+
+#if defined(KR_SKINNING_SSE)
+			// The weighted sum of the bones' matrices, a column a register
+			__m128 column0 = _mm_setzero_ps();
+			__m128 column1 = _mm_setzero_ps();
+			__m128 column2 = _mm_setzero_ps();
+			__m128 column3 = _mm_setzero_ps();
+
+			for (uint32_t influence = 0; influence < 4; influence++)
+			{
+				const float* matrix = &skinMatrices[vertexWeights.m_BoneIDs[influence]][0][0];
+				const __m128 weight = _mm_set1_ps(vertexWeights.m_Weights[influence]);
+
+				column0 = _mm_add_ps(column0, _mm_mul_ps(_mm_loadu_ps(matrix), weight));
+				column1 = _mm_add_ps(column1, _mm_mul_ps(_mm_loadu_ps(matrix + 4), weight));
+				column2 = _mm_add_ps(column2, _mm_mul_ps(_mm_loadu_ps(matrix + 8), weight));
+				column3 = _mm_add_ps(column3, _mm_mul_ps(_mm_loadu_ps(matrix + 12), weight));
+			}
+
+			const glm::vec3& position = positions[vertex];
+			const glm::vec3& normal = normals[vertex];
+
+			__m128 skinnedPosition = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(position.x)), _mm_mul_ps(column1, _mm_set1_ps(position.y)));
+			skinnedPosition = _mm_add_ps(skinnedPosition, _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(position.z)), column3));
+
+			__m128 skinnedNormal = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(normal.x)), _mm_mul_ps(column1, _mm_set1_ps(normal.y)));
+			skinnedNormal = _mm_add_ps(skinnedNormal, _mm_mul_ps(column2, _mm_set1_ps(normal.z)));
+
+			// Stored whole, then three of the four taken, the arrays being of vec3
+			alignas(16) float positionValues[4];
+			alignas(16) float normalValues[4];
+			_mm_store_ps(positionValues, skinnedPosition);
+			_mm_store_ps(normalValues, skinnedNormal);
+
+			skinnedPositions[vertex] = glm::vec3(positionValues[0], positionValues[1], positionValues[2]);
+			const glm::vec3 skinnedNormalValue(normalValues[0], normalValues[1], normalValues[2]);
+#else
+			glm::mat4 skinMatrix(0.0f);
+
+			for (uint32_t influence = 0; influence < 4; influence++)
+			{
+				skinMatrix += skinMatrices[vertexWeights.m_BoneIDs[influence]] * vertexWeights.m_Weights[influence];
+			}
+
+			skinnedPositions[vertex] = glm::vec3(skinMatrix * glm::vec4(positions[vertex], 1.0f));
+			const glm::vec3 skinnedNormalValue = glm::vec3(skinMatrix * glm::vec4(normals[vertex], 0.0f));
+#endif
+
+			// Left as they were for meshes without normals
+			const float length = glm::length(skinnedNormalValue);
+			skinnedNormals[vertex] = length > 0.0f ? skinnedNormalValue / length : normals[vertex];
+		}
+	}
+
+	std::vector<ShaderDataType> SkeletalMesh::GetSkinnedUniformTypes()
+	{
+		std::vector<ShaderDataType> uniformTypes = { ShaderDataType::Mat4, ShaderDataType::Mat4, ShaderDataType::Mat4 };
+		uniformTypes.insert(uniformTypes.end(), s_MaxBones, ShaderDataType::Mat4);
+
+		return uniformTypes;
+	}
+
+	std::shared_ptr<RiggedAnimation> SkeletalMesh::FindAnimation(const std::string& name) const
+	{
+		for (const std::shared_ptr<RiggedAnimation>& animation : m_Animations)
+		{
+			if (animation->GetName() == name)
+			{
+				return animation;
+			}
+		}
 
+		return nullptr;
 	}
-}
\ No newline at end of file
+}
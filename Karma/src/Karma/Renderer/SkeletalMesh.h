@@ -15,12 +15,15 @@
 
 namespace Karma
 {
+	class Skeleton;
+	class RiggedAnimation;
+
 	/**
 	 * @brief A structure of bone information used to identify in SkeletalMesh
 	 */
 	struct BoneInfo
 	{
-		/** 
+		/**
 		 * @brief The index in u_FinalBonesMatrices.
 		 */
 		int m_Id;
@@ -32,7 +35,22 @@ namespace Karma
 	};
 
 	/**
-	 * @brief SkeletalMesh class
+	 * @brief The bones (BoneInfo::m_Id) a vertex follows and their weights, summing to 1 (or all 0 for a vertex following none)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API VertexBoneWeights
+	{
+		uint32_t m_BoneIDs[4] = { 0, 0, 0, 0 };
+		float m_Weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	/**
+	 * @brief SkeletalMesh class. The first mesh of a rigged model, its vertices weighted to the bones of the Skeleton, along with
+	 * the animations of the model (RiggedAnimation, played by Anuprana).
+	 *
+	 * The vertex buffer is laid out v_Position, v_UV, v_Color, v_BoneIDs, v_BoneWeights, as skinned.vert reads it. The vertices are
+	 * skinned on the GPU by the matrices of Anuprana::GetSkinMatrices (Material::SetBoneMatrices), or on the CPU by Skin.
 	 */
 	class KARMA_API SkeletalMesh : public Mesh
 	{
@@ -50,10 +68,86 @@ namespace Karma
 		SkeletalMesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer, const std::string& meshName = "NoName");
 
 		/**
-		 * @brief To be written appropriately
+		 * @brief Imports the first mesh of the model with Assimp, with its bones, the node hierarchy as the Skeleton, and the animations
+		 * (compressed as RiggedAnimation::GetDefaultCompression says)
+		 *
+		 * @param filePath						The model file
+		 *
+		 * @since Karma 1.0.0
+		 */
+		SkeletalMesh(const std::string& filePath);
+
+		/**
+		 * @brief Makes the buffers of the mesh, the bone weights of each vertex included (the four heaviest, normalized), and keeps
+		 * the bind pose positions and normals for Skin
 		 *
 		 * @since Karma 1.0.0
 		 */
 		virtual void ProcessMesh(aiMesh* meshToProcess) override;
+
+		/**
+		 * @brief Skins the bind pose vertices on the CPU
+		 *
+		 * @param skinMatrices					By BoneInfo::m_Id, Anuprana::GetSkinMatrices
+		 * @param positions						Gets the skinned positions, a vertex each
+		 * @param normals						Gets the skinned normals
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Skin(const glm::mat4* skinMatrices, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) const;
+
+		/**
+		 * @brief Skins the vertices, each by the weighted sum of the matrices of its bones (SIMD where the compiler allows)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void SkinVertices(const glm::vec3* positions, const glm::vec3* normals, const VertexBoneWeights* weights, uint32_t numberOfVertices,
+			const glm::mat4* skinMatrices, glm::vec3* skinnedPositions, glm::vec3* skinnedNormals);
+
+		/**
+		 * @brief The types of the uniform buffer object of skinned.vert: projection, view, world and s_MaxBones bone matrices. Its materials
+		 * are to be marked Material::SetSkinned.
+		 *
+		 * @see UniformBufferObject::Create
+		 * @since Karma 1.0.0
+		 */
+		static std::vector<ShaderDataType> GetSkinnedUniformTypes();
+
+		const std::unordered_map<std::string, BoneInfo>& GetBoneInfoMap() const { return m_BoneInfoMap; }
+
+		/**
+		 * @brief The joint hierarchy, nullptr for meshes made from bare buffers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::shared_ptr<Skeleton>& GetSkeleton() const { return m_Skeleton; }
+
+		const std::vector<std::shared_ptr<RiggedAnimation>>& GetAnimations() const { return m_Animations; }
+
+		/**
+		 * @brief The animation of the name, nullptr if there is none
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<RiggedAnimation> FindAnimation(const std::string& name) const;
+
+		/**
+		 * @brief Most bones the GPU skinning takes (KARMA_MAX_BONES of skinned.vert). The weights of the bones past it are left out of
+		 * the vertex buffer (the others renormalized), Skin takes them all.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static const uint32_t s_MaxBones = 64;
+
+	private:
+		std::unordered_map<std::string, BoneInfo> m_BoneInfoMap;
+
+		std::shared_ptr<Skeleton> m_Skeleton;
+		std::vector<std::shared_ptr<RiggedAnimation>> m_Animations;
+
+		// Bind pose, for Skin
+		std::vector<glm::vec3> m_BindPositions;
+		std::vector<glm::vec3> m_BindNormals;
+		std::vector<VertexBoneWeights> m_BoneWeights;
 	};
 }
@@ -0,0 +1,68 @@
+#include "StreamedTexture.h"
+#include "Renderer.h"
+#include "Platform/OpenGL/OpenGLStreamedTexture.h"
+#include "Platform/Null/NullStreamedTexture.h"
+#include "Platform/Vulkan/VulkanStreamedTexture.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+
+namespace Karma
+{
+	StreamedTexture::StreamedTexture(uint32_t width, uint32_t height, TextureFormat format) : m_Width(width), m_Height(height),
+		m_Format(format)
+	{
+		m_NumberOfMips = ComputeNumberOfMips(width, height);
+		m_FirstResidentMip = m_NumberOfMips;
+	}
+
+	uint32_t StreamedTexture::ComputeNumberOfMips(uint32_t width, uint32_t height)
+	{
+		uint32_t numberOfMips = 1;
+
+		for (uint32_t extent = std::max(width, height); extent > 1; extent >>= 1)
+		{
+			numberOfMips++;
+		}
+
+		return numberOfMips;
+	}
+
+	StreamedTexture* StreamedTexture::Create(uint32_t width, uint32_t height, TextureFormat format)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return new OpenGLStreamedTexture(width, height, format);
+			case RendererAPI::API::Vulkan:
+				// The per material descriptor sets hold the image view the vertex array was made with, so only the bindless table streams
+				if (!VulkanHolder::GetVulkanContext()->SupportsBindless())
+				{
+					return nullptr;
+				}
+				return new VulkanStreamedTexture(width, height, format);
+			case RendererAPI::API::Null:
+				return new NullStreamedTexture(width, height, format);
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
+		return nullptr;
+	}
+
+	void StreamedTexture::Flush()
+	{
+		if (Renderer::GetAPI() == RendererAPI::API::Vulkan && VulkanHolder::GetVulkanContext()->SupportsBindless())
+		{
+			VulkanStreamedTexture::Flush();
+		}
+	}
+
+	void StreamedTexture::ReleaseResources()
+	{
+		if (Renderer::GetAPI() == RendererAPI::API::Vulkan && VulkanHolder::GetVulkanContext()->SupportsBindless())
+		{
+			VulkanStreamedTexture::ReleaseResources();
+		}
+	}
+}
@@ -0,0 +1,147 @@
+/**
+ * @file StreamedTexture.h
+ * @brief This file contains the StreamedTexture class, the GPU side of a texture whose mips come and go (TextureStreamer).
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "TextureCompressor.h"
+
+#include <algorithm>
+
+namespace Karma
+{
+	/**
+	 * @brief An RGBA8 (sRGB), or block compressed, texture with a full mip chain of which only the tail from GetFirstResidentMip is in memory and sampled.
+	 * Mips are uploaded one at a time from the smallest up, so that the texture is complete after every upload, and dropped from the
+	 * largest down.
+	 *
+	 * @see TextureStreamer
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API StreamedTexture
+	{
+	public:
+		/**
+		 * @brief Destructor, frees whatever is resident
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~StreamedTexture() = default;
+
+		/**
+		 * @brief Uploads a mip, which must be GetFirstResidentMip() - 1 (or the last mip of a texture with none resident), and samples from
+		 * it on
+		 *
+		 * @param mip							The mip, 0 being the full size
+		 * @param pixels						Tightly packed texels (or blocks) of the texture's format, GetMipSize bytes. Copied before
+		 * 										returning.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void UploadMip(uint32_t mip, const uint8_t* pixels) = 0;
+
+		/**
+		 * @brief Drops the mips above firstMip (larger than it) from memory and samples from firstMip on
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void Evict(uint32_t firstMip) = 0;
+
+		/**
+		 * @brief Binds the texture to the texture unit, for the APIs binding per draw
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void Bind(uint32_t unit) const = 0;
+
+		/**
+		 * @brief The largest mip in memory, GetNumberOfMips() when none is
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetFirstResidentMip() const { return m_FirstResidentMip; }
+
+		uint32_t GetNumberOfMips() const { return m_NumberOfMips; }
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		TextureFormat GetFormat() const { return m_Format; }
+
+		/**
+		 * @brief Changes the format of the mips to come, for a texture made before its first decode (TextureStreamer::GetTexture)
+		 *
+		 * @note Only with nothing resident
+		 * @since Karma 1.0.0
+		 */
+		void SetFormat(TextureFormat format)
+		{
+			KR_CORE_ASSERT(m_FirstResidentMip == m_NumberOfMips, "The format of a streamed texture changes with nothing resident only");
+			m_Format = format;
+		}
+
+		/**
+		 * @brief Creates the texture of the renderer's API, with nothing resident
+		 *
+		 * @param width							Width of mip 0
+		 * @param height						Height of mip 0
+		 * @param format						Format of the mips, which the API must support (RendererAPI::SupportsTextureFormat)
+		 *
+		 * @return nullptr for the APIs which don't stream (Vulkan without the bindless table, see TextureStreamer::IsSupported)
+		 * @since Karma 1.0.0
+		 */
+		static StreamedTexture* Create(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::RGBA8);
+
+		/**
+		 * @brief Makes the uploads and evictions since the last call visible to the draws, for the APIs which can't do so right away
+		 * (Vulkan remakes the images, VulkanStreamedTexture::Flush). Once per TextureStreamer::Update.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Flush();
+
+		/**
+		 * @brief Frees what the API's streamed textures share or have retired, after they are deleted and before the context goes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReleaseResources();
+
+		/**
+		 * @brief Number of mips down to 1x1
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t ComputeNumberOfMips(uint32_t width, uint32_t height);
+
+		/**
+		 * @brief Size of a mip, at least 1
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetMipExtent(uint32_t extent, uint32_t mip) { return std::max(extent >> mip, 1u); }
+
+		/**
+		 * @brief Bytes of a mip of the format
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t GetMipSize(TextureFormat format, uint32_t width, uint32_t height, uint32_t mip)
+		{
+			return TextureCompressor::GetDataSize(format, GetMipExtent(width, mip), GetMipExtent(height, mip));
+		}
+
+	protected:
+		StreamedTexture(uint32_t width, uint32_t height, TextureFormat format);
+
+	protected:
+		uint32_t m_Width;
+		uint32_t m_Height;
+		TextureFormat m_Format;
+		uint32_t m_NumberOfMips;
+		uint32_t m_FirstResidentMip;
+	};
+}
@@ -1,21 +1,55 @@
 #include "Texture.h"
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Platform/Null/NullBuffer.h"
 #include "Renderer.h"
+#include "CookedTexture.h"
 #include "Platform/Vulkan/VulkanTexutre.h"
+#include "Karma/CommandLine.h"
 
 namespace Karma
 {
-	Texture::Texture()
+	bool Texture::s_bStreamingAllowed = true;
+	bool Texture::s_bCookedTexturesAllowed = true;
+
+	static CommandLineOption s_TextureStreamingOption("texture-streaming", "--texture-streaming=off loads the textures whole instead of streaming their mips",
+		[](const std::string& value) { Texture::SetStreamingAllowed(value != "off"); });
+
+	static CommandLineOption s_CookedTexturesOption("cooked-textures", "--cooked-textures=off decodes the images at load time instead of loading their cooked files",
+		[](const std::string& value) { Texture::SetCookedTexturesAllowed(value != "off"); });
+
+	Texture::Texture() : m_MemorySize(0)
 	{
 	}
 
 	Texture::Texture(TextureType tType, const char* filename, std::string textureName, std::string textureShaderName) : m_TType(tType),
-		m_TName(textureName), m_TShaderName(textureShaderName)
+		m_TName(textureName), m_TShaderName(textureShaderName), m_MemorySize(0)
 	{
 		switch (tType)
 		{
 		case TextureType::Image:
 		{
+			if (s_bStreamingAllowed && TextureStreamer::IsSupported())
+			{
+				// Decoded in the background, from the smallest mip up, as the use asks. Cooked mips are uploaded as they are.
+				std::shared_ptr<TextureSource> source;
+
+				if (s_bCookedTexturesAllowed)
+				{
+					source = std::make_shared<CookedTextureSource>(filename, CookedTexture::GetCompression());
+				}
+				else
+				{
+					source = std::make_shared<FileTextureSource>(filename);
+				}
+
+				m_StreamHandle = TextureStreamer::Get().Register(source);
+
+				if (m_StreamHandle.IsSet())
+				{
+					break;
+				}
+			}
+
 			switch (Renderer::GetAPI())
 			{
 			case RendererAPI::API::None:
@@ -24,7 +58,30 @@ namespace Karma
 			case RendererAPI::API::OpenGL:
 				ImageBuffer::Create(filename);
 				break;
+			case RendererAPI::API::Null:
+			{
+				// Decoded, validated and counted, there is no texture object to keep
+				NullImageBuffer* nImageBuffer = static_cast<NullImageBuffer*>(ImageBuffer::Create(filename));
+				m_MemorySize = uint64_t(nImageBuffer->GetWidth()) * nImageBuffer->GetHeight() * 4;
+				delete nImageBuffer;
+				break;
+			}
 			case RendererAPI::API::Vulkan:
+			{
+				if (s_bCookedTexturesAllowed)
+				{
+					// The blocks of the mips go from the mapping to the staging ring
+					CookedTexture cookedTexture;
+
+					if (cookedTexture.LoadOrCook(filename, CookedTexture::GetCompression()))
+					{
+						m_VulkanTexture.reset(new VulkanTexture());
+						m_VulkanTexture->GenerateVulkanTexture(cookedTexture);
+						m_MemorySize = cookedTexture.GetDataSize();
+						break;
+					}
+				}
+
 				VulkanImageBuffer* vImageBuffer = static_cast<VulkanImageBuffer*>(ImageBuffer::Create(filename));
 				if (vImageBuffer != nullptr)
 				{
@@ -32,10 +89,14 @@ namespace Karma
 					// VulkanTexture::GenerateVulkanTexture(vImageBuffer);
 					m_VulkanTexture.reset(new VulkanTexture());
 					m_VulkanTexture->GenerateVulkanTexture(vImageBuffer);
+
+					// And the mips, a third more
+					m_MemorySize = uint64_t(vImageBuffer->GetImageSize()) * 4 / 3;
 				}
 				delete vImageBuffer;
 				break;
 			}
+			}
 			break;
 		}
 		case TextureType::DiffusionMap:
@@ -49,5 +110,60 @@ namespace Karma
 
 	Texture::~Texture()
 	{
+		if (m_StreamHandle.IsSet())
+		{
+			TextureStreamer::Get().Unregister(m_StreamHandle);
+		}
+	}
+
+	bool Texture::Prepare(const std::string& filename)
+	{
+		const bool bStreamed = s_bStreamingAllowed && TextureStreamer::IsSupported();
+
+		// Mirrors the constructor: only the streamed textures and the ones of Vulkan are loaded cooked
+		if (s_bCookedTexturesAllowed && (bStreamed || Renderer::GetAPI() == RendererAPI::API::Vulkan))
+		{
+			CookedTexture cookedTexture;
+
+			return cookedTexture.LoadOrCook(filename, CookedTexture::GetCompression());
+		}
+
+		return std::filesystem::exists(filename);
+	}
+
+	uint64_t Texture::GetMemorySize() const
+	{
+		if (m_StreamHandle.IsSet())
+		{
+			return TextureStreamer::Get().GetResidentBytes(m_StreamHandle);
+		}
+
+		return m_MemorySize;
+	}
+
+	void Texture::SwapContents(Texture& other)
+	{
+		// OpenGL's whole images are bound to the unit as they load (ImageBuffer::Create), nothing to swap for them
+		std::swap(m_VulkanTexture, other.m_VulkanTexture);
+		std::swap(m_StreamHandle, other.m_StreamHandle);
+		std::swap(m_MemorySize, other.m_MemorySize);
+
+		m_Generation++;
+	}
+
+	void Texture::Bind(uint32_t unit) const
+	{
+		if (m_StreamHandle.IsSet())
+		{
+			TextureStreamer::Get().Bind(m_StreamHandle, unit);
+		}
+	}
+
+	void Texture::ReportScreenSize(float screenFraction) const
+	{
+		if (m_StreamHandle.IsSet())
+		{
+			TextureStreamer::Get().ReportUsage(m_StreamHandle, screenFraction);
+		}
 	}
 }
@@ -11,6 +11,8 @@
 
 #include "krpch.h"
 
+#include "TextureStreamer.h"
+
 namespace Karma
 {
 	/**
@@ -94,6 +96,91 @@ namespace Karma
 		 */
 		std::shared_ptr<VulkanTexture> GetVulkanTexture() const { return m_VulkanTexture; }
 
+		/**
+		 * @brief Whether the mips of the texture come and go with its use (TextureStreamer), else it is loaded whole
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsStreamed() const { return m_StreamHandle.IsSet(); }
+
+		/**
+		 * @brief Getter for the handle of the streamed texture, not set for the textures loaded whole
+		 *
+		 * @see TextureStreamer::GetTexture
+		 * @since Karma 1.0.0
+		 */
+		TextureStreamHandle GetStreamHandle() const { return m_StreamHandle; }
+
+		/**
+		 * @brief Binds the streamed texture (or its placeholder till a mip is in) to the texture unit. The textures loaded whole are bound
+		 * by the backend.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Bind(uint32_t unit) const;
+
+		/**
+		 * @brief Tells the TextureStreamer that the texture is drawn this frame over screenFraction of the viewport's height
+		 *
+		 * @see Renderer::Submit
+		 * @since Karma 1.0.0
+		 */
+		void ReportScreenSize(float screenFraction) const;
+
+		/**
+		 * @brief Whether the textures made from now on may be streamed (the API permitting, TextureStreamer::IsSupported)
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetStreamingAllowed(bool bAllowed) { s_bStreamingAllowed = bAllowed; }
+
+		/**
+		 * @brief Whether the textures made from now on are loaded from their cooked files (CookedTexture), cooking them if need be. Else
+		 * the images are decoded and their mips made at load time, uncompressed.
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetCookedTexturesAllowed(bool bAllowed) { s_bCookedTexturesAllowed = bAllowed; }
+
+		/**
+		 * @brief The CPU side of loading the image, which may run on any thread ahead of the constructor: cooks it (CookedTexture) if the
+		 * constructor is going to load the cooked file and that is missing or stale, so that the constructor only maps it
+		 *
+		 * @param filename						The path of the image
+		 *
+		 * @return false if there is neither the image nor a usable cooked file
+		 * @see AssetManager
+		 * @since Karma 1.0.0
+		 */
+		static bool Prepare(const std::string& filename);
+
+		/**
+		 * @brief Bytes the texture takes on the GPU, only the resident mips for a streamed one. 0 when the backend doesn't tell (OpenGL
+		 * loading the image whole).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetMemorySize() const;
+
+		/**
+		 * @brief Swaps the GPU side (the Vulkan texture or the stream) with the one of other, a texture made from the reloaded image, and
+		 * counts a generation. The names stay, so the materials holding this texture sample the new image once the vertex arrays have
+		 * rebuilt their descriptors.
+		 *
+		 * @see AssetManager::SetHotReloadEnabled
+		 * @since Karma 1.0.0
+		 */
+		void SwapContents(Texture& other);
+
+		/**
+		 * @brief Number of SwapContents so far (VertexArray::RefreshReloadedAssets)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetGeneration() const { return m_Generation; }
+
 	private:
 		TextureType m_TType;
 		std::string m_TName;
@@ -103,5 +190,15 @@ namespace Karma
 
 		// For Vulkan specific purposes
 		std::shared_ptr<VulkanTexture> m_VulkanTexture;
+
+		TextureStreamHandle m_StreamHandle;
+
+		// Of the textures loaded whole
+		uint64_t m_MemorySize;
+
+		uint32_t m_Generation = 0;
+
+		static bool s_bStreamingAllowed;
+		static bool s_bCookedTexturesAllowed;
 	};
 }
@@ -0,0 +1,1368 @@
+#include "TextureCompressor.h"
+#include "TextureStreamer.h"
+#include "Karma/JobPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Karma
+{
+	namespace
+	{
+		typedef uint8_t BlockTexels[16][4];
+
+		// ETC1 intensity modifiers, the pixel indices (msb, lsb) 0 to 3 adding +a, +b, -a and -b
+		const int s_ETCModifiers[8][2] = { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+
+		const int s_EACModifiers[16][8] =
+		{
+			{ -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 }, { -2, -5, -8, -13, 1, 4, 7, 12 },
+			{ -2, -4, -6, -13, 1, 3, 5, 12 }, { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+			{ -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 }, { -2, -6, -8, -10, 1, 5, 7, 9 },
+			{ -2, -5, -8, -10, 1, 4, 7, 9 }, { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+			{ -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 }, { -4, -6, -8, -9, 3, 5, 7, 8 },
+			{ -3, -5, -7, -9, 2, 4, 6, 8 }
+		};
+
+		// BC7 interpolation weights (out of 64) of the 4 bit indices
+		const int s_BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		int Clamp255(int value)
+		{
+			return std::min(std::max(value, 0), 255);
+		}
+
+		int Square(int value)
+		{
+			return value * value;
+		}
+
+		/**
+		 * @brief Writes bits least significant first, as BC7 is laid out
+		 */
+		struct BitWriter
+		{
+			uint8_t* m_Data;
+			uint32_t m_Position;
+
+			void Write(uint32_t value, uint32_t numberOfBits)
+			{
+				for (uint32_t bit = 0; bit < numberOfBits; bit++, m_Position++)
+				{
+					m_Data[m_Position >> 3] |= uint8_t(((value >> bit) & 1) << (m_Position & 7));
+				}
+			}
+		};
+
+		struct BitReader
+		{
+			const uint8_t* m_Data;
+			uint32_t m_Position;
+
+			uint32_t Read(uint32_t numberOfBits)
+			{
+				uint32_t value = 0;
+
+				for (uint32_t bit = 0; bit < numberOfBits; bit++, m_Position++)
+				{
+					value |= uint32_t((m_Data[m_Position >> 3] >> (m_Position & 7)) & 1) << bit;
+				}
+
+				return value;
+			}
+		};
+
+		void StoreBigEndian(uint64_t value, uint8_t* destination)
+		{
+			for (uint32_t counter = 0; counter < 8; counter++)
+			{
+				destination[counter] = uint8_t(value >> (56 - counter * 8));
+			}
+		}
+
+		uint64_t LoadBigEndian(const uint8_t* source)
+		{
+			uint64_t value = 0;
+
+			for (uint32_t counter = 0; counter < 8; counter++)
+			{
+				value = (value << 8) | source[counter];
+			}
+
+			return value;
+		}
+
+		/**
+		 * @brief The texels of a block, those past the edges of the mip repeating its last row and column
+		 */
+		void FetchBlock(const TextureMip& mip, uint32_t blockX, uint32_t blockY, BlockTexels& texels)
+		{
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				const uint32_t row = std::min(blockY * 4 + y, mip.m_Height - 1);
+
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					const uint32_t column = std::min(blockX * 4 + x, mip.m_Width - 1);
+					memcpy(texels[y * 4 + x], &mip.m_Pixels[(size_t(row) * mip.m_Width + column) * 4], 4);
+				}
+			}
+		}
+
+		void StoreBlock(const BlockTexels& texels, uint32_t blockX, uint32_t blockY, TextureMip& mip)
+		{
+			for (uint32_t y = 0; y < 4 && blockY * 4 + y < mip.m_Height; y++)
+			{
+				for (uint32_t x = 0; x < 4 && blockX * 4 + x < mip.m_Width; x++)
+				{
+					memcpy(&mip.m_Pixels[(size_t(blockY * 4 + y) * mip.m_Width + blockX * 4 + x) * 4], texels[y * 4 + x], 4);
+				}
+			}
+		}
+
+		/**
+		 * @brief Ends of the segment along the principal axis of the block's texels (the first numberOfChannels channels) which spans
+		 * their projections
+		 */
+		void FitPrincipalAxis(const BlockTexels& texels, uint32_t numberOfChannels, float start[4], float end[4])
+		{
+			float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+				{
+					mean[channel] += texels[texel][channel] / 16.0f;
+				}
+			}
+
+			float covariance[4][4] = {};
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				float difference[4];
+
+				for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+				{
+					difference[channel] = texels[texel][channel] - mean[channel];
+				}
+
+				for (uint32_t row = 0; row < numberOfChannels; row++)
+				{
+					for (uint32_t column = 0; column < numberOfChannels; column++)
+					{
+						covariance[row][column] += difference[row] * difference[column];
+					}
+				}
+			}
+
+			// Power iteration, from the channel of the largest variance
+			float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			uint32_t largest = 0;
+
+			for (uint32_t channel = 1; channel < numberOfChannels; channel++)
+			{
+				if (covariance[channel][channel] > covariance[largest][largest])
+				{
+					largest = channel;
+				}
+			}
+
+			for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+			{
+				axis[channel] = covariance[largest][channel];
+			}
+
+			for (uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				float length = 0.0f;
+
+				for (uint32_t row = 0; row < numberOfChannels; row++)
+				{
+					for (uint32_t column = 0; column < numberOfChannels; column++)
+					{
+						next[row] += covariance[row][column] * axis[column];
+					}
+					length = std::max(length, std::fabs(next[row]));
+				}
+
+				if (length < 1.0e-6f)
+				{
+					break;
+				}
+
+				for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+				{
+					axis[channel] = next[channel] / length;
+				}
+			}
+
+			float squaredLength = 0.0f;
+
+			for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+			{
+				squaredLength += axis[channel] * axis[channel];
+			}
+
+			float minimum = 0.0f;
+			float maximum = 0.0f;
+
+			if (squaredLength > 1.0e-12f)
+			{
+				minimum = std::numeric_limits<float>::max();
+				maximum = -std::numeric_limits<float>::max();
+
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					float projection = 0.0f;
+
+					for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+					{
+						projection += (texels[texel][channel] - mean[channel]) * axis[channel];
+					}
+
+					minimum = std::min(minimum, projection / squaredLength);
+					maximum = std::max(maximum, projection / squaredLength);
+				}
+			}
+
+			for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+			{
+				start[channel] = std::min(std::max(mean[channel] + axis[channel] * minimum, 0.0f), 255.0f);
+				end[channel] = std::min(std::max(mean[channel] + axis[channel] * maximum, 0.0f), 255.0f);
+			}
+		}
+
+		/**
+		 * @brief Endpoints minimizing the squared error of the texels at their weights along the segment (0 being start)
+		 *
+		 * @return false if the weights don't determine them (all the same)
+		 */
+		bool SolveEndpoints(const BlockTexels& texels, const float weights[16], uint32_t numberOfChannels, float start[4], float end[4])
+		{
+			float startStart = 0.0f;
+			float startEnd = 0.0f;
+			float endEnd = 0.0f;
+			float startTexel[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float endTexel[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				const float weight = weights[texel];
+
+				startStart += (1.0f - weight) * (1.0f - weight);
+				startEnd += (1.0f - weight) * weight;
+				endEnd += weight * weight;
+
+				for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+				{
+					startTexel[channel] += (1.0f - weight) * texels[texel][channel];
+					endTexel[channel] += weight * texels[texel][channel];
+				}
+			}
+
+			const float determinant = startStart * endEnd - startEnd * startEnd;
+
+			if (std::fabs(determinant) < 1.0e-6f)
+			{
+				return false;
+			}
+
+			for (uint32_t channel = 0; channel < numberOfChannels; channel++)
+			{
+				start[channel] = std::min(std::max((endEnd * startTexel[channel] - startEnd * endTexel[channel]) / determinant, 0.0f), 255.0f);
+				end[channel] = std::min(std::max((startStart * endTexel[channel] - startEnd * startTexel[channel]) / determinant, 0.0f), 255.0f);
+			}
+
+			return true;
+		}
+
+		uint16_t Pack565(const float color[3])
+		{
+			const uint32_t red = uint32_t(color[0] * 31.0f / 255.0f + 0.5f);
+			const uint32_t green = uint32_t(color[1] * 63.0f / 255.0f + 0.5f);
+			const uint32_t blue = uint32_t(color[2] * 31.0f / 255.0f + 0.5f);
+
+			return uint16_t((red << 11) | (green << 5) | blue);
+		}
+
+		void Unpack565(uint16_t packed, int color[3])
+		{
+			const int red = packed >> 11;
+			const int green = (packed >> 5) & 63;
+			const int blue = packed & 31;
+
+			color[0] = (red << 3) | (red >> 2);
+			color[1] = (green << 2) | (green >> 4);
+			color[2] = (blue << 3) | (blue >> 2);
+		}
+
+		void GetBC1Palette(uint16_t color0, uint16_t color1, int palette[4][3])
+		{
+			Unpack565(color0, palette[0]);
+			Unpack565(color1, palette[1]);
+
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				if (color0 > color1)
+				{
+					palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+					palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+				}
+				else
+				{
+					palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+					palette[3][channel] = 0;
+				}
+			}
+		}
+
+		/**
+		 * @brief Picks the nearest of the four colors for each texel
+		 *
+		 * @return The squared error
+		 */
+		uint32_t ChooseBC1Indices(const BlockTexels& texels, uint16_t color0, uint16_t color1, uint32_t& indices)
+		{
+			int palette[4][3];
+			GetBC1Palette(color0, color1, palette);
+
+			uint32_t totalError = 0;
+			indices = 0;
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				uint32_t bestError = UINT32_MAX;
+				uint32_t bestIndex = 0;
+
+				for (uint32_t index = 0; index < 4; index++)
+				{
+					const uint32_t error = Square(texels[texel][0] - palette[index][0]) + Square(texels[texel][1] - palette[index][1]) +
+						Square(texels[texel][2] - palette[index][2]);
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = index;
+					}
+				}
+
+				indices |= bestIndex << (texel * 2);
+				totalError += bestError;
+			}
+
+			return totalError;
+		}
+
+		void EncodeBC1Block(const BlockTexels& texels, uint8_t* destination)
+		{
+			// Weights of the indices along color0 -> color1
+			static const float indexWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+			float start[4];
+			float end[4];
+			FitPrincipalAxis(texels, 3, start, end);
+
+			uint16_t bestColor0 = 0;
+			uint16_t bestColor1 = 0;
+			uint32_t bestIndices = 0;
+			uint32_t bestError = UINT32_MAX;
+
+			for (uint32_t iteration = 0; iteration < 3; iteration++)
+			{
+				uint16_t color0 = Pack565(end);
+				uint16_t color1 = Pack565(start);
+
+				// The four color mode needs color0 above color1
+				if (color0 < color1)
+				{
+					std::swap(color0, color1);
+					std::swap(start, end);
+				}
+
+				uint32_t indices = 0;
+				const uint32_t error = color0 == color1 ? ChooseBC1Indices(texels, color0, color0, indices) :
+					ChooseBC1Indices(texels, color0, color1, indices);
+
+				if (error < bestError)
+				{
+					bestError = error;
+					bestColor0 = color0;
+					bestColor1 = color1;
+					bestIndices = indices;
+				}
+
+				if (error == 0 || color0 == color1)
+				{
+					break;
+				}
+
+				float weights[16];
+
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					// Weights from color1 (start) to color0 (end)
+					weights[texel] = 1.0f - indexWeights[(indices >> (texel * 2)) & 3];
+				}
+
+				if (!SolveEndpoints(texels, weights, 3, start, end))
+				{
+					break;
+				}
+			}
+
+			if (bestColor0 == bestColor1)
+			{
+				// Both the same, index 0 is the color in either mode
+				bestIndices = 0;
+			}
+
+			destination[0] = uint8_t(bestColor0);
+			destination[1] = uint8_t(bestColor0 >> 8);
+			destination[2] = uint8_t(bestColor1);
+			destination[3] = uint8_t(bestColor1 >> 8);
+			destination[4] = uint8_t(bestIndices);
+			destination[5] = uint8_t(bestIndices >> 8);
+			destination[6] = uint8_t(bestIndices >> 16);
+			destination[7] = uint8_t(bestIndices >> 24);
+		}
+
+		void DecodeBC1Block(const uint8_t* source, BlockTexels& texels)
+		{
+			const uint16_t color0 = uint16_t(source[0] | (source[1] << 8));
+			const uint16_t color1 = uint16_t(source[2] | (source[3] << 8));
+			const uint32_t indices = uint32_t(source[4]) | (uint32_t(source[5]) << 8) | (uint32_t(source[6]) << 16) | (uint32_t(source[7]) << 24);
+
+			int palette[4][3];
+			GetBC1Palette(color0, color1, palette);
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				const uint32_t index = (indices >> (texel * 2)) & 3;
+
+				texels[texel][0] = uint8_t(palette[index][0]);
+				texels[texel][1] = uint8_t(palette[index][1]);
+				texels[texel][2] = uint8_t(palette[index][2]);
+				texels[texel][3] = color0 <= color1 && index == 3 ? 0 : 255;
+			}
+		}
+
+		void GetBC4Palette(int value0, int value1, int palette[8])
+		{
+			palette[0] = value0;
+			palette[1] = value1;
+
+			if (value0 > value1)
+			{
+				for (int index = 2; index < 8; index++)
+				{
+					palette[index] = ((8 - index) * value0 + (index - 1) * value1) / 7;
+				}
+			}
+			else
+			{
+				for (int index = 2; index < 6; index++)
+				{
+					palette[index] = ((6 - index) * value0 + (index - 1) * value1) / 5;
+				}
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		/**
+		 * @brief A BC4 block of one channel of the texels (the alpha of BC3, the red and green of BC5)
+		 */
+		void EncodeBC4Block(const BlockTexels& texels, uint32_t channel, uint8_t* destination)
+		{
+			int minimum = 255;
+			int maximum = 0;
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				minimum = std::min(minimum, int(texels[texel][channel]));
+				maximum = std::max(maximum, int(texels[texel][channel]));
+			}
+
+			int palette[8];
+			GetBC4Palette(maximum, minimum, palette);
+
+			uint64_t indices = 0;
+
+			if (maximum > minimum)
+			{
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					uint32_t bestIndex = 0;
+					int bestError = INT_MAX;
+
+					for (uint32_t index = 0; index < 8; index++)
+					{
+						const int error = std::abs(texels[texel][channel] - palette[index]);
+
+						if (error < bestError)
+						{
+							bestError = error;
+							bestIndex = index;
+						}
+					}
+
+					indices |= uint64_t(bestIndex) << (texel * 3);
+				}
+			}
+
+			destination[0] = uint8_t(maximum);
+			destination[1] = uint8_t(minimum);
+
+			for (uint32_t counter = 0; counter < 6; counter++)
+			{
+				destination[2 + counter] = uint8_t(indices >> (counter * 8));
+			}
+		}
+
+		void DecodeBC4Block(const uint8_t* source, uint32_t channel, BlockTexels& texels)
+		{
+			int palette[8];
+			GetBC4Palette(source[0], source[1], palette);
+
+			uint64_t indices = 0;
+
+			for (uint32_t counter = 0; counter < 6; counter++)
+			{
+				indices |= uint64_t(source[2 + counter]) << (counter * 8);
+			}
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				texels[texel][channel] = uint8_t(palette[(indices >> (texel * 3)) & 7]);
+			}
+		}
+
+		void GetBC7Palette(const int endpoints[2][4], int palette[16][4])
+		{
+			for (uint32_t index = 0; index < 16; index++)
+			{
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					palette[index][channel] = ((64 - s_BC7Weights[index]) * endpoints[0][channel] + s_BC7Weights[index] * endpoints[1][channel] + 32) >> 6;
+				}
+			}
+		}
+
+		/**
+		 * @brief 7 bit endpoint and p bit (shared by the channels) nearest to a color, as the 8 bit value they decode to
+		 */
+		void QuantizeBC7Endpoint(const float color[4], int quantized[4], uint32_t& pBit)
+		{
+			float bestError = std::numeric_limits<float>::max();
+
+			for (uint32_t candidate = 0; candidate < 2; candidate++)
+			{
+				int values[4];
+				float error = 0.0f;
+
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					const int value = std::min(std::max(int((color[channel] - candidate) / 2.0f + 0.5f), 0), 127);
+					values[channel] = (value << 1) | int(candidate);
+					error += (values[channel] - color[channel]) * (values[channel] - color[channel]);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					pBit = candidate;
+					memcpy(quantized, values, sizeof(values));
+				}
+			}
+		}
+
+		uint32_t ChooseBC7Indices(const BlockTexels& texels, const int endpoints[2][4], uint8_t indices[16])
+		{
+			int palette[16][4];
+			GetBC7Palette(endpoints, palette);
+
+			uint32_t totalError = 0;
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				uint32_t bestError = UINT32_MAX;
+
+				for (uint32_t index = 0; index < 16; index++)
+				{
+					const uint32_t error = Square(texels[texel][0] - palette[index][0]) + Square(texels[texel][1] - palette[index][1]) +
+						Square(texels[texel][2] - palette[index][2]) + Square(texels[texel][3] - palette[index][3]);
+
+					if (error < bestError)
+					{
+						bestError = error;
+						indices[texel] = uint8_t(index);
+					}
+				}
+
+				totalError += bestError;
+			}
+
+			return totalError;
+		}
+
+		/**
+		 * @brief Mode 6: one subset, RGBA endpoints of 7 bits and a p bit each, 4 bit indices
+		 */
+		void EncodeBC7Block(const BlockTexels& texels, uint8_t* destination)
+		{
+			float start[4];
+			float end[4];
+			FitPrincipalAxis(texels, 4, start, end);
+
+			int bestEndpoints[2][4] = {};
+			uint32_t bestPBits[2] = { 0, 0 };
+			uint8_t bestIndices[16] = {};
+			uint32_t bestError = UINT32_MAX;
+
+			for (uint32_t iteration = 0; iteration < 3; iteration++)
+			{
+				int endpoints[2][4];
+				uint32_t pBits[2];
+				uint8_t indices[16];
+
+				QuantizeBC7Endpoint(start, endpoints[0], pBits[0]);
+				QuantizeBC7Endpoint(end, endpoints[1], pBits[1]);
+
+				const uint32_t error = ChooseBC7Indices(texels, endpoints, indices);
+
+				if (error < bestError)
+				{
+					bestError = error;
+					memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+					memcpy(bestPBits, pBits, sizeof(pBits));
+					memcpy(bestIndices, indices, sizeof(indices));
+				}
+
+				if (error == 0)
+				{
+					break;
+				}
+
+				float weights[16];
+
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					weights[texel] = s_BC7Weights[indices[texel]] / 64.0f;
+				}
+
+				if (!SolveEndpoints(texels, weights, 4, start, end))
+				{
+					break;
+				}
+			}
+
+			// The anchor (first) texel's index has its top bit implied 0
+			if (bestIndices[0] & 8)
+			{
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					std::swap(bestEndpoints[0][channel], bestEndpoints[1][channel]);
+				}
+				std::swap(bestPBits[0], bestPBits[1]);
+
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					bestIndices[texel] = uint8_t(15 - bestIndices[texel]);
+				}
+			}
+
+			memset(destination, 0, 16);
+
+			BitWriter writer = { destination, 0 };
+			writer.Write(1 << 6, 7);
+
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				writer.Write(uint32_t(bestEndpoints[0][channel] >> 1), 7);
+				writer.Write(uint32_t(bestEndpoints[1][channel] >> 1), 7);
+			}
+
+			writer.Write(bestPBits[0], 1);
+			writer.Write(bestPBits[1], 1);
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				writer.Write(bestIndices[texel], texel == 0 ? 3 : 4);
+			}
+		}
+
+		void DecodeBC7Block(const uint8_t* source, BlockTexels& texels)
+		{
+			BitReader reader = { source, 0 };
+
+			if (reader.Read(7) != (1 << 6))
+			{
+				// Not mode 6, which is all Compress writes
+				for (uint32_t texel = 0; texel < 16; texel++)
+				{
+					texels[texel][0] = 255;
+					texels[texel][1] = 0;
+					texels[texel][2] = 255;
+					texels[texel][3] = 255;
+				}
+				return;
+			}
+
+			int endpoints[2][4];
+
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				endpoints[0][channel] = int(reader.Read(7)) << 1;
+				endpoints[1][channel] = int(reader.Read(7)) << 1;
+			}
+
+			const uint32_t pBit0 = reader.Read(1);
+			const uint32_t pBit1 = reader.Read(1);
+
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				endpoints[0][channel] |= int(pBit0);
+				endpoints[1][channel] |= int(pBit1);
+			}
+
+			int palette[16][4];
+			GetBC7Palette(endpoints, palette);
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				const uint32_t index = reader.Read(texel == 0 ? 3 : 4);
+
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					texels[texel][channel] = uint8_t(palette[index][channel]);
+				}
+			}
+		}
+
+		/**
+		 * @brief Best modifier table and pixel indices of an ETC subblock around a base color
+		 *
+		 * @return The squared error
+		 */
+		uint32_t FitETCSubblock(const BlockTexels& texels, const uint32_t subblockTexels[8], const int base[3], uint32_t& table,
+			uint32_t pixelIndices[8])
+		{
+			uint32_t bestError = UINT32_MAX;
+
+			for (uint32_t candidate = 0; candidate < 8; candidate++)
+			{
+				const int modifiers[4] = { s_ETCModifiers[candidate][0], s_ETCModifiers[candidate][1], -s_ETCModifiers[candidate][0],
+					-s_ETCModifiers[candidate][1] };
+
+				uint32_t error = 0;
+				uint32_t indices[8];
+
+				for (uint32_t counter = 0; counter < 8 && error < bestError; counter++)
+				{
+					const uint8_t* texel = texels[subblockTexels[counter]];
+					uint32_t bestTexelError = UINT32_MAX;
+
+					for (uint32_t index = 0; index < 4; index++)
+					{
+						const uint32_t texelError = Square(texel[0] - Clamp255(base[0] + modifiers[index])) +
+							Square(texel[1] - Clamp255(base[1] + modifiers[index])) + Square(texel[2] - Clamp255(base[2] + modifiers[index]));
+
+						if (texelError < bestTexelError)
+						{
+							bestTexelError = texelError;
+							indices[counter] = index;
+						}
+					}
+
+					error += bestTexelError;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					table = candidate;
+					memcpy(pixelIndices, indices, sizeof(indices));
+				}
+			}
+
+			return bestError;
+		}
+
+		/**
+		 * @brief The texels (x * 4 + y order, as ETC numbers them) of the two subblocks of a flip
+		 */
+		void GetETCSubblocks(uint32_t flip, uint32_t subblocks[2][8])
+		{
+			uint32_t counts[2] = { 0, 0 };
+
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				for (uint32_t y = 0; y < 4; y++)
+				{
+					const uint32_t subblock = flip ? (y >= 2 ? 1 : 0) : (x >= 2 ? 1 : 0);
+					subblocks[subblock][counts[subblock]++] = x * 4 + y;
+				}
+			}
+		}
+
+		int Expand4(int value)
+		{
+			return (value << 4) | value;
+		}
+
+		int Expand5(int value)
+		{
+			return (value << 3) | (value >> 2);
+		}
+
+		/**
+		 * @brief An ETC1 (so ETC2 compatible) color block: the individual and the differential modes, both flips, the best of them
+		 */
+		void EncodeETCBlock(const BlockTexels& blockTexels, uint8_t* destination)
+		{
+			// Texels in ETC's x * 4 + y order
+			BlockTexels texels;
+
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				for (uint32_t y = 0; y < 4; y++)
+				{
+					memcpy(texels[x * 4 + y], blockTexels[y * 4 + x], 4);
+				}
+			}
+
+			uint64_t bestBlock = 0;
+			uint32_t bestError = UINT32_MAX;
+
+			for (uint32_t flip = 0; flip < 2; flip++)
+			{
+				uint32_t subblocks[2][8];
+				GetETCSubblocks(flip, subblocks);
+
+				float averages[2][3] = {};
+
+				for (uint32_t subblock = 0; subblock < 2; subblock++)
+				{
+					for (uint32_t counter = 0; counter < 8; counter++)
+					{
+						for (uint32_t channel = 0; channel < 3; channel++)
+						{
+							averages[subblock][channel] += texels[subblocks[subblock][counter]][channel] / 8.0f;
+						}
+					}
+				}
+
+				for (uint32_t differential = 0; differential < 2; differential++)
+				{
+					int quantized[2][3];
+					int bases[2][3];
+
+					for (uint32_t subblock = 0; subblock < 2; subblock++)
+					{
+						for (uint32_t channel = 0; channel < 3; channel++)
+						{
+							const float maximum = differential ? 31.0f : 15.0f;
+							quantized[subblock][channel] = int(averages[subblock][channel] * maximum / 255.0f + 0.5f);
+							bases[subblock][channel] = differential ? Expand5(quantized[subblock][channel]) : Expand4(quantized[subblock][channel]);
+						}
+					}
+
+					if (differential)
+					{
+						bool bInRange = true;
+
+						for (uint32_t channel = 0; channel < 3; channel++)
+						{
+							const int delta = quantized[1][channel] - quantized[0][channel];
+							bInRange = bInRange && delta >= -4 && delta <= 3;
+						}
+
+						if (!bInRange)
+						{
+							continue;
+						}
+					}
+
+					uint32_t tables[2];
+					uint32_t pixelIndices[2][8];
+					uint32_t error = 0;
+
+					for (uint32_t subblock = 0; subblock < 2; subblock++)
+					{
+						error += FitETCSubblock(texels, subblocks[subblock], bases[subblock], tables[subblock], pixelIndices[subblock]);
+					}
+
+					if (error >= bestError)
+					{
+						continue;
+					}
+
+					uint64_t block = 0;
+
+					for (uint32_t channel = 0; channel < 3; channel++)
+					{
+						const uint32_t shift = 56 - channel * 8;
+
+						if (differential)
+						{
+							block |= uint64_t(quantized[0][channel]) << (shift + 3);
+							block |= uint64_t((quantized[1][channel] - quantized[0][channel]) & 7) << shift;
+						}
+						else
+						{
+							block |= uint64_t(quantized[0][channel]) << (shift + 4);
+							block |= uint64_t(quantized[1][channel]) << shift;
+						}
+					}
+
+					block |= uint64_t(tables[0]) << 37;
+					block |= uint64_t(tables[1]) << 34;
+					block |= uint64_t(differential) << 33;
+					block |= uint64_t(flip) << 32;
+
+					for (uint32_t subblock = 0; subblock < 2; subblock++)
+					{
+						for (uint32_t counter = 0; counter < 8; counter++)
+						{
+							const uint32_t pixel = subblocks[subblock][counter];
+							const uint32_t index = pixelIndices[subblock][counter];
+
+							block |= uint64_t(index >> 1) << (16 + pixel);
+							block |= uint64_t(index & 1) << pixel;
+						}
+					}
+
+					bestError = error;
+					bestBlock = block;
+				}
+			}
+
+			StoreBigEndian(bestBlock, destination);
+		}
+
+		void DecodeETCBlock(const uint8_t* source, BlockTexels& texels)
+		{
+			const uint64_t block = LoadBigEndian(source);
+			const uint32_t differential = uint32_t(block >> 33) & 1;
+			const uint32_t flip = uint32_t(block >> 32) & 1;
+			const uint32_t tables[2] = { uint32_t(block >> 37) & 7, uint32_t(block >> 34) & 7 };
+
+			int bases[2][3];
+
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				const uint32_t shift = 56 - channel * 8;
+
+				if (differential)
+				{
+					const int base = int(block >> (shift + 3)) & 31;
+					const int delta = ((int(block >> shift) & 7) ^ 4) - 4;
+
+					bases[0][channel] = Expand5(base);
+					bases[1][channel] = Expand5(base + delta);
+				}
+				else
+				{
+					bases[0][channel] = Expand4(int(block >> (shift + 4)) & 15);
+					bases[1][channel] = Expand4(int(block >> shift) & 15);
+				}
+			}
+
+			uint32_t subblocks[2][8];
+			GetETCSubblocks(flip, subblocks);
+
+			for (uint32_t subblock = 0; subblock < 2; subblock++)
+			{
+				for (uint32_t counter = 0; counter < 8; counter++)
+				{
+					const uint32_t pixel = subblocks[subblock][counter];
+					const uint32_t index = ((uint32_t(block >> (16 + pixel)) & 1) << 1) | (uint32_t(block >> pixel) & 1);
+					const int modifier = (index & 2 ? -1 : 1) * s_ETCModifiers[tables[subblock]][index & 1];
+
+					// Back to row major
+					uint8_t* texel = texels[(pixel & 3) * 4 + (pixel >> 2)];
+
+					for (uint32_t channel = 0; channel < 3; channel++)
+					{
+						texel[channel] = uint8_t(Clamp255(bases[subblock][channel] + modifier));
+					}
+					texel[3] = 255;
+				}
+			}
+		}
+
+		void EncodeEACBlock(const BlockTexels& texels, uint8_t* destination)
+		{
+			int minimum = 255;
+			int maximum = 0;
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				minimum = std::min(minimum, int(texels[texel][3]));
+				maximum = std::max(maximum, int(texels[texel][3]));
+			}
+
+			// Table 13 has a 0 modifier (index 4), for the blocks of one alpha
+			uint32_t bestBase = uint32_t(minimum);
+			uint32_t bestMultiplier = 1;
+			uint32_t bestTable = 13;
+			uint64_t bestIndices = 0;
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				bestIndices |= uint64_t(4) << (45 - ((texel & 3) * 4 + (texel >> 2)) * 3);
+			}
+
+			if (maximum > minimum)
+			{
+				uint32_t bestError = UINT32_MAX;
+
+				for (uint32_t table = 0; table < 16; table++)
+				{
+					const int* modifiers = s_EACModifiers[table];
+					const int range = modifiers[7] - modifiers[3];
+					const int guess = std::min(std::max(int(float(maximum - minimum) / range + 0.5f), 1), 15);
+
+					for (int multiplier = std::max(guess - 1, 1); multiplier <= std::min(guess + 1, 15); multiplier++)
+					{
+						const int center = int((maximum + minimum) / 2.0f - (modifiers[7] + modifiers[3]) * multiplier / 2.0f + 0.5f);
+
+						for (int base = std::max(center - 1, 0); base <= std::min(center + 1, 255); base++)
+						{
+							uint32_t error = 0;
+							uint64_t indices = 0;
+
+							for (uint32_t texel = 0; texel < 16 && error < bestError; texel++)
+							{
+								uint32_t bestTexelError = UINT32_MAX;
+								uint32_t bestIndex = 0;
+
+								for (uint32_t index = 0; index < 8; index++)
+								{
+									const uint32_t texelError = Square(texels[texel][3] - Clamp255(base + modifiers[index] * multiplier));
+
+									if (texelError < bestTexelError)
+									{
+										bestTexelError = texelError;
+										bestIndex = index;
+									}
+								}
+
+								error += bestTexelError;
+								indices |= uint64_t(bestIndex) << (45 - ((texel & 3) * 4 + (texel >> 2)) * 3);
+							}
+
+							if (error < bestError)
+							{
+								bestError = error;
+								bestBase = uint32_t(base);
+								bestMultiplier = uint32_t(multiplier);
+								bestTable = table;
+								bestIndices = indices;
+							}
+						}
+					}
+				}
+			}
+
+			StoreBigEndian((uint64_t(bestBase) << 56) | (uint64_t(bestMultiplier) << 52) | (uint64_t(bestTable) << 48) | bestIndices, destination);
+		}
+
+		void DecodeEACBlock(const uint8_t* source, BlockTexels& texels)
+		{
+			const uint64_t block = LoadBigEndian(source);
+			const int base = int(block >> 56);
+			const int multiplier = int(block >> 52) & 15;
+			const int* modifiers = s_EACModifiers[(block >> 48) & 15];
+
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				const uint32_t index = uint32_t(block >> (45 - ((texel & 3) * 4 + (texel >> 2)) * 3)) & 7;
+				texels[texel][3] = uint8_t(Clamp255(base + modifiers[index] * multiplier));
+			}
+		}
+
+		void EncodeBlock(TextureFormat format, const BlockTexels& texels, uint8_t* destination)
+		{
+			switch (format)
+			{
+				case TextureFormat::BC1:
+					EncodeBC1Block(texels, destination);
+					break;
+				case TextureFormat::BC3:
+					EncodeBC4Block(texels, 3, destination);
+					EncodeBC1Block(texels, destination + 8);
+					break;
+				case TextureFormat::BC5:
+					EncodeBC4Block(texels, 0, destination);
+					EncodeBC4Block(texels, 1, destination + 8);
+					break;
+				case TextureFormat::BC7:
+					EncodeBC7Block(texels, destination);
+					break;
+				case TextureFormat::ETC2RGB:
+					EncodeETCBlock(texels, destination);
+					break;
+				case TextureFormat::ETC2RGBA:
+					EncodeEACBlock(texels, destination);
+					EncodeETCBlock(texels, destination + 8);
+					break;
+				case TextureFormat::RGBA8:
+					KR_CORE_ASSERT(false, "RGBA8 isn't block compressed");
+					break;
+			}
+		}
+
+		void DecodeBlock(TextureFormat format, const uint8_t* source, BlockTexels& texels)
+		{
+			switch (format)
+			{
+				case TextureFormat::BC1:
+					DecodeBC1Block(source, texels);
+					break;
+				case TextureFormat::BC3:
+					DecodeBC1Block(source + 8, texels);
+					DecodeBC4Block(source, 3, texels);
+					break;
+				case TextureFormat::BC5:
+					DecodeBC4Block(source, 0, texels);
+					DecodeBC4Block(source + 8, 1, texels);
+					for (uint32_t texel = 0; texel < 16; texel++)
+					{
+						texels[texel][2] = 0;
+						texels[texel][3] = 255;
+					}
+					break;
+				case TextureFormat::BC7:
+					DecodeBC7Block(source, texels);
+					break;
+				case TextureFormat::ETC2RGB:
+					DecodeETCBlock(source, texels);
+					break;
+				case TextureFormat::ETC2RGBA:
+					DecodeETCBlock(source + 8, texels);
+					DecodeEACBlock(source, texels);
+					break;
+				case TextureFormat::RGBA8:
+					KR_CORE_ASSERT(false, "RGBA8 isn't block compressed");
+					break;
+			}
+		}
+	}
+
+	void TextureCompressor::Compress(TextureFormat format, const TextureMip& source, TextureMip& destination, JobPool* pool)
+	{
+		KR_CORE_ASSERT(source.m_Format == TextureFormat::RGBA8, "Only RGBA8 mips are compressed");
+
+		destination.m_Width = source.m_Width;
+		destination.m_Height = source.m_Height;
+		destination.m_Format = format;
+
+		if (!IsCompressed(format))
+		{
+			destination.m_Pixels = source.m_Pixels;
+			return;
+		}
+
+		const uint32_t blockSize = GetBlockSize(format);
+		const uint32_t numberOfBlocksX = (source.m_Width + 3) / 4;
+		const uint32_t numberOfBlocksY = (source.m_Height + 3) / 4;
+
+		destination.m_Pixels.assign(size_t(numberOfBlocksX) * numberOfBlocksY * blockSize, 0);
+
+		auto compressRow = [&](uint32_t blockY)
+		{
+			BlockTexels texels;
+
+			for (uint32_t blockX = 0; blockX < numberOfBlocksX; blockX++)
+			{
+				FetchBlock(source, blockX, blockY, texels);
+				EncodeBlock(format, texels, &destination.m_Pixels[(size_t(blockY) * numberOfBlocksX + blockX) * blockSize]);
+			}
+		};
+
+		if (pool)
+		{
+			pool->ParallelFor(numberOfBlocksY, compressRow);
+		}
+		else
+		{
+			for (uint32_t blockY = 0; blockY < numberOfBlocksY; blockY++)
+			{
+				compressRow(blockY);
+			}
+		}
+	}
+
+	void TextureCompressor::Decompress(const TextureMip& source, TextureMip& destination)
+	{
+		destination.m_Width = source.m_Width;
+		destination.m_Height = source.m_Height;
+		destination.m_Format = TextureFormat::RGBA8;
+
+		if (!IsCompressed(source.m_Format))
+		{
+			destination.m_Pixels = source.m_Pixels;
+			return;
+		}
+
+		const uint32_t blockSize = GetBlockSize(source.m_Format);
+		const uint32_t numberOfBlocksX = (source.m_Width + 3) / 4;
+		const uint32_t numberOfBlocksY = (source.m_Height + 3) / 4;
+
+		destination.m_Pixels.assign(size_t(source.m_Width) * source.m_Height * 4, 0);
+
+		for (uint32_t blockY = 0; blockY < numberOfBlocksY; blockY++)
+		{
+			for (uint32_t blockX = 0; blockX < numberOfBlocksX; blockX++)
+			{
+				BlockTexels texels;
+				DecodeBlock(source.m_Format, &source.m_Pixels[(size_t(blockY) * numberOfBlocksX + blockX) * blockSize], texels);
+				StoreBlock(texels, blockX, blockY, destination);
+			}
+		}
+	}
+
+	uint64_t TextureCompressor::GetDataSize(TextureFormat format, uint32_t width, uint32_t height)
+	{
+		if (!IsCompressed(format))
+		{
+			return uint64_t(width) * height * 4;
+		}
+
+		return uint64_t((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+	}
+
+	uint32_t TextureCompressor::GetBlockSize(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::BC1:
+			case TextureFormat::ETC2RGB:
+				return 8;
+			case TextureFormat::BC3:
+			case TextureFormat::BC5:
+			case TextureFormat::BC7:
+			case TextureFormat::ETC2RGBA:
+				return 16;
+			case TextureFormat::RGBA8:
+				return 0;
+		}
+
+		return 0;
+	}
+
+	TextureFormat TextureCompressor::ChooseFormat(TextureCompression compression, bool bHasAlpha)
+	{
+		switch (compression)
+		{
+			case TextureCompression::None:
+				return TextureFormat::RGBA8;
+			case TextureCompression::BC:
+				return bHasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+			case TextureCompression::BC7:
+				return TextureFormat::BC7;
+			case TextureCompression::BC5:
+				return TextureFormat::BC5;
+			case TextureCompression::ETC2:
+				return bHasAlpha ? TextureFormat::ETC2RGBA : TextureFormat::ETC2RGB;
+		}
+
+		return TextureFormat::RGBA8;
+	}
+
+	bool TextureCompressor::HasAlpha(const TextureMip& mip)
+	{
+		for (size_t offset = 3; offset < mip.m_Pixels.size(); offset += 4)
+		{
+			if (mip.m_Pixels[offset] != 255)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	double TextureCompressor::ComputePSNR(const TextureMip& original, const TextureMip& decoded)
+	{
+		KR_CORE_ASSERT(original.m_Pixels.size() == decoded.m_Pixels.size(), "ComputePSNR: mips of different sizes");
+
+		double squaredError = 0.0;
+
+		for (size_t offset = 0; offset < original.m_Pixels.size(); offset++)
+		{
+			if ((offset & 3) != 3)
+			{
+				const double difference = double(original.m_Pixels[offset]) - double(decoded.m_Pixels[offset]);
+				squaredError += difference * difference;
+			}
+		}
+
+		const double meanSquaredError = squaredError / std::max<double>(double(original.m_Pixels.size()) * 0.75, 1.0);
+
+		return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+	}
+
+	const char* TextureCompressor::GetFormatName(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::RGBA8:
+				return "RGBA8";
+			case TextureFormat::BC1:
+				return "BC1";
+			case TextureFormat::BC3:
+				return "BC3";
+			case TextureFormat::BC5:
+				return "BC5";
+			case TextureFormat::BC7:
+				return "BC7";
+			case TextureFormat::ETC2RGB:
+				return "ETC2 RGB";
+			case TextureFormat::ETC2RGBA:
+				return "ETC2 RGBA";
+		}
+
+		return "Unknown";
+	}
+
+	const char* TextureCompressor::GetCompressionName(TextureCompression compression)
+	{
+		switch (compression)
+		{
+			case TextureCompression::None:
+				return "none";
+			case TextureCompression::BC:
+				return "bc";
+			case TextureCompression::BC7:
+				return "bc7";
+			case TextureCompression::BC5:
+				return "bc5";
+			case TextureCompression::ETC2:
+				return "etc2";
+		}
+
+		return "unknown";
+	}
+
+	bool TextureCompressor::ParseCompression(const std::string& name, TextureCompression& compression)
+	{
+		const TextureCompression compressions[] = { TextureCompression::None, TextureCompression::BC, TextureCompression::BC7,
+			TextureCompression::BC5, TextureCompression::ETC2 };
+
+		for (TextureCompression candidate : compressions)
+		{
+			if (name == GetCompressionName(candidate))
+			{
+				compression = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
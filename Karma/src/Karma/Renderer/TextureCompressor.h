@@ -0,0 +1,143 @@
+/**
+ * @file TextureCompressor.h
+ * @brief This file contains the TextureCompressor class, which encodes mips into the GPU's block compressed formats (BCn and ETC2).
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declarations
+	 */
+	struct TextureMip;
+	class JobPool;
+
+	/**
+	 * @brief Formats of the texels of a mip as they go to the GPU. The block compressed ones are 4x4 texel blocks, row after row of
+	 * blocks, the blocks past the edges of a mip (not a multiple of 4) repeating its last texels.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class TextureFormat : uint32_t
+	{
+		/** Uncompressed, 4 bytes a texel, sRGB */
+		RGBA8 = 0,
+		/** Opaque color, 8 bytes a block, sRGB */
+		BC1,
+		/** Color and alpha (BC1 color with a BC4 alpha), 16 bytes a block, sRGB */
+		BC3,
+		/** Two linear channels (red and green, two BC4), 16 bytes a block, for normal maps and the like */
+		BC5,
+		/** Color and alpha of high quality, 16 bytes a block, sRGB. Only mode 6 (one subset, 7 bit endpoints) is written. */
+		BC7,
+		/** Opaque color (the ETC1 compatible modes), 8 bytes a block, sRGB */
+		ETC2RGB,
+		/** Color and alpha (EAC alpha and ETC2 color), 16 bytes a block, sRGB */
+		ETC2RGBA
+	};
+
+	/**
+	 * @brief Which formats the cooked textures are encoded to, the format of each texture following its alpha
+	 *
+	 * @see CookedTexture
+	 * @since Karma 1.0.0
+	 */
+	enum class TextureCompression : uint32_t
+	{
+		/** RGBA8, the mips being the only thing cooked */
+		None = 0,
+		/** BC1, or BC3 for the textures with alpha */
+		BC,
+		/** BC7 */
+		BC7,
+		/** BC5, for textures of two channels (the blue and alpha are dropped) */
+		BC5,
+		/** ETC2RGB, or ETC2RGBA for the textures with alpha */
+		ETC2
+	};
+
+	/**
+	 * @brief Block compression of mips, on the CPU. The encoders fit the endpoints along the principal axis of each block's colors
+	 * and refine them by least squares (BC1, BC7), or search the tables (ETC2, EAC), which is fast enough for cooking at load time with
+	 * a JobPool but not of the quality of the offline compressors.
+	 *
+	 * @see CookedTexture
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API TextureCompressor
+	{
+	public:
+		/**
+		 * @brief Encodes an RGBA8 mip
+		 *
+		 * @param format						The format wanted
+		 * @param source						RGBA8 texels
+		 * @param destination					Output, of source's size
+		 * @param pool							Pool to encode the rows of blocks on, nullptr encodes them on the calling thread
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Compress(TextureFormat format, const TextureMip& source, TextureMip& destination, JobPool* pool = nullptr);
+
+		/**
+		 * @brief Decodes a mip of the blocks Compress writes (BC7 mode 6 only, and no T, H or planar ETC2 blocks) back to RGBA8, for
+		 * measuring the error of the encoders
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Decompress(const TextureMip& source, TextureMip& destination);
+
+		/**
+		 * @brief Bytes of a mip of the format
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint64_t GetDataSize(TextureFormat format, uint32_t width, uint32_t height);
+
+		/**
+		 * @brief Bytes of a 4x4 block, 0 for RGBA8
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetBlockSize(TextureFormat format);
+
+		static bool IsCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+
+		/**
+		 * @brief The format of the compression for a texture with or without alpha
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static TextureFormat ChooseFormat(TextureCompression compression, bool bHasAlpha);
+
+		/**
+		 * @brief Whether a texel of the mip isn't opaque
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool HasAlpha(const TextureMip& mip);
+
+		/**
+		 * @brief Peak signal to noise ratio (in dB) of the color channels of a mip against the original, for the logs
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static double ComputePSNR(const TextureMip& original, const TextureMip& decoded);
+
+		static const char* GetFormatName(TextureFormat format);
+		static const char* GetCompressionName(TextureCompression compression);
+
+		/**
+		 * @brief The compression of a name (none, bc, bc7, bc5, etc2)
+		 *
+		 * @return false if the name is none of them
+		 * @since Karma 1.0.0
+		 */
+		static bool ParseCompression(const std::string& name, TextureCompression& compression);
+	};
+}
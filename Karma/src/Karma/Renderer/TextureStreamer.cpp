@@ -0,0 +1,849 @@
+#include "TextureStreamer.h"
+#include "StreamedTexture.h"
+#include "Renderer.h"
+#include "Karma/JobPool.h"
+#include "Karma/KarmaUtilities.h"
+#include "Karma/CommandLine.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace Karma
+{
+	namespace
+	{
+		struct SRGBTables
+		{
+			float m_ToLinear[256];
+			uint8_t m_FromLinear[4096];
+
+			SRGBTables()
+			{
+				for (uint32_t counter = 0; counter < 256; counter++)
+				{
+					float value = counter / 255.0f;
+					m_ToLinear[counter] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+				}
+
+				for (uint32_t counter = 0; counter < 4096; counter++)
+				{
+					float value = counter / 4095.0f;
+					value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+					m_FromLinear[counter] = uint8_t(std::min(value * 255.0f + 0.5f, 255.0f));
+				}
+			}
+		};
+
+		const SRGBTables& GetSRGBTables()
+		{
+			static SRGBTables tables;
+
+			return tables;
+		}
+
+		uint32_t Hash(uint32_t value)
+		{
+			value ^= value >> 16;
+			value *= 0x7feb352du;
+			value ^= value >> 15;
+			value *= 0x846ca68bu;
+			value ^= value >> 16;
+
+			return value;
+		}
+	}
+
+	void TextureSource::GenerateMipChain(std::vector<TextureMip>& mips)
+	{
+		KR_CORE_ASSERT(!mips.empty() && mips.back().m_Width > 0 && mips.back().m_Height > 0, "GenerateMipChain: no mip to start from");
+
+		const SRGBTables& tables = GetSRGBTables();
+
+		while (mips.back().m_Width > 1 || mips.back().m_Height > 1)
+		{
+			TextureMip mip;
+			{
+				const TextureMip& source = mips.back();
+
+				mip.m_Width = std::max(source.m_Width / 2, 1u);
+				mip.m_Height = std::max(source.m_Height / 2, 1u);
+				mip.m_Pixels.resize(size_t(mip.m_Width) * mip.m_Height * 4);
+
+				for (uint32_t y = 0; y < mip.m_Height; y++)
+				{
+					// The last row of an odd height goes with the last texel's rows
+					const uint32_t firstRow = std::min(y * 2, source.m_Height - 1);
+					const uint32_t endRow = y + 1 == mip.m_Height ? source.m_Height : std::min(y * 2 + 2, source.m_Height);
+
+					for (uint32_t x = 0; x < mip.m_Width; x++)
+					{
+						const uint32_t firstColumn = std::min(x * 2, source.m_Width - 1);
+						const uint32_t endColumn = x + 1 == mip.m_Width ? source.m_Width : std::min(x * 2 + 2, source.m_Width);
+
+						float color[3] = { 0.0f, 0.0f, 0.0f };
+						uint32_t alpha = 0;
+
+						for (uint32_t row = firstRow; row < endRow; row++)
+						{
+							const uint8_t* texel = &source.m_Pixels[(size_t(row) * source.m_Width + firstColumn) * 4];
+
+							for (uint32_t column = firstColumn; column < endColumn; column++, texel += 4)
+							{
+								color[0] += tables.m_ToLinear[texel[0]];
+								color[1] += tables.m_ToLinear[texel[1]];
+								color[2] += tables.m_ToLinear[texel[2]];
+								alpha += texel[3];
+							}
+						}
+
+						const uint32_t numberOfTexels = (endRow - firstRow) * (endColumn - firstColumn);
+						const float scale = 4095.0f / numberOfTexels;
+						uint8_t* destination = &mip.m_Pixels[(size_t(y) * mip.m_Width + x) * 4];
+
+						for (uint32_t channel = 0; channel < 3; channel++)
+						{
+							destination[channel] = tables.m_FromLinear[std::min(uint32_t(color[channel] * scale + 0.5f), 4095u)];
+						}
+						destination[3] = uint8_t((alpha + numberOfTexels / 2) / numberOfTexels);
+					}
+				}
+			}
+
+			mips.push_back(std::move(mip));
+		}
+	}
+
+	FileTextureSource::FileTextureSource(const std::string& fileName) : m_FileName(fileName)
+	{
+	}
+
+	bool FileTextureSource::GetInfo(uint32_t& width, uint32_t& height)
+	{
+		int imageWidth = 0;
+		int imageHeight = 0;
+		int channels = 0;
+
+		if (!KarmaUtilities::GetImageInfo(m_FileName.c_str(), &imageWidth, &imageHeight, &channels) || imageWidth <= 0 || imageHeight <= 0)
+		{
+			return false;
+		}
+
+		width = uint32_t(imageWidth);
+		height = uint32_t(imageHeight);
+
+		return true;
+	}
+
+	bool FileTextureSource::Decode(uint32_t firstMip, std::vector<TextureMip>& mips)
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+
+		unsigned char* pixels = KarmaUtilities::GetImagePixelData(m_FileName.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+		if (pixels == nullptr)
+		{
+			return false;
+		}
+
+		mips.resize(1);
+		mips[0].m_Width = uint32_t(width);
+		mips[0].m_Height = uint32_t(height);
+		mips[0].m_Pixels.assign(pixels, pixels + size_t(width) * height * 4);
+
+		stbi_image_free(pixels);
+
+		// No mips in the file, the whole chain is made to get to the ones asked for
+		GenerateMipChain(mips);
+		mips.erase(mips.begin(), mips.begin() + std::min<size_t>(firstMip, mips.size() - 1));
+
+		return true;
+	}
+
+	SyntheticTextureSource::SyntheticTextureSource(uint32_t width, uint32_t height, uint32_t seed) : m_Width(width), m_Height(height),
+		m_Seed(seed)
+	{
+		m_Name = "Synthetic" + std::to_string(seed) + "_" + std::to_string(width) + "x" + std::to_string(height);
+	}
+
+	bool SyntheticTextureSource::GetInfo(uint32_t& width, uint32_t& height)
+	{
+		width = m_Width;
+		height = m_Height;
+
+		return true;
+	}
+
+	bool SyntheticTextureSource::Decode(uint32_t firstMip, std::vector<TextureMip>& mips)
+	{
+		// The first mip is made at its size, as a file's would be decoded, and the rest filtered from it
+		mips.resize(1);
+
+		TextureMip& mip = mips[0];
+		mip.m_Width = StreamedTexture::GetMipExtent(m_Width, firstMip);
+		mip.m_Height = StreamedTexture::GetMipExtent(m_Height, firstMip);
+		mip.m_Pixels.resize(size_t(mip.m_Width) * mip.m_Height * 4);
+
+		const uint32_t cellShift = 5 > firstMip ? 5 - firstMip : 0;
+
+		for (uint32_t y = 0; y < mip.m_Height; y++)
+		{
+			for (uint32_t x = 0; x < mip.m_Width; x++)
+			{
+				const uint32_t cell = Hash(m_Seed ^ Hash(((y >> cellShift) << 16) ^ (x >> cellShift)));
+				const uint32_t noise = Hash(cell ^ (y * mip.m_Width + x)) & 31;
+
+				uint8_t* texel = &mip.m_Pixels[(size_t(y) * mip.m_Width + x) * 4];
+				texel[0] = uint8_t((cell & 0xdf) + noise);
+				texel[1] = uint8_t(((cell >> 8) & 0xdf) + noise);
+				texel[2] = uint8_t(((cell >> 16) & 0xdf) + noise);
+				texel[3] = 255;
+			}
+		}
+
+		GenerateMipChain(mips);
+
+		return true;
+	}
+
+	TextureStreamer::TextureStreamer() : m_Placeholder(nullptr), m_FrameNumber(0), m_NumberOfRunningDecodes(0), m_bQuit(false)
+	{
+		m_Pool = &JobPool::GetLoadingPool();
+		m_DecodeThread = std::thread(&TextureStreamer::DecodeLoop, this);
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bQuit = true;
+		}
+		m_DecodeCondition.notify_all();
+
+		m_DecodeThread.join();
+
+		// The GPU textures are ReleaseResources' business, the context may be gone by now
+	}
+
+	// In megabytes
+	static CommandLineOption s_TextureBudgetOption("texture-budget", "--texture-budget=MB sets the memory the streamed mips may take",
+		[](const std::string& value) { TextureStreamer::Get().GetSettings().m_BudgetBytes = CommandLine::ParseNumber(value, 256) << 20; });
+
+	TextureStreamer& TextureStreamer::Get()
+	{
+		static TextureStreamer textureStreamer;
+
+		return textureStreamer;
+	}
+
+	bool TextureStreamer::IsSupported()
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::OpenGL:
+			case RendererAPI::API::Null:
+				return true;
+			case RendererAPI::API::Vulkan:
+				return VulkanHolder::GetVulkanContext()->SupportsBindless();
+			default:
+				return false;
+		}
+	}
+
+	TextureStreamHandle TextureStreamer::Register(std::shared_ptr<TextureSource> source)
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		if (!source->GetInfo(width, height))
+		{
+			KR_CORE_WARN("Couldn't read the texture {0} for streaming", source->GetName());
+			return TextureStreamHandle();
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint32_t index;
+
+		if (m_FreeEntries.size())
+		{
+			index = m_FreeEntries.back();
+			m_FreeEntries.pop_back();
+		}
+		else
+		{
+			index = uint32_t(m_Entries.size());
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[index];
+		const uint32_t generation = entry.m_Generation;
+
+		entry = Entry();
+		entry.m_Source = source;
+		entry.m_Width = width;
+		entry.m_Height = height;
+		entry.m_NumberOfMips = StreamedTexture::ComputeNumberOfMips(width, height);
+		entry.m_Format = source->GetFormat();
+		entry.m_Generation = generation;
+		entry.m_bAlive = true;
+		entry.m_WantedMip = entry.m_NumberOfMips;
+		entry.m_ResidentMip = entry.m_NumberOfMips;
+
+		m_Statistics.m_NumberOfTextures++;
+
+		TextureStreamHandle handle;
+		handle.m_Index = index;
+		handle.m_Generation = generation;
+
+		return handle;
+	}
+
+	void TextureStreamer::Unregister(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		if (entry == nullptr)
+		{
+			return;
+		}
+
+		if (entry->m_Texture)
+		{
+			m_PendingDeletes.push_back(entry->m_Texture);
+		}
+
+		m_Statistics.m_ResidentBytes -= ComputeBytes(*entry, entry->m_ResidentMip);
+		m_Statistics.m_NumberOfTextures--;
+
+		// A decode in flight is dropped by the generation
+		const uint32_t generation = entry->m_Generation + 1;
+
+		*entry = Entry();
+		entry->m_Generation = generation;
+
+		m_FreeEntries.push_back(handle.m_Index);
+	}
+
+	void TextureStreamer::ReportUsage(TextureStreamHandle handle, float screenFraction)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (Entry* entry = Find(handle))
+		{
+			entry->m_ReportedPixels = std::max(entry->m_ReportedPixels, screenFraction * m_Settings.m_ScreenHeight);
+			entry->m_LastUsedFrame = m_FrameNumber;
+		}
+	}
+
+	void TextureStreamer::Bind(TextureStreamHandle handle, uint32_t unit)
+	{
+		// The draws sample the texture's slot through the material table (GetTexture)
+		if (Renderer::GetAPI() == RendererAPI::API::Vulkan)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		if (entry && entry->m_Texture && entry->m_ResidentMip < entry->m_NumberOfMips)
+		{
+			entry->m_Texture->Bind(unit);
+			return;
+		}
+
+		if (m_Placeholder == nullptr)
+		{
+			const uint8_t grey[4] = { 128, 128, 128, 255 };
+
+			m_Placeholder = StreamedTexture::Create(1, 1);
+
+			if (m_Placeholder == nullptr)
+			{
+				return;
+			}
+
+			m_Placeholder->UploadMip(0, grey);
+		}
+
+		m_Placeholder->Bind(unit);
+		m_Statistics.m_NumberOfPlaceholderBinds++;
+	}
+
+	StreamedTexture* TextureStreamer::GetTexture(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		if (entry == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (entry->m_Texture == nullptr)
+		{
+			entry->m_Texture = StreamedTexture::Create(entry->m_Width, entry->m_Height, entry->m_Format);
+		}
+
+		return entry->m_Texture;
+	}
+
+	void TextureStreamer::Update()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_FrameNumber++;
+
+		for (StreamedTexture* texture : m_PendingDeletes)
+		{
+			delete texture;
+		}
+		m_PendingDeletes.clear();
+
+		m_Statistics.m_NumberOfUploads = 0;
+		m_Statistics.m_UploadedBytes = 0;
+		m_Statistics.m_NumberOfEvictions = 0;
+		m_Statistics.m_NumberOfBudgetReductions = 0;
+		m_Statistics.m_NumberOfPlaceholderBinds = 0;
+		m_Statistics.m_WantedBytes = 0;
+
+		// What the last frame's usage asks for
+		for (Entry& entry : m_Entries)
+		{
+			if (!entry.m_bAlive)
+			{
+				continue;
+			}
+
+			if (entry.m_ReportedPixels > 0.0f)
+			{
+				entry.m_ScreenPixels = entry.m_ReportedPixels;
+			}
+			else if (m_FrameNumber - entry.m_LastUsedFrame > m_Settings.m_UnusedFrames)
+			{
+				entry.m_ScreenPixels = 0.0f;
+			}
+			entry.m_ReportedPixels = 0.0f;
+
+			entry.m_WantedMip = ComputeWantedMip(entry);
+			m_Statistics.m_WantedBytes += ComputeBytes(entry, entry.m_WantedMip);
+		}
+
+		FitBudget();
+
+		bool bQueued = false;
+
+		for (uint32_t index = 0; index < uint32_t(m_Entries.size()); index++)
+		{
+			Entry& entry = m_Entries[index];
+
+			if (!entry.m_bAlive)
+			{
+				continue;
+			}
+
+			if (entry.m_ResidentMip < entry.m_WantedMip)
+			{
+				entry.m_Texture->Evict(entry.m_WantedMip);
+
+				m_Statistics.m_ResidentBytes -= ComputeBytes(entry, entry.m_ResidentMip) - ComputeBytes(entry, entry.m_WantedMip);
+				m_Statistics.m_NumberOfEvictions++;
+
+				entry.m_ResidentMip = entry.m_WantedMip;
+			}
+
+			// Decoded mips which aren't wanted anymore aren't uploaded
+			if (entry.m_Decoded.size() && entry.m_DecodedFirstMip < entry.m_WantedMip)
+			{
+				const uint32_t numberOfDropped = std::min(entry.m_WantedMip - entry.m_DecodedFirstMip, uint32_t(entry.m_Decoded.size()));
+
+				entry.m_Decoded.erase(entry.m_Decoded.begin(), entry.m_Decoded.begin() + numberOfDropped);
+				entry.m_DecodedFirstMip += numberOfDropped;
+			}
+
+			if (entry.m_WantedMip < entry.m_ResidentMip && !entry.m_bDecoding && entry.m_Decoded.empty())
+			{
+				DecodeRequest request;
+				request.m_Index = index;
+				request.m_Generation = entry.m_Generation;
+				request.m_FirstMip = entry.m_WantedMip;
+				request.m_Source = entry.m_Source;
+
+				m_DecodeQueue.push_back(request);
+				entry.m_bDecoding = true;
+				bQueued = true;
+			}
+		}
+
+		if (bQueued)
+		{
+			m_DecodeCondition.notify_one();
+		}
+
+		UploadDecoded();
+
+		StreamedTexture::Flush();
+
+		m_Statistics.m_PeakResidentBytes = std::max(m_Statistics.m_PeakResidentBytes, m_Statistics.m_ResidentBytes);
+	}
+
+	uint32_t TextureStreamer::GetTailMip(const Entry& entry) const
+	{
+		const uint32_t extent = std::max(entry.m_Width, entry.m_Height);
+		uint32_t mip = 0;
+
+		while (mip + 1 < entry.m_NumberOfMips && StreamedTexture::GetMipExtent(extent, mip) > m_Settings.m_ResidentTailExtent)
+		{
+			mip++;
+		}
+
+		return mip;
+	}
+
+	uint32_t TextureStreamer::ComputeWantedMip(const Entry& entry) const
+	{
+		if (entry.m_bFailed)
+		{
+			return entry.m_NumberOfMips;
+		}
+
+		const uint32_t tailMip = GetTailMip(entry);
+
+		if (entry.m_ScreenPixels <= 0.0f)
+		{
+			return tailMip;
+		}
+
+		// The smallest mip with at least a texel per pixel covered
+		const uint32_t extent = std::max(entry.m_Width, entry.m_Height);
+		uint32_t mip = 0;
+
+		while (mip < tailMip && float(StreamedTexture::GetMipExtent(extent, mip + 1)) >= entry.m_ScreenPixels)
+		{
+			mip++;
+		}
+
+		return mip;
+	}
+
+	uint64_t TextureStreamer::ComputeBytes(const Entry& entry, uint32_t firstMip) const
+	{
+		uint64_t bytes = 0;
+
+		for (uint32_t mip = firstMip; mip < entry.m_NumberOfMips; mip++)
+		{
+			bytes += StreamedTexture::GetMipSize(entry.m_Format, entry.m_Width, entry.m_Height, mip);
+		}
+
+		return bytes;
+	}
+
+	void TextureStreamer::FitBudget()
+	{
+		uint64_t totalBytes = m_Statistics.m_WantedBytes;
+
+		if (totalBytes <= m_Settings.m_BudgetBytes)
+		{
+			return;
+		}
+
+		// Texels per pixel covered of the wanted mip, the largest giving the least when cut
+		typedef std::pair<float, uint32_t> Candidate;
+		std::priority_queue<Candidate> candidates;
+
+		for (uint32_t index = 0; index < uint32_t(m_Entries.size()); index++)
+		{
+			const Entry& entry = m_Entries[index];
+
+			if (entry.m_bAlive && entry.m_WantedMip < GetTailMip(entry))
+			{
+				const float extent = float(StreamedTexture::GetMipExtent(std::max(entry.m_Width, entry.m_Height), entry.m_WantedMip));
+				candidates.push(Candidate(extent / std::max(entry.m_ScreenPixels, 1.0f), index));
+			}
+		}
+
+		std::vector<bool> reduced(m_Entries.size(), false);
+
+		while (totalBytes > m_Settings.m_BudgetBytes && candidates.size())
+		{
+			Candidate candidate = candidates.top();
+			candidates.pop();
+
+			Entry& entry = m_Entries[candidate.second];
+
+			totalBytes -= StreamedTexture::GetMipSize(entry.m_Format, entry.m_Width, entry.m_Height, entry.m_WantedMip);
+			entry.m_WantedMip++;
+
+			if (!reduced[candidate.second])
+			{
+				reduced[candidate.second] = true;
+				m_Statistics.m_NumberOfBudgetReductions++;
+			}
+
+			if (entry.m_WantedMip < GetTailMip(entry))
+			{
+				candidates.push(Candidate(candidate.first * 0.5f, candidate.second));
+			}
+		}
+	}
+
+	void TextureStreamer::UploadDecoded()
+	{
+		// Bytes of the next mip to upload, the smallest going first over all textures
+		typedef std::pair<uint64_t, uint32_t> Candidate;
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+		auto pushNext = [this, &candidates](uint32_t index)
+		{
+			Entry& entry = m_Entries[index];
+
+			const uint32_t nextMip = entry.m_ResidentMip - 1;
+
+			if (entry.m_ResidentMip == 0 || entry.m_ResidentMip <= entry.m_DecodedFirstMip || nextMip < entry.m_WantedMip ||
+				nextMip - entry.m_DecodedFirstMip >= entry.m_Decoded.size())
+			{
+				// Nothing to upload of what was decoded
+				entry.m_Decoded.clear();
+				return;
+			}
+
+			candidates.push(Candidate(StreamedTexture::GetMipSize(entry.m_Format, entry.m_Width, entry.m_Height, nextMip), index));
+		};
+
+		for (uint32_t index = 0; index < uint32_t(m_Entries.size()); index++)
+		{
+			if (m_Entries[index].m_bAlive && m_Entries[index].m_Decoded.size())
+			{
+				pushNext(index);
+			}
+		}
+
+		while (candidates.size())
+		{
+			Candidate candidate = candidates.top();
+			candidates.pop();
+
+			// One mip is uploaded whatever its size, so that none waits forever
+			if (m_Statistics.m_UploadedBytes > 0 && m_Statistics.m_UploadedBytes + candidate.first > m_Settings.m_UploadBytesPerFrame)
+			{
+				break;
+			}
+
+			Entry& entry = m_Entries[candidate.second];
+
+			if (entry.m_Texture == nullptr)
+			{
+				entry.m_Texture = StreamedTexture::Create(entry.m_Width, entry.m_Height, entry.m_Format);
+
+				if (entry.m_Texture == nullptr)
+				{
+					entry.m_Decoded.clear();
+					continue;
+				}
+			}
+			else if (entry.m_Texture->GetFormat() != entry.m_Format)
+			{
+				// Made by GetTexture before the first decode told the format
+				entry.m_Texture->SetFormat(entry.m_Format);
+			}
+
+			const uint32_t mip = entry.m_ResidentMip - 1;
+			TextureMip& decoded = entry.m_Decoded[mip - entry.m_DecodedFirstMip];
+
+			entry.m_Texture->UploadMip(mip, decoded.m_Pixels.data());
+			entry.m_ResidentMip = mip;
+
+			std::vector<uint8_t>().swap(decoded.m_Pixels);
+
+			m_Statistics.m_ResidentBytes += candidate.first;
+			m_Statistics.m_UploadedBytes += candidate.first;
+			m_Statistics.m_NumberOfUploads++;
+
+			pushNext(candidate.second);
+		}
+	}
+
+	void TextureStreamer::DecodeLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		while (true)
+		{
+			m_DecodeCondition.wait(lock, [this] { return m_bQuit || m_DecodeQueue.size(); });
+
+			if (m_bQuit)
+			{
+				return;
+			}
+
+			std::vector<DecodeRequest> batch;
+
+			while (m_DecodeQueue.size() && batch.size() < std::max(m_Settings.m_DecodeBatchSize, 1u))
+			{
+				batch.push_back(m_DecodeQueue.front());
+				m_DecodeQueue.pop_front();
+			}
+
+			m_NumberOfRunningDecodes += uint32_t(batch.size());
+
+			lock.unlock();
+
+			std::vector<std::vector<TextureMip>> results(batch.size());
+			std::vector<uint8_t> succeeded(batch.size(), 0);
+
+			m_Pool->ParallelFor(uint32_t(batch.size()), [&batch, &results, &succeeded](uint32_t job)
+			{
+				succeeded[job] = batch[job].m_Source->Decode(batch[job].m_FirstMip, results[job]) ? 1 : 0;
+			});
+
+			lock.lock();
+
+			for (uint32_t counter = 0; counter < uint32_t(batch.size()); counter++)
+			{
+				const DecodeRequest& request = batch[counter];
+				Entry& entry = m_Entries[request.m_Index];
+
+				m_Statistics.m_NumberOfDecodes++;
+
+				if (!entry.m_bAlive || entry.m_Generation != request.m_Generation)
+				{
+					continue;
+				}
+
+				entry.m_bDecoding = false;
+
+				if (!succeeded[counter])
+				{
+					KR_CORE_WARN("Couldn't decode the texture {0}, it stays a placeholder", request.m_Source->GetName());
+					entry.m_bFailed = true;
+					continue;
+				}
+
+				if (results[counter].size() && results[counter].front().m_Format != entry.m_Format)
+				{
+					if (entry.m_ResidentMip < entry.m_NumberOfMips)
+					{
+						KR_CORE_WARN("The texture {0} changed format while streamed, it keeps the mips it has", request.m_Source->GetName());
+						entry.m_bFailed = true;
+						continue;
+					}
+
+					// Nothing uploaded (nor counted resident) yet, the texture takes the decoded format at the upload
+					entry.m_Format = results[counter].front().m_Format;
+				}
+
+				entry.m_Decoded = std::move(results[counter]);
+				entry.m_DecodedFirstMip = request.m_FirstMip;
+			}
+
+			m_NumberOfRunningDecodes -= uint32_t(batch.size());
+			m_DecodedCondition.notify_all();
+		}
+	}
+
+	void TextureStreamer::WaitForDecodes()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		m_DecodedCondition.wait(lock, [this] { return m_DecodeQueue.empty() && m_NumberOfRunningDecodes == 0; });
+	}
+
+	void TextureStreamer::ReleaseResources()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (StreamedTexture* texture : m_PendingDeletes)
+		{
+			delete texture;
+		}
+		m_PendingDeletes.clear();
+
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.m_Texture)
+			{
+				delete entry.m_Texture;
+				entry.m_Texture = nullptr;
+			}
+
+			entry.m_ResidentMip = entry.m_NumberOfMips;
+			entry.m_Decoded.clear();
+		}
+
+		if (m_Placeholder)
+		{
+			delete m_Placeholder;
+			m_Placeholder = nullptr;
+		}
+
+		StreamedTexture::ReleaseResources();
+
+		m_Statistics.m_ResidentBytes = 0;
+	}
+
+	uint32_t TextureStreamer::GetFirstResidentMip(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		return entry ? entry->m_ResidentMip : 0;
+	}
+
+	uint64_t TextureStreamer::GetResidentBytes(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		return entry ? ComputeBytes(*entry, entry->m_ResidentMip) : 0;
+	}
+
+	uint64_t TextureStreamer::GetFullBytes(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		return entry ? ComputeBytes(*entry, 0) : 0;
+	}
+
+	uint64_t TextureStreamer::GetTailBytes(TextureStreamHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Entry* entry = Find(handle);
+
+		return entry ? ComputeBytes(*entry, GetTailMip(*entry)) : 0;
+	}
+
+	TextureStreamingStatistics TextureStreamer::GetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		TextureStreamingStatistics statistics = m_Statistics;
+		statistics.m_NumberOfPendingDecodes = uint32_t(m_DecodeQueue.size()) + m_NumberOfRunningDecodes;
+
+		return statistics;
+	}
+
+	TextureStreamer::Entry* TextureStreamer::Find(TextureStreamHandle handle)
+	{
+		if (!handle.IsSet() || handle.m_Index >= m_Entries.size())
+		{
+			return nullptr;
+		}
+
+		Entry& entry = m_Entries[handle.m_Index];
+
+		return entry.m_bAlive && entry.m_Generation == handle.m_Generation ? &entry : nullptr;
+	}
+}
@@ -0,0 +1,438 @@
+/**
+ * @file TextureStreamer.h
+ * @brief This file contains the TextureStreamer class, which keeps the mips of the textures in memory within a budget, decoding them on background threads.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "TextureCompressor.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declarations
+	 */
+	class StreamedTexture;
+	class JobPool;
+
+	/**
+	 * @brief A decoded mip, tightly packed RGBA8 (sRGB) or the blocks of a compressed format
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API TextureMip
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		TextureFormat m_Format = TextureFormat::RGBA8;
+		std::vector<uint8_t> m_Pixels;
+	};
+
+	/**
+	 * @brief Where the mips of a streamed texture come from. Decode is called on the decoding threads, never twice at once for one source.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API TextureSource
+	{
+	public:
+		virtual ~TextureSource() = default;
+
+		/**
+		 * @brief Size of mip 0, without decoding the texels
+		 *
+		 * @return false if the texture can't be read
+		 * @since Karma 1.0.0
+		 */
+		virtual bool GetInfo(uint32_t& width, uint32_t& height) = 0;
+
+		/**
+		 * @brief Decodes the mips from firstMip down to 1x1
+		 *
+		 * @param firstMip						The largest mip wanted
+		 * @param mips							Output, mips[i] being mip firstMip + i
+		 *
+		 * @return false if the texture can't be read
+		 * @since Karma 1.0.0
+		 */
+		virtual bool Decode(uint32_t firstMip, std::vector<TextureMip>& mips) = 0;
+
+		/**
+		 * @brief Format of the mips Decode gives, as far as it is known after GetInfo. The streamer goes by the decoded mips' format
+		 * once there are some.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual TextureFormat GetFormat() const { return TextureFormat::RGBA8; }
+
+		/**
+		 * @brief For the logs
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual const std::string& GetName() const = 0;
+
+		/**
+		 * @brief Appends the mips of mips.back() down to 1x1, each a 2x2 box filter of the previous one. Color is averaged in linear space
+		 * (the texels being sRGB) and alpha as is. The last row or column of an odd sized mip is folded into its neighbour's texel.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void GenerateMipChain(std::vector<TextureMip>& mips);
+	};
+
+	/**
+	 * @brief Image file (whatever KarmaUtilities::GetImagePixelData reads) with its mips made on the CPU when decoded
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API FileTextureSource : public TextureSource
+	{
+	public:
+		FileTextureSource(const std::string& fileName);
+
+		virtual bool GetInfo(uint32_t& width, uint32_t& height) override;
+		virtual bool Decode(uint32_t firstMip, std::vector<TextureMip>& mips) override;
+		virtual const std::string& GetName() const override { return m_FileName; }
+
+	private:
+		std::string m_FileName;
+	};
+
+	/**
+	 * @brief Made up texture (cells of noise) for running the streamer without files (the texture stream benchmark of KarmaBenchmarks)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API SyntheticTextureSource : public TextureSource
+	{
+	public:
+		SyntheticTextureSource(uint32_t width, uint32_t height, uint32_t seed);
+
+		virtual bool GetInfo(uint32_t& width, uint32_t& height) override;
+		virtual bool Decode(uint32_t firstMip, std::vector<TextureMip>& mips) override;
+		virtual const std::string& GetName() const override { return m_Name; }
+
+	private:
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint32_t m_Seed;
+		std::string m_Name;
+	};
+
+	/**
+	 * @brief The knobs of the TextureStreamer
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API TextureStreamingSettings
+	{
+		/**
+		 * @brief Bytes the resident mips may take. The small mips (m_ResidentTailExtent) are kept regardless.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_BudgetBytes = 256ull * 1024 * 1024;
+
+		/**
+		 * @brief Bytes uploaded per Update at most (one mip is, whatever its size), so that a burst of loading doesn't stall a frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_UploadBytesPerFrame = 8ull * 1024 * 1024;
+
+		/**
+		 * @brief Textures the decoding thread hands the loading pool at once
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_DecodeBatchSize = 16;
+
+		/**
+		 * @brief Updates without a ReportUsage after which a texture wants its tail only
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_UnusedFrames = 60;
+
+		/**
+		 * @brief Mips of this extent (in pixels, the larger side) or smaller stay resident
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_ResidentTailExtent = 32;
+
+		/**
+		 * @brief Height of the viewport in pixels, for turning the screen fractions of ReportUsage into texels
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float m_ScreenHeight = 1080.0f;
+	};
+
+	/**
+	 * @brief What the TextureStreamer did, per Update or overall
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API TextureStreamingStatistics
+	{
+		/** Textures registered */
+		uint32_t m_NumberOfTextures = 0;
+
+		/** Bytes of the mips in memory */
+		uint64_t m_ResidentBytes = 0;
+
+		/** Bytes of the mips the usage asks for, before the budget */
+		uint64_t m_WantedBytes = 0;
+
+		/** The most m_ResidentBytes has been */
+		uint64_t m_PeakResidentBytes = 0;
+
+		/** Mips uploaded by the last Update, and their bytes */
+		uint32_t m_NumberOfUploads = 0;
+		uint64_t m_UploadedBytes = 0;
+
+		/** Textures which had mips dropped by the last Update, for the budget or for not being used */
+		uint32_t m_NumberOfEvictions = 0;
+
+		/** Textures whose mips were cut by the last Update to fit the budget */
+		uint32_t m_NumberOfBudgetReductions = 0;
+
+		/** Decodes done since the start, and queued or running now */
+		uint64_t m_NumberOfDecodes = 0;
+		uint32_t m_NumberOfPendingDecodes = 0;
+
+		/** Textures bound since the last Update with nothing resident, which the placeholder stood in for */
+		uint32_t m_NumberOfPlaceholderBinds = 0;
+	};
+
+	/**
+	 * @brief Handle to a texture of the TextureStreamer. The generation makes handles of unregistered textures invalid, even if the slot
+	 * is reused.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API TextureStreamHandle
+	{
+		uint32_t m_Index = UINT32_MAX;
+		uint32_t m_Generation = 0;
+
+		bool IsSet() const { return m_Index != UINT32_MAX; }
+	};
+
+	/**
+	 * @brief Keeps the mips of the registered textures in memory according to their use on screen, within a budget.
+	 *
+	 * Each Update (on the render thread, Renderer::BeginScene)
+	 * 1. turns the screen sizes reported since the previous one into the mip each texture wants (the smallest one with a texel per pixel
+	 *    covered),
+	 * 2. cuts the largest mips of the most oversampled textures while the wanted ones are over budget,
+	 * 3. drops the mips which aren't wanted anymore,
+	 * 4. queues the decodes of the mips missing to the decoding thread, which decodes them in batches on the loading pool (JobPool), and
+	 * 5. uploads the decoded mips, the smallest first over all textures, up to the bytes of a frame, so that a texture gets sharper
+	 *    one mip at a time and is never incomplete.
+	 *
+	 * Textures with nothing resident yet bind a placeholder. Streaming needs textures bound per draw (OpenGL, Null) or sampled through the
+	 * bindless table (Vulkan), see IsSupported.
+	 *
+	 * @see Texture, StreamedTexture
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API TextureStreamer
+	{
+	public:
+		TextureStreamer();
+		~TextureStreamer();
+
+		/**
+		 * @brief The streamer of the renderer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static TextureStreamer& Get();
+
+		/**
+		 * @brief Whether the renderer's API can stream. Vulkan does with the bindless table only, whose slots the streamed textures move
+		 * between as their images are remade (VulkanStreamedTexture). The per material descriptor sets hold the image view the vertex
+		 * array was made with (VulkanVertexArray::CreateDescriptorSets), so without the table the textures are loaded whole.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool IsSupported();
+
+		/**
+		 * @brief Starts streaming the source. Nothing is decoded till an Update.
+		 *
+		 * @return Invalid handle (not IsSet) if the source can't be read
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		TextureStreamHandle Register(std::shared_ptr<TextureSource> source);
+
+		/**
+		 * @brief Stops streaming the texture. Its GPU texture goes at the next Update.
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		void Unregister(TextureStreamHandle handle);
+
+		/**
+		 * @brief Tells that the texture is drawn this frame, covering screenFraction of the viewport's height. The largest report of a
+		 * frame counts.
+		 *
+		 * @note Thread safe
+		 * @since Karma 1.0.0
+		 */
+		void ReportUsage(TextureStreamHandle handle, float screenFraction);
+
+		/**
+		 * @brief Binds the texture, or the placeholder if none of its mips is resident
+		 *
+		 * @note Render thread
+		 * @since Karma 1.0.0
+		 */
+		void Bind(TextureStreamHandle handle, uint32_t unit);
+
+		/**
+		 * @brief The GPU texture of the handle, made (with nothing resident) if it isn't yet, for the APIs which reference it ahead of
+		 * the draws (Vulkan's material table)
+		 *
+		 * @return nullptr if the handle isn't registered or the API doesn't stream
+		 * @note Render thread
+		 * @since Karma 1.0.0
+		 */
+		StreamedTexture* GetTexture(TextureStreamHandle handle);
+
+		/**
+		 * @brief One round of the streaming, see the class
+		 *
+		 * @note Render thread
+		 * @since Karma 1.0.0
+		 */
+		void Update();
+
+		/**
+		 * @brief Blocks till the decodes queued are done
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void WaitForDecodes();
+
+		/**
+		 * @brief Deletes the GPU textures and the placeholder, before the context goes. The textures still registered start from nothing
+		 * at the next Update.
+		 *
+		 * @note Render thread
+		 * @since Karma 1.0.0
+		 */
+		void ReleaseResources();
+
+		/**
+		 * @brief The mip of the texture sampled from, its number of mips when none is resident
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetFirstResidentMip(TextureStreamHandle handle);
+
+		/**
+		 * @brief Bytes the resident mips of the texture take on the GPU
+		 *
+		 * @see AssetManager::GetMemoryReport
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetResidentBytes(TextureStreamHandle handle);
+
+		/**
+		 * @brief Bytes all of the mips of the texture take on the GPU, and the mips kept resident regardless (m_ResidentTailExtent)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetFullBytes(TextureStreamHandle handle);
+		uint64_t GetTailBytes(TextureStreamHandle handle);
+
+		TextureStreamingSettings& GetSettings() { return m_Settings; }
+		TextureStreamingStatistics GetStatistics();
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<TextureSource> m_Source;
+			StreamedTexture* m_Texture = nullptr;
+
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+			uint32_t m_NumberOfMips = 0;
+			TextureFormat m_Format = TextureFormat::RGBA8;
+
+			uint32_t m_Generation = 0;
+			bool m_bAlive = false;
+
+			// Couldn't be decoded, stays a placeholder
+			bool m_bFailed = false;
+
+			// Largest of this frame's reports, and the one Update went by
+			float m_ReportedPixels = 0.0f;
+			float m_ScreenPixels = 0.0f;
+			uint64_t m_LastUsedFrame = 0;
+
+			uint32_t m_WantedMip = 0;
+			uint32_t m_ResidentMip = 0;
+
+			// Decoded mips waiting for the upload, m_Decoded[i] being mip m_DecodedFirstMip + i
+			bool m_bDecoding = false;
+			std::vector<TextureMip> m_Decoded;
+			uint32_t m_DecodedFirstMip = 0;
+		};
+
+		struct DecodeRequest
+		{
+			uint32_t m_Index;
+			uint32_t m_Generation;
+			uint32_t m_FirstMip;
+			std::shared_ptr<TextureSource> m_Source;
+		};
+
+		uint32_t ComputeWantedMip(const Entry& entry) const;
+		uint32_t GetTailMip(const Entry& entry) const;
+		uint64_t ComputeBytes(const Entry& entry, uint32_t firstMip) const;
+
+		void FitBudget();
+		void UploadDecoded();
+		void DecodeLoop();
+		Entry* Find(TextureStreamHandle handle);
+
+	private:
+		TextureStreamingSettings m_Settings;
+		TextureStreamingStatistics m_Statistics;
+
+		std::vector<Entry> m_Entries;
+		std::vector<uint32_t> m_FreeEntries;
+
+		// GPU textures of unregistered entries, deleted on the render thread
+		std::vector<StreamedTexture*> m_PendingDeletes;
+
+		StreamedTexture* m_Placeholder;
+		uint64_t m_FrameNumber;
+
+		std::mutex m_Mutex;
+
+		// The decoding thread's
+		std::thread m_DecodeThread;
+		std::condition_variable m_DecodeCondition;
+		std::condition_variable m_DecodedCondition;
+		std::list<DecodeRequest> m_DecodeQueue;
+		uint32_t m_NumberOfRunningDecodes;
+		bool m_bQuit;
+		JobPool* m_Pool;
+	};
+}
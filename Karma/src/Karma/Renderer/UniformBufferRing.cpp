@@ -0,0 +1,116 @@
+#include "UniformBufferRing.h"
+#include "Karma/Core.h"
+#include "Renderer.h"
+#include "Buffer.h"
+#include "Platform/OpenGL/OpenGLUniformBufferRing.h"
+#include "Platform/Vulkan/VulkanUniformBufferRing.h"
+#include "Platform/Null/NullUniformBufferRing.h"
+
+namespace Karma
+{
+	UniformBufferRing* UniformBufferRing::Create(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+				KR_CORE_ASSERT(false, "RendererAPI::None is not supported");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return new OpenGLUniformBufferRing(type, bytesPerFrame, numberOfFrames);
+			case RendererAPI::API::Vulkan:
+				return new VulkanUniformBufferRing(type, bytesPerFrame, numberOfFrames);
+			case RendererAPI::API::Null:
+				return new NullUniformBufferRing(type, bytesPerFrame, numberOfFrames);
+		}
+
+		KR_CORE_ASSERT(false, "Unknown RendererAPI specified");
+		return nullptr;
+	}
+
+	UniformBufferRing::UniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames) :
+		m_MappedData(nullptr), m_Alignment(1), m_Type(type), m_BytesPerFrame(bytesPerFrame), m_NumberOfFrames(numberOfFrames),
+		m_CurrentFrame(0), m_Head(0)
+	{
+		KR_CORE_ASSERT(numberOfFrames > 0, "UniformBufferRing needs atleast one frame");
+	}
+
+	void UniformBufferRing::BeginFrame()
+	{
+		m_CurrentFrame = (m_CurrentFrame + 1) % m_NumberOfFrames;
+		m_Head = 0;
+
+		m_Statistics = UniformRingStatistics();
+	}
+
+	void* UniformBufferRing::Allocate(uint32_t size, uint32_t& offset)
+	{
+		uint32_t frameStart = m_CurrentFrame * m_BytesPerFrame;
+
+		// Align the absolute offset, since that is what the graphics card gets to see
+		uint32_t alignedOffset = (frameStart + m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+		if (uint64_t(alignedOffset) + size > frameStart + m_BytesPerFrame)
+		{
+			// Out of room for this frame. Wrapping would overwrite the blocks the earlier draws of the frame still refer to, so the
+			// allocation fails and its draw is skipped.
+			if (m_Statistics.m_NumberOfFailedAllocations++ == 0)
+			{
+				KR_CORE_ERROR("UniformBufferRing: frame region of {0} bytes exhausted, skipping the draws which don't fit. Consider a bigger ring.",
+					m_BytesPerFrame);
+			}
+
+			offset = s_InvalidOffset;
+			return nullptr;
+		}
+
+		m_Head = alignedOffset + size - frameStart;
+
+		m_Statistics.m_NumberOfAllocations++;
+		m_Statistics.m_UsedBytes = m_Head;
+
+		offset = alignedOffset;
+		return m_MappedData + alignedOffset;
+	}
+
+	uint32_t UniformBufferRing::PushData(const void* data, uint32_t size)
+	{
+		uint32_t blockOffset;
+		void* destination = Allocate(size, blockOffset);
+
+		if (destination == nullptr)
+		{
+			return s_InvalidOffset;
+		}
+
+		memcpy(destination, data, size);
+		FlushRange(blockOffset, size);
+
+		return blockOffset;
+	}
+
+	uint32_t UniformBufferRing::PushUniforms(const UniformBufferObject& ubo)
+	{
+		uint32_t blockSize = ubo.GetBufferSize();
+		uint32_t blockOffset;
+		uint8_t* destination = static_cast<uint8_t*>(Allocate(blockSize, blockOffset));
+
+		if (destination == nullptr)
+		{
+			return s_InvalidOffset;
+		}
+
+		// The uniforms go at their std140 offsets, the padding between them is left as it is
+		uint32_t index = 0;
+		for (auto& it : ubo.GetUniformList())
+		{
+			uint32_t uniformSize = ubo.GetUniformSize()[index];
+			uint32_t offset = ubo.GetAlignedOffsets()[index++];
+
+			memcpy(destination + offset, it.GetDataPointer(), uniformSize);
+		}
+
+		FlushRange(blockOffset, blockSize);
+
+		return blockOffset;
+	}
+}
@@ -0,0 +1,246 @@
+/**
+ * @file UniformBufferRing.h
+ * @brief This file contains the UniformBufferRing class, a persistently mapped, per frame, linear allocator for uniform (and storage) data.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	struct UniformBufferObject;
+
+	/**
+	 * @brief The kind of data the ring holds. Decides the buffer usage and the offset alignment honoured by the ring.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	enum class RingBufferType
+	{
+		/**
+		 * @brief Uniform buffer (UBO), aligned to minUniformBufferOffsetAlignment (Vulkan) or GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT (OpenGL)
+		 */
+		Uniform = 0,
+		/**
+		 * @brief Shader storage buffer (SSBO), aligned to minStorageBufferOffsetAlignment (Vulkan) or GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT (OpenGL)
+		 */
+		Storage,
+		/**
+		 * @brief Per instance vertex data (instanced draws' world matrices), aligned to 16 bytes
+		 */
+		Vertex
+	};
+
+	/**
+	 * @brief Counters gathered by UniformBufferRing, per frame
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API UniformRingStatistics
+	{
+		/**
+		 * @brief Number of UniformBufferRing::Allocate calls
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfAllocations = 0;
+
+		/**
+		 * @brief Bytes (including alignment padding) consumed from the frame's region
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_UsedBytes = 0;
+
+		/**
+		 * @brief Number of allocations refused because the frame's region was full. The draws using them are skipped.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfFailedAllocations = 0;
+	};
+
+	/**
+	 * @brief A single buffer, mapped once at creation and never unmapped, split into numberOfFrames regions of bytesPerFrame each.
+	 * Every frame the CPU writes its uniforms linearly (pointer bump) into the region of that frame, and the draws refer to the data by an
+	 * offset (dynamic offset in Vulkan, glBindBufferRange in OpenGL). This replaces the map/memcpy/unmap per uniform, per frame.
+	 *
+	 * The region is reused only after numberOfFrames frames have gone by, so the numberOfFrames should be (at least) one more than the number of
+	 * frames the GPU can lag behind the CPU.
+	 *
+	 * An allocation which doesn't fit in what is left of the frame's region fails (s_InvalidOffset), rather than overwriting the blocks the
+	 * earlier draws of the frame refer to. The ring doesn't grow, since the descriptor sets (and GL bindings) refer to its one buffer.
+	 *
+	 * @note Every push writes its own block, identical or not, so that a push stays a pointer bump and a copy
+	 *
+	 * @see VulkanUniformBufferRing, OpenGLUniformBufferRing
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API UniformBufferRing
+	{
+	public:
+		/**
+		 * @brief The offset of a failed allocation. A draw with it is to be skipped.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_InvalidOffset = UINT32_MAX;
+
+		/**
+		 * @brief A function for appropriate initialization of the ring based on programmer selected renderer (Vulkan or OpenGL)
+		 *
+		 * @param type							Uniform or storage data
+		 * @param bytesPerFrame					Size (in bytes) of the region available to each frame
+		 * @param numberOfFrames				Number of regions (frames) the buffer is split into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static UniformBufferRing* Create(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames);
+
+		/**
+		 * @brief Destructor. Sub class frees up the buffer.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~UniformBufferRing() = default;
+
+		/**
+		 * @brief Moves to the region of the next frame and resets the linear head. Called once per frame (when swapping buffers).
+		 *
+		 * @note Sub class may override for waiting on the GPU to be done with the region
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginFrame();
+
+		/**
+		 * @brief Sub-allocates (pointer bump) size bytes from the region of the current frame
+		 *
+		 * @param size							Size (in bytes) demanded
+		 * @param offset						Out parameter, the offset (from the beginning of the buffer) of the allocation, multiple of GetAlignment().
+		 *										s_InvalidOffset if the frame's region is full.
+		 *
+		 * @return Host pointer to write the data to, nullptr if the frame's region is full
+		 * @since Karma 1.0.0
+		 */
+		void* Allocate(uint32_t size, uint32_t& offset);
+
+		/**
+		 * @brief Writes the uniforms of the UBO (at their std140 aligned offsets) straight into a block of the ring
+		 *
+		 * @param ubo							The UBO with latest uniform list, see UniformBufferObject::UpdateUniforms
+		 *
+		 * @return The offset (from the beginning of the buffer) of the written block, s_InvalidOffset if the frame's region is full
+		 * @since Karma 1.0.0
+		 */
+		uint32_t PushUniforms(const UniformBufferObject& ubo);
+
+		/**
+		 * @brief Copies raw data (for instance per instance world matrices) into the ring, the way PushUniforms does
+		 *
+		 * @param data							Source
+		 * @param size							Size in bytes
+		 *
+		 * @return The offset (from the beginning of the buffer) of the written block, s_InvalidOffset if the frame's region is full
+		 * @since Karma 1.0.0
+		 */
+		uint32_t PushData(const void* data, uint32_t size);
+
+		/**
+		 * @brief Type of data held by the ring
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RingBufferType GetType() const { return m_Type; }
+
+		/**
+		 * @brief Offset alignment honoured by the allocations
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetAlignment() const { return m_Alignment; }
+
+		/**
+		 * @brief Size (in bytes) of each frame's region
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetBytesPerFrame() const { return m_BytesPerFrame; }
+
+		/**
+		 * @brief Number of regions the buffer is split into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfFrames() const { return m_NumberOfFrames; }
+
+		/**
+		 * @brief Total size (in bytes) of the buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetTotalSize() const { return m_BytesPerFrame * m_NumberOfFrames; }
+
+		/**
+		 * @brief Index of the region being written
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetCurrentFrame() const { return m_CurrentFrame; }
+
+		/**
+		 * @brief Counters of the current frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const UniformRingStatistics& GetStatistics() const { return m_Statistics; }
+
+	protected:
+		/**
+		 * @brief Agnostic constructor. Sub class is supposed to create and map the buffer, and set m_MappedData and m_Alignment.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		UniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames);
+
+		/**
+		 * @brief Called after the data is written at offset. Persistently (and coherently) mapped buffers need do nothing, whereas a renderer
+		 * without persistent mapping may copy the range to GPU here.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void FlushRange(uint32_t offset, uint32_t size) {}
+
+	protected:
+		/**
+		 * @brief Host pointer to the beginning of the (mapped) buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint8_t* m_MappedData;
+
+		/**
+		 * @brief Offset alignment demanded by the graphics card
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Alignment;
+
+	private:
+		RingBufferType m_Type;
+
+		uint32_t m_BytesPerFrame;
+		uint32_t m_NumberOfFrames;
+		uint32_t m_CurrentFrame;
+
+		// Offset (from the region start) of the free space
+		uint32_t m_Head;
+
+		UniformRingStatistics m_Statistics;
+	};
+}
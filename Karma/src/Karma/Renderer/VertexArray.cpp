@@ -3,6 +3,7 @@
 #include "Karma/Core.h"
 #include "Platform/OpenGL/OpenGLVertexArray.h"
 #include "Platform/Vulkan/VulkanVertexArray.h"
+#include "Platform/Null/NullVertexArray.h"
 
 namespace Karma
 {
@@ -17,9 +18,63 @@ namespace Karma
 				return new OpenGLVertexArray();
 			case RendererAPI::API::Vulkan:
 				return new VulkanVertexArray();
+			case RendererAPI::API::Null:
+				return new NullVertexArray();
 		}
 
 		KR_CORE_ASSERT(false, "Unknown RendererAPI");
 		return nullptr;
 	}
-}
\ No newline at end of file
+
+	bool VertexArray::RefreshReloadedAssets()
+	{
+		const uint64_t assetGeneration = GetAssetGeneration();
+
+		if (assetGeneration == m_AssetGeneration)
+		{
+			return false;
+		}
+
+		OnAssetsReloaded();
+		m_AssetGeneration = GetAssetGeneration();
+
+		return true;
+	}
+
+	void VertexArray::TrackMesh(std::shared_ptr<Mesh> mesh)
+	{
+		m_Mesh = mesh;
+		m_AssetGeneration = GetAssetGeneration();
+	}
+
+	void VertexArray::TrackMaterial(std::shared_ptr<Material> material)
+	{
+		// The first material is the one drawn with
+		if (!m_TrackedMaterial)
+		{
+			m_TrackedMaterial = material;
+		}
+
+		m_AssetGeneration = GetAssetGeneration();
+	}
+
+	uint64_t VertexArray::GetAssetGeneration() const
+	{
+		uint64_t assetGeneration = m_Mesh ? m_Mesh->GetGeneration() : 0;
+
+		if (m_TrackedMaterial)
+		{
+			if (std::shared_ptr<Shader> shader = m_TrackedMaterial->GetShader(0))
+			{
+				assetGeneration += shader->GetGeneration();
+			}
+
+			for (const std::shared_ptr<Texture>& texture : m_TrackedMaterial->GetTextures())
+			{
+				assetGeneration += texture->GetGeneration();
+			}
+		}
+
+		return assetGeneration;
+	}
+}
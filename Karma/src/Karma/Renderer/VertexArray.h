@@ -15,6 +15,7 @@
 #include "Karma/Renderer/Shader.h"
 #include "Karma/Renderer/Mesh.h"
 #include "Karma/Renderer/Material.h"
+#include "Karma/Renderer/RenderSortKey.h"
 
 namespace Karma
 {
@@ -86,7 +87,12 @@ namespace Karma
 		virtual void UpdateProcessAndSetReadyForSubmission() const = 0;
 
 		// Getters
-		//virtual std::shared_ptr<Mesh> GetMesh() const = 0;
+		/**
+		 * @brief Getter for the mesh set last, nullptr if the buffers were added bare (AddVertexBuffer, SetIndexBuffer)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<Mesh> GetMesh() const { return m_Mesh; }
 
 		/**
 		 * @brief Getter function for material
@@ -101,5 +107,63 @@ namespace Karma
 		 * @since Karma 1.0.0
 		 */
 		static VertexArray* Create();
+
+		/**
+		 * @brief Identity of the vertex array in RenderSortKey
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetSortID() const { return m_SortID; }
+
+		/**
+		 * @brief Sets the vertex array up again (the buffers, and the pipelines and descriptors of Vulkan) if the contents of its mesh, or
+		 * of the shader or textures of its material, were swapped for reloaded ones since it was set up. To be called on the render thread
+		 * between frames, after AssetManager::Update.
+		 *
+		 * @return true if it was set up again
+		 * @see Scene::RefreshReloadedAssets
+		 * @since Karma 1.0.0
+		 */
+		bool RefreshReloadedAssets();
+
+	protected:
+		/**
+		 * @brief Remembers the mesh and the generation of the contents the vertex array is set up from. For the backends' SetMesh.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void TrackMesh(std::shared_ptr<Mesh> mesh);
+
+		/**
+		 * @brief Remembers the (first) material and the generation of the contents the vertex array is set up from. For the backends'
+		 * SetMaterial.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void TrackMaterial(std::shared_ptr<Material> material);
+
+		/**
+		 * @brief The backend's part of RefreshReloadedAssets, the mesh and material being the same objects with new contents
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void OnAssetsReloaded() {}
+
+	private:
+		/**
+		 * @brief Sum of the generations (Mesh::GetGeneration and company) of the mesh, shader and textures
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetAssetGeneration() const;
+
+	private:
+		uint32_t m_SortID = RenderSortKey::NextSortID();
+
+		std::shared_ptr<Mesh> m_Mesh;
+
+		// The backends keep their list of materials, this one is for the generations
+		std::shared_ptr<Material> m_TrackedMaterial;
+		uint64_t m_AssetGeneration = 0;
 	};
 }
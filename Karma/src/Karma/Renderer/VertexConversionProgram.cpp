@@ -0,0 +1,206 @@
+#include "VertexConversionProgram.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define KR_INTERLEAVE_SSE 1
+#endif
+
+namespace Karma
+{
+	namespace
+	{
+		static_assert(sizeof(aiVector3D) == 3 * sizeof(float) && sizeof(aiColor4D) == 4 * sizeof(float),
+			"The vertex conversion reads Assimp's streams as floats (ASSIMP_DOUBLE_PRECISION is not supported)");
+
+		// Values of the attributes a mesh lacks
+		const float s_DefaultUV[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		const float s_DefaultColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		const float s_DefaultNormal[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+		const float s_DefaultTangent[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+		const float s_DefaultZero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		template<uint32_t NumberOfComponents>
+		void CopyElements(const float* source, uint32_t sourceStride, float* destination, uint32_t destinationStride, uint32_t numberOfElements)
+		{
+			for (uint32_t counter = 0; counter < numberOfElements; counter++)
+			{
+				for (uint32_t component = 0; component < NumberOfComponents; component++)
+				{
+					destination[component] = source[component];
+				}
+
+				source += sourceStride;
+				destination += destinationStride;
+			}
+		}
+
+#if defined(KR_INTERLEAVE_SSE)
+		template<>
+		void CopyElements<4>(const float* source, uint32_t sourceStride, float* destination, uint32_t destinationStride, uint32_t numberOfElements)
+		{
+			for (uint32_t counter = 0; counter < numberOfElements; counter++)
+			{
+				_mm_storeu_ps(destination, _mm_loadu_ps(source));
+
+				source += sourceStride;
+				destination += destinationStride;
+			}
+		}
+
+		template<>
+		void CopyElements<3>(const float* source, uint32_t sourceStride, float* destination, uint32_t destinationStride, uint32_t numberOfElements)
+		{
+			if (numberOfElements == 0)
+			{
+				return;
+			}
+
+			// One float is read past each element, so the last one (whose next float may be past the stream) is copied apart
+			for (uint32_t counter = 0; counter + 1 < numberOfElements; counter++)
+			{
+				__m128 element = _mm_loadu_ps(source);
+
+				_mm_storel_pi(reinterpret_cast<__m64*>(destination), element);
+				_mm_store_ss(destination + 2, _mm_movehl_ps(element, element));
+
+				source += sourceStride;
+				destination += destinationStride;
+			}
+
+			destination[0] = source[0];
+			destination[1] = source[1];
+			destination[2] = source[2];
+		}
+
+		template<>
+		void CopyElements<2>(const float* source, uint32_t sourceStride, float* destination, uint32_t destinationStride, uint32_t numberOfElements)
+		{
+			for (uint32_t counter = 0; counter < numberOfElements; counter++)
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(destination), _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(source)));
+
+				source += sourceStride;
+				destination += destinationStride;
+			}
+		}
+#endif
+
+		// The stream of the attribute within the mesh, nullptr if the mesh lacks it
+		const float* GetAttributeStream(const aiMesh* meshToProcess, MeshAttribute attribute, uint32_t& sourceStride)
+		{
+			sourceStride = 3;
+
+			switch (attribute)
+			{
+				case MeshAttribute::Vertices:
+					return reinterpret_cast<const float*>(meshToProcess->mVertices);
+				case MeshAttribute::Normals:
+					return reinterpret_cast<const float*>(meshToProcess->mNormals);
+				case MeshAttribute::Tangents:
+					return reinterpret_cast<const float*>(meshToProcess->mTangents);
+				case MeshAttribute::Bitangents:
+					return reinterpret_cast<const float*>(meshToProcess->mBitangents);
+				case MeshAttribute::TextureCoords:
+					return reinterpret_cast<const float*>(meshToProcess->mTextureCoords[0]);
+				case MeshAttribute::Colors:
+					sourceStride = 4;
+					return reinterpret_cast<const float*>(meshToProcess->mColors[0]);
+				default:
+					return nullptr;
+			}
+		}
+
+		const float* GetAttributeDefault(MeshAttribute attribute)
+		{
+			switch (attribute)
+			{
+				case MeshAttribute::TextureCoords:
+					return s_DefaultUV;
+				case MeshAttribute::Colors:
+					return s_DefaultColor;
+				case MeshAttribute::Normals:
+					return s_DefaultNormal;
+				case MeshAttribute::Tangents:
+					return s_DefaultTangent;
+				default:
+					return s_DefaultZero;
+			}
+		}
+	}
+
+	VertexConversionProgram::VertexConversionProgram(const BufferLayout& buffLayout) : m_StrideInFloats(buffLayout.GetStride() / sizeof(float))
+	{
+		Mesh::InitializeAttributeDictionary();
+
+		for (const BufferElement& layoutElem : buffLayout.GetElements())
+		{
+			StreamCopy streamCopy;
+
+			if (!Mesh::GetAttributeOfElement(layoutElem.Name, streamCopy.m_Attribute))
+			{
+				KR_CORE_WARN("Interleaving unknown attribute {0}, it is filled with zeros", layoutElem.Name);
+				streamCopy.m_Attribute = MeshAttribute::AnimMeshes;
+			}
+
+			streamCopy.m_NumberOfComponents = layoutElem.GetComponentCount();
+			streamCopy.m_DestinationOffset = uint32_t(layoutElem.Offset / sizeof(float));
+
+			KR_CORE_ASSERT(streamCopy.m_NumberOfComponents >= 1 && streamCopy.m_NumberOfComponents <= 4, "Vertex elements are 1 to 4 floats");
+
+			m_StreamCopies.push_back(streamCopy);
+		}
+	}
+
+	void VertexConversionProgram::Convert(const aiMesh* meshToProcess, float* vertexData) const
+	{
+		for (const StreamCopy& streamCopy : m_StreamCopies)
+		{
+			uint32_t sourceStride;
+			const float* source = GetAttributeStream(meshToProcess, streamCopy.m_Attribute, sourceStride);
+
+			if (source == nullptr)
+			{
+				source = GetAttributeDefault(streamCopy.m_Attribute);
+				sourceStride = 0;
+			}
+
+			CopyStream(source, sourceStride, streamCopy.m_NumberOfComponents, vertexData + streamCopy.m_DestinationOffset, m_StrideInFloats,
+				meshToProcess->mNumVertices);
+		}
+	}
+
+	void VertexConversionProgram::CopyStream(const float* source, uint32_t sourceStride, uint32_t numberOfComponents, float* destination,
+		uint32_t destinationStride, uint32_t numberOfElements)
+	{
+		// A repeated element is copied aside first, so that the SSE loads never read past it
+		float repeatedElement[4] = {};
+
+		if (sourceStride == 0)
+		{
+			for (uint32_t component = 0; component < numberOfComponents; component++)
+			{
+				repeatedElement[component] = source[component];
+			}
+			source = repeatedElement;
+		}
+
+		switch (numberOfComponents)
+		{
+			case 1:
+				CopyElements<1>(source, sourceStride, destination, destinationStride, numberOfElements);
+				break;
+			case 2:
+				CopyElements<2>(source, sourceStride, destination, destinationStride, numberOfElements);
+				break;
+			case 3:
+				CopyElements<3>(source, sourceStride, destination, destinationStride, numberOfElements);
+				break;
+			case 4:
+				CopyElements<4>(source, sourceStride, destination, destinationStride, numberOfElements);
+				break;
+			default:
+				KR_CORE_ASSERT(false, "Vertex elements are 1 to 4 floats");
+				break;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/**
+ * @file VertexConversionProgram.h
+ * @brief This file contains the VertexConversionProgram class, which interleaves the attribute streams of an aiMesh as a BufferLayout lays them.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Mesh.h"
+
+namespace Karma
+{
+	/**
+	 * @brief A BufferLayout compiled into a list of stream copies. The names of the elements are looked up (in the attribute dictionary of
+	 * Mesh) once, when the program is made, instead of once per float as Mesh::LayoutElementToAttributeValue does.
+	 *
+	 * Convert then copies whole attribute streams (all of the positions, then all of the UVs, and so on) into their slots of the
+	 * interleaved vertices, with SSE loads and stores where available. Attributes the mesh lacks are filled with defaults (UV 0,
+	 * color white, normal +z, tangent +x), so that meshes of one model can share a layout.
+	 *
+	 * @see Mesh::DealVertexIndexBufferData, ModelImporter
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VertexConversionProgram
+	{
+	public:
+		/**
+		 * @brief Resolves the elements of the layout to the attributes of aiMesh
+		 *
+		 * @param buffLayout					Layout of the interleaved vertices (float elements)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VertexConversionProgram(const BufferLayout& buffLayout);
+
+		/**
+		 * @brief Interleaves the vertices of the mesh
+		 *
+		 * @param meshToProcess					The mesh
+		 * @param vertexData					Output, at least meshToProcess->mNumVertices * GetStrideInFloats() floats
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Convert(const aiMesh* meshToProcess, float* vertexData) const;
+
+		/**
+		 * @brief Floats per interleaved vertex
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetStrideInFloats() const { return m_StrideInFloats; }
+
+		/**
+		 * @brief Copies numberOfComponents floats from each source element to each destination element
+		 *
+		 * @param source						First source element
+		 * @param sourceStride					Distance, in floats, between consecutive source elements (0 repeats the first element)
+		 * @param numberOfComponents			Floats per element, 1 to 4
+		 * @param destination					First destination element
+		 * @param destinationStride				Distance, in floats, between consecutive destination elements
+		 * @param numberOfElements				Number of elements
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void CopyStream(const float* source, uint32_t sourceStride, uint32_t numberOfComponents, float* destination,
+			uint32_t destinationStride, uint32_t numberOfElements);
+
+	private:
+		/**
+		 * @brief One element of the layout, resolved
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct StreamCopy
+		{
+			MeshAttribute m_Attribute;
+			uint32_t m_NumberOfComponents;
+			uint32_t m_DestinationOffset;
+		};
+
+		std::vector<StreamCopy> m_StreamCopies;
+		uint32_t m_StrideInFloats;
+	};
+}
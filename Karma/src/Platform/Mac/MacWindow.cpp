@@ -8,6 +8,7 @@
 #include "stb_image.h"
 #include "Karma/Renderer/Renderer.h"
 #include "Platform/Vulkan/VulkanContext.h"
+#include "Platform/Null/NullWindow.h"
 #include "Karma/KarmaUtilities.h"
 
 namespace Karma
@@ -21,6 +22,12 @@ namespace Karma
 #ifdef KR_MAC_PLATFORM
 	Window* Window::Create(const WindowProps& props)
 	{
+		// Headless, no display needed
+		if (RendererAPI::GetAPI() == RendererAPI::API::Null)
+		{
+			return new NullWindow(props);
+		}
+
 		return new MacWindow(props);
 	}
 #endif
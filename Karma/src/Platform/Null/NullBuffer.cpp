@@ -0,0 +1,114 @@
+#include "NullBuffer.h"
+#include "NullRendererAPI.h"
+#include "NullUniformBufferRing.h"
+#include "Karma/Renderer/RenderCommand.h"
+#include "Karma/KarmaUtilities.h"
+
+namespace Karma
+{
+	NullVertexBuffer::NullVertexBuffer(float* vertices, uint32_t size) : m_Size(size)
+	{
+		KR_CORE_ASSERT(vertices != nullptr, "NullVertexBuffer: no vertex data");
+		KR_CORE_ASSERT(size > 0 && size % sizeof(float) == 0, "NullVertexBuffer: size should be a non zero multiple of sizeof(float)");
+
+		NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+		statistics.m_BytesUploaded += size;
+		statistics.m_LiveVertexBuffers++;
+	}
+
+	NullVertexBuffer::~NullVertexBuffer()
+	{
+		NullRendererAPI::GetStatistics().m_LiveVertexBuffers--;
+	}
+
+	void NullVertexBuffer::SetLayout(const BufferLayout& layout)
+	{
+		KR_CORE_ASSERT(layout.GetElements().size(), "NullVertexBuffer: VertexBufferLayout empty.");
+		KR_CORE_ASSERT(layout.GetStride() > 0 && m_Size % layout.GetStride() == 0, "NullVertexBuffer: size isn't a multiple of the layout's stride");
+
+		m_Layout = layout;
+	}
+
+	// IndexBuffer
+
+	NullIndexBuffer::NullIndexBuffer(uint32_t* indices, uint32_t count) : m_Count(count), m_IndexType(IndexType::UInt32)
+	{
+		KR_CORE_ASSERT(indices != nullptr, "NullIndexBuffer: no index data");
+		KR_CORE_ASSERT(count > 0, "NullIndexBuffer: no indices");
+
+		NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+		statistics.m_BytesUploaded += uint64_t(count) * sizeof(uint32_t);
+		statistics.m_LiveIndexBuffers++;
+	}
+
+	NullIndexBuffer::NullIndexBuffer(uint16_t* indices, uint32_t count) : m_Count(count), m_IndexType(IndexType::UInt16)
+	{
+		KR_CORE_ASSERT(indices != nullptr, "NullIndexBuffer: no index data");
+		KR_CORE_ASSERT(count > 0, "NullIndexBuffer: no indices");
+
+		NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+		statistics.m_BytesUploaded += uint64_t(count) * sizeof(uint16_t);
+		statistics.m_LiveIndexBuffers++;
+	}
+
+	NullIndexBuffer::~NullIndexBuffer()
+	{
+		NullRendererAPI::GetStatistics().m_LiveIndexBuffers--;
+	}
+
+	// ImageBuffer
+
+	NullImageBuffer::NullImageBuffer(const char* filename) : m_Width(0), m_Height(0)
+	{
+		KR_CORE_ASSERT(filename != nullptr, "NullImageBuffer: no filename");
+
+		m_BindingPoint = 1;
+
+		int channels = 0;
+		unsigned char* pixels = KarmaUtilities::GetImagePixelData(filename, &m_Width, &m_Height, &channels, 4);
+
+		if (pixels == nullptr)
+		{
+			KR_CORE_ERROR("NullImageBuffer: failed to load the image {0}", filename);
+			m_Width = m_Height = 0;
+			return;
+		}
+
+		stbi_image_free(pixels);
+
+		NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+		statistics.m_BytesUploaded += uint64_t(m_Width) * uint64_t(m_Height) * 4;
+		statistics.m_NumberOfImages++;
+	}
+
+	// UniformBufferObject
+
+	NullUniformBuffer::NullUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex) :
+		UniformBufferObject(dataTypes, bindingPointIndex)
+	{
+		KR_CORE_ASSERT(dataTypes.size(), "NullUniformBuffer: no uniforms");
+
+		NullRendererAPI::GetStatistics().m_LiveUniformBuffers++;
+	}
+
+	NullUniformBuffer::~NullUniformBuffer()
+	{
+		NullRendererAPI::GetStatistics().m_LiveUniformBuffers--;
+	}
+
+	void NullUniformBuffer::UploadUniformBuffer(size_t frameIndex)
+	{
+		KR_CORE_ASSERT(m_UniformList.size() == m_UniformDataType.size(), "NullUniformBuffer: number of uniforms and data types differ");
+
+		for (const auto& uniform : m_UniformList)
+		{
+			KR_CORE_ASSERT(uniform.GetDataPointer() != nullptr, "NullUniformBuffer: uniform without data");
+		}
+
+		NullRendererAPI* nullAPI = static_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI());
+
+		m_RingOffset = nullAPI->GetUniformRing()->PushUniforms(*this);
+
+		NullRendererAPI::GetStatistics().m_BytesUploaded += m_BufferSize;
+	}
+}
@@ -0,0 +1,196 @@
+/**
+ * @file NullBuffer.h
+ * @brief This file contains NullVertex/Index/Image/UniformBuffer classes of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/Buffer.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Null backend's vertex buffer. Validates the data and counts the bytes, nothing is uploaded.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullVertexBuffer : public VertexBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param vertices						float array of interleaved vertex data based on the BufferLayout
+		 * @param size							Size (in bytes) of the vertex buffer
+		 *
+		 * @see OpenGLVertexBuffer::OpenGLVertexBuffer
+		 * @since Karma 1.0.0
+		 */
+		NullVertexBuffer(float* vertices, uint32_t size);
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullVertexBuffer();
+
+		virtual void Bind() const override {}
+		virtual void UnBind() const override {}
+
+		/**
+		 * @brief Getter for the layout of the vertex buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual const BufferLayout& GetLayout() const override
+		{
+			return m_Layout;
+		}
+
+		/**
+		 * @brief Sets the layout of the vertex buffer, asserting that the stride divides the size
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetLayout(const BufferLayout& layout) override;
+
+		/**
+		 * @brief Getter for the size (in bytes)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetSize() const { return m_Size; }
+
+	private:
+		uint32_t m_Size;
+		BufferLayout m_Layout;
+	};
+
+	/**
+	 * @brief Null backend's index buffer. Validates the data and counts the bytes, nothing is uploaded.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullIndexBuffer : public IndexBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param indices						Array of indices
+		 * @param count							Number of indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullIndexBuffer(uint32_t* indices, uint32_t count);
+
+		/**
+		 * @brief Constructor for 16 bit indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullIndexBuffer(uint16_t* indices, uint32_t count);
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullIndexBuffer();
+
+		virtual void Bind() const override {}
+		virtual void UnBind() const override {}
+
+		/**
+		 * @brief Getter for the number of indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual uint32_t GetCount() const override { return m_Count; }
+
+		/**
+		 * @brief Width of the indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual IndexType GetIndexType() const override { return m_IndexType; }
+
+	private:
+		uint32_t m_Count;
+		IndexType m_IndexType;
+	};
+
+	/**
+	 * @brief Null backend's image buffer. The image is decoded (so that missing or corrupt files are caught and the CPU cost is accounted for)
+	 * and the pixels are dropped.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullImageBuffer : public ImageBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param filename						Path to the image
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullImageBuffer(const char* filename);
+
+		/**
+		 * @brief Getter for the width (in pixels) of the decoded image, 0 if decoding failed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		int GetWidth() const { return m_Width; }
+
+		/**
+		 * @brief Getter for the height (in pixels) of the decoded image, 0 if decoding failed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		int GetHeight() const { return m_Height; }
+
+	private:
+		int m_Width;
+		int m_Height;
+	};
+
+	/**
+	 * @brief Null backend's uniform buffer object. The uniforms are written into NullRendererAPI's (host memory) uniform ring, so that the
+	 * packing cost is the same as with the GPU backends.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullUniformBuffer : public UniformBufferObject
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param dataTypes						List of data types for uniforms
+		 * @param bindingPointIndex				The binding of shader specified index
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex);
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullUniformBuffer();
+
+		/**
+		 * @brief Asserts that each uniform has data and pushes the uniforms into the uniform ring
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void UploadUniformBuffer(size_t frameIndex = 0) override;
+	};
+}
@@ -0,0 +1,16 @@
+#include "NullContext.h"
+#include "NullRendererAPI.h"
+#include "Karma/Renderer/RenderCommand.h"
+
+namespace Karma
+{
+	void NullContext::Init()
+	{
+		KR_CORE_INFO("Null context initialized");
+	}
+
+	void NullContext::SwapBuffers()
+	{
+		static_cast<NullRendererAPI*>(RenderCommand::GetRendererAPI())->EndFrame();
+	}
+}
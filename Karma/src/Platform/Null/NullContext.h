@@ -0,0 +1,43 @@
+/**
+ * @file NullContext.h
+ * @brief This file contains NullContext class, the GraphicsContext of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/GraphicsContext.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Null backend's implementation of GraphicsContext. There is no surface, presenting a frame just ends the frame of NullRendererAPI.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class NullContext : public GraphicsContext
+	{
+	public:
+		/**
+		 * @brief Nothing to initialize
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void Init() override;
+
+		/**
+		 * @brief Ends the frame of NullRendererAPI (counters and uniform ring)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SwapBuffers() override;
+
+		/**
+		 * @brief Nothing to resize
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool OnWindowResize(WindowResizeEvent& event) override { return true; }
+	};
+}
@@ -0,0 +1,89 @@
+#include "NullRenderTarget.h"
+
+#include "glm/gtc/packing.hpp"
+
+namespace Karma
+{
+	NullRenderTarget::NullRenderTarget(const RenderTargetSpecification& specification) : RenderTarget(specification)
+	{
+	}
+
+	void NullRenderTarget::Resolve(const glm::vec4& clearColor)
+	{
+		if (!EndFrame())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Same bound as the GPU backends, so the dropped requests show up the same way
+		if (m_Readbacks.size() >= s_ReadbackSlots)
+		{
+			m_Statistics.m_NumberOfDroppedReadbacks++;
+			return;
+		}
+
+		PendingReadback pending;
+		pending.m_IssueTime = std::chrono::steady_clock::now();
+
+		RenderTargetReadback& readback = pending.m_Readback;
+		FillReadbackHeader(readback);
+
+		// One pixel of the clear color, in the layout of the format
+		uint8_t pixel[8] = {};
+		const uint32_t bytesPerPixel = GetBytesPerPixel(readback.m_Format);
+
+		glm::vec4 color = glm::clamp(clearColor, 0.0f, 1.0f);
+
+		switch (readback.m_Format)
+		{
+			case RenderTargetFormat::RGBA8:
+				pixel[0] = uint8_t(color.r * 255.0f + 0.5f);
+				pixel[1] = uint8_t(color.g * 255.0f + 0.5f);
+				pixel[2] = uint8_t(color.b * 255.0f + 0.5f);
+				pixel[3] = uint8_t(color.a * 255.0f + 0.5f);
+				break;
+			case RenderTargetFormat::BGRA8:
+				pixel[0] = uint8_t(color.b * 255.0f + 0.5f);
+				pixel[1] = uint8_t(color.g * 255.0f + 0.5f);
+				pixel[2] = uint8_t(color.r * 255.0f + 0.5f);
+				pixel[3] = uint8_t(color.a * 255.0f + 0.5f);
+				break;
+			case RenderTargetFormat::RGBA16F:
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					uint16_t half = glm::packHalf1x16(clearColor[channel]);
+					memcpy(pixel + 2 * channel, &half, sizeof(half));
+				}
+				break;
+		}
+
+		readback.m_Pixels.resize(GetReadbackSize());
+		for (size_t offset = 0; offset < readback.m_Pixels.size(); offset += bytesPerPixel)
+		{
+			memcpy(readback.m_Pixels.data() + offset, pixel, bytesPerPixel);
+		}
+
+		m_Statistics.m_NumberOfReadbacks++;
+		m_Readbacks.push_back(std::move(pending));
+	}
+
+	bool NullRenderTarget::PollReadback(RenderTargetReadback& readback)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Readbacks.empty())
+		{
+			return false;
+		}
+
+		PendingReadback& pending = m_Readbacks.front();
+
+		readback = std::move(pending.m_Readback);
+		CompleteReadback(readback, pending.m_IssueTime);
+
+		m_Readbacks.pop_front();
+		return true;
+	}
+}
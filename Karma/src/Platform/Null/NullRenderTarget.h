@@ -0,0 +1,63 @@
+/**
+ * @file NullRenderTarget.h
+ * @brief This file contains NullRenderTarget class, the host memory implementation of RenderTarget for the Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/RenderTarget.h"
+#include "glm/glm.hpp"
+
+#include <deque>
+#include <mutex>
+
+namespace Karma
+{
+	/**
+	 * @brief Render target of the Null backend. Nothing is rasterized, a copied frame is the clear color all over. Keeps the benchmark and
+	 * golden image tooling (request, poll, compare) runnable on machines without a GPU.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullRenderTarget : public RenderTarget
+	{
+	public:
+		/**
+		 * @brief Nothing to allocate up front
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullRenderTarget(const RenderTargetSpecification& specification);
+
+		/**
+		 * @brief Hands out the oldest copy, which is done as soon as it is made
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool PollReadback(RenderTargetReadback& readback) override;
+
+		/**
+		 * @brief Ends the frame of the target, making the copy if one was requested. Called by NullRendererAPI::EndScene.
+		 *
+		 * @param clearColor					The color the frame was cleared with
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Resolve(const glm::vec4& clearColor);
+
+	private:
+		struct PendingReadback
+		{
+			RenderTargetReadback m_Readback;
+			std::chrono::steady_clock::time_point m_IssueTime;
+		};
+
+		// Filled on the render thread, polled on the main one
+		std::mutex m_Mutex;
+		std::deque<PendingReadback> m_Readbacks;
+	};
+}
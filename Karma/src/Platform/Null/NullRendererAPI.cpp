@@ -0,0 +1,171 @@
+#include "NullRendererAPI.h"
+#include "NullVertexArray.h"
+#include "NullUniformBufferRing.h"
+#include "NullRenderTarget.h"
+
+namespace Karma
+{
+	NullRHIStatistics NullRendererAPI::s_Statistics;
+
+	NullRendererAPI::NullRendererAPI() : m_bInScene(false), m_bInPass(false), m_CurrentPass(RenderPassType::Opaque), m_BoundVertexArray(nullptr), m_BoundShader(nullptr)
+	{
+		m_UniformRing = new NullUniformBufferRing(RingBufferType::Uniform, s_UniformRingBytesPerFrame, s_UniformRingFrames);
+
+		KR_CORE_INFO("Null renderer in use, no GPU work will be done");
+	}
+
+	NullRendererAPI::~NullRendererAPI()
+	{
+		delete m_UniformRing;
+		m_UniformRing = nullptr;
+
+		KR_CORE_INFO("Null renderer: {0} frames, {1} draws, {2} triangles, {3} bytes uploaded, {4} state changes", s_Statistics.m_NumberOfFrames,
+			s_Statistics.m_NumberOfDrawCalls, s_Statistics.m_NumberOfTriangles, s_Statistics.m_BytesUploaded, s_Statistics.m_NumberOfStateChanges);
+
+		uint32_t liveResources = s_Statistics.m_LiveVertexBuffers + s_Statistics.m_LiveIndexBuffers + s_Statistics.m_LiveUniformBuffers +
+			s_Statistics.m_LiveVertexArrays + s_Statistics.m_LiveShaders;
+
+		if (liveResources > 0)
+		{
+			KR_CORE_WARN("Null renderer: {0} resource(s) still alive ({1} vertex buffers, {2} index buffers, {3} uniform buffers, {4} vertex arrays, {5} shaders)",
+				liveResources, s_Statistics.m_LiveVertexBuffers, s_Statistics.m_LiveIndexBuffers, s_Statistics.m_LiveUniformBuffers,
+				s_Statistics.m_LiveVertexArrays, s_Statistics.m_LiveShaders);
+		}
+	}
+
+	void NullRendererAPI::SetClearColor(const glm::vec4& color)
+	{
+		if (color != m_ClearColor)
+		{
+			m_ClearColor = color;
+			s_Statistics.m_NumberOfStateChanges++;
+		}
+	}
+
+	void NullRendererAPI::BeginScene()
+	{
+		KR_CORE_ASSERT(!m_bInScene, "NullRendererAPI: BeginScene called twice without EndScene");
+
+		m_bInScene = true;
+	}
+
+	void NullRendererAPI::DrawIndexed(std::shared_ptr<VertexArray> vertexArray)
+	{
+		uint32_t indexCount = ValidateAndBind(vertexArray);
+
+		s_Statistics.m_NumberOfDrawCalls++;
+		s_Statistics.m_NumberOfInstances++;
+		s_Statistics.m_NumberOfTriangles += indexCount / 3;
+
+		if (m_bInPass)
+		{
+			s_Statistics.m_NumberOfPassDrawCalls[uint32_t(m_CurrentPass)]++;
+		}
+	}
+
+	void NullRendererAPI::DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount)
+	{
+		KR_CORE_ASSERT(worldMatrices != nullptr || instanceCount == 0, "NullRendererAPI: instanced draw without world matrices");
+
+		std::shared_ptr<Shader> shader = static_cast<NullVertexArray*>(vertexArray.get())->GetShader();
+
+		if (shader == nullptr || !shader->SupportsInstancing())
+		{
+			RendererAPI::DrawIndexedInstanced(vertexArray, worldMatrices, instanceCount);
+			return;
+		}
+
+		uint32_t indexCount = ValidateAndBind(vertexArray);
+
+		s_Statistics.m_NumberOfDrawCalls++;
+		s_Statistics.m_NumberOfInstances += instanceCount;
+		s_Statistics.m_NumberOfTriangles += uint64_t(indexCount / 3) * instanceCount;
+		s_Statistics.m_BytesUploaded += uint64_t(instanceCount) * sizeof(glm::mat4);
+
+		if (m_bInPass)
+		{
+			s_Statistics.m_NumberOfPassDrawCalls[uint32_t(m_CurrentPass)]++;
+		}
+	}
+
+	uint32_t NullRendererAPI::ValidateAndBind(const std::shared_ptr<VertexArray>& vertexArray)
+	{
+		KR_CORE_ASSERT(m_bInScene, "NullRendererAPI: draw outside BeginScene/EndScene");
+		KR_CORE_ASSERT(vertexArray != nullptr, "NullRendererAPI: null vertex array");
+		KR_CORE_ASSERT(vertexArray->GetIndexBuffer() != nullptr, "NullRendererAPI: vertex array without index buffer");
+		KR_CORE_ASSERT(vertexArray->GetVertexBuffers().size(), "NullRendererAPI: vertex array without vertex buffer");
+
+		uint32_t indexCount = vertexArray->GetIndexBuffer()->GetCount();
+		KR_CORE_ASSERT(indexCount % 3 == 0, "NullRendererAPI: index count isn't a multiple of 3 (triangle list)");
+
+		if (vertexArray.get() != m_BoundVertexArray)
+		{
+			m_BoundVertexArray = vertexArray.get();
+			s_Statistics.m_NumberOfStateChanges++;
+		}
+
+		const void* shader = static_cast<NullVertexArray*>(vertexArray.get())->GetShader().get();
+		if (shader != m_BoundShader)
+		{
+			m_BoundShader = shader;
+			s_Statistics.m_NumberOfStateChanges++;
+		}
+
+		return indexCount;
+	}
+
+	void NullRendererAPI::BeginPass(RenderPassType pass)
+	{
+		KR_CORE_ASSERT(m_bInScene, "NullRendererAPI: pass outside BeginScene/EndScene");
+		KR_CORE_ASSERT(!m_bInPass, "NullRendererAPI: BeginPass called twice without EndPass");
+
+		m_bInPass = true;
+		m_CurrentPass = pass;
+	}
+
+	void NullRendererAPI::EndPass()
+	{
+		KR_CORE_ASSERT(m_bInPass, "NullRendererAPI: EndPass without BeginPass");
+
+		m_bInPass = false;
+	}
+
+	void NullRendererAPI::EndScene()
+	{
+		KR_CORE_ASSERT(m_bInScene, "NullRendererAPI: EndScene without BeginScene");
+		KR_CORE_ASSERT(!m_bInPass, "NullRendererAPI: EndScene within a pass");
+
+		if (m_RenderTarget)
+		{
+			static_cast<NullRenderTarget*>(m_RenderTarget)->Resolve(m_ClearColor);
+		}
+
+		m_bInScene = false;
+	}
+
+	void NullRendererAPI::EndFrame()
+	{
+		m_UniformRing->BeginFrame();
+
+		// Like the GPU backends, nothing stays bound across frames
+		m_BoundVertexArray = nullptr;
+		m_BoundShader = nullptr;
+
+		s_Statistics.m_NumberOfFrames++;
+	}
+
+	void NullRendererAPI::ResetStatistics()
+	{
+		s_Statistics.m_NumberOfDrawCalls = 0;
+		s_Statistics.m_NumberOfInstances = 0;
+		s_Statistics.m_NumberOfTriangles = 0;
+		s_Statistics.m_BytesUploaded = 0;
+		s_Statistics.m_NumberOfStateChanges = 0;
+		s_Statistics.m_NumberOfFrames = 0;
+
+		for (uint64_t& passDrawCalls : s_Statistics.m_NumberOfPassDrawCalls)
+		{
+			passDrawCalls = 0;
+		}
+	}
+}
@@ -0,0 +1,278 @@
+/**
+ * @file NullRendererAPI.h
+ * @brief This file contains NullRendererAPI class, a headless renderer which validates and counts but submits nothing to a GPU.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/RendererAPI.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class NullUniformBufferRing;
+
+	/**
+	 * @brief Counters gathered by the Null backend. Everything the GPU backends would have done shows up here, so the CPU side of the renderer
+	 * can be measured (and regressions caught) on machines without a GPU or a display.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API NullRHIStatistics
+	{
+		/**
+		 * @brief Number of draw calls (a DrawIndexed, or an instanced draw of many instances, counts one)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfDrawCalls = 0;
+
+		/**
+		 * @brief Number of instances drawn (one per DrawIndexed, instanceCount per instanced draw)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfInstances = 0;
+
+		/**
+		 * @brief Number of triangles the draw calls would have rasterized
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfTriangles = 0;
+
+		/**
+		 * @brief Bytes of vertex, index, uniform and image data handed to the backend
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_BytesUploaded = 0;
+
+		/**
+		 * @brief Number of binds (vertex array, shader) and clear state changes which differ from the present state
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfStateChanges = 0;
+
+		/**
+		 * @brief Number of frames presented (NullContext::SwapBuffers)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfFrames = 0;
+
+		/**
+		 * @brief Live vertex buffers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LiveVertexBuffers = 0;
+
+		/**
+		 * @brief Live index buffers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LiveIndexBuffers = 0;
+
+		/**
+		 * @brief Live uniform buffer objects
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LiveUniformBuffers = 0;
+
+		/**
+		 * @brief Live vertex arrays
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LiveVertexArrays = 0;
+
+		/**
+		 * @brief Live shaders
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LiveShaders = 0;
+
+		/**
+		 * @brief Number of images (textures) created
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfImages = 0;
+
+		/**
+		 * @brief Bytes of the mips of the streamed textures (NullStreamedTexture) in memory
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ResidentTextureBytes = 0;
+
+		/**
+		 * @brief Number of draw calls of each pass (indexed by RenderPassType), draws outside a pass are not counted here
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfPassDrawCalls[s_NumberOfRenderPasses] = {};
+	};
+
+	/**
+	 * @brief Headless implementation of RendererAPI. Arguments are validated (KR_CORE_ASSERT) just like the GPU backends would choke on them,
+	 * resources are tracked and the work is counted in NullRHIStatistics, but no GPU (or window) is ever touched.
+	 *
+	 * Selected with --renderer=null on the command line (or KARMA_RENDERER=null in the environment).
+	 *
+	 * @see CommandLine
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullRendererAPI : public RendererAPI
+	{
+	public:
+		/**
+		 * @brief Constructor. Creates the (host memory) uniform ring.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullRendererAPI();
+
+		/**
+		 * @brief Destructor. Deletes the uniform ring and reports the resources which are still alive.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullRendererAPI();
+
+		/**
+		 * @brief Records the clear color, counting a state change if it differs
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetClearColor(const glm::vec4& color) override;
+
+		/**
+		 * @brief Nothing to clear
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void Clear() override {}
+
+		/**
+		 * @brief Marks the beginning of the scene, draws are accepted only within BeginScene and EndScene
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginScene() override;
+
+		/**
+		 * @brief Validates the vertex array (index buffer and material) and counts the draw, triangles and binds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexed(std::shared_ptr<VertexArray> vertexArray) override;
+
+		/**
+		 * @brief Counts one draw of instanceCount instances (and the world matrices as uploaded bytes) for shaders which read the per
+		 * instance matrix, like the GPU backends would issue. Other shaders get a draw per instance.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount) override;
+
+		/**
+		 * @brief Starts counting the draws for the pass. Passes don't nest and belong within BeginScene and EndScene.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginPass(RenderPassType pass) override;
+
+		/**
+		 * @brief Ends the pass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndPass() override;
+
+		/**
+		 * @brief Every pass is accepted (and counted)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsDepthPrePass() const override { return true; }
+
+		/**
+		 * @brief Every format is accepted (and its bytes counted)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsTextureFormat(TextureFormat format) const override { return true; }
+
+		/**
+		 * @brief Marks the end of the scene, and of the frame of the render target if one is set (NullRenderTarget::Resolve)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndScene() override;
+
+		/**
+		 * @brief Counts the frame and advances the uniform ring. Called by NullContext::SwapBuffers, headless tools without a window should call
+		 * it once per frame themselves.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void EndFrame();
+
+		/**
+		 * @brief Getter for the uniform ring in which NullUniformBuffer writes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullUniformBufferRing* GetUniformRing() const { return m_UniformRing; }
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static NullRHIStatistics& GetStatistics() { return s_Statistics; }
+
+		/**
+		 * @brief Zeroes the work counters (draws, triangles, bytes, state changes and frames). The live resource counts are kept.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ResetStatistics();
+
+	private:
+		/**
+		 * @brief Validates the vertex array and counts the binds which differ from the present ones
+		 *
+		 * @return Number of indices of the vertex array
+		 * @since Karma 1.0.0
+		 */
+		uint32_t ValidateAndBind(const std::shared_ptr<VertexArray>& vertexArray);
+
+	private:
+		NullUniformBufferRing* m_UniformRing;
+
+		bool m_bInScene;
+
+		bool m_bInPass;
+		RenderPassType m_CurrentPass;
+
+		// What is "bound" presently, for counting state changes
+		const VertexArray* m_BoundVertexArray;
+		const void* m_BoundShader;
+
+		static NullRHIStatistics s_Statistics;
+
+		static constexpr uint32_t s_UniformRingBytesPerFrame = 256 * 1024;
+		static constexpr uint32_t s_UniformRingFrames = 2;
+	};
+}
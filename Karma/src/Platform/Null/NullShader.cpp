@@ -0,0 +1,43 @@
+#include "NullShader.h"
+#include "NullRendererAPI.h"
+#include "Karma/KarmaUtilities.h"
+
+namespace Karma
+{
+	NullShader::NullShader(const std::string& vertexSrc, const std::string& fragmentSrc) : Shader(nullptr)
+	{
+		KR_CORE_ASSERT(!vertexSrc.empty() && !fragmentSrc.empty(), "NullShader: empty shader source");
+
+		m_ShaderName = "NoNamedShader";
+
+		NullRendererAPI::GetStatistics().m_LiveShaders++;
+	}
+
+	NullShader::NullShader(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, std::shared_ptr<UniformBufferObject> ubo,
+		const std::string& shaderName) : Shader(ubo)
+	{
+		KR_CORE_ASSERT(ubo != nullptr, "NullShader: no uniform buffer object");
+
+		for (const std::string& sourceFile : { vertexSrcFile, fragmentSrcFile })
+		{
+			if (!std::filesystem::exists(sourceFile))
+			{
+				KR_CORE_ERROR("NullShader: shader source {0} not found", sourceFile);
+			}
+		}
+
+		m_ShaderName = shaderName;
+
+		if (std::filesystem::exists(vertexSrcFile))
+		{
+			m_bSupportsInstancing = DeclaresInstanceTransform(KarmaUtilities::ReadFileToSpitString(vertexSrcFile));
+		}
+
+		NullRendererAPI::GetStatistics().m_LiveShaders++;
+	}
+
+	NullShader::~NullShader()
+	{
+		NullRendererAPI::GetStatistics().m_LiveShaders--;
+	}
+}
@@ -0,0 +1,52 @@
+/**
+ * @file NullShader.h
+ * @brief This file contains NullShader class of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/Shader.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Null backend's shader. The sources are checked to be present, nothing is compiled.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullShader : public Shader
+	{
+	public:
+		/**
+		 * @brief Constructor for shaders supplied as source strings (legacy)
+		 *
+		 * @param vertexSrc						Source of the vertex shader
+		 * @param fragmentSrc					Source of the fragment shader
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullShader(const std::string& vertexSrc, const std::string& fragmentSrc);
+
+		/**
+		 * @brief Constructor for shaders supplied as files
+		 *
+		 * @param vertexSrcFile					Path to the vertex shader
+		 * @param fragmentSrcFile				Path to the fragment shader
+		 * @param ubo							The uniform buffer object the shader reads
+		 * @param shaderName					Name of the shader
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullShader(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, std::shared_ptr<UniformBufferObject> ubo,
+			const std::string& shaderName);
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullShader();
+	};
+}
@@ -0,0 +1,49 @@
+#include "NullStreamedTexture.h"
+#include "NullRendererAPI.h"
+
+namespace Karma
+{
+	NullStreamedTexture::NullStreamedTexture(uint32_t width, uint32_t height, TextureFormat format) : StreamedTexture(width, height, format),
+		m_ResidentBytes(0)
+	{
+		KR_CORE_ASSERT(width > 0 && height > 0, "NullStreamedTexture: empty texture");
+
+		NullRendererAPI::GetStatistics().m_NumberOfImages++;
+	}
+
+	NullStreamedTexture::~NullStreamedTexture()
+	{
+		NullRendererAPI::GetStatistics().m_ResidentTextureBytes -= m_ResidentBytes;
+	}
+
+	void NullStreamedTexture::UploadMip(uint32_t mip, const uint8_t* pixels)
+	{
+		KR_CORE_ASSERT(pixels != nullptr, "NullStreamedTexture: no pixels");
+		KR_CORE_ASSERT(mip + 1 == m_FirstResidentMip || (m_FirstResidentMip == m_NumberOfMips && mip == m_NumberOfMips - 1),
+			"Mips are streamed in from the smallest up");
+
+		const uint64_t size = GetMipSize(m_Format, m_Width, m_Height, mip);
+
+		NullRHIStatistics& statistics = NullRendererAPI::GetStatistics();
+		statistics.m_BytesUploaded += size;
+		statistics.m_ResidentTextureBytes += size;
+
+		m_ResidentBytes += size;
+		m_FirstResidentMip = mip;
+	}
+
+	void NullStreamedTexture::Evict(uint32_t firstMip)
+	{
+		for (; m_FirstResidentMip < firstMip && m_FirstResidentMip < m_NumberOfMips; m_FirstResidentMip++)
+		{
+			const uint64_t size = GetMipSize(m_Format, m_Width, m_Height, m_FirstResidentMip);
+
+			NullRendererAPI::GetStatistics().m_ResidentTextureBytes -= size;
+			m_ResidentBytes -= size;
+		}
+	}
+
+	void NullStreamedTexture::Bind(uint32_t unit) const
+	{
+	}
+}
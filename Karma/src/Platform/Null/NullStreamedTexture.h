@@ -0,0 +1,33 @@
+/**
+ * @file NullStreamedTexture.h
+ * @brief This file contains the NullStreamedTexture class of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/StreamedTexture.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Null backend's streamed texture. Validates the order of the uploads and counts the bytes (NullRHIStatistics), so that the
+	 * TextureStreamer can be run and measured headless.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullStreamedTexture : public StreamedTexture
+	{
+	public:
+		NullStreamedTexture(uint32_t width, uint32_t height, TextureFormat format);
+		virtual ~NullStreamedTexture() override;
+
+		virtual void UploadMip(uint32_t mip, const uint8_t* pixels) override;
+		virtual void Evict(uint32_t firstMip) override;
+		virtual void Bind(uint32_t unit) const override;
+
+	private:
+		uint64_t m_ResidentBytes;
+	};
+}
@@ -0,0 +1,13 @@
+#include "NullUniformBufferRing.h"
+
+namespace Karma
+{
+	NullUniformBufferRing::NullUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames) :
+		UniformBufferRing(type, bytesPerFrame, numberOfFrames)
+	{
+		m_Alignment = s_Alignment;
+
+		m_HostData.resize(GetTotalSize());
+		m_MappedData = m_HostData.data();
+	}
+}
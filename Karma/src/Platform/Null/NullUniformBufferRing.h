@@ -0,0 +1,43 @@
+/**
+ * @file NullUniformBufferRing.h
+ * @brief This file contains NullUniformBufferRing class, the host memory implementation of UniformBufferRing for the Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/UniformBufferRing.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Uniform (or storage) ring living in host memory. The packing, deduplication and alignment work of UniformBufferRing is done as
+	 * with the GPU backends, only nothing is copied anywhere afterwards.
+	 *
+	 * @see NullUniformBuffer::UploadUniformBuffer
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullUniformBufferRing : public UniformBufferRing
+	{
+	public:
+		/**
+		 * @brief Allocates the host memory
+		 *
+		 * @param type							Uniform or storage data
+		 * @param bytesPerFrame					Size (in bytes) of the region available to each frame
+		 * @param numberOfFrames				Number of regions (frames) the buffer is split into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames);
+
+	private:
+		std::vector<uint8_t> m_HostData;
+
+		// Typical of discrete GPUs, so that the offsets (and the overflow behaviour) resemble the real backends
+		static constexpr uint32_t s_Alignment = 256;
+	};
+}
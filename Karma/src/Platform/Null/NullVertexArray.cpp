@@ -0,0 +1,74 @@
+#include "NullVertexArray.h"
+#include "NullRendererAPI.h"
+
+namespace Karma
+{
+	NullVertexArray::NullVertexArray()
+	{
+		NullRendererAPI::GetStatistics().m_LiveVertexArrays++;
+	}
+
+	NullVertexArray::~NullVertexArray()
+	{
+		NullRendererAPI::GetStatistics().m_LiveVertexArrays--;
+	}
+
+	void NullVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
+	{
+		KR_CORE_ASSERT(vertexBuffer != nullptr, "NullVertexArray: null vertex buffer");
+		KR_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBufferLayout empty.");
+
+		m_VertexBuffers.push_back(vertexBuffer);
+	}
+
+	void NullVertexArray::SetIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer)
+	{
+		KR_CORE_ASSERT(indexBuffer != nullptr, "NullVertexArray: null index buffer");
+
+		m_IndexBuffer = indexBuffer;
+	}
+
+	void NullVertexArray::SetShader(std::shared_ptr<Shader> shader)
+	{
+		KR_CORE_ASSERT(shader != nullptr, "NullVertexArray: null shader");
+
+		m_Shader = shader;
+	}
+
+	void NullVertexArray::SetMesh(std::shared_ptr<Mesh> mesh)
+	{
+		KR_CORE_ASSERT(mesh != nullptr, "NullVertexArray: null mesh");
+
+		AddVertexBuffer(mesh->GetVertexBuffer());
+		SetIndexBuffer(mesh->GetIndexBuffer());
+
+		TrackMesh(mesh);
+	}
+
+	void NullVertexArray::SetMaterial(std::shared_ptr<Material> material)
+	{
+		KR_CORE_ASSERT(material != nullptr, "NullVertexArray: null material");
+
+		m_Materials.push_back(material);
+		m_Shader = material->GetShader(0);
+
+		TrackMaterial(material);
+	}
+
+	void NullVertexArray::OnAssetsReloaded()
+	{
+		if (GetMesh())
+		{
+			m_VertexBuffers.clear();
+			SetMesh(GetMesh());
+		}
+	}
+
+	void NullVertexArray::UpdateProcessAndSetReadyForSubmission() const
+	{
+		KR_CORE_ASSERT(m_Materials.size(), "NullVertexArray: no material set");
+
+		m_Materials.at(0)->OnUpdate();
+		m_Materials.at(0)->ProcessForSubmission();
+	}
+}
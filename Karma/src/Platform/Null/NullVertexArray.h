@@ -0,0 +1,100 @@
+/**
+ * @file NullVertexArray.h
+ * @brief This file contains NullVertexArray class of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/VertexArray.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Null backend's vertex array. Holds the buffers and materials like the GPU backends, validating the layouts, and runs the material
+	 * update (uniform packing) on submission.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API NullVertexArray : public VertexArray
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullVertexArray();
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullVertexArray();
+
+		virtual void Bind() const override {}
+
+		virtual void UnBind() const override {}
+
+		// For legacy purposes. Use Mesh abstraction
+
+		virtual void AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer) override;
+		virtual void SetIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer) override;
+		// Use Material abstraction
+		virtual void SetShader(std::shared_ptr<Shader> shader) override;
+
+		// End legacy functions
+
+		/**
+		 * @brief Sets the vertex and index buffers of the mesh, asserting that the layout is not empty
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetMesh(std::shared_ptr<Mesh> mesh) override;
+
+		/**
+		 * @brief Adds the material, the first shader of the material becomes the shader of the vertex array
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetMaterial(std::shared_ptr<Material> material) override;
+
+		virtual const std::vector<std::shared_ptr<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
+
+		virtual const IndexBuffer* GetIndexBuffer() const override { return m_IndexBuffer.get(); }
+
+		virtual std::shared_ptr<Material> GetMaterial() const override { return m_Materials.at(0); }
+
+		/**
+		 * @brief Getter for the shader, used by NullRendererAPI for counting shader changes
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<Shader> GetShader() const { return m_Shader; }
+
+		/**
+		 * @brief Updates the material and uploads the uniforms (into NullRendererAPI's uniform ring)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void UpdateProcessAndSetReadyForSubmission() const override;
+
+	protected:
+		/**
+		 * @brief Takes the buffers of the mesh again
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void OnAssetsReloaded() override;
+
+	private:
+		std::vector<std::shared_ptr<VertexBuffer>> m_VertexBuffers;
+		std::shared_ptr<IndexBuffer> m_IndexBuffer;
+
+		// Material relevant members
+		std::vector<std::shared_ptr<Material>> m_Materials;
+		std::shared_ptr<Shader> m_Shader;
+	};
+}
@@ -0,0 +1,52 @@
+#include "NullWindow.h"
+#include "NullContext.h"
+#include "Karma/CommandLine.h"
+
+namespace Karma
+{
+	uint64_t NullWindow::s_FrameLimit = 0;
+
+	static CommandLineOption s_FramesOption("frames", "--frames=N ends the run after N frames (Null renderer)",
+		[](const std::string& value) { NullWindow::SetFrameLimit(CommandLine::ParseNumber(value, 0)); });
+
+	NullWindow::NullWindow(const WindowProps& props) : m_NumberOfFrames(0)
+	{
+		m_Data.Title = props.Title;
+		m_Data.Width = props.Width;
+		m_Data.Height = props.Height;
+		m_Data.VSync = false;
+
+		KR_CORE_INFO("Creating Null window {0} ({1}, {2})", props.Title, props.Width, props.Height);
+
+		m_Context = new NullContext();
+		m_Context->Init();
+	}
+
+	NullWindow::~NullWindow()
+	{
+		delete m_Context;
+		m_Context = nullptr;
+	}
+
+	void NullWindow::OnUpdate()
+	{
+		m_Context->SwapBuffers();
+		m_NumberOfFrames++;
+
+		if (s_FrameLimit > 0 && m_NumberOfFrames == s_FrameLimit && m_Data.EventCallback)
+		{
+			KR_CORE_INFO("Null window: frame limit ({0}) reached", s_FrameLimit);
+
+			WindowCloseEvent event;
+			m_Data.EventCallback(event);
+		}
+	}
+
+	bool NullWindow::OnResize(WindowResizeEvent& event)
+	{
+		m_Data.Width = event.GetWidth();
+		m_Data.Height = event.GetHeight();
+
+		return m_Context->OnWindowResize(event);
+	}
+}
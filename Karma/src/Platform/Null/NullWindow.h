@@ -0,0 +1,98 @@
+/**
+ * @file NullWindow.h
+ * @brief This file contains NullWindow class, the windowless Window of the headless Null backend.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Window.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class GraphicsContext;
+
+	/**
+	 * @brief Window used with RendererAPI::API::Null. No display (or GLFW) is needed, so the Application runs on servers and CI machines.
+	 * Optionally the window "closes" itself after a number of frames (--frames=N on the command line), to have a terminating run.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class NullWindow : public Window
+	{
+	public:
+		/**
+		 * @brief Constructor. Creates the NullContext.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		NullWindow(const WindowProps& props);
+
+		/**
+		 * @brief Destructor
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~NullWindow();
+
+		/**
+		 * @brief Presents the frame (NullContext::SwapBuffers) and dispatches WindowCloseEvent once the frame limit is reached
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void OnUpdate() override;
+
+		virtual bool OnResize(WindowResizeEvent& event) override;
+
+		inline unsigned int GetWidth() const override { return m_Data.Width; }
+
+		inline unsigned int GetHeight() const override { return m_Data.Height; }
+
+		inline void SetEventCallback(const EventCallbackFn& callback) override
+		{
+			m_Data.EventCallback = callback;
+		}
+
+		/**
+		 * @brief There is no native window
+		 *
+		 * @since Karma 1.0.0
+		 */
+		inline virtual void* GetNativeWindow() const override { return nullptr; }
+
+		void SetVSync(bool enabled) override { m_Data.VSync = enabled; }
+
+		bool IsVSync() const override { return m_Data.VSync; }
+
+		/**
+		 * @brief Sets the number of frames after which the window asks the Application to close, 0 for running indefinitely
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetFrameLimit(uint64_t frameLimit) { s_FrameLimit = frameLimit; }
+
+	private:
+		GraphicsContext* m_Context;
+
+		uint64_t m_NumberOfFrames;
+
+		struct WindowData
+		{
+			std::string Title;
+			unsigned int Width, Height;
+
+			bool VSync;
+
+			EventCallbackFn EventCallback;
+		};
+
+		WindowData m_Data;
+
+		static uint64_t s_FrameLimit;
+	};
+}
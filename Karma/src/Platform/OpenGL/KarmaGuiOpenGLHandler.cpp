@@ -7,6 +7,7 @@
 
 // Experimental
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 #if defined(_MSC_VER) && _MSC_VER <= 1500 // MSVC 2008 or earlier
 #include <stddef.h>     // intptr_t
@@ -220,6 +221,9 @@ namespace Karma
 		glVertexAttribPointer(bd->AttribLocationVtxPos, 2, GL_FLOAT, GL_FALSE, sizeof(KGDrawVert), (GLvoid*)KG_OFFSETOF(KGDrawVert, pos));
 		glVertexAttribPointer(bd->AttribLocationVtxUV, 2, GL_FLOAT, GL_FALSE, sizeof(KGDrawVert), (GLvoid*)KG_OFFSETOF(KGDrawVert, uv));
 		glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(KGDrawVert), (GLvoid*)KG_OFFSETOF(KGDrawVert, col));
+
+		// Program, vertex array and texture were bound behind the state cache's back
+		OpenGLStateCache::Invalidate();
 	}
 
 	// OpenGL3 Render function.
@@ -356,7 +360,7 @@ namespace Karma
 
 							// A very experimental hack
 							OpenGLImageBuffer::BindTexture();
-							glDrawElements(GL_TRIANGLES, openGLVA->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+							glDrawElements(GL_TRIANGLES, openGLVA->GetIndexBuffer()->GetCount(), OpenGLIndexBuffer::GetGLIndexType(openGLVA->GetIndexBuffer()), nullptr);
 						}
 						KarmaGuiOpenGLHandler::KarmaGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
 					}
@@ -424,6 +428,9 @@ namespace Karma
 		glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
 		glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
 		(void)bd; // Not all compilation paths use this
+
+		// The restored bindings aren't known to the state cache either
+		OpenGLStateCache::Invalidate();
 	}
 
 	bool KarmaGuiOpenGLHandler::KarmaGui_ImplOpenGL3_CreateFontsTexture()
@@ -2,6 +2,9 @@
 #include "glad/glad.h"
 
 #include "Karma/KarmaUtilities.h"
+#include "OpenGLContext.h"
+#include "OpenGLUniformBufferRing.h"
+#include "OpenGLStateCache.h"
 
 namespace Karma
 {
@@ -40,7 +43,7 @@ namespace Karma
 	// IndexBuffer
 
 	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count)
-		: m_Count(count)
+		: m_Count(count), m_IndexType(IndexType::UInt32)
 	{
 		//glCreateBuffers(1, &m_RendererID);
 		glGenBuffers(1, &m_RendererID);
@@ -49,6 +52,20 @@ namespace Karma
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint16_t* indices, uint32_t count)
+		: m_Count(count), m_IndexType(IndexType::UInt16)
+	{
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		// Upload to GPU
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), indices, GL_STATIC_DRAW);
+	}
+
+	uint32_t OpenGLIndexBuffer::GetGLIndexType(const IndexBuffer* indexBuffer)
+	{
+		return indexBuffer->GetIndexType() == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
 		glDeleteBuffers(1, &m_RendererID);
@@ -71,7 +88,7 @@ namespace Karma
 		// Load and create a texture. Need proper texture loading abstraction
 		//unsigned int texture1;
 		glGenTextures(1, &m_ImageBufferID);
-		glBindTexture(GL_TEXTURE_2D, m_ImageBufferID);
+		OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, m_ImageBufferID);
 		// set the texture wrapping parameters
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -101,48 +118,28 @@ namespace Karma
 
 	void OpenGLImageBuffer::BindTexture()
 	{
-		glBindTexture(GL_TEXTURE_2D, m_ImageBufferID);
+		OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, m_ImageBufferID);
 	}
 
 	OpenGLUniformBuffer::OpenGLUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex) :
 		UniformBufferObject(dataTypes, bindingPointIndex)
 	{
-		GenerateUniformBufferObject();
-		BindUniformBufferObject();
 	}
 
 	OpenGLUniformBuffer::~OpenGLUniformBuffer()
 	{
-		glDeleteBuffers(1, &m_UniformsID);
 	}
 
-	void OpenGLUniformBuffer::GenerateUniformBufferObject()
+	void OpenGLUniformBuffer::UploadUniformBuffer(size_t frameIndex)
 	{
-		//glCreateBuffers(1, &m_UniformsID);
-		glGenBuffers(1, &m_UniformsID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_UniformsID);
-	}
+		OpenGLUniformBufferRing* uniformRing = OpenGLContext::GetUniformRing();
 
-	void OpenGLUniformBuffer::BindUniformBufferObject() const
-	{
-		glBindBuffer(GL_UNIFORM_BUFFER, m_UniformsID);
-		glBufferData(GL_UNIFORM_BUFFER, GetBufferSize(), NULL, GL_STATIC_DRAW);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
-	}
+		m_RingOffset = uniformRing->PushUniforms(*this);
 
-	void OpenGLUniformBuffer::UploadUniformBuffer(size_t frameIndex)
-	{
-		uint32_t index = 0;
-		for (auto it : GetUniformList())
+		// Otherwise the draw is skipped, see RenderCommand::DrawIndexed
+		if (m_RingOffset != UniformBufferRing::s_InvalidOffset)
 		{
-			uint32_t uniformSize = GetUniformSize()[index];
-			uint32_t offset = GetAlignedOffsets()[index++];
-
-			glBindBuffer(GL_UNIFORM_BUFFER, GetUniformsID());
-			glBufferSubData(GL_UNIFORM_BUFFER, offset, uniformSize, it.GetDataPointer());
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			uniformRing->BindRange(GetBindingPointIndex(), m_RingOffset, GetBufferSize());
 		}
-
-		glBindBufferRange(GL_UNIFORM_BUFFER, GetBindingPointIndex(), GetUniformsID(), 0, GetBufferSize());
 	}
 };
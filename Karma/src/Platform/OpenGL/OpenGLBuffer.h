@@ -108,6 +108,16 @@ namespace Karma
 		 */
 		OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
 
+		/**
+		 * @brief Constructor for 16 bit indices (drawn with GL_UNSIGNED_SHORT)
+		 *
+		 * @param indices						The indices
+		 * @param count							Number of indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLIndexBuffer(uint16_t* indices, uint32_t count);
+
 		/**
 		 * @brief Deletes the buffers and cleans up
 		 *
@@ -137,9 +147,24 @@ namespace Karma
 		 */
 		virtual uint32_t GetCount() const override { return m_Count; }
 
+		/**
+		 * @brief Width of the indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual IndexType GetIndexType() const override { return m_IndexType; }
+
+		/**
+		 * @brief The type glDrawElements reads the indices of indexBuffer with
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetGLIndexType(const IndexBuffer* indexBuffer);
+
 	private:
 		uint32_t m_RendererID;
 		uint32_t m_Count;
+		IndexType m_IndexType;
 	};
 
 	/**
@@ -177,8 +202,7 @@ namespace Karma
 	{
 	public:
 		/**
-		 * @brief Constructor
-		 * Generate the buffers for uniforms and bind them
+		 * @brief Constructor. The buffer itself is OpenGLContext's uniform ring (see OpenGLUniformBufferRing), so no buffer is generated here.
 		 *
 		 * @param dataTypes								The vector of ShaderDataType. See \ref UniformBufferObject::Create for information
 		 *
@@ -187,42 +211,17 @@ namespace Karma
 		OpenGLUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex);
 
 		/**
-		 * @brief Getter for the uniform id
-		 *
-		 * @since Karma 1.0.0
-		 */
-		uint32_t GetUniformsID() const { return m_UniformsID; }
-
-		/**
-		 * @brief Delete the buffers and clean up the resources appropriately
+		 * @brief Destructor
 		 *
 		 * @since Karma 1.0.0
 		 */
 		virtual ~OpenGLUniformBuffer();
 
 		/**
-		 * @brief Upload the uniform to GPU
+		 * @brief Writes the uniforms into the uniform ring and binds the written range (glBindBufferRange) to the binding point
 		 *
 		 * @since Karma 1.0.0
 		 */
 		virtual void UploadUniformBuffer(size_t frameIndex) override;
-
-	private:
-		/**
-		 * @brief Generate the uniform buffers
-		 *
-		 * @since Karma 1.0.0
-		 */
-		void GenerateUniformBufferObject();
-
-		/**
-		 * @brief Bind the buffer objects
-		 *
-		 * @since Karma 1.0.0
-		 */
-		void BindUniformBufferObject() const;
-
-	private:
-		uint32_t m_UniformsID;
 	};
 }
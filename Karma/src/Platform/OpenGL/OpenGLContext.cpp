@@ -2,15 +2,42 @@
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 #include "Karma/Core.h"
+#include "OpenGLUniformBufferRing.h"
+#include "OpenGLGPUProfiler.h"
 
 namespace Karma
 {
+	OpenGLUniformBufferRing* OpenGLContext::s_UniformRing = nullptr;
+	OpenGLUniformBufferRing* OpenGLContext::s_InstanceRing = nullptr;
+	OpenGLGPUProfiler* OpenGLContext::s_GPUProfiler = nullptr;
+
 	OpenGLContext::OpenGLContext(GLFWwindow* windowHandle)
 		: m_windowHandle(windowHandle)
 	{
 		KR_CORE_ASSERT(windowHandle, "windowHandle is null");
 	}
 
+	OpenGLContext::~OpenGLContext()
+	{
+		if (s_UniformRing)
+		{
+			delete s_UniformRing;
+			s_UniformRing = nullptr;
+		}
+
+		if (s_InstanceRing)
+		{
+			delete s_InstanceRing;
+			s_InstanceRing = nullptr;
+		}
+
+		if (s_GPUProfiler)
+		{
+			delete s_GPUProfiler;
+			s_GPUProfiler = nullptr;
+		}
+	}
+
 	void OpenGLContext::Init()
 	{
 		glfwMakeContextCurrent(m_windowHandle);
@@ -18,6 +45,11 @@ namespace Karma
 
 		KR_CORE_ASSERT(status, "Failed to initialize Glad");
 		KR_CORE_INFO("Glad initialized with OpenGL version {0}", (const char *) glGetString(GL_VERSION));
+
+		s_UniformRing = new OpenGLUniformBufferRing(RingBufferType::Uniform, s_UniformRingBytesPerFrame, s_UniformRingFrames);
+		s_InstanceRing = new OpenGLUniformBufferRing(RingBufferType::Vertex, s_InstanceRingBytesPerFrame, s_UniformRingFrames);
+
+		s_GPUProfiler = new OpenGLGPUProfiler();
 	}
 
 	// Based on the advice from
@@ -28,6 +60,10 @@ namespace Karma
 		glfwSwapInterval(1);
 		
 		glFinish();
+
+		s_UniformRing->BeginFrame();
+		s_InstanceRing->BeginFrame();
+		s_GPUProfiler->BeginFrame();
 	}
 
 	bool OpenGLContext::OnWindowResize(WindowResizeEvent& event)
@@ -15,6 +15,12 @@ struct GLFWwindow;
 
 namespace Karma
 {
+	/**
+	 * @brief Forward declaration
+	 */
+	class OpenGLUniformBufferRing;
+	class OpenGLGPUProfiler;
+
 	/**
 	 * @brief OpenGL API based implementation of GraphicsContext
 	 *
@@ -34,10 +40,17 @@ namespace Karma
 		 */
 		OpenGLContext(GLFWwindow* windowHandle);
 
+		/**
+		 * @brief Destructor. Deletes the uniform ring.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~OpenGLContext();
+
 		/**
 		 * @brief Initializes the context
 		 *
-		 * Loads Glad
+		 * Loads Glad and creates the uniform ring
 		 *
 		 * @since Karma 1.0.0
 		 */
@@ -47,6 +60,7 @@ namespace Karma
 		 * @brief This function swaps the front and back buffers of the context window. 
 		 *
 		 * @note If the swap interval is greater than zero, the GPU driver waits the specified number of screen updates before swapping the buffers.
+		 * The uniform ring moves to the next frame's region here, and the GPU profiler to its next set of queries.
 		 * @since Karma 1.0.0
 		 */
 		virtual void SwapBuffers() override;
@@ -59,7 +73,42 @@ namespace Karma
 		 */
 		virtual bool OnWindowResize(WindowResizeEvent& event) override;
 
+		/**
+		 * @brief Getter for the persistently mapped ring the uniforms of all the draws are written into
+		 *
+		 * @see OpenGLUniformBuffer::UploadUniformBuffer
+		 * @since Karma 1.0.0
+		 */
+		static OpenGLUniformBufferRing* GetUniformRing() { return s_UniformRing; }
+
+		/**
+		 * @brief Getter for the ring the per instance world matrices of instanced draws are written into
+		 *
+		 * @see OpenGLRendererAPI::DrawIndexedInstanced
+		 * @since Karma 1.0.0
+		 */
+		static OpenGLUniformBufferRing* GetInstanceRing() { return s_InstanceRing; }
+
+		/**
+		 * @brief Getter for the profiler timing the scopes (scene, passes, KarmaGui) of the context
+		 *
+		 * @see GPUProfiler
+		 * @since Karma 1.0.0
+		 */
+		static OpenGLGPUProfiler* GetGPUProfiler() { return s_GPUProfiler; }
+
 	private:
 		GLFWwindow* m_windowHandle;
+
+		static OpenGLUniformBufferRing* s_UniformRing;
+		static OpenGLUniformBufferRing* s_InstanceRing;
+		static OpenGLGPUProfiler* s_GPUProfiler;
+
+		// Room for a few thousand per draw blocks every frame
+		static constexpr uint32_t s_UniformRingBytesPerFrame = 256 * 1024;
+		static constexpr uint32_t s_UniformRingFrames = 3;
+
+		// Per instance world matrices, 16k instances every frame
+		static constexpr uint32_t s_InstanceRingBytesPerFrame = 1024 * 1024;
 	};
 }
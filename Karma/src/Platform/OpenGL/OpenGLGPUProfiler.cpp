@@ -0,0 +1,191 @@
+#include "OpenGLGPUProfiler.h"
+
+namespace Karma
+{
+	OpenGLGPUProfiler::OpenGLGPUProfiler() : m_CurrentFrame(0), m_bStatisticsScopeOpen(false), m_NumberOfDroppedScopes(0)
+	{
+		for (Frame& frame : m_Frames)
+		{
+			glGenQueries(2 * GPUProfiler::s_MaxScopesPerFrame, frame.m_Timestamps);
+
+			if (SupportsPipelineStatistics())
+			{
+				glGenQueries(GPUProfiler::s_MaxScopesPerFrame * s_NumberOfPipelineStatistics, &frame.m_Statistics[0][0]);
+			}
+		}
+
+		// The first frame is recorded before any SwapBuffers
+		m_Frames[0].m_bActive = GPUProfiler::IsEnabled();
+		m_Frames[0].m_bStatisticsActive = m_Frames[0].m_bActive && SupportsPipelineStatistics() && GPUProfiler::IsPipelineStatisticsEnabled();
+	}
+
+	OpenGLGPUProfiler::~OpenGLGPUProfiler()
+	{
+		for (Frame& frame : m_Frames)
+		{
+			glDeleteQueries(2 * GPUProfiler::s_MaxScopesPerFrame, frame.m_Timestamps);
+
+			if (SupportsPipelineStatistics())
+			{
+				glDeleteQueries(GPUProfiler::s_MaxScopesPerFrame * s_NumberOfPipelineStatistics, &frame.m_Statistics[0][0]);
+			}
+		}
+
+		if (m_NumberOfDroppedScopes > 0)
+		{
+			KR_CORE_INFO("OpenGLGPUProfiler: results of {0} scope(s) weren't ready in time and were dropped", m_NumberOfDroppedScopes);
+		}
+	}
+
+	void OpenGLGPUProfiler::BeginFrame()
+	{
+		KR_CORE_ASSERT(m_OpenScopes.empty(), "A GPU scope was left open across frames");
+
+		m_OpenScopes.clear();
+		m_bStatisticsScopeOpen = false;
+
+		m_CurrentFrame = (m_CurrentFrame + 1) % s_QueryFrames;
+
+		Frame& frame = m_Frames[m_CurrentFrame];
+
+		ResolveFrame(frame);
+
+		frame.m_Scopes.clear();
+		frame.m_NumberOfTimestamps = 0;
+		frame.m_NumberOfStatistics = 0;
+		frame.m_bActive = GPUProfiler::IsEnabled();
+		frame.m_bStatisticsActive = frame.m_bActive && SupportsPipelineStatistics() && GPUProfiler::IsPipelineStatisticsEnabled();
+	}
+
+	void OpenGLGPUProfiler::BeginScope(const char* scopeName, bool bPipelineStatistics)
+	{
+		Frame& frame = m_Frames[m_CurrentFrame];
+
+		if (!frame.m_bActive || frame.m_Scopes.size() >= GPUProfiler::s_MaxScopesPerFrame)
+		{
+			m_OpenScopes.push_back(UINT32_MAX);
+			return;
+		}
+
+		Scope scope;
+		scope.m_Name = scopeName;
+		scope.m_BeginQuery = frame.m_NumberOfTimestamps;
+
+		frame.m_NumberOfTimestamps += 2;
+
+		glQueryCounter(frame.m_Timestamps[scope.m_BeginQuery], GL_TIMESTAMP);
+
+		if (bPipelineStatistics && frame.m_bStatisticsActive && !m_bStatisticsScopeOpen)
+		{
+			scope.m_StatisticsQuery = frame.m_NumberOfStatistics++;
+			m_bStatisticsScopeOpen = true;
+
+			for (uint32_t counter = 0; counter < s_NumberOfPipelineStatistics; counter++)
+			{
+				glBeginQuery(s_PipelineStatisticsTargets[counter], frame.m_Statistics[scope.m_StatisticsQuery][counter]);
+			}
+		}
+
+		m_OpenScopes.push_back(uint32_t(frame.m_Scopes.size()));
+		frame.m_Scopes.push_back(scope);
+	}
+
+	void OpenGLGPUProfiler::EndScope()
+	{
+		KR_CORE_ASSERT(!m_OpenScopes.empty(), "EndScope without a BeginScope");
+
+		uint32_t scopeIndex = m_OpenScopes.back();
+		m_OpenScopes.pop_back();
+
+		if (scopeIndex == UINT32_MAX)
+		{
+			return;
+		}
+
+		Frame& frame = m_Frames[m_CurrentFrame];
+		Scope& scope = frame.m_Scopes[scopeIndex];
+
+		if (scope.m_StatisticsQuery != UINT32_MAX)
+		{
+			for (uint32_t counter = 0; counter < s_NumberOfPipelineStatistics; counter++)
+			{
+				glEndQuery(s_PipelineStatisticsTargets[counter]);
+			}
+			m_bStatisticsScopeOpen = false;
+		}
+
+		glQueryCounter(frame.m_Timestamps[scope.m_BeginQuery + 1], GL_TIMESTAMP);
+
+		scope.m_bEnded = true;
+	}
+
+	bool OpenGLGPUProfiler::ReadQuery(GLuint query, uint64_t& result)
+	{
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+
+		if (bAvailable == GL_FALSE)
+		{
+			return false;
+		}
+
+		GLuint64 value = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &value);
+
+		result = uint64_t(value);
+		return true;
+	}
+
+	void OpenGLGPUProfiler::ResolveFrame(Frame& frame)
+	{
+		if (!frame.m_bActive)
+		{
+			return;
+		}
+
+		for (const Scope& scope : frame.m_Scopes)
+		{
+			if (!scope.m_bEnded)
+			{
+				continue;
+			}
+
+			// GL_TIMESTAMP is in nanoseconds
+			uint64_t begin = 0;
+			uint64_t end = 0;
+
+			if (ReadQuery(frame.m_Timestamps[scope.m_BeginQuery], begin) && ReadQuery(frame.m_Timestamps[scope.m_BeginQuery + 1], end))
+			{
+				GPUProfiler::ReportTime(scope.m_Name, double(end - begin) / 1000000.0);
+			}
+			else
+			{
+				m_NumberOfDroppedScopes++;
+			}
+
+			if (scope.m_StatisticsQuery == UINT32_MAX)
+			{
+				continue;
+			}
+
+			uint64_t counters[s_NumberOfPipelineStatistics] = {};
+			bool bAvailable = true;
+
+			for (uint32_t counter = 0; counter < s_NumberOfPipelineStatistics && bAvailable; counter++)
+			{
+				bAvailable = ReadQuery(frame.m_Statistics[scope.m_StatisticsQuery][counter], counters[counter]);
+			}
+
+			if (bAvailable)
+			{
+				GPUPipelineStatistics statistics;
+				statistics.m_VertexInvocations = counters[0];
+				statistics.m_ClippingInvocations = counters[1];
+				statistics.m_ClippingPrimitives = counters[2];
+				statistics.m_FragmentInvocations = counters[3];
+
+				GPUProfiler::ReportPipelineStatistics(scope.m_Name, statistics);
+			}
+		}
+	}
+}
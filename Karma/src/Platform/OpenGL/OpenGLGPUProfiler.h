@@ -0,0 +1,147 @@
+/**
+ * @file OpenGLGPUProfiler.h
+ * @brief This file contains OpenGLGPUProfiler class, GL_TIMESTAMP and pipeline statistics queries around named scopes.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/GPUProfiler.h"
+#include "glad/glad.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Measures named scopes of the OpenGL context with glQueryCounter(GL_TIMESTAMP) and, with OpenGL 4.6, the pipeline statistics
+	 * queries (GL_VERTEX_SHADER_INVOCATIONS, GL_CLIPPING_INPUT_PRIMITIVES, GL_CLIPPING_OUTPUT_PRIMITIVES and GL_FRAGMENT_SHADER_INVOCATIONS).
+	 *
+	 * The queries of a frame come from a set of s_QueryFrames sets. When a set comes round again (BeginFrame, called by OpenGLContext::SwapBuffers),
+	 * the results which GL_QUERY_RESULT_AVAILABLE says are there are handed to GPUProfiler and the rest are dropped, so the CPU never waits on
+	 * the GPU. Works with software rasterizers (llvmpipe), which implement timestamps.
+	 *
+	 * Scopes nest for timing. A target may have only one active query, so statistics are gathered for the outermost scope asking for them.
+	 * OpenGLRendererAPI counts the invocations of the scene's passes with queries of its own, so the "Scene" scope doesn't ask.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API OpenGLGPUProfiler
+	{
+	public:
+		/**
+		 * @brief Generates the queries, with the context current
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLGPUProfiler();
+
+		/**
+		 * @brief Deletes the queries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~OpenGLGPUProfiler();
+
+		/**
+		 * @brief Moves on to the next set of queries, first resolving what its previous round left
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Issues the begin timestamp of the scope
+		 *
+		 * @param scopeName						Name the results are reported under
+		 * @param bPipelineStatistics			Whether to count the invocations too (see GPUProfiler::IsPipelineStatisticsEnabled)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void BeginScope(const char* scopeName, bool bPipelineStatistics = false);
+
+		/**
+		 * @brief Issues the end timestamp of the innermost open scope
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void EndScope();
+
+		/**
+		 * @brief Whether the context has the pipeline statistics queries (OpenGL 4.6, or ARB_pipeline_statistics_query before it)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static bool SupportsPipelineStatistics() { return GLAD_GL_VERSION_4_6; }
+
+		/**
+		 * @brief Reads the result of a query if it is there, without waiting
+		 *
+		 * @return false if the GPU isn't done with the query yet
+		 * @since Karma 1.0.0
+		 */
+		static bool ReadQuery(GLuint query, uint64_t& result);
+
+	public:
+		/**
+		 * @brief The targets of a pipeline statistics scope, in the order of GPUPipelineStatistics
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr GLenum s_PipelineStatisticsTargets[] = { GL_VERTEX_SHADER_INVOCATIONS, GL_CLIPPING_INPUT_PRIMITIVES,
+			GL_CLIPPING_OUTPUT_PRIMITIVES, GL_FRAGMENT_SHADER_INVOCATIONS };
+
+		/**
+		 * @brief Number of s_PipelineStatisticsTargets
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_NumberOfPipelineStatistics = 4;
+
+	private:
+		/**
+		 * @brief A scope recorded in a frame, the timestamps being the queries m_BeginQuery and m_BeginQuery + 1 of the set
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Scope
+		{
+			std::string m_Name;
+			uint32_t m_BeginQuery = 0;
+			uint32_t m_StatisticsQuery = UINT32_MAX;
+			bool m_bEnded = false;
+		};
+
+		/**
+		 * @brief A set of queries and the scopes recorded with it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Frame
+		{
+			GLuint m_Timestamps[2 * GPUProfiler::s_MaxScopesPerFrame] = {};
+			GLuint m_Statistics[GPUProfiler::s_MaxScopesPerFrame][s_NumberOfPipelineStatistics] = {};
+			std::vector<Scope> m_Scopes;
+			uint32_t m_NumberOfTimestamps = 0;
+			uint32_t m_NumberOfStatistics = 0;
+			bool m_bActive = false;
+			bool m_bStatisticsActive = false;
+		};
+
+		void ResolveFrame(Frame& frame);
+
+	private:
+		// Three sets, as the uniform rings of OpenGLContext, so the GPU is two frames ahead at most when a set is reused
+		static constexpr uint32_t s_QueryFrames = 3;
+
+		Frame m_Frames[s_QueryFrames];
+		uint32_t m_CurrentFrame;
+
+		std::vector<uint32_t> m_OpenScopes;
+		bool m_bStatisticsScopeOpen;
+
+		// Results of sets reused before the GPU was done with them
+		uint64_t m_NumberOfDroppedScopes;
+	};
+}
@@ -0,0 +1,184 @@
+#include "OpenGLRenderTarget.h"
+
+namespace Karma
+{
+	OpenGLRenderTarget::OpenGLRenderTarget(const RenderTargetSpecification& specification) : RenderTarget(specification), m_Framebuffer(0),
+		m_ColorRenderbuffer(0), m_DepthRenderbuffer(0), m_WindowViewport{ 0, 0, 0, 0 }
+	{
+		GLenum colorFormat = GL_RGBA8;
+
+		switch (specification.m_ColorFormat)
+		{
+			case RenderTargetFormat::RGBA8:
+				m_ReadFormat = GL_RGBA;
+				m_ReadType = GL_UNSIGNED_BYTE;
+				break;
+			case RenderTargetFormat::BGRA8:
+				// Same storage, the swizzle happens in the read
+				m_ReadFormat = GL_BGRA;
+				m_ReadType = GL_UNSIGNED_BYTE;
+				break;
+			case RenderTargetFormat::RGBA16F:
+				colorFormat = GL_RGBA16F;
+				m_ReadFormat = GL_RGBA;
+				m_ReadType = GL_HALF_FLOAT;
+				break;
+		}
+
+		const GLsizei width = GLsizei(specification.m_Width);
+		const GLsizei height = GLsizei(specification.m_Height);
+
+		glGenFramebuffers(1, &m_Framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+
+		glGenRenderbuffers(1, &m_ColorRenderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_ColorRenderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, colorFormat, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorRenderbuffer);
+
+		if (specification.m_DepthFormat != RenderTargetDepthFormat::None)
+		{
+			const bool bStencil = specification.m_DepthFormat == RenderTargetDepthFormat::Depth24Stencil8;
+
+			glGenRenderbuffers(1, &m_DepthRenderbuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, m_DepthRenderbuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, bStencil ? GL_DEPTH24_STENCIL8 : GL_DEPTH_COMPONENT32F, width, height);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, bStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthRenderbuffer);
+		}
+
+		KR_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Render target framebuffer is incomplete");
+
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			glGenBuffers(1, &slot.m_PixelBuffer);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_PixelBuffer);
+			glBufferData(GL_PIXEL_PACK_BUFFER, GetReadbackSize(), nullptr, GL_STREAM_READ);
+		}
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	OpenGLRenderTarget::~OpenGLRenderTarget()
+	{
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			if (slot.m_Fence)
+			{
+				glDeleteSync(slot.m_Fence);
+			}
+
+			glDeleteBuffers(1, &slot.m_PixelBuffer);
+		}
+
+		if (m_DepthRenderbuffer)
+		{
+			glDeleteRenderbuffers(1, &m_DepthRenderbuffer);
+		}
+
+		glDeleteRenderbuffers(1, &m_ColorRenderbuffer);
+		glDeleteFramebuffers(1, &m_Framebuffer);
+	}
+
+	void OpenGLRenderTarget::Bind()
+	{
+		glGetIntegerv(GL_VIEWPORT, m_WindowViewport);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+		glViewport(0, 0, GLsizei(m_Specification.m_Width), GLsizei(m_Specification.m_Height));
+	}
+
+	void OpenGLRenderTarget::Unbind()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(m_WindowViewport[0], m_WindowViewport[1], m_WindowViewport[2], m_WindowViewport[3]);
+	}
+
+	void OpenGLRenderTarget::Resolve()
+	{
+		if (!EndFrame())
+		{
+			return;
+		}
+
+		ReadbackSlot* freeSlot = nullptr;
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			if (slot.m_Fence == nullptr)
+			{
+				freeSlot = &slot;
+				break;
+			}
+		}
+
+		if (freeSlot == nullptr)
+		{
+			m_Statistics.m_NumberOfDroppedReadbacks++;
+			return;
+		}
+
+		// Into the pixel buffer object, so glReadPixels only queues the copy
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, freeSlot->m_PixelBuffer);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, GLsizei(m_Specification.m_Width), GLsizei(m_Specification.m_Height), m_ReadFormat, m_ReadType, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		freeSlot->m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		freeSlot->m_IssueTime = std::chrono::steady_clock::now();
+		FillReadbackHeader(freeSlot->m_Header);
+
+		m_Statistics.m_NumberOfReadbacks++;
+	}
+
+	bool OpenGLRenderTarget::PollReadback(RenderTargetReadback& readback)
+	{
+		// The oldest copy first
+		ReadbackSlot* oldestSlot = nullptr;
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			if (slot.m_Fence && (oldestSlot == nullptr || slot.m_Header.m_FrameNumber < oldestSlot->m_Header.m_FrameNumber))
+			{
+				oldestSlot = &slot;
+			}
+		}
+
+		if (oldestSlot == nullptr)
+		{
+			return false;
+		}
+
+		// Flushed, else the fence may never reach the GPU, but not waited upon
+		GLenum status = glClientWaitSync(oldestSlot->m_Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			KR_CORE_ASSERT(status != GL_WAIT_FAILED, "glClientWaitSync failed on a readback fence");
+			return false;
+		}
+
+		glDeleteSync(oldestSlot->m_Fence);
+		oldestSlot->m_Fence = nullptr;
+
+		readback = oldestSlot->m_Header;
+		readback.m_Pixels.resize(GetReadbackSize());
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, oldestSlot->m_PixelBuffer);
+
+		const void* mappedData = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(readback.m_Pixels.size()), GL_MAP_READ_BIT);
+		if (mappedData)
+		{
+			memcpy(readback.m_Pixels.data(), mappedData, readback.m_Pixels.size());
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		KR_CORE_ASSERT(mappedData != nullptr, "Failed to map the readback pixel buffer");
+
+		CompleteReadback(readback, oldestSlot->m_IssueTime);
+		return true;
+	}
+}
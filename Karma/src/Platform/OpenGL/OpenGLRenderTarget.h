@@ -0,0 +1,107 @@
+/**
+ * @file OpenGLRenderTarget.h
+ * @brief This file contains OpenGLRenderTarget class, a framebuffer object with pixel buffer object readback.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/RenderTarget.h"
+#include "glad/glad.h"
+
+namespace Karma
+{
+	/**
+	 * @brief OpenGL implementation of RenderTarget: a framebuffer object with a color renderbuffer and, if asked for, a depth one.
+	 *
+	 * A copy is a glReadPixels into one of s_ReadbackSlots pixel buffer objects (so the call returns at once) followed by a fence
+	 * (glFenceSync). PollReadback maps the buffer only once glClientWaitSync, with a timeout of 0, says the fence has signaled.
+	 *
+	 * @note The OpenGL context is current on the main thread only (the render thread runs synchronously for OpenGL), which is where
+	 * PollReadback should be called from as well.
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API OpenGLRenderTarget : public RenderTarget
+	{
+	public:
+		/**
+		 * @brief Creates the framebuffer object, its renderbuffers and the pixel buffer objects
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLRenderTarget(const RenderTargetSpecification& specification);
+
+		/**
+		 * @brief Deletes the GL objects and the fences still pending
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~OpenGLRenderTarget();
+
+		/**
+		 * @brief Hands out the oldest copy whose fence has signaled
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool PollReadback(RenderTargetReadback& readback) override;
+
+		/**
+		 * @brief glReadPixels puts the bottom row first
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool IsBottomUp() const override { return true; }
+
+		/**
+		 * @brief Binds the framebuffer object and sets the viewport to the target's size, remembering the window's. Called by
+		 * OpenGLRendererAPI::SetRenderTarget.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Bind();
+
+		/**
+		 * @brief Binds the default framebuffer and restores the viewport Bind found
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Unbind();
+
+		/**
+		 * @brief Ends the frame of the target, issuing the copy if one was requested. Called by OpenGLRendererAPI::EndScene.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Resolve();
+
+	private:
+		/**
+		 * @brief A pixel buffer object and the copy it holds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct ReadbackSlot
+		{
+			GLuint m_PixelBuffer = 0;
+			GLsync m_Fence = nullptr;
+			RenderTargetReadback m_Header;
+			std::chrono::steady_clock::time_point m_IssueTime;
+		};
+
+	private:
+		GLuint m_Framebuffer;
+		GLuint m_ColorRenderbuffer;
+		GLuint m_DepthRenderbuffer;
+
+		// glReadPixels format and type of the color format
+		GLenum m_ReadFormat;
+		GLenum m_ReadType;
+
+		GLint m_WindowViewport[4];
+
+		ReadbackSlot m_ReadbackSlots[s_ReadbackSlots];
+	};
+}
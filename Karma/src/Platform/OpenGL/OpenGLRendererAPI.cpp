@@ -1,8 +1,43 @@
 #include "OpenGLRendererAPI.h"
 #include "glad/glad.h"
+#include "Platform/OpenGL/OpenGLVertexArray.h"
+#include "Platform/OpenGL/OpenGLContext.h"
+#include "Platform/OpenGL/OpenGLUniformBufferRing.h"
+#include "Platform/OpenGL/OpenGLGPUProfiler.h"
+#include "Platform/OpenGL/OpenGLRenderTarget.h"
+#include "Platform/OpenGL/OpenGLBuffer.h"
 
 namespace Karma
 {
+	OpenGLRendererAPI::OpenGLRendererAPI() : m_bQueriesCreated(false), m_QueryFrame(0), m_CurrentPass(RenderPassType::Opaque)
+	{
+		for (uint32_t frame = 0; frame < s_QueryFrames; frame++)
+		{
+			for (uint32_t pass = 0; pass < s_NumberOfRenderPasses; pass++)
+			{
+				for (uint32_t statistic = 0; statistic < s_NumberOfStatistics; statistic++)
+				{
+					m_Queries[frame][pass][statistic] = 0;
+				}
+				m_IssuedQueries[frame][pass] = 0;
+			}
+		}
+
+		for (uint32_t pass = 0; pass < s_NumberOfRenderPasses; pass++)
+		{
+			m_FragmentInvocations[pass] = 0;
+			m_bHasFragmentInvocations[pass] = false;
+		}
+	}
+
+	OpenGLRendererAPI::~OpenGLRendererAPI()
+	{
+		if (m_bQueriesCreated)
+		{
+			glDeleteQueries(s_QueryFrames * s_NumberOfRenderPasses * s_NumberOfStatistics, &m_Queries[0][0][0]);
+		}
+	}
+
 	void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
 	{
 		glClearColor(color.r, color.g, color.b, color.a);
@@ -16,6 +51,274 @@ namespace Karma
 
 	void OpenGLRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray> vertexArray)
 	{
-		glDrawElements(GL_TRIANGLES, vertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, vertexArray->GetIndexBuffer()->GetCount(), OpenGLIndexBuffer::GetGLIndexType(vertexArray->GetIndexBuffer()), nullptr);
+	}
+
+	void OpenGLRendererAPI::DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount)
+	{
+		const std::shared_ptr<OpenGLShader>& shader = static_cast<OpenGLVertexArray*>(vertexArray.get())->GetShader();
+
+		if (shader == nullptr || !shader->SupportsInstancing())
+		{
+			RendererAPI::DrawIndexedInstanced(vertexArray, worldMatrices, instanceCount);
+			return;
+		}
+
+		OpenGLUniformBufferRing* instanceRing = OpenGLContext::GetInstanceRing();
+		uint32_t offset = instanceRing->PushData(worldMatrices, instanceCount * uint32_t(sizeof(glm::mat4)));
+
+		// The matrices didn't fit in the frame's region of the instance ring
+		if (offset == UniformBufferRing::s_InvalidOffset)
+		{
+			return;
+		}
+
+		// The vertex array is bound, the columns of the matrix go to four consecutive locations, advancing once per instance
+		glBindBuffer(GL_ARRAY_BUFFER, instanceRing->GetBufferID());
+
+		GLuint location = GLuint(shader->GetInstanceTransformLocation());
+		for (GLuint column = 0; column < 4; column++)
+		{
+			glEnableVertexAttribArray(location + column);
+			glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const void*)(uintptr_t)(offset + column * sizeof(glm::vec4)));
+			glVertexAttribDivisor(location + column, 1);
+		}
+
+		glDrawElementsInstanced(GL_TRIANGLES, vertexArray->GetIndexBuffer()->GetCount(), OpenGLIndexBuffer::GetGLIndexType(vertexArray->GetIndexBuffer()), nullptr,
+			GLsizei(instanceCount));
+
+		for (GLuint column = 0; column < 4; column++)
+		{
+			glDisableVertexAttribArray(location + column);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void OpenGLRendererAPI::BeginScene()
+	{
+		// Timing only, the passes within count the invocations themselves
+		OpenGLContext::GetGPUProfiler()->BeginScope("Scene");
+	}
+
+	void OpenGLRendererAPI::BeginPass(RenderPassType pass)
+	{
+		m_CurrentPass = pass;
+
+		OpenGLContext::GetGPUProfiler()->BeginScope(GetRenderPassName(pass));
+
+		switch (pass)
+		{
+			case RenderPassType::DepthPrePass:
+				glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+				glDepthMask(GL_TRUE);
+				glDepthFunc(GL_LESS);
+				OpenGLVertexArray::SetDepthOnlyPass(true);
+				break;
+			case RenderPassType::Opaque:
+				glDepthMask(GL_TRUE);
+				glDepthFunc(GL_LEQUAL);
+				break;
+			case RenderPassType::Transparent:
+				glDepthMask(GL_FALSE);
+				glDepthFunc(GL_LEQUAL);
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+		}
+
+		// The pipeline statistics queries are core from 4.6 (ARB_pipeline_statistics_query before)
+		if (!OpenGLGPUProfiler::SupportsPipelineStatistics())
+		{
+			return;
+		}
+
+		if (!m_bQueriesCreated)
+		{
+			glGenQueries(s_QueryFrames * s_NumberOfRenderPasses * s_NumberOfStatistics, &m_Queries[0][0][0]);
+			m_bQueriesCreated = true;
+		}
+
+		const uint32_t passIndex = uint32_t(pass);
+
+		// The results of the set's previous round, before the queries are reused
+		ResolvePassQueries(passIndex);
+
+		// The fragment invocations always, for RenderPassStatistics, the rest for the profiler
+		uint32_t issuedQueries = 1u << s_FragmentStatistic;
+		if (GPUProfiler::IsPipelineStatisticsEnabled())
+		{
+			issuedQueries = (1u << s_NumberOfStatistics) - 1;
+		}
+
+		for (uint32_t statistic = 0; statistic < s_NumberOfStatistics; statistic++)
+		{
+			if (issuedQueries & (1u << statistic))
+			{
+				glBeginQuery(OpenGLGPUProfiler::s_PipelineStatisticsTargets[statistic], m_Queries[m_QueryFrame][passIndex][statistic]);
+			}
+		}
+
+		m_IssuedQueries[m_QueryFrame][passIndex] = issuedQueries;
+	}
+
+	void OpenGLRendererAPI::ResolvePassQueries(uint32_t passIndex)
+	{
+		uint32_t issuedQueries = m_IssuedQueries[m_QueryFrame][passIndex];
+
+		if (issuedQueries == 0)
+		{
+			return;
+		}
+
+		m_IssuedQueries[m_QueryFrame][passIndex] = 0;
+
+		uint64_t counters[s_NumberOfStatistics] = {};
+		for (uint32_t statistic = 0; statistic < s_NumberOfStatistics; statistic++)
+		{
+			if ((issuedQueries & (1u << statistic)) && !OpenGLGPUProfiler::ReadQuery(m_Queries[m_QueryFrame][passIndex][statistic], counters[statistic]))
+			{
+				return;
+			}
+		}
+
+		m_FragmentInvocations[passIndex] = counters[s_FragmentStatistic];
+		m_bHasFragmentInvocations[passIndex] = true;
+
+		if (issuedQueries == (1u << s_NumberOfStatistics) - 1)
+		{
+			GPUPipelineStatistics statistics;
+			statistics.m_VertexInvocations = counters[0];
+			statistics.m_ClippingInvocations = counters[1];
+			statistics.m_ClippingPrimitives = counters[2];
+			statistics.m_FragmentInvocations = counters[3];
+
+			GPUProfiler::ReportPipelineStatistics(GetRenderPassName(RenderPassType(passIndex)), statistics);
+		}
+	}
+
+	void OpenGLRendererAPI::EndPass()
+	{
+		if (OpenGLGPUProfiler::SupportsPipelineStatistics())
+		{
+			const uint32_t issuedQueries = m_IssuedQueries[m_QueryFrame][uint32_t(m_CurrentPass)];
+
+			for (uint32_t statistic = 0; statistic < s_NumberOfStatistics; statistic++)
+			{
+				if (issuedQueries & (1u << statistic))
+				{
+					glEndQuery(OpenGLGPUProfiler::s_PipelineStatisticsTargets[statistic]);
+				}
+			}
+		}
+
+		OpenGLContext::GetGPUProfiler()->EndScope();
+
+		switch (m_CurrentPass)
+		{
+			case RenderPassType::DepthPrePass:
+				glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+				OpenGLVertexArray::SetDepthOnlyPass(false);
+				break;
+			case RenderPassType::Opaque:
+				glDepthFunc(GL_LESS);
+				break;
+			case RenderPassType::Transparent:
+				glDepthMask(GL_TRUE);
+				glDepthFunc(GL_LESS);
+				glDisable(GL_BLEND);
+				break;
+		}
+	}
+
+	bool OpenGLRendererAPI::GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const
+	{
+		const uint32_t passIndex = uint32_t(pass);
+
+		if (!m_bHasFragmentInvocations[passIndex])
+		{
+			return false;
+		}
+
+		invocations = m_FragmentInvocations[passIndex];
+		return true;
+	}
+
+	bool OpenGLRendererAPI::SupportsTextureFormat(TextureFormat format) const
+	{
+		switch (format)
+		{
+			case TextureFormat::RGBA8:
+				return true;
+			case TextureFormat::BC1:
+			case TextureFormat::BC3:
+			{
+				// Not core anywhere, and the sRGB variants come with EXT_texture_sRGB
+				static const bool bHasS3TC = []()
+				{
+					bool bCompression = false;
+					bool bSRGB = false;
+
+					GLint numberOfExtensions = 0;
+					glGetIntegerv(GL_NUM_EXTENSIONS, &numberOfExtensions);
+
+					for (GLint counter = 0; counter < numberOfExtensions; counter++)
+					{
+						const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, GLuint(counter));
+
+						if (extension != nullptr)
+						{
+							bCompression = bCompression || strcmp(extension, "GL_EXT_texture_compression_s3tc") == 0;
+							bSRGB = bSRGB || strcmp(extension, "GL_EXT_texture_sRGB") == 0;
+						}
+					}
+
+					return bCompression && bSRGB;
+				}();
+
+				return bHasS3TC;
+			}
+			case TextureFormat::BC5:
+				return GLAD_GL_VERSION_3_0 != 0;
+			case TextureFormat::BC7:
+				return GLAD_GL_VERSION_4_2 != 0;
+			case TextureFormat::ETC2RGB:
+			case TextureFormat::ETC2RGBA:
+				return GLAD_GL_VERSION_4_3 != 0;
+		}
+
+		return false;
+	}
+
+	void OpenGLRendererAPI::SetRenderTarget(RenderTarget* renderTarget)
+	{
+		if (m_RenderTarget == renderTarget)
+		{
+			return;
+		}
+
+		if (m_RenderTarget)
+		{
+			static_cast<OpenGLRenderTarget*>(m_RenderTarget)->Unbind();
+		}
+
+		m_RenderTarget = renderTarget;
+
+		if (m_RenderTarget)
+		{
+			static_cast<OpenGLRenderTarget*>(m_RenderTarget)->Bind();
+		}
+	}
+
+	void OpenGLRendererAPI::EndScene()
+	{
+		OpenGLContext::GetGPUProfiler()->EndScope();
+
+		if (m_RenderTarget)
+		{
+			static_cast<OpenGLRenderTarget*>(m_RenderTarget)->Resolve();
+		}
+
+		m_QueryFrame = (m_QueryFrame + 1) % s_QueryFrames;
 	}
 }
@@ -21,6 +21,20 @@ namespace Karma
 	class KARMA_API OpenGLRendererAPI : public RendererAPI
 	{
 	public:
+		/**
+		 * @brief A constructor. The queries are made on first use, when the context is current.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLRendererAPI();
+
+		/**
+		 * @brief Deletes the pipeline statistics queries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~OpenGLRendererAPI();
+
 		/**
 		 * @brief Set the color to be used for clear (rendering) screen
 		 *
@@ -37,11 +51,11 @@ namespace Karma
 		virtual void Clear() override;
 
 		/**
-		 * @brief In OpenGL left empty
+		 * @brief Opens the "Scene" scope of the GPU profiler (OpenGLContext::GetGPUProfiler)
 		 *
 		 * @since Karma 1.0.0
 		 */
-		virtual void BeginScene() override {}
+		virtual void BeginScene() override;
 
 		/**
 		 * @brief Do the triangle drawing using glDrawElements
@@ -54,10 +68,94 @@ namespace Karma
 		virtual void DrawIndexed(const std::shared_ptr<VertexArray> vertexArray) override;
 
 		/**
-		 * @brief In openGL left empty
+		 * @brief Draws the instances with glDrawElementsInstanced, the world matrices streamed through OpenGLContext's instance ring into
+		 * the shader's per instance attribute. Shaders without one get a draw per instance.
+		 *
+		 * @see https://registry.khronos.org/OpenGL-Refpages/gl4/html/glDrawElementsInstanced.xhtml
+		 * @since Karma 1.0.0
+		 */
+		virtual void DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount) override;
+
+		/**
+		 * @brief Sets the fixed function state of the pass: no color writes for the depth pre-pass, GL_LEQUAL depth test for the opaque
+		 * pass (so the laid depth passes), and alpha blending without depth writes for the transparent pass. With OpenGL 4.6 the
+		 * fragment shader invocations of the pass are counted with a GL_FRAGMENT_SHADER_INVOCATIONS query, and the other invocations
+		 * (OpenGLGPUProfiler::s_PipelineStatisticsTargets) as well while GPUProfiler::IsPipelineStatisticsEnabled. The pass is a scope of
+		 * the GPU profiler.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginPass(RenderPassType pass) override;
+
+		/**
+		 * @brief Ends the queries of the pass and restores the default state (color and depth writes, GL_LESS, no blending)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndPass() override;
+
+		/**
+		 * @brief The pre-pass is drawn with the full program and masked color writes
 		 *
 		 * @since Karma 1.0.0
 		 */
-		virtual void EndScene() override {}
+		virtual bool SupportsDepthPrePass() const override { return true; }
+
+		/**
+		 * @brief BC1 and BC3 with EXT_texture_compression_s3tc (and EXT_texture_sRGB), BC5 from OpenGL 3.0, BC7 from 4.2 and ETC2 from 4.3
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsTextureFormat(TextureFormat format) const override;
+
+		/**
+		 * @brief The count of the pass's query s_QueryFrames frames back, if OpenGL 4.6 is there
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const override;
+
+		/**
+		 * @brief Binds the framebuffer object of the target (OpenGLRenderTarget::Bind), or the window's back with nullptr
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SetRenderTarget(RenderTarget* renderTarget) override;
+
+		/**
+		 * @brief Closes the "Scene" scope, issues the readback of the render target if one is set and requested, and moves the queries
+		 * on to the next frame's set
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndScene() override;
+
+	private:
+		/**
+		 * @brief Reads what the queries of the pass left in the present set, if the GPU is done with them
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ResolvePassQueries(uint32_t passIndex);
+
+	private:
+		// Queries of a frame are read when the set comes round again, by when the GPU has long finished them. Results which still aren't
+		// there are dropped rather than waited for.
+		static constexpr uint32_t s_QueryFrames = 3;
+
+		// A query per pipeline statistic, in the order of OpenGLGPUProfiler::s_PipelineStatisticsTargets (the fragment invocations last),
+		// and which of them were issued
+		static constexpr uint32_t s_NumberOfStatistics = 4;
+		static constexpr uint32_t s_FragmentStatistic = 3;
+
+		uint32_t m_Queries[s_QueryFrames][s_NumberOfRenderPasses][s_NumberOfStatistics];
+		uint32_t m_IssuedQueries[s_QueryFrames][s_NumberOfRenderPasses];
+		bool m_bQueriesCreated;
+		uint32_t m_QueryFrame;
+
+		RenderPassType m_CurrentPass;
+
+		uint64_t m_FragmentInvocations[s_NumberOfRenderPasses];
+		bool m_bHasFragmentInvocations[s_NumberOfRenderPasses];
 	};
 }
@@ -2,6 +2,7 @@
 #include "glad/glad.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 namespace Karma
 {
@@ -107,6 +108,11 @@ namespace Karma
 		// Always detach shaders after a successful link.
 		glDetachShader(program, vertexShader);
 		glDetachShader(program, fragmentShader);
+
+		m_InstanceTransformLocation = glGetAttribLocation(program, s_InstanceTransformName);
+		m_bSupportsInstancing = m_InstanceTransformLocation >= 0;
+
+		CacheUniformLocations();
 	}
 
 	OpenGLShader::OpenGLShader(const std::string& vertexSrcFile, const std::string& fragmentSrcFile, std::shared_ptr<UniformBufferObject> ubo,
@@ -197,34 +203,120 @@ namespace Karma
 		}
 
 		m_RendererID = program;
+
+		// Linker knows best whether the instance transform is actually read
+		m_InstanceTransformLocation = glGetAttribLocation(program, s_InstanceTransformName);
+		m_bSupportsInstancing = m_InstanceTransformLocation >= 0;
+
+		CacheUniformLocations();
+	}
+
+	void OpenGLShader::CacheUniformLocations()
+	{
+		m_UniformLocations.clear();
+		m_SamplerUnits.clear();
+
+		GLint numberOfUniforms = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &numberOfUniforms);
+
+		GLint maxNameLength = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+
+		for (GLint counter = 0; counter < numberOfUniforms; counter++)
+		{
+			GLsizei nameLength = 0;
+			GLint size = 0;
+			GLenum type = GL_NONE;
+			glGetActiveUniform(m_RendererID, GLuint(counter), GLsizei(nameBuffer.size()), &nameLength, &size, &type, nameBuffer.data());
+
+			std::string name(nameBuffer.data(), nameLength);
+			GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+
+			// Members of uniform blocks have no location, they travel through the uniform ring
+			if (location < 0)
+			{
+				continue;
+			}
+
+			m_UniformLocations[name] = location;
+
+			// Arrays are reported as "name[0]", make the plain name work too
+			size_t bracket = name.find('[');
+			if (bracket != std::string::npos)
+			{
+				m_UniformLocations[name.substr(0, bracket)] = location;
+			}
+		}
+	}
+
+	GLint OpenGLShader::GetUniformLocation(const std::string& name) const
+	{
+		auto iterator = m_UniformLocations.find(name);
+
+		return iterator != m_UniformLocations.end() ? iterator->second : -1;
+	}
+
+	void OpenGLShader::SetSamplerUnit(GLint location, GLint unit) const
+	{
+		if (location < 0)
+		{
+			return;
+		}
+
+		auto iterator = m_SamplerUnits.find(location);
+		const bool bIssue = iterator == m_SamplerUnits.end() || iterator->second != unit;
+
+		if (bIssue)
+		{
+			// The program is current (Bind)
+			glUniform1i(location, unit);
+			m_SamplerUnits[location] = unit;
+		}
+
+		OpenGLStateCache::CountUniformSet(bIssue);
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
+		OpenGLStateCache::ForgetProgram(m_RendererID);
 		glDeleteProgram(m_RendererID);
 	}
 
+	void OpenGLShader::SwapContents(Shader& other)
+	{
+		Shader::SwapContents(other);
+
+		OpenGLShader& otherShader = static_cast<OpenGLShader&>(other);
+
+		std::swap(m_RendererID, otherShader.m_RendererID);
+		std::swap(m_InstanceTransformLocation, otherShader.m_InstanceTransformLocation);
+		std::swap(m_UniformLocations, otherShader.m_UniformLocations);
+		std::swap(m_SamplerUnits, otherShader.m_SamplerUnits);
+	}
+
 	void OpenGLShader::Bind() const
 	{
-		glUseProgram(m_RendererID);
-		glUniform1i(glGetUniformLocation(m_RendererID, "texSampler"), 0);
+		OpenGLStateCache::UseProgram(m_RendererID);
+		SetSamplerUnit(GetUniformLocation("texSampler"), 0);
 	}
 
 	void OpenGLShader::Bind(const std::string& texShaderName) const
 	{
-		glUseProgram(m_RendererID);
+		OpenGLStateCache::UseProgram(m_RendererID);
 		// Hacky for now
-		glUniform1i(glGetUniformLocation(m_RendererID, texShaderName.c_str()), 0);
+		SetSamplerUnit(GetUniformLocation(texShaderName), 0);
 	}
 
 	void OpenGLShader::UnBind() const
 	{
-		glUseProgram(0);
+		OpenGLStateCache::UseProgram(0);
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		OpenGLStateCache::UseProgram(m_RendererID);
+		glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 }
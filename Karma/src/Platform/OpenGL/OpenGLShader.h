@@ -99,6 +99,30 @@ namespace Karma
 		 */
 		void UploadUniformMat4(const std::string& name, const glm::mat4& matrix);
 
+		/**
+		 * @brief Location of the (default block) uniform, cached at link time
+		 *
+		 * @param name					The name of the uniform, as in the shader source
+		 *
+		 * @return -1 if the program has no such active uniform (glUniform* ignores -1)
+		 * @since Karma 1.0.0
+		 */
+		GLint GetUniformLocation(const std::string& name) const;
+
+		/**
+		 * @brief Location of the per instance world matrix (see Shader::s_InstanceTransformName), -1 if the shader doesn't read one
+		 *
+		 * @since Karma 1.0.0
+		 */
+		int32_t GetInstanceTransformLocation() const { return m_InstanceTransformLocation; }
+
+		/**
+		 * @brief Swaps the program, and what was cached of it, with the other (reloaded) shader's. The old program goes with other.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SwapContents(Shader& other) override;
+
 	private:
 		/**
 		 * @brief A routine to comple and link the shader (both vertex and fragment) for Karma and cache the generated ID to m_RendererID
@@ -108,9 +132,31 @@ namespace Karma
 		 */
 		void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
 
+		/**
+		 * @brief Queries the active uniforms of the linked program once, so that no glGetUniformLocation is needed per upload
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CacheUniformLocations();
+
+		/**
+		 * @brief glUniform1i of the sampler, if the unit differs from the one set last on this program
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetSamplerUnit(GLint location, GLint unit) const;
+
 	private:
 		// OpenGL's identification scheme
 		uint32_t m_RendererID;
 		std::shared_ptr<OpenGLUniformBuffer> m_UniformBufferObject;
+
+		int32_t m_InstanceTransformLocation = -1;
+
+		// Uniform locations by name, filled at link time
+		std::unordered_map<std::string, GLint> m_UniformLocations;
+
+		// Uniform values are program state, so the sampler units set on this program are remembered
+		mutable std::unordered_map<GLint, GLint> m_SamplerUnits;
 	};
 }
@@ -0,0 +1,159 @@
+#include "OpenGLStateCache.h"
+
+namespace Karma
+{
+	GLuint OpenGLStateCache::s_Program = OpenGLStateCache::s_Unknown;
+	GLuint OpenGLStateCache::s_VertexArray = OpenGLStateCache::s_Unknown;
+	GLuint OpenGLStateCache::s_ActiveTextureUnit = OpenGLStateCache::s_Unknown;
+	OpenGLStateCache::TextureBinding OpenGLStateCache::s_Textures[OpenGLStateCache::s_MaxTextureUnits];
+	OpenGLStateCache::BufferRange OpenGLStateCache::s_BufferRanges[OpenGLStateCache::s_MaxBufferBindings];
+
+	OpenGLStateStatistics OpenGLStateCache::s_Statistics;
+
+	void OpenGLStateCache::UseProgram(GLuint program)
+	{
+		s_Statistics.m_ProgramBindsRequested++;
+
+		if (s_Program == program)
+		{
+			return;
+		}
+
+		glUseProgram(program);
+		s_Program = program;
+
+		s_Statistics.m_ProgramBindsIssued++;
+	}
+
+	void OpenGLStateCache::BindVertexArray(GLuint vertexArray)
+	{
+		s_Statistics.m_VertexArrayBindsRequested++;
+
+		if (s_VertexArray == vertexArray)
+		{
+			return;
+		}
+
+		glBindVertexArray(vertexArray);
+		s_VertexArray = vertexArray;
+
+		s_Statistics.m_VertexArrayBindsIssued++;
+	}
+
+	void OpenGLStateCache::BindTexture(uint32_t unit, GLenum target, GLuint texture)
+	{
+		s_Statistics.m_TextureBindsRequested++;
+
+		if (unit < s_MaxTextureUnits && s_Textures[unit].m_Target == target && s_Textures[unit].m_Texture == texture)
+		{
+			return;
+		}
+
+		if (s_ActiveTextureUnit != unit)
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			s_ActiveTextureUnit = unit;
+		}
+
+		glBindTexture(target, texture);
+
+		if (unit < s_MaxTextureUnits)
+		{
+			s_Textures[unit].m_Target = target;
+			s_Textures[unit].m_Texture = texture;
+		}
+
+		s_Statistics.m_TextureBindsIssued++;
+	}
+
+	void OpenGLStateCache::BindBufferRange(GLenum target, uint32_t bindingPointIndex, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		s_Statistics.m_BufferRangeBindsRequested++;
+
+		if (bindingPointIndex < s_MaxBufferBindings)
+		{
+			BufferRange& range = s_BufferRanges[bindingPointIndex];
+
+			if (range.m_Target == target && range.m_Buffer == buffer && range.m_Offset == offset && range.m_Size == size)
+			{
+				return;
+			}
+
+			range.m_Target = target;
+			range.m_Buffer = buffer;
+			range.m_Offset = offset;
+			range.m_Size = size;
+		}
+
+		glBindBufferRange(target, bindingPointIndex, buffer, offset, size);
+
+		s_Statistics.m_BufferRangeBindsIssued++;
+	}
+
+	void OpenGLStateCache::Invalidate()
+	{
+		s_Program = s_Unknown;
+		s_VertexArray = s_Unknown;
+		s_ActiveTextureUnit = s_Unknown;
+
+		for (TextureBinding& binding : s_Textures)
+		{
+			binding.m_Target = GL_NONE;
+			binding.m_Texture = s_Unknown;
+		}
+
+		for (BufferRange& range : s_BufferRanges)
+		{
+			range.m_Target = GL_NONE;
+			range.m_Buffer = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::ForgetProgram(GLuint program)
+	{
+		if (s_Program == program)
+		{
+			s_Program = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::ForgetVertexArray(GLuint vertexArray)
+	{
+		if (s_VertexArray == vertexArray)
+		{
+			s_VertexArray = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::ForgetTexture(GLuint texture)
+	{
+		for (TextureBinding& binding : s_Textures)
+		{
+			if (binding.m_Texture == texture)
+			{
+				binding.m_Texture = s_Unknown;
+			}
+		}
+	}
+
+	void OpenGLStateCache::ForgetBuffer(GLuint buffer)
+	{
+		for (BufferRange& range : s_BufferRanges)
+		{
+			if (range.m_Buffer == buffer)
+			{
+				range.m_Buffer = s_Unknown;
+			}
+		}
+	}
+
+	void OpenGLStateCache::CountUniformSet(bool bIssued)
+	{
+		s_Statistics.m_UniformSetsRequested++;
+
+		if (bIssued)
+		{
+			s_Statistics.m_UniformSetsIssued++;
+		}
+	}
+}
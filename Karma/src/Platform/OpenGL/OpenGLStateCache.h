@@ -0,0 +1,206 @@
+/**
+ * @file OpenGLStateCache.h
+ * @brief This file contains OpenGLStateCache class, the shadow of the OpenGL binding state which filters out redundant binds.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "glad/glad.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Binds asked for (through OpenGLStateCache) and the ones which were actually issued to OpenGL. For a scene the requested
+	 * counts are what the backend used to issue before the cache, so requested - issued is the reduction in GL calls.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API OpenGLStateStatistics
+	{
+		/**
+		 * @brief glUseProgram calls asked for and issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_ProgramBindsRequested = 0;
+		uint64_t m_ProgramBindsIssued = 0;
+
+		/**
+		 * @brief glBindVertexArray calls asked for and issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_VertexArrayBindsRequested = 0;
+		uint64_t m_VertexArrayBindsIssued = 0;
+
+		/**
+		 * @brief glBindTexture (and glActiveTexture) calls asked for and issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_TextureBindsRequested = 0;
+		uint64_t m_TextureBindsIssued = 0;
+
+		/**
+		 * @brief glBindBufferRange calls asked for and issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_BufferRangeBindsRequested = 0;
+		uint64_t m_BufferRangeBindsIssued = 0;
+
+		/**
+		 * @brief glUniform* calls (sampler units) asked for and issued, see OpenGLShader::Bind
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_UniformSetsRequested = 0;
+		uint64_t m_UniformSetsIssued = 0;
+	};
+
+	/**
+	 * @brief Remembers the bound program, vertex array, textures (per unit) and uniform buffer ranges (per binding point), and issues a bind only
+	 * when it changes something. All the binds of the OpenGL backend go through here.
+	 *
+	 * Code which changes the bindings behind the cache's back (KarmaGui's renderer for instance) must call Invalidate, after which the next
+	 * bind of each kind is issued unconditionally. The cache assumes the one OpenGL context of the main thread.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API OpenGLStateCache
+	{
+	public:
+		/**
+		 * @brief glUseProgram, if the program isn't current
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void UseProgram(GLuint program);
+
+		/**
+		 * @brief glBindVertexArray, if the vertex array isn't bound
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void BindVertexArray(GLuint vertexArray);
+
+		/**
+		 * @brief glActiveTexture and glBindTexture, if the texture isn't bound to the unit
+		 *
+		 * @param unit						Texture unit (0 for GL_TEXTURE0)
+		 * @param target					GL_TEXTURE_2D and the like
+		 * @param texture					The texture name
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void BindTexture(uint32_t unit, GLenum target, GLuint texture);
+
+		/**
+		 * @brief glBindBufferRange of GL_UNIFORM_BUFFER (or GL_SHADER_STORAGE_BUFFER), if the binding point doesn't hold that range already
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void BindBufferRange(GLenum target, uint32_t bindingPointIndex, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Forgets everything, the next binds are issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Invalidate();
+
+		/**
+		 * @brief Forgets the program if current, called before glDeleteProgram (the name may be given out again)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ForgetProgram(GLuint program);
+
+		/**
+		 * @brief Forgets the vertex array if bound, called before glDeleteVertexArrays
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ForgetVertexArray(GLuint vertexArray);
+
+		/**
+		 * @brief Forgets the texture on all the units, called before glDeleteTextures
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ForgetTexture(GLuint texture);
+
+		/**
+		 * @brief Forgets the ranges of the buffer, called before glDeleteBuffers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ForgetBuffer(GLuint buffer);
+
+		/**
+		 * @brief Counts a uniform set asked for (and whether it was issued), for the uniform values cached by OpenGLShader
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void CountUniformSet(bool bIssued);
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static const OpenGLStateStatistics& GetStatistics() { return s_Statistics; }
+
+		/**
+		 * @brief Zeroes the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ResetStatistics() { s_Statistics = OpenGLStateStatistics(); }
+
+	public:
+		/**
+		 * @brief Number of texture units tracked, binds to the units beyond are always issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_MaxTextureUnits = 16;
+
+		/**
+		 * @brief Number of buffer binding points tracked, binds to the points beyond are always issued
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_MaxBufferBindings = 32;
+
+	private:
+		// Marks unknown state
+		static constexpr GLuint s_Unknown = GLuint(~0u);
+
+		struct TextureBinding
+		{
+			GLenum m_Target;
+			GLuint m_Texture;
+		};
+
+		struct BufferRange
+		{
+			GLenum m_Target;
+			GLuint m_Buffer;
+			GLintptr m_Offset;
+			GLsizeiptr m_Size;
+		};
+
+		static GLuint s_Program;
+		static GLuint s_VertexArray;
+		static GLuint s_ActiveTextureUnit;
+		static TextureBinding s_Textures[s_MaxTextureUnits];
+		static BufferRange s_BufferRanges[s_MaxBufferBindings];
+
+		static OpenGLStateStatistics s_Statistics;
+	};
+}
@@ -0,0 +1,119 @@
+#include "OpenGLStreamedTexture.h"
+#include "OpenGLStateCache.h"
+#include "glad/glad.h"
+
+// EXT_texture_sRGB's S3TC formats, which the glad of core profile doesn't have
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace Karma
+{
+	OpenGLStreamedTexture::OpenGLStreamedTexture(uint32_t width, uint32_t height, TextureFormat format) : StreamedTexture(width, height,
+		format)
+	{
+		glGenTextures(1, &m_RendererID);
+		OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, GLint(m_NumberOfMips - 1));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(m_NumberOfMips - 1));
+	}
+
+	OpenGLStreamedTexture::~OpenGLStreamedTexture()
+	{
+		OpenGLStateCache::ForgetTexture(m_RendererID);
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLStreamedTexture::UploadMip(uint32_t mip, const uint8_t* pixels)
+	{
+		KR_CORE_ASSERT(mip + 1 == m_FirstResidentMip || (m_FirstResidentMip == m_NumberOfMips && mip == m_NumberOfMips - 1),
+			"Mips are streamed in from the smallest up");
+
+		OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+		const GLsizei width = GLsizei(GetMipExtent(m_Width, mip));
+		const GLsizei height = GLsizei(GetMipExtent(m_Height, mip));
+
+		if (TextureCompressor::IsCompressed(m_Format))
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, GLint(mip), GLenum(GetInternalFormat(m_Format)), width, height, 0,
+				GLsizei(GetMipSize(m_Format, m_Width, m_Height, mip)), pixels);
+		}
+		else
+		{
+			// Rows of odd widths aren't 4 byte multiples below the largest mips
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexImage2D(GL_TEXTURE_2D, GLint(mip), GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, GLint(mip));
+
+		m_FirstResidentMip = mip;
+	}
+
+	void OpenGLStreamedTexture::Evict(uint32_t firstMip)
+	{
+		if (firstMip <= m_FirstResidentMip)
+		{
+			return;
+		}
+
+		OpenGLStateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+		// Sampling moves off the mips before they go
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, GLint(std::min(firstMip, m_NumberOfMips - 1)));
+
+		for (uint32_t mip = m_FirstResidentMip; mip < firstMip && mip < m_NumberOfMips; mip++)
+		{
+			if (TextureCompressor::IsCompressed(m_Format))
+			{
+				glCompressedTexImage2D(GL_TEXTURE_2D, GLint(mip), GLenum(GetInternalFormat(m_Format)), 0, 0, 0, 0, nullptr);
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, GLint(mip), GL_SRGB8_ALPHA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			}
+		}
+
+		m_FirstResidentMip = std::min(firstMip, m_NumberOfMips);
+	}
+
+	void OpenGLStreamedTexture::Bind(uint32_t unit) const
+	{
+		OpenGLStateCache::BindTexture(unit, GL_TEXTURE_2D, m_RendererID);
+	}
+
+	uint32_t OpenGLStreamedTexture::GetInternalFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::RGBA8:
+				return GL_SRGB8_ALPHA8;
+			case TextureFormat::BC1:
+				return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+			case TextureFormat::BC3:
+				return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+			case TextureFormat::BC5:
+				return GL_COMPRESSED_RG_RGTC2;
+			case TextureFormat::BC7:
+				return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+			case TextureFormat::ETC2RGB:
+				return GL_COMPRESSED_SRGB8_ETC2;
+			case TextureFormat::ETC2RGBA:
+				return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+		}
+
+		KR_CORE_ASSERT(false, "Unknown TextureFormat");
+		return GL_SRGB8_ALPHA8;
+	}
+}
@@ -0,0 +1,52 @@
+/**
+ * @file OpenGLStreamedTexture.h
+ * @brief This file contains the OpenGLStreamedTexture class.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/StreamedTexture.h"
+
+namespace Karma
+{
+	/**
+	 * @brief OpenGL's streamed texture. The mips are specified one by one (glTexImage2D, or glCompressedTexImage2D with the blocks as
+	 * they are for the compressed formats) and GL_TEXTURE_BASE_LEVEL follows the largest
+	 * resident, so that the texture stays complete. Evicted mips are respecified as empty, which lets the driver free them.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API OpenGLStreamedTexture : public StreamedTexture
+	{
+	public:
+		/**
+		 * @brief Generates the texture object, with nothing resident
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLStreamedTexture(uint32_t width, uint32_t height, TextureFormat format);
+
+		/**
+		 * @brief Deletes the texture object
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~OpenGLStreamedTexture() override;
+
+		virtual void UploadMip(uint32_t mip, const uint8_t* pixels) override;
+		virtual void Evict(uint32_t firstMip) override;
+		virtual void Bind(uint32_t unit) const override;
+
+		/**
+		 * @brief OpenGL's (sRGB where there is one) internal format of a TextureFormat
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t GetInternalFormat(TextureFormat format);
+
+	private:
+		uint32_t m_RendererID;
+	};
+}
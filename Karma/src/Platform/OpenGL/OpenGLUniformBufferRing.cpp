@@ -0,0 +1,121 @@
+#include "OpenGLUniformBufferRing.h"
+#include "glad/glad.h"
+#include "Karma/Core.h"
+#include "OpenGLStateCache.h"
+
+namespace Karma
+{
+	OpenGLUniformBufferRing::OpenGLUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames) :
+		UniformBufferRing(type, bytesPerFrame, numberOfFrames), m_BufferID(0), m_bPersistent(false)
+	{
+		// 256 is the largest alignment seen in the wild, in case the query isn't supported
+		GLint alignment = 256;
+
+		switch (type)
+		{
+			case RingBufferType::Uniform:
+				m_Target = GL_UNIFORM_BUFFER;
+				glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+				break;
+			case RingBufferType::Storage:
+				m_Target = GL_SHADER_STORAGE_BUFFER;
+				glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+				break;
+			case RingBufferType::Vertex:
+				m_Target = GL_ARRAY_BUFFER;
+				alignment = 16;
+				break;
+		}
+
+		m_Alignment = alignment > 0 ? uint32_t(alignment) : 256;
+
+		m_Fences.resize(numberOfFrames, nullptr);
+
+		glGenBuffers(1, &m_BufferID);
+		glBindBuffer(m_Target, m_BufferID);
+
+		if (GLAD_GL_VERSION_4_4)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			glBufferStorage(m_Target, GetTotalSize(), nullptr, flags);
+			m_MappedData = static_cast<uint8_t*>(glMapBufferRange(m_Target, 0, GetTotalSize(), flags));
+
+			m_bPersistent = m_MappedData != nullptr;
+		}
+
+		if (!m_bPersistent)
+		{
+			glBufferData(m_Target, GetTotalSize(), nullptr, GL_DYNAMIC_DRAW);
+
+			m_HostData.resize(GetTotalSize());
+			m_MappedData = m_HostData.data();
+		}
+
+		glBindBuffer(m_Target, 0);
+
+		KR_CORE_INFO("OpenGL uniform ring created ({0} mapping, alignment {1})", m_bPersistent ? "persistent" : "no persistent", m_Alignment);
+	}
+
+	OpenGLUniformBufferRing::~OpenGLUniformBufferRing()
+	{
+		for (auto fence : m_Fences)
+		{
+			if (fence)
+			{
+				glDeleteSync(static_cast<GLsync>(fence));
+			}
+		}
+
+		if (m_bPersistent)
+		{
+			glBindBuffer(m_Target, m_BufferID);
+			glUnmapBuffer(m_Target);
+			glBindBuffer(m_Target, 0);
+		}
+
+		OpenGLStateCache::ForgetBuffer(m_BufferID);
+		glDeleteBuffers(1, &m_BufferID);
+	}
+
+	void OpenGLUniformBufferRing::BeginFrame()
+	{
+		if (m_bPersistent)
+		{
+			uint32_t finishedFrame = GetCurrentFrame();
+			uint32_t nextFrame = (finishedFrame + 1) % GetNumberOfFrames();
+
+			m_Fences[finishedFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+			if (GLsync fence = static_cast<GLsync>(m_Fences[nextFrame]))
+			{
+				// GPU may still be reading the region we are about to write
+				while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+				{
+				}
+
+				glDeleteSync(fence);
+				m_Fences[nextFrame] = nullptr;
+			}
+		}
+
+		UniformBufferRing::BeginFrame();
+	}
+
+	void OpenGLUniformBufferRing::BindRange(uint32_t bindingPointIndex, uint32_t offset, uint32_t size) const
+	{
+		OpenGLStateCache::BindBufferRange(m_Target, bindingPointIndex, m_BufferID, offset, size);
+	}
+
+	void OpenGLUniformBufferRing::FlushRange(uint32_t offset, uint32_t size)
+	{
+		if (m_bPersistent)
+		{
+			return;
+		}
+
+		glBindBuffer(m_Target, m_BufferID);
+		glBufferSubData(m_Target, offset, size, m_MappedData + offset);
+		glBindBuffer(m_Target, 0);
+	}
+}
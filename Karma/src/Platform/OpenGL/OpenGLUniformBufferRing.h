@@ -0,0 +1,98 @@
+/**
+ * @file OpenGLUniformBufferRing.h
+ * @brief This file contains OpenGLUniformBufferRing class, the OpenGL implementation of UniformBufferRing.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/UniformBufferRing.h"
+
+namespace Karma
+{
+	/**
+	 * @brief OpenGL uniform (or storage) ring. With OpenGL 4.4 (glBufferStorage) the buffer is mapped persistently and coherently, and a fence
+	 * is placed at the end of each frame's region so that the region is reused only after the GPU is done with it. On older contexts
+	 * (for instance 3.3 on Mac) the ring writes into host memory and copies each pushed block with one glBufferSubData call.
+	 *
+	 * The draw binds the block with BindRange (glBindBufferRange) using the offset returned by UniformBufferRing::PushUniforms.
+	 *
+	 * @see OpenGLUniformBuffer::UploadUniformBuffer
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API OpenGLUniformBufferRing : public UniformBufferRing
+	{
+	public:
+		/**
+		 * @brief Generates the buffer and maps it (persistently, if supported)
+		 *
+		 * @param type							Uniform or storage data
+		 * @param bytesPerFrame					Size (in bytes) of the region available to each frame
+		 * @param numberOfFrames				Number of regions (frames) the buffer is split into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		OpenGLUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames);
+
+		/**
+		 * @brief Unmaps and deletes the buffer and the fences
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~OpenGLUniformBufferRing();
+
+		/**
+		 * @brief Fences the region just written and waits (if needed) on the fence of the region about to be written
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginFrame() override;
+
+		/**
+		 * @brief Binds the range [offset, offset + size) of the ring to the indexed binding point (glBindBufferRange)
+		 *
+		 * @param bindingPointIndex				The binding specified in the shader
+		 * @param offset						Offset returned by UniformBufferRing::PushUniforms
+		 * @param size							Size (in bytes) of the block
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void BindRange(uint32_t bindingPointIndex, uint32_t offset, uint32_t size) const;
+
+		/**
+		 * @brief Getter for the buffer id
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetBufferID() const { return m_BufferID; }
+
+		/**
+		 * @brief Whether the buffer is persistently mapped (glBufferStorage available)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsPersistentlyMapped() const { return m_bPersistent; }
+
+	protected:
+		/**
+		 * @brief Copies the range to GPU, when not persistently mapped
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void FlushRange(uint32_t offset, uint32_t size) override;
+
+	private:
+		uint32_t m_Target;
+		uint32_t m_BufferID;
+		bool m_bPersistent;
+
+		// Host side copy when persistent mapping is not available
+		std::vector<uint8_t> m_HostData;
+
+		// One GLsync per region
+		std::vector<void*> m_Fences;
+	};
+}
@@ -1,5 +1,6 @@
 #include "OpenGLVertexArray.h"
 #include "glad/glad.h"
+#include "OpenGLStateCache.h"
 
 namespace Karma
 {
@@ -29,6 +30,16 @@ namespace Karma
 			return GL_INT;
 		case Karma::ShaderDataType::Bool:
 			return GL_INT;
+		case Karma::ShaderDataType::Half2:
+			return GL_HALF_FLOAT;
+		case Karma::ShaderDataType::Half4:
+			return GL_HALF_FLOAT;
+		case Karma::ShaderDataType::Short2Norm:
+			return GL_SHORT;
+		case Karma::ShaderDataType::Byte4Norm:
+			return GL_BYTE;
+		case Karma::ShaderDataType::UByte4Norm:
+			return GL_UNSIGNED_BYTE;
 		case Karma::ShaderDataType::None:
 			return GL_NONE;
 		}
@@ -37,33 +48,40 @@ namespace Karma
 		return 0;
 	}
 
+	bool OpenGLVertexArray::s_bDepthOnlyPass = false;
+
 	OpenGLVertexArray::OpenGLVertexArray()
 	{
 		//glCreateVertexArrays(1, &m_RendererID);
 		glGenVertexArrays(1, &m_RendererID);
+		glGenVertexArrays(1, &m_DepthOnlyRendererID);
 		Bind();
 	}
 
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
+		OpenGLStateCache::ForgetVertexArray(m_RendererID);
+		OpenGLStateCache::ForgetVertexArray(m_DepthOnlyRendererID);
 		glDeleteVertexArrays(1, &m_RendererID);
+		glDeleteVertexArrays(1, &m_DepthOnlyRendererID);
 	}
 	
 	void OpenGLVertexArray::Bind() const
 	{
-		glBindVertexArray(m_RendererID);
+		// The legacy AddVertexBuffer path sets up the full one only
+		OpenGLStateCache::BindVertexArray(s_bDepthOnlyPass && GetMesh() ? m_DepthOnlyRendererID : m_RendererID);
 	}
 
 	void OpenGLVertexArray::UnBind() const
 	{
-		glBindVertexArray(0);
+		OpenGLStateCache::BindVertexArray(0);
 	}
 
 	void OpenGLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
 	{
 		KR_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBufferLayout empty.");
 
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		vertexBuffer->Bind();
 
 		uint32_t index = 0;
@@ -84,7 +102,7 @@ namespace Karma
 
 	void OpenGLVertexArray::SetIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;
@@ -95,7 +113,9 @@ namespace Karma
 		// Vertexbuffer stuff
 		KR_CORE_ASSERT(mesh->GetVertexBuffer()->GetLayout().GetElements().size(), "VertexBufferLayout empty.");
 
-		glBindVertexArray(m_RendererID);
+		SetDepthOnlyMesh(mesh);
+
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		mesh->GetVertexBuffer()->Bind();
 
 		uint32_t index = 0;
@@ -116,17 +136,63 @@ namespace Karma
 
 
 		// Index buffer stuff
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		mesh->GetIndexBuffer()->Bind();
 
 		// May need modificaitons for batch rendering later.
 		m_IndexBuffer = mesh->GetIndexBuffer();
+
+		TrackMesh(mesh);
+	}
+
+	void OpenGLVertexArray::SetDepthOnlyMesh(const std::shared_ptr<Mesh>& mesh)
+	{
+		OpenGLStateCache::BindVertexArray(m_DepthOnlyRendererID);
+		mesh->GetVertexBuffer()->Bind();
+
+		const auto& layout = mesh->GetVertexBuffer()->GetLayout();
+		const auto& position = layout.GetElements()[s_PositionLocation];
+
+		glEnableVertexAttribArray(s_PositionLocation);
+		glVertexAttribPointer(s_PositionLocation,
+			position.GetComponentCount(),
+			ShaderDataTypeToOpenGLBaseType(position.Type),
+			position.Normalized ? GL_TRUE : GL_FALSE,
+			layout.GetStride(),
+			(const void*)position.Offset);
+
+		mesh->GetIndexBuffer()->Bind();
 	}
 
 	void OpenGLVertexArray::SetMaterial(std::shared_ptr<Material> material)
 	{
 		m_Materials.push_back(material);
 		m_Shader = std::static_pointer_cast<OpenGLShader>(material->GetShader(0));
+
+		TrackMaterial(material);
+	}
+
+	void OpenGLVertexArray::OnAssetsReloaded()
+	{
+		// The program was swapped within the shader, the attributes of the new buffers are all there is to set
+		if (!GetMesh())
+		{
+			return;
+		}
+
+		OpenGLStateCache::BindVertexArray(m_RendererID);
+
+		// The new layout may have fewer attributes
+		for (const std::shared_ptr<VertexBuffer>& vertexBuffer : m_VertexBuffers)
+		{
+			for (uint32_t index = 0; index < uint32_t(vertexBuffer->GetLayout().GetElements().size()); index++)
+			{
+				glDisableVertexAttribArray(index);
+			}
+		}
+		m_VertexBuffers.clear();
+
+		SetMesh(GetMesh());
 	}
 
 	void OpenGLVertexArray::UpdateProcessAndSetReadyForSubmission() const
@@ -39,8 +39,9 @@ namespace Karma
 		virtual ~OpenGLVertexArray();
 
 		/**
-		 * @brief Binds the vertex array object
+		 * @brief Binds the vertex array object, the position only one during the depth pre-pass
 		 *
+		 * @see SetDepthOnlyPass
 		 * @since Karma 1.0.0
 		 */
 		virtual void Bind() const override;
@@ -52,6 +53,17 @@ namespace Karma
 		 */
 		virtual void UnBind() const override;
 
+		/**
+		 * @brief Makes Bind pick the position only vertex array, fetching the mesh's position attribute and nothing else, for the draws of
+		 * the depth pre-pass. The other attributes of the program read their constant current values.
+		 *
+		 * @param bDepthOnly						Whether the depth pre-pass is being drawn (OpenGLRendererAPI::BeginPass and EndPass)
+		 *
+		 * @see RenderPassType::DepthPrePass
+		 * @since Karma 1.0.0
+		 */
+		static void SetDepthOnlyPass(bool bDepthOnly) { s_bDepthOnlyPass = bDepthOnly; }
+
 		// For legacy purposes. Use Mesh abstraction
 
 		virtual void AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer) override;
@@ -105,9 +117,40 @@ namespace Karma
 		 */
 		virtual void UpdateProcessAndSetReadyForSubmission() const override;
 
+		/**
+		 * @brief Getter for the shader of the (first) material
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::shared_ptr<OpenGLShader>& GetShader() const { return m_Shader; }
+
+	protected:
+		/**
+		 * @brief Points the attributes at the mesh's new buffers
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void OnAssetsReloaded() override;
+
+	private:
+		/**
+		 * @brief Points the position only vertex array at the mesh's position attribute and index buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SetDepthOnlyMesh(const std::shared_ptr<Mesh>& mesh);
+
 	private:
 		uint32_t m_RendererID;
 
+		// Of the depth pre-pass, as VulkanVertexArray's depth only pipeline
+		uint32_t m_DepthOnlyRendererID;
+
+		// Of the attribute the depth only vertex array enables
+		static constexpr uint32_t s_PositionLocation = 0;
+
+		static bool s_bDepthOnlyPass;
+
 		std::vector<std::shared_ptr<VertexBuffer>> m_VertexBuffers;
 		std::shared_ptr<IndexBuffer> m_IndexBuffer;
 
@@ -4,6 +4,7 @@
 #include "KarmaUtilities.h"
 #include "Platform/Vulkan/VulkanVertexArray.h"
 #include "Karma/KarmaGui/KarmaGuiRenderer.h"
+#include "Karma/Renderer/UniformBufferRing.h"
 
 // Visual Studio warnings
 /*#ifdef _MSC_VER
@@ -164,7 +165,7 @@ namespace Karma
 			VkBuffer vertexBuffers[1] = { vulkanVA->GetVertexBuffer()->GetVertexBuffer() };
 			VkDeviceSize vertexOffset[1] = { 0 };
 			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, vertexOffset);
-			vkCmdBindIndexBuffer(commandBuffer, vulkanVA->GetIndexBuffer()->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+			vkCmdBindIndexBuffer(commandBuffer, vulkanVA->GetIndexBuffer()->GetIndexBuffer(), 0, vulkanVA->GetIndexBuffer()->GetVulkanIndexType());
 		}
 
 		// Setup viewport:
@@ -173,9 +174,8 @@ namespace Karma
 			{
 				KGGuiWindow* windowToRenderWithin = static_cast<KGGuiWindow*>(sceneToDraw->GetRenderingWindow());
 
+				// Viewport is dynamic state of the pipeline, no rebuild needed
 				vulkanVA->CreateExternalViewPort(windowToRenderWithin->Pos.x * drawData->FramebufferScale.x, (windowToRenderWithin->Pos.y + windowToRenderWithin->TitleBarHeight()) * drawData->FramebufferScale.y , windowToRenderWithin->Size.x * drawData->FramebufferScale.x , (windowToRenderWithin->Size.y - windowToRenderWithin->TitleBarHeight()) * drawData->FramebufferScale.y);
-				vulkanVA->CleanupPipeline();
-				vulkanVA->RecreateVulkanVA();
 				sceneToDraw->SetWindowToRenderWithinResize(false);
 			}
 		}
@@ -185,6 +185,19 @@ namespace Karma
 			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, static_pointer_cast<VulkanVertexArray>(sceneToDraw->GetRenderableVertexArray())->GetGraphicsPipeline());
 		}
 
+		// Dynamic viewport and scissor of the 3D pipeline
+		{
+			VkExtent2D extent = VulkanHolder::GetVulkanContext()->GetSwapChainExtent();
+
+			VkViewport viewport = vulkanVA->GetViewport(extent);
+			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+			VkRect2D scissor;
+			scissor.offset = { 0, 0 };
+			scissor.extent = extent;
+			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+		}
+
 	}
 
 	void KarmaGuiVulkanHandler::KarmaGui_ImplVulkan_SetupRenderState(KGDrawData* drawData, VkPipeline pipeline, VkCommandBuffer commandBuffer, KarmaGui_ImplVulkanH_ImageFrameRenderBuffers* remderingBufferData, int width, int height)
@@ -383,10 +396,16 @@ namespace Karma
 							vulkanVA->UpdateProcessAndSetReadyForSubmission();
 							vulkanVA->Bind();
 
-							VulkanHolder::GetVulkanContext()->UploadUBO(frameIndex);
+							// Uniforms were pushed into the uniform ring by UpdateProcessAndSetReadyForSubmission
+							uint32_t dynamicOffset = vulkanVA->GetShader()->GetUniformBufferObject()->GetRingOffset();
+							VkDescriptorSet descriptorSet = vulkanVA->GetDescriptorSet();
 
-							vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanVA->GetGraphicsPipelineLayout(), 0, 1, &vulkanVA->GetDescriptorSets()[frameIndex], 0, nullptr);
-							vkCmdDrawIndexed(commandBuffer, vulkanVA->GetIndexBuffer()->GetCount(), 1, 0, 0, 0);
+							// Unless the ring's frame region was full
+							if (dynamicOffset != UniformBufferRing::s_InvalidOffset)
+							{
+								vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanVA->GetGraphicsPipelineLayout(), 0, 1, &descriptorSet, 1, &dynamicOffset);
+								vkCmdDrawIndexed(commandBuffer, vulkanVA->GetIndexBuffer()->GetCount(), 1, 0, 0, 0);
+							}
 						}
 					}
 				}
@@ -1359,7 +1378,6 @@ namespace Karma
 		windowData->RenderArea.offset = { 0, 0 };
 		windowData->RenderPass = VulkanHolder::GetVulkanContext()->GetRenderPass();
 		windowData->MAX_FRAMES_IN_FLIGHT = vulkanAPI->GetMaxFramesInFlight();
-		windowData->CommandPool = VulkanHolder::GetVulkanContext()->GetCommandPool();
 		windowData->ImageFrameIndex = 0;
 
 		KR_CORE_ASSERT(windowData->ImageFrames == nullptr, "Somehow frames are still occupied. Please clear them.");
@@ -1411,16 +1429,38 @@ namespace Karma
 			}
 
 			windowData->SemaphoreIndex = 0;
-		}
 
-		KR_CORE_ASSERT(windowData->FramesOnFlight != nullptr, "Commandbuffers are being assigned without enough resources");
-		vulkanAPI->AllocateCommandBuffers();
+			// KarmaGui's own pool and command buffers. The renderer's are guarded by its fences, which KarmaGui doesn't wait on, so
+			// recording into those may hit one still pending on the GPU.
+			VkCommandPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			poolInfo.queueFamilyIndex = vulkanInfo->QueueFamily;
 
-		for (uint32_t counter = 0; counter < windowData->MAX_FRAMES_IN_FLIGHT; counter++)
-		{
-			KarmaGui_Vulkan_Frame_On_Flight* frameOnFlight = &windowData->FramesOnFlight[counter];
-			frameOnFlight->CommandBuffer = vulkanAPI->GetCommandBuffers()[counter];
+			VkResult result = vkCreateCommandPool(vulkanInfo->Device, &poolInfo, VK_NULL_HANDLE, &windowData->CommandPool);
+
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create command pool");
+
+			std::vector<VkCommandBuffer> commandBuffers(windowData->MAX_FRAMES_IN_FLIGHT);
+
+			VkCommandBufferAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = windowData->CommandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = uint32_t(commandBuffers.size());
+
+			result = vkAllocateCommandBuffers(vulkanInfo->Device, &allocInfo, commandBuffers.data());
+
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate command buffers");
+
+			for (uint32_t counter = 0; counter < windowData->MAX_FRAMES_IN_FLIGHT; counter++)
+			{
+				windowData->FramesOnFlight[counter].CommandBuffer = commandBuffers[counter];
+			}
 		}
+
+		KR_CORE_ASSERT(windowData->FramesOnFlight != nullptr && windowData->CommandPool != VK_NULL_HANDLE,
+			"Commandbuffers are being assigned without enough resources");
 	}
 
 	void KarmaGuiVulkanHandler::ClearVulkanWindowData(KarmaGui_ImplVulkanH_Window* vulkanWindowData, bool bDestroySyncronicity)
@@ -1462,9 +1502,17 @@ namespace Karma
 			vulkanWindowData->FramesOnFlight = nullptr;
 		}
 
+		// The command buffers of the frames on flight go with the pool, the device was waited upon above
+		if (bDestroySyncronicity && vulkanWindowData->CommandPool != VK_NULL_HANDLE)
+		{
+			KarmaGui_ImplVulkan_Data* backendData = KarmaGuiRenderer::GetBackendRendererUserData();
+
+			vkDestroyCommandPool(backendData->VulkanInitInfo.Device, vulkanWindowData->CommandPool, VK_NULL_HANDLE);
+			vulkanWindowData->CommandPool = VK_NULL_HANDLE;
+		}
+
 		vulkanWindowData->TotalImageCount = 0;
 		vulkanWindowData->SemaphoreIndex = 0;
-		vulkanWindowData->CommandPool = VK_NULL_HANDLE;
 	}
 
 	void KarmaGuiVulkanHandler::DestroyWindowDataFrame(KarmaGui_ImplVulkanH_ImageFrame* frame)
@@ -90,7 +90,7 @@ namespace Karma
 		VkQueue                         Queue;
 
 		/**
-		 * @brief A fresh descriptor pool created in KarmaGuiRenderer::CreateDescriptorPool() (seperate from VulkanVertexArray::CreateDescriptorPool()) for the uniforms and texture purposes. In this backend chiefly for KarmaGuiVulkanHandler::KarmaGui_ImplVulkan_AddTexture routine.
+		 * @brief A fresh descriptor pool created in KarmaGuiRenderer::CreateDescriptorPool() (seperate from the VulkanDescriptorCache pools used by VulkanVertexArray) for the uniforms and texture purposes. In this backend chiefly for KarmaGuiVulkanHandler::KarmaGui_ImplVulkan_AddTexture routine.
 		 *
 		 * @since Karma 1.0.0
 		 */
@@ -305,7 +305,8 @@ namespace Karma
 		VkSwapchainKHR      Swapchain;
 
 		/**
-		 * @brief Command pools manage the memory that is used to store the buffers and command buffers are allocated from them. Taken from VulkanContext::CreateCommandPool()
+		 * @brief Command pools manage the memory that is used to store the buffers and command buffers are allocated from them. KarmaGui's own, on the
+		 * graphics family, for the command buffers of the FramesOnFlight, so that it never records into the renderer's ones.
 		 *
 		 * @since Karma 1.0.0
 		 */
@@ -1094,12 +1095,13 @@ namespace Karma
 		/**
 		 * @brief The purpose of the routine is two-fold
 		 * 
-		 * - Share the Vulkan resources, including Swapchain, Renderpass, CommandPool, Framebuffer, and all that, of MainWindow (stored in VulkanContext of VulkanHolder, initialized during VulkanContext::Init() which gets called
+		 * - Share the Vulkan resources, including Swapchain, Renderpass, Framebuffer, and all that, of MainWindow (stored in VulkanContext of VulkanHolder, initialized during VulkanContext::Init() which gets called
 		 *  on Platform(Windows, Mac, and Linux)Window during their specific creation implementation, for instance LinuxWindow::Init) to KarmaGui's backend, after appropriate clearence.
 		 * - Ground work for establishing syncronicity, in GPU side functions' execution, by creating semaphores for (https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Synchronization)
 		 *      -# to signal that image has been acquired from the swapchain and ready for rendering
 		 *      -# to signal that rendering has finished and presentation (the last step of drawing a frame is submitting the result back to the swap chain to have it eventually show up on the screen) can happen
 		 * The set number of semaphores (we are using two types of them) are for number of "frames in flight" which represent the number of frames which can be processed on CPU whilst rendering is done on GPU
+		 *      -# along with a command pool and a command buffer per frame in flight of KarmaGui's own, guarded by its own fences
 		 * 
 		 * @param windowData											The datastructure to hold all the data needed by one rendering Vulkan context.
 		 * @param bCreateSyncronicity									Should we allocate semaphores and fences. For instance true during KarmaGuiRenderer::SetUpKarmaGuiRenderer and false during KarmaGuiRenderer::GiveLoopBeginControlToVulkan
@@ -0,0 +1,319 @@
+#include "VulkanBindlessTable.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+#include "Karma/Renderer/RenderThread.h"
+
+namespace Karma
+{
+	VulkanBindlessTable::VulkanBindlessTable(VkDevice device, uint32_t maxTextures) : m_Device(device), m_MaxTextures(maxTextures),
+		m_DescriptorSetLayout(VK_NULL_HANDLE), m_DescriptorPool(VK_NULL_HANDLE), m_DescriptorSet(VK_NULL_HANDLE), m_MaterialBuffer(VK_NULL_HANDLE),
+		m_MaterialBufferMemory(VK_NULL_HANDLE), m_MappedMaterials(nullptr), m_NextTextureSlot(0),
+		m_NumberOfAllocatedSlots(0)
+	{
+		CreateDescriptorSetLayout();
+		CreateMaterialBuffer();
+		CreateDescriptorSet();
+
+		KR_CORE_INFO("Bindless textures enabled: {0} texture slots, {1} material entries", m_MaxTextures, s_MaxMaterials);
+	}
+
+	VulkanBindlessTable::~VulkanBindlessTable()
+	{
+		vkUnmapMemory(m_Device, m_MaterialBufferMemory);
+		vkDestroyBuffer(m_Device, m_MaterialBuffer, nullptr);
+		vkFreeMemory(m_Device, m_MaterialBufferMemory, nullptr);
+
+		// Frees the set as well
+		vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
+	}
+
+	void VulkanBindlessTable::CreateDescriptorSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = m_MaxTextures;
+		bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// Unused slots may hold nothing, and slots may be written while command buffers using the set are pending
+		std::array<VkDescriptorBindingFlags, 2> bindingFlags{};
+		bindingFlags[0] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+		bindingFlags[1] = 0;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+		bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+		bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &bindingFlagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkResult result = vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_DescriptorSetLayout);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create bindless descriptor set layout!");
+	}
+
+	void VulkanBindlessTable::CreateMaterialBuffer()
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		const VkDeviceSize bufferSize = sizeof(BindlessMaterialEntry) * s_MaxMaterials;
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = bufferSize;
+		bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &m_MaterialBuffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create material table");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(m_Device, m_MaterialBuffer, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = context->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &m_MaterialBufferMemory);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate material table memory");
+
+		vkBindBufferMemory(m_Device, m_MaterialBuffer, m_MaterialBufferMemory, 0);
+
+		// Persistently mapped, the entries are few and small so they are written in place
+		void* data;
+		vkMapMemory(m_Device, m_MaterialBufferMemory, 0, bufferSize, 0, &data);
+		m_MappedMaterials = static_cast<BindlessMaterialEntry*>(data);
+
+		memset(m_MappedMaterials, 0, size_t(bufferSize));
+	}
+
+	void VulkanBindlessTable::CreateDescriptorSet()
+	{
+		std::array<VkDescriptorPoolSize, 2> poolSizes{};
+		poolSizes[0] = { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_MaxTextures };
+		poolSizes[1] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 };
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = 1;
+
+		VkResult result = vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_DescriptorPool);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create bindless descriptor pool!");
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+		result = vkAllocateDescriptorSets(m_Device, &allocInfo, &m_DescriptorSet);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate bindless descriptor set!");
+
+		// The material table never moves, written once
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = m_MaterialBuffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = VK_WHOLE_SIZE;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = m_DescriptorSet;
+		descriptorWrite.dstBinding = 1;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device, 1, &descriptorWrite, 0, nullptr);
+	}
+
+	uint32_t VulkanBindlessTable::RegisterTexture(VkImageView imageView, VkSampler sampler)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto found = m_TextureSlots.find(imageView);
+		if (found != m_TextureSlots.end())
+		{
+			return found->second;
+		}
+
+		uint32_t slot = TakeTextureSlot();
+
+		if (slot == s_InvalidSlot)
+		{
+			KR_CORE_WARN("Bindless texture array is full ({0} slots), reusing slot 0", m_MaxTextures);
+			return 0;
+		}
+
+		WriteTextureSlot(slot, imageView, sampler);
+
+		m_TextureSlots[imageView] = slot;
+
+		m_Statistics.m_NumberOfTextures = uint32_t(m_TextureSlots.size()) + m_NumberOfAllocatedSlots;
+
+		return slot;
+	}
+
+	uint32_t VulkanBindlessTable::AllocateTextureSlot(VkImageView imageView, VkSampler sampler)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint32_t slot = TakeTextureSlot();
+
+		if (slot == s_InvalidSlot)
+		{
+			KR_CORE_WARN("Bindless texture array is full ({0} slots)", m_MaxTextures);
+			return s_InvalidSlot;
+		}
+
+		WriteTextureSlot(slot, imageView, sampler);
+
+		m_NumberOfAllocatedSlots++;
+		m_Statistics.m_NumberOfTextures = uint32_t(m_TextureSlots.size()) + m_NumberOfAllocatedSlots;
+
+		return slot;
+	}
+
+	void VulkanBindlessTable::FreeTextureSlot(uint32_t slot)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		if (slot == s_InvalidSlot)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		KR_CORE_ASSERT(m_NumberOfAllocatedSlots > 0, "Freeing a slot which wasn't allocated");
+
+		m_FreeTextureSlots.push_back(slot);
+
+		m_NumberOfAllocatedSlots--;
+		m_Statistics.m_NumberOfTextures = uint32_t(m_TextureSlots.size()) + m_NumberOfAllocatedSlots;
+	}
+
+	void VulkanBindlessTable::RetargetMaterials(uint32_t previousSlot, uint32_t slot)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// The frames in flight read either slot, both being valid till the previous one is freed
+		for (const auto& materialEntry : m_MaterialEntries)
+		{
+			if (m_MappedMaterials[materialEntry.second].m_AlbedoTextureIndex == previousSlot)
+			{
+				m_MappedMaterials[materialEntry.second].m_AlbedoTextureIndex = slot;
+			}
+		}
+	}
+
+	uint32_t VulkanBindlessTable::TakeTextureSlot()
+	{
+		if (!m_FreeTextureSlots.empty())
+		{
+			const uint32_t slot = m_FreeTextureSlots.back();
+			m_FreeTextureSlots.pop_back();
+
+			return slot;
+		}
+
+		if (m_NextTextureSlot < m_MaxTextures)
+		{
+			return m_NextTextureSlot++;
+		}
+
+		return s_InvalidSlot;
+	}
+
+	void VulkanBindlessTable::WriteTextureSlot(uint32_t slot, VkImageView imageView, VkSampler sampler)
+	{
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = imageView;
+		imageInfo.sampler = sampler;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = m_DescriptorSet;
+		descriptorWrite.dstBinding = 0;
+		descriptorWrite.dstArrayElement = slot;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(m_Device, 1, &descriptorWrite, 0, nullptr);
+
+		m_Statistics.m_TextureWrites++;
+	}
+
+	void VulkanBindlessTable::ReleaseTexture(VkImageView imageView)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto found = m_TextureSlots.find(imageView);
+		if (found == m_TextureSlots.end())
+		{
+			return;
+		}
+
+		// The slot keeps the stale descriptor till it is given out again. Being partially bound, that is fine as long as no
+		// shader reads it, which holds since the materials using the texture are gone by now.
+		m_FreeTextureSlots.push_back(found->second);
+		m_TextureSlots.erase(found);
+
+		m_Statistics.m_NumberOfTextures = uint32_t(m_TextureSlots.size()) + m_NumberOfAllocatedSlots;
+	}
+
+	uint32_t VulkanBindlessTable::RegisterMaterial(uint32_t materialID, const BindlessMaterialEntry& entry)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The bindless table is changed while the render thread plays a frame");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint32_t index;
+
+		auto found = m_MaterialEntries.find(materialID);
+		if (found != m_MaterialEntries.end())
+		{
+			index = found->second;
+		}
+		else if (m_MaterialEntries.size() < s_MaxMaterials)
+		{
+			index = uint32_t(m_MaterialEntries.size());
+			m_MaterialEntries[materialID] = index;
+
+			m_Statistics.m_NumberOfMaterials = uint32_t(m_MaterialEntries.size());
+		}
+		else
+		{
+			KR_CORE_WARN("Bindless material table is full ({0} entries), reusing entry 0", s_MaxMaterials);
+			return 0;
+		}
+
+		m_MappedMaterials[index] = entry;
+
+		return index;
+	}
+}
@@ -0,0 +1,249 @@
+/**
+ * @file VulkanBindlessTable.h
+ * @brief This file contains VulkanBindlessTable class, the one descriptor array of all the textures and the GPU side material table.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "vulkan/vulkan.h"
+
+#include <mutex>
+
+namespace Karma
+{
+	/**
+	 * @brief An entry of the material table, as read by the shaders (std430, see Resources/Shaders/shader.frag)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API BindlessMaterialEntry
+	{
+		/**
+		 * @brief Index of the albedo texture in the texture array
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_AlbedoTextureIndex = 0;
+
+		/**
+		 * @brief Keeps the entry 16 bytes, room for more textures and factors
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Padding[3] = { 0, 0, 0 };
+	};
+
+	/**
+	 * @brief Counters gathered by VulkanBindlessTable
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API BindlessStatistics
+	{
+		/**
+		 * @brief Textures (slots of the array) presently registered
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfTextures = 0;
+
+		/**
+		 * @brief Materials (entries of the table) presently registered
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfMaterials = 0;
+
+		/**
+		 * @brief Descriptor writes issued for the texture array
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_TextureWrites = 0;
+	};
+
+	/**
+	 * @brief Descriptor indexing (bindless) resources of the Vulkan backend, a single descriptor set (bound as set s_SetIndex) holding
+	 * - binding 0: an array of combined image samplers, one slot for each texture in use
+	 * - binding 1: the material table, a storage buffer of BindlessMaterialEntry
+	 *
+	 * The shaders read the material index from a push constant and fetch the textures through the table, so a draw with any material needs no
+	 * descriptor rebind. The array is partially bound and updated after bind, so textures may be registered while frames are in flight.
+	 *
+	 * Created by VulkanContext only if the device supports the needed descriptor indexing features, the vertex arrays fall back to the
+	 * per material descriptor sets otherwise.
+	 *
+	 * @note Registered into by the render thread (or with it idle, see RenderThread::IsRenderingContext), like the vertex arrays are made
+	 * @see VulkanContext::SupportsBindless, VulkanVertexArray::CreateDescriptorSets
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanBindlessTable
+	{
+	public:
+		/**
+		 * @brief Creates the layout, pool, set and the material table buffer
+		 *
+		 * @param device						The logical device
+		 * @param maxTextures					Number of slots of the texture array (already clamped to the device limits)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanBindlessTable(VkDevice device, uint32_t maxTextures);
+
+		/**
+		 * @brief Destroys the buffer, pool and layout
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~VulkanBindlessTable();
+
+		/**
+		 * @brief Gives the texture a slot in the array, writing its descriptor. A texture registered already gets its slot back.
+		 *
+		 * @return The slot, to be put in a BindlessMaterialEntry
+		 * @since Karma 1.0.0
+		 */
+		uint32_t RegisterTexture(VkImageView imageView, VkSampler sampler);
+
+		/**
+		 * @brief Frees the slot of the texture. Called by the owner of the view before destroying it.
+		 *
+		 * @see VulkanTexture::~VulkanTexture
+		 * @since Karma 1.0.0
+		 */
+		void ReleaseTexture(VkImageView imageView);
+
+		/**
+		 * @brief Gives a slot of its own to the view, whether or not the view has one already, and writes its descriptor. For the textures
+		 * whose image is remade while in use (VulkanStreamedTexture), which move their materials to the new slot (RetargetMaterials)
+		 * and free the old one once the frames in flight are done with it.
+		 *
+		 * @return The slot, or s_InvalidSlot if the array is full
+		 * @since Karma 1.0.0
+		 */
+		uint32_t AllocateTextureSlot(VkImageView imageView, VkSampler sampler);
+
+		/**
+		 * @brief Frees a slot of AllocateTextureSlot, which no frame in flight may read anymore
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void FreeTextureSlot(uint32_t slot);
+
+		/**
+		 * @brief Points the materials sampling the slot previousSlot at slot instead
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RetargetMaterials(uint32_t previousSlot, uint32_t slot);
+
+		/**
+		 * @brief Gives the material an entry in the table (or returns the one it has) and writes the entry
+		 *
+		 * @param materialID					Identity of the material (Material::GetSortID)
+		 * @param entry							The contents of the entry
+		 *
+		 * @return Index of the entry, pushed as constant for the draws with the material
+		 * @since Karma 1.0.0
+		 */
+		uint32_t RegisterMaterial(uint32_t materialID, const BindlessMaterialEntry& entry);
+
+		/**
+		 * @brief Layout of the set, for the pipeline layouts of the bindless shaders
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+
+		/**
+		 * @brief The one set, bound as s_SetIndex
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const BindlessStatistics& GetStatistics() const { return m_Statistics; }
+
+	public:
+		/**
+		 * @brief Descriptor set index the table is bound at (set 0 holds the uniforms)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_SetIndex = 1;
+
+		/**
+		 * @brief Slots of the texture array asked for, fewer if the device allows fewer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_MaxTextures = 4096;
+
+		/**
+		 * @brief Entries of the material table
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_MaxMaterials = 4096;
+
+		/**
+		 * @brief Name of the texture array in the shaders, telling a bindless shader apart
+		 *
+		 * @see VulkanShader::UsesBindless
+		 * @since Karma 1.0.0
+		 */
+		static constexpr const char* s_TextureArrayName = "bindlessTextures";
+
+		/**
+		 * @brief No slot, the array being full
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_InvalidSlot = UINT32_MAX;
+
+	private:
+		void CreateDescriptorSetLayout();
+		void CreateDescriptorSet();
+		void CreateMaterialBuffer();
+
+		// With m_Mutex held
+		uint32_t TakeTextureSlot();
+		void WriteTextureSlot(uint32_t slot, VkImageView imageView, VkSampler sampler);
+
+	private:
+		VkDevice m_Device;
+		uint32_t m_MaxTextures;
+
+		VkDescriptorSetLayout m_DescriptorSetLayout;
+		VkDescriptorPool m_DescriptorPool;
+		VkDescriptorSet m_DescriptorSet;
+
+		VkBuffer m_MaterialBuffer;
+		VkDeviceMemory m_MaterialBufferMemory;
+		BindlessMaterialEntry* m_MappedMaterials;
+
+		// Slots given out, and the ones freed for reuse
+		std::unordered_map<VkImageView, uint32_t> m_TextureSlots;
+		std::vector<uint32_t> m_FreeTextureSlots;
+		uint32_t m_NextTextureSlot;
+
+		// Slots of AllocateTextureSlot, not keyed by view
+		uint32_t m_NumberOfAllocatedSlots;
+
+		std::unordered_map<uint32_t, uint32_t> m_MaterialEntries;
+
+		// The table is filled from the game thread and read by whoever records (render thread, recording workers)
+		std::mutex m_Mutex;
+
+		BindlessStatistics m_Statistics;
+	};
+}
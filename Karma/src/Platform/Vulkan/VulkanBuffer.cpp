@@ -2,6 +2,8 @@
 #include "Platform/Vulkan/VulkanHolder.h"
 #include "Karma/Renderer/RenderCommand.h"
 #include "Karma/KarmaUtilities.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+#include "Platform/Vulkan/VulkanUniformBufferRing.h"
 
 namespace Karma
 {
@@ -13,66 +15,22 @@ namespace Karma
 		VkDeviceSize bufferSize = size;
 		m_BufferSize = size;
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-
-		CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			stagingBuffer, stagingBufferMemory);
-
-		void* data;
-		vkMapMemory(m_Device, stagingBufferMemory, 0, size, 0, &data);
-		memcpy(data, vertices, (size_t)size);
-		vkUnmapMemory(m_Device, stagingBufferMemory);
-
-		CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 			m_VertexBuffer, m_VertexBufferMemory);
 
-		CopyBuffer(stagingBuffer, m_VertexBuffer, size);
-
-		vkDestroyBuffer(m_Device, stagingBuffer, nullptr);
-		vkFreeMemory(m_Device, stagingBufferMemory, nullptr);
+		// Staged in the upload ring, copied when the upload batch is flushed (before the draw)
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->UploadBuffer(m_VertexBuffer, vertices, bufferSize);
 	}
 
 	VulkanVertexBuffer::~VulkanVertexBuffer()
 	{
+		// The copy into this buffer may still be pending
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->WaitForUploads();
+
 		vkDestroyBuffer(m_Device, m_VertexBuffer, nullptr);
 		vkFreeMemory(m_Device, m_VertexBufferMemory, nullptr);
 	}
 
-	void VulkanVertexBuffer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
-	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = VulkanHolder::GetVulkanContext()->GetCommandPool();
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer);
-
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		VkBufferCopy copyRegion{};
-		copyRegion.size = size;
-		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-		vkEndCommandBuffer(commandBuffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		vkQueueSubmit(VulkanHolder::GetVulkanContext()->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(VulkanHolder::GetVulkanContext()->GetGraphicsQueue());
-
-		vkFreeCommandBuffers(m_Device, VulkanHolder::GetVulkanContext()->GetCommandPool(), 1, &commandBuffer);
-	}
-
 	void VulkanVertexBuffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
 		VkBuffer& buffer, VkDeviceMemory& bufferMemory)
 	{
@@ -80,7 +38,9 @@ namespace Karma
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size = size;
 		bufferInfo.usage = usage;
-		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		// Concurrent if a dedicated transfer queue writes the buffer
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->FillSharingMode(bufferInfo);
 
 		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer);
 
@@ -128,73 +88,37 @@ namespace Karma
 
 
 	// Index buffer
-	VulkanIndexBuffer::VulkanIndexBuffer(uint32_t* indices, uint32_t count) : m_Count(count)
+	VulkanIndexBuffer::VulkanIndexBuffer(uint32_t* indices, uint32_t count) : m_Count(count), m_IndexType(IndexType::UInt32)
 	{
-		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
-
-		VkDeviceSize bufferSize = sizeof(uint32_t) * count;
-		m_BufferSize = bufferSize;
+		UploadIndices(indices, sizeof(uint32_t) * count);
+	}
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
+	VulkanIndexBuffer::VulkanIndexBuffer(uint16_t* indices, uint32_t count) : m_Count(count), m_IndexType(IndexType::UInt16)
+	{
+		UploadIndices(indices, sizeof(uint16_t) * count);
+	}
 
-		CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			stagingBuffer, stagingBufferMemory);
+	void VulkanIndexBuffer::UploadIndices(const void* indices, VkDeviceSize bufferSize)
+	{
+		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
 
-		void* data;
-		vkMapMemory(m_Device, stagingBufferMemory, 0, bufferSize, 0, &data);
-		memcpy(data, indices, (size_t)bufferSize);
-		vkUnmapMemory(m_Device, stagingBufferMemory);
+		m_BufferSize = bufferSize;
 
 		CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 			m_IndexBuffer, m_IndexBufferMemory);
 
-		CopyBuffer(stagingBuffer, m_IndexBuffer, bufferSize);
-
-		vkDestroyBuffer(m_Device, stagingBuffer, nullptr);
-		vkFreeMemory(m_Device, stagingBufferMemory, nullptr);
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->UploadBuffer(m_IndexBuffer, indices, bufferSize);
 	}
 
 	VulkanIndexBuffer::~VulkanIndexBuffer()
 	{
+		// The copy into this buffer may still be pending
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->WaitForUploads();
+
 		vkDestroyBuffer(m_Device, m_IndexBuffer, nullptr);
 		vkFreeMemory(m_Device, m_IndexBufferMemory, nullptr);
 	}
 
-	void VulkanIndexBuffer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
-	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = VulkanHolder::GetVulkanContext()->GetCommandPool();
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer);
-
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		VkBufferCopy copyRegion{};
-		copyRegion.size = size;
-		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-		vkEndCommandBuffer(commandBuffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		vkQueueSubmit(VulkanHolder::GetVulkanContext()->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(VulkanHolder::GetVulkanContext()->GetGraphicsQueue());
-
-		vkFreeCommandBuffers(m_Device, VulkanHolder::GetVulkanContext()->GetCommandPool(), 1, &commandBuffer);
-	}
-
 	void VulkanIndexBuffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
 		VkBuffer& buffer, VkDeviceMemory& bufferMemory)
 	{
@@ -202,7 +126,9 @@ namespace Karma
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size = size;
 		bufferInfo.usage = usage;
-		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		// Concurrent if a dedicated transfer queue writes the buffer
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->FillSharingMode(bufferInfo);
 
 		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer);
 
@@ -251,177 +177,33 @@ namespace Karma
 	VulkanUniformBuffer::VulkanUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex) :
 		UniformBufferObject(dataTypes, bindingPointIndex)
 	{
-		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
-		BufferCreation();
 	}
 
 	VulkanUniformBuffer::~VulkanUniformBuffer()
 	{
-		//ClearBuffer();
-	}
-
-	void VulkanUniformBuffer::BufferCreation()
-	{
-		VkDeviceSize bufferSize = GetBufferSize();
-		
-		RendererAPI* rAPI = RenderCommand::GetRendererAPI();
-		VulkanRendererAPI* vulkanAPI = nullptr;
-		
-		if(rAPI->GetAPI() == RendererAPI::API::Vulkan)
-		{
-			vulkanAPI = static_cast<VulkanRendererAPI*>(rAPI);
-		}
-		else
-		{
-			KR_CORE_ASSERT(false, "How is this even possible?");
-		}
-		
-		int maxFramesInFlight = vulkanAPI->GetMaxFramesInFlight();
-
-		m_UniformBuffers.resize(maxFramesInFlight);
-		m_UniformBuffersMemory.resize(maxFramesInFlight);
-
-		for (size_t i = 0; i < maxFramesInFlight; i++)
-		{
-			CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-				VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_UniformBuffers[i], m_UniformBuffersMemory[i]);
-		}
-	}
-
-	void VulkanUniformBuffer::ClearBuffer()
-	{
-		for (size_t i = 0; i < m_UniformBuffers.size(); i++)
-		{
-			vkDestroyBuffer(m_Device, m_UniformBuffers[i], nullptr);
-			vkFreeMemory(m_Device, m_UniformBuffersMemory[i], nullptr);
-		}
 	}
 
 	void VulkanUniformBuffer::UploadUniformBuffer(size_t frameIndex)
 	{
-		uint32_t index = 0;
-		for (auto& it : GetUniformList())
-		{
-			size_t uniformSize = GetUniformSize()[index];
-			size_t offset = GetAlignedOffsets()[index++];
-			void* data;
-			vkMapMemory(m_Device, m_UniformBuffersMemory[frameIndex], offset, uniformSize, 0, &data);
-			memcpy(data, it.GetDataPointer(), uniformSize);
-			vkUnmapMemory(m_Device, m_UniformBuffersMemory[frameIndex]);
-		}
-	}
-
-	void VulkanUniformBuffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-		VkBuffer& buffer, VkDeviceMemory& bufferMemory)
-	{
-		VkBufferCreateInfo bufferInfo{};
-		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bufferInfo.size = size;
-		bufferInfo.usage = usage;
-		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer);
-
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create uniformbuffer");
-
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		VkResult resultm = vkAllocateMemory(m_Device, &allocInfo, nullptr, &bufferMemory);
-
-		KR_CORE_ASSERT(resultm == VK_SUCCESS, "Failed to allocate uniformbuffer memory");
-		vkBindBufferMemory(m_Device, buffer, bufferMemory, 0);
-	}
-
-	uint32_t VulkanUniformBuffer::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
-	{
-		VkPhysicalDeviceMemoryProperties memProperties;
-		vkGetPhysicalDeviceMemoryProperties(VulkanHolder::GetVulkanContext()->GetPhysicalDevice(), &memProperties);
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-		{
-			if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				return i;
-			}
-		}
-
-		KR_CORE_ASSERT(false, "Failed to find suitable memory type for uniformbuffer");
-		return 0;
+		m_RingOffset = VulkanHolder::GetVulkanContext()->GetUniformRing()->PushUniforms(*this);
 	}
 
 	// ImageBuffer
 	VulkanImageBuffer::VulkanImageBuffer(const char* filename)
 	{
-		stbi_uc* pixels = KarmaUtilities::GetImagePixelData(filename, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-
-		// Need more consideration on image size
-		VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-		KR_CORE_ASSERT(pixels, "Failed to load textures image!");
+		m_Pixels = KarmaUtilities::GetImagePixelData(filename, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
-		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
-		CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_StagingBuffer, m_StagingBufferMemory);
-		void* data;
-		vkMapMemory(m_Device, m_StagingBufferMemory, 0, imageSize, 0, &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
-		vkUnmapMemory(m_Device, m_StagingBufferMemory);
+		KR_CORE_ASSERT(m_Pixels, "Failed to load textures image!");
 
-		stbi_image_free(pixels);
+		// Need more consideration on image size
+		m_ImageSize = texWidth * texHeight * 4;
 	}
 
 	VulkanImageBuffer::~VulkanImageBuffer()
 	{
-		vkDestroyBuffer(m_Device, m_StagingBuffer, nullptr);
-		vkFreeMemory(m_Device, m_StagingBufferMemory, nullptr);
-	}
-
-	void VulkanImageBuffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-		VkBuffer& buffer, VkDeviceMemory& bufferMemory)
-	{
-		VkBufferCreateInfo bufferInfo{};
-		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bufferInfo.size = size;
-		bufferInfo.usage = usage;
-		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer);
-
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create uniformbuffer");
-
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		VkResult resultm = vkAllocateMemory(m_Device, &allocInfo, nullptr, &bufferMemory);
-
-		KR_CORE_ASSERT(resultm == VK_SUCCESS, "Failed to allocate imagebuffer memory");
-		vkBindBufferMemory(m_Device, buffer, bufferMemory, 0);
-	}
-
-	uint32_t VulkanImageBuffer::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
-	{
-		VkPhysicalDeviceMemoryProperties memProperties;
-		vkGetPhysicalDeviceMemoryProperties(VulkanHolder::GetVulkanContext()->GetPhysicalDevice(), &memProperties);
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+		if (m_Pixels)
 		{
-			if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				return i;
-			}
+			stbi_image_free(m_Pixels);
 		}
-
-		KR_CORE_ASSERT(false, "Failed to find suitable memory type for imagebuffer");
-		return 0;
 	}
 }
@@ -31,6 +31,9 @@ namespace Karma
 		 * One staging buffer in CPU accessible memory to upload the data from the vertex array to, and the final vertex buffer in device (GPU) local memory. We'll then use a buffer copy
 		 * command to move the data from the staging buffer to the actual vertex buffer.
 		 *
+		 * The staging is done by VulkanUploadManager in its persistent ring, and the copy is batched with other uploads, so no
+		 * staging buffer is created (and no queue idle wait happens) per vertex buffer.
+		 *
 		 * @param vertices						float array of interleaved vertex data (including position, uv, color, normal, and tangent) based on the BufferLayout
 		 * @param size							Size (in bytes) of the vertex buffer (number of mesh vertices * sum of each vertex attribute's size). For instance:
 		 *										@code{}
@@ -42,7 +45,7 @@ namespace Karma
 		 *										@endcode
 		 * 										will have size = 3 * (7 * sizeof(float)).
 		 *
-		 * @see Mesh::DealVertexIndexBufferData, VulkanVertexBuffer::CreateBuffer
+		 * @see Mesh::DealVertexIndexBufferData, VulkanVertexBuffer::CreateBuffer, VulkanUploadManager::UploadBuffer
 		 * @since Karma 1.0.0
 		 */
 		VulkanVertexBuffer(float* vertices, uint32_t size);
@@ -50,7 +53,7 @@ namespace Karma
 		/**
 		 * @brief Destructor
 		 *
-		 * Deletes the buffers and clears up Vulkan relevant resources
+		 * Deletes the buffers and clears up Vulkan relevant resources. Waits for pending uploads first.
 		 *
 		 * @since Karma 1.0.0
 		 */
@@ -108,16 +111,6 @@ namespace Karma
 		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
 			VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
-		/**
-		 * @brief Copy buffer
-		 *
-		 * @param srcBuffer							The source buffer to copy data from
-		 * @param dstBuffer							The destination buffer to copy data to
-		 * @param size								The total size of data in bytes
-		 * @since Karma 1.0.0
-		 */
-		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-
 		/**
 		 * @brief Finds appropriate memory type with demanded properties. Basically a loop is run from counter i = 0 to VkPhysicalDeviceMemoryProperties.memoryTypeCount
 		 * (number of valid elements in the memoryTypes array) and memoryType[i] is queried for appropriate properties. On condition satisfaction, counter i is returned.
@@ -184,6 +177,16 @@ namespace Karma
 		 */
 		VulkanIndexBuffer(uint32_t* indices, uint32_t count);
 
+		/**
+		 * @brief Constructor for 16 bit indices (bound with VK_INDEX_TYPE_UINT16)
+		 *
+		 * @param indices						The indices
+		 * @param count							Number of indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanIndexBuffer(uint16_t* indices, uint32_t count);
+
 		/**
 		 * @brief Destructor involving destruction of index buffer and freeing up of memory
 		 *
@@ -221,16 +224,6 @@ namespace Karma
 		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
 			VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
-		/**
-		 * @brief Copy buffer
-		 *
-		 * @param srcBuffer							The source buffer to copy data from
-		 * @param dstBuffer							The destination buffer to copy data to
-		 * @param size								The total size of data in bytes
-		 * @since Karma 1.0.0
-		 */
-		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-
 		/**
 		 * @brief Finds appropriate memory type with demanded properties. Basically a loop is run from counter i = 0 to VkPhysicalDeviceMemoryProperties.memoryTypeCount
 		 * (number of valid elements in the memoryTypes array) and memoryType[i] is queried for appropriate properties. On condition satisfaction, counter i is returned.
@@ -252,6 +245,20 @@ namespace Karma
 		 */
 		virtual uint32_t GetCount() const override { return m_Count; }
 
+		/**
+		 * @brief Width of the indices
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual IndexType GetIndexType() const override { return m_IndexType; }
+
+		/**
+		 * @brief The VkIndexType for vkCmdBindIndexBuffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		inline VkIndexType GetVulkanIndexType() const { return m_IndexType == IndexType::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32; }
+
 		/**
 		 * @brief Getter for indexbuffer
 		 *
@@ -273,9 +280,18 @@ namespace Karma
 		 */
 		inline size_t GetBufferSize() { return m_BufferSize; }
 
+	private:
+		/**
+		 * @brief Creates the device local buffer and stages the indices into it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void UploadIndices(const void* indices, VkDeviceSize bufferSize);
+
 	private:
 		VkDevice m_Device;
 		uint32_t m_Count;
+		IndexType m_IndexType;
 
 		VkBuffer m_IndexBuffer;
 		VkDeviceMemory m_IndexBufferMemory;
@@ -292,7 +308,8 @@ namespace Karma
 	{
 	public:
 		/**
-		 * @brief Constructor for Vulkan buffer. Calls VulkanUniformBuffer::BufferCreation().
+		 * @brief Constructor for Vulkan buffer. The buffer itself is VulkanContext's uniform ring (see VulkanUniformBufferRing), so no
+		 * Vulkan resources are created here.
 		 *
 		 * @param dataTypes						List of data types for uniforms to be uploaded to GPU (like used in shaders),
 		 * 								for instance https://github.com/ravimohan1991/KarmaEngine/blob/138c172ccedf31acfab982af51ae130f9a37d3bb/Application/src/KarmaApp.cpp#L39 where Mat4 are for https://github.com/ravimohan1991/KarmaEngine/blob/138c172ccedf31acfab982af51ae130f9a37d3bb/Resources/Shaders/shader.vert#L9-L13
@@ -303,84 +320,33 @@ namespace Karma
 		VulkanUniformBuffer(std::vector<ShaderDataType> dataTypes, uint32_t bindingPointIndex);
 
 		/**
-		 * @brief Destructor. For freeing up UBO resources, use VulkanUniformBuffer::ClearBuffer()
+		 * @brief Destructor
 		 *
-		 * @see VulkanContext::ClearUBO
 		 * @since Karma 1.0.0
 		 */
 		virtual ~VulkanUniformBuffer();
 
 		/**
-		 * @brief Creates Vulkan buffer (VKbuffer) for ubo use and allocates device memory appropriately
-		 *
-		 * @param size							The  size, in bytes, of the buffer to be created
-		 * @param properties					The demanded properties (https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkBufferUsageFlagBits.html). For instance (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-		 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-		 *
-		 * @see VulkanUniformBuffer::BufferCreation()
-		 * @since Karma 1.0.0
-		 */
-		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-			VkBuffer& buffer, VkDeviceMemory& bufferMemory);
-
-		/**
-		 * @brief Finds appropriate memory type with demanded properties. Basically a loop is run from counter i = 0 to VkPhysicalDeviceMemoryProperties.memoryTypeCount
-		 * (number of valid elements in the memoryTypes array) and memoryType[i] is queried for appropriate properties. On condition satisfaction, counter i is returned.
+		 * @brief Writes the uniforms (m_UniformList) into the persistently mapped uniform ring and caches the offset, which is supplied as
+		 * dynamic offset when binding the descriptor set
 		 *
-		 * @param typeFilter								A bitmask, and contains one bit set for every supported memory type for the resource. Bit i is set if and only if the memory type i in the VkPhysicalDeviceMemoryProperties structure for the physical device is supported for the resource.
-		 * @param properties								The demanded properties (https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkBufferUsageFlagBits.html).
+		 * @param frameIndex								Unused, the ring switches regions when VulkanContext::SwapBuffers is called
 		 *
-		 * @return Memory type index i
-		 * @since Karma 1.0.0
-		 */
-		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-
-		/**
-		 * @brief Getter for the uniform buffers
-		 *
-		 * @since Karma 1.0.0
-		 */
-		const std::vector<VkBuffer>& GetUniformBuffers() const { return m_UniformBuffers; }
-
-		/**
-		 * @brief Frees up the resources by destroying the buffer object(s) and clearing memory
-		 *
-		 * @since Karma 1.0.0
-		 */
-		void ClearBuffer();
-
-		/**
-		 * @brief Based on MAX_FRAMES_IN_FLIGHT (number of images (to work upon (CPU side) whilst an image is being rendered (GPU side processing)) + 1), uniform
-		 * buffers are created with appropriate buffer size.
-		 *
-		 * @since Karma 1.0.0.
-		 */
-		void BufferCreation();
-
-		/**
-		 * @brief Uploads (copies) the data from buffer memory (m_UniformBuffersMemory) to  host-accessible (CPU) pointer, m_UniformList, to the beginning of the mapped range
-		 *
-		 * @param frameIndex								The m_CurrentFrame index representing index of MAX_FRAMES_IN_FLIGHT (number of images (to work upon (CPU side) whilst an image is being rendered (GPU side processing)) + 1)
-		 *
-		 * @see VulkanRendererAPI::SubmitCommandBuffers()
+		 * @see VulkanRendererAPI::RecordCommandBuffers()
 		 * @since Karma 1.0.0
 		 */
 		void UploadUniformBuffer(size_t frameIndex) override;
-
-	private:
-		VkDevice m_Device;
-		std::vector<VkBuffer> m_UniformBuffers;
-		std::vector<VkDeviceMemory> m_UniformBuffersMemory;
 	};
 
 	/**
-	 * @brief Vulkan specific implemetation of ImageBuffer class.
+	 * @brief Vulkan specific implemetation of ImageBuffer class. Holds the decoded pixels (host side) till the texture
+	 * is uploaded via VulkanUploadManager::UploadImage.
 	 */
 	class KARMA_API VulkanImageBuffer : public ImageBuffer
 	{
 	public:
 		/**
-		 * @brief Creates a GPU memory buffer for storing image texture
+		 * @brief Decodes the image file into host memory
 		 *
 		 * @param filename								The path to the file, including filename, containing the image texture
 		 * @since Karma 1.0.0
@@ -388,36 +354,25 @@ namespace Karma
 		VulkanImageBuffer(const char* filename);
 
 		/**
-		 * @brief Frees up device resources
+		 * @brief Frees up the decoded pixels
 		 *
 		 * @since Karma 1.0.0
 		 */
 		virtual ~VulkanImageBuffer();
 
 		/**
-		 * @brief Creates Vulkan buffer (VKbuffer) for image texture's use and allocates device memory appropriately
-		 *
-		 * @param size							The  size, in bytes, of the buffer to be created
-		 * @param properties					The demanded properties (https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkBufferUsageFlagBits.html). For instance (VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		 * @brief Getter for the RGBA pixel data, arranged left-to-right, top-to-bottom
 		 *
-		 * @see VulkanUniformBuffer::BufferCreation()
 		 * @since Karma 1.0.0
 		 */
-		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-			VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+		const unsigned char* GetPixelData() const { return m_Pixels; }
 
 		/**
-		 * @brief Finds appropriate memory type with demanded properties. Basically a loop is run from counter i = 0 to VkPhysicalDeviceMemoryProperties.memoryTypeCount
-		 * (number of valid elements in the memoryTypes array) and memoryType[i] is queried for appropriate properties. On condition satisfaction, counter i is returned.
-		 *
-		 * @param typeFilter								A bitmask, and contains one bit set for every supported memory type for the resource. Bit i is set if and only if the memory type i in the VkPhysicalDeviceMemoryProperties structure for the physical device is supported for the resource.
-		 * @param properties								The demanded properties (https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkBufferUsageFlagBits.html).
+		 * @brief Getter for the size (in bytes) of pixel data
 		 *
-		 * @return Memory type index i
 		 * @since Karma 1.0.0
 		 */
-		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-		const inline VkBuffer& GetBuffer() const { return m_StagingBuffer; }
+		VkDeviceSize GetImageSize() const { return m_ImageSize; }
 
 		// Getters
 		/**
@@ -443,9 +398,8 @@ namespace Karma
 		int GetTextureChannels() const { return texChannels; }
 
 	private:
-		VkDevice m_Device;
-		VkBuffer m_StagingBuffer;
-		VkDeviceMemory m_StagingBufferMemory;
+		unsigned char* m_Pixels;
+		VkDeviceSize m_ImageSize;
 
 		// Image props (properties)
 		int texWidth;
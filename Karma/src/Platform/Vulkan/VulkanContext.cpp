@@ -6,6 +6,13 @@
 #include "Karma/Renderer/RenderCommand.h"
 #include "Platform/Vulkan/VulkanVertexArray.h"
 #include "Platform/Vulkan/VulkanBuffer.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+#include "Platform/Vulkan/VulkanUniformBufferRing.h"
+#include "Platform/Vulkan/VulkanDescriptorCache.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+#include "Karma/CommandLine.h"
+#include <chrono>
+#include <algorithm>
 
 namespace Karma
 {
@@ -19,6 +26,17 @@ namespace Karma
 	bool VulkanContext::bEnableValidationLayers = false;
 #endif
 
+	bool VulkanContext::s_bBindlessAllowed = true;
+	uint32_t VulkanContext::s_ResizeBenchmarkInterval = 0;
+
+	// Vulkan only, OpenGL binds a texture per material anyway
+	static CommandLineOption s_BindlessOption("bindless", "--bindless=off keeps Vulkan on the per material descriptor sets even if the device supports descriptor indexing",
+		[](const std::string& value) { VulkanContext::SetBindlessAllowed(value != "off"); });
+
+	// Vulkan only, OpenGL's default framebuffer is resized by the driver
+	static CommandLineOption s_ResizeBenchmarkOption("resize-benchmark", "--resize-benchmark=N recreates the Vulkan swapchain every N frames and logs the latencies",
+		[](const std::string& value) { VulkanContext::SetResizeBenchmarkInterval(uint32_t(CommandLine::ParseNumber(value, 0))); });
+
 	VulkanContext::VulkanContext(GLFWwindow* windowHandle)
 		: m_windowHandle(windowHandle)
 	{
@@ -29,7 +47,32 @@ namespace Karma
 	VulkanContext::~VulkanContext()
 	{
 		m_vulkanRendererAPI->ClearVulkanRendererAPI();
-		ClearUBO();
+
+		// The device is idle now
+		DestroyRetiredSwapChains(true);
+
+		if (m_SwapChainRecreationStatistics.m_NumberOfRecreations > 0)
+		{
+			KR_CORE_INFO("VulkanContext: {0} swapchain recreation(s) ({1} with the render pass rebuilt), average {2} ms, last {3} ms, max {4} ms",
+				m_SwapChainRecreationStatistics.m_NumberOfRecreations, m_SwapChainRecreationStatistics.m_NumberOfRenderPassRebuilds,
+				m_SwapChainRecreationStatistics.m_AverageMilliseconds, m_SwapChainRecreationStatistics.m_LastMilliseconds,
+				m_SwapChainRecreationStatistics.m_MaxMilliseconds);
+		}
+
+		delete m_BindlessTable;
+		m_BindlessTable = nullptr;
+
+		delete m_DescriptorCache;
+		m_DescriptorCache = nullptr;
+
+		vkDestroyPipelineCache(m_device, m_PipelineCache, nullptr);
+		m_PipelineCache = VK_NULL_HANDLE;
+
+		delete m_UniformRing;
+		m_UniformRing = nullptr;
+
+		delete m_InstanceRing;
+		m_InstanceRing = nullptr;
 
 		for (auto framebuffer : m_swapChainFrameBuffers)
 		{
@@ -40,6 +83,9 @@ namespace Karma
 		vkDestroyImage(m_device, m_DepthImage, nullptr);
 		vkFreeMemory(m_device, m_DepthImageMemory, nullptr);
 
+		delete m_UploadManager;
+		m_UploadManager = nullptr;
+
 		vkDestroyCommandPool(m_device, m_commandPool, nullptr);
 		vkDestroyRenderPass(m_device, m_renderPass, nullptr);
 		for (auto imageView : m_swapChainImageViews)
@@ -60,35 +106,6 @@ namespace Karma
 		glslang::FinalizeProcess();
 	}
 
-	void VulkanContext::RegisterUBO(const std::shared_ptr<VulkanUniformBuffer>& ubo)
-	{
-		m_VulkanUBO.insert(ubo);
-	}
-
-	void VulkanContext::UploadUBO(size_t frameIndex)
-	{
-		for (auto ubo : m_VulkanUBO)
-		{
-			ubo->UploadUniformBuffer(frameIndex);
-		}
-	}
-
-	void VulkanContext::ClearUBO()
-	{
-		for (auto ubo : m_VulkanUBO)
-		{
-			ubo->ClearBuffer();
-		}
-	}
-
-	void VulkanContext::RecreateUBO()
-	{
-		for (auto ubo : m_VulkanUBO)
-		{
-			ubo->BufferCreation();
-		}
-	}
-
 	void VulkanContext::Init()
 	{
 		CreateInstance();
@@ -100,11 +117,34 @@ namespace Karma
 		CreateImageViews();
 		CreateRenderPass();
 		CreateCommandPool();
+
+		QueueFamilyIndices indices = FindQueueFamilies(m_physicalDevice);
+		uint32_t transferFamily = indices.transferFamily.has_value() ? indices.transferFamily.value() : indices.graphicsFamily.value();
+		m_UploadManager = new VulkanUploadManager(this, m_transferQueue, transferFamily, indices.graphicsFamily.value());
+
 		CreateDepthResources();
 		CreateFrameBuffers();
 
 		VulkanHolder::SetVulkanContext(this);
 
+		// Per frame uniforms. A region is reused only after every swapchain image (KarmaGui may have that many frames in flight) has come around.
+		m_UniformRing = new VulkanUniformBufferRing(RingBufferType::Uniform, s_UniformRingBytesPerFrame, GetImageCount() + 1);
+		m_InstanceRing = new VulkanUniformBufferRing(RingBufferType::Vertex, s_InstanceRingBytesPerFrame, GetImageCount() + 1);
+
+		m_DescriptorCache = new VulkanDescriptorCache(m_device, m_vulkanRendererAPI->GetMaxFramesInFlight());
+
+		VkPipelineCacheCreateInfo pipelineCacheInfo{};
+		pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+		VkResult result = vkCreatePipelineCache(m_device, &pipelineCacheInfo, nullptr, &m_PipelineCache);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline cache!");
+
+		// Textures indexed by material in the shaders, else a descriptor set per material
+		if (m_bSupportsBindless)
+		{
+			m_BindlessTable = new VulkanBindlessTable(m_device, m_MaxBindlessTextures);
+		}
+
 		m_vulkanRendererAPI->CreateSynchronicity();
 
 		// For glslang
@@ -119,17 +159,108 @@ namespace Karma
 
 	void VulkanContext::SwapBuffers()
 	{
+		m_UniformRing->BeginFrame();
+		m_InstanceRing->BeginFrame();
+
+		m_FrameSerial++;
+		DestroyRetiredSwapChains(false);
+
+		// The render thread is done with the frame (see Application::Run) and KarmaGui picks the new swapchain up on its next frame
+		if (s_ResizeBenchmarkInterval > 0 && m_FrameSerial % s_ResizeBenchmarkInterval == 0)
+		{
+			m_bSimulateSmallerExtent = !m_bSimulateSmallerExtent;
+
+			if (RecreateSwapChain())
+			{
+				KR_CORE_WARN("VulkanContext: the surface format changed during the resize benchmark, pipelines are stale");
+			}
+		}
 	}
 
-	void VulkanContext::RecreateSwapChain()
+	bool VulkanContext::RecreateSwapChain()
 	{
-		CleanupSwapChain();
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
 
-		CreateSwapChain();
+		// The frames in flight may still be using these, so they are destroyed a few frames later instead of waiting for the device
+		RetiredSwapChain retired;
+		retired.m_SwapChain = m_swapChain;
+		retired.m_ImageViews = std::move(m_swapChainImageViews);
+		retired.m_FrameBuffers = std::move(m_swapChainFrameBuffers);
+		retired.m_DepthImage = m_DepthImage;
+		retired.m_DepthImageMemory = m_DepthImageMemory;
+		retired.m_DepthImageView = m_DepthImageView;
+		retired.m_RetiredFrame = m_FrameSerial;
+		retired.m_ImageCount = GetImageCount();
+
+		m_swapChainImageViews.clear();
+		m_swapChainFrameBuffers.clear();
+
+		VkFormat previousFormat = m_swapChainImageFormat;
+
+		CreateSwapChain(retired.m_SwapChain);
 		CreateImageViews();
-		CreateRenderPass();
+
+		// Render passes (and so the pipelines) stay compatible as long as the attachment formats do
+		bool bRenderPassRebuilt = m_swapChainImageFormat != previousFormat;
+		if (bRenderPassRebuilt)
+		{
+			retired.m_RenderPass = m_renderPass;
+			CreateRenderPass();
+		}
+
 		CreateDepthResources();
 		CreateFrameBuffers();
+
+		m_RetiredSwapChains.push_back(std::move(retired));
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		SwapChainRecreationStatistics& statistics = m_SwapChainRecreationStatistics;
+
+		statistics.m_NumberOfRecreations++;
+		statistics.m_NumberOfRenderPassRebuilds += bRenderPassRebuilt ? 1 : 0;
+		statistics.m_LastMilliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+		statistics.m_AverageMilliseconds += (statistics.m_LastMilliseconds - statistics.m_AverageMilliseconds) / double(statistics.m_NumberOfRecreations);
+		statistics.m_MaxMilliseconds = std::max(statistics.m_MaxMilliseconds, statistics.m_LastMilliseconds);
+
+		return bRenderPassRebuilt;
+	}
+
+	void VulkanContext::DestroyRetiredSwapChains(bool bAll)
+	{
+		auto iterator = m_RetiredSwapChains.begin();
+
+		while (iterator != m_RetiredSwapChains.end())
+		{
+			if (!bAll && m_FrameSerial < iterator->m_RetiredFrame + iterator->m_ImageCount + 1)
+			{
+				++iterator;
+				continue;
+			}
+
+			for (auto framebuffer : iterator->m_FrameBuffers)
+			{
+				vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+			}
+
+			vkDestroyImageView(m_device, iterator->m_DepthImageView, nullptr);
+			vkDestroyImage(m_device, iterator->m_DepthImage, nullptr);
+			vkFreeMemory(m_device, iterator->m_DepthImageMemory, nullptr);
+
+			if (iterator->m_RenderPass != VK_NULL_HANDLE)
+			{
+				vkDestroyRenderPass(m_device, iterator->m_RenderPass, nullptr);
+			}
+
+			for (auto imageView : iterator->m_ImageViews)
+			{
+				vkDestroyImageView(m_device, imageView, nullptr);
+			}
+
+			vkDestroySwapchainKHR(m_device, iterator->m_SwapChain, nullptr);
+
+			iterator = m_RetiredSwapChains.erase(iterator);
+		}
 	}
 
 	void VulkanContext::CreateDepthResources()
@@ -299,95 +430,7 @@ namespace Karma
 
 	void VulkanContext::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
 	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = m_commandPool;
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer);
-
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.oldLayout = oldLayout;
-		barrier.newLayout = newLayout;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.image = image;
-		if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL && HasStencilComponent(format))
-		{
-			barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
-		}
-		else
-		{
-			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		}
-		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = 1;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = 1;
-		barrier.srcAccessMask = 0; // TODO
-		barrier.dstAccessMask = 0; // TODO
-
-		VkPipelineStageFlags sourceStage;
-		VkPipelineStageFlags destinationStage;
-
-		if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-		{
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		}
-		else
-		{
-			KR_CORE_ASSERT(false, "Unsupported layout transition!");
-		}
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			sourceStage, destinationStage,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
-
-		vkEndCommandBuffer(commandBuffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(m_graphicsQueue);
-
-		vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
+		m_UploadManager->TransitionImageLayout(image, format, oldLayout, newLayout);
 	}
 
 	/*
@@ -412,58 +455,10 @@ namespace Karma
 
 	void VulkanContext::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
 	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = m_commandPool;
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer);
-
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = 1;
-
-		region.imageOffset = { 0, 0, 0 };
-		region.imageExtent = {
-			width,
-			height,
-			1
-		};
-
-		vkCmdCopyBufferToImage(
-			commandBuffer,
-			buffer,
-			image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1,
-			&region
-		);
-
-		vkEndCommandBuffer(commandBuffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(m_graphicsQueue);
-
-		vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
+		m_UploadManager->CopyBufferToImage(buffer, image, width, height);
+
+		// The buffer is caller owned, so we can't let the copy outlive this call
+		m_UploadManager->WaitForUploads();
 	}
 
 	void VulkanContext::CreateCommandPool()
@@ -522,7 +517,7 @@ namespace Karma
 		}
 	}
 
-	void VulkanContext::CreateSwapChain()
+	void VulkanContext::CreateSwapChain(VkSwapchainKHR oldSwapChain)
 	{
 		SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(m_physicalDevice);
 
@@ -532,6 +527,15 @@ namespace Karma
 
 		VkExtent2D extent = ChooseSwapExtent(swapChainSupport.capabilities);
 
+		// Resize benchmark, see SetResizeBenchmarkInterval
+		if (m_bSimulateSmallerExtent)
+		{
+			const VkSurfaceCapabilitiesKHR& capabilities = swapChainSupport.capabilities;
+
+			extent.width = std::max(capabilities.minImageExtent.width, std::min(capabilities.maxImageExtent.width, extent.width * 3 / 4));
+			extent.height = std::max(capabilities.minImageExtent.height, std::min(capabilities.maxImageExtent.height, extent.height * 3 / 4));
+		}
+
 		m_MinImageCount = swapChainSupport.capabilities.minImageCount;
 		uint32_t imageCount = m_MinImageCount + 1;
 
@@ -571,7 +575,7 @@ namespace Karma
 		createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 		createInfo.presentMode = m_presentMode;
 		createInfo.clipped = VK_TRUE;
-		createInfo.oldSwapchain = VK_NULL_HANDLE;
+		createInfo.oldSwapchain = oldSwapChain;
 
 		VkResult result = vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapChain);
 
@@ -627,6 +631,11 @@ namespace Karma
 		std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(),
 		indices.presentFamily.value() };
 
+		if (indices.transferFamily.has_value())
+		{
+			uniqueQueueFamilies.insert(indices.transferFamily.value());
+		}
+
 		if (bEnableValidationLayers)
 		{
 			KR_CORE_INFO("+-------------------------------------------------");
@@ -657,8 +666,41 @@ namespace Karma
 			deviceFeatures.logicOp = VK_TRUE;
 		}
 
+		// For counting the fragment shader invocations of each pass, see VulkanParallelRecorder
+		if (m_SupportedDeviceFeatures.pipelineStatisticsQuery)
+		{
+			deviceFeatures.pipelineStatisticsQuery = VK_TRUE;
+		}
+
+		QueryBindlessSupport();
+
+		VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+		if (m_bSupportsBindless)
+		{
+			descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+			descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+			descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		}
+
+		QueryTimelineSemaphoreSupport();
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+		timelineSemaphoreFeatures.pNext = m_bSupportsBindless ? &descriptorIndexingFeatures : nullptr;
+
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		if (m_bSupportsTimelineSemaphore)
+		{
+			createInfo.pNext = &timelineSemaphoreFeatures;
+		}
+		else
+		{
+			createInfo.pNext = m_bSupportsBindless ? &descriptorIndexingFeatures : nullptr;
+		}
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pEnabledFeatures = &deviceFeatures;
@@ -681,6 +723,117 @@ namespace Karma
 
 		vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
 		vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+
+		// For the GPU profiler. Software implementations (lavapipe) report timestamps too, a family without them reports 0 valid bits.
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+		m_TimestampValidBits = queueFamilies[indices.graphicsFamily.value()].timestampValidBits;
+		m_TimestampPeriod = properties.limits.timestampPeriod;
+
+		if (indices.transferFamily.has_value())
+		{
+			vkGetDeviceQueue(m_device, indices.transferFamily.value(), 0, &m_transferQueue);
+		}
+		else
+		{
+			m_transferQueue = m_graphicsQueue;
+		}
+	}
+
+	void VulkanContext::QueryBindlessSupport()
+	{
+		m_bSupportsBindless = false;
+		m_MaxBindlessTextures = 0;
+
+		if (!s_bBindlessAllowed)
+		{
+			KR_CORE_INFO("Bindless textures turned off, using a descriptor set per material");
+			return;
+		}
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+		// The features (and vkGetPhysicalDeviceFeatures2) are core in 1.2
+		if (properties.apiVersion < VK_API_VERSION_1_2)
+		{
+			KR_CORE_INFO("Device supports Vulkan {0}.{1}, bindless textures need 1.2. Using a descriptor set per material",
+				VK_API_VERSION_MAJOR(properties.apiVersion), VK_API_VERSION_MINOR(properties.apiVersion));
+			return;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &indexingFeatures;
+
+		vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features);
+
+		if (!indexingFeatures.runtimeDescriptorArray || !indexingFeatures.descriptorBindingPartiallyBound ||
+			!indexingFeatures.descriptorBindingSampledImageUpdateAfterBind || !indexingFeatures.shaderSampledImageArrayNonUniformIndexing)
+		{
+			KR_CORE_INFO("Device lacks descriptor indexing features for bindless textures, using a descriptor set per material");
+			return;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+		indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &indexingProperties;
+
+		vkGetPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+		// A combined image sampler counts as a sampler and a sampled image
+		uint32_t maxTextures = VulkanBindlessTable::s_MaxTextures;
+		maxTextures = std::min(maxTextures, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+		maxTextures = std::min(maxTextures, indexingProperties.maxDescriptorSetUpdateAfterBindSamplers);
+		maxTextures = std::min(maxTextures, indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+		maxTextures = std::min(maxTextures, indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers);
+
+		if (maxTextures == 0)
+		{
+			return;
+		}
+
+		m_bSupportsBindless = true;
+		m_MaxBindlessTextures = maxTextures;
+	}
+
+	void VulkanContext::QueryTimelineSemaphoreSupport()
+	{
+		m_bSupportsTimelineSemaphore = false;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+		if (properties.apiVersion < VK_API_VERSION_1_2)
+		{
+			KR_CORE_INFO("Device supports Vulkan {0}.{1}, no timeline semaphores. The host waits for the uploads before drawing",
+				VK_API_VERSION_MAJOR(properties.apiVersion), VK_API_VERSION_MINOR(properties.apiVersion));
+			return;
+		}
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &timelineFeatures;
+
+		vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features);
+
+		m_bSupportsTimelineSemaphore = timelineFeatures.timelineSemaphore == VK_TRUE;
 	}
 
 	void VulkanContext::PickPhysicalDevice()
@@ -834,6 +987,16 @@ namespace Karma
 			i++;
 		}
 
+		// Dedicated transfer (DMA) queue family, if any, for the VulkanUploadManager
+		for (uint32_t j = 0; j < queueFamilyCount; j++)
+		{
+			if ((queueFamilies[j].queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamilies[j].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+			{
+				indices.transferFamily = j;
+				break;
+			}
+		}
+
 		return indices;
 	}
 
@@ -1203,7 +1366,7 @@ namespace Karma
 	{
 		bVSync = bEnable;
 
-		vkDeviceWaitIdle(m_device);
+		// The present mode is all that changes, the swapchain is handed over without waiting
 		RecreateSwapChain();
 	}
 }
@@ -33,7 +33,22 @@ namespace Karma
 	/**
 	 * @brief Forward declaration
 	 */
-	struct VulkanUniformBuffer;
+	class VulkanUploadManager;
+
+	/**
+	 * @brief Forward declaration
+	 */
+	class VulkanUniformBufferRing;
+
+	/**
+	 * @brief Forward declaration
+	 */
+	class VulkanDescriptorCache;
+
+	/**
+	 * @brief Forward declaration
+	 */
+	class VulkanBindlessTable;
 
 	/**
 	 * @brief A structure for graphics and present queuefamilies
@@ -70,6 +85,15 @@ namespace Karma
 		 */
 		std::optional<uint32_t> presentFamily;
 
+		/**
+		 * @brief A queue family supporting transfer operations but not graphics (the so called DMA queue on dedicated graphics cards).
+		 *
+		 * @note Optional in the true sense, if absent the uploads go through the graphics queue
+		 * @see VulkanUploadManager
+		 * @since Karma 1.0.0
+		 */
+		std::optional<uint32_t> transferFamily;
+
 		/**
 		 * @brief Routine for querying if appropriate queue families (graphicsFamily and presentFamily) are available.
 		 *
@@ -117,6 +141,49 @@ namespace Karma
 		std::vector<VkPresentModeKHR> presentModes;
 	};
 
+	/**
+	 * @brief Timings of VulkanContext::RecreateSwapChain, for the resize benchmark (see VulkanContext::SetResizeBenchmarkInterval)
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API SwapChainRecreationStatistics
+	{
+		/**
+		 * @brief Number of recreations
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfRecreations = 0;
+
+		/**
+		 * @brief Number of recreations which had to rebuild the render pass (the surface format changed), and so the pipelines
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfRenderPassRebuilds = 0;
+
+		/**
+		 * @brief CPU time of the latest recreation
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_LastMilliseconds = 0.0;
+
+		/**
+		 * @brief Mean CPU time of a recreation
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_AverageMilliseconds = 0.0;
+
+		/**
+		 * @brief Longest recreation
+		 *
+		 * @since Karma 1.0.0
+		 */
+		double m_MaxMilliseconds = 0.0;
+	};
+
 	/**
 	 * @brief Vulkan API has the following concepts
 	 * 1. Physical Device (https://vulkan-tutorial.com/Drawing_a_triangle/Setup/Physical_devices_and_queue_families): The software counterpart (VkPhysicalDevice) of a graphics card (GPU). Logical device is created from physical device.
@@ -144,7 +211,7 @@ namespace Karma
 		 * 3. Destroy depth imageview (CreateDepthResources())
 		 * 4. Destroy image (CreateDepthResources())
 		 * 5. Free up depthimagememory (CreateDepthResources())
-		 * 6. Destroy command pool (CreateCommandPool())
+		 * 6. Destroy command pool (CreateCommandPool()) and the VulkanUploadManager
 		 * 7. Destroy render pass (CreateRenderPass())
 		 * 8. Destroy swapchain imageview (CreateImageViews())
 		 * 9. Destroy swapchain (CreateSwapChain())
@@ -172,11 +239,13 @@ namespace Karma
 		 * 7. Create ImageViews
 		 * 8. Create RenderPass
 		 * 9. Create CommandPool
-		 * 10. Create DepthResources
-		 * 11. Create FrameBuffers
-		 * 12. VulkanHolder::SetVulkanContext(this) (VulkanHolder::m_VulkanContext)
-		 * 13. m_vulkanRendererAPI->CreateSynchronicity()
-		 * 14. Initialize glslang()
+		 * 10. Create VulkanUploadManager (staging ring and transfer batches)
+		 * 11. Create DepthResources
+		 * 12. Create FrameBuffers
+		 * 13. VulkanHolder::SetVulkanContext(this) (VulkanHolder::m_VulkanContext)
+		 * 13.1 Create the VulkanBindlessTable, if descriptor indexing is supported
+		 * 14. m_vulkanRendererAPI->CreateSynchronicity()
+		 * 15. Initialize glslang()
 		 *
 		 * @see ~VulkanContext()
 		 * @since Karma 1.0.0
@@ -223,13 +292,33 @@ namespace Karma
 		 */
 		void CreateLogicalDevice();
 
+		/**
+		 * @brief Checks the device for the descriptor indexing features VulkanBindlessTable needs (Vulkan 1.2 core): runtime descriptor arrays,
+		 * partially bound and update after bind sampled images and non uniform indexing of them. Sets m_bSupportsBindless and the number of
+		 * texture slots within the device limits.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void QueryBindlessSupport();
+
+		/**
+		 * @brief Checks the device for timeline semaphores (Vulkan 1.2 core), with which the graphics submissions wait (on the GPU)
+		 * for the uploads. Sets m_bSupportsTimelineSemaphore.
+		 *
+		 * @see VulkanUploadManager::GetGraphicsWait
+		 * @since Karma 1.0.0
+		 */
+		void QueryTimelineSemaphoreSupport();
+
 		// Swapchain
 		/**
 		 * @brief Vulkan does not have the concept of a "default framebuffer", hence it requires an infrastructure that will own the buffers we will render to before we visualize them on the screen. This infrastructure is known as the swap chain and must be created explicitly in Vulkan. The swap chain is essentially a queue of images that are waiting to be presented to the screen. Our backend will acquire such an image to draw to it, and then return it to the queue.
 		 *
+		 * @param oldSwapChain					The swapchain being replaced, if any, so that the presentation engine may hand its resources over
+		 *
 		 * @brief Karma 1.0.0
 		 */
-		void CreateSwapChain();
+		void CreateSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
 		SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device);
 		VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -277,21 +366,66 @@ namespace Karma
 
 		// Texture relevant
 		//void CreateTextureImage(VulkanImageBuffer* vImageBuffer);
+		/**
+		 * @brief Records the layout transition into the VulkanUploadManager's current batch. Executed on the next flush.
+		 *
+		 * @since Karma 1.0.0
+		 */
 		void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
+
+		/**
+		 * @brief Copies the buffer to image via VulkanUploadManager and waits (on fence) for the copy, so that the caller
+		 * may free the buffer right after.
+		 *
+		 * @note Prefer VulkanUploadManager::UploadImage which stages the pixels itself and doesn't block
+		 * @since Karma 1.0.0
+		 */
 		void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
 		//void CreateTextureImageView();
 		//void CreateTextureSampler();
 
-		void RecreateSwapChain();
+		/**
+		 * @brief Recreates the swapchain, its image views, depth resources and framebuffers for the present surface extent, without waiting
+		 * for the device to be idle. The new swapchain is created with the old one as oldSwapchain, and the old handles are retired
+		 * (see DestroyRetiredSwapChains). The render pass is kept, and so are the pipelines (their viewport and scissor are dynamic),
+		 * unless the surface format has changed.
+		 *
+		 * @return true if the render pass had to be rebuilt, in which case the pipelines built against it should be too
+		 * @since Karma 1.0.0
+		 */
+		bool RecreateSwapChain();
 		void CleanupSwapChain();
 
+		/**
+		 * @brief Counts the frame (SwapBuffers) and destroys the retired swapchain handles no frame in flight can be using anymore,
+		 * that is retired GetImageCount() + 1 frames ago (the convention of the uniform rings).
+		 *
+		 * @param bAll							Destroy all, irrespective of the age. The device should be idle.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void DestroyRetiredSwapChains(bool bAll);
+
+		/**
+		 * @brief Getter for the recreation timings
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const SwapChainRecreationStatistics& GetSwapChainRecreationStatistics() const { return m_SwapChainRecreationStatistics; }
+
+		/**
+		 * @brief Resize latency benchmark: every numberOfFrames frames (0 turns it off, the default) the swapchain is recreated, alternating
+		 * between the surface extent and a smaller simulated one (clamped to the surface's min/max image extent, so the extent stays put
+		 * on surfaces which dictate it). The timings are logged at shutdown.
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetResizeBenchmarkInterval(uint32_t numberOfFrames) { s_ResizeBenchmarkInterval = numberOfFrames; }
+
 		void SetVSync(bool bEnable);
 
 		void Initializeglslang();
-		void RegisterUBO(const std::shared_ptr<VulkanUniformBuffer>& ubo);
-		void ClearUBO();
-		void RecreateUBO();
-		void UploadUBO(size_t frameIndex);
 
 		// Getters
 		VkDevice GetLogicalDevice() const { return m_device; }
@@ -306,6 +440,77 @@ namespace Karma
 		VkSurfaceFormatKHR GetSurfaceFormat() const { return m_surfaceFormat; }
 		VkQueue GetGraphicsQueue() const { return m_graphicsQueue; }
 		VkQueue GetPresentQueue() const { return m_presentQueue; }
+		VkQueue GetTransferQueue() const { return m_transferQueue; }
+		VulkanUploadManager* GetUploadManager() const { return m_UploadManager; }
+		VulkanUniformBufferRing* GetUniformRing() const { return m_UniformRing; }
+		VulkanUniformBufferRing* GetInstanceRing() const { return m_InstanceRing; }
+		VulkanDescriptorCache* GetDescriptorCache() const { return m_DescriptorCache; }
+
+		/**
+		 * @brief Pipeline cache of the device, so that pipelines rebuilt from shader stages seen before (the swapchain recreated, the
+		 * assets reloaded by AssetManager) skip the driver's compilation
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+
+		/**
+		 * @brief The bindless texture array and material table, nullptr if the device lacks descriptor indexing (or it was turned off)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanBindlessTable* GetBindlessTable() const { return m_BindlessTable; }
+
+		/**
+		 * @brief Whether shaders should be compiled for the bindless path (KARMA_BINDLESS defined)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool SupportsBindless() const { return m_BindlessTable != nullptr; }
+
+		/**
+		 * @brief Number of SwapBuffers so far, for telling when the frames in flight are done with what was retired
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetFrameSerial() const { return m_FrameSerial; }
+
+		/**
+		 * @brief Allows (default) or forbids the bindless path, for comparison with the per material descriptor sets. To be set before Init.
+		 *
+		 * @see CommandLine
+		 * @since Karma 1.0.0
+		 */
+		static void SetBindlessAllowed(bool bAllowed) { s_bBindlessAllowed = bAllowed; }
+
+		/**
+		 * @brief Whether the logical device was created with timeline semaphores enabled
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool SupportsTimelineSemaphore() const { return m_bSupportsTimelineSemaphore; }
+
+		/**
+		 * @brief Whether the graphics queue can write timestamps (its family has non zero timestampValidBits)
+		 *
+		 * @see VulkanGPUProfiler
+		 * @since Karma 1.0.0
+		 */
+		bool SupportsTimestamps() const { return m_TimestampValidBits > 0; }
+
+		/**
+		 * @brief Nanoseconds per timestamp tick (VkPhysicalDeviceLimits::timestampPeriod)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		float GetTimestampPeriod() const { return m_TimestampPeriod; }
+
+		/**
+		 * @brief Mask of the meaningful bits of a timestamp written on the graphics queue, for differences which wrap around
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t GetTimestampMask() const { return m_TimestampValidBits >= 64 ? UINT64_MAX : ((uint64_t(1) << m_TimestampValidBits) - 1); }
 		VkCommandPool GetCommandPool() const { return m_commandPool; }
 		//VkImageView GetTextureImageView() const { return m_TextureImageView; }
 		//VkSampler GetTextureSampler() const { return m_TextureSampler; }
@@ -329,14 +534,38 @@ namespace Karma
 
 		static bool bEnableValidationLayers;
 
+		static bool s_bBindlessAllowed;
+		bool m_bSupportsBindless = false;
+		uint32_t m_MaxBindlessTextures = 0;
+
+		bool m_bSupportsTimelineSemaphore = false;
+
+		// Of the graphics queue family, 0 bits meaning no timestamps
+		uint32_t m_TimestampValidBits = 0;
+		float m_TimestampPeriod = 1.0f;
+
 		VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
 		VkDevice m_device;
 		VkQueue m_graphicsQueue;
 
 		VkSurfaceKHR m_surface;
 		VkQueue m_presentQueue;
+		VkQueue m_transferQueue;
 		VkPresentModeKHR m_presentMode;
 
+		VulkanUploadManager* m_UploadManager = nullptr;
+		VulkanUniformBufferRing* m_UniformRing = nullptr;
+		VulkanUniformBufferRing* m_InstanceRing = nullptr;
+		VulkanDescriptorCache* m_DescriptorCache = nullptr;
+		VulkanBindlessTable* m_BindlessTable = nullptr;
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+
+		// Room for a few thousand per draw blocks every frame
+		static constexpr uint32_t s_UniformRingBytesPerFrame = 256 * 1024;
+
+		// Per instance world matrices, 16k instances every frame
+		static constexpr uint32_t s_InstanceRingBytesPerFrame = 1024 * 1024;
+
 		VkSurfaceFormatKHR m_surfaceFormat;
 
 		VkSwapchainKHR m_swapChain;
@@ -350,8 +579,6 @@ namespace Karma
 		std::vector<VkFramebuffer> m_swapChainFrameBuffers;
 		VkCommandPool m_commandPool;
 
-		std::set<std::shared_ptr<VulkanUniformBuffer>> m_VulkanUBO;
-
 		bool bVSync = false;
 
 		VkImage m_DepthImage;
@@ -360,6 +587,30 @@ namespace Karma
 
 		uint32_t m_MinImageCount = 0;
 
+		// Handles replaced by RecreateSwapChain, destroyed once the frames in flight are done with them
+		struct RetiredSwapChain
+		{
+			VkSwapchainKHR m_SwapChain = VK_NULL_HANDLE;
+			std::vector<VkImageView> m_ImageViews;
+			std::vector<VkFramebuffer> m_FrameBuffers;
+			VkImage m_DepthImage = VK_NULL_HANDLE;
+			VkDeviceMemory m_DepthImageMemory = VK_NULL_HANDLE;
+			VkImageView m_DepthImageView = VK_NULL_HANDLE;
+			VkRenderPass m_RenderPass = VK_NULL_HANDLE;
+			uint64_t m_RetiredFrame = 0;
+			uint32_t m_ImageCount = 0;
+		};
+
+		std::vector<RetiredSwapChain> m_RetiredSwapChains;
+
+		// Number of SwapBuffers so far
+		uint64_t m_FrameSerial = 0;
+
+		SwapChainRecreationStatistics m_SwapChainRecreationStatistics;
+
+		static uint32_t s_ResizeBenchmarkInterval;
+		bool m_bSimulateSmallerExtent = false;
+
 		//VkImage m_TextureImage;
 		/*
 		VkDeviceMemory m_TextureImageMemory;
@@ -0,0 +1,432 @@
+#include "VulkanDescriptorCache.h"
+#include "Karma/Core.h"
+#include "Karma/Renderer/RenderThread.h"
+
+namespace Karma
+{
+	namespace
+	{
+		// FNV-1a, good enough for a handful of plain old data fields
+		inline void HashCombine(uint64_t& hash, const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ULL;
+			}
+		}
+
+		template<typename T>
+		inline void HashCombine(uint64_t& hash, const T& value)
+		{
+			HashCombine(hash, &value, sizeof(T));
+		}
+	}
+
+	bool DescriptorBindingInfo::IsImage() const
+	{
+		return m_Type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || m_Type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+			m_Type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE || m_Type == VK_DESCRIPTOR_TYPE_SAMPLER;
+	}
+
+	bool DescriptorBindingInfo::operator==(const DescriptorBindingInfo& other) const
+	{
+		if (m_Binding != other.m_Binding || m_Type != other.m_Type)
+		{
+			return false;
+		}
+
+		if (IsImage())
+		{
+			return m_ImageInfo.imageView == other.m_ImageInfo.imageView && m_ImageInfo.sampler == other.m_ImageInfo.sampler &&
+				m_ImageInfo.imageLayout == other.m_ImageInfo.imageLayout;
+		}
+
+		return m_BufferInfo.buffer == other.m_BufferInfo.buffer && m_BufferInfo.offset == other.m_BufferInfo.offset &&
+			m_BufferInfo.range == other.m_BufferInfo.range;
+	}
+
+	VulkanDescriptorCache::VulkanDescriptorCache(VkDevice device, uint32_t numberOfFrames) : m_Device(device)
+	{
+		m_FramePools.resize(numberOfFrames);
+	}
+
+	VulkanDescriptorCache::~VulkanDescriptorCache()
+	{
+		for (auto pool : m_PersistentPools.m_Pools)
+		{
+			vkDestroyDescriptorPool(m_Device, pool, nullptr);
+		}
+
+		for (auto& poolList : m_FramePools)
+		{
+			for (auto pool : poolList.m_Pools)
+			{
+				vkDestroyDescriptorPool(m_Device, pool, nullptr);
+			}
+		}
+
+		for (auto& pipelineLayout : m_PipelineLayouts)
+		{
+			vkDestroyPipelineLayout(m_Device, pipelineLayout.second, nullptr);
+		}
+
+		for (auto& pipelineLayout : m_MultiSetPipelineLayouts)
+		{
+			vkDestroyPipelineLayout(m_Device, pipelineLayout.second.m_Layout, nullptr);
+		}
+
+		for (auto& layout : m_Layouts)
+		{
+			vkDestroyDescriptorSetLayout(m_Device, layout.second.m_Layout, nullptr);
+		}
+	}
+
+	uint64_t VulkanDescriptorCache::HashLayoutBindings(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+
+		for (const auto& binding : bindings)
+		{
+			HashCombine(hash, binding.binding);
+			HashCombine(hash, binding.descriptorType);
+			HashCombine(hash, binding.descriptorCount);
+			HashCombine(hash, binding.stageFlags);
+		}
+
+		return hash;
+	}
+
+	uint64_t VulkanDescriptorCache::HashSet(VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingInfo>& bindings)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+		HashCombine(hash, setLayout);
+
+		for (const auto& binding : bindings)
+		{
+			HashCombine(hash, binding.m_Binding);
+			HashCombine(hash, binding.m_Type);
+
+			if (binding.IsImage())
+			{
+				HashCombine(hash, binding.m_ImageInfo.imageView);
+				HashCombine(hash, binding.m_ImageInfo.sampler);
+				HashCombine(hash, binding.m_ImageInfo.imageLayout);
+			}
+			else
+			{
+				HashCombine(hash, binding.m_BufferInfo.buffer);
+				HashCombine(hash, binding.m_BufferInfo.offset);
+				HashCombine(hash, binding.m_BufferInfo.range);
+			}
+		}
+
+		return hash;
+	}
+
+	VkDescriptorSetLayout VulkanDescriptorCache::GetOrCreateLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		uint64_t hash = HashLayoutBindings(bindings);
+
+		auto range = m_Layouts.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			const auto& cached = it->second.m_Bindings;
+
+			bool bSame = cached.size() == bindings.size();
+			for (size_t i = 0; bSame && i < bindings.size(); i++)
+			{
+				bSame = cached[i].binding == bindings[i].binding && cached[i].descriptorType == bindings[i].descriptorType &&
+					cached[i].descriptorCount == bindings[i].descriptorCount && cached[i].stageFlags == bindings[i].stageFlags;
+			}
+
+			if (bSame)
+			{
+				m_Statistics.m_LayoutHits++;
+				return it->second.m_Layout;
+			}
+		}
+
+		for (const auto& binding : bindings)
+		{
+			KR_CORE_ASSERT(binding.pImmutableSamplers == nullptr, "Immutable samplers are not supported by the descriptor cache");
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		CachedLayout cachedLayout;
+		cachedLayout.m_Bindings = bindings;
+
+		VkResult result = vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &cachedLayout.m_Layout);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor set layout!");
+
+		m_Layouts.emplace(hash, cachedLayout);
+		m_Statistics.m_LayoutMisses++;
+
+		return cachedLayout.m_Layout;
+	}
+
+	VkPipelineLayout VulkanDescriptorCache::GetOrCreatePipelineLayout(VkDescriptorSetLayout setLayout)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		auto found = m_PipelineLayouts.find(setLayout);
+		if (found != m_PipelineLayouts.end())
+		{
+			return found->second;
+		}
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &setLayout;
+
+		VkPipelineLayout pipelineLayout;
+		VkResult result = vkCreatePipelineLayout(m_Device, &pipelineLayoutInfo, nullptr, &pipelineLayout);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline layout!");
+
+		m_PipelineLayouts[setLayout] = pipelineLayout;
+
+		return pipelineLayout;
+	}
+
+	VkPipelineLayout VulkanDescriptorCache::GetOrCreatePipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+		const std::vector<VkPushConstantRange>& pushConstantRanges)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		uint64_t hash = 14695981039346656037ULL;
+
+		for (const auto& setLayout : setLayouts)
+		{
+			HashCombine(hash, setLayout);
+		}
+
+		for (const auto& range : pushConstantRanges)
+		{
+			HashCombine(hash, range.stageFlags);
+			HashCombine(hash, range.offset);
+			HashCombine(hash, range.size);
+		}
+
+		auto found = m_MultiSetPipelineLayouts.equal_range(hash);
+		for (auto it = found.first; it != found.second; ++it)
+		{
+			const CachedPipelineLayout& cached = it->second;
+
+			bool bSame = cached.m_SetLayouts == setLayouts && cached.m_PushConstantRanges.size() == pushConstantRanges.size();
+			for (size_t i = 0; bSame && i < pushConstantRanges.size(); i++)
+			{
+				bSame = cached.m_PushConstantRanges[i].stageFlags == pushConstantRanges[i].stageFlags &&
+					cached.m_PushConstantRanges[i].offset == pushConstantRanges[i].offset && cached.m_PushConstantRanges[i].size == pushConstantRanges[i].size;
+			}
+
+			if (bSame)
+			{
+				return cached.m_Layout;
+			}
+		}
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+		pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+		CachedPipelineLayout cachedLayout;
+		cachedLayout.m_SetLayouts = setLayouts;
+		cachedLayout.m_PushConstantRanges = pushConstantRanges;
+
+		VkResult result = vkCreatePipelineLayout(m_Device, &pipelineLayoutInfo, nullptr, &cachedLayout.m_Layout);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline layout!");
+
+		m_MultiSetPipelineLayouts.emplace(hash, cachedLayout);
+
+		return cachedLayout.m_Layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorCache::GetOrCreateSet(VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingInfo>& bindings)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		uint64_t hash = HashSet(setLayout, bindings);
+
+		auto range = m_Sets.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second.m_Layout == setLayout && it->second.m_Bindings == bindings)
+			{
+				m_Statistics.m_SetHits++;
+				return it->second.m_Set;
+			}
+		}
+
+		CachedSet cachedSet;
+		cachedSet.m_Layout = setLayout;
+		cachedSet.m_Bindings = bindings;
+		cachedSet.m_Set = AllocateFromList(m_PersistentPools, setLayout, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, &cachedSet.m_Pool);
+
+		WriteSet(cachedSet.m_Set, bindings);
+
+		m_Sets.emplace(hash, cachedSet);
+		m_Statistics.m_SetMisses++;
+
+		return cachedSet.m_Set;
+	}
+
+	void VulkanDescriptorCache::ReleaseImageView(VkImageView imageView)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		for (auto it = m_Sets.begin(); it != m_Sets.end();)
+		{
+			bool bRefers = false;
+			for (const auto& binding : it->second.m_Bindings)
+			{
+				if (binding.IsImage() && binding.m_ImageInfo.imageView == imageView)
+				{
+					bRefers = true;
+					break;
+				}
+			}
+
+			if (bRefers)
+			{
+				vkFreeDescriptorSets(m_Device, it->second.m_Pool, 1, &it->second.m_Set);
+				it = m_Sets.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		// Freed sets leave holes in the pools, so start looking from the first one again
+		m_PersistentPools.m_Active = 0;
+	}
+
+	VkDescriptorSet VulkanDescriptorCache::AllocateFrameSet(VkDescriptorSetLayout setLayout, uint32_t frameIndex)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		KR_CORE_ASSERT(frameIndex < m_FramePools.size(), "Frame index out of range");
+
+		m_Statistics.m_FrameSetAllocations++;
+		return AllocateFromList(m_FramePools[frameIndex], setLayout, 0, nullptr);
+	}
+
+	void VulkanDescriptorCache::ResetFrame(uint32_t frameIndex)
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The descriptor cache is changed while the render thread plays a frame");
+
+		KR_CORE_ASSERT(frameIndex < m_FramePools.size(), "Frame index out of range");
+
+		PoolList& poolList = m_FramePools[frameIndex];
+
+		// Only the pools used this frame need resetting
+		for (uint32_t i = 0; i < poolList.m_Pools.size() && i <= poolList.m_Active; i++)
+		{
+			vkResetDescriptorPool(m_Device, poolList.m_Pools[i], 0);
+		}
+
+		poolList.m_Active = 0;
+	}
+
+	void VulkanDescriptorCache::WriteSet(VkDescriptorSet set, const std::vector<DescriptorBindingInfo>& bindings) const
+	{
+		std::vector<VkWriteDescriptorSet> descriptorWrites(bindings.size());
+
+		for (size_t i = 0; i < bindings.size(); i++)
+		{
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = set;
+			descriptorWrites[i].dstBinding = bindings[i].m_Binding;
+			descriptorWrites[i].dstArrayElement = 0;
+			descriptorWrites[i].descriptorType = bindings[i].m_Type;
+			descriptorWrites[i].descriptorCount = 1;
+
+			if (bindings[i].IsImage())
+			{
+				descriptorWrites[i].pImageInfo = &bindings[i].m_ImageInfo;
+			}
+			else
+			{
+				descriptorWrites[i].pBufferInfo = &bindings[i].m_BufferInfo;
+			}
+		}
+
+		vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+
+	VkDescriptorPool VulkanDescriptorCache::CreatePool(VkDescriptorPoolCreateFlags flags)
+	{
+		// Generous ratios per set, covering what the engine's shaders use
+		std::array<VkDescriptorPoolSize, 6> poolSizes{};
+		poolSizes[0] = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * s_SetsPerPool };
+		poolSizes[1] = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 2 * s_SetsPerPool };
+		poolSizes[2] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, s_SetsPerPool };
+		poolSizes[3] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, s_SetsPerPool };
+		poolSizes[4] = { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * s_SetsPerPool };
+		poolSizes[5] = { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, s_SetsPerPool };
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = flags;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = s_SetsPerPool;
+
+		VkDescriptorPool pool;
+		VkResult result = vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &pool);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor pool!");
+
+		m_Statistics.m_NumberOfPools++;
+
+		return pool;
+	}
+
+	VkDescriptorSet VulkanDescriptorCache::AllocateFromList(PoolList& poolList, VkDescriptorSetLayout setLayout, VkDescriptorPoolCreateFlags flags, VkDescriptorPool* sourcePool)
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &setLayout;
+
+		// Walk the pools starting from the active one, appending a fresh pool when all are exhausted
+		while (true)
+		{
+			if (poolList.m_Active == poolList.m_Pools.size())
+			{
+				poolList.m_Pools.push_back(CreatePool(flags));
+			}
+
+			allocInfo.descriptorPool = poolList.m_Pools[poolList.m_Active];
+
+			VkDescriptorSet set;
+			VkResult result = vkAllocateDescriptorSets(m_Device, &allocInfo, &set);
+
+			if (result == VK_SUCCESS)
+			{
+				if (sourcePool)
+				{
+					*sourcePool = allocInfo.descriptorPool;
+				}
+				return set;
+			}
+
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+			{
+				KR_CORE_ASSERT(false, "Failed to allocate descriptor set!");
+				return VK_NULL_HANDLE;
+			}
+
+			poolList.m_Active++;
+		}
+	}
+}
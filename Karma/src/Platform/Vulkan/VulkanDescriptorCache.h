@@ -0,0 +1,286 @@
+/**
+ * @file VulkanDescriptorCache.h
+ * @brief This file contains VulkanDescriptorCache class, the owner of descriptor set layouts, pipeline layouts, descriptor pools and sets.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "vulkan/vulkan.h"
+
+namespace Karma
+{
+	/**
+	 * @brief What a binding of a descriptor set points to. Either m_BufferInfo or m_ImageInfo is relevant, depending upon the m_Type.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API DescriptorBindingInfo
+	{
+		/**
+		 * @brief The binding number (as specified in the shader)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_Binding = 0;
+
+		/**
+		 * @brief Type of the descriptor, for instance VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorType m_Type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+		/**
+		 * @brief Buffer, offset and range for buffer descriptors
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorBufferInfo m_BufferInfo{};
+
+		/**
+		 * @brief Image view, sampler and layout for image descriptors
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorImageInfo m_ImageInfo{};
+
+		/**
+		 * @brief Comparison of the relevant fields
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool operator==(const DescriptorBindingInfo& other) const;
+
+		/**
+		 * @brief Whether the descriptor is an image (or sampler) one
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsImage() const;
+	};
+
+	/**
+	 * @brief Counters gathered by VulkanDescriptorCache
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API DescriptorCacheStatistics
+	{
+		/**
+		 * @brief Number of GetOrCreateLayout calls served from the cache
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LayoutHits = 0;
+
+		/**
+		 * @brief Number of descriptor set layouts created
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_LayoutMisses = 0;
+
+		/**
+		 * @brief Number of GetOrCreateSet calls served from the cache
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_SetHits = 0;
+
+		/**
+		 * @brief Number of long lived descriptor sets allocated
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_SetMisses = 0;
+
+		/**
+		 * @brief Number of per frame descriptor sets allocated since the stats were reset
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_FrameSetAllocations = 0;
+
+		/**
+		 * @brief Number of descriptor pools created (long lived and per frame)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfPools = 0;
+	};
+
+	/**
+	 * @brief Central place for descriptor management, instead of a pool and a set of descriptor sets per VulkanVertexArray.
+	 *
+	 * - Descriptor set layouts (and the pipeline layouts made from them) are deduplicated by hash of the bindings, so that identically
+	 *   defined vertex arrays share the handles.
+	 * - Long lived sets (material textures and samplers, and the uniform ring) are cached by the contents of their bindings and allocated from
+	 *   a growable list of pools.
+	 * - Short lived sets are allocated from a growable list of pools per frame in flight, which are reset as a whole by ResetFrame.
+	 *
+	 * Since the handles are shared, comparing them is enough to figure if a vkCmdBindDescriptorSets would be redundant.
+	 *
+	 * @note Not locked, the cache is used by the render thread (or with it idle, see RenderThread::IsRenderingContext)
+	 * @see VulkanVertexArray::CreateDescriptorSets, VulkanRendererAPI::RecordCommandBuffers
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanDescriptorCache
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param device						The logical device
+		 * @param numberOfFrames				Number of frames in flight, each gets its own list of pools for short lived sets
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanDescriptorCache(VkDevice device, uint32_t numberOfFrames);
+
+		/**
+		 * @brief Destroys all the pools (freeing the sets), the pipeline layouts and the descriptor set layouts
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~VulkanDescriptorCache();
+
+		/**
+		 * @brief Returns the cached descriptor set layout for the bindings, creating it if needed
+		 *
+		 * @param bindings						The layout bindings (immutable samplers are not supported)
+		 *
+		 * @note The layout is owned by the cache, do not destroy
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorSetLayout GetOrCreateLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+		/**
+		 * @brief Returns the cached pipeline layout with single descriptor set layout (and no push constants), creating it if needed
+		 *
+		 * @note The layout is owned by the cache, do not destroy
+		 * @since Karma 1.0.0
+		 */
+		VkPipelineLayout GetOrCreatePipelineLayout(VkDescriptorSetLayout setLayout);
+
+		/**
+		 * @brief Returns the cached pipeline layout with several descriptor set layouts and push constant ranges, creating it if needed
+		 *
+		 * @param setLayouts					Descriptor set layouts, in set order (from GetOrCreateLayout or VulkanBindlessTable)
+		 * @param pushConstantRanges			The push constant ranges
+		 *
+		 * @note The layout is owned by the cache, do not destroy
+		 * @see VulkanVertexArray::CreatePipelineLayout
+		 * @since Karma 1.0.0
+		 */
+		VkPipelineLayout GetOrCreatePipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges);
+
+		/**
+		 * @brief Returns the long lived descriptor set with layout and bindings, allocating and writing it if not cached
+		 *
+		 * @param setLayout						A layout obtained from GetOrCreateLayout
+		 * @param bindings						What each binding points to
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorSet GetOrCreateSet(VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingInfo>& bindings);
+
+		/**
+		 * @brief Frees the cached sets referring to the image view. Called by the owner of the view before destroying it.
+		 *
+		 * @see VulkanTexture::~VulkanTexture
+		 * @since Karma 1.0.0
+		 */
+		void ReleaseImageView(VkImageView imageView);
+
+		/**
+		 * @brief Allocates a short lived set from the pools of frameIndex. The set is valid till ResetFrame(frameIndex).
+		 *
+		 * @param setLayout						A layout obtained from GetOrCreateLayout
+		 * @param frameIndex					The frame in flight (VulkanRendererAPI's m_CurrentFrame)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorSet AllocateFrameSet(VkDescriptorSetLayout setLayout, uint32_t frameIndex);
+
+		/**
+		 * @brief Resets all the pools of frameIndex in one go (vkResetDescriptorPool). To be called after the fence of the frame is waited upon.
+		 *
+		 * @see VulkanRendererAPI::SubmitCommandBuffers
+		 * @since Karma 1.0.0
+		 */
+		void ResetFrame(uint32_t frameIndex);
+
+		/**
+		 * @brief Writes the bindings into the set (vkUpdateDescriptorSets)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void WriteSet(VkDescriptorSet set, const std::vector<DescriptorBindingInfo>& bindings) const;
+
+		/**
+		 * @brief Getter for the counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const DescriptorCacheStatistics& GetStatistics() const { return m_Statistics; }
+
+	private:
+		/**
+		 * @brief A list of pools, sets are allocated from the m_Active pool and a new one is appended when it runs dry
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct PoolList
+		{
+			std::vector<VkDescriptorPool> m_Pools;
+			uint32_t m_Active = 0;
+		};
+
+		struct CachedLayout
+		{
+			std::vector<VkDescriptorSetLayoutBinding> m_Bindings;
+			VkDescriptorSetLayout m_Layout;
+		};
+
+		struct CachedPipelineLayout
+		{
+			std::vector<VkDescriptorSetLayout> m_SetLayouts;
+			std::vector<VkPushConstantRange> m_PushConstantRanges;
+			VkPipelineLayout m_Layout;
+		};
+
+		struct CachedSet
+		{
+			VkDescriptorSetLayout m_Layout;
+			std::vector<DescriptorBindingInfo> m_Bindings;
+			VkDescriptorSet m_Set;
+			VkDescriptorPool m_Pool;
+		};
+
+		VkDescriptorPool CreatePool(VkDescriptorPoolCreateFlags flags);
+		VkDescriptorSet AllocateFromList(PoolList& poolList, VkDescriptorSetLayout setLayout, VkDescriptorPoolCreateFlags flags, VkDescriptorPool* sourcePool);
+
+		static uint64_t HashLayoutBindings(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+		static uint64_t HashSet(VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingInfo>& bindings);
+
+	private:
+		VkDevice m_Device;
+
+		std::unordered_multimap<uint64_t, CachedLayout> m_Layouts;
+		std::unordered_map<VkDescriptorSetLayout, VkPipelineLayout> m_PipelineLayouts;
+		std::unordered_multimap<uint64_t, CachedPipelineLayout> m_MultiSetPipelineLayouts;
+		std::unordered_multimap<uint64_t, CachedSet> m_Sets;
+
+		PoolList m_PersistentPools;
+		std::vector<PoolList> m_FramePools;
+
+		DescriptorCacheStatistics m_Statistics;
+
+		// Sets per pool, the descriptor counts are scaled accordingly
+		static constexpr uint32_t s_SetsPerPool = 128;
+	};
+}
@@ -0,0 +1,233 @@
+#include "VulkanGPUProfiler.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+
+namespace Karma
+{
+	VulkanGPUProfiler::VulkanGPUProfiler(uint32_t numberOfFrames) : m_CurrentFrame(0), m_bStatisticsScopeOpen(false)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		m_Device = context->GetLogicalDevice();
+
+		m_bTimestampsSupported = context->SupportsTimestamps();
+
+		// Enabled on the device when supported, see VulkanContext::CreateLogicalDevice
+		m_bStatisticsSupported = m_bTimestampsSupported && context->GetSupportedDeviceFeatures().pipelineStatisticsQuery == VK_TRUE;
+
+		m_Frames.resize(numberOfFrames);
+
+		if (!m_bTimestampsSupported)
+		{
+			KR_CORE_WARN("The graphics queue has no timestamps, GPU scopes won't be timed");
+			return;
+		}
+
+		for (Frame& frame : m_Frames)
+		{
+			VkQueryPoolCreateInfo queryPoolInfo{};
+			queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			queryPoolInfo.queryCount = 2 * GPUProfiler::s_MaxScopesPerFrame;
+
+			VkResult result = vkCreateQueryPool(m_Device, &queryPoolInfo, nullptr, &frame.m_TimestampPool);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create timestamp query pool!");
+
+			if (m_bStatisticsSupported)
+			{
+				queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+				queryPoolInfo.queryCount = GPUProfiler::s_MaxScopesPerFrame;
+				queryPoolInfo.pipelineStatistics = s_PipelineStatisticsFlags;
+
+				result = vkCreateQueryPool(m_Device, &queryPoolInfo, nullptr, &frame.m_StatisticsPool);
+				KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline statistics query pool!");
+			}
+		}
+	}
+
+	VulkanGPUProfiler::~VulkanGPUProfiler()
+	{
+		for (Frame& frame : m_Frames)
+		{
+			if (frame.m_TimestampPool != VK_NULL_HANDLE)
+			{
+				vkDestroyQueryPool(m_Device, frame.m_TimestampPool, nullptr);
+			}
+
+			if (frame.m_StatisticsPool != VK_NULL_HANDLE)
+			{
+				vkDestroyQueryPool(m_Device, frame.m_StatisticsPool, nullptr);
+			}
+		}
+	}
+
+	void VulkanGPUProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		KR_CORE_ASSERT(frameIndex < m_Frames.size(), "Frame index out of the frames in flight");
+
+		m_CurrentFrame = frameIndex;
+		m_OpenScopes.clear();
+		m_bStatisticsScopeOpen = false;
+
+		Frame& frame = m_Frames[frameIndex];
+
+		ResolveFrame(frame);
+
+		frame.m_Scopes.clear();
+		frame.m_NumberOfTimestamps = 0;
+		frame.m_NumberOfStatistics = 0;
+		frame.m_bActive = m_bTimestampsSupported && GPUProfiler::IsEnabled();
+		frame.m_bStatisticsActive = frame.m_bActive && m_bStatisticsSupported && GPUProfiler::IsPipelineStatisticsEnabled();
+
+		if (!frame.m_bActive)
+		{
+			return;
+		}
+
+		// Queries have to be reset before they are written, and resets aren't allowed within a render pass
+		vkCmdResetQueryPool(commandBuffer, frame.m_TimestampPool, 0, 2 * GPUProfiler::s_MaxScopesPerFrame);
+
+		if (frame.m_bStatisticsActive)
+		{
+			vkCmdResetQueryPool(commandBuffer, frame.m_StatisticsPool, 0, GPUProfiler::s_MaxScopesPerFrame);
+		}
+	}
+
+	void VulkanGPUProfiler::BeginScope(VkCommandBuffer commandBuffer, const char* scopeName, bool bPipelineStatistics)
+	{
+		Frame& frame = m_Frames[m_CurrentFrame];
+
+		if (!frame.m_bActive || frame.m_Scopes.size() >= GPUProfiler::s_MaxScopesPerFrame)
+		{
+			m_OpenScopes.push_back(UINT32_MAX);
+			return;
+		}
+
+		Scope scope;
+		scope.m_Name = scopeName;
+		scope.m_BeginQuery = frame.m_NumberOfTimestamps;
+
+		frame.m_NumberOfTimestamps += 2;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.m_TimestampPool, scope.m_BeginQuery);
+
+		if (bPipelineStatistics && frame.m_bStatisticsActive && !m_bStatisticsScopeOpen)
+		{
+			scope.m_StatisticsQuery = frame.m_NumberOfStatistics++;
+			m_bStatisticsScopeOpen = true;
+
+			vkCmdBeginQuery(commandBuffer, frame.m_StatisticsPool, scope.m_StatisticsQuery, 0);
+		}
+
+		m_OpenScopes.push_back(uint32_t(frame.m_Scopes.size()));
+		frame.m_Scopes.push_back(scope);
+	}
+
+	void VulkanGPUProfiler::EndScope(VkCommandBuffer commandBuffer)
+	{
+		KR_CORE_ASSERT(!m_OpenScopes.empty(), "EndScope without a BeginScope");
+
+		uint32_t scopeIndex = m_OpenScopes.back();
+		m_OpenScopes.pop_back();
+
+		if (scopeIndex == UINT32_MAX)
+		{
+			return;
+		}
+
+		Frame& frame = m_Frames[m_CurrentFrame];
+		Scope& scope = frame.m_Scopes[scopeIndex];
+
+		if (scope.m_StatisticsQuery != UINT32_MAX)
+		{
+			vkCmdEndQuery(commandBuffer, frame.m_StatisticsPool, scope.m_StatisticsQuery);
+			m_bStatisticsScopeOpen = false;
+		}
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.m_TimestampPool, scope.m_BeginQuery + 1);
+
+		scope.m_bEnded = true;
+	}
+
+	void VulkanGPUProfiler::ResolveFrame(Frame& frame)
+	{
+		if (!frame.m_bActive || frame.m_NumberOfTimestamps == 0)
+		{
+			return;
+		}
+
+		// Each result is followed by its availability. The fence has been waited upon so all should be there, but nothing is waited for.
+		std::vector<uint64_t> timestamps(2 * frame.m_NumberOfTimestamps);
+
+		VkResult result = vkGetQueryPoolResults(m_Device, frame.m_TimestampPool, 0, frame.m_NumberOfTimestamps, timestamps.size() * sizeof(uint64_t),
+			timestamps.data(), 2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+		if (result != VK_SUCCESS && result != VK_NOT_READY)
+		{
+			return;
+		}
+
+		std::vector<uint64_t> statistics;
+		if (frame.m_NumberOfStatistics > 0)
+		{
+			const uint32_t stride = s_NumberOfPipelineStatistics + 1;
+			statistics.resize(stride * frame.m_NumberOfStatistics);
+
+			result = vkGetQueryPoolResults(m_Device, frame.m_StatisticsPool, 0, frame.m_NumberOfStatistics, statistics.size() * sizeof(uint64_t),
+				statistics.data(), stride * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+			if (result != VK_SUCCESS && result != VK_NOT_READY)
+			{
+				statistics.clear();
+			}
+		}
+
+		for (const Scope& scope : frame.m_Scopes)
+		{
+			// A scope left open has no end timestamp
+			if (!scope.m_bEnded)
+			{
+				continue;
+			}
+
+			const uint64_t* begin = &timestamps[2 * scope.m_BeginQuery];
+			const uint64_t* end = &timestamps[2 * (scope.m_BeginQuery + 1)];
+
+			if (begin[1] != 0 && end[1] != 0)
+			{
+				GPUProfiler::ReportTime(scope.m_Name, TimestampsToMilliseconds(begin[0], end[0]));
+			}
+
+			if (scope.m_StatisticsQuery != UINT32_MAX && !statistics.empty())
+			{
+				const uint64_t* counters = &statistics[(s_NumberOfPipelineStatistics + 1) * scope.m_StatisticsQuery];
+
+				if (counters[s_NumberOfPipelineStatistics] != 0)
+				{
+					GPUProfiler::ReportPipelineStatistics(scope.m_Name, ReadPipelineStatistics(counters));
+				}
+			}
+		}
+	}
+
+	double VulkanGPUProfiler::TimestampsToMilliseconds(uint64_t beginTimestamp, uint64_t endTimestamp)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		// Only the valid bits count, the difference is taken modulo them in case the counter wrapped around
+		uint64_t ticks = (endTimestamp - beginTimestamp) & context->GetTimestampMask();
+
+		return double(ticks) * double(context->GetTimestampPeriod()) / 1000000.0;
+	}
+
+	GPUPipelineStatistics VulkanGPUProfiler::ReadPipelineStatistics(const uint64_t* result)
+	{
+		GPUPipelineStatistics statistics;
+
+		statistics.m_VertexInvocations = result[0];
+		statistics.m_ClippingInvocations = result[1];
+		statistics.m_ClippingPrimitives = result[2];
+		statistics.m_FragmentInvocations = result[3];
+
+		return statistics;
+	}
+}
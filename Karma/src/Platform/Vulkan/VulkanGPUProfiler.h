@@ -0,0 +1,158 @@
+/**
+ * @file VulkanGPUProfiler.h
+ * @brief This file contains VulkanGPUProfiler class, timestamp and pipeline statistics queries around named scopes of a primary command buffer.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/GPUProfiler.h"
+#include "vulkan/vulkan.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Measures named scopes of the command buffers of one submission stream (the scene of VulkanRendererAPI, the overlay of KarmaGuiRenderer),
+	 * each stream having its own frames in flight and fences.
+	 *
+	 * There is a timestamp query pool (and, if the device has pipelineStatisticsQuery, a pipeline statistics pool) per frame in flight. BeginFrame,
+	 * called once the frame's fence has been waited upon, reads the results the frame's previous recording left (without VK_QUERY_RESULT_WAIT_BIT,
+	 * results which aren't there are skipped rather than waited for), hands them to GPUProfiler and resets the pools for the new recording.
+	 *
+	 * Scopes nest for timing. Only one pipeline statistics query may be active in a command buffer, so statistics are gathered for the outermost
+	 * scope asking for them, and a scope which executes secondary command buffers shouldn't ask (the secondaries would need inheritedQueries).
+	 *
+	 * Nothing is recorded unless GPUProfiler::IsEnabled, or if the graphics queue has no timestamps (VulkanContext::SupportsTimestamps). Software
+	 * implementations such as lavapipe have both timestamps and pipeline statistics.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanGPUProfiler
+	{
+	public:
+		/**
+		 * @brief Creates the query pools, if the device can write timestamps
+		 *
+		 * @param numberOfFrames				Number of frames in flight of the stream
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanGPUProfiler(uint32_t numberOfFrames);
+
+		/**
+		 * @brief Destroys the query pools
+		 *
+		 * @note The GPU should be done with the command buffers which used them (vkDeviceWaitIdle)
+		 * @since Karma 1.0.0
+		 */
+		~VulkanGPUProfiler();
+
+		/**
+		 * @brief Resolves the frame's previous results and resets its queries in the command buffer. To be recorded before any scope and
+		 * outside of a render pass.
+		 *
+		 * @param commandBuffer					Primary command buffer being recorded
+		 * @param frameIndex					The frame in flight whose fence has been waited upon
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		/**
+		 * @brief Writes the begin timestamp of the scope (VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT)
+		 *
+		 * @param commandBuffer					The command buffer of BeginFrame
+		 * @param scopeName						Name the results are reported under
+		 * @param bPipelineStatistics			Whether to count the invocations too (see GPUProfiler::IsPipelineStatisticsEnabled)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void BeginScope(VkCommandBuffer commandBuffer, const char* scopeName, bool bPipelineStatistics = false);
+
+		/**
+		 * @brief Writes the end timestamp (VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT) of the innermost open scope
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void EndScope(VkCommandBuffer commandBuffer);
+
+		/**
+		 * @brief GPU time, in milliseconds, between two timestamps written on the graphics queue
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static double TimestampsToMilliseconds(uint64_t beginTimestamp, uint64_t endTimestamp);
+
+		/**
+		 * @brief Reads a result of a pool created with s_PipelineStatisticsFlags, the counters being in the order of their bits
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static GPUPipelineStatistics ReadPipelineStatistics(const uint64_t* result);
+
+	public:
+		/**
+		 * @brief The counters of a pipeline statistics query, matching GPUPipelineStatistics
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr VkQueryPipelineStatisticFlags s_PipelineStatisticsFlags = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+		/**
+		 * @brief Number of counters (uint64_t) in a result of such a query
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr uint32_t s_NumberOfPipelineStatistics = 4;
+
+	private:
+		/**
+		 * @brief A scope recorded in a frame, the timestamps at m_BeginQuery and m_BeginQuery + 1
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Scope
+		{
+			std::string m_Name;
+			uint32_t m_BeginQuery = 0;
+			uint32_t m_StatisticsQuery = UINT32_MAX;
+			bool m_bEnded = false;
+		};
+
+		/**
+		 * @brief Pools of a frame in flight and the scopes recorded into them
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Frame
+		{
+			VkQueryPool m_TimestampPool = VK_NULL_HANDLE;
+			VkQueryPool m_StatisticsPool = VK_NULL_HANDLE;
+			std::vector<Scope> m_Scopes;
+			uint32_t m_NumberOfTimestamps = 0;
+			uint32_t m_NumberOfStatistics = 0;
+			bool m_bActive = false;
+			bool m_bStatisticsActive = false;
+		};
+
+		void ResolveFrame(Frame& frame);
+
+	private:
+		VkDevice m_Device;
+
+		bool m_bTimestampsSupported;
+		bool m_bStatisticsSupported;
+
+		std::vector<Frame> m_Frames;
+		uint32_t m_CurrentFrame;
+
+		// Indices (into the current frame's m_Scopes) of the open scopes, UINT32_MAX for the ones not recorded
+		std::vector<uint32_t> m_OpenScopes;
+		bool m_bStatisticsScopeOpen;
+	};
+}
@@ -0,0 +1,635 @@
+#include "VulkanParallelRecorder.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+#include "Platform/Vulkan/VulkanVertexArray.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+#include "Platform/Vulkan/VulkanGPUProfiler.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace Karma
+{
+	VulkanParallelRecorder::VulkanParallelRecorder(uint32_t graphicsFamily, uint32_t numberOfFrames, int32_t numberOfWorkers) :
+		m_GraphicsFamily(graphicsFamily), m_NumberOfFrames(numberOfFrames), m_Generation(0), m_PendingWorkers(0), m_bQuit(false),
+		m_FrameIndex(0), m_InheritanceInfo{}, m_Extent{}, m_DrawCommands(nullptr), m_NumberOfChunks(0), m_QueriesPerPass(0)
+	{
+		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
+
+		// Enabled on the device when supported, see VulkanContext::CreateLogicalDevice
+		m_bQueriesSupported = VulkanHolder::GetVulkanContext()->GetSupportedDeviceFeatures().pipelineStatisticsQuery == VK_TRUE;
+		m_bTimestampsSupported = VulkanHolder::GetVulkanContext()->SupportsTimestamps();
+
+		for (uint32_t pass = 0; pass < s_NumberOfRenderPasses; pass++)
+		{
+			m_FragmentInvocations[pass] = 0;
+			m_bHasFragmentInvocations[pass] = false;
+		}
+
+		if (numberOfWorkers < 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			numberOfWorkers = hardwareThreads > 1 ? int32_t(hardwareThreads - 1) : 0;
+		}
+
+		SpawnWorkers(uint32_t(numberOfWorkers));
+
+		KR_CORE_INFO("VulkanParallelRecorder: {0} worker thread(s)", numberOfWorkers);
+	}
+
+	VulkanParallelRecorder::~VulkanParallelRecorder()
+	{
+		JoinWorkers();
+	}
+
+	void VulkanParallelRecorder::SetNumberOfWorkers(uint32_t numberOfWorkers)
+	{
+		vkDeviceWaitIdle(m_Device);
+
+		JoinWorkers();
+		SpawnWorkers(numberOfWorkers);
+	}
+
+	void VulkanParallelRecorder::SpawnWorkers(uint32_t numberOfWorkers)
+	{
+		CreateContexts(numberOfWorkers + 1);
+		CreateQueryPools(numberOfWorkers + 1);
+
+		m_bQuit = false;
+
+		for (uint32_t counter = 0; counter < numberOfWorkers; counter++)
+		{
+			// Workers start from the present generation, so they neither replay an old job nor miss the next one
+			m_Workers.emplace_back(&VulkanParallelRecorder::WorkerLoop, this, counter + 1, m_Generation);
+		}
+	}
+
+	void VulkanParallelRecorder::JoinWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bQuit = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+		m_Workers.clear();
+
+		DestroyContexts();
+		DestroyQueryPools();
+	}
+
+	void VulkanParallelRecorder::CreateContexts(uint32_t numberOfContexts)
+	{
+		m_Contexts.resize(numberOfContexts);
+
+		for (auto& context : m_Contexts)
+		{
+			context.resize(m_NumberOfFrames);
+
+			for (auto& contextFrame : context)
+			{
+				VkCommandPoolCreateInfo poolInfo{};
+				poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+				poolInfo.queueFamilyIndex = m_GraphicsFamily;
+				poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+				VkResult result = vkCreateCommandPool(m_Device, &poolInfo, nullptr, &contextFrame.m_CommandPool);
+				KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create recording command pool!");
+
+				VkCommandBufferAllocateInfo allocInfo{};
+				allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+				allocInfo.commandPool = contextFrame.m_CommandPool;
+				allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+				allocInfo.commandBufferCount = 1;
+
+				result = vkAllocateCommandBuffers(m_Device, &allocInfo, &contextFrame.m_CommandBuffer);
+				KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate secondary command buffer!");
+			}
+		}
+	}
+
+	void VulkanParallelRecorder::DestroyContexts()
+	{
+		for (auto& context : m_Contexts)
+		{
+			for (auto& contextFrame : context)
+			{
+				// Command buffers are freed with the pool
+				vkDestroyCommandPool(m_Device, contextFrame.m_CommandPool, nullptr);
+			}
+		}
+
+		m_Contexts.clear();
+	}
+
+	void VulkanParallelRecorder::CreateQueryPools(uint32_t numberOfContexts)
+	{
+		m_QueriedChunks.assign(m_NumberOfFrames, 0);
+		m_QueriedPasses.assign(m_NumberOfFrames, 0);
+		m_bTimedFrames.assign(m_NumberOfFrames, false);
+		m_PassChunks.resize(m_NumberOfFrames);
+
+		// A chunk is recorded by one context, so there are at most as many chunks as contexts
+		m_QueriesPerPass = numberOfContexts;
+
+		if (m_bQueriesSupported)
+		{
+			m_QueryPools.resize(m_NumberOfFrames);
+
+			for (auto& queryPool : m_QueryPools)
+			{
+				VkQueryPoolCreateInfo queryPoolInfo{};
+				queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+				queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+				queryPoolInfo.queryCount = s_NumberOfRenderPasses * m_QueriesPerPass;
+				queryPoolInfo.pipelineStatistics = VulkanGPUProfiler::s_PipelineStatisticsFlags;
+
+				VkResult result = vkCreateQueryPool(m_Device, &queryPoolInfo, nullptr, &queryPool);
+				KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline statistics query pool!");
+			}
+		}
+
+		if (m_bTimestampsSupported)
+		{
+			m_TimestampPools.resize(m_NumberOfFrames);
+
+			for (auto& queryPool : m_TimestampPools)
+			{
+				VkQueryPoolCreateInfo queryPoolInfo{};
+				queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+				queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+				queryPoolInfo.queryCount = 2 * s_NumberOfRenderPasses * m_QueriesPerPass;
+
+				VkResult result = vkCreateQueryPool(m_Device, &queryPoolInfo, nullptr, &queryPool);
+				KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create timestamp query pool!");
+			}
+		}
+	}
+
+	void VulkanParallelRecorder::DestroyQueryPools()
+	{
+		for (auto& queryPool : m_QueryPools)
+		{
+			vkDestroyQueryPool(m_Device, queryPool, nullptr);
+		}
+
+		for (auto& queryPool : m_TimestampPools)
+		{
+			vkDestroyQueryPool(m_Device, queryPool, nullptr);
+		}
+
+		m_QueryPools.clear();
+		m_TimestampPools.clear();
+	}
+
+	void VulkanParallelRecorder::ResetQueries(VkCommandBuffer primary, uint32_t frameIndex)
+	{
+		if (!m_QueryPools.empty())
+		{
+			vkCmdResetQueryPool(primary, m_QueryPools[frameIndex], 0, s_NumberOfRenderPasses * m_QueriesPerPass);
+		}
+
+		// Decided here for the whole frame, Record follows within the same recording
+		m_bTimedFrames[frameIndex] = !m_TimestampPools.empty() && GPUProfiler::IsEnabled();
+
+		if (m_bTimedFrames[frameIndex])
+		{
+			vkCmdResetQueryPool(primary, m_TimestampPools[frameIndex], 0, 2 * s_NumberOfRenderPasses * m_QueriesPerPass);
+		}
+	}
+
+	void VulkanParallelRecorder::CollectQueryResults(uint32_t frameIndex)
+	{
+		if (m_QueriedChunks[frameIndex] == 0)
+		{
+			return;
+		}
+
+		const uint32_t numberOfChunks = m_QueriedChunks[frameIndex];
+
+		// Every result is followed by its availability, the fence has been waited upon so all should be there but nothing is waited for
+		const uint32_t stride = VulkanGPUProfiler::s_NumberOfPipelineStatistics + 1;
+		std::vector<uint64_t> results(numberOfChunks * stride);
+
+		for (uint32_t pass = 0; pass < s_NumberOfRenderPasses; pass++)
+		{
+			if (!(m_QueriedPasses[frameIndex] & (1u << pass)))
+			{
+				continue;
+			}
+
+			const char* passName = GetRenderPassName(RenderPassType(pass));
+
+			if (!m_QueryPools.empty())
+			{
+				VkResult result = vkGetQueryPoolResults(m_Device, m_QueryPools[frameIndex], pass * m_QueriesPerPass, numberOfChunks,
+					results.size() * sizeof(uint64_t), results.data(), stride * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+				GPUPipelineStatistics passStatistics;
+				bool bAvailable = result == VK_SUCCESS || result == VK_NOT_READY;
+
+				for (uint32_t chunk = 0; chunk < numberOfChunks && bAvailable; chunk++)
+				{
+					const uint64_t* counters = &results[chunk * stride];
+
+					if (counters[VulkanGPUProfiler::s_NumberOfPipelineStatistics] == 0)
+					{
+						bAvailable = false;
+						break;
+					}
+
+					GPUPipelineStatistics chunkStatistics = VulkanGPUProfiler::ReadPipelineStatistics(counters);
+
+					passStatistics.m_VertexInvocations += chunkStatistics.m_VertexInvocations;
+					passStatistics.m_ClippingInvocations += chunkStatistics.m_ClippingInvocations;
+					passStatistics.m_ClippingPrimitives += chunkStatistics.m_ClippingPrimitives;
+					passStatistics.m_FragmentInvocations += chunkStatistics.m_FragmentInvocations;
+				}
+
+				if (bAvailable)
+				{
+					m_FragmentInvocations[pass] = passStatistics.m_FragmentInvocations;
+					m_bHasFragmentInvocations[pass] = true;
+
+					if (GPUProfiler::IsPipelineStatisticsEnabled())
+					{
+						GPUProfiler::ReportPipelineStatistics(passName, passStatistics);
+					}
+				}
+			}
+
+			if (m_bTimedFrames[frameIndex])
+			{
+				// From the begin of the pass's run in its first chunk to the end of the run in its last one
+				const std::pair<uint32_t, uint32_t>& chunks = m_PassChunks[frameIndex][pass];
+
+				uint64_t begin[2] = { 0, 0 };
+				uint64_t end[2] = { 0, 0 };
+
+				vkGetQueryPoolResults(m_Device, m_TimestampPools[frameIndex], 2 * (pass * m_QueriesPerPass + chunks.first), 1, sizeof(begin), begin,
+					sizeof(begin), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+				vkGetQueryPoolResults(m_Device, m_TimestampPools[frameIndex], 2 * (pass * m_QueriesPerPass + chunks.second) + 1, 1, sizeof(end), end,
+					sizeof(end), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+				if (begin[1] != 0 && end[1] != 0)
+				{
+					GPUProfiler::ReportTime(passName, VulkanGPUProfiler::TimestampsToMilliseconds(begin[0], end[0]));
+				}
+			}
+		}
+
+		m_QueriedChunks[frameIndex] = 0;
+	}
+
+	bool VulkanParallelRecorder::GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const
+	{
+		if (!m_bHasFragmentInvocations[uint32_t(pass)])
+		{
+			return false;
+		}
+
+		invocations = m_FragmentInvocations[uint32_t(pass)];
+		return true;
+	}
+
+	void VulkanParallelRecorder::WorkerLoop(uint32_t contextIndex, uint64_t seenGeneration)
+	{
+		while (true)
+		{
+			uint32_t numberOfChunks;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeCondition.wait(lock, [&] { return m_bQuit || m_Generation != seenGeneration; });
+
+				if (m_bQuit)
+				{
+					return;
+				}
+
+				seenGeneration = m_Generation;
+				numberOfChunks = m_NumberOfChunks;
+			}
+
+			if (contextIndex < numberOfChunks)
+			{
+				RecordChunk(contextIndex, contextIndex);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (--m_PendingWorkers == 0)
+				{
+					m_DoneCondition.notify_one();
+				}
+			}
+		}
+	}
+
+	void VulkanParallelRecorder::Record(VkCommandBuffer primary, uint32_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent,
+		const std::vector<VulkanDrawCommand>& drawCommands)
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+
+		uint32_t numberOfDraws = uint32_t(drawCommands.size());
+		uint32_t numberOfContexts = uint32_t(m_Contexts.size());
+
+		uint32_t numberOfChunks = (numberOfDraws + s_MinimumDrawsPerChunk - 1) / s_MinimumDrawsPerChunk;
+		numberOfChunks = std::max(1u, std::min(numberOfChunks, numberOfContexts));
+
+		m_InheritanceInfo = {};
+		m_InheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		m_InheritanceInfo.renderPass = renderPass;
+		m_InheritanceInfo.subpass = 0;
+		m_InheritanceInfo.framebuffer = framebuffer;
+
+		m_FrameIndex = frameIndex;
+		m_Extent = extent;
+		m_DrawCommands = &drawCommands;
+		m_ChunkDescriptorBinds.assign(numberOfChunks, 0);
+
+		if (!m_QueryPools.empty() || m_bTimedFrames[frameIndex])
+		{
+			uint32_t passes = 0;
+			std::array<std::pair<uint32_t, uint32_t>, s_NumberOfRenderPasses>& passChunks = m_PassChunks[frameIndex];
+
+			// Chunk c holds the draws [numberOfDraws * c / numberOfChunks, numberOfDraws * (c + 1) / numberOfChunks)
+			uint32_t chunk = 0;
+			for (uint32_t counter = 0; counter < numberOfDraws; counter++)
+			{
+				while (counter >= uint64_t(numberOfDraws) * (chunk + 1) / numberOfChunks)
+				{
+					chunk++;
+				}
+
+				uint32_t pass = uint32_t(drawCommands[counter].m_Pass);
+
+				if (!(passes & (1u << pass)))
+				{
+					passChunks[pass].first = chunk;
+					passes |= 1u << pass;
+				}
+				passChunks[pass].second = chunk;
+			}
+
+			m_QueriedChunks[frameIndex] = numberOfChunks;
+			m_QueriedPasses[frameIndex] = passes;
+		}
+
+		if (numberOfChunks > 1)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_NumberOfChunks = numberOfChunks;
+				m_PendingWorkers = uint32_t(m_Workers.size());
+				m_Generation++;
+			}
+			m_WakeCondition.notify_all();
+		}
+		else
+		{
+			m_NumberOfChunks = 1;
+		}
+
+		// The calling thread records the first chunk
+		RecordChunk(0, 0);
+
+		if (numberOfChunks > 1)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_DoneCondition.wait(lock, [&] { return m_PendingWorkers == 0; });
+		}
+
+		// Deterministic order, irrespective of who finished first
+		std::vector<VkCommandBuffer> secondaries(numberOfChunks);
+		for (uint32_t chunk = 0; chunk < numberOfChunks; chunk++)
+		{
+			secondaries[chunk] = m_Contexts[chunk][frameIndex].m_CommandBuffer;
+		}
+
+		vkCmdExecuteCommands(primary, numberOfChunks, secondaries.data());
+
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		m_Statistics.m_NumberOfDraws = numberOfDraws;
+		m_Statistics.m_NumberOfChunks = numberOfChunks;
+		m_Statistics.m_RecordingTimeMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+		m_Statistics.m_NumberOfDescriptorBinds = 0;
+		for (uint32_t descriptorBinds : m_ChunkDescriptorBinds)
+		{
+			m_Statistics.m_NumberOfDescriptorBinds += descriptorBinds;
+		}
+	}
+
+	void VulkanParallelRecorder::RecordChunk(uint32_t contextIndex, uint32_t chunkIndex)
+	{
+		ContextFrame& contextFrame = m_Contexts[contextIndex][m_FrameIndex];
+
+		// The fence of this frame has been waited upon, so the previous recording is no longer in use
+		vkResetCommandPool(m_Device, contextFrame.m_CommandPool, 0);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &m_InheritanceInfo;
+
+		VkResult result = vkBeginCommandBuffer(contextFrame.m_CommandBuffer, &beginInfo);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to begin recording secondary command buffer");
+
+		// Contiguous, nearly equal, chunks
+		size_t numberOfDraws = m_DrawCommands->size();
+		size_t first = numberOfDraws * chunkIndex / m_NumberOfChunks;
+		size_t last = numberOfDraws * (chunkIndex + 1) / m_NumberOfChunks;
+
+		const VulkanDrawCommand* drawCommands = m_DrawCommands->data();
+
+		const bool bTimed = m_bTimedFrames[m_FrameIndex];
+
+		uint32_t& descriptorBinds = m_ChunkDescriptorBinds[chunkIndex];
+
+		if (m_QueryPools.empty() && !bTimed)
+		{
+			if (last > first)
+			{
+				descriptorBinds += RecordDraws(contextFrame.m_CommandBuffer, m_Extent, drawCommands + first, last - first);
+			}
+		}
+		else
+		{
+			VkQueryPool queryPool = m_QueryPools.empty() ? VK_NULL_HANDLE : m_QueryPools[m_FrameIndex];
+			VkQueryPool timestampPool = bTimed ? m_TimestampPools[m_FrameIndex] : VK_NULL_HANDLE;
+
+			// The passes come in order (Renderer::Submit), so each is one contiguous run of the chunk. Every query of the chunk is begun
+			// and ended, even around no draws, so that all the results read by CollectQueryResults become available.
+			size_t runStart = first;
+			for (uint32_t pass = 0; pass < s_NumberOfRenderPasses; pass++)
+			{
+				size_t runEnd = runStart;
+				while (runEnd < last && uint32_t(drawCommands[runEnd].m_Pass) == pass)
+				{
+					runEnd++;
+				}
+
+				uint32_t query = pass * m_QueriesPerPass + chunkIndex;
+
+				if (timestampPool != VK_NULL_HANDLE)
+				{
+					vkCmdWriteTimestamp(contextFrame.m_CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool, 2 * query);
+				}
+				if (queryPool != VK_NULL_HANDLE)
+				{
+					vkCmdBeginQuery(contextFrame.m_CommandBuffer, queryPool, query, 0);
+				}
+
+				if (runEnd > runStart)
+				{
+					descriptorBinds += RecordDraws(contextFrame.m_CommandBuffer, m_Extent, drawCommands + runStart, runEnd - runStart);
+				}
+
+				if (queryPool != VK_NULL_HANDLE)
+				{
+					vkCmdEndQuery(contextFrame.m_CommandBuffer, queryPool, query);
+				}
+				if (timestampPool != VK_NULL_HANDLE)
+				{
+					vkCmdWriteTimestamp(contextFrame.m_CommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 2 * query + 1);
+				}
+
+				runStart = runEnd;
+			}
+
+			// Draws out of pass order, if any, go uncounted
+			if (last > runStart)
+			{
+				descriptorBinds += RecordDraws(contextFrame.m_CommandBuffer, m_Extent, drawCommands + runStart, last - runStart);
+			}
+		}
+
+		result = vkEndCommandBuffer(contextFrame.m_CommandBuffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to record secondary command buffer");
+	}
+
+	uint32_t VulkanParallelRecorder::RecordDraws(VkCommandBuffer commandBuffer, VkExtent2D extent, const VulkanDrawCommand* first, size_t count)
+	{
+		// Viewport and scissor are dynamic (see VulkanVertexArray::BuildGraphicsPipeline), which keeps the pipelines valid across
+		// swapchain recreation
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = extent;
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		VkViewport boundViewport{};
+		bool bViewportSet = false;
+
+		// What is bound presently. Layouts and sets are shared (see VulkanDescriptorCache) so comparing handles tells redundant binds.
+		VkPipeline boundPipeline = VK_NULL_HANDLE;
+		VkPipelineLayout boundPipelineLayout = VK_NULL_HANDLE;
+		VkDescriptorSet boundDescriptorSet = VK_NULL_HANDLE;
+		uint32_t boundDynamicOffset = 0;
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+		VkBuffer boundInstanceBuffer = VK_NULL_HANDLE;
+		VkDeviceSize boundInstanceOffset = 0;
+
+		// Bindless: the table is bound once per pipeline layout, and a draw changes only the material index
+		VkPipelineLayout boundBindlessLayout = VK_NULL_HANDLE;
+		uint32_t pushedMaterialIndex = UINT32_MAX;
+		VulkanBindlessTable* bindlessTable = VulkanHolder::GetVulkanContext()->GetBindlessTable();
+
+		uint32_t descriptorBinds = 0;
+
+		for (size_t counter = 0; counter < count; counter++)
+		{
+			const std::shared_ptr<VulkanVertexArray>& vulkanVA = first[counter].m_VertexArray;
+
+			// The depth only pipeline shares the layout, so the descriptor sets below serve both
+			VkPipeline pipeline = first[counter].m_Pass == RenderPassType::DepthPrePass ? vulkanVA->GetDepthOnlyPipeline() : vulkanVA->GetGraphicsPipeline();
+
+			if (pipeline != boundPipeline)
+			{
+				boundPipeline = pipeline;
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline);
+			}
+
+			VkViewport viewport = vulkanVA->GetViewport(extent);
+			if (!bViewportSet || viewport.x != boundViewport.x || viewport.y != boundViewport.y || viewport.width != boundViewport.width ||
+				viewport.height != boundViewport.height)
+			{
+				bViewportSet = true;
+				boundViewport = viewport;
+				vkCmdSetViewport(commandBuffer, 0, 1, &boundViewport);
+			}
+
+			// Bind vertex/index buffers
+			VkBuffer vertexBuffer = vulkanVA->GetVertexBuffer()->GetVertexBuffer();
+			if (vertexBuffer != boundVertexBuffer)
+			{
+				VkDeviceSize offsets[] = { 0 };
+
+				boundVertexBuffer = vertexBuffer;
+				vkCmdBindVertexBuffers(commandBuffer, 0, 1, &boundVertexBuffer, offsets);
+			}
+
+			VkBuffer indexBuffer = vulkanVA->GetIndexBuffer()->GetIndexBuffer();
+			if (indexBuffer != boundIndexBuffer)
+			{
+				boundIndexBuffer = indexBuffer;
+				vkCmdBindIndexBuffer(commandBuffer, boundIndexBuffer, 0, vulkanVA->GetIndexBuffer()->GetVulkanIndexType());
+			}
+
+			// The dynamic offset points to this draw's uniforms in the uniform ring
+			VkDescriptorSet descriptorSet = vulkanVA->GetDescriptorSet();
+			uint32_t dynamicOffset = first[counter].m_DynamicOffset;
+
+			if (descriptorSet != boundDescriptorSet || dynamicOffset != boundDynamicOffset || vulkanVA->GetGraphicsPipelineLayout() != boundPipelineLayout)
+			{
+				boundDescriptorSet = descriptorSet;
+				boundDynamicOffset = dynamicOffset;
+				boundPipelineLayout = vulkanVA->GetGraphicsPipelineLayout();
+
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipelineLayout, 0, 1, &boundDescriptorSet, 1, &boundDynamicOffset);
+				descriptorBinds++;
+			}
+
+			if (vulkanVA->UsesBindless())
+			{
+				if (boundBindlessLayout != boundPipelineLayout)
+				{
+					VkDescriptorSet bindlessSet = bindlessTable->GetDescriptorSet();
+
+					boundBindlessLayout = boundPipelineLayout;
+					pushedMaterialIndex = UINT32_MAX;
+
+					vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundBindlessLayout, VulkanBindlessTable::s_SetIndex, 1,
+						&bindlessSet, 0, nullptr);
+					descriptorBinds++;
+				}
+
+				uint32_t materialIndex = vulkanVA->GetMaterialIndex();
+				if (materialIndex != pushedMaterialIndex)
+				{
+					pushedMaterialIndex = materialIndex;
+					vkCmdPushConstants(commandBuffer, boundPipelineLayout, VulkanVertexArray::s_MaterialIndexStages, 0, sizeof(uint32_t), &pushedMaterialIndex);
+				}
+			}
+
+			// Per instance world matrices
+			const VulkanDrawCommand& drawCommand = first[counter];
+			if (drawCommand.m_InstanceBuffer != VK_NULL_HANDLE &&
+				(drawCommand.m_InstanceBuffer != boundInstanceBuffer || drawCommand.m_InstanceOffset != boundInstanceOffset))
+			{
+				boundInstanceBuffer = drawCommand.m_InstanceBuffer;
+				boundInstanceOffset = drawCommand.m_InstanceOffset;
+
+				vkCmdBindVertexBuffers(commandBuffer, VulkanVertexArray::s_InstanceBinding, 1, &boundInstanceBuffer, &boundInstanceOffset);
+			}
+
+			vkCmdDrawIndexed(commandBuffer, vulkanVA->GetIndexBuffer()->GetCount(), drawCommand.m_InstanceCount, 0, 0, 0);
+		}
+
+		return descriptorBinds;
+	}
+}
@@ -0,0 +1,307 @@
+/**
+ * @file VulkanParallelRecorder.h
+ * @brief This file contains VulkanParallelRecorder class, which records the draws of a frame on multiple threads using secondary command buffers.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "vulkan/vulkan.h"
+#include "Karma/Renderer/RenderPass.h"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class VulkanVertexArray;
+
+	/**
+	 * @brief A queued draw: the vertex array and the offset of its uniforms in the uniform ring. The offset is captured when the draw is queued,
+	 * so that a vertex array drawn several times in a frame (for instance by several render proxies) uses the right uniforms each time.
+	 *
+	 * @see VulkanRendererAPI::DrawIndexed
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API VulkanDrawCommand
+	{
+		/**
+		 * @brief The vertex array to be drawn
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::shared_ptr<VulkanVertexArray> m_VertexArray;
+
+		/**
+		 * @brief Dynamic offset of the uniforms (UniformBufferObject::GetRingOffset at the time of DrawIndexed)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_DynamicOffset = 0;
+
+		/**
+		 * @brief Number of instances drawn
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_InstanceCount = 1;
+
+		/**
+		 * @brief Buffer holding the per instance world matrices (VK_NULL_HANDLE for draws of shaders without them)
+		 *
+		 * @see VulkanRendererAPI::DrawIndexedInstanced
+		 * @since Karma 1.0.0
+		 */
+		VkBuffer m_InstanceBuffer = VK_NULL_HANDLE;
+
+		/**
+		 * @brief Offset of the first world matrix in m_InstanceBuffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDeviceSize m_InstanceOffset = 0;
+
+		/**
+		 * @brief The pass the draw belongs to (RendererAPI::BeginPass at the time of the draw). Depth pre-pass draws use
+		 * VulkanVertexArray::GetDepthOnlyPipeline.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		RenderPassType m_Pass = RenderPassType::Opaque;
+	};
+
+	/**
+	 * @brief Counters of the latest VulkanParallelRecorder::Record call. Changing the number of workers (SetNumberOfWorkers) and comparing
+	 * m_RecordingTimeMicroseconds gives the scaling of the recording with threads.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API ParallelRecordingStatistics
+	{
+		/**
+		 * @brief Number of draws recorded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfDraws = 0;
+
+		/**
+		 * @brief Number of secondary command buffers (chunks of the draw list) recorded, hence the threads involved
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfChunks = 0;
+
+		/**
+		 * @brief Wall clock time for recording all the secondaries (main thread's point of view)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_RecordingTimeMicroseconds = 0;
+
+		/**
+		 * @brief Number of vkCmdBindDescriptorSets recorded, the per draw sets and the bindless table together. Comparing runs with and
+		 * without --bindless gives the rebinds the table saves.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t m_NumberOfDescriptorBinds = 0;
+	};
+
+	/**
+	 * @brief Partitions the draw list (VulkanDrawCommand) into contiguous chunks and records each chunk into a secondary command buffer on a worker
+	 * thread. Every recording context (the calling thread plus the workers) has its own command pool per frame in flight, so no pool is touched by
+	 * two threads. The primary command buffer executes the secondaries in chunk order, so the result is deterministic regardless of which
+	 * thread finishes first.
+	 *
+	 * Small draw lists (less than s_MinimumDrawsPerChunk draws per context) use fewer chunks, down to a single one recorded on the calling thread.
+	 *
+	 * If the device has pipeline statistics queries, each secondary counts the invocations (VulkanGPUProfiler::s_PipelineStatisticsFlags) of each
+	 * pass (RenderPassType) in a query of its own. The results are summed per pass once the frame's fence has been waited upon (CollectQueryResults).
+	 * While GPUProfiler is enabled, each run of a pass in a secondary is also bracketed by timestamps, the pass taking from the begin timestamp
+	 * of its first chunk to the end timestamp of its last. Both are reported to GPUProfiler under GetRenderPassName.
+	 *
+	 * @see VulkanRendererAPI::RecordCommandBuffers
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanParallelRecorder
+	{
+	public:
+		/**
+		 * @brief Creates the command pools and spawns the workers
+		 *
+		 * @param graphicsFamily				Queue family index of the graphics queue
+		 * @param numberOfFrames				Number of frames in flight
+		 * @param numberOfWorkers				Number of worker threads (besides the calling thread). -1 picks hardware concurrency - 1.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanParallelRecorder(uint32_t graphicsFamily, uint32_t numberOfFrames, int32_t numberOfWorkers = -1);
+
+		/**
+		 * @brief Joins the workers and destroys the command pools
+		 *
+		 * @note The GPU should be done with the secondaries (vkDeviceWaitIdle) by the time this is called
+		 * @since Karma 1.0.0
+		 */
+		~VulkanParallelRecorder();
+
+		/**
+		 * @brief Records the draws into secondaries and executes them (vkCmdExecuteCommands) in the primary
+		 *
+		 * @param primary						Primary command buffer, within a render pass begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+		 * @param frameIndex					The frame in flight whose fence has been waited upon
+		 * @param renderPass					The render pass begun in the primary
+		 * @param framebuffer					The framebuffer begun in the primary
+		 * @param extent						Extent of the framebuffer, for the dynamic viewport and scissor
+		 * @param drawCommands					The draw list
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Record(VkCommandBuffer primary, uint32_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent,
+			const std::vector<VulkanDrawCommand>& drawCommands);
+
+		/**
+		 * @brief Resets the queries of the frame. To be recorded in the primary before the render pass begins (resets aren't allowed within).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ResetQueries(VkCommandBuffer primary, uint32_t frameIndex);
+
+		/**
+		 * @brief Sums the query results of the frame's previous recording into the per pass counts, and reports the pass timings. To be
+		 * called after the frame's fence has been waited upon. Results which aren't available are skipped, not waited for.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CollectQueryResults(uint32_t frameIndex);
+
+		/**
+		 * @brief Fragment shader invocations of the pass in the latest frame whose results were collected
+		 *
+		 * @return false if the device has no pipeline statistics queries, or the pass hasn't been drawn yet
+		 * @since Karma 1.0.0
+		 */
+		bool GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const;
+
+		/**
+		 * @brief Records the draws [first, first + count), binding the pipeline, buffers and descriptor set only when they change.
+		 * Secondaries don't inherit dynamic state, so the scissor (whole of extent) and viewport (VulkanVertexArray::GetViewport) are set here.
+		 *
+		 * @return Number of descriptor set binds recorded
+		 * @since Karma 1.0.0
+		 */
+		static uint32_t RecordDraws(VkCommandBuffer commandBuffer, VkExtent2D extent, const VulkanDrawCommand* first, size_t count);
+
+		/**
+		 * @brief Joins the present workers and spawns numberOfWorkers fresh ones
+		 *
+		 * @note Waits for the device to be idle
+		 * @since Karma 1.0.0
+		 */
+		void SetNumberOfWorkers(uint32_t numberOfWorkers);
+
+		/**
+		 * @brief Number of worker threads (besides the calling thread)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetNumberOfWorkers() const { return uint32_t(m_Workers.size()); }
+
+		/**
+		 * @brief Counters of the latest Record call
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const ParallelRecordingStatistics& GetStatistics() const { return m_Statistics; }
+
+	private:
+		/**
+		 * @brief Command pool, with a secondary command buffer, of a recording context for a frame in flight
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct ContextFrame
+		{
+			VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+			VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+		};
+
+		void CreateContexts(uint32_t numberOfContexts);
+		void DestroyContexts();
+
+		void CreateQueryPools(uint32_t numberOfContexts);
+		void DestroyQueryPools();
+
+		void SpawnWorkers(uint32_t numberOfWorkers);
+		void JoinWorkers();
+
+		void WorkerLoop(uint32_t contextIndex, uint64_t seenGeneration);
+
+		/**
+		 * @brief Records chunk number chunkIndex of the present job, using the pool of contextIndex
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RecordChunk(uint32_t contextIndex, uint32_t chunkIndex);
+
+	private:
+		VkDevice m_Device;
+		uint32_t m_GraphicsFamily;
+		uint32_t m_NumberOfFrames;
+
+		// [context][frame], context 0 belongs to the calling thread and context i to worker i - 1
+		std::vector<std::vector<ContextFrame>> m_Contexts;
+
+		std::vector<std::thread> m_Workers;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeCondition;
+		std::condition_variable m_DoneCondition;
+		uint64_t m_Generation;
+		uint32_t m_PendingWorkers;
+		bool m_bQuit;
+
+		// The present job
+		uint32_t m_FrameIndex;
+		VkCommandBufferInheritanceInfo m_InheritanceInfo;
+		VkExtent2D m_Extent;
+		const std::vector<VulkanDrawCommand>* m_DrawCommands;
+		uint32_t m_NumberOfChunks;
+
+		// Descriptor set binds of each chunk of the present job, summed into m_Statistics once the chunks are recorded
+		std::vector<uint32_t> m_ChunkDescriptorBinds;
+
+		ParallelRecordingStatistics m_Statistics;
+
+		// Pipeline statistics: a pool per frame with a query per (pass, context), query pass * contexts + chunk. For each frame, the chunks
+		// recorded and the passes drawn, so that only those results are read.
+		bool m_bQueriesSupported;
+		std::vector<VkQueryPool> m_QueryPools;
+		uint32_t m_QueriesPerPass;
+		std::vector<uint32_t> m_QueriedChunks;
+		std::vector<uint32_t> m_QueriedPasses;
+
+		// Timestamps: a pool per frame with a pair (begin, end) per query of the above. For each frame whether they were written, and the
+		// first and last chunk of each pass.
+		bool m_bTimestampsSupported;
+		std::vector<VkQueryPool> m_TimestampPools;
+		std::vector<bool> m_bTimedFrames;
+		std::vector<std::array<std::pair<uint32_t, uint32_t>, s_NumberOfRenderPasses>> m_PassChunks;
+
+		// Read by the game thread (Renderer::Submit), written by the render thread
+		std::atomic<uint64_t> m_FragmentInvocations[s_NumberOfRenderPasses];
+		std::atomic<bool> m_bHasFragmentInvocations[s_NumberOfRenderPasses];
+
+		// Below this many draws per chunk, threading costs more than it saves
+		static constexpr uint32_t s_MinimumDrawsPerChunk = 64;
+	};
+}
@@ -0,0 +1,347 @@
+#include "VulkanRenderTarget.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+
+namespace Karma
+{
+	VulkanRenderTarget::VulkanRenderTarget(const RenderTargetSpecification& specification) : RenderTarget(specification),
+		m_ColorImage(VK_NULL_HANDLE), m_ColorImageMemory(VK_NULL_HANDLE), m_ColorImageView(VK_NULL_HANDLE), m_DepthImage(VK_NULL_HANDLE),
+		m_DepthImageMemory(VK_NULL_HANDLE), m_DepthImageView(VK_NULL_HANDLE), m_RenderPass(VK_NULL_HANDLE), m_Framebuffer(VK_NULL_HANDLE)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		m_Device = context->GetLogicalDevice();
+
+		// The pipelines decide the formats, see the note of the class. Viewport and scissor are dynamic, so any extent goes.
+		m_ColorFormat = context->GetSwapChainImageFormat();
+		m_DepthFormat = context->FindDepthFormat();
+
+		RenderTargetFormat colorFormat = RenderTargetFormat::BGRA8;
+		bool bKnownFormat = ToRenderTargetFormat(m_ColorFormat, colorFormat);
+		KR_CORE_ASSERT(bKnownFormat, "The swapchain format has no RenderTargetFormat");
+
+		if (colorFormat != specification.m_ColorFormat)
+		{
+			KR_CORE_WARN("VulkanRenderTarget: the swapchain's color format instead of the asked one, the pipelines are built against it");
+		}
+
+		m_Specification.m_ColorFormat = colorFormat;
+		m_Specification.m_DepthFormat = m_DepthFormat == VK_FORMAT_D32_SFLOAT ? RenderTargetDepthFormat::Depth32F : RenderTargetDepthFormat::Depth24Stencil8;
+
+		CreateAttachment(m_ColorFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
+			m_ColorImage, m_ColorImageMemory, m_ColorImageView);
+		CreateAttachment(m_DepthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, m_DepthImage, m_DepthImageMemory,
+			m_DepthImageView);
+
+		CreateRenderPass();
+
+		std::array<VkImageView, 2> attachments = { m_ColorImageView, m_DepthImageView };
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_RenderPass;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		framebufferInfo.pAttachments = attachments.data();
+		framebufferInfo.width = m_Specification.m_Width;
+		framebufferInfo.height = m_Specification.m_Height;
+		framebufferInfo.layers = 1;
+
+		VkResult result = vkCreateFramebuffer(m_Device, &framebufferInfo, nullptr, &m_Framebuffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create render target framebuffer");
+
+		CreateReadbackSlots();
+	}
+
+	VulkanRenderTarget::~VulkanRenderTarget()
+	{
+		vkDeviceWaitIdle(m_Device);
+
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			vkDestroyEvent(m_Device, slot.m_Event, nullptr);
+			vkUnmapMemory(m_Device, slot.m_Memory);
+			vkDestroyBuffer(m_Device, slot.m_Buffer, nullptr);
+			vkFreeMemory(m_Device, slot.m_Memory, nullptr);
+		}
+
+		vkDestroyFramebuffer(m_Device, m_Framebuffer, nullptr);
+		vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
+
+		vkDestroyImageView(m_Device, m_DepthImageView, nullptr);
+		vkDestroyImage(m_Device, m_DepthImage, nullptr);
+		vkFreeMemory(m_Device, m_DepthImageMemory, nullptr);
+
+		vkDestroyImageView(m_Device, m_ColorImageView, nullptr);
+		vkDestroyImage(m_Device, m_ColorImage, nullptr);
+		vkFreeMemory(m_Device, m_ColorImageMemory, nullptr);
+	}
+
+	bool VulkanRenderTarget::ToRenderTargetFormat(VkFormat format, RenderTargetFormat& renderTargetFormat)
+	{
+		switch (format)
+		{
+			case VK_FORMAT_R8G8B8A8_UNORM:
+			case VK_FORMAT_R8G8B8A8_SRGB:
+				renderTargetFormat = RenderTargetFormat::RGBA8;
+				return true;
+			case VK_FORMAT_B8G8R8A8_UNORM:
+			case VK_FORMAT_B8G8R8A8_SRGB:
+				renderTargetFormat = RenderTargetFormat::BGRA8;
+				return true;
+			case VK_FORMAT_R16G16B16A16_SFLOAT:
+				renderTargetFormat = RenderTargetFormat::RGBA16F;
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	void VulkanRenderTarget::CreateAttachment(VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect, VkImage& image,
+		VkDeviceMemory& memory, VkImageView& imageView)
+	{
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = m_Specification.m_Width;
+		imageInfo.extent.height = m_Specification.m_Height;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = format;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = usage;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkResult result = vkCreateImage(m_Device, &imageInfo, nullptr, &image);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create render target image");
+
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(m_Device, image, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = VulkanHolder::GetVulkanContext()->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate render target image memory");
+
+		vkBindImageMemory(m_Device, image, memory, 0);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = format;
+		viewInfo.subresourceRange.aspectMask = aspect;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		result = vkCreateImageView(m_Device, &viewInfo, nullptr, &imageView);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create render target imageview");
+	}
+
+	void VulkanRenderTarget::CreateRenderPass()
+	{
+		VkAttachmentDescription colorAttachment{};
+		colorAttachment.format = m_ColorFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		// Ready for the copy instead of the present
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+		VkAttachmentReference colorAttachmentRef{};
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentDescription depthAttachment{};
+		depthAttachment.format = m_DepthFormat;
+		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentReference depthAttachmentRef{};
+		depthAttachmentRef.attachment = 1;
+		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorAttachmentRef;
+		subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+		std::array<VkSubpassDependency, 2> dependencies{};
+
+		// The previous frame's copy reads the color attachment before this frame clears it
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		// The copy after the pass reads what the pass wrote
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+
+		VkResult result = vkCreateRenderPass(m_Device, &renderPassInfo, nullptr, &m_RenderPass);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create render target render pass");
+	}
+
+	void VulkanRenderTarget::CreateReadbackSlots()
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			VkBufferCreateInfo bufferInfo{};
+			bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferInfo.size = GetReadbackSize();
+			bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &slot.m_Buffer);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create readback buffer");
+
+			VkMemoryRequirements memRequirements;
+			vkGetBufferMemoryRequirements(m_Device, slot.m_Buffer, &memRequirements);
+
+			VkMemoryAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = memRequirements.size;
+			allocInfo.memoryTypeIndex = context->FindMemoryType(memRequirements.memoryTypeBits,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+			result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &slot.m_Memory);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate readback buffer memory");
+
+			vkBindBufferMemory(m_Device, slot.m_Buffer, slot.m_Memory, 0);
+
+			// Mapped for the lifetime of the target
+			vkMapMemory(m_Device, slot.m_Memory, 0, VK_WHOLE_SIZE, 0, &slot.m_MappedData);
+
+			VkEventCreateInfo eventInfo{};
+			eventInfo.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+			result = vkCreateEvent(m_Device, &eventInfo, nullptr, &slot.m_Event);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create readback event");
+		}
+	}
+
+	void VulkanRenderTarget::RecordReadback(VkCommandBuffer commandBuffer)
+	{
+		if (!EndFrame())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_ReadbackMutex);
+
+		ReadbackSlot* freeSlot = nullptr;
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			if (!slot.m_bPending)
+			{
+				freeSlot = &slot;
+				break;
+			}
+		}
+
+		if (freeSlot == nullptr)
+		{
+			m_Statistics.m_NumberOfDroppedReadbacks++;
+			return;
+		}
+
+		// Tightly packed rows (bufferRowLength of 0)
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { m_Specification.m_Width, m_Specification.m_Height, 1 };
+
+		vkCmdCopyImageToBuffer(commandBuffer, m_ColorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, freeSlot->m_Buffer, 1, &region);
+
+		// Make the copy visible to the host before the event says it is done
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = freeSlot->m_Buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+		vkCmdSetEvent(commandBuffer, freeSlot->m_Event, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		freeSlot->m_bPending = true;
+		freeSlot->m_IssueTime = std::chrono::steady_clock::now();
+		FillReadbackHeader(freeSlot->m_Header);
+
+		m_Statistics.m_NumberOfReadbacks++;
+	}
+
+	bool VulkanRenderTarget::PollReadback(RenderTargetReadback& readback)
+	{
+		std::lock_guard<std::mutex> lock(m_ReadbackMutex);
+
+		ReadbackSlot* oldestSlot = nullptr;
+		for (ReadbackSlot& slot : m_ReadbackSlots)
+		{
+			if (slot.m_bPending && (oldestSlot == nullptr || slot.m_Header.m_FrameNumber < oldestSlot->m_Header.m_FrameNumber))
+			{
+				oldestSlot = &slot;
+			}
+		}
+
+		if (oldestSlot == nullptr || vkGetEventStatus(m_Device, oldestSlot->m_Event) != VK_EVENT_SET)
+		{
+			return false;
+		}
+
+		readback = oldestSlot->m_Header;
+		readback.m_Pixels.resize(GetReadbackSize());
+
+		memcpy(readback.m_Pixels.data(), oldestSlot->m_MappedData, readback.m_Pixels.size());
+
+		// The GPU is done with the event, so the host may reset it
+		vkResetEvent(m_Device, oldestSlot->m_Event);
+		oldestSlot->m_bPending = false;
+
+		CompleteReadback(readback, oldestSlot->m_IssueTime);
+		return true;
+	}
+}
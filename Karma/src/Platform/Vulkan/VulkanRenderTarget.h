@@ -0,0 +1,157 @@
+/**
+ * @file VulkanRenderTarget.h
+ * @brief This file contains VulkanRenderTarget class, offscreen attachments with staging buffer readback.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/RenderTarget.h"
+#include "vulkan/vulkan.h"
+
+#include <mutex>
+
+namespace Karma
+{
+	/**
+	 * @brief Vulkan implementation of RenderTarget: color and depth images, a framebuffer and a render pass compatible with
+	 * VulkanContext::GetRenderPass (same formats), so the pipelines of the vertex arrays draw into it unchanged. The color attachment ends
+	 * the pass in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL.
+	 *
+	 * A copy is a vkCmdCopyImageToBuffer, recorded after the render pass, into one of s_ReadbackSlots host visible (persistently mapped)
+	 * staging buffers, followed by a VkEvent set on the GPU. PollReadback checks the event with vkGetEventStatus, never waiting on a fence.
+	 *
+	 * @note The pipelines are built against the swapchain's formats, so the target takes the swapchain's color format (and
+	 * VulkanContext::FindDepthFormat for depth) whatever the specification asks for. The extent is as asked, viewport and scissor being
+	 * dynamic state. GetSpecification tells what was created.
+	 * @see VulkanRendererAPI::SubmitOffscreen
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanRenderTarget : public RenderTarget
+	{
+	public:
+		/**
+		 * @brief Creates the images, render pass, framebuffer and the readback slots
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanRenderTarget(const RenderTargetSpecification& specification);
+
+		/**
+		 * @brief Waits for the device to be idle and destroys the Vulkan objects
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~VulkanRenderTarget();
+
+		/**
+		 * @brief Hands out the oldest copy whose event is set. May be called from any thread.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool PollReadback(RenderTargetReadback& readback) override;
+
+		/**
+		 * @brief Ends the frame of the target, recording the copy (and the event) if one was requested. To be recorded after the render
+		 * pass has ended.
+		 *
+		 * @param commandBuffer					The primary command buffer of the frame
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RecordReadback(VkCommandBuffer commandBuffer);
+
+		/**
+		 * @brief The render pass to begin with GetFramebuffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkRenderPass GetRenderPass() const { return m_RenderPass; }
+
+		/**
+		 * @brief Framebuffer of the color and depth attachments
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkFramebuffer GetFramebuffer() const { return m_Framebuffer; }
+
+		/**
+		 * @brief Size of the attachments
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkExtent2D GetExtent() const { return { m_Specification.m_Width, m_Specification.m_Height }; }
+
+		/**
+		 * @brief The RenderTargetFormat laid out as the given (color) format
+		 *
+		 * @return false if there is no such RenderTargetFormat
+		 * @since Karma 1.0.0
+		 */
+		static bool ToRenderTargetFormat(VkFormat format, RenderTargetFormat& renderTargetFormat);
+
+	private:
+		/**
+		 * @brief Creates an image in device local memory, and its view
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CreateAttachment(VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect, VkImage& image, VkDeviceMemory& memory,
+			VkImageView& imageView);
+
+		/**
+		 * @brief Creates the render pass, like VulkanContext::CreateRenderPass but for the final layout of the color attachment
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CreateRenderPass();
+
+		/**
+		 * @brief Creates the staging buffers (mapped) and events
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void CreateReadbackSlots();
+
+	private:
+		/**
+		 * @brief A staging buffer and the copy it holds
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct ReadbackSlot
+		{
+			VkBuffer m_Buffer = VK_NULL_HANDLE;
+			VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+			void* m_MappedData = nullptr;
+			VkEvent m_Event = VK_NULL_HANDLE;
+			bool m_bPending = false;
+			RenderTargetReadback m_Header;
+			std::chrono::steady_clock::time_point m_IssueTime;
+		};
+
+	private:
+		VkDevice m_Device;
+
+		VkFormat m_ColorFormat;
+		VkFormat m_DepthFormat;
+
+		VkImage m_ColorImage;
+		VkDeviceMemory m_ColorImageMemory;
+		VkImageView m_ColorImageView;
+
+		VkImage m_DepthImage;
+		VkDeviceMemory m_DepthImageMemory;
+		VkImageView m_DepthImageView;
+
+		VkRenderPass m_RenderPass;
+		VkFramebuffer m_Framebuffer;
+
+		// Recorded on the render thread, polled from the main thread
+		std::mutex m_ReadbackMutex;
+		ReadbackSlot m_ReadbackSlots[s_ReadbackSlots];
+	};
+}
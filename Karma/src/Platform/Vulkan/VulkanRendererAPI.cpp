@@ -2,10 +2,17 @@
 #include "vulkan/vulkan.h"
 #include "Platform/Vulkan/VulkanHolder.h"
 #include "Platform/Vulkan/VulkanVertexArray.h"
+#include "Platform/Vulkan/VulkanUploadManager.h"
+#include "Platform/Vulkan/VulkanDescriptorCache.h"
+#include "Platform/Vulkan/VulkanParallelRecorder.h"
+#include "Platform/Vulkan/VulkanGPUProfiler.h"
+#include "Platform/Vulkan/VulkanRenderTarget.h"
+#include "Platform/Vulkan/VulkanUniformBufferRing.h"
+#include "Platform/Vulkan/VulkanTexutre.h"
 
 namespace Karma
 {
-	VulkanRendererAPI::VulkanRendererAPI() : m_bAllocateCommandBuffers(true)
+	VulkanRendererAPI::VulkanRendererAPI() : m_ParallelRecorder(nullptr), m_GPUProfiler(nullptr), m_bAllocateCommandBuffers(true)
 	{
 	}
 
@@ -17,10 +24,23 @@ namespace Karma
 	{
 		vkDeviceWaitIdle(VulkanHolder::GetVulkanContext()->GetLogicalDevice());
 
+		if (m_ParallelRecorder)
+		{
+			delete m_ParallelRecorder;
+			m_ParallelRecorder = nullptr;
+		}
+
+		if (m_GPUProfiler)
+		{
+			delete m_GPUProfiler;
+			m_GPUProfiler = nullptr;
+		}
+
 		RemoveSynchronicity();
 		if (m_commandBuffers.size() > 0)
 		{
 			vkFreeCommandBuffers(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), VulkanHolder::GetVulkanContext()->GetCommandPool(), static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
+			m_commandBuffers.clear();
 		}
 	}
 
@@ -45,6 +65,12 @@ namespace Karma
 	// Command buffers are used for stacking rendering commands (in bulk) to be processed in batches
 	void VulkanRendererAPI::AllocateCommandBuffers()
 	{
+		// Swapchain recreation keeps the command buffers
+		if (m_commandBuffers.size() > 0)
+		{
+			return;
+		}
+
 		// Since we be needing stack of commands per frame basis
 		m_commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
@@ -59,7 +85,8 @@ namespace Karma
 		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create command buffers!");
 	}
 
-	void VulkanRendererAPI::RecordCommandBuffers(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+	void VulkanRendererAPI::RecordCommandBuffers(VkCommandBuffer commandBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent,
+		VulkanRenderTarget* renderTarget)
 	{
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -72,10 +99,10 @@ namespace Karma
 
 		VkRenderPassBeginInfo renderPassInfo{};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = VulkanHolder::GetVulkanContext()->GetRenderPass();
-		renderPassInfo.framebuffer = VulkanHolder::GetVulkanContext()->GetSwapChainFrameBuffer()[imageIndex];
+		renderPassInfo.renderPass = renderPass;
+		renderPassInfo.framebuffer = framebuffer;
 		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = VulkanHolder::GetVulkanContext()->GetSwapChainExtent();
+		renderPassInfo.renderArea.extent = extent;
 
 		std::array<VkClearValue, 2> clearValues{};
 		clearValues[0] = { m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a };
@@ -83,27 +110,28 @@ namespace Karma
 		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 		renderPassInfo.pClearValues = clearValues.data();
 
-		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		// Query resets aren't allowed within a render pass
+		m_GPUProfiler->BeginFrame(commandBuffer, uint32_t(m_CurrentFrame));
+		m_ParallelRecorder->ResetQueries(commandBuffer, uint32_t(m_CurrentFrame));
 
-		for (auto vulkanVA : m_VulkaVertexArrays)
-		{
-			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanVA->GetGraphicsPipeline());
+		// Timing only, the secondaries count the invocations of each pass themselves
+		m_GPUProfiler->BeginScope(commandBuffer, "Scene");
+
+		// Draws are recorded into secondaries, in parallel, and executed in order
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
-			// Bind vertex/index buffers
-			VkBuffer vertexBuffers[] = { vulkanVA->GetVertexBuffer()->GetVertexBuffer() };
-			VkDeviceSize offsets[] = { 0 };
+		m_ParallelRecorder->Record(commandBuffer, uint32_t(m_CurrentFrame), renderPassInfo.renderPass, renderPassInfo.framebuffer, extent, m_DrawCommands);
 
-			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-			vkCmdBindIndexBuffer(commandBuffer, vulkanVA->GetIndexBuffer()->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+		vkCmdEndRenderPass(commandBuffer);
 
-			// DescriptorSets number needs be depending upon MAX_FRAMES_IN_FLIGHT or swapchainimages size
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanVA->GetGraphicsPipelineLayout(), 0, 1, &vulkanVA->GetDescriptorSets()[m_CurrentFrame], 0, nullptr);
+		m_GPUProfiler->EndScope(commandBuffer);
 
-			vkCmdDrawIndexed(commandBuffer, vulkanVA->GetIndexBuffer()->GetCount(), 1, 0, 0, 0);
+		// The color attachment is in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL now
+		if (renderTarget)
+		{
+			renderTarget->RecordReadback(commandBuffer);
 		}
 
-		vkCmdEndRenderPass(commandBuffer);
-
 		VkResult resultCB = vkEndCommandBuffer(commandBuffer);
 
 		KR_CORE_ASSERT(resultCB == VK_SUCCESS, "Failed to record command buffer");
@@ -111,12 +139,19 @@ namespace Karma
 
 	void VulkanRendererAPI::EndScene()
 	{
-		vkDeviceWaitIdle(VulkanHolder::GetVulkanContext()->GetLogicalDevice());
-		for (size_t i = 0; i < m_commandBuffers.size(); i++)
+		// All the draws of the scene go in one submission. A render target is cleared (and counts the frame) even without draws.
+		if (m_RenderTarget)
+		{
+			SubmitOffscreen(static_cast<VulkanRenderTarget*>(m_RenderTarget));
+		}
+		else if (m_DrawCommands.size())
 		{
-			vkResetCommandBuffer(m_commandBuffers[i], VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+			SubmitCommandBuffers();
 		}
-		m_VulkaVertexArrays.clear();
+
+		// No idling of the device: the next use of a frame's command buffer, descriptor sets and ring region comes after the wait on
+		// its in flight fence, and vkBeginCommandBuffer resets the command buffer (the pool allows it)
+		m_DrawCommands.clear();
 	}
 
 	void VulkanRendererAPI::CreateSynchronicity()
@@ -145,6 +180,12 @@ namespace Karma
 			VkResult resultf = vkCreateFence(device, &fenceInfo, nullptr, &m_InFlightFences[i]);
 			KR_CORE_ASSERT(resultf == VK_SUCCESS, "Failed to create inFlightFence");
 		}
+
+		VulkanContext* vulkanContext = VulkanHolder::GetVulkanContext();
+		uint32_t graphicsFamily = vulkanContext->FindQueueFamilies(vulkanContext->GetPhysicalDevice()).graphicsFamily.value();
+
+		m_ParallelRecorder = new VulkanParallelRecorder(graphicsFamily, MAX_FRAMES_IN_FLIGHT);
+		m_GPUProfiler = new VulkanGPUProfiler(MAX_FRAMES_IN_FLIGHT);
 	}
 
 	void VulkanRendererAPI::RemoveSynchronicity()
@@ -163,33 +204,57 @@ namespace Karma
 	{
 		vkWaitForFences(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
 
+		// GPU is done with this frame's short lived descriptor sets, and its queries have their results
+		VulkanHolder::GetVulkanContext()->GetDescriptorCache()->ResetFrame(m_CurrentFrame);
+		m_ParallelRecorder->CollectQueryResults(uint32_t(m_CurrentFrame));
+
 		uint32_t imageIndex;
 		VkResult resultAI = vkAcquireNextImageKHR(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), VulkanHolder::GetVulkanContext()->GetSwapChain(), UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
 
 		if (resultAI == VK_ERROR_OUT_OF_DATE_KHR)
 		{
+			// No image to draw into, the frame is skipped. The fence is left signaled for the next one.
 			RecreateCommandBuffersPipelineSwapchain();
+			return;
 		}
 		else if (resultAI != VK_SUCCESS && resultAI != VK_SUBOPTIMAL_KHR)
 		{
 			KR_CORE_ASSERT(false, "Failed to acquire swapchain image");
 		}
 
-		VulkanHolder::GetVulkanContext()->UploadUBO(m_CurrentFrame);
+		// Uniforms are already in the (persistently mapped) uniform ring, courtesy Material::ProcessForSubmission
+
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
 
-		vkResetFences(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), 1, &m_InFlightFences[m_CurrentFrame]);
+		// Submit the batched mesh/texture uploads of this frame. The draws wait for them on the GPU, through the upload timeline semaphore.
+		VkSemaphore uploadSemaphore = VK_NULL_HANDLE;
+		uint64_t uploadValue = 0;
+		const bool bWaitForUploads = context->GetUploadManager()->GetGraphicsWait(uploadSemaphore, uploadValue);
+
+		vkResetFences(context->GetLogicalDevice(), 1, &m_InFlightFences[m_CurrentFrame]);
 		vkResetCommandBuffer(m_commandBuffers[m_CurrentFrame], VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
 
-		RecordCommandBuffers(m_commandBuffers[m_CurrentFrame], imageIndex);
+		RecordCommandBuffers(m_commandBuffers[m_CurrentFrame], context->GetRenderPass(), context->GetSwapChainFrameBuffer()[imageIndex],
+			context->GetSwapChainExtent());
 
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-		VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame] };
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
+		VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame], uploadSemaphore };
+		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VulkanUploadManager::s_GraphicsWaitStages };
+		submitInfo.waitSemaphoreCount = bWaitForUploads ? 2 : 1;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 		submitInfo.pWaitDstStageMask = waitStages;
+
+		// The value of the binary (swapchain) semaphore is ignored
+		uint64_t waitValues[] = { 0, uploadValue };
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+		timelineInfo.pWaitSemaphoreValues = waitValues;
+
+		submitInfo.pNext = bWaitForUploads ? &timelineInfo : nullptr;
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &m_commandBuffers[m_CurrentFrame];
 
@@ -197,7 +262,7 @@ namespace Karma
 		submitInfo.signalSemaphoreCount = 1;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
-		VkResult result = vkQueueSubmit(VulkanHolder::GetVulkanContext()->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]);
+		VkResult result = vkQueueSubmit(context->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]);
 		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to submit draw command buffer");
 
 		VkPresentInfoKHR presentInfo{};
@@ -225,45 +290,165 @@ namespace Karma
 		m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	}
 
-	void VulkanRendererAPI::RecreateCommandBuffersAndSwapChain()
+	void VulkanRendererAPI::SubmitOffscreen(VulkanRenderTarget* renderTarget)
 	{
-		vkDeviceWaitIdle(VulkanHolder::GetVulkanContext()->GetLogicalDevice());
-		vkFreeCommandBuffers(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), VulkanHolder::GetVulkanContext()->GetCommandPool(), static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		vkWaitForFences(context->GetLogicalDevice(), 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+
+		context->GetDescriptorCache()->ResetFrame(m_CurrentFrame);
+		m_ParallelRecorder->CollectQueryResults(uint32_t(m_CurrentFrame));
+
+		VkSemaphore uploadSemaphore = VK_NULL_HANDLE;
+		uint64_t uploadValue = 0;
+		const bool bWaitForUploads = context->GetUploadManager()->GetGraphicsWait(uploadSemaphore, uploadValue);
+
+		vkResetFences(context->GetLogicalDevice(), 1, &m_InFlightFences[m_CurrentFrame]);
+		vkResetCommandBuffer(m_commandBuffers[m_CurrentFrame], VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+
+		RecordCommandBuffers(m_commandBuffers[m_CurrentFrame], renderTarget->GetRenderPass(), renderTarget->GetFramebuffer(), renderTarget->GetExtent(),
+			renderTarget);
+
+		// No swapchain image to wait for or to present, the fence alone tells when the frame (and its copy) is done
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &m_commandBuffers[m_CurrentFrame];
+
+		const VkPipelineStageFlags waitStage = VulkanUploadManager::s_GraphicsWaitStages;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = 1;
+		timelineInfo.pWaitSemaphoreValues = &uploadValue;
+
+		if (bWaitForUploads)
+		{
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &uploadSemaphore;
+			submitInfo.pWaitDstStageMask = &waitStage;
+		}
+
+		VkResult result = vkQueueSubmit(context->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to submit offscreen command buffer");
+
+		m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	}
 
-		VulkanHolder::GetVulkanContext()->RecreateSwapChain();
-		AllocateCommandBuffers();
-		m_bAllocateCommandBuffers = false;
+	void VulkanRendererAPI::RecreateCommandBuffersAndSwapChain()
+	{
+		// Neither the command buffers nor the pipelines depend upon the swapchain (viewport and scissor are dynamic), and the old
+		// swapchain is retired by the context, so nothing is waited for
+		if (VulkanHolder::GetVulkanContext()->RecreateSwapChain())
+		{
+			RecreateQueuedPipelines();
+		}
 	}
 
 	void VulkanRendererAPI::RecreateCommandBuffersPipelineSwapchain()
 	{
+		RecreateCommandBuffersAndSwapChain();
+	}
+
+	void VulkanRendererAPI::RecreateQueuedPipelines()
+	{
+		// The render pass was rebuilt for another format, the pipelines have to follow. The device is waited upon since the frames in
+		// flight may be using them.
 		vkDeviceWaitIdle(VulkanHolder::GetVulkanContext()->GetLogicalDevice());
 
-		vkFreeCommandBuffers(VulkanHolder::GetVulkanContext()->GetLogicalDevice(), VulkanHolder::GetVulkanContext()->GetCommandPool(), static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
-		m_bAllocateCommandBuffers = true;
+		// A vertex array may be drawn several times, its pipeline is recreated once
+		std::unordered_set<VulkanVertexArray*> vertexArrays;
+		for (const auto& drawCommand : m_DrawCommands)
+		{
+			vertexArrays.insert(drawCommand.m_VertexArray.get());
+		}
 
-		for (auto vulkanVA : m_VulkaVertexArrays)
+		for (auto vulkanVA : vertexArrays)
 		{
 			vulkanVA->CleanupPipeline();
+			vulkanVA->RecreateVulkanVA();
 		}
+	}
+
+	void VulkanRendererAPI::DrawIndexed(std::shared_ptr<VertexArray> vertexArray)
+	{
+		std::shared_ptr<VulkanVertexArray> vulkanVA = std::static_pointer_cast<VulkanVertexArray>(vertexArray);
+
+		DrawIndexedRecorded(vertexArray, vulkanVA->GetShader()->GetUniformBufferObject()->GetRingOffset());
+	}
 
-		VulkanHolder::GetVulkanContext()->ClearUBO();
-		VulkanHolder::GetVulkanContext()->RecreateSwapChain();
-		VulkanHolder::GetVulkanContext()->RecreateUBO();
+	void VulkanRendererAPI::DrawIndexedRecorded(std::shared_ptr<VertexArray> vertexArray, uint32_t uniformRingOffset)
+	{
+		std::shared_ptr<VulkanVertexArray> vulkanVA = std::static_pointer_cast<VulkanVertexArray>(vertexArray);
 
-		for (auto vulkanVA : m_VulkaVertexArrays)
+		// Without a depth only pipeline (no variant, or transparent) the draw has no part in the pre-pass
+		if (m_CurrentPass == RenderPassType::DepthPrePass && vulkanVA->GetDepthOnlyPipeline() == VK_NULL_HANDLE)
 		{
-			vulkanVA->RecreateVulkanVA();
+			return;
 		}
 
-		AllocateCommandBuffers();
+		VulkanDrawCommand drawCommand;
+		drawCommand.m_VertexArray = vulkanVA;
+		drawCommand.m_DynamicOffset = uniformRingOffset;
+		drawCommand.m_Pass = m_CurrentPass;
+
+		m_DrawCommands.push_back(drawCommand);
 	}
 
-	void VulkanRendererAPI::DrawIndexed(std::shared_ptr<VertexArray> vertexArray)
+	void VulkanRendererAPI::DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount)
 	{
 		std::shared_ptr<VulkanVertexArray> vulkanVA = std::static_pointer_cast<VulkanVertexArray>(vertexArray);
-		m_VulkaVertexArrays.push_back(vulkanVA);
-		
-		SubmitCommandBuffers();
+
+		DrawIndexedInstancedRecorded(vertexArray, worldMatrices, instanceCount, vulkanVA->GetShader()->GetUniformBufferObject()->GetRingOffset());
+	}
+
+	void VulkanRendererAPI::DrawIndexedInstancedRecorded(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount,
+		uint32_t uniformRingOffset)
+	{
+		std::shared_ptr<VulkanVertexArray> vulkanVA = std::static_pointer_cast<VulkanVertexArray>(vertexArray);
+
+		if (!vulkanVA->GetShader()->SupportsInstancing())
+		{
+			RendererAPI::DrawIndexedInstanced(vertexArray, worldMatrices, instanceCount);
+			return;
+		}
+
+		if (m_CurrentPass == RenderPassType::DepthPrePass && vulkanVA->GetDepthOnlyPipeline() == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		VulkanUniformBufferRing* instanceRing = VulkanHolder::GetVulkanContext()->GetInstanceRing();
+
+		VulkanDrawCommand drawCommand;
+		drawCommand.m_VertexArray = vulkanVA;
+		drawCommand.m_DynamicOffset = uniformRingOffset;
+		drawCommand.m_InstanceCount = instanceCount;
+		drawCommand.m_InstanceBuffer = instanceRing->GetBuffer();
+		drawCommand.m_InstanceOffset = instanceRing->PushData(worldMatrices, instanceCount * uint32_t(sizeof(glm::mat4)));
+		drawCommand.m_Pass = m_CurrentPass;
+
+		// The matrices didn't fit in the frame's region of the instance ring
+		if (drawCommand.m_InstanceOffset == UniformBufferRing::s_InvalidOffset)
+		{
+			return;
+		}
+
+		m_DrawCommands.push_back(drawCommand);
+	}
+
+	bool VulkanRendererAPI::GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const
+	{
+		return m_ParallelRecorder && m_ParallelRecorder->GetFragmentInvocations(pass, invocations);
+	}
+
+	bool VulkanRendererAPI::SupportsTextureFormat(TextureFormat format) const
+	{
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(VulkanHolder::GetVulkanContext()->GetPhysicalDevice(), VulkanTexture::GetVulkanFormat(format),
+			&properties);
+
+		return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
 	}
 }
@@ -8,6 +8,10 @@
 namespace Karma
 {
 	class VulkanVertexArray;
+	class VulkanParallelRecorder;
+	class VulkanGPUProfiler;
+	class VulkanRenderTarget;
+	struct VulkanDrawCommand;
 	class KARMA_API VulkanRendererAPI : public RendererAPI
 	{
 	public:
@@ -17,7 +21,69 @@ namespace Karma
 		virtual void Clear() override;
 
 		virtual void BeginScene() override;
+		/**
+		 * @brief Queues the draw (with the present uniform ring offset of the vertex array). The queued draws are recorded and submitted,
+		 * as one frame, by EndScene.
+		 */
 		virtual void DrawIndexed(std::shared_ptr<VertexArray> vertexArray) override;
+
+		/**
+		 * @brief Queues one draw of instanceCount instances, the world matrices written in the context's instance ring and bound at
+		 * VulkanVertexArray::s_InstanceBinding. Shaders without the per instance matrix get a draw per instance.
+		 */
+		virtual void DrawIndexedInstanced(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount) override;
+
+		/**
+		 * @brief Queues the draw with the given uniform ring offset, taken when the draw was recorded for the render thread
+		 */
+		virtual void DrawIndexedRecorded(std::shared_ptr<VertexArray> vertexArray, uint32_t uniformRingOffset) override;
+
+		/**
+		 * @brief Queues the instanced draw with the given uniform ring offset, taken when the draw was recorded for the render thread
+		 */
+		virtual void DrawIndexedInstancedRecorded(std::shared_ptr<VertexArray> vertexArray, const glm::mat4* worldMatrices, uint32_t instanceCount,
+			uint32_t uniformRingOffset) override;
+
+		/**
+		 * @brief Tags the draws queued till EndPass with the pass. All the passes share the one render pass (and depth attachment), the
+		 * state of each lives in the pipelines (see VulkanVertexArray::GetDepthOnlyPipeline).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void BeginPass(RenderPassType pass) override { m_CurrentPass = pass; }
+
+		/**
+		 * @brief Back to the default (opaque) tagging
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void EndPass() override { m_CurrentPass = RenderPassType::Opaque; }
+
+		/**
+		 * @brief Vertex arrays whose shader has a depth only variant draw in the pre-pass, the others skip it
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsDepthPrePass() const override { return true; }
+
+		/**
+		 * @brief Whether the physical device can sample optimally tiled images of the format
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool SupportsTextureFormat(TextureFormat format) const override;
+
+		/**
+		 * @brief Fragment invocations counted by VulkanParallelRecorder's pipeline statistics queries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual bool GetFragmentInvocations(RenderPassType pass, uint64_t& invocations) const override;
+
+		/**
+		 * @brief Submits the queued draws (SubmitCommandBuffers), if any, or into the render target if one is set (SubmitOffscreen), and
+		 * clears the queue
+		 */
 		virtual void EndScene() override;
 
 		/**
@@ -26,31 +92,78 @@ namespace Karma
 		 * For instance the graphics and presentation queues.
 		 */
 		void AllocateCommandBuffers();
-		void RecordCommandBuffers(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+
+		/**
+		 * @brief Records the frame: the queued draws (in parallel secondaries) within the render pass, the GPU profiler's scopes and, for a
+		 * render target, its readback
+		 *
+		 * @param commandBuffer					Primary command buffer of the frame in flight
+		 * @param renderPass					VulkanContext::GetRenderPass, or the render target's (compatible) one
+		 * @param framebuffer					Swapchain framebuffer of the acquired image, or the render target's
+		 * @param extent						Render area
+		 * @param renderTarget					The target whose readback is recorded, nullptr for the swapchain
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RecordCommandBuffers(VkCommandBuffer commandBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent,
+			VulkanRenderTarget* renderTarget = nullptr);
 		void SubmitCommandBuffers();
+
+		/**
+		 * @brief Submits the queued draws into the render target: no image is acquired or presented, the frame's fence is all the
+		 * synchronization
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void SubmitOffscreen(VulkanRenderTarget* renderTarget);
 		void CreateSynchronicity();
 		void ClearVulkanRendererAPI();
 		void RemoveSynchronicity();
 		void RecreateCommandBuffersPipelineSwapchain();
+
+		/**
+		 * @brief Recreates the swapchain (VulkanContext::RecreateSwapChain) without waiting for the device. The command buffers and the
+		 * pipelines are kept, unless the surface format changed (see RecreateQueuedPipelines).
+		 *
+		 * @since Karma 1.0.0
+		 */
 		void RecreateCommandBuffersAndSwapChain();
 
+		/**
+		 * @brief Rebuilds the pipelines of the queued draws against the present render pass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RecreateQueuedPipelines();
+
 		// Getters. Depending on detailed implementation of other API (such as OpenGL), we may promote the getter to abstract
 		const std::vector<VkCommandBuffer>& GetCommandBuffers() const { return m_commandBuffers; }
 		const int& GetMaxFramesInFlight() const { return MAX_FRAMES_IN_FLIGHT; }
 		const std::vector<VkFence>& GetFences() const { return m_InFlightFences; }
 		const std::vector<VkSemaphore>& GetImageAvailableSemaphores() const { return m_ImageAvailableSemaphores; }
 		const std::vector<VkSemaphore> GetRenderFinishedSemaphore() const { return m_RenderFinishedSemaphores; }
+		VulkanParallelRecorder* GetParallelRecorder() const { return m_ParallelRecorder; }
+		VulkanGPUProfiler* GetGPUProfiler() const { return m_GPUProfiler; }
 
 	private:
 		size_t m_CurrentFrame = 0;
 
 		std::vector<VkCommandBuffer> m_commandBuffers;
-		std::vector<std::shared_ptr<VulkanVertexArray>> m_VulkaVertexArrays;
+		std::vector<VulkanDrawCommand> m_DrawCommands;
+
+		// The pass the queued draws go to
+		RenderPassType m_CurrentPass = RenderPassType::Opaque;
 
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores;
 		std::vector<VkSemaphore> m_RenderFinishedSemaphores;
 		std::vector<VkFence> m_InFlightFences;
 
+		// Records the draws on worker threads, see RecordCommandBuffers
+		VulkanParallelRecorder* m_ParallelRecorder;
+
+		// Times the scene's render pass (the passes within are timed by the recorder)
+		VulkanGPUProfiler* m_GPUProfiler;
+
 		// Number of images (to work upon (CPU side) whilst an image is being rendered (GPU side processing)) + 1
 		// Clearly, MAX_FRAMES_IN_FLIGHT shouldn't exceed m_SwapChainImages.size()
 		const int MAX_FRAMES_IN_FLIGHT = 2;
@@ -2,6 +2,9 @@
 #include "SPIRV/GlslangToSpv.h"
 #include "StandAlone/DirStackFileIncluder.h"
 #include "Platform/Vulkan/VulkanBuffer.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+#include "Karma/Renderer/CookedMesh.h"
 
 namespace Karma
 {
@@ -10,6 +13,12 @@ namespace Karma
 		std::string vString = KarmaUtilities::ReadFileToSpitString(vertexSrc);
 		vertSpirV = Compile(vertexSrc, vString, EShLangVertex);// vertex shader
 
+		// Position only variant for the depth pre-pass, if the source provides one
+		if (vString.find(s_DepthOnlyDefine) != std::string::npos)
+		{
+			m_DepthOnlyVertSpirV = Compile(vertexSrc, vString, EShLangVertex, true);
+		}
+
 		vString = KarmaUtilities::ReadFileToSpitString(fragmentSrc);
 		fragSpirV = Compile(fragmentSrc, vString, EShLangFragment);// fragment shader
 
@@ -21,10 +30,34 @@ namespace Karma
 
 	}
 
-	std::vector<uint32_t> VulkanShader::Compile(const std::string& src, const std::string& source, EShLanguage lang)
+	std::mutex VulkanShader::s_SpirVCacheMutex;
+	std::unordered_map<uint64_t, std::vector<uint32_t>> VulkanShader::s_SpirVCache;
+
+	std::vector<uint32_t> VulkanShader::Compile(const std::string& src, const std::string& source, EShLanguage lang, bool bDepthOnly)
 	{
-		KR_CORE_INFO("Compiling {0} {1} for Vulkan ...", lang == EShLangVertex ? "vertex shader" : "fragment shader", src);
+		std::vector<uint32_t> SpirV;
+		std::string PreprocessedGLSL;
 
+		const bool bCompiled = CompileCached(src, source, lang, bDepthOnly, SpirV, PreprocessedGLSL);
+		KR_CORE_ASSERT(bCompiled, "Shader compilation faliure!");
+
+		// Comments and inactive branches are gone by now. The depth only variant must not change what the shader is found to be.
+		if (lang == EShLangVertex && !bDepthOnly)
+		{
+			m_bSupportsInstancing = DeclaresInstanceTransform(PreprocessedGLSL);
+		}
+
+		if (!bDepthOnly && PreprocessedGLSL.find(VulkanBindlessTable::s_TextureArrayName) != std::string::npos)
+		{
+			m_bUsesBindless = true;
+		}
+
+		return SpirV;
+	}
+
+	bool VulkanShader::CompileCached(const std::string& src, const std::string& source, EShLanguage lang, bool bDepthOnly,
+		std::vector<uint32_t>& spirV, std::string& preprocessedGLSL)
+	{
 		const char* sString = source.c_str();
 
 		glslang::TShader Shader(lang);
@@ -38,6 +71,24 @@ namespace Karma
 		Shader.setEnvClient(glslang::EShClientVulkan, VulkanClientVersion);
 		Shader.setEnvTarget(glslang::EShTargetSpv, TargetVersion);
 
+		// Shaders may pick the bindless path (see Resources/Shaders/shader.frag), the device supports it
+		std::string preamble;
+		if (VulkanHolder::GetVulkanContext()->SupportsBindless())
+		{
+			preamble += "#define KARMA_BINDLESS 1\n";
+		}
+
+		if (bDepthOnly)
+		{
+			preamble += "#define " + std::string(s_DepthOnlyDefine) + " 1\n";
+		}
+
+		// glslang keeps the pointer, the string lives till the end of the compilation
+		if (!preamble.empty())
+		{
+			Shader.setPreamble(preamble.c_str());
+		}
+
 		TBuiltInResource Resources{};
 		Resources.maxDrawBuffers = true;
 
@@ -50,24 +101,43 @@ namespace Karma
 		std::string Path = KarmaUtilities::GetFilePath(src);
 		Includer.pushExternalLocalDirectory(Path);
 
-		std::string PreprocessedGLSL;
-		if (!Shader.preprocess(&Resources, DefaultVersion, ENoProfile, false, false, messages, &PreprocessedGLSL, Includer))
+		if (!Shader.preprocess(&Resources, DefaultVersion, ENoProfile, false, false, messages, &preprocessedGLSL, Includer))
 		{
+			KR_CORE_ERROR("Preprocessing of {0} failed", src);
 			KR_CORE_ERROR("{0}", Shader.getInfoLog());
 			KR_CORE_ERROR("{0}", Shader.getInfoDebugLog());
 
-			KR_CORE_ASSERT(false, "Shader preprocessing failed!");
+			return false;
 		}
 
-		const char* PreprocessedCStr = PreprocessedGLSL.c_str();
+		// The includes and defines are in the preprocessed source, so alike sources compile once whichever file they came from
+		const uint32_t stage = uint32_t(lang);
+		const uint64_t key = CookedMesh::HashBytes(preprocessedGLSL.data(), preprocessedGLSL.size(), CookedMesh::HashBytes(&stage, sizeof(stage)));
+
+		{
+			std::lock_guard<std::mutex> lock(s_SpirVCacheMutex);
+
+			std::unordered_map<uint64_t, std::vector<uint32_t>>::const_iterator cached = s_SpirVCache.find(key);
+
+			if (cached != s_SpirVCache.end())
+			{
+				spirV = cached->second;
+				return true;
+			}
+		}
+
+		KR_CORE_INFO("Compiling {0} {1} for Vulkan{2} ...", lang == EShLangVertex ? "vertex shader" : "fragment shader", src, bDepthOnly ? " (depth only)" : "");
+
+		const char* PreprocessedCStr = preprocessedGLSL.c_str();
 		Shader.setStrings(&PreprocessedCStr, 1);
 
 		if (!Shader.parse(&Resources, 100, false, messages))
 		{
+			KR_CORE_ERROR("GLSL parsing of {0} failed", src);
 			KR_CORE_ERROR("{0}", Shader.getInfoLog());
 			KR_CORE_ERROR("{0}", Shader.getInfoDebugLog());
 
-			KR_CORE_ASSERT(false, "GLSL parsing failed!");
+			return false;
 		}
 
 		glslang::TProgram Program;
@@ -75,18 +145,59 @@ namespace Karma
 
 		if (!Program.link(messages))
 		{
+			KR_CORE_ERROR("Shader link faliure of {0}", src);
 			KR_CORE_ERROR("{0}", Shader.getInfoLog());
 			KR_CORE_ERROR("{0}", Shader.getInfoDebugLog());
-			
-			KR_CORE_ASSERT(false, "Shader link faliure!");
+
+			return false;
 		}
 
-		std::vector<uint32_t> SpirV;
 		spv::SpvBuildLogger Logger;
 		glslang::SpvOptions SpvOptions;
-		glslang::GlslangToSpv(*Program.getIntermediate(lang), SpirV, &Logger, &SpvOptions);
+		glslang::GlslangToSpv(*Program.getIntermediate(lang), spirV, &Logger, &SpvOptions);
 
-		return SpirV;
+		std::lock_guard<std::mutex> lock(s_SpirVCacheMutex);
+		s_SpirVCache[key] = spirV;
+
+		return true;
+	}
+
+	bool VulkanShader::Prepare(const std::string& vertexSrcFile, const std::string& fragmentSrcFile)
+	{
+		if (!std::filesystem::exists(vertexSrcFile) || !std::filesystem::exists(fragmentSrcFile))
+		{
+			return false;
+		}
+
+		std::vector<uint32_t> spirV;
+		std::string preprocessedGLSL;
+
+		// The same stages the constructor compiles
+		std::string vString = KarmaUtilities::ReadFileToSpitString(vertexSrcFile);
+
+		if (!CompileCached(vertexSrcFile, vString, EShLangVertex, false, spirV, preprocessedGLSL))
+		{
+			return false;
+		}
+
+		if (vString.find(s_DepthOnlyDefine) != std::string::npos && !CompileCached(vertexSrcFile, vString, EShLangVertex, true, spirV, preprocessedGLSL))
+		{
+			return false;
+		}
+
+		return CompileCached(fragmentSrcFile, KarmaUtilities::ReadFileToSpitString(fragmentSrcFile), EShLangFragment, false, spirV, preprocessedGLSL);
+	}
+
+	void VulkanShader::SwapContents(Shader& other)
+	{
+		Shader::SwapContents(other);
+
+		VulkanShader& otherShader = static_cast<VulkanShader&>(other);
+
+		std::swap(vertSpirV, otherShader.vertSpirV);
+		std::swap(fragSpirV, otherShader.fragSpirV);
+		std::swap(m_DepthOnlyVertSpirV, otherShader.m_DepthOnlyVertSpirV);
+		std::swap(m_bUsesBindless, otherShader.m_bUsesBindless);
 	}
 
 	void VulkanShader::Bind() const
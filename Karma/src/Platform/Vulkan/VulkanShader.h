@@ -6,6 +6,8 @@
 #include "glslang/Public/ShaderLang.h"
 #include "Karma/KarmaUtilities.h"
 
+#include <mutex>
+
 namespace Karma
 {
 	struct VulkanUniformBuffer;
@@ -24,19 +26,97 @@ namespace Karma
 		virtual void Bind() const override;
 		virtual void UnBind() const override;
 
-		std::vector<uint32_t> Compile(const std::string& src, const std::string& source, EShLanguage lang);
+		/**
+		 * @brief Compiles the GLSL source to SPIR-V
+		 *
+		 * @param src							Path of the source, for the includes and the logs
+		 * @param source						The GLSL
+		 * @param lang							The stage
+		 * @param bDepthOnly					Compile with s_DepthOnlyDefine defined, the position only variant of a vertex shader
+		 *
+		 * @since Karma 1.0.0
+		 */
+		std::vector<uint32_t> Compile(const std::string& src, const std::string& source, EShLanguage lang, bool bDepthOnly = false);
+
+		/**
+		 * @brief Compiles the GLSL source to SPIR-V, or takes the SPIR-V of an earlier compilation of the same preprocessed source and
+		 * stage. Thread safe, and logs rather than asserts if the source doesn't compile.
+		 *
+		 * @param spirV							Gets the SPIR-V
+		 * @param preprocessedGLSL				Gets the source preprocessed, for what the shader is found to be
+		 *
+		 * @return false if the source doesn't compile
+		 * @since Karma 1.0.0
+		 */
+		static bool CompileCached(const std::string& src, const std::string& source, EShLanguage lang, bool bDepthOnly, std::vector<uint32_t>& spirV,
+			std::string& preprocessedGLSL);
+
+		/**
+		 * @brief Compiles the stages of the shader files on the calling thread (a loading thread) into the SPIR-V cache, so that the
+		 * constructor only looks them up
+		 *
+		 * @return false if a file is missing or doesn't compile
+		 * @see Shader::Prepare
+		 * @since Karma 1.0.0
+		 */
+		static bool Prepare(const std::string& vertexSrcFile, const std::string& fragmentSrcFile);
+
+		/**
+		 * @brief Swaps the SPIR-V with the other (reloaded) shader's. The pipelines made of it are rebuilt by the vertex arrays.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void SwapContents(Shader& other) override;
 
 		void UploadUniformMat4(const std::string& name, const glm::mat4& matrix);
 
 		//Getters
 		const std::vector<uint32_t>& GetVertSpirV() const { return vertSpirV; }
 		const std::vector<uint32_t>& GetFragSpirV() const { return fragSpirV; }
+
+		/**
+		 * @brief SPIR-V of the depth only vertex shader (empty if the source has no such variant)
+		 *
+		 * @see HasDepthOnlyVariant
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<uint32_t>& GetDepthOnlyVertSpirV() const { return m_DepthOnlyVertSpirV; }
+
+		/**
+		 * @brief Whether the vertex shader source has a depth only variant (mentions s_DepthOnlyDefine), reading only the position
+		 * (location 0) and writing no varyings. VulkanVertexArray makes the depth pre-pass pipeline out of it.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool HasDepthOnlyVariant() const { return !m_DepthOnlyVertSpirV.empty(); }
 		std::shared_ptr<VulkanUniformBuffer> GetUniformBufferObject() const { return m_UniformBufferObject; }
 
+		/**
+		 * @brief Whether the shader fetches its textures through VulkanBindlessTable (declares the texture array, which it may do only when
+		 * compiled with KARMA_BINDLESS defined)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool UsesBindless() const { return m_bUsesBindless; }
+
+		/**
+		 * @brief Define of the depth only variant of the vertex shaders (see Resources/Shaders/shader.vert)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr const char* s_DepthOnlyDefine = "KARMA_DEPTH_ONLY";
+
 	private:
 		std::vector<uint32_t> vertSpirV;
 		std::vector<uint32_t> fragSpirV;
+		std::vector<uint32_t> m_DepthOnlyVertSpirV;
 		std::shared_ptr<VulkanUniformBuffer> m_UniformBufferObject;
+
+		bool m_bUsesBindless = false;
+
+		// SPIR-V by hash of the preprocessed source and stage
+		static std::mutex s_SpirVCacheMutex;
+		static std::unordered_map<uint64_t, std::vector<uint32_t>> s_SpirVCache;
 	};
 
 }
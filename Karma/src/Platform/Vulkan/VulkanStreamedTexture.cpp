@@ -0,0 +1,358 @@
+#include "VulkanStreamedTexture.h"
+#include "VulkanHolder.h"
+#include "VulkanRendererAPI.h"
+#include "VulkanUploadManager.h"
+#include "VulkanDescriptorCache.h"
+#include "VulkanBindlessTable.h"
+#include "VulkanTexutre.h"
+#include "Karma/Renderer/RenderCommand.h"
+#include "Karma/Renderer/RenderThread.h"
+
+namespace Karma
+{
+	namespace
+	{
+		struct RetiredImage
+		{
+			VulkanStreamedTexture::Image m_Image;
+			uint32_t m_Slot = VulkanBindlessTable::s_InvalidSlot;
+			uint64_t m_RetiredFrame = 0;
+		};
+
+		std::vector<VulkanStreamedTexture*> s_ChangedTextures;
+		std::vector<RetiredImage> s_RetiredImages;
+
+		VulkanStreamedTexture::Image s_Placeholder;
+		VkSampler s_Sampler = VK_NULL_HANDLE;
+	}
+
+	VulkanStreamedTexture::VulkanStreamedTexture(uint32_t width, uint32_t height, TextureFormat format) : StreamedTexture(width, height, format),
+		m_Slot(VulkanBindlessTable::s_InvalidSlot), m_bChanged(false)
+	{
+		KR_CORE_ASSERT(width > 0 && height > 0, "VulkanStreamedTexture: empty texture");
+		KR_CORE_ASSERT(VulkanHolder::GetVulkanContext()->SupportsBindless(), "Vulkan streams the textures through the bindless table only");
+
+		CreatePlaceholder();
+
+		m_Slot = VulkanHolder::GetVulkanContext()->GetBindlessTable()->AllocateTextureSlot(s_Placeholder.m_View, s_Sampler);
+	}
+
+	VulkanStreamedTexture::~VulkanStreamedTexture()
+	{
+		if (m_bChanged)
+		{
+			s_ChangedTextures.erase(std::find(s_ChangedTextures.begin(), s_ChangedTextures.end(), this));
+		}
+
+		Retire();
+	}
+
+	void VulkanStreamedTexture::UploadMip(uint32_t mip, const uint8_t* pixels)
+	{
+		KR_CORE_ASSERT(pixels != nullptr, "VulkanStreamedTexture: no pixels");
+		KR_CORE_ASSERT(mip + 1 == m_FirstResidentMip || (m_FirstResidentMip == m_NumberOfMips && mip == m_NumberOfMips - 1),
+			"Mips are streamed in from the smallest up");
+
+		const uint64_t size = GetMipSize(m_Format, m_Width, m_Height, mip);
+
+		m_Mips.insert(m_Mips.begin(), std::vector<uint8_t>(pixels, pixels + size));
+		m_FirstResidentMip = mip;
+
+		MarkChanged();
+	}
+
+	void VulkanStreamedTexture::Evict(uint32_t firstMip)
+	{
+		if (m_FirstResidentMip >= firstMip || m_FirstResidentMip >= m_NumberOfMips)
+		{
+			return;
+		}
+
+		const uint32_t numberOfEvicted = std::min(firstMip, m_NumberOfMips) - m_FirstResidentMip;
+
+		m_Mips.erase(m_Mips.begin(), m_Mips.begin() + numberOfEvicted);
+		m_FirstResidentMip += numberOfEvicted;
+
+		MarkChanged();
+	}
+
+	uint32_t VulkanStreamedTexture::GetBindlessSlot() const
+	{
+		// The array being full, the texture samples whatever slot 0 holds (as VulkanBindlessTable::RegisterTexture has it)
+		return m_Slot != VulkanBindlessTable::s_InvalidSlot ? m_Slot : 0;
+	}
+
+	void VulkanStreamedTexture::MarkChanged()
+	{
+		if (!m_bChanged)
+		{
+			s_ChangedTextures.push_back(this);
+			m_bChanged = true;
+		}
+	}
+
+	void VulkanStreamedTexture::Flush()
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "The streamed textures are changed while the render thread plays a frame");
+
+		if (s_ChangedTextures.size())
+		{
+			for (VulkanStreamedTexture* texture : s_ChangedTextures)
+			{
+				texture->UploadResident();
+			}
+
+			// The material table is written in place, so the frames already submitted may sample the new slots as soon as they are
+			// retargeted. One wait for all of the changed textures of the frame.
+			VulkanHolder::GetVulkanContext()->GetUploadManager()->WaitForUploads();
+
+			for (VulkanStreamedTexture* texture : s_ChangedTextures)
+			{
+				texture->Commit();
+			}
+
+			// The ones which got no slot are tried again at the next Flush
+			s_ChangedTextures.erase(std::remove_if(s_ChangedTextures.begin(), s_ChangedTextures.end(),
+				[](VulkanStreamedTexture* texture) { return !texture->m_bChanged; }), s_ChangedTextures.end());
+		}
+
+		DestroyRetired(false);
+	}
+
+	void VulkanStreamedTexture::UploadResident()
+	{
+		const uint32_t numberOfResident = m_NumberOfMips - m_FirstResidentMip;
+
+		if (numberOfResident == 0)
+		{
+			return;
+		}
+
+		const uint32_t width = GetMipExtent(m_Width, m_FirstResidentMip);
+		const uint32_t height = GetMipExtent(m_Height, m_FirstResidentMip);
+
+		m_PendingImage = CreateImage(m_Format, width, height, numberOfResident);
+
+		// Mip 0 of the image is the first resident one
+		for (uint32_t mip = 0; mip < numberOfResident; mip++)
+		{
+			VulkanHolder::GetVulkanContext()->GetUploadManager()->UploadImage(m_PendingImage.m_Image, m_Mips[mip].data(), m_Mips[mip].size(),
+				GetMipExtent(width, mip), GetMipExtent(height, mip), mip);
+		}
+	}
+
+	void VulkanStreamedTexture::Commit()
+	{
+		VulkanBindlessTable* bindlessTable = VulkanHolder::GetVulkanContext()->GetBindlessTable();
+
+		const VkImageView view = m_PendingImage.m_View != VK_NULL_HANDLE ? m_PendingImage.m_View : s_Placeholder.m_View;
+		const uint32_t slot = bindlessTable->AllocateTextureSlot(view, s_Sampler);
+
+		if (slot == VulkanBindlessTable::s_InvalidSlot)
+		{
+			// Never sampled, and the uploads are done
+			DestroyImage(m_PendingImage);
+			m_PendingImage = Image();
+			return;
+		}
+
+		if (m_Slot != VulkanBindlessTable::s_InvalidSlot)
+		{
+			bindlessTable->RetargetMaterials(m_Slot, slot);
+		}
+
+		Retire();
+
+		m_Image = m_PendingImage;
+		m_PendingImage = Image();
+		m_Slot = slot;
+		m_bChanged = false;
+	}
+
+	void VulkanStreamedTexture::Retire()
+	{
+		if (m_Image.m_Image == VK_NULL_HANDLE && m_Slot == VulkanBindlessTable::s_InvalidSlot)
+		{
+			return;
+		}
+
+		RetiredImage retired;
+		retired.m_Image = m_Image;
+		retired.m_Slot = m_Slot;
+		retired.m_RetiredFrame = VulkanHolder::GetVulkanContext()->GetFrameSerial();
+
+		s_RetiredImages.push_back(retired);
+
+		m_Image = Image();
+		m_Slot = VulkanBindlessTable::s_InvalidSlot;
+	}
+
+	void VulkanStreamedTexture::DestroyRetired(bool bAll)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		const uint64_t framesInFlight = uint64_t(static_cast<VulkanRendererAPI*>(RenderCommand::GetRendererAPI())->GetMaxFramesInFlight());
+
+		auto iterator = s_RetiredImages.begin();
+
+		while (iterator != s_RetiredImages.end())
+		{
+			if (!bAll && context->GetFrameSerial() < iterator->m_RetiredFrame + framesInFlight + 1)
+			{
+				++iterator;
+				continue;
+			}
+
+			DestroyImage(iterator->m_Image);
+			context->GetBindlessTable()->FreeTextureSlot(iterator->m_Slot);
+
+			iterator = s_RetiredImages.erase(iterator);
+		}
+	}
+
+	void VulkanStreamedTexture::ReleaseResources()
+	{
+		KR_CORE_ASSERT(s_ChangedTextures.empty(), "Streamed textures outlive the context");
+
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		vkDeviceWaitIdle(context->GetLogicalDevice());
+
+		DestroyRetired(true);
+
+		if (s_Placeholder.m_View != VK_NULL_HANDLE)
+		{
+			// Cached descriptor sets mustn't outlive the view
+			context->GetDescriptorCache()->ReleaseImageView(s_Placeholder.m_View);
+
+			DestroyImage(s_Placeholder);
+			s_Placeholder = Image();
+		}
+
+		if (s_Sampler != VK_NULL_HANDLE)
+		{
+			vkDestroySampler(context->GetLogicalDevice(), s_Sampler, nullptr);
+			s_Sampler = VK_NULL_HANDLE;
+		}
+	}
+
+	VkImageView VulkanStreamedTexture::GetPlaceholderView()
+	{
+		CreatePlaceholder();
+
+		return s_Placeholder.m_View;
+	}
+
+	VkSampler VulkanStreamedTexture::GetSampler()
+	{
+		CreatePlaceholder();
+
+		return s_Sampler;
+	}
+
+	void VulkanStreamedTexture::CreatePlaceholder()
+	{
+		if (s_Placeholder.m_View != VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+
+		const uint8_t grey[4] = { 128, 128, 128, 255 };
+
+		// The draws wait for the upload on the GPU (VulkanUploadManager::GetGraphicsWait)
+		s_Placeholder = CreateImage(TextureFormat::RGBA8, 1, 1, 1);
+		context->GetUploadManager()->UploadImage(s_Placeholder.m_Image, grey, sizeof(grey), 1, 1, 0);
+
+		// One sampler for all, the images having their resident mips only
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.anisotropyEnable = VK_TRUE;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(context->GetPhysicalDevice(), &properties);
+
+		samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+		samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+		samplerInfo.unnormalizedCoordinates = VK_FALSE;
+		samplerInfo.compareEnable = VK_FALSE;
+		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		samplerInfo.mipLodBias = 0.0f;
+		samplerInfo.minLod = 0.0f;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+		VkResult result = vkCreateSampler(context->GetLogicalDevice(), &samplerInfo, nullptr, &s_Sampler);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create streamed texture sampler!");
+	}
+
+	VulkanStreamedTexture::Image VulkanStreamedTexture::CreateImage(TextureFormat format, uint32_t width, uint32_t height, uint32_t numberOfMips)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+		VkDevice device = context->GetLogicalDevice();
+
+		Image image;
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = width;
+		imageInfo.extent.height = height;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = numberOfMips;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = VulkanTexture::GetVulkanFormat(format);
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		context->GetUploadManager()->FillSharingMode(imageInfo);
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.flags = 0;
+
+		VkResult result = vkCreateImage(device, &imageInfo, nullptr, &image.m_Image);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create streamed texture image!");
+
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(device, image.m_Image, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = context->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		result = vkAllocateMemory(device, &allocInfo, nullptr, &image.m_Memory);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate streamed texture memory");
+
+		vkBindImageMemory(device, image.m_Image, image.m_Memory, 0);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image.m_Image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = imageInfo.format;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = numberOfMips;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		result = vkCreateImageView(device, &viewInfo, nullptr, &image.m_View);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create streamed texture image view");
+
+		return image;
+	}
+
+	void VulkanStreamedTexture::DestroyImage(const Image& image)
+	{
+		VkDevice device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
+
+		vkDestroyImageView(device, image.m_View, nullptr);
+		vkDestroyImage(device, image.m_Image, nullptr);
+		vkFreeMemory(device, image.m_Memory, nullptr);
+	}
+}
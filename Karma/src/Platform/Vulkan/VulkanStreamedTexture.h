@@ -0,0 +1,127 @@
+/**
+ * @file VulkanStreamedTexture.h
+ * @brief This file contains the VulkanStreamedTexture class, the streamed texture of the bindless Vulkan path.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "Karma/Renderer/StreamedTexture.h"
+
+#include "vulkan/vulkan.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Vulkan's streamed texture. A Vulkan image can't grow or shrink its mips, so the texture keeps the resident mips on the CPU
+	 * and UploadMip and Evict only mark it changed. Flush then makes, for each changed texture, an image of the resident mips (sized to
+	 * the first of them), uploads them and gives the image a new slot of the bindless texture array, to which the materials sampling
+	 * the texture are moved (VulkanBindlessTable::RetargetMaterials). The previous image and slot are destroyed once the frames in
+	 * flight are done with them.
+	 *
+	 * With nothing resident the slot holds a 1x1 grey placeholder shared by all the streamed textures.
+	 *
+	 * @note Render thread. Needs the bindless table, see TextureStreamer::IsSupported.
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanStreamedTexture : public StreamedTexture
+	{
+	public:
+		/**
+		 * @brief Takes a slot for the placeholder, with nothing resident
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanStreamedTexture(uint32_t width, uint32_t height, TextureFormat format);
+
+		/**
+		 * @brief Retires the image and the slot, destroyed once the frames in flight are done with them
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~VulkanStreamedTexture() override;
+
+		virtual void UploadMip(uint32_t mip, const uint8_t* pixels) override;
+		virtual void Evict(uint32_t firstMip) override;
+
+		/**
+		 * @brief Nothing to bind, the draws sample the slot through the material table
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void Bind(uint32_t unit) const override {}
+
+		/**
+		 * @brief Slot of the bindless texture array presently holding the texture (or the placeholder), for the material entries
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint32_t GetBindlessSlot() const;
+
+		/**
+		 * @brief Remakes the images of the textures changed since the last call and moves their materials to them, then destroys what
+		 * the frames in flight are done with. Once per TextureStreamer::Update.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void Flush();
+
+		/**
+		 * @brief Destroys whatever was retired, and the placeholder, before the context goes. The device must be idle.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static void ReleaseResources();
+
+		/**
+		 * @brief View and sampler of the placeholder, for the vertex arrays of a shader sampling through a descriptor set of its own
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static VkImageView GetPlaceholderView();
+		static VkSampler GetSampler();
+
+	public:
+		/**
+		 * @brief An image with its memory and view
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct Image
+		{
+			VkImage m_Image = VK_NULL_HANDLE;
+			VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+			VkImageView m_View = VK_NULL_HANDLE;
+		};
+
+	private:
+		void MarkChanged();
+
+		// Makes the image of the resident mips and records their uploads
+		void UploadResident();
+
+		// Gives the uploaded image a slot, moves the materials to it and retires the previous one
+		void Commit();
+
+		void Retire();
+
+		static Image CreateImage(TextureFormat format, uint32_t width, uint32_t height, uint32_t numberOfMips);
+		static void DestroyImage(const Image& image);
+		static void CreatePlaceholder();
+		static void DestroyRetired(bool bAll);
+
+	private:
+		// The resident mips, m_Mips[i] being mip m_FirstResidentMip + i
+		std::vector<std::vector<uint8_t>> m_Mips;
+
+		// Of the resident mips, empty while the placeholder stands in
+		Image m_Image;
+
+		// Made by UploadResident, committed once the uploads are done
+		Image m_PendingImage;
+
+		uint32_t m_Slot;
+		bool m_bChanged;
+	};
+}
@@ -1,9 +1,13 @@
 #include "VulkanTexutre.h"
 #include "VulkanHolder.h"
+#include "VulkanUploadManager.h"
+#include "VulkanDescriptorCache.h"
+#include "VulkanBindlessTable.h"
+#include "Karma/Renderer/TextureStreamer.h"
 
 namespace Karma
 {
-	VulkanTexture::VulkanTexture()
+	VulkanTexture::VulkanTexture() : m_Format(VK_FORMAT_R8G8B8A8_SRGB), m_NumberOfMips(1)
 	{
 		m_Device = VulkanHolder::GetVulkanContext()->GetLogicalDevice();
 		m_PhysicalDevice = VulkanHolder::GetVulkanContext()->GetPhysicalDevice();
@@ -11,6 +15,16 @@ namespace Karma
 
 	VulkanTexture::~VulkanTexture()
 	{
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->WaitForUploads();
+
+		// Cached descriptor sets mustn't outlive the view
+		VulkanHolder::GetVulkanContext()->GetDescriptorCache()->ReleaseImageView(m_TextureImageView);
+
+		if (VulkanBindlessTable* bindlessTable = VulkanHolder::GetVulkanContext()->GetBindlessTable())
+		{
+			bindlessTable->ReleaseTexture(m_TextureImageView);
+		}
+
 		vkDestroySampler(m_Device, m_TextureSampler, nullptr);
 		vkDestroyImageView(m_Device, m_TextureImageView, nullptr);
 		vkDestroyImage(m_Device, m_TextureImage, nullptr);
@@ -19,25 +33,61 @@ namespace Karma
 
 	void VulkanTexture::GenerateVulkanTexture(VulkanImageBuffer* vImageBuffer)
 	{
-		CreateTextureImage(vImageBuffer);
+		// Not streamed (see TextureStreamer::IsSupported), so the whole chain is made and uploaded here
+		std::vector<TextureMip> mips(1);
+		mips[0].m_Width = static_cast<uint32_t>(vImageBuffer->GetTextureWidth());
+		mips[0].m_Height = static_cast<uint32_t>(vImageBuffer->GetTextureHeight());
+		mips[0].m_Pixels.assign(vImageBuffer->GetPixelData(), vImageBuffer->GetPixelData() + vImageBuffer->GetImageSize());
+
+		TextureSource::GenerateMipChain(mips);
+
+		CreateTextureImage(TextureFormat::RGBA8, mips[0].m_Width, mips[0].m_Height, static_cast<uint32_t>(mips.size()));
+
+		// Transitions and copies are batched with other uploads
+		for (uint32_t mip = 0; mip < m_NumberOfMips; mip++)
+		{
+			VulkanHolder::GetVulkanContext()->GetUploadManager()->UploadImage(m_TextureImage, mips[mip].m_Pixels.data(), mips[mip].m_Pixels.size(),
+				mips[mip].m_Width, mips[mip].m_Height, mip);
+		}
+
+		CreateTextureImageView();
+		CreateTextureSampler();
+	}
+
+	void VulkanTexture::GenerateVulkanTexture(const CookedTexture& cookedTexture)
+	{
+		CreateTextureImage(cookedTexture.GetFormat(), cookedTexture.GetWidth(), cookedTexture.GetHeight(), cookedTexture.GetNumberOfMips());
+
+		// The upload manager stages the blocks, the extents being in texels whatever the format
+		for (uint32_t mip = 0; mip < m_NumberOfMips; mip++)
+		{
+			const CookedTextureMip& cookedMip = cookedTexture.GetMip(mip);
+
+			VulkanHolder::GetVulkanContext()->GetUploadManager()->UploadImage(m_TextureImage, cookedTexture.GetMipData(mip), cookedMip.m_Size,
+				cookedMip.m_Width, cookedMip.m_Height, mip);
+		}
+
 		CreateTextureImageView();
 		CreateTextureSampler();
 	}
 
-	void VulkanTexture::CreateTextureImage(VulkanImageBuffer* vImageBuffer)
+	void VulkanTexture::CreateTextureImage(TextureFormat format, uint32_t width, uint32_t height, uint32_t numberOfMips)
 	{
+		m_Format = GetVulkanFormat(format);
+		m_NumberOfMips = numberOfMips;
+
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageInfo.imageType = VK_IMAGE_TYPE_2D;
-		imageInfo.extent.width = static_cast<uint32_t>(vImageBuffer->GetTextureWidth());
-		imageInfo.extent.height = static_cast<uint32_t>(vImageBuffer->GetTextureHeight());
+		imageInfo.extent.width = width;
+		imageInfo.extent.height = height;
 		imageInfo.extent.depth = 1;
-		imageInfo.mipLevels = 1;
+		imageInfo.mipLevels = m_NumberOfMips;
 		imageInfo.arrayLayers = 1;
-		imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+		imageInfo.format = m_Format;
 		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		VulkanHolder::GetVulkanContext()->GetUploadManager()->FillSharingMode(imageInfo);
 		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageInfo.flags = 0;
 
@@ -55,10 +105,6 @@ namespace Karma
 		KR_CORE_ASSERT(result1 == VK_SUCCESS, "Failed to allocate image memeory");
 
 		vkBindImageMemory(m_Device, m_TextureImage, m_TextureImageMemory, 0);
-
-		VulkanHolder::GetVulkanContext()->TransitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		VulkanHolder::GetVulkanContext()->CopyBufferToImage(vImageBuffer->GetBuffer(), m_TextureImage, static_cast<uint32_t>(vImageBuffer->GetTextureWidth()), static_cast<uint32_t>(vImageBuffer->GetTextureHeight()));
-		VulkanHolder::GetVulkanContext()->TransitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 	}
 
 	void VulkanTexture::CreateTextureImageView()
@@ -67,10 +113,10 @@ namespace Karma
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = m_TextureImage;
 		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+		viewInfo.format = m_Format;
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = m_NumberOfMips;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -101,10 +147,34 @@ namespace Karma
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
+		samplerInfo.maxLod = static_cast<float>(m_NumberOfMips);
 
 		VkResult result = vkCreateSampler(m_Device, &samplerInfo, nullptr, &m_TextureSampler);
 
 		KR_CORE_ASSERT(result == false, "Failed to create texture sampler!");
 	}
-}
\ No newline at end of file
+
+	VkFormat VulkanTexture::GetVulkanFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::RGBA8:
+				return VK_FORMAT_R8G8B8A8_SRGB;
+			case TextureFormat::BC1:
+				return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+			case TextureFormat::BC3:
+				return VK_FORMAT_BC3_SRGB_BLOCK;
+			case TextureFormat::BC5:
+				return VK_FORMAT_BC5_UNORM_BLOCK;
+			case TextureFormat::BC7:
+				return VK_FORMAT_BC7_SRGB_BLOCK;
+			case TextureFormat::ETC2RGB:
+				return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+			case TextureFormat::ETC2RGBA:
+				return VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
+		}
+
+		KR_CORE_ASSERT(false, "Unknown TextureFormat");
+		return VK_FORMAT_R8G8B8A8_SRGB;
+	}
+}
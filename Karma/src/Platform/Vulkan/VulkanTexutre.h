@@ -2,6 +2,7 @@
 
 #include "Karma/Renderer/Texture.h"
 #include "VulkanBuffer.h"
+#include "Karma/Renderer/CookedTexture.h"
 
 namespace Karma
 {
@@ -11,12 +12,18 @@ namespace Karma
 		VulkanTexture();
 		~VulkanTexture();
 		
-		void CreateTextureImage(VulkanImageBuffer* vImageBuffer);
+		void CreateTextureImage(TextureFormat format, uint32_t width, uint32_t height, uint32_t numberOfMips);
 		void CreateTextureImageView();
 		void CreateTextureSampler();
 		
-		// Upload the VulkanImageBuffer to GPU when Texture is instantiated
+		// Upload the VulkanImageBuffer to GPU when Texture is instantiated, its mips made on the CPU
 		void GenerateVulkanTexture(VulkanImageBuffer* vImageBuffer);
+
+		// Upload the mips of the cooked texture as they are (block compressed), straight from the mapping
+		void GenerateVulkanTexture(const CookedTexture& cookedTexture);
+
+		// The VkFormat (sRGB where there is one) of a TextureFormat
+		static VkFormat GetVulkanFormat(TextureFormat format);
 		
 		// Getters
 		VkImageView GetImageView() const { return m_TextureImageView; }
@@ -29,6 +36,8 @@ namespace Karma
 		
 		// Texture relevant stuff
 		VkImage m_TextureImage;
+		VkFormat m_Format;
+		uint32_t m_NumberOfMips;
 		
 		VkDeviceMemory m_TextureImageMemory;
 		VkImageView m_TextureImageView;
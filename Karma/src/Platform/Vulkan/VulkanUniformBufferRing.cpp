@@ -0,0 +1,78 @@
+#include "VulkanUniformBufferRing.h"
+#include "Platform/Vulkan/VulkanHolder.h"
+
+namespace Karma
+{
+	VulkanUniformBufferRing::VulkanUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames) :
+		UniformBufferRing(type, bytesPerFrame, numberOfFrames), m_Buffer(VK_NULL_HANDLE), m_BufferMemory(VK_NULL_HANDLE)
+	{
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
+		m_Device = context->GetLogicalDevice();
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(context->GetPhysicalDevice(), &properties);
+
+		switch (type)
+		{
+			case RingBufferType::Uniform:
+				m_Alignment = uint32_t(properties.limits.minUniformBufferOffsetAlignment);
+				break;
+			case RingBufferType::Storage:
+				m_Alignment = uint32_t(properties.limits.minStorageBufferOffsetAlignment);
+				break;
+			case RingBufferType::Vertex:
+				m_Alignment = 16;
+				break;
+		}
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = GetTotalSize();
+		switch (type)
+		{
+			case RingBufferType::Uniform:
+				bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+				break;
+			case RingBufferType::Storage:
+				bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+				break;
+			case RingBufferType::Vertex:
+				bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+				break;
+		}
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &m_Buffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create uniform ring");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(m_Device, m_Buffer, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = context->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &m_BufferMemory);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate uniform ring memory");
+
+		vkBindBufferMemory(m_Device, m_Buffer, m_BufferMemory, 0);
+
+		// Persistently mapped, we never unmap till the ring is destroyed
+		void* data;
+		vkMapMemory(m_Device, m_BufferMemory, 0, GetTotalSize(), 0, &data);
+		m_MappedData = static_cast<uint8_t*>(data);
+	}
+
+	VulkanUniformBufferRing::~VulkanUniformBufferRing()
+	{
+		vkUnmapMemory(m_Device, m_BufferMemory);
+		vkDestroyBuffer(m_Device, m_Buffer, nullptr);
+		vkFreeMemory(m_Device, m_BufferMemory, nullptr);
+	}
+
+	VkDescriptorType VulkanUniformBufferRing::GetDescriptorType() const
+	{
+		return GetType() == RingBufferType::Uniform ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	}
+}
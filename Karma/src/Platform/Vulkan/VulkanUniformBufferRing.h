@@ -0,0 +1,66 @@
+/**
+ * @file VulkanUniformBufferRing.h
+ * @brief This file contains VulkanUniformBufferRing class, the Vulkan implementation of UniformBufferRing.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "Karma/Renderer/UniformBufferRing.h"
+#include "vulkan/vulkan.h"
+
+namespace Karma
+{
+	/**
+	 * @brief A single host visible (and coherent) VkBuffer, mapped once. Descriptors refer to the buffer with
+	 * VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC (or VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) and the offset returned by
+	 * UniformBufferRing::PushUniforms is supplied to vkCmdBindDescriptorSets as the dynamic offset.
+	 *
+	 * @see VulkanVertexArray::CreateDescriptorSetLayout, VulkanRendererAPI::RecordCommandBuffers
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanUniformBufferRing : public UniformBufferRing
+	{
+	public:
+		/**
+		 * @brief Creates the buffer, allocates the memory and maps it persistently
+		 *
+		 * @param type							Uniform or storage data
+		 * @param bytesPerFrame					Size (in bytes) of the region available to each frame
+		 * @param numberOfFrames				Number of regions (frames) the buffer is split into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VulkanUniformBufferRing(RingBufferType type, uint32_t bytesPerFrame, uint32_t numberOfFrames);
+
+		/**
+		 * @brief Unmaps and frees up the buffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual ~VulkanUniformBufferRing();
+
+		/**
+		 * @brief Getter for the buffer to be written into the descriptor sets
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkBuffer GetBuffer() const { return m_Buffer; }
+
+		/**
+		 * @brief The descriptor type to be used with this ring
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkDescriptorType GetDescriptorType() const;
+
+	private:
+		VkDevice m_Device;
+
+		VkBuffer m_Buffer;
+		VkDeviceMemory m_BufferMemory;
+	};
+}
@@ -0,0 +1,535 @@
+#include "VulkanUploadManager.h"
+#include "Platform/Vulkan/VulkanContext.h"
+#include "Karma/Renderer/RenderThread.h"
+
+namespace Karma
+{
+	VulkanUploadManager::VulkanUploadManager(VulkanContext* context, VkQueue transferQueue, uint32_t transferFamily, uint32_t graphicsFamily, VkDeviceSize ringSize)
+		: m_Context(context), m_TransferQueue(transferQueue), m_TransferFamily(transferFamily), m_GraphicsFamily(graphicsFamily),
+		m_RingBuffer(VK_NULL_HANDLE), m_RingMemory(VK_NULL_HANDLE), m_RingMapped(nullptr), m_RingSize(0), m_RingHead(0), m_RingUsed(0),
+		m_TimelineSemaphore(VK_NULL_HANDLE), m_TimelineValue(0), m_RecordingBatch(-1)
+	{
+		KR_CORE_ASSERT(context, "VulkanContext is null");
+		m_Device = context->GetLogicalDevice();
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(m_Context->GetPhysicalDevice(), &properties);
+
+		// bufferOffset must be multiple of 4 (and texel size)
+		m_ImageCopyAlignment = std::max<VkDeviceSize>(16, properties.limits.optimalBufferCopyOffsetAlignment);
+
+		if (m_TransferFamily != m_GraphicsFamily)
+		{
+			m_ConcurrentQueueFamilies = { m_GraphicsFamily, m_TransferFamily };
+		}
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = m_TransferFamily;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+		VkResult result = vkCreateCommandPool(m_Device, &poolInfo, nullptr, &m_CommandPool);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create upload command pool!");
+
+		m_Batches.resize(s_NumberOfBatches);
+
+		std::vector<VkCommandBuffer> commandBuffers(s_NumberOfBatches);
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = m_CommandPool;
+		allocInfo.commandBufferCount = s_NumberOfBatches;
+
+		result = vkAllocateCommandBuffers(m_Device, &allocInfo, commandBuffers.data());
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate upload command buffers!");
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		for (uint32_t i = 0; i < s_NumberOfBatches; i++)
+		{
+			m_Batches[i].m_CommandBuffer = commandBuffers[i];
+
+			result = vkCreateFence(m_Device, &fenceInfo, nullptr, &m_Batches[i].m_Fence);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create upload fence");
+		}
+
+		if (context->SupportsTimelineSemaphore())
+		{
+			VkSemaphoreTypeCreateInfo typeInfo{};
+			typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+			typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+			typeInfo.initialValue = 0;
+
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreInfo.pNext = &typeInfo;
+
+			result = vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &m_TimelineSemaphore);
+			KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create upload timeline semaphore");
+		}
+
+		CreateRing(ringSize);
+
+		KR_CORE_INFO("VulkanUploadManager: staging ring of {0} bytes, {1} transfer queue", ringSize, IsUsingDedicatedTransferQueue() ? "dedicated" : "graphics");
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		WaitForUploads();
+
+		for (auto& batch : m_Batches)
+		{
+			vkDestroyFence(m_Device, batch.m_Fence, nullptr);
+		}
+
+		if (m_TimelineSemaphore != VK_NULL_HANDLE)
+		{
+			vkDestroySemaphore(m_Device, m_TimelineSemaphore, nullptr);
+		}
+
+		vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+
+		DestroyRing();
+	}
+
+	void VulkanUploadManager::CreateRing(VkDeviceSize ringSize)
+	{
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = ringSize;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkResult result = vkCreateBuffer(m_Device, &bufferInfo, nullptr, &m_RingBuffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create staging ring");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(m_Device, m_RingBuffer, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = m_Context->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &m_RingMemory);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate staging ring memory");
+
+		vkBindBufferMemory(m_Device, m_RingBuffer, m_RingMemory, 0);
+
+		// Persistently mapped, we never unmap till the ring is destroyed
+		void* data;
+		vkMapMemory(m_Device, m_RingMemory, 0, ringSize, 0, &data);
+		m_RingMapped = static_cast<uint8_t*>(data);
+
+		m_RingSize = ringSize;
+		m_RingHead = 0;
+		m_RingUsed = 0;
+	}
+
+	void VulkanUploadManager::DestroyRing()
+	{
+		if (m_RingBuffer == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		vkUnmapMemory(m_Device, m_RingMemory);
+		vkDestroyBuffer(m_Device, m_RingBuffer, nullptr);
+		vkFreeMemory(m_Device, m_RingMemory, nullptr);
+
+		m_RingBuffer = VK_NULL_HANDLE;
+		m_RingMemory = VK_NULL_HANDLE;
+		m_RingMapped = nullptr;
+	}
+
+	VkDeviceSize VulkanUploadManager::AllocateFromRing(VkDeviceSize size, VkDeviceSize alignment)
+	{
+		// Oversized upload, we need a bigger ring
+		if (size + alignment > m_RingSize)
+		{
+			WaitForUploads();
+			DestroyRing();
+
+			VkDeviceSize newSize = m_RingSize;
+			while (newSize < size + alignment)
+			{
+				newSize *= 2;
+			}
+
+			CreateRing(newSize);
+			m_Statistics.m_NumberOfRingGrowths++;
+
+			KR_CORE_WARN("VulkanUploadManager: staging ring grown to {0} bytes", newSize);
+		}
+
+		VkDeviceSize offset = 0;
+		VkDeviceSize consumed = 0;
+
+		while (true)
+		{
+			if (m_RingUsed == 0)
+			{
+				m_RingHead = 0;
+			}
+
+			VkDeviceSize freeBytes = m_RingSize - m_RingUsed;
+			VkDeviceSize alignedHead = (m_RingHead + alignment - 1) & ~(alignment - 1);
+
+			if (alignedHead + size <= m_RingSize)
+			{
+				offset = alignedHead;
+				consumed = alignedHead + size - m_RingHead;
+			}
+			else
+			{
+				// Wrap around, the tail end of ring is wasted till the batch retires
+				offset = 0;
+				consumed = (m_RingSize - m_RingHead) + size;
+			}
+
+			if (consumed <= freeBytes)
+			{
+				break;
+			}
+
+			// Not enough room. Submit what we have and reclaim the oldest batch.
+			Flush();
+
+			if (!RetireOldestBatch())
+			{
+				KR_CORE_ASSERT(false, "Staging ring is out of space with nothing in flight");
+				break;
+			}
+		}
+
+		m_RingHead = (offset + size) % m_RingSize;
+		m_RingUsed += consumed;
+
+		UploadBatch& batch = GetRecordingBatch();
+		batch.m_RingBytes += consumed;
+
+		return offset;
+	}
+
+	VulkanUploadManager::UploadBatch& VulkanUploadManager::GetRecordingBatch()
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "Uploads are recorded while the render thread plays a frame");
+
+		if (m_RecordingBatch >= 0)
+		{
+			return m_Batches[m_RecordingBatch];
+		}
+
+		RetireCompletedBatches();
+
+		int32_t freeBatch = -1;
+		while (freeBatch < 0)
+		{
+			for (uint32_t i = 0; i < s_NumberOfBatches; i++)
+			{
+				if (!m_Batches[i].m_bInFlight)
+				{
+					freeBatch = int32_t(i);
+					break;
+				}
+			}
+
+			if (freeBatch < 0)
+			{
+				RetireOldestBatch();
+			}
+		}
+
+		UploadBatch& batch = m_Batches[freeBatch];
+
+		vkResetCommandBuffer(batch.m_CommandBuffer, 0);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VkResult result = vkBeginCommandBuffer(batch.m_CommandBuffer, &beginInfo);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to begin upload command buffer");
+
+		m_RecordingBatch = freeBatch;
+
+		return batch;
+	}
+
+	bool VulkanUploadManager::RetireOldestBatch()
+	{
+		if (m_InFlightBatches.empty())
+		{
+			return false;
+		}
+
+		UploadBatch& batch = m_Batches[m_InFlightBatches.front()];
+
+		if (vkGetFenceStatus(m_Device, batch.m_Fence) != VK_SUCCESS)
+		{
+			vkWaitForFences(m_Device, 1, &batch.m_Fence, VK_TRUE, UINT64_MAX);
+			m_Statistics.m_NumberOfFenceWaits++;
+		}
+
+		m_RingUsed -= batch.m_RingBytes;
+		batch.m_RingBytes = 0;
+		batch.m_bInFlight = false;
+
+		m_InFlightBatches.pop_front();
+
+		return true;
+	}
+
+	void VulkanUploadManager::RetireCompletedBatches()
+	{
+		while (!m_InFlightBatches.empty())
+		{
+			UploadBatch& batch = m_Batches[m_InFlightBatches.front()];
+
+			if (vkGetFenceStatus(m_Device, batch.m_Fence) != VK_SUCCESS)
+			{
+				break;
+			}
+
+			RetireOldestBatch();
+		}
+	}
+
+	void VulkanUploadManager::UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		VkDeviceSize srcOffset = AllocateFromRing(size, 16);
+		memcpy(m_RingMapped + srcOffset, data, static_cast<size_t>(size));
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+
+		vkCmdCopyBuffer(GetRecordingBatch().m_CommandBuffer, m_RingBuffer, dstBuffer, 1, &copyRegion);
+
+		m_Statistics.m_NumberOfUploads++;
+		m_Statistics.m_UploadedBytes += size;
+	}
+
+	void VulkanUploadManager::UploadImage(VkImage image, const void* pixels, VkDeviceSize size, uint32_t width, uint32_t height, uint32_t mipLevel)
+	{
+		VkDeviceSize srcOffset = AllocateFromRing(size, m_ImageCopyAlignment);
+		memcpy(m_RingMapped + srcOffset, pixels, static_cast<size_t>(size));
+
+		TransitionImageLayout(image, VK_FORMAT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevel);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = mipLevel;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+
+		vkCmdCopyBufferToImage(GetRecordingBatch().m_CommandBuffer, m_RingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		TransitionImageLayout(image, VK_FORMAT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevel);
+
+		m_Statistics.m_NumberOfUploads++;
+		m_Statistics.m_UploadedBytes += size;
+	}
+
+	void VulkanUploadManager::CopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t width, uint32_t height)
+	{
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+
+		vkCmdCopyBufferToImage(GetRecordingBatch().m_CommandBuffer, srcBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		m_Statistics.m_NumberOfUploads++;
+	}
+
+	VkPipelineStageFlags VulkanUploadManager::ResolveDestinationStage(VkPipelineStageFlags stage, VkAccessFlags& accessMask) const
+	{
+		if (!IsUsingDedicatedTransferQueue())
+		{
+			return stage;
+		}
+
+		// Release: the transition completes within the transfer stage, and the semaphore the batch signals (whose first scope is
+		// all of the batch) carries it to the acquire, the graphics queue's wait at s_GraphicsWaitStages
+		if (stage & s_GraphicsWaitStages)
+		{
+			accessMask = 0;
+			return VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+
+		return stage;
+	}
+
+	void VulkanUploadManager::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevel)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+
+		if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+		{
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			if (m_Context->HasStencilComponent(format))
+			{
+				barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+			}
+		}
+		else
+		{
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+
+		barrier.subresourceRange.baseMipLevel = mipLevel;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		VkPipelineStageFlags sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		VkPipelineStageFlags destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+		{
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			destinationStage = ResolveDestinationStage(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, barrier.dstAccessMask);
+		}
+		else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+		{
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			destinationStage = ResolveDestinationStage(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, barrier.dstAccessMask);
+		}
+		else
+		{
+			KR_CORE_ASSERT(false, "Unsupported layout transition!");
+		}
+
+		vkCmdPipelineBarrier(
+			GetRecordingBatch().m_CommandBuffer,
+			sourceStage, destinationStage,
+			0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier
+		);
+	}
+
+	void VulkanUploadManager::Flush()
+	{
+		KR_CORE_ASSERT(RenderThread::IsRenderingContext(), "Uploads are recorded while the render thread plays a frame");
+
+		if (m_RecordingBatch < 0)
+		{
+			return;
+		}
+
+		UploadBatch& batch = m_Batches[m_RecordingBatch];
+		m_RecordingBatch = -1;
+
+		VkResult result = vkEndCommandBuffer(batch.m_CommandBuffer);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to record upload command buffer");
+
+		vkResetFences(m_Device, 1, &batch.m_Fence);
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.m_CommandBuffer;
+
+		const uint64_t signalValue = m_TimelineValue + 1;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+		if (m_TimelineSemaphore != VK_NULL_HANDLE)
+		{
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &m_TimelineSemaphore;
+		}
+
+		result = vkQueueSubmit(m_TransferQueue, 1, &submitInfo, batch.m_Fence);
+		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to submit upload command buffer");
+
+		if (m_TimelineSemaphore != VK_NULL_HANDLE)
+		{
+			m_TimelineValue = signalValue;
+		}
+
+		batch.m_bInFlight = true;
+		m_InFlightBatches.push_back(uint32_t(&batch - m_Batches.data()));
+
+		m_Statistics.m_NumberOfSubmissions++;
+	}
+
+	void VulkanUploadManager::WaitForUploads()
+	{
+		Flush();
+
+		while (RetireOldestBatch())
+		{
+		}
+	}
+
+	bool VulkanUploadManager::GetGraphicsWait(VkSemaphore& semaphore, uint64_t& value)
+	{
+		if (m_TimelineSemaphore == VK_NULL_HANDLE)
+		{
+			WaitForUploads();
+			return false;
+		}
+
+		Flush();
+
+		// Ring space is given back without blocking, the fences of batches the GPU is yet to finish are left alone
+		RetireCompletedBatches();
+
+		if (m_TimelineValue == 0)
+		{
+			return false;
+		}
+
+		semaphore = m_TimelineSemaphore;
+		value = m_TimelineValue;
+
+		return true;
+	}
+}
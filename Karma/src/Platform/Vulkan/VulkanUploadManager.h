@@ -0,0 +1,338 @@
+/**
+ * @file VulkanUploadManager.h
+ * @brief This file contains VulkanUploadManager class, the batched staging path for host to device transfers.
+ * @version 1.0
+ *
+ * @copyright Karma Engine copyright(c) People of India
+ */
+#pragma once
+
+#include "krpch.h"
+
+#include "vulkan/vulkan.h"
+
+namespace Karma
+{
+	/**
+	 * @brief Forward declaration
+	 */
+	class VulkanContext;
+
+	/**
+	 * @brief Counters gathered by VulkanUploadManager. Useful for gauging the cost of (say) loading 1000 meshes
+	 * against the old one-submission-per-copy path.
+	 *
+	 * @since Karma 1.0.0
+	 */
+	struct KARMA_API UploadStatistics
+	{
+		/**
+		 * @brief Number of buffer and image copies recorded
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfUploads = 0;
+
+		/**
+		 * @brief Total number of bytes staged through the ring
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_UploadedBytes = 0;
+
+		/**
+		 * @brief Number of vkQueueSubmit calls made for the uploads. Ideally much smaller than m_NumberOfUploads.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfSubmissions = 0;
+
+		/**
+		 * @brief Number of times the host had to block on an upload fence
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfFenceWaits = 0;
+
+		/**
+		 * @brief Number of times the staging ring had to be reallocated for an oversized upload
+		 *
+		 * @since Karma 1.0.0
+		 */
+		uint64_t m_NumberOfRingGrowths = 0;
+	};
+
+	/**
+	 * @brief Batches host to device (GPU) copies and layout transitions into a single command buffer which is submitted
+	 * once (per frame or when the staging ring runs out of space), instead of one command buffer, vkQueueSubmit and vkQueueWaitIdle
+	 * per upload.
+	 *
+	 * Data is memcpy'd into a persistently mapped, host visible, ring buffer (the staging ring). The copy commands are recorded
+	 * into the batch being recorded. Each submitted batch carries a fence, and the ring space it consumed is reclaimed once the fence
+	 * is signalled. Each batch also signals the next value of a timeline semaphore, which the graphics submission waits upon (see
+	 * GetGraphicsWait()), so the host never blocks on the uploads to draw. A dedicated transfer queue (queue family with VK_QUEUE_TRANSFER_BIT but without VK_QUEUE_GRAPHICS_BIT) is used
+	 * when the graphics card exposes one, else the graphics queue is used.
+	 *
+	 * @note When a dedicated transfer queue is in use, the destination resources are created with VK_SHARING_MODE_CONCURRENT
+	 * (see GetConcurrentQueueFamilies()) so that no queue family ownership transfer is needed.
+	 *
+	 * @note Not locked, the uploads are recorded by the render thread (or with it idle, see RenderThread::IsRenderingContext)
+	 * @see VulkanVertexBuffer, VulkanIndexBuffer, VulkanTexture
+	 * @since Karma 1.0.0
+	 */
+	class KARMA_API VulkanUploadManager
+	{
+	public:
+		/**
+		 * @brief Creates the staging ring, command pool (on transfer queue family) and the batches (command buffer + fence)
+		 *
+		 * @param context						The VulkanContext with logical device and queues already created
+		 * @param transferQueue					The queue to submit the uploads to
+		 * @param transferFamily				Queue family index of transferQueue
+		 * @param graphicsFamily				Queue family index of the graphics queue
+		 * @param ringSize						Initial size (in bytes) of the staging ring
+		 *
+		 * @see VulkanContext::Init()
+		 * @since Karma 1.0.0
+		 */
+		VulkanUploadManager(VulkanContext* context, VkQueue transferQueue, uint32_t transferFamily, uint32_t graphicsFamily, VkDeviceSize ringSize = 32 * 1024 * 1024);
+
+		/**
+		 * @brief Waits for pending uploads and frees up the Vulkan resources (ring, fences, command pool)
+		 *
+		 * @since Karma 1.0.0
+		 */
+		~VulkanUploadManager();
+
+		/**
+		 * @brief Stages the data and records a copy into dstBuffer. The copy is executed when the batch is submitted.
+		 *
+		 * @param dstBuffer						The device local buffer to copy data to (must have VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+		 * @param data							Pointer to host data. Copied immediately, so may be freed after the call
+		 * @param size							Size (in bytes) of the data
+		 * @param dstOffset						Offset (in bytes) in the dstBuffer
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+		/**
+		 * @brief Stages the pixels and records UNDEFINED -> TRANSFER_DST transition, the copy, and TRANSFER_DST -> SHADER_READ_ONLY
+		 * transition of the (color) image.
+		 *
+		 * @param image							The image with VK_IMAGE_USAGE_TRANSFER_DST_BIT
+		 * @param pixels						Tightly packed pixel data. Copied immediately, so may be freed after the call
+		 * @param size							Size (in bytes) of pixel data
+		 * @param width							Width of the mip in pixels
+		 * @param height						Height of the mip in pixels
+		 * @param mipLevel						The mip written (and transitioned), the others are left alone
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void UploadImage(VkImage image, const void* pixels, VkDeviceSize size, uint32_t width, uint32_t height, uint32_t mipLevel = 0);
+
+		/**
+		 * @brief Records an image layout transition into the current batch
+		 *
+		 * @param image							The image to transition
+		 * @param format						Format of the image (for stencil aspect)
+		 * @param oldLayout						Present layout
+		 * @param newLayout						Demanded layout
+		 * @param mipLevel						The mip transitioned
+		 *
+		 * @see VulkanContext::TransitionImageLayout
+		 * @since Karma 1.0.0
+		 */
+		void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevel = 0);
+
+		/**
+		 * @brief Records a copy from a caller owned buffer to image (in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+		 *
+		 * @note The caller is responsible for keeping srcBuffer alive till WaitForUploads() returns
+		 * @since Karma 1.0.0
+		 */
+		void CopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t width, uint32_t height);
+
+		/**
+		 * @brief Ends and submits the batch being recorded (if any) with its fence. Does not block.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void Flush();
+
+		/**
+		 * @brief Flushes and blocks on the fences of all in-flight batches. For the callers which are about to destroy (or read back)
+		 * what the uploads touch, the draws wait on the GPU instead (GetGraphicsWait()).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void WaitForUploads();
+
+		/**
+		 * @brief Flushes the batch being recorded and gives the timeline semaphore value the graphics submission need wait for,
+		 * at s_GraphicsWaitStages, for the uploads submitted so far. Without timeline semaphore support the host waits (WaitForUploads())
+		 * instead, and false is returned.
+		 *
+		 * @param semaphore						The timeline semaphore, to go into pWaitSemaphores
+		 * @param value							The value to go into VkTimelineSemaphoreSubmitInfo::pWaitSemaphoreValues
+		 *
+		 * @return false if there is nothing to wait for
+		 * @see VulkanRendererAPI::SubmitCommandBuffers()
+		 * @since Karma 1.0.0
+		 */
+		bool GetGraphicsWait(VkSemaphore& semaphore, uint64_t& value);
+
+		/**
+		 * @brief The stages of the graphics queue which consume the uploads: vertex and index fetch, texture sampling and the depth
+		 * attachment transitioned here
+		 *
+		 * @since Karma 1.0.0
+		 */
+		static constexpr VkPipelineStageFlags s_GraphicsWaitStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+
+		/**
+		 * @brief Queue families the destination resources need be shared among. Empty if the uploads go to the graphics queue
+		 * (in which case VK_SHARING_MODE_EXCLUSIVE is fine).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const std::vector<uint32_t>& GetConcurrentQueueFamilies() const { return m_ConcurrentQueueFamilies; }
+
+		/**
+		 * @brief Fills sharingMode, queueFamilyIndexCount and pQueueFamilyIndices of the buffer/image create info
+		 * according to GetConcurrentQueueFamilies()
+		 *
+		 * @since Karma 1.0.0
+		 */
+		template<typename CreateInfo>
+		void FillSharingMode(CreateInfo& createInfo) const
+		{
+			if (m_ConcurrentQueueFamilies.size() > 1)
+			{
+				createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+				createInfo.queueFamilyIndexCount = static_cast<uint32_t>(m_ConcurrentQueueFamilies.size());
+				createInfo.pQueueFamilyIndices = m_ConcurrentQueueFamilies.data();
+			}
+			else
+			{
+				createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+				createInfo.queueFamilyIndexCount = 0;
+				createInfo.pQueueFamilyIndices = nullptr;
+			}
+		}
+
+		/**
+		 * @brief Getter for the upload counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		const UploadStatistics& GetStatistics() const { return m_Statistics; }
+
+		/**
+		 * @brief Resets the upload counters
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void ResetStatistics() { m_Statistics = UploadStatistics(); }
+
+		/**
+		 * @brief Whether a dedicated transfer queue (different family from graphics) is being used
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsUsingDedicatedTransferQueue() const { return m_TransferFamily != m_GraphicsFamily; }
+
+	private:
+		/**
+		 * @brief A command buffer with fence and the amount of staging ring consumed
+		 *
+		 * @since Karma 1.0.0
+		 */
+		struct UploadBatch
+		{
+			VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+			VkFence m_Fence = VK_NULL_HANDLE;
+			VkDeviceSize m_RingBytes = 0;
+			bool m_bInFlight = false;
+		};
+
+		void CreateRing(VkDeviceSize ringSize);
+		void DestroyRing();
+
+		/**
+		 * @brief Sub-allocates size bytes from the staging ring, reclaiming (or growing) when needed
+		 *
+		 * @return Offset of the allocation within the ring
+		 * @since Karma 1.0.0
+		 */
+		VkDeviceSize AllocateFromRing(VkDeviceSize size, VkDeviceSize alignment);
+
+		/**
+		 * @brief Returns the batch being recorded, beginning a fresh one if required
+		 *
+		 * @since Karma 1.0.0
+		 */
+		UploadBatch& GetRecordingBatch();
+
+		/**
+		 * @brief Blocks on the oldest in-flight batch and gives its ring bytes back
+		 *
+		 * @return false if nothing was in flight
+		 * @since Karma 1.0.0
+		 */
+		bool RetireOldestBatch();
+
+		/**
+		 * @brief Gives back the ring bytes of batches whose fences are already signalled, without blocking
+		 *
+		 * @since Karma 1.0.0
+		 */
+		void RetireCompletedBatches();
+
+		/**
+		 * @brief Stage masks for transitions need be supported by the queue family. A transfer only queue can't name the vertex or
+		 * fragment stages, so on it the barrier is the release half only (transfer stage, no destination access) and the acquire half is
+		 * the graphics submission's wait on the timeline semaphore at s_GraphicsWaitStages.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkPipelineStageFlags ResolveDestinationStage(VkPipelineStageFlags stage, VkAccessFlags& accessMask) const;
+
+	private:
+		VulkanContext* m_Context;
+		VkDevice m_Device;
+
+		VkQueue m_TransferQueue;
+		uint32_t m_TransferFamily;
+		uint32_t m_GraphicsFamily;
+		std::vector<uint32_t> m_ConcurrentQueueFamilies;
+
+		VkCommandPool m_CommandPool;
+
+		// Signalled by each batch with the next value, VK_NULL_HANDLE without timeline semaphore support
+		VkSemaphore m_TimelineSemaphore;
+		uint64_t m_TimelineValue;
+
+		// bufferOffset of image copies, from the device limits
+		VkDeviceSize m_ImageCopyAlignment;
+
+		// Staging ring
+		VkBuffer m_RingBuffer;
+		VkDeviceMemory m_RingMemory;
+		uint8_t* m_RingMapped;
+		VkDeviceSize m_RingSize;
+		VkDeviceSize m_RingHead;
+		VkDeviceSize m_RingUsed;
+
+		// Batches
+		std::vector<UploadBatch> m_Batches;
+		std::list<uint32_t> m_InFlightBatches;
+		int32_t m_RecordingBatch;
+
+		UploadStatistics m_Statistics;
+
+		// Number of batches that can be in flight (and one being recorded)
+		static constexpr uint32_t s_NumberOfBatches = 4;
+	};
+}
@@ -1,7 +1,13 @@
 #include "VulkanVertexArray.h"
 #include "Platform/Vulkan/VulkanHolder.h"
+#include "Platform/Vulkan/VulkanUniformBufferRing.h"
+#include "Platform/Vulkan/VulkanDescriptorCache.h"
 #include "Platform/Vulkan/VulkanTexutre.h"
+#include "Platform/Vulkan/VulkanBindlessTable.h"
+#include "Platform/Vulkan/VulkanStreamedTexture.h"
+#include "Karma/Renderer/TextureStreamer.h"
 #include "Karma/Renderer/RenderCommand.h"
+#include "Karma/Renderer/Material.h"
 
 namespace Karma
 {
@@ -26,22 +32,24 @@ namespace Karma
 		CreateDescriptorSetLayout();
 		CreatePipelineLayout();
 		CreateGraphicsPipeline();
-		CreateDescriptorPool();
 		CreateDescriptorSets();
 	}
 
 	void VulkanVertexArray::CleanupPipeline()
 	{
+		// Layouts and descriptor sets are owned by VulkanDescriptorCache
 		vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
-		vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
-		vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
-		vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);// Descriptorsets get automatically get freed
+
+		if (m_DepthOnlyPipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(m_device, m_DepthOnlyPipeline, nullptr);
+			m_DepthOnlyPipeline = VK_NULL_HANDLE;
+		}
 	}
 
 	void VulkanVertexArray::SetShader(std::shared_ptr<Shader> shader)
 	{
 		m_Shader = std::static_pointer_cast<VulkanShader>(shader);
-		VulkanHolder::GetVulkanContext()->RegisterUBO(m_Shader->GetUniformBufferObject());
 		GenerateVulkanVA();
 	}
 
@@ -57,10 +65,45 @@ namespace Karma
 		m_UseExternalViewPort = true;
 	}
 
+	VkViewport VulkanVertexArray::GetViewport(VkExtent2D extent) const
+	{
+		if (m_UseExternalViewPort)
+		{
+			return m_ExternalViewPort;
+		}
+
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = (float)extent.width;
+		viewport.height = (float)extent.height;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+
+		return viewport;
+	}
+
 	void VulkanVertexArray::CreateGraphicsPipeline()
 	{
-		VkShaderModule vertShaderModule = CreateShaderModule(m_Shader->GetVertSpirV());
-		VkShaderModule fragShaderModule = CreateShaderModule(m_Shader->GetFragSpirV());
+		m_graphicsPipeline = BuildGraphicsPipeline(false);
+
+		// Transparent draws don't write depth, so they have no part in the pre-pass
+		m_DepthOnlyPipeline = VK_NULL_HANDLE;
+		if (m_Shader->HasDepthOnlyVariant() && !IsTransparent())
+		{
+			m_DepthOnlyPipeline = BuildGraphicsPipeline(true);
+		}
+	}
+
+	bool VulkanVertexArray::IsTransparent() const
+	{
+		return m_Materials.size() && m_Materials[0]->IsTransparent();
+	}
+
+	VkPipeline VulkanVertexArray::BuildGraphicsPipeline(bool bDepthOnly)
+	{
+		VkShaderModule vertShaderModule = CreateShaderModule(bDepthOnly ? m_Shader->GetDepthOnlyVertSpirV() : m_Shader->GetVertSpirV());
+		VkShaderModule fragShaderModule = bDepthOnly ? VK_NULL_HANDLE : CreateShaderModule(m_Shader->GetFragSpirV());
 
 		VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 		vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -76,44 +119,67 @@ namespace Karma
 
 		VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions = { m_bindingDescription };
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+
+		// The depth only variant reads the position alone, the stride stays that of the full vertex
+		for (const VkVertexInputAttributeDescription& attribute : m_attributeDescriptions)
+		{
+			if (!bDepthOnly || attribute.location == s_PositionLocation)
+			{
+				attributeDescriptions.push_back(attribute);
+			}
+		}
+
+		// Instancing shaders read the world matrix, column by column, from binding 1 (see VulkanRendererAPI::DrawIndexedInstanced)
+		if (m_Shader->SupportsInstancing())
+		{
+			VkVertexInputBindingDescription instanceBinding{};
+			instanceBinding.binding = s_InstanceBinding;
+			instanceBinding.stride = sizeof(glm::mat4);
+			instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+			bindingDescriptions.push_back(instanceBinding);
+
+			for (uint32_t column = 0; column < 4; column++)
+			{
+				VkVertexInputAttributeDescription columnAttribute{};
+				columnAttribute.binding = s_InstanceBinding;
+				columnAttribute.location = Shader::s_InstanceTransformLocation + column;
+				columnAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+				columnAttribute.offset = column * sizeof(glm::vec4);
+
+				attributeDescriptions.push_back(columnAttribute);
+			}
+		}
+
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(m_attributeDescriptions.size());
-		vertexInputInfo.pVertexBindingDescriptions = &m_bindingDescription;
-		vertexInputInfo.pVertexAttributeDescriptions = m_attributeDescriptions.data();
+		vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
+		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+		vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
 		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
 		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
 		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = (float)VulkanHolder::GetVulkanContext()->GetSwapChainExtent().width;
-		viewport.height = (float)VulkanHolder::GetVulkanContext()->GetSwapChainExtent().height;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-
-		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = VulkanHolder::GetVulkanContext()->GetSwapChainExtent();
-
+		// Viewport and scissor are set at record time (see GetViewport), so the pipeline outlives swapchain recreation and draws into
+		// render targets of any size
 		VkPipelineViewportStateCreateInfo viewportState{};
 		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 		viewportState.viewportCount = 1;
-		if (m_UseExternalViewPort)
-		{
-			viewportState.pViewports = &m_ExternalViewPort;
-		}
-		else
-		{
-			viewportState.pViewports = &viewport;
-		}
-		
+		viewportState.pViewports = nullptr;
 		viewportState.scissorCount = 1;
-		viewportState.pScissors = &scissor;
+		viewportState.pScissors = nullptr;
+
+		std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
 
 		VkPipelineRasterizationStateCreateInfo rasterizer{};
 		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -131,15 +197,20 @@ namespace Karma
 		multisampling.sampleShadingEnable = VK_FALSE;
 		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+		const bool bTransparent = IsTransparent();
+
+		// LESS_OR_EQUAL so that the shading pass passes where the pre-pass laid the very same depth. Transparent draws test against
+		// the opaque depth but leave it be.
 		VkPipelineDepthStencilStateCreateInfo depthStencil{};
 		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 		depthStencil.depthTestEnable = VK_TRUE;
-		depthStencil.depthWriteEnable = VK_TRUE;
-		depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+		depthStencil.depthWriteEnable = bTransparent ? VK_FALSE : VK_TRUE;
+		depthStencil.depthCompareOp = bDepthOnly ? VK_COMPARE_OP_LESS : VK_COMPARE_OP_LESS_OR_EQUAL;
 		depthStencil.depthBoundsTestEnable = VK_FALSE;
 		depthStencil.stencilTestEnable = VK_FALSE;
 
-		VkBool32 bLogicalOperationsAllowed = m_SupportedDeviceFeatures.logicOp;
+		// Blending needs the logic op off
+		VkBool32 bLogicalOperationsAllowed = m_SupportedDeviceFeatures.logicOp && !bTransparent && !bDepthOnly;
 
 		// Mix the old and new value to produce a final color
 		// finalColor.rgb = newAlpha * newColor + (1 - newAlpha) * oldColor;
@@ -147,7 +218,13 @@ namespace Karma
 		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
 		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
 			| VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-		if (!bLogicalOperationsAllowed)
+		if (bDepthOnly)
+		{
+			// No fragment shader, the color attachment is left untouched
+			colorBlendAttachment.colorWriteMask = 0;
+			colorBlendAttachment.blendEnable = VK_FALSE;
+		}
+		else if (!bLogicalOperationsAllowed)
 		{
 			colorBlendAttachment.blendEnable = VK_TRUE;
 		}
@@ -183,11 +260,12 @@ namespace Karma
 
 		VkGraphicsPipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		pipelineInfo.stageCount = 2;
+		pipelineInfo.stageCount = bDepthOnly ? 1 : 2;
 		pipelineInfo.pStages = shaderStages;
 		pipelineInfo.pVertexInputState = &vertexInputInfo;
 		pipelineInfo.pInputAssemblyState = &inputAssembly;
 		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pDynamicState = &dynamicState;
 		pipelineInfo.pRasterizationState = &rasterizer;
 		pipelineInfo.pMultisampleState = &multisampling;
 		pipelineInfo.pColorBlendState = &colorBlending;
@@ -197,13 +275,20 @@ namespace Karma
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 		pipelineInfo.pDepthStencilState = &depthStencil;
 
-		VkResult resultGP = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE,
-			1, &pipelineInfo, nullptr, &m_graphicsPipeline);
+		VkPipeline pipeline;
+		// The cache lets a pipeline rebuilt from unchanged stages skip the driver's compilation
+		VkResult resultGP = vkCreateGraphicsPipelines(m_device, VulkanHolder::GetVulkanContext()->GetPipelineCache(),
+			1, &pipelineInfo, nullptr, &pipeline);
 
 		KR_CORE_ASSERT(resultGP == VK_SUCCESS, "Failed to create graphics pipeline!");
 
-		vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
+		if (fragShaderModule != VK_NULL_HANDLE)
+		{
+			vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
+		}
 		vkDestroyShaderModule(m_device, vertShaderModule, nullptr);
+
+		return pipeline;
 	}
 
 	void VulkanVertexArray::SetMesh(std::shared_ptr<Mesh> mesh)
@@ -223,6 +308,8 @@ namespace Karma
 
 		// May need modificaitons for batch rendering later.
 		m_IndexBuffer = std::static_pointer_cast<VulkanIndexBuffer>(mesh->GetIndexBuffer());
+
+		TrackMesh(mesh);
 	}
 
 	void VulkanVertexArray::SetMaterial(std::shared_ptr<Material> material)
@@ -230,8 +317,25 @@ namespace Karma
 		m_Materials.push_back(material);
 		m_Shader = std::static_pointer_cast<VulkanShader>(material->GetShader(0));
 
-		VulkanHolder::GetVulkanContext()->RegisterUBO(m_Shader->GetUniformBufferObject());
 		GenerateVulkanVA();
+
+		TrackMaterial(material);
+	}
+
+	void VulkanVertexArray::OnAssetsReloaded()
+	{
+		// The buffers, and with them the vertex layout, may be new
+		if (GetMesh())
+		{
+			SetMesh(GetMesh());
+		}
+
+		// The SPIR-V or the texture's image view may be new. The pipeline cache spares the compilation of the stages that aren't.
+		if (m_Materials.size())
+		{
+			CleanupPipeline();
+			RecreateVulkanVA();
+		}
 	}
 
 	void VulkanVertexArray::UpdateProcessAndSetReadyForSubmission() const
@@ -269,6 +373,16 @@ namespace Karma
 			return VK_FORMAT_R32G32B32_SFLOAT;
 		case ShaderDataType::Float4:
 			return VK_FORMAT_R32G32B32A32_SFLOAT;
+		case ShaderDataType::Half2:
+			return VK_FORMAT_R16G16_SFLOAT;
+		case ShaderDataType::Half4:
+			return VK_FORMAT_R16G16B16A16_SFLOAT;
+		case ShaderDataType::Short2Norm:
+			return VK_FORMAT_R16G16_SNORM;
+		case ShaderDataType::Byte4Norm:
+			return VK_FORMAT_R8G8B8A8_SNORM;
+		case ShaderDataType::UByte4Norm:
+			return VK_FORMAT_R8G8B8A8_UNORM;
 		case ShaderDataType::None:
 		case ShaderDataType::Mat3:
 		case ShaderDataType::Mat4:
@@ -326,50 +440,46 @@ namespace Karma
 		CreateDescriptorSetLayout();
 		CreatePipelineLayout();
 		CreateGraphicsPipeline();
-		CreateDescriptorPool();
 		CreateDescriptorSets();
 	}
 
 	void VulkanVertexArray::CreatePipelineLayout()
 	{
-		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = 1;
-		pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-
-		VkResult result = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr,
-			&m_pipelineLayout);
+		VulkanContext* context = VulkanHolder::GetVulkanContext();
 
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create pipeline layout!");
-	}
+		if (UsesBindless())
+		{
+			VkPushConstantRange materialIndexRange{};
+			materialIndexRange.stageFlags = s_MaterialIndexStages;
+			materialIndexRange.offset = 0;
+			materialIndexRange.size = sizeof(uint32_t);
+
+			// Same layout for every bindless vertex array with alike uniforms, whatever the material
+			m_pipelineLayout = context->GetDescriptorCache()->GetOrCreatePipelineLayout({ m_descriptorSetLayout, context->GetBindlessTable()->GetDescriptorSetLayout() },
+				{ materialIndexRange });
+			return;
+		}
 
-	void VulkanVertexArray::CreateDescriptorPool()
-	{
-		std::array<VkDescriptorPoolSize, 2> poolSizes{};
-		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[0].descriptorCount = static_cast<uint32_t>(VulkanHolder::GetVulkanContext()->GetSwapChainImages().size());
-		poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		poolSizes[1].descriptorCount = static_cast<uint32_t>(VulkanHolder::GetVulkanContext()->GetSwapChainImages().size());
-
-		VkDescriptorPoolCreateInfo poolInfo{};
-		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = static_cast<uint32_t>(VulkanHolder::GetVulkanContext()->GetSwapChainImages().size());
-
-		VkResult result = vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool);
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor pool!");
+		m_pipelineLayout = context->GetDescriptorCache()->GetOrCreatePipelineLayout(m_descriptorSetLayout);
 	}
 
 	void VulkanVertexArray::CreateDescriptorSetLayout()
 	{
 		VkDescriptorSetLayoutBinding uboLayoutBinding{};
 		uboLayoutBinding.binding = m_Shader->GetUniformBufferObject()->GetBindingPointIndex();
-		uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		// The uniforms live in VulkanContext's uniform ring, the offset is supplied at bind time
+		uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		uboLayoutBinding.descriptorCount = 1;
 		uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 		uboLayoutBinding.pImmutableSamplers = nullptr;
 
+		// Textures come from the bindless table (set 1)
+		if (UsesBindless())
+		{
+			m_descriptorSetLayout = VulkanHolder::GetVulkanContext()->GetDescriptorCache()->GetOrCreateLayout({ uboLayoutBinding });
+			return;
+		}
+
 		VkDescriptorSetLayoutBinding samplerLayoutBinding{};
 		samplerLayoutBinding.binding = 1;
 		samplerLayoutBinding.descriptorCount = 1;
@@ -377,79 +487,76 @@ namespace Karma
 		samplerLayoutBinding.pImmutableSamplers = nullptr;
 		samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-		std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
-		VkDescriptorSetLayoutCreateInfo layoutInfo{};
-		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-		layoutInfo.pBindings = bindings.data();
-
-		VkResult result = vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout);
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create descriptor set layout!");
+		// Identically defined layouts are shared among vertex arrays
+		m_descriptorSetLayout = VulkanHolder::GetVulkanContext()->GetDescriptorCache()->GetOrCreateLayout({ uboLayoutBinding, samplerLayoutBinding });
 	}
 
 	void VulkanVertexArray::CreateDescriptorSets()
 	{
-		RendererAPI* rAPI = RenderCommand::GetRendererAPI();
-		VulkanRendererAPI* vulkanAPI = nullptr;
-
-		if (rAPI->GetAPI() == RendererAPI::API::Vulkan)
+		// Single set suffices since the uniforms of each frame live in the uniform ring and are reached by dynamic offset
+		DescriptorBindingInfo uboInfo;
+		uboInfo.m_Binding = m_Shader->GetUniformBufferObject()->GetBindingPointIndex();
+		uboInfo.m_Type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		uboInfo.m_BufferInfo.buffer = VulkanHolder::GetVulkanContext()->GetUniformRing()->GetBuffer();
+		uboInfo.m_BufferInfo.offset = 0;
+		uboInfo.m_BufferInfo.range = m_Shader->GetUniformBufferObject()->GetBufferSize();
+
+		// Fetch right texture pointer first whose image is to be considered.
+		// Caution: GetTexture index is with temporary assumption that needs addressing.
+		std::shared_ptr<Texture> texture = m_Materials[0]->GetTexture(0);
+		std::shared_ptr<VulkanTexture> vTexture = texture->GetVulkanTexture();
+
+		// The streamed ones (TextureStreamer) have no VulkanTexture, their images being remade as the mips come and go
+		VulkanStreamedTexture* streamedTexture = nullptr;
+
+		if (texture->IsStreamed())
 		{
-			vulkanAPI = static_cast<VulkanRendererAPI*>(rAPI);
+			streamedTexture = static_cast<VulkanStreamedTexture*>(TextureStreamer::Get().GetTexture(texture->GetStreamHandle()));
 		}
-		else
+
+		if (UsesBindless())
 		{
-			KR_CORE_ASSERT(false, "How is this even possible?");
-		}
+			VulkanBindlessTable* bindlessTable = VulkanHolder::GetVulkanContext()->GetBindlessTable();
+
+			BindlessMaterialEntry materialEntry;
+
+			if (texture->IsStreamed())
+			{
+				// Follows the texture from slot to slot (VulkanBindlessTable::RetargetMaterials)
+				materialEntry.m_AlbedoTextureIndex = streamedTexture ? streamedTexture->GetBindlessSlot() : 0;
+			}
+			else
+			{
+				materialEntry.m_AlbedoTextureIndex = bindlessTable->RegisterTexture(vTexture->GetImageView(), vTexture->GetImageSampler());
+			}
 
-		int maxFramesInFlight = vulkanAPI->GetMaxFramesInFlight();
+			m_MaterialIndex = bindlessTable->RegisterMaterial(m_Materials[0]->GetSortID(), materialEntry);
 
-		std::vector<VkDescriptorSetLayout> layouts(maxFramesInFlight, m_descriptorSetLayout);
-		VkDescriptorSetAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		allocInfo.descriptorPool = m_descriptorPool;
-		allocInfo.descriptorSetCount = static_cast<uint32_t>(maxFramesInFlight);
-		allocInfo.pSetLayouts = layouts.data();
+			// The uniforms only, so the set is shared by all the vertex arrays using alike uniforms
+			m_descriptorSet = VulkanHolder::GetVulkanContext()->GetDescriptorCache()->GetOrCreateSet(m_descriptorSetLayout, { uboInfo });
+			return;
+		}
 
-		m_descriptorSets.resize(maxFramesInFlight);
-		VkResult result = vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data());
+		DescriptorBindingInfo samplerInfo;
+		samplerInfo.m_Binding = 1;
+		samplerInfo.m_Type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		samplerInfo.m_ImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		KR_CORE_ASSERT(result == VK_SUCCESS, "Failed to allocate descriptor sets!");
+		if (texture->IsStreamed())
+		{
+			// The set would hold an image which the streamer remakes, so the shader without the bindless table gets the placeholder
+			KR_CORE_WARN("VulkanVertexArray: the shader doesn't sample through the bindless table, a streamed texture is drawn as the placeholder");
 
-		for (size_t i = 0; i < maxFramesInFlight; i++)
+			samplerInfo.m_ImageInfo.imageView = VulkanStreamedTexture::GetPlaceholderView();
+			samplerInfo.m_ImageInfo.sampler = VulkanStreamedTexture::GetSampler();
+		}
+		else
 		{
-			VkDescriptorBufferInfo bufferInfo{};
-			bufferInfo.buffer = m_Shader->GetUniformBufferObject()->GetUniformBuffers()[i];
-			bufferInfo.offset = 0;
-			bufferInfo.range = m_Shader->GetUniformBufferObject()->GetBufferSize();
-
-			// Fetch right texture pointer first whose image is to be considered.
-			// Caution: GetTexture index is with temporary assumption that needs addressing.
-			std::shared_ptr<VulkanTexture> vTexture = m_Materials[0]->GetTexture(0)->GetVulkanTexture();
-
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			imageInfo.imageView = vTexture->GetImageView();
-			imageInfo.sampler = vTexture->GetImageSampler();
-
-			std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = m_descriptorSets[i];
-			descriptorWrites[0].dstBinding = m_Shader->GetUniformBufferObject()->GetBindingPointIndex();
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-			descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[1].dstSet = m_descriptorSets[i];
-			descriptorWrites[1].dstBinding = 1;
-			descriptorWrites[1].dstArrayElement = 0;
-			descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			descriptorWrites[1].descriptorCount = 1;
-			descriptorWrites[1].pImageInfo = &imageInfo;
-
-			vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+			samplerInfo.m_ImageInfo.imageView = vTexture->GetImageView();
+			samplerInfo.m_ImageInfo.sampler = vTexture->GetImageSampler();
 		}
+
+		// Vertex arrays sharing the material (texture and sampler) share the set
+		m_descriptorSet = VulkanHolder::GetVulkanContext()->GetDescriptorCache()->GetOrCreateSet(m_descriptorSetLayout, { uboInfo, samplerInfo });
 	}
 }
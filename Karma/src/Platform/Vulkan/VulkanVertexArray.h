@@ -29,11 +29,20 @@ namespace Karma
 		void CreateDescriptorSetLayout();
 		void CreatePipelineLayout();
 		void CreateGraphicsPipeline();
-		void CreateDescriptorPool();
 		void CreateDescriptorSets();
 
 		void CreateExternalViewPort(float startX, float startY, float width, float height);
 
+		/**
+		 * @brief The viewport to set (vkCmdSetViewport) before drawing: the external one if CreateExternalViewPort was called, else the
+		 * whole of extent. The pipelines have viewport and scissor as dynamic state.
+		 *
+		 * @param extent						Extent of the framebuffer being drawn into
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkViewport GetViewport(VkExtent2D extent) const;
+
 		//void CreateCommandBuffers();
 
 		void GenerateVulkanVA();
@@ -46,11 +55,23 @@ namespace Karma
 
 		// Getters
 		VkPipeline GetGraphicsPipeline() const { return m_graphicsPipeline; }
+
+		/**
+		 * @brief Pipeline of the depth pre-pass: the depth only vertex shader (VulkanShader::HasDepthOnlyVariant) fetching the position
+		 * alone, no fragment stage and no color writes. VK_NULL_HANDLE if the shader has no such variant or the material is transparent.
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkPipeline GetDepthOnlyPipeline() const { return m_DepthOnlyPipeline; }
 		VkPipelineLayout GetGraphicsPipelineLayout() const { return m_pipelineLayout; }
 		const std::shared_ptr<VulkanShader>& GetShader() const { return m_Shader; }
 		//const std::vector<VkDescriptorSet>& GetUBDescriptorSets() const { return m_descriptorSets; }
 		const std::shared_ptr<VulkanVertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
-		const std::vector<VkDescriptorSet>& GetDescriptorSets() const { return m_descriptorSets; }
+		VkDescriptorSet GetDescriptorSet() const { return m_descriptorSet; }
+
+		// Bindless path (see VulkanBindlessTable): set 0 holds only the uniforms, the material is a push constant
+		bool UsesBindless() const { return m_Shader && m_Shader->UsesBindless(); }
+		uint32_t GetMaterialIndex() const { return m_MaterialIndex; }
 
 		virtual std::shared_ptr<Material> GetMaterial() const override { return m_Materials.at(0); }
 
@@ -60,6 +81,39 @@ namespace Karma
 		virtual const std::vector<std::shared_ptr<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
 		virtual const VulkanIndexBuffer* GetIndexBuffer() const override { return m_IndexBuffer.get(); }
 
+		// Vertex binding of the per instance world matrices
+		static constexpr uint32_t s_InstanceBinding = 1;
+
+		// Location of the position attribute, the one the depth only pipeline reads
+		static constexpr uint32_t s_PositionLocation = 0;
+
+		// Stages reading the material index push constant of the bindless shaders
+		static constexpr VkShaderStageFlags s_MaterialIndexStages = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	private:
+		/**
+		 * @brief Makes the pipeline, the shading one or the depth only one. The depth state and blending follow the material's
+		 * transparency (Material::IsTransparent).
+		 *
+		 * @since Karma 1.0.0
+		 */
+		VkPipeline BuildGraphicsPipeline(bool bDepthOnly);
+
+		/**
+		 * @brief Whether the material is drawn in the transparent pass
+		 *
+		 * @since Karma 1.0.0
+		 */
+		bool IsTransparent() const;
+
+	protected:
+		/**
+		 * @brief Takes the buffers of the mesh again and rebuilds the pipelines and descriptor sets
+		 *
+		 * @since Karma 1.0.0
+		 */
+		virtual void OnAssetsReloaded() override;
+
 	private:
 		// May need to consider batching for components of Meshes and Materials
 
@@ -79,8 +133,11 @@ namespace Karma
 		VkDescriptorSetLayout m_descriptorSetLayout;
 
 		VkPipeline m_graphicsPipeline;
-		VkDescriptorPool m_descriptorPool;
-		std::vector<VkDescriptorSet> m_descriptorSets;
+		VkPipeline m_DepthOnlyPipeline = VK_NULL_HANDLE;
+		VkDescriptorSet m_descriptorSet;
+
+		// Entry of the material in VulkanBindlessTable's material table
+		uint32_t m_MaterialIndex = 0;
 
 		VkVertexInputBindingDescription m_bindingDescription{};
 		std::vector<VkVertexInputAttributeDescription> m_attributeDescriptions;
@@ -6,6 +6,7 @@
 #include "GLFW/glfw3.h"
 #include "Platform/OpenGL/OpenGLContext.h"
 #include "Platform/Vulkan/VulkanContext.h"
+#include "Platform/Null/NullWindow.h"
 #include "Karma/Renderer/Renderer.h"
 
 namespace Karma
@@ -19,6 +20,12 @@ namespace Karma
 #ifdef KR_WINDOWS_PLATFORM
 	Window* Window::Create(const WindowProps& props)
 	{
+		// Headless, no display needed
+		if (RendererAPI::GetAPI() == RendererAPI::API::Null)
+		{
+			return new NullWindow(props);
+		}
+
 		return new WindowsWindow(props);
 	}
 #endif
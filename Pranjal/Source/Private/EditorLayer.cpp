@@ -29,18 +29,16 @@ namespace Karma
 		// First intantiate VertexArray
 		m_ModelVertexArray.reset(Karma::VertexArray::Create());
 
+		Karma::AssetManager& assetManager = Karma::AssetManager::Get();
+
 		{
-			// Get hold of model
-			std::shared_ptr<Karma::Mesh> modelMesh;
-			modelMesh.reset(new Karma::Mesh("../Resources/Models/BonedCylinder.obj"));
+			// Get hold of model, loaded (cooked, if need be) before the vertex array takes it
+			m_ModelMesh = assetManager.LoadMesh("../Resources/Models/BonedCylinder.obj", Karma::AssetPriority::Immediate);
 
 			// Set the mesh in vertex array
-			m_ModelVertexArray->SetMesh(modelMesh);
+			m_ModelVertexArray->SetMesh(m_ModelMesh.GetShared());
 		}
 
-		// Next, instantiate material
-		m_ModelMaterial.reset(new Karma::Material());
-
 		{
 			// Setting shader
 
@@ -48,18 +46,18 @@ namespace Karma
 			std::shared_ptr<Karma::UniformBufferObject> shaderUniform;
 			shaderUniform.reset(Karma::UniformBufferObject::Create({ Karma::ShaderDataType::Mat4, Karma::ShaderDataType::Mat4 }, 0));
 
-			m_ModelShader.reset(Karma::Shader::Create("../Resources/Shaders/shader.vert", "../Resources/Shaders/shader.frag", shaderUniform, "CylinderShader"));
-
-			m_ModelMaterial->AddShader(m_ModelShader);
+			m_ModelShader = assetManager.LoadShader("../Resources/Shaders/shader.vert", "../Resources/Shaders/shader.frag", shaderUniform, "CylinderShader",
+				Karma::AssetPriority::Immediate);
 		}
 
 		// Then we set texture
-		m_ModelTexture.reset(new Karma::Texture(Karma::TextureType::Image, "../Resources/Textures/UnrealGrid.png", "VikingTex", "texSampler"));
+		m_ModelTexture = assetManager.LoadTexture("../Resources/Textures/UnrealGrid.png", "VikingTex", "texSampler", Karma::AssetPriority::Immediate);
 
-		m_ModelMaterial->AddTexture(m_ModelTexture);
+		// Next, instantiate material of the two
+		m_ModelMaterial = assetManager.LoadMaterial("EditorModelMaterial", m_ModelShader, { m_ModelTexture }, Karma::AssetPriority::Immediate);
 		m_ModelMaterial->AttatchMainCamera(m_EditorCamera); //Is this needed?
 
-		m_ModelVertexArray->SetMaterial(m_ModelMaterial);
+		m_ModelVertexArray->SetMaterial(m_ModelMaterial.GetShared());
 
 		m_EditorScene.reset(new Karma::Scene());
 		m_EditorScene->AddCamera(m_EditorCamera);
@@ -74,12 +72,16 @@ namespace Karma
 
 	void EditorLayer::OpenScene(const std::string& objFileName)
 	{
-		std::shared_ptr<Mesh> meshToLoad;
+		// The mesh replaced is unloaded once the vertex array lets go of it too
+		m_ModelMesh = AssetManager::Get().LoadMesh(objFileName, AssetPriority::Immediate);
 
-		// Check if the already assigned is freed and there is no leak
-		meshToLoad.reset(new Mesh(objFileName));
+		if (!m_ModelMesh.IsReady())
+		{
+			KR_WARN("Couldn't load the scene {0}", objFileName);
+			return;
+		}
 
-		m_ModelVertexArray->SetMesh(meshToLoad);
+		m_ModelVertexArray->SetMesh(m_ModelMesh.GetShared());
 		KR_INFO("Successfully loaded scene");
 	}
 
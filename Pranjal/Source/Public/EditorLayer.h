@@ -27,10 +27,13 @@ namespace Karma
 		void IterateActors();
 
 	private:
-		std::shared_ptr<Karma::Shader> m_ModelShader;
+		// Held so that the AssetManager keeps them loaded, and hands them out again to whoever asks for the same files
+		Karma::AssetHandle<Karma::Mesh> m_ModelMesh;
+		Karma::AssetHandle<Karma::Shader> m_ModelShader;
+		Karma::AssetHandle<Karma::Material> m_ModelMaterial;
+		Karma::AssetHandle<Karma::Texture> m_ModelTexture;
+
 		std::shared_ptr<Karma::VertexArray> m_ModelVertexArray;
-		std::shared_ptr<Karma::Material> m_ModelMaterial;
-		std::shared_ptr<Karma::Texture> m_ModelTexture;
 
 		std::shared_ptr<Karma::PerspectiveCamera> m_EditorCamera;
 		std::shared_ptr<Karma::Scene> m_EditorScene;
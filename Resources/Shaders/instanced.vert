@@ -0,0 +1,38 @@
+// Instanced variant of shader.vert. The world matrix comes per instance
+// (see Shader::s_InstanceTransformName and s_InstanceTransformLocation).
+// KARMA_DEPTH_ONLY as in shader.vert.
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 inPosition;
+#ifndef KARMA_DEPTH_ONLY
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+#endif
+
+layout(location = 8) in mat4 inInstanceWorld;
+
+
+#ifndef KARMA_DEPTH_ONLY
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUVs;
+#endif
+
+// The depth only variant must lay exactly the depth the shading pass tests against
+invariant gl_Position;
+
+layout(std140, binding = 0) uniform MVPUniformBufferObject
+{
+	mat4 u_Projection;
+	mat4 u_View;
+};
+
+
+void main()
+{
+	gl_Position = u_Projection * u_View * inInstanceWorld * vec4(inPosition, 1.0);
+#ifndef KARMA_DEPTH_ONLY
+	fragColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	fragUVs = inUV;
+#endif
+}
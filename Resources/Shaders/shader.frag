@@ -1,14 +1,55 @@
+// KARMA_BINDLESS is defined by the Vulkan backend when the device supports
+// descriptor indexing (see VulkanBindlessTable). The texture is then fetched
+// from the one texture array through the material table, else from the
+// material's own sampler.
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+#ifdef KARMA_BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 layout(location = 0) in vec4 fragColor;
 layout(location = 1) in vec2 fragUVs;
 
 layout(location = 0) out vec4 outColor;
 
+#ifdef KARMA_BINDLESS
+struct MaterialEntry
+{
+	uint albedoTextureIndex;
+	uint padding0;
+	uint padding1;
+	uint padding2;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D bindlessTextures[];
+
+layout(std430, set = 1, binding = 1) readonly buffer MaterialTable
+{
+	MaterialEntry materials[];
+};
+
+layout(push_constant) uniform MaterialIndex
+{
+	uint materialIndex;
+};
+
+vec4 SampleAlbedo(vec2 uvs)
+{
+	uint textureIndex = materials[materialIndex].albedoTextureIndex;
+	return texture(bindlessTextures[nonuniformEXT(textureIndex)], uvs);
+}
+#else
 layout(binding = 1) uniform sampler2D texSampler;
 
+vec4 SampleAlbedo(vec2 uvs)
+{
+	return texture(texSampler, uvs);
+}
+#endif
+
 void main()
 {
-	outColor = vec4(vec3(fragColor.x, fragColor.y, fragColor.z) * texture(texSampler, fragUVs).rgb, 1.0);
+	outColor = vec4(vec3(fragColor.x, fragColor.y, fragColor.z) * SampleAlbedo(fragUVs).rgb, 1.0);
 }
@@ -1,15 +1,24 @@
 // Shader needs be conforming to Mesh vertexdata. So we need an algorithm
 // to gauge that.
+// KARMA_DEPTH_ONLY is defined by the Vulkan backend for the depth pre-pass
+// variant, which reads the position alone (see VulkanShader::HasDepthOnlyVariant).
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(location = 0) in vec3 inPosition;
+#ifndef KARMA_DEPTH_ONLY
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec4 inColor;
+#endif
 
 
+#ifndef KARMA_DEPTH_ONLY
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 fragUVs;
+#endif
+
+// The depth only variant must lay exactly the depth the shading pass tests against
+invariant gl_Position;
 
 layout(std140, binding = 0) uniform MVPUniformBufferObject
 {
@@ -21,6 +30,8 @@ layout(std140, binding = 0) uniform MVPUniformBufferObject
 void main()
 {
 	gl_Position = u_Projection * u_View * vec4(inPosition, 1.0);
+#ifndef KARMA_DEPTH_ONLY
 	fragColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
 	fragUVs = inUV;
+#endif
 }
@@ -0,0 +1,45 @@
+// Skinned variant of shader.vert, for SkeletalMesh. Each vertex follows up to four bones, by
+// u_FinalBonesMatrices (Anuprana::GetSkinMatrices, passed through Material::SetBoneMatrices).
+// KARMA_MAX_BONES must match SkeletalMesh::s_MaxBones. There is no depth only variant, the
+// pre-pass feeds the position alone and the skinned position needs the bones.
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+#define KARMA_MAX_BONES 64
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in vec4 inBoneIDs;
+layout(location = 4) in vec4 inBoneWeights;
+
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUVs;
+
+layout(std140, binding = 0) uniform MVPUniformBufferObject
+{
+	mat4 u_Projection;
+	mat4 u_View;
+	mat4 u_World;
+	mat4 u_FinalBonesMatrices[KARMA_MAX_BONES];
+};
+
+
+void main()
+{
+	mat4 skinMatrix = u_FinalBonesMatrices[int(inBoneIDs.x)] * inBoneWeights.x +
+		u_FinalBonesMatrices[int(inBoneIDs.y)] * inBoneWeights.y +
+		u_FinalBonesMatrices[int(inBoneIDs.z)] * inBoneWeights.z +
+		u_FinalBonesMatrices[int(inBoneIDs.w)] * inBoneWeights.w;
+
+	// Vertices weighted to no bone stay as they are
+	if (dot(inBoneWeights, vec4(1.0)) < 0.0001)
+	{
+		skinMatrix = mat4(1.0);
+	}
+
+	gl_Position = u_Projection * u_View * u_World * skinMatrix * vec4(inPosition, 1.0);
+	fragColor = inColor;
+	fragUVs = inUV;
+}